@@ -24,6 +24,7 @@ THE SOFTWARE.
 #include <assert.h>
 
 #include <algorithm>
+#include <cctype>
 
 #include "rdc/rdc.h"
 namespace amd {
@@ -62,5 +63,41 @@ bool is_field_valid(rdc_field_t field_id) {
   return field_id_to_descript.find(static_cast<uint32_t>(field_id)) != field_id_to_descript.end();
 }
 
+std::string get_field_metric_name(const std::string& label) {
+  std::string name;
+  for (char c : label) {
+    name += std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == ':'
+                ? static_cast<char>(std::tolower(static_cast<unsigned char>(c)))
+                : '_';
+  }
+  if (name.empty() || std::isdigit(static_cast<unsigned char>(name[0]))) {
+    name = "_" + name;
+  }
+  return name;
+}
+
+// The rate fields mirror the ids of their counters
+static const uint32_t kRateFieldOffset = RDC_FI_ECC_CORRECT_RATE - RDC_FI_ECC_CORRECT_TOTAL;
+
+bool get_rate_field(rdc_field_t counter_id, rdc_field_t* rate_id) {
+  assert(rate_id != nullptr);
+  uint32_t id = counter_id + kRateFieldOffset;
+  if (id < RDC_FI_RATE_FIRST || id > RDC_FI_RATE_LAST ||
+      !is_field_valid(static_cast<rdc_field_t>(id))) {
+    return false;
+  }
+  *rate_id = static_cast<rdc_field_t>(id);
+  return true;
+}
+
+bool get_rate_counter_field(rdc_field_t rate_id, rdc_field_t* counter_id) {
+  assert(counter_id != nullptr);
+  if (rate_id < RDC_FI_RATE_FIRST || rate_id > RDC_FI_RATE_LAST || !is_field_valid(rate_id)) {
+    return false;
+  }
+  *counter_id = static_cast<rdc_field_t>(rate_id - kRateFieldOffset);
+  return true;
+}
+
 }  // namespace rdc
 }  // namespace amd
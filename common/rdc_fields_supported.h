@@ -44,6 +44,12 @@ typedef std::unordered_map<std::string, uint32_t> fld_name2id_map_t;
 bool get_field_id_from_name(const std::string name, rdc_field_t* value);
 fld_id2name_map_t& get_field_id_description_from_id(void);  // NOLINT
 bool is_field_valid(rdc_field_t field_id);
+//!< The lower case label of a field, with the characters which a Prometheus
+//!< or InfluxDB name cannot hold replaced by '_'
+std::string get_field_metric_name(const std::string& label);
+//!< The rate field computed from a cumulative counter, and the reverse
+bool get_rate_field(rdc_field_t counter_id, rdc_field_t* rate_id);
+bool get_rate_counter_field(rdc_field_t rate_id, rdc_field_t* counter_id);
 
 }  // namespace rdc
 }  // namespace amd
@@ -0,0 +1,200 @@
+/*
+Copyright (c) 2024 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include "common/rdc_perf_histogram.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+namespace amd {
+namespace rdc {
+
+//!< The shards claimed by one thread, indexed by histogram id. Releasing
+//!< them when the thread exits lets the next thread reuse them.
+struct RdcPerfThreadShards {
+  std::vector<RdcPerfHistogram::Shard*> shards;
+  ~RdcPerfThreadShards() {
+    for (auto shard : shards) {
+      if (shard) {
+        shard->in_use.store(false, std::memory_order_release);
+      }
+    }
+  }
+};
+
+namespace {
+thread_local RdcPerfThreadShards thread_shards;
+}  // namespace
+
+RdcPerfHistogram::Shard::Shard() : in_use(false), count(0), total(0), max(0) {
+  for (auto& bucket : buckets) {
+    bucket.store(0, std::memory_order_relaxed);
+  }
+}
+
+RdcPerfHistogram::RdcPerfHistogram(const std::string& name, uint32_t id) : name_(name), id_(id) {}
+
+uint32_t RdcPerfHistogram::bucket_index(uint64_t value) {
+  if (value < kSubBuckets) {
+    return static_cast<uint32_t>(value);
+  }
+  uint32_t msb = 63 - __builtin_clzll(value);
+  uint32_t shift = msb - kSubBits;
+  return (shift + 1) * kSubBuckets + static_cast<uint32_t>((value >> shift) & (kSubBuckets - 1));
+}
+
+uint64_t RdcPerfHistogram::bucket_value(uint32_t index) {
+  if (index < kSubBuckets) {
+    return index;
+  }
+  uint32_t shift = index / kSubBuckets - 1;
+  uint64_t low = static_cast<uint64_t>(kSubBuckets + index % kSubBuckets) << shift;
+  // The middle of the bucket
+  return low + ((1ULL << shift) >> 1);
+}
+
+RdcPerfHistogram::Shard* RdcPerfHistogram::local_shard() {
+  std::vector<Shard*>& shards = thread_shards.shards;
+  if (id_ < shards.size() && shards[id_] != nullptr) {
+    return shards[id_];
+  }
+
+  Shard* shard = nullptr;
+  do {  //< lock guard for thread safe
+    std::lock_guard<std::mutex> guard(shards_mutex_);
+    for (auto& s : shards_) {
+      bool expected = false;
+      if (s->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+        shard = s.get();
+        break;
+      }
+    }
+    if (shard == nullptr) {
+      shards_.emplace_back(new Shard());
+      shard = shards_.back().get();
+      shard->in_use.store(true, std::memory_order_relaxed);
+    }
+  } while (0);
+
+  if (shards.size() <= id_) {
+    shards.resize(id_ + 1, nullptr);
+  }
+  shards[id_] = shard;
+  return shard;
+}
+
+void RdcPerfHistogram::record(uint64_t value_ns) {
+  Shard* shard = local_shard();
+  // Only this thread writes the shard, so plain load and store is enough
+  auto& bucket = shard->buckets[bucket_index(value_ns)];
+  bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  shard->count.store(shard->count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  shard->total.store(shard->total.load(std::memory_order_relaxed) + value_ns,
+                     std::memory_order_relaxed);
+  if (value_ns > shard->max.load(std::memory_order_relaxed)) {
+    shard->max.store(value_ns, std::memory_order_relaxed);
+  }
+}
+
+void RdcPerfHistogram::get_stat(rdc_perf_stat_t* stat) {
+  if (stat == nullptr) {
+    return;
+  }
+
+  std::vector<uint64_t> buckets(kNumBuckets, 0);
+  uint64_t count = 0;
+  uint64_t total = 0;
+  uint64_t max = 0;
+  do {  //< lock guard for thread safe
+    std::lock_guard<std::mutex> guard(shards_mutex_);
+    for (auto& shard : shards_) {
+      for (uint32_t i = 0; i < kNumBuckets; i++) {
+        uint64_t n = shard->buckets[i].load(std::memory_order_relaxed);
+        buckets[i] += n;
+        count += n;
+      }
+      total += shard->total.load(std::memory_order_relaxed);
+      max = std::max(max, shard->max.load(std::memory_order_relaxed));
+    }
+  } while (0);
+
+  stat->count = count;
+  stat->total_ns = total;
+  stat->max_ns = max;
+
+  const double quantiles[] = {0.5, 0.9, 0.99, 0.999};
+  uint64_t* results[] = {&stat->p50_ns, &stat->p90_ns, &stat->p99_ns, &stat->p999_ns};
+  uint64_t seen = 0;
+  uint32_t q = 0;
+  for (uint32_t i = 0; i < kNumBuckets && q < 4; i++) {
+    seen += buckets[i];
+    while (q < 4 && count > 0 && seen >= quantiles[q] * count) {
+      *results[q] = std::min(bucket_value(i), max);
+      q++;
+    }
+  }
+  for (; q < 4; q++) {
+    *results[q] = max;
+  }
+}
+
+RdcPerfRegistry& RdcPerfRegistry::get_instance() {
+  // Never destroyed, so threads exiting after main() can still release
+  // their shards
+  static RdcPerfRegistry* registry = new RdcPerfRegistry();
+  return *registry;
+}
+
+RdcPerfHistogram& RdcPerfRegistry::get_histogram(const std::string& name) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto ite = histograms_.find(name);
+  if (ite != histograms_.end()) {
+    return *ite->second;
+  }
+  RdcPerfHistogram* histogram = new RdcPerfHistogram(name, histograms_.size());
+  histograms_.emplace(name, std::unique_ptr<RdcPerfHistogram>(histogram));
+  return *histogram;
+}
+
+void RdcPerfRegistry::get_stats(rdc_perf_stats_t* stats) {
+  if (stats == nullptr) {
+    return;
+  }
+  std::lock_guard<std::mutex> guard(mutex_);
+  for (auto& ite : histograms_) {
+    if (stats->num_stats >= RDC_MAX_NUM_PERF_STATS) {
+      break;
+    }
+    rdc_perf_stat_t& stat = stats->stats[stats->num_stats];
+    ite.second->get_stat(&stat);
+    if (stat.count == 0) {
+      continue;
+    }
+    strncpy(stat.name, ite.first.c_str(), RDC_MAX_PERF_STAT_NAME - 1);
+    stat.name[RDC_MAX_PERF_STAT_NAME - 1] = '\0';
+    stats->num_stats++;
+  }
+}
+
+}  // namespace rdc
+}  // namespace amd
@@ -0,0 +1,133 @@
+/*
+Copyright (c) 2024 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#ifndef COMMON_RDC_PERF_HISTOGRAM_H_
+#define COMMON_RDC_PERF_HISTOGRAM_H_
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <vector>
+
+#include "rdc/rdc.h"
+
+namespace amd {
+namespace rdc {
+
+//!< Log-linear latency histogram in nanoseconds. Every power of two is split
+//!< into kSubBuckets linear buckets, so a bucket is at most 1/16 of its value
+//!< wide. Each recording thread owns a shard of the buckets which only it
+//!< writes, so recording takes no lock and no atomic read-modify-write.
+//!< Readers sum the shards.
+class RdcPerfHistogram {
+ public:
+  static const uint32_t kSubBits = 4;
+  static const uint32_t kSubBuckets = 1 << kSubBits;
+  static const uint32_t kNumBuckets = (64 - kSubBits + 1) * kSubBuckets;
+
+  void record(uint64_t value_ns);
+
+  //!< Fill the count, total, max and percentiles of stat, not its name
+  void get_stat(rdc_perf_stat_t* stat);
+
+  const std::string& name() const { return name_; }
+
+  RdcPerfHistogram(const std::string& name, uint32_t id);
+
+ private:
+  struct Shard {
+    std::atomic<bool> in_use;
+    std::atomic<uint64_t> count;
+    std::atomic<uint64_t> total;
+    std::atomic<uint64_t> max;
+    std::atomic<uint64_t> buckets[kNumBuckets];
+    Shard();
+  };
+  friend struct RdcPerfThreadShards;
+
+  //!< The shard of the calling thread, claimed on its first record
+  Shard* local_shard();
+  static uint32_t bucket_index(uint64_t value);
+  static uint64_t bucket_value(uint32_t index);
+
+  std::string name_;
+  uint32_t id_;  //!< Index into the per thread shard table
+  std::mutex shards_mutex_;
+  //!< Shards of exited threads are released and reused by new threads,
+  //!< so the list only grows to the peak number of recording threads
+  std::vector<std::unique_ptr<Shard>> shards_;
+};
+
+//!< Process wide set of named histograms
+class RdcPerfRegistry {
+ public:
+  static RdcPerfRegistry& get_instance();
+
+  //!< Returns the histogram with this name, creating it on first use. The
+  //!< histogram lives as long as the process.
+  RdcPerfHistogram& get_histogram(const std::string& name);
+
+  //!< Append the histograms with samples to stats, up to
+  //!< RDC_MAX_NUM_PERF_STATS in total
+  void get_stats(rdc_perf_stats_t* stats);
+
+ private:
+  RdcPerfRegistry() {}
+  std::mutex mutex_;
+  std::map<std::string, std::unique_ptr<RdcPerfHistogram>> histograms_;
+};
+
+//!< Records the lifetime of the object into a histogram
+class RdcScopedPerfTimer {
+ public:
+  explicit RdcScopedPerfTimer(RdcPerfHistogram& histogram)
+      : histogram_(histogram), start_(std::chrono::steady_clock::now()) {}
+  ~RdcScopedPerfTimer() {
+    histogram_.record(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                          std::chrono::steady_clock::now() - start_)
+                          .count());
+  }
+
+ private:
+  RdcPerfHistogram& histogram_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+#define RDC_PERF_CONCAT_(a, b) a##b
+#define RDC_PERF_CONCAT(a, b) RDC_PERF_CONCAT_(a, b)
+
+//!< Time the rest of the enclosing scope into the histogram called name.
+//!< The histogram is looked up once per call site.
+#define RDC_PERF_SCOPE(name)                                                            \
+  static amd::rdc::RdcPerfHistogram& RDC_PERF_CONCAT(rdc_perf_histogram_, __LINE__) = \
+      amd::rdc::RdcPerfRegistry::get_instance().get_histogram(name);                    \
+  amd::rdc::RdcScopedPerfTimer RDC_PERF_CONCAT(rdc_perf_timer_, __LINE__)(              \
+      RDC_PERF_CONCAT(rdc_perf_histogram_, __LINE__))
+
+}  // namespace rdc
+}  // namespace amd
+
+#endif  // COMMON_RDC_PERF_HISTOGRAM_H_
@@ -86,5 +86,23 @@ bool IsIP(const std::string& s) {
   return result == 1;
 }
 
+void WriteTimelineCsvHeader(std::ostream* out) {
+  *out << "gpu_index,field,start_ts,count,min,max,average\n";
+}
+
+uint32_t WriteTimelineCsv(std::ostream* out, uint32_t gpu_index, rdc_field_t field,
+                          const rdc_job_timeline_t& timeline) {
+  uint32_t num_rows = 0;
+  for (uint32_t p = 0; p < timeline.num_points && p < RDC_MAX_TIMELINE_POINTS; p++) {
+    const rdc_timeline_point_t& point = timeline.points[p];
+    if (point.count == 0) continue;
+    *out << gpu_index << "," << field_id_string(field) << "," << point.start_ts << ","
+         << point.count << "," << point.min_value << "," << point.max_value << ","
+         << point.average << "\n";
+    num_rows++;
+  }
+  return num_rows;
+}
+
 }  // namespace rdc
 }  // namespace amd
@@ -24,8 +24,11 @@ THE SOFTWARE.
 #ifndef COMMON_RDC_UTILS_H_
 #define COMMON_RDC_UTILS_H_
 
+#include <ostream>
 #include <string>
 
+#include "rdc/rdc.h"
+
 namespace amd {
 namespace rdc {
 
@@ -48,6 +51,11 @@ int ReadFile(const char* path, std::string* retStr, bool chop_newline = false);
 bool IsNumber(const std::string& s);
 bool IsIP(const std::string& s);
 
+// The CSV export of the job timelines, one row per point with samples
+void WriteTimelineCsvHeader(std::ostream* out);
+uint32_t WriteTimelineCsv(std::ostream* out, uint32_t gpu_index, rdc_field_t field,
+                          const rdc_job_timeline_t& timeline);
+
 }  // namespace rdc
 }  // namespace amd
 
@@ -92,6 +92,15 @@ typedef enum {
  */
 typedef enum { RDC_OPERATION_MODE_AUTO = 0, RDC_OPERATION_MODE_MANUAL } rdc_operation_mode_t;
 
+/**
+ * @brief Bit flags passed to rdc_init()
+ */
+typedef enum {
+  RDC_INIT_FLAG_NONE = 0x0,     //!< Default initialization
+  RDC_INIT_FLAG_FAKE_SMI = 0x1  //!< Collect from simulated GPUs instead of
+                                //!< amd_smi_lib. See RDC_FAKE_SMI_* env vars
+} rdc_init_flags_t;
+
 /**
  * @brief type of GPU group
  */
@@ -274,6 +283,67 @@ typedef enum {
   RDC_FI_PROF_EVAL_FLOPS_32,
   RDC_FI_PROF_EVAL_FLOPS_64,
 
+  /**
+   * @brief RDC self telemetry. These fields describe RDC itself rather
+   * than a GPU, so the same value is reported for every GPU index.
+   */
+  RDC_FI_RDC_TICK_DURATION = 900,  //!< Duration of the last update tick
+                                   //!< in microseconds
+  RDC_FI_RDC_TICK_OVERRUNS,        //!< Update ticks which took longer than
+                                   //!< the shortest watched update interval
+  RDC_FI_RDC_FETCH_LATENCY,        //!< Duration of the last bulk fetch from
+                                   //!< all modules in microseconds
+  RDC_FI_RDC_SMI_FETCH_LATENCY,    //!< Duration of the last amd_smi module
+                                   //!< fetch in microseconds
+  RDC_FI_RDC_PROF_FETCH_LATENCY,   //!< Duration of the last profiler module
+                                   //!< fetch in microseconds
+  RDC_FI_RDC_SAMPLES_PER_SEC,      //!< Samples written to the cache per second
+  RDC_FI_RDC_CACHE_SAMPLES,        //!< Samples currently held in the cache
+  RDC_FI_RDC_CACHE_BYTES,          //!< Approximate memory used by the cache
+  RDC_FI_RDC_API_CALLS_PER_SEC,    //!< Query API calls (gRPC requests when
+                                   //!< running in rdcd) per second
+  RDC_FI_RDC_FETCH_QUEUE_DEPTH,    //!< Fields fetched in the last update tick
+  RDC_FI_RDC_EVENT_QUEUE_DEPTH,    //!< Events returned by the last
+                                   //!< notification listen
+  RDC_FI_RDC_EXPORT_SAMPLES,       //!< Samples pushed by the push exporter
+  RDC_FI_RDC_EXPORT_DROPPED,       //!< Samples the push exporter dropped,
+                                   //!< its buffer being full or its agent down
+
+  /**
+   * @brief Anomaly scores. RDC_FI_ANOMALY_SCORE_<N> is the z-score of the
+   * last sample of the field of anomaly detector N against its baseline,
+   * see rdc_anomaly_set_detector().
+   */
+  RDC_FI_ANOMALY_SCORE_0 = 950,  //!< Score of anomaly detector 0
+  RDC_FI_ANOMALY_SCORE_1,        //!< Score of anomaly detector 1
+  RDC_FI_ANOMALY_SCORE_2,        //!< Score of anomaly detector 2
+  RDC_FI_ANOMALY_SCORE_3,        //!< Score of anomaly detector 3
+  RDC_FI_ANOMALY_SCORE_4,        //!< Score of anomaly detector 4
+  RDC_FI_ANOMALY_SCORE_5,        //!< Score of anomaly detector 5
+  RDC_FI_ANOMALY_SCORE_6,        //!< Score of anomaly detector 6
+  RDC_FI_ANOMALY_SCORE_7,        //!< Score of anomaly detector 7
+
+  /**
+   * @brief Derived fields, computed by rdcd from the samples of other
+   * fields with the expression set by rdc_field_derived_set()
+   */
+  RDC_FI_DERIVED_0 = 960,  //!< Derived field 0
+  RDC_FI_DERIVED_1,        //!< Derived field 1
+  RDC_FI_DERIVED_2,        //!< Derived field 2
+  RDC_FI_DERIVED_3,        //!< Derived field 3
+  RDC_FI_DERIVED_4,        //!< Derived field 4
+  RDC_FI_DERIVED_5,        //!< Derived field 5
+  RDC_FI_DERIVED_6,        //!< Derived field 6
+  RDC_FI_DERIVED_7,        //!< Derived field 7
+  RDC_FI_DERIVED_8,        //!< Derived field 8
+  RDC_FI_DERIVED_9,        //!< Derived field 9
+  RDC_FI_DERIVED_10,       //!< Derived field 10
+  RDC_FI_DERIVED_11,       //!< Derived field 11
+  RDC_FI_DERIVED_12,       //!< Derived field 12
+  RDC_FI_DERIVED_13,       //!< Derived field 13
+  RDC_FI_DERIVED_14,       //!< Derived field 14
+  RDC_FI_DERIVED_15,       //!< Derived field 15
+
   /**
    * @brief Raw XGMI counter events
    */
@@ -329,8 +399,54 @@ typedef enum {
   RDC_EVNT_NOTIF_PRE_RESET,         //!< GPU reset is about to occur
   RDC_EVNT_NOTIF_POST_RESET,        //!< GPU reset just occurred
   RDC_EVNT_NOTIF_RING_HANG,         //!< GPU ring hang just occurred
+  RDC_EVNT_NOTIF_ANOMALY,           //!< An anomaly detector fired; the
+                                    //!< value is the field id of the
+                                    //!< anomalous sample
+  RDC_EVNT_NOTIF_POLICY_VIOLATION,  //!< A policy rule is violated; the
+                                    //!< value is the rule id
+  RDC_EVNT_NOTIF_POLICY_CLEARED,    //!< A violated policy rule cleared;
+                                    //!< the value is the rule id
+
+  RDC_EVNT_NOTIF_LAST = RDC_EVNT_NOTIF_POLICY_CLEARED,
 
-  RDC_EVNT_NOTIF_LAST = RDC_EVNT_NOTIF_RING_HANG,
+  /**
+   * @brief Rates of the cumulative counters, per second. They are computed
+   * by the cache from consecutive samples of the counter, and are cached
+   * whenever the counter is watched. Each is the counter id plus 2400.
+   */
+  RDC_FI_ECC_CORRECT_RATE = 3000,      //!< Correctable ECC errors per second
+  RDC_FI_ECC_UNCORRECT_RATE,           //!< Uncorrectable ECC errors per second
+
+  RDC_FI_XGMI_0_READ_RATE = 3100,      //!< XGMI_0 data read (KB/s)
+  RDC_FI_XGMI_1_READ_RATE,             //!< XGMI_1 data read (KB/s)
+  RDC_FI_XGMI_2_READ_RATE,             //!< XGMI_2 data read (KB/s)
+  RDC_FI_XGMI_3_READ_RATE,             //!< XGMI_3 data read (KB/s)
+  RDC_FI_XGMI_4_READ_RATE,             //!< XGMI_4 data read (KB/s)
+  RDC_FI_XGMI_5_READ_RATE,             //!< XGMI_5 data read (KB/s)
+  RDC_FI_XGMI_6_READ_RATE,             //!< XGMI_6 data read (KB/s)
+  RDC_FI_XGMI_7_READ_RATE,             //!< XGMI_7 data read (KB/s)
+  RDC_FI_XGMI_0_WRITE_RATE,            //!< XGMI_0 data write (KB/s)
+  RDC_FI_XGMI_1_WRITE_RATE,            //!< XGMI_1 data write (KB/s)
+  RDC_FI_XGMI_2_WRITE_RATE,            //!< XGMI_2 data write (KB/s)
+  RDC_FI_XGMI_3_WRITE_RATE,            //!< XGMI_3 data write (KB/s)
+  RDC_FI_XGMI_4_WRITE_RATE,            //!< XGMI_4 data write (KB/s)
+  RDC_FI_XGMI_5_WRITE_RATE,            //!< XGMI_5 data write (KB/s)
+  RDC_FI_XGMI_6_WRITE_RATE,            //!< XGMI_6 data write (KB/s)
+  RDC_FI_XGMI_7_WRITE_RATE,            //!< XGMI_7 data write (KB/s)
+  RDC_FI_XGMI_TOTAL_READ_RATE,         //!< XGMI_SUM data read (KB/s)
+  RDC_FI_XGMI_TOTAL_WRITE_RATE,        //!< XGMI_SUM data write (KB/s)
+
+  RDC_EVNT_XGMI_0_NOP_TX_RATE = 3400,  //!< NOPs sent to neighbor 0 per second
+  RDC_EVNT_XGMI_0_REQ_TX_RATE,         //!< Requests sent to neighbor 0 per second
+  RDC_EVNT_XGMI_0_RESP_TX_RATE,        //!< Responses sent to neighbor 0 per second
+  RDC_EVNT_XGMI_0_BEATS_TX_RATE,       //!< Data beats sent to neighbor 0 per second
+  RDC_EVNT_XGMI_1_NOP_TX_RATE,         //!< NOPs sent to neighbor 1 per second
+  RDC_EVNT_XGMI_1_REQ_TX_RATE,         //!< Requests sent to neighbor 1 per second
+  RDC_EVNT_XGMI_1_RESP_TX_RATE,        //!< Responses sent to neighbor 1 per second
+  RDC_EVNT_XGMI_1_BEATS_TX_RATE,       //!< Data beats sent to neighbor 1 per second
+
+  RDC_FI_RATE_FIRST = RDC_FI_ECC_CORRECT_RATE,
+  RDC_FI_RATE_LAST = RDC_EVNT_XGMI_1_BEATS_TX_RATE,
 } rdc_field_t;
 
 // even and odd numbers are used for correctable and uncorrectable errors
@@ -382,6 +498,10 @@ typedef struct {
   uint64_t min_value;         //!< Minimum value measured
   uint64_t average;           //!< Average value measured
   double standard_deviation;  //!< The standard deviation
+  uint64_t p50;               //!< Median, within 1% like the other percentiles
+  uint64_t p90;               //!< 90th percentile
+  uint64_t p95;               //!< 95th percentile
+  uint64_t p99;               //!< 99th percentile
 } rdc_stats_summary_t;
 
 /**
@@ -417,6 +537,69 @@ typedef struct {
   rdc_gpu_usage_info_t gpus[16];  //!< Job usage summary statistics by GPU
 } rdc_job_info_t;
 
+/**
+ * @brief Max number of points in a job timeline
+ */
+#define RDC_MAX_TIMELINE_POINTS 128
+
+/**
+ * @brief The samples of a field which fell into one bucket of a timeline,
+ * in the units of rdc_stats_summary_t
+ */
+typedef struct {
+  uint64_t start_ts;  //!< Start of the bucket in milliseconds since 1970
+  uint32_t count;     //!< Number of samples, 0 when the field was not updated
+  double min_value;
+  double max_value;
+  double average;
+} rdc_timeline_point_t;
+
+/**
+ * @brief The downsampled timeline of a field over the life of a job
+ */
+typedef struct {
+  uint64_t bucket_ms;  //!< Width of the buckets, it doubles as the job ages
+  uint32_t num_points;
+  rdc_timeline_point_t points[RDC_MAX_TIMELINE_POINTS];  //!< Oldest first
+} rdc_job_timeline_t;
+
+/**
+ * @brief Max number of jobs in one page of rdc_job_list()
+ */
+#define RDC_MAX_JOB_LIST 32
+
+/**
+ * @brief The stopped jobs to list. A job matches when it started within
+ * [start_since, start_until] and, if field_id is set, the summary average
+ * of that field is within [min_average, max_average].
+ */
+typedef struct {
+  uint64_t start_since;  //!< In seconds since 1970
+  uint64_t start_until;  //!< In seconds since 1970, 0 for no bound
+  rdc_field_t field_id;  //!< A job stats field, or RDC_FI_INVALID for no filter
+  uint64_t min_average;  //!< In the units of rdc_stats_summary_t
+  uint64_t max_average;  //!< 0 for no bound
+  uint64_t cursor;       //!< 0 for the first page, then next_cursor
+} rdc_job_filter_t;
+
+/**
+ * @brief A stopped job read from the job store
+ */
+typedef struct {
+  char job_id[64];
+  uint32_t num_gpus;
+  rdc_gpu_usage_info_t summary;  //!< As reported by rdc_job_get_stats()
+} rdc_job_record_t;
+
+/**
+ * @brief One page of stopped jobs, by start time
+ */
+typedef struct {
+  uint32_t num_jobs;
+  uint64_t next_cursor;  //!< 0 when this is the last page
+  rdc_job_record_t jobs[RDC_MAX_JOB_LIST];
+} rdc_job_list_t;
+
 /**
  * @brief Field value data
  */
@@ -552,6 +735,293 @@ typedef struct {
   rdc_diag_test_result_t diag_info[MAX_TEST_CASES];
 } rdc_diag_response_t;
 
+/**
+ * @brief The maximum number of instrumented code paths reported
+ */
+#define RDC_MAX_NUM_PERF_STATS 256
+
+/**
+ * @brief The maximum length of an instrumented code path name
+ */
+#define RDC_MAX_PERF_STAT_NAME 64
+
+/**
+ * @brief Latency distribution of one instrumented code path. Percentiles
+ * are accurate to within 1/16 of their value.
+ */
+typedef struct {
+  char name[RDC_MAX_PERF_STAT_NAME];  //!< The instrumented code path
+  uint64_t count;                     //!< Number of timed calls
+  uint64_t total_ns;                  //!< Total time spent in nanoseconds
+  uint64_t max_ns;                    //!< Slowest call in nanoseconds
+  uint64_t p50_ns;                    //!< Median in nanoseconds
+  uint64_t p90_ns;                    //!< 90th percentile in nanoseconds
+  uint64_t p99_ns;                    //!< 99th percentile in nanoseconds
+  uint64_t p999_ns;                   //!< 99.9th percentile in nanoseconds
+} rdc_perf_stat_t;
+
+/**
+ * @brief The latency distributions of all instrumented code paths
+ */
+typedef struct {
+  uint32_t num_stats;
+  rdc_perf_stat_t stats[RDC_MAX_NUM_PERF_STATS];
+} rdc_perf_stats_t;
+
+/**
+ * @brief The maximum number of buckets returned by rdc_field_get_rollup()
+ */
+#define RDC_MAX_ROLLUP_BUCKETS 1024
+
+/**
+ * @brief The aggregate of the samples of a numeric field in one time bucket
+ */
+typedef struct {
+  uint64_t start_ts;  //!< Start of the bucket in milliseconds since 1970
+  uint64_t last_ts;   //!< Timestamp of the newest sample in the bucket
+  uint64_t count;     //!< Number of samples in the bucket
+  double min_value;   //!< Smallest sample
+  double max_value;   //!< Largest sample
+  double sum;         //!< Sum of the samples, sum / count is the average
+  double last_value;  //!< The newest sample
+} rdc_field_rollup_t;
+
+/**
+ * @brief The history of a field at one resolution
+ */
+typedef struct {
+  uint64_t resolution_ms;  //!< Width of the buckets, 0 for raw samples
+  uint32_t num_buckets;
+  rdc_field_rollup_t buckets[RDC_MAX_ROLLUP_BUCKETS];  //!< Oldest first
+} rdc_field_rollups_t;
+
+/**
+ * @brief The maximum number of values returned by rdc_field_get_history()
+ */
+#define RDC_MAX_HISTORY_VALUES 256
+
+/**
+ * @brief A page of the on-disk history of a field
+ */
+typedef struct {
+  uint64_t next_since_ts;  //!< since_ts of the next page, 0 when there is no more
+  uint32_t num_values;
+  rdc_field_value values[RDC_MAX_HISTORY_VALUES];  //!< Oldest first
+} rdc_field_history_t;
+
+/**
+ * @brief The condition of a policy rule
+ */
+typedef enum {
+  RDC_POLICY_ABOVE = 0,  //!< The value is above the threshold
+  RDC_POLICY_BELOW,      //!< The value is below the threshold
+  RDC_POLICY_INCREASED   //!< The value grew since the previous sample, such
+                         //!< as RDC_FI_ECC_UNCORRECT_TOTAL
+} rdc_policy_condition_t;
+
+/**
+ * @brief A rule evaluated on every sample of a watched field. The values
+ * are in the units of the samples, such as millidegrees Celsius for
+ * RDC_FI_GPU_TEMP.
+ */
+typedef struct {
+  uint32_t gpu_index;  //!< The GPU, or GPU_ID_INVALID for every GPU
+  rdc_field_t field_id;
+  rdc_policy_condition_t condition;
+  double threshold;      //!< Unused by RDC_POLICY_INCREASED
+  double hysteresis;     //!< How far back past the threshold the value must
+                         //!< come for the violation to clear
+  uint64_t duration_ms;  //!< How long the condition must hold, 0 to raise
+                         //!< a violation on the first sample
+} rdc_policy_rule_t;
+
+/**
+ * @brief A rule which started or stopped being violated
+ */
+typedef struct {
+  uint64_t seq;      //!< Increases by one per violation
+  uint32_t rule_id;  //!< As returned by rdc_policy_add_rule()
+  uint32_t gpu_index;
+  rdc_field_t field_id;
+  uint64_t ts;       //!< Timestamp of the sample in milliseconds since 1970
+  double value;      //!< The sample
+  uint32_t cleared;  //!< 1 when the value came back past the hysteresis
+} rdc_policy_violation_t;
+
+/**
+ * @brief The maximum number of violations returned per call
+ */
+#define RDC_MAX_POLICY_VIOLATIONS 64
+
+/**
+ * @brief The violations after a sequence number, oldest first
+ */
+typedef struct {
+  uint64_t num_missed;  //!< Violations dropped from the queue before read
+  uint32_t num_violations;
+  rdc_policy_violation_t violations[RDC_MAX_POLICY_VIOLATIONS];
+} rdc_policy_violations_t;
+
+/**
+ * @brief The number of anomaly detectors, one per RDC_FI_ANOMALY_SCORE_<N>
+ */
+#define RDC_MAX_ANOMALY_DETECTORS 8
+
+/**
+ * @brief The settings of an anomaly detector. The detector keeps an EWMA
+ * of the mean and variance of the field per GPU, and optionally one per
+ * slice of a period, such as a day or the iteration of a training job.
+ */
+typedef struct {
+  rdc_field_t field_id;
+  double alpha;              //!< Weight of a new sample in the EWMA, in
+                             //!< (0, 1]; smaller follows slower drifts
+  double threshold;          //!< The score raising RDC_EVNT_NOTIF_ANOMALY
+  uint32_t warmup_samples;   //!< Samples learnt before a baseline is scored
+  uint32_t season_period_s;  //!< The period of the seasonal baselines in
+                             //!< seconds, 0 to only keep the global one
+} rdc_anomaly_config_t;
+
+/**
+ * @brief The number of derived fields, RDC_FI_DERIVED_0 and on
+ */
+#define RDC_MAX_DERIVED_FIELDS 16
+
+/**
+ * @brief In an aggregator rdcd, the GPU index of a downstream GPU is its
+ * index on the downstream rdcd plus the gpu_base of the host, which is
+ * (host_id + 1) * RDC_AGGREGATE_GPU_BASE
+ */
+#define RDC_AGGREGATE_GPU_BASE 0x10000
+
+/**
+ * @brief The maximum number of downstream rdcds of an aggregator
+ */
+#define RDC_MAX_AGGREGATE_HOSTS 256
+
+/**
+ * @brief The reduction of a field over the GPUs of all the downstream rdcds,
+ * or over a GPU group
+ */
+typedef enum {
+  RDC_AGGREGATE_SUM = 0,  //!< Such as the power of the cluster
+  RDC_AGGREGATE_AVG,
+  RDC_AGGREGATE_MIN,
+  RDC_AGGREGATE_MAX,        //!< Such as the hottest GPU
+  RDC_AGGREGATE_LAST,       //!< The newest sample, only for a GPU group
+  RDC_AGGREGATE_PERCENTILE  //!< Only for a GPU group
+} rdc_aggregate_op_t;
+
+/**
+ * @brief A downstream rdcd of an aggregator
+ */
+typedef struct {
+  char host[RDC_MAX_STR_LENGTH];  //!< host:port as listed to the aggregator
+  uint32_t host_id;
+  uint32_t gpu_base;              //!< Added to the downstream GPU indexes
+  uint32_t connected;             //!< 1 while its stream is up
+  uint32_t num_gpus;              //!< The GPUs it sent samples of
+  uint64_t last_sample_ts;        //!< Timestamp of its latest sample
+  uint64_t num_samples;           //!< Samples received
+  uint64_t num_reconnects;        //!< Streams opened again after a failure
+} rdc_aggregate_host_t;
+
+/**
+ * @brief The downstream rdcds of an aggregator
+ */
+typedef struct {
+  uint32_t num_hosts;
+  rdc_aggregate_host_t hosts[RDC_MAX_AGGREGATE_HOSTS];
+} rdc_aggregate_hosts_t;
+
+/**
+ * @brief A field reduced over the GPUs of all the downstream rdcds
+ */
+typedef struct {
+  double value;
+  uint32_t num_gpus;   //!< The GPUs with a recent sample, which were reduced
+  uint32_t gpu_index;  //!< For RDC_AGGREGATE_MIN and RDC_AGGREGATE_MAX, the
+                       //!< aggregator GPU index of the value
+  uint32_t host_id;    //!< and its downstream rdcd
+  uint64_t ts;         //!< Timestamp of the oldest sample reduced
+} rdc_cluster_aggregate_t;
+
+/**
+ * @brief The maximum number of reductions of one rdc_field_get_group_aggregate()
+ */
+#define RDC_MAX_GROUP_AGGREGATE_OPS 8
+
+/**
+ * @brief A reduction asked of rdc_field_get_group_aggregate()
+ */
+typedef struct {
+  rdc_aggregate_op_t op;
+  double percentile;  //!< For RDC_AGGREGATE_PERCENTILE, from 0 to 100
+} rdc_aggregate_spec_t;
+
+/**
+ * @brief A field of a field group reduced over the GPUs of a GPU group
+ */
+typedef struct {
+  rdc_field_t field_id;
+  rdc_aggregate_spec_t spec;
+  rdc_status_t status;   //!< RDC_ST_NOT_FOUND when no GPU has a numeric sample
+  double value;
+  uint32_t num_gpus;     //!< The GPUs with samples, which were reduced
+  uint64_t num_samples;  //!< The samples reduced
+  uint32_t gpu_index;    //!< For RDC_AGGREGATE_MIN, RDC_AGGREGATE_MAX and
+                         //!< RDC_AGGREGATE_LAST, the GPU of the value
+  uint64_t ts;           //!< and its timestamp, else the newest sample reduced
+} rdc_group_aggregate_value_t;
+
+/**
+ * @brief The reductions of a field group over a GPU group
+ */
+typedef struct {
+  uint32_t num_values;
+  //!< For each field of the field group, one value per reduction in order
+  rdc_group_aggregate_value_t
+      values[RDC_MAX_FIELD_IDS_PER_FIELD_GROUP * RDC_MAX_GROUP_AGGREGATE_OPS];
+} rdc_group_aggregate_t;
+
+/**
+ * @brief The verbosity of RDC's own log
+ */
+typedef enum {
+  RDC_LOG_LEVEL_ERROR = 0,  //!< Errors only
+  RDC_LOG_LEVEL_INFO,       //!< Errors and informational messages
+  RDC_LOG_LEVEL_DEBUG       //!< Everything, including every field fetch
+} rdc_log_level_t;
+
+/**
+ * @brief The maximum number of pipeline trace events returned per call
+ */
+#define RDC_MAX_NUM_PIPELINE_EVENTS 1024
+
+/**
+ * @brief One timed span of the collection pipeline, such as an update
+ * tick, a module dispatch, a per field SMI call, a cache ingest or a gRPC
+ * handler.
+ */
+typedef struct {
+  char name[RDC_MAX_PERF_STAT_NAME];  //!< The traced code path
+  uint64_t seq;                       //!< Sequence number of the event
+  uint64_t ts_us;                     //!< Start on a monotonic clock in microseconds
+  uint64_t dur_us;                    //!< Duration in microseconds
+  uint32_t tid;                       //!< The thread which ran the span
+  uint32_t gpu_index;                 //!< The GPU, or GPU_ID_INVALID
+  rdc_field_t field_id;               //!< The field, or RDC_FI_INVALID
+} rdc_pipeline_event_t;
+
+/**
+ * @brief A batch of pipeline trace events
+ */
+typedef struct {
+  uint64_t next_seq;  //!< Pass as start_seq to get the following events
+  uint32_t num_events;
+  rdc_pipeline_event_t events[RDC_MAX_NUM_PIPELINE_EVENTS];
+} rdc_pipeline_events_t;
+
 /**
  *  @brief Initialize ROCm RDC.
  *
@@ -560,6 +1030,7 @@ typedef struct {
  *  This must be called before rdc_start_embedded() or rdc_connect()
  *
  *  @param[in] init_flags init_flags Bit flags that tell RDC how to initialize.
+ *  See ::rdc_init_flags_t.
  *
  *  @retval ::RDC_ST_OK is returned upon successful call.
  */
@@ -698,12 +1169,62 @@ rdc_status_t rdc_job_get_stats(rdc_handle_t p_rdc_handle, const char job_id[64],
  */
 rdc_status_t rdc_job_stop_stats(rdc_handle_t p_rdc_handle, const char job_id[64]);
 
+/**
+ *  @brief Get the timeline of a field of a job on one GPU.
+ *
+ *  @details The samples which update the job stats are also folded into
+ *  RDC_MAX_TIMELINE_POINTS buckets per GPU and field. The buckets start 1
+ *  second wide and are merged in pairs whenever the job outgrows them, so
+ *  the timeline covers the whole job in fixed memory. The timelines are
+ *  kept in memory only, they start over when rdcd restarts.
+ *
+ *  @param[in] p_rdc_handle The RDC handler.
+ *
+ *  @param[in] job_id The name of the job.
+ *
+ *  @param[in] gpu_index The GPU index in the job group.
+ *
+ *  @param[in] field One of the job stats fields, such as RDC_FI_POWER_USAGE.
+ *
+ *  @param[inout] timeline Caller provided pointer to rdc_job_timeline_t.
+ *
+ *  @retval ::RDC_ST_OK is returned upon successful call.
+ *  @retval ::RDC_ST_NOT_FOUND when the job, the GPU or the field is not
+ *  part of the job stats, or no sample was seen yet.
+ */
+rdc_status_t rdc_job_get_timeline(rdc_handle_t p_rdc_handle, const char job_id[64],
+                                  uint32_t gpu_index, rdc_field_t field,
+                                  rdc_job_timeline_t* timeline);
+
+/**
+ *  @brief List the stopped jobs kept in the job store.
+ *
+ *  @details When rdcd runs with RDC_JOB_STORE_DIR set, the stats of every
+ *  stopped job are appended to an indexed log in that directory. They
+ *  outlive rdc_job_remove() and restarts of rdcd, and rdc_job_get_stats()
+ *  reads a job back from the store once it is no longer in memory.
+ *
+ *  @param[in] p_rdc_handle The RDC handler.
+ *
+ *  @param[in] filter The start time range, an optional filter on the
+ *  average of a field and the cursor of the page.
+ *
+ *  @param[inout] jobs Caller provided pointer to rdc_job_list_t. Upon
+ *  successful call, it holds up to RDC_MAX_JOB_LIST jobs by start time.
+ *
+ *  @retval ::RDC_ST_OK is returned upon successful call.
+ *  @retval ::RDC_ST_NOT_SUPPORTED when the job store is not enabled.
+ */
+rdc_status_t rdc_job_list(rdc_handle_t p_rdc_handle, const rdc_job_filter_t* filter,
+                          rdc_job_list_t* jobs);
+
 /**
  *  @brief Request RDC to stop tracking the job given by job_id
  *
  *  @details After this call, you will no longer be able to call
- *  rdc_job_get_stats() on this job_id. But you will be able to reuse
- *  the job_id after this call.
+ *  rdc_job_get_stats() on this job_id, unless the job store keeps it,
+ *  see rdc_job_list(). But you will be able to reuse the job_id after
+ *  this call.
  *
  *  @param[in] p_rdc_handle The RDC handler.
  *
@@ -1023,6 +1544,310 @@ rdc_status_t rdc_field_get_value_since(rdc_handle_t p_rdc_handle, uint32_t gpu_i
                                        rdc_field_t field, uint64_t since_time_stamp,
                                        uint64_t* next_since_time_stamp, rdc_field_value* value);
 
+/**
+ *  @brief Get the history of a numeric field over a time range
+ *
+ *  @details Besides the raw samples, RDC rolls every numeric sample up into
+ *  coarser tiers of min/max/sum/count/last buckets, by default 10 seconds
+ *  kept for 1 hour, 1 minute kept for 6 hours and 10 minutes kept for 24
+ *  hours (see RDC_ROLLUP_TIERS). This returns the range from the finest
+ *  tier, raw samples included, which reaches back to start_ts and fits in
+ *  RDC_MAX_ROLLUP_BUCKETS. When no tier reaches back that far, the one
+ *  reaching back the furthest is used. Raw samples are returned as buckets
+ *  of one sample.
+ *
+ *  @param[in] p_rdc_handle The RDC handler.
+ *
+ *  @param[in] gpu_index The GPU index.
+ *
+ *  @param[in] field The field id.
+ *
+ *  @param[in] start_ts Start of the range in milliseconds since 1970.
+ *
+ *  @param[in] end_ts End of the range in milliseconds since 1970.
+ *
+ *  @param[out] rollups The buckets overlapping the range, oldest first.
+ *
+ *  @retval ::RDC_ST_OK is returned upon successful call.
+ *  @retval ::RDC_ST_NOT_FOUND is returned when nothing is cached in range.
+ */
+rdc_status_t rdc_field_get_rollup(rdc_handle_t p_rdc_handle, uint32_t gpu_index,
+                                  rdc_field_t field, uint64_t start_ts, uint64_t end_ts,
+                                  rdc_field_rollups_t* rollups);
+
+/**
+ *  @brief Get the values of a field or event from the on-disk history log
+ *
+ *  @details When RDC_HISTORY_DIR is set, rdcd streams every ingested value
+ *  and event into rotating segment files, which outlive the cache. This
+ *  scans only the segments and blocks overlapping the range. The values
+ *  ingested in the last few seconds may not be written yet. When the range
+ *  holds more than RDC_MAX_HISTORY_VALUES values, call again with
+ *  next_since_ts as since_ts.
+ *
+ *  @param[in] p_rdc_handle The RDC handler.
+ *
+ *  @param[in] gpu_index The GPU index.
+ *
+ *  @param[in] field The field or event id.
+ *
+ *  @param[in] since_ts Start of the range in milliseconds since 1970.
+ *
+ *  @param[in] until_ts End of the range in milliseconds since 1970.
+ *
+ *  @param[out] history The values in range, oldest first.
+ *
+ *  @retval ::RDC_ST_OK is returned upon successful call.
+ *  @retval ::RDC_ST_NOT_SUPPORTED is returned when the history log is off.
+ */
+rdc_status_t rdc_field_get_history(rdc_handle_t p_rdc_handle, uint32_t gpu_index,
+                                   rdc_field_t field, uint64_t since_ts, uint64_t until_ts,
+                                   rdc_field_history_t* history);
+
+/**
+ *  @brief Add a policy rule
+ *
+ *  @details The rule is evaluated by rdcd on every sample of the field as it
+ *  is cached, so clients need not poll the field to compare it. Only the
+ *  watched fields are sampled; watch the field with rdc_field_watch(). A
+ *  violation is raised once the condition held for duration_ms, and cleared
+ *  once the value came back past the threshold by the hysteresis. Read
+ *  them with rdc_policy_get_violations().
+ *
+ *  @param[in] p_rdc_handle The RDC handler.
+ *
+ *  @param[in] rule The rule, such as RDC_FI_GPU_TEMP above 95000 for 10000
+ *  milliseconds.
+ *
+ *  @param[out] rule_id The id of the rule.
+ *
+ *  @retval ::RDC_ST_OK is returned upon successful call.
+ */
+rdc_status_t rdc_policy_add_rule(rdc_handle_t p_rdc_handle, const rdc_policy_rule_t* rule,
+                                 uint32_t* rule_id);
+
+/**
+ *  @brief Delete a policy rule
+ *
+ *  @param[in] p_rdc_handle The RDC handler.
+ *
+ *  @param[in] rule_id The id returned by rdc_policy_add_rule().
+ *
+ *  @retval ::RDC_ST_OK is returned upon successful call.
+ *  @retval ::RDC_ST_NOT_FOUND when there is no such rule.
+ */
+rdc_status_t rdc_policy_delete_rule(rdc_handle_t p_rdc_handle, uint32_t rule_id);
+
+/**
+ *  @brief Get the policy violations raised or cleared after a sequence number
+ *
+ *  @details When there is none, wait up to timeout_ms for one. Pass the seq
+ *  of the last violation read as since_seq of the next call, 0 the first
+ *  time. rdcd keeps the last few thousand violations.
+ *
+ *  @param[in] p_rdc_handle The RDC handler.
+ *
+ *  @param[in] since_seq Only the violations with a greater seq.
+ *
+ *  @param[in] timeout_ms How long to wait for a violation, 0 to return
+ *  at once.
+ *
+ *  @param[out] violations The violations, oldest first.
+ *
+ *  @retval ::RDC_ST_OK is returned upon successful call, also when it
+ *  timed out without violation.
+ */
+rdc_status_t rdc_policy_get_violations(rdc_handle_t p_rdc_handle, uint64_t since_seq,
+                                       uint32_t timeout_ms, rdc_policy_violations_t* violations);
+
+/**
+ *  @brief Set an anomaly detector
+ *
+ *  @details The detector scores every cached sample of the field against
+ *  a baseline of the same GPU: the seasonal baseline of the slice of the
+ *  period the sample falls in once it has learnt warmup_samples, else the
+ *  global one. The score is the distance to the mean in standard
+ *  deviations and is published as RDC_FI_ANOMALY_SCORE_<detector_id>.
+ *  When its magnitude reaches the threshold, an RDC_EVNT_NOTIF_ANOMALY
+ *  event is cached for the GPU; it is raised again only after the score
+ *  fell below half the threshold. Only the watched fields are sampled.
+ *  Setting a detector again restarts its baselines.
+ *
+ *  @param[in] p_rdc_handle The RDC handler.
+ *
+ *  @param[in] detector_id The detector, below RDC_MAX_ANOMALY_DETECTORS.
+ *
+ *  @param[in] config The field to watch and the detector settings.
+ *
+ *  @retval ::RDC_ST_OK is returned upon successful call.
+ */
+rdc_status_t rdc_anomaly_set_detector(rdc_handle_t p_rdc_handle, uint32_t detector_id,
+                                      const rdc_anomaly_config_t* config);
+
+/**
+ *  @brief Clear an anomaly detector
+ *
+ *  @param[in] p_rdc_handle The RDC handler.
+ *
+ *  @param[in] detector_id The detector, below RDC_MAX_ANOMALY_DETECTORS.
+ *
+ *  @retval ::RDC_ST_OK is returned upon successful call.
+ *  @retval ::RDC_ST_NOT_FOUND when the detector is not set.
+ */
+rdc_status_t rdc_anomaly_clear_detector(rdc_handle_t p_rdc_handle, uint32_t detector_id);
+
+/**
+ *  @brief Set the expression of a derived field
+ *
+ *  @details The expression is arithmetic over the other fields of the same
+ *  GPU, named as in rdc.h, and over the GPUs of the group the derived field
+ *  is watched on with sum(), avg(), min() and max(). For instance, the
+ *  memory used in percent:
+ *
+ *      RDC_FI_GPU_MEMORY_USAGE * 100 / RDC_FI_GPU_MEMORY_TOTAL
+ *
+ *  It is compiled once and evaluated whenever a sample of one of its fields
+ *  is cached, on the latest sample of each field newer than the update
+ *  interval. The derived field is then watched, cached and queried like
+ *  the others, and watching it watches the fields it reads. Expressions
+ *  can also be loaded at start from the file named by RDC_DERIVED_FIELDS,
+ *  one "RDC_FI_DERIVED_<N> = <expression>" per line.
+ *
+ *  @param[in] p_rdc_handle The RDC handler.
+ *
+ *  @param[in] field_id One of RDC_FI_DERIVED_0 to RDC_FI_DERIVED_15.
+ *
+ *  @param[in] expression The expression, shorter than RDC_MAX_STR_LENGTH.
+ *
+ *  @retval ::RDC_ST_OK is returned upon successful call.
+ *  @retval ::RDC_ST_BAD_PARAMETER when the expression does not parse.
+ */
+rdc_status_t rdc_field_derived_set(rdc_handle_t p_rdc_handle, rdc_field_t field_id,
+                                   const char* expression);
+
+/**
+ *  @brief Clear the expression of a derived field
+ *
+ *  @param[in] p_rdc_handle The RDC handler.
+ *
+ *  @param[in] field_id One of RDC_FI_DERIVED_0 to RDC_FI_DERIVED_15.
+ *
+ *  @retval ::RDC_ST_OK is returned upon successful call.
+ *  @retval ::RDC_ST_NOT_FOUND when the field has no expression.
+ */
+rdc_status_t rdc_field_derived_clear(rdc_handle_t p_rdc_handle, rdc_field_t field_id);
+
+/**
+ *  @brief Ingest samples collected elsewhere into the cache
+ *
+ *  @details The samples go through the same path as the watched fields:
+ *  they are cached, logged, exported and evaluated by the policy rules,
+ *  the anomaly detectors and the derived fields. They are evicted by
+ *  max_keep_age and max_keep_samples as if the field were watched. An
+ *  aggregator rdcd ingests the samples of its downstream rdcds this way.
+ *  It is only supported in the embedded mode.
+ *
+ *  @param[in] p_rdc_handle The RDC handler.
+ *
+ *  @param[in] gpu_index The GPU index to cache the samples under.
+ *
+ *  @param[in] values The samples, whose status is RDC_ST_OK.
+ *
+ *  @param[in] num_values The number of samples.
+ *
+ *  @param[in] max_keep_age How long to keep the samples in seconds.
+ *
+ *  @param[in] max_keep_samples How many samples to keep per field.
+ *
+ *  @retval ::RDC_ST_OK is returned upon successful call.
+ *  @retval ::RDC_ST_NOT_SUPPORTED in the standalone mode.
+ */
+rdc_status_t rdc_field_ingest(rdc_handle_t p_rdc_handle, uint32_t gpu_index,
+                              const rdc_field_value* values, uint32_t num_values,
+                              double max_keep_age, uint32_t max_keep_samples);
+
+/**
+ *  @brief Get the downstream rdcds of an aggregator rdcd
+ *
+ *  @details rdcd runs as an aggregator when started with --aggregate. It
+ *  streams the samples of every listed rdcd into its own cache, under the
+ *  GPU indexes offset by the gpu_base of the host, so the field APIs work
+ *  on them as on local GPUs.
+ *
+ *  @param[in] p_rdc_handle The RDC handler.
+ *
+ *  @param[out] hosts The downstream rdcds, by host_id.
+ *
+ *  @retval ::RDC_ST_OK is returned upon successful call.
+ *  @retval ::RDC_ST_NOT_SUPPORTED when rdcd is not an aggregator, and in
+ *  the embedded mode.
+ */
+rdc_status_t rdc_aggregate_get_hosts(rdc_handle_t p_rdc_handle, rdc_aggregate_hosts_t* hosts);
+
+/**
+ *  @brief Reduce the latest sample of a field over every downstream GPU of
+ *  an aggregator rdcd
+ *
+ *  @details For instance, RDC_FI_POWER_USAGE with RDC_AGGREGATE_SUM is the
+ *  power of the cluster, and RDC_FI_GPU_TEMP with RDC_AGGREGATE_MAX finds
+ *  the hottest GPU. The GPUs whose latest sample is older than ten update
+ *  periods are left out. The field must be one the aggregator streams.
+ *
+ *  @param[in] p_rdc_handle The RDC handler.
+ *
+ *  @param[in] field The field, of numeric values.
+ *
+ *  @param[in] op The reduction, from RDC_AGGREGATE_SUM to RDC_AGGREGATE_MAX.
+ *
+ *  @param[out] aggregate The reduced value.
+ *
+ *  @retval ::RDC_ST_OK is returned upon successful call.
+ *  @retval ::RDC_ST_NOT_FOUND when no GPU has a recent sample of the field.
+ *  @retval ::RDC_ST_NOT_SUPPORTED when rdcd is not an aggregator, and in
+ *  the embedded mode.
+ */
+rdc_status_t rdc_aggregate_get_field(rdc_handle_t p_rdc_handle, rdc_field_t field,
+                                     rdc_aggregate_op_t op, rdc_cluster_aggregate_t* aggregate);
+
+/**
+ *  @brief Reduce the cached samples of a field group over a GPU group
+ *
+ *  @details This answers questions such as the power of a GPU group or its
+ *  hottest GPU over the last minute inside RDC, without fetching the samples
+ *  of every GPU. Each reduction is over the samples of the last window_ms,
+ *  or over the latest sample of each GPU when window_ms is 0:
+ *  - RDC_AGGREGATE_SUM adds up the average of each GPU over the window
+ *  - RDC_AGGREGATE_AVG is that sum divided by the number of GPUs
+ *  - RDC_AGGREGATE_MIN, RDC_AGGREGATE_MAX and RDC_AGGREGATE_PERCENTILE are
+ *    over every sample of every GPU in the window
+ *  - RDC_AGGREGATE_LAST is the newest sample of any GPU
+ *
+ *  The window reaches back only as far as the cache keeps the samples, see
+ *  rdc_field_watch(). The fields of string values are not reduced.
+ *
+ *  @param[in] p_rdc_handle The RDC handler.
+ *
+ *  @param[in] group_id The GPU group.
+ *
+ *  @param[in] field_group_id The field group.
+ *
+ *  @param[in] window_ms The window in milliseconds back from now, or 0.
+ *
+ *  @param[in] specs The reductions.
+ *
+ *  @param[in] num_specs The number of reductions, up to
+ *  RDC_MAX_GROUP_AGGREGATE_OPS.
+ *
+ *  @param[out] aggregate For each field, one value per reduction.
+ *
+ *  @retval ::RDC_ST_OK is returned upon successful call.
+ *  @retval ::RDC_ST_NOT_FOUND when a group does not exist.
+ */
+rdc_status_t rdc_field_get_group_aggregate(rdc_handle_t p_rdc_handle, rdc_gpu_group_t group_id,
+                                           rdc_field_grp_t field_group_id, uint64_t window_ms,
+                                           const rdc_aggregate_spec_t* specs, uint32_t num_specs,
+                                           rdc_group_aggregate_t* aggregate);
+
 /**
  *  @brief Stop record updates for a given field collection.
  *
@@ -1087,6 +1912,72 @@ rdc_status_t rdc_test_case_run(rdc_handle_t p_rdc_handle, rdc_gpu_group_t group_
                                rdc_diag_test_cases_t test_case, const char* config,
                                size_t config_size, rdc_diag_test_result_t* result);
 
+/**
+ *  @brief Get the latency distributions of RDC's own hot paths
+ *
+ *  @details Returns the field fetches, module dispatches, cache operations
+ *  and, when connected to rdcd, the gRPC handlers, since RDC started.
+ *  Code paths which have not run yet are not reported.
+ *
+ *  @param[in] p_rdc_handle The RDC handler.
+ *
+ *  @param[out] stats The latency distributions.
+ *
+ *  @retval ::RDC_ST_OK is returned upon successful call.
+ */
+rdc_status_t rdc_perf_stats_get(rdc_handle_t p_rdc_handle, rdc_perf_stats_t* stats);
+
+/**
+ *  @brief Start or stop tracing the collection pipeline
+ *
+ *  @details While enabled, RDC records a begin/end span for every update
+ *  tick, module dispatch, per field SMI call, cache ingest and, when
+ *  connected to rdcd, gRPC handler into a bounded in-memory ring. Enabling
+ *  discards the events of the previous trace. When disabled the events are
+ *  kept until the next trace starts.
+ *
+ *  @param[in] p_rdc_handle The RDC handler.
+ *
+ *  @param[in] enabled 1 to start tracing, 0 to stop.
+ *
+ *  @retval ::RDC_ST_OK is returned upon successful call.
+ */
+rdc_status_t rdc_pipeline_trace_set(rdc_handle_t p_rdc_handle, uint32_t enabled);
+
+/**
+ *  @brief Get the recorded pipeline trace events
+ *
+ *  @details Returns up to RDC_MAX_NUM_PIPELINE_EVENTS events starting at
+ *  sequence number start_seq, oldest first. Events which were overwritten
+ *  in the ring are skipped. Call again with events->next_seq until
+ *  num_events is 0 to read the whole ring.
+ *
+ *  @param[in] p_rdc_handle The RDC handler.
+ *
+ *  @param[in] start_seq The first sequence number to return, 0 for the
+ *  oldest event in the ring.
+ *
+ *  @param[out] events The trace events.
+ *
+ *  @retval ::RDC_ST_OK is returned upon successful call.
+ */
+rdc_status_t rdc_pipeline_trace_get(rdc_handle_t p_rdc_handle, uint64_t start_seq,
+                                    rdc_pipeline_events_t* events);
+
+/**
+ *  @brief Change the verbosity of RDC's log at runtime
+ *
+ *  @details The level starts from the RDC_LOG environment variable. When
+ *  connected to rdcd, this changes the log level of rdcd.
+ *
+ *  @param[in] p_rdc_handle The RDC handler.
+ *
+ *  @param[in] level The new log level.
+ *
+ *  @retval ::RDC_ST_OK is returned upon successful call.
+ */
+rdc_status_t rdc_log_level_set(rdc_handle_t p_rdc_handle, rdc_log_level_t level);
+
 /**
  *  @brief Get a description of a provided RDC error status
  *
@@ -59,6 +59,34 @@ typedef enum {
  */
 rdc_status_t get_mixed_component_version(rdc_handle_t p_rdc_handle, mixed_component_t component, mixed_component_version_t* p_mixed_compv);
 
+/**
+ *  @brief Get the generations of the cached samples of a field and of the
+ *  groups.
+ *
+ *  @details rdcd reuses the replies of its hot read RPCs while the
+ *  generation they were built at is still current. The cache generation
+ *  advances whenever the latest sample of the field on the GPU may have
+ *  changed, so a sample of another GPU or field leaves it alone. The group
+ *  generation advances whenever a GPU group or a field group changes.
+ *
+ *  @param[in] p_rdc_handle The RDC handler.
+ *
+ *  @param[in] gpu_index The GPU of the field.
+ *
+ *  @param[in] field_id The field of the samples.
+ *
+ *  @param[out] cache_generation The generation of the cached samples of the
+ *  field on the GPU.
+ *
+ *  @param[out] group_generation The generation of the groups.
+ *
+ *  @retval ::RDC_ST_OK is returned upon successful call.
+ *  @retval ::RDC_ST_NOT_SUPPORTED is returned in the standalone mode.
+ */
+rdc_status_t get_cache_generation(rdc_handle_t p_rdc_handle, uint32_t gpu_index,
+                                  rdc_field_t field_id, uint64_t* cache_generation,
+                                  uint64_t* group_generation);
+
 #ifdef __cplusplus
 }
 #endif  // __cplusplus
@@ -42,10 +42,25 @@ class RdcCacheManager {
                                                  uint64_t since_time_stamp,
                                                  uint64_t* next_since_time_stamp,
                                                  rdc_field_value* value) = 0;
+  virtual rdc_status_t rdc_field_get_rollup(uint32_t gpu_index, rdc_field_t field,
+                                            uint64_t start_ts, uint64_t end_ts,
+                                            rdc_field_rollups_t* rollups) = 0;
+  //!< Reduce the samples of the fields over the GPUs, see
+  //!< rdc_field_get_group_aggregate()
+  virtual rdc_status_t rdc_field_get_group_aggregate(const std::vector<uint32_t>& gpu_indexes,
+                                                     const std::vector<rdc_field_t>& field_ids,
+                                                     uint64_t window_ms,
+                                                     const rdc_aggregate_spec_t* specs,
+                                                     uint32_t num_specs,
+                                                     rdc_group_aggregate_t* aggregate) = 0;
   virtual rdc_status_t rdc_update_cache(uint32_t gpu_index, const rdc_field_value& value) = 0;
   virtual rdc_status_t evict_cache(uint32_t gpu_index, rdc_field_t field_id,
                                    uint64_t max_keep_samples, double max_keep_age) = 0;
   virtual std::string get_cache_stats() = 0;
+  //!< Number of cached samples and an estimate of the memory they use
+  virtual void get_cache_usage(uint64_t* num_samples, uint64_t* num_bytes) = 0;
+  //!< Advances whenever the latest sample of the field may have changed
+  virtual uint64_t get_generation(const RdcFieldKey& field) const = 0;
 
   virtual rdc_status_t rdc_job_get_stats(const char job_id[64], const rdc_gpu_gauges_t& gpu_gauges,
                                          rdc_job_info_t* p_job_info) = 0;
@@ -54,10 +69,19 @@ class RdcCacheManager {
                                            const rdc_gpu_gauges_t& gpu_gauges) = 0;
   virtual rdc_status_t rdc_job_stop_stats(const char job_id[64],
                                           const rdc_gpu_gauges_t& gpu_gauge) = 0;
+  virtual rdc_status_t rdc_job_get_timeline(const char job_id[64], uint32_t gpu_index,
+                                            rdc_field_t field, const rdc_gpu_gauges_t& gpu_gauges,
+                                            rdc_job_timeline_t* timeline) = 0;
   virtual rdc_status_t rdc_update_job_stats(uint32_t gpu_index, const std::string& job_id,
                                             const rdc_field_value& value) = 0;
   virtual rdc_status_t rdc_job_remove(const char job_id[64]) = 0;
+  //!< The GPUs of a job and whether it is still running, to fetch only the
+  //!< gauges that rdc_job_get_stats needs
+  virtual rdc_status_t rdc_job_get_gpus(const char job_id[64], std::vector<uint32_t>* gpu_indexes,
+                                        bool* is_running) = 0;
   virtual rdc_status_t rdc_job_remove_all() = 0;
+  //!< The stopped jobs of the job store, RDC_ST_NOT_SUPPORTED without one
+  virtual rdc_status_t rdc_job_list(const rdc_job_filter_t& filter, rdc_job_list_t* jobs) = 0;
 
   virtual ~RdcCacheManager() {}
 };
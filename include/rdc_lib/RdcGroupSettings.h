@@ -48,6 +48,8 @@ class RdcGroupSettings {
                                                 rdc_field_group_info_t* field_group_info) = 0;
   virtual rdc_status_t rdc_group_field_get_all_ids(rdc_field_grp_t field_group_id_list[],
                                                    uint32_t* count) = 0;
+  //!< Advances whenever a GPU group or a field group changes
+  virtual uint64_t get_generation() const = 0;
 
   virtual ~RdcGroupSettings() {}
 };
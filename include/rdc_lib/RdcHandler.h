@@ -37,6 +37,9 @@ class RdcHandler {
                                            uint64_t update_freq) = 0;
   virtual rdc_status_t rdc_job_get_stats(const char jobId[64], rdc_job_info_t* p_job_info) = 0;
   virtual rdc_status_t rdc_job_stop_stats(const char job_id[64]) = 0;
+  virtual rdc_status_t rdc_job_get_timeline(const char job_id[64], uint32_t gpu_index,
+                                            rdc_field_t field, rdc_job_timeline_t* timeline) = 0;
+  virtual rdc_status_t rdc_job_list(const rdc_job_filter_t* filter, rdc_job_list_t* jobs) = 0;
   virtual rdc_status_t rdc_job_remove(const char job_id[64]) = 0;
   virtual rdc_status_t rdc_job_remove_all() = 0;
 
@@ -74,6 +77,33 @@ class RdcHandler {
                                                  uint64_t since_time_stamp,
                                                  uint64_t* next_since_time_stamp,
                                                  rdc_field_value* value) = 0;
+  virtual rdc_status_t rdc_field_get_rollup(uint32_t gpu_index, rdc_field_t field,
+                                            uint64_t start_ts, uint64_t end_ts,
+                                            rdc_field_rollups_t* rollups) = 0;
+  virtual rdc_status_t rdc_field_get_history(uint32_t gpu_index, rdc_field_t field,
+                                             uint64_t since_ts, uint64_t until_ts,
+                                             rdc_field_history_t* history) = 0;
+  virtual rdc_status_t rdc_policy_add_rule(const rdc_policy_rule_t* rule, uint32_t* rule_id) = 0;
+  virtual rdc_status_t rdc_policy_delete_rule(uint32_t rule_id) = 0;
+  virtual rdc_status_t rdc_policy_get_violations(uint64_t since_seq, uint32_t timeout_ms,
+                                                 rdc_policy_violations_t* violations) = 0;
+  virtual rdc_status_t rdc_anomaly_set_detector(uint32_t detector_id,
+                                                const rdc_anomaly_config_t* config) = 0;
+  virtual rdc_status_t rdc_anomaly_clear_detector(uint32_t detector_id) = 0;
+  virtual rdc_status_t rdc_field_derived_set(rdc_field_t field_id, const char* expression) = 0;
+  virtual rdc_status_t rdc_field_derived_clear(rdc_field_t field_id) = 0;
+  virtual rdc_status_t rdc_field_ingest(uint32_t gpu_index, const rdc_field_value* values,
+                                        uint32_t num_values, double max_keep_age,
+                                        uint32_t max_keep_samples) = 0;
+  virtual rdc_status_t rdc_aggregate_get_hosts(rdc_aggregate_hosts_t* hosts) = 0;
+  virtual rdc_status_t rdc_aggregate_get_field(rdc_field_t field, rdc_aggregate_op_t op,
+                                               rdc_cluster_aggregate_t* aggregate) = 0;
+  virtual rdc_status_t rdc_field_get_group_aggregate(rdc_gpu_group_t group_id,
+                                                     rdc_field_grp_t field_group_id,
+                                                     uint64_t window_ms,
+                                                     const rdc_aggregate_spec_t* specs,
+                                                     uint32_t num_specs,
+                                                     rdc_group_aggregate_t* aggregate) = 0;
   virtual rdc_status_t rdc_field_unwatch(rdc_gpu_group_t group_id,
                                          rdc_field_grp_t field_group_id) = 0;
 
@@ -88,10 +118,19 @@ class RdcHandler {
 
   // Control API
   virtual rdc_status_t rdc_field_update_all(uint32_t wait_for_update) = 0;
+  virtual rdc_status_t rdc_perf_stats_get(rdc_perf_stats_t* stats) = 0;
+  virtual rdc_status_t rdc_pipeline_trace_set(uint32_t enabled) = 0;
+  virtual rdc_status_t rdc_pipeline_trace_get(uint64_t start_seq,
+                                              rdc_pipeline_events_t* events) = 0;
+  virtual rdc_status_t rdc_log_level_set(rdc_log_level_t level) = 0;
 
   // It is just a client interface under the GRPC framework and is not used as an RDC API.
   // The reason is that RdcEmbeddedHandler::get_mixed_component_version does not need to be called.
   virtual rdc_status_t get_mixed_component_version(mixed_component_t component, mixed_component_version_t* p_mixed_compv) = 0;
+  // Only used by rdcd on its embedded handler, to reuse the replies of the hot read RPCs.
+  virtual rdc_status_t get_cache_generation(uint32_t gpu_index, rdc_field_t field_id,
+                                            uint64_t* cache_generation,
+                                            uint64_t* group_generation) = 0;
 
   virtual ~RdcHandler() {}
 };
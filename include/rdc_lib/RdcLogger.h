@@ -21,43 +21,141 @@ THE SOFTWARE.
 */
 #ifndef INCLUDE_RDC_LIB_RDCLOGGER_H_
 #define INCLUDE_RDC_LIB_RDCLOGGER_H_
+#include <atomic>
 #include <chrono>  // NOLINT
+#include <condition_variable>  // NOLINT
+#include <cstdint>
+#include <fstream>
 #include <iostream>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <sstream>
 #include <string>
+#include <vector>
 
 #define RDC_ERROR 0
 #define RDC_INFO 1
 #define RDC_DEBUG 2
 
-#define RDC_LOG(debug_level, msg)                                                             \
-  do {                                                                                        \
-    auto& logger = amd::rdc::RdcLogger::getLogger();                                          \
-    if (logger.should_log((debug_level))) {                                                   \
-      logger.get_ostream() << logger.get_log_header((debug_level), __FILE__, __LINE__) << msg \
-                           << std::endl;                                                      \
-    }                                                                                         \
+//!< The message is only formatted when its level is enabled, and only
+//!< handed to the logger thread when its call site is not rate limited.
+#define RDC_LOG(debug_level, msg)                                                      \
+  do {                                                                                 \
+    auto& logger = amd::rdc::RdcLogger::getLogger();                                   \
+    if (logger.should_log((debug_level))) {                                            \
+      static amd::rdc::RdcLogSite rdc_log_site;                                        \
+      amd::rdc::RdcLogMessage rdc_log_message(logger, (debug_level), __FILE__, __LINE__, \
+                                              &rdc_log_site);                          \
+      rdc_log_message.stream() << msg;                                                 \
+    }                                                                                  \
   } while (0)
 
 namespace amd {
 namespace rdc {
+
+//!< Rate limiting state of one RDC_LOG call site. Updated without a lock,
+//!< so concurrent callers may let a message or two more through.
+struct RdcLogSite {
+  std::atomic<uint64_t> last_hash{0};
+  std::atomic<uint64_t> window_start_ms{0};
+  std::atomic<uint32_t> repeats{0};     //!< Identical messages in the window
+  std::atomic<uint32_t> suppressed{0};  //!< Identical messages dropped
+};
+
+//!< Asynchronous logger. Callers format a message on their own thread and
+//!< push it into a ring owned by that thread; a background thread drains
+//!< the rings, adds the headers and writes them out in batches. A full ring
+//!< drops INFO and DEBUG messages rather than blocking the caller.
+//!<
+//!< RDC_LOG selects the level (ERROR, INFO or DEBUG), RDC_LOG_OUTPUT the
+//!< destination ("stdout" by default, "syslog" or a file path) and
+//!< RDC_LOG_RATE_LIMIT the identical messages let through per call site and
+//!< second (10 by default, 0 for no limit).
 class RdcLogger {
  public:
-  explicit RdcLogger(std::ostream& os);
+  static RdcLogger& getLogger();
 
-  static RdcLogger& getLogger() {
-    static RdcLogger logger(std::cout);
-    return logger;
+  bool should_log(uint32_t severity) const {
+    return log_level_.load(std::memory_order_relaxed) >= severity;
   }
 
-  bool should_log(uint32_t severity) { return log_level_ >= severity; }
+  void set_log_level(uint32_t severity) { log_level_.store(severity, std::memory_order_relaxed); }
+
+  //!< Queue a formatted message unless its call site is rate limited
+  void log(uint32_t severity, const char* file, int line, RdcLogSite* site,
+           const std::string& text);
+
+  //!< Write out everything queued so far, from the calling thread
+  void flush();
+
+ private:
+  struct Record {
+    uint64_t ts_ms;
+    uint32_t severity;
+    const char* file;
+    int line;
+    std::string text;
+  };
+
+  //!< Single producer, single consumer ring of one thread
+  struct Ring {
+    static const uint32_t kSlots = 1024;
+    Record slots[kSlots];
+    std::atomic<uint64_t> head{0};  //!< Next slot the owner writes
+    std::atomic<uint64_t> tail{0};  //!< Next slot the logger thread reads
+    std::atomic<bool> orphaned{false};  //!< The owner thread exited
+  };
+  friend struct RdcLogRingHolder;
 
-  std::ostream& get_ostream() { return os_; }
+  RdcLogger();
+  Ring* local_ring();
+  bool rate_limited(RdcLogSite* site, const std::string& text, uint64_t now_ms,
+                    uint32_t* suppressed);
+  void start_worker();
+  void worker_loop();
+  void drain_locked();
+  void append_header(const Record& record, std::string* out) const;
+  void write_batch(const std::string& batch);
+
+  static void prepare_fork();
+  static void parent_after_fork();
+  static void child_after_fork();
+
+  std::atomic<uint32_t> log_level_;
+  uint32_t rate_limit_;
+
+  std::mutex rings_mutex_;
+  std::vector<std::shared_ptr<Ring>> rings_;
+  std::atomic<uint64_t> dropped_{0};
+
+  std::mutex drain_mutex_;  //!< Serializes draining and the output
+  std::atomic<bool> worker_running_{false};
+  std::mutex worker_mutex_;
+  std::condition_variable worker_cv_;
+
+  enum { OUTPUT_STDOUT, OUTPUT_FILE, OUTPUT_SYSLOG } output_;
+  std::ofstream file_;
+};
+
+//!< One RDC_LOG message. It is formatted into a stream reused by the thread
+//!< and queued when the object goes out of scope.
+class RdcLogMessage {
+ public:
+  RdcLogMessage(RdcLogger& logger, uint32_t severity, const char* file, int line,
+                RdcLogSite* site);
+  ~RdcLogMessage();
 
-  std::string get_log_header(uint32_t severity, const char* file, int line);
+  std::ostream& stream() { return *stream_; }
 
  private:
-  std::ostream& os_;
-  uint32_t log_level_;
+  RdcLogger& logger_;
+  uint32_t severity_;
+  const char* file_;
+  int line_;
+  RdcLogSite* site_;
+  std::ostringstream* stream_;
+  //!< Only used when a message is formatted while formatting another one
+  std::unique_ptr<std::ostringstream> nested_stream_;
 };
 
 }  // namespace rdc
@@ -0,0 +1,118 @@
+/*
+Copyright (c) 2024 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#ifndef INCLUDE_RDC_LIB_RDCPIPELINETRACE_H_
+#define INCLUDE_RDC_LIB_RDCPIPELINETRACE_H_
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstdint>
+#include <mutex>  // NOLINT
+#include <ostream>
+#include <vector>
+
+#include "rdc/rdc.h"
+
+namespace amd {
+namespace rdc {
+
+//!< Bounded ring of timed spans of the collection pipeline. It lives in the
+//!< bootstrap library, so rdcd and the librdc it loads share one ring and
+//!< the gRPC handlers line up with the fetches they wait on. Nothing is
+//!< allocated or timed until tracing is first enabled.
+class RdcPipelineTrace {
+ public:
+  static RdcPipelineTrace& get_instance();
+
+  //!< A single relaxed load, checked before any other tracing work
+  static bool enabled() { return enabled_.load(std::memory_order_relaxed); }
+
+  static uint64_t now_us() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  }
+
+  //!< Enabling clears the ring. The capacity comes from
+  //!< RDC_PIPELINE_TRACE_EVENTS, 65536 events by default.
+  void set_enabled(bool enabled);
+
+  void record(const char* name, uint64_t start_us, uint64_t end_us, uint32_t gpu_index,
+              uint32_t field_id);
+
+  //!< Copy up to RDC_MAX_NUM_PIPELINE_EVENTS events from start_seq on
+  void get_events(uint64_t start_seq, rdc_pipeline_events_t* events);
+
+  //!< Write events as Chrome trace-event JSON, which Perfetto and
+  //!< chrome://tracing load directly
+  static void write_chrome_json(const std::vector<rdc_pipeline_event_t>& events,
+                                std::ostream& os);
+
+  //!< Write the whole ring as Chrome trace-event JSON to a file
+  rdc_status_t dump_chrome_json(const char* path);
+
+ private:
+  RdcPipelineTrace() {}
+
+  static std::atomic<bool> enabled_;
+
+  std::mutex mutex_;
+  std::vector<rdc_pipeline_event_t> ring_;
+  uint64_t first_seq_ = 1;  //!< Oldest sequence number still in the ring
+  uint64_t next_seq_ = 1;
+};
+
+//!< Records the lifetime of the object as one span. When tracing is
+//!< disabled it neither reads the clock nor takes the ring lock.
+class RdcPipelineScope {
+ public:
+  explicit RdcPipelineScope(const char* name, uint32_t gpu_index = GPU_ID_INVALID,
+                            uint32_t field_id = RDC_FI_INVALID)
+      : name_(name),
+        gpu_index_(gpu_index),
+        field_id_(field_id),
+        start_us_(RdcPipelineTrace::enabled() ? RdcPipelineTrace::now_us() : 0) {}
+  ~RdcPipelineScope() {
+    if (start_us_ != 0) {
+      RdcPipelineTrace::get_instance().record(name_, start_us_, RdcPipelineTrace::now_us(),
+                                              gpu_index_, field_id_);
+    }
+  }
+
+ private:
+  const char* name_;
+  uint32_t gpu_index_;
+  uint32_t field_id_;
+  uint64_t start_us_;
+};
+
+#define RDC_PIPELINE_CONCAT_(a, b) a##b
+#define RDC_PIPELINE_CONCAT(a, b) RDC_PIPELINE_CONCAT_(a, b)
+
+//!< Trace the rest of the enclosing scope as a span called name, optionally
+//!< tagged with the GPU index and field id it works on
+#define RDC_PIPELINE_SCOPE(...) \
+  amd::rdc::RdcPipelineScope RDC_PIPELINE_CONCAT(rdc_pipeline_scope_, __LINE__)(__VA_ARGS__)
+
+}  // namespace rdc
+}  // namespace amd
+
+#endif  // INCLUDE_RDC_LIB_RDCPIPELINETRACE_H_
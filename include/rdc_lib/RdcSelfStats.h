@@ -0,0 +1,99 @@
+/*
+Copyright (c) 2024 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#ifndef INCLUDE_RDC_LIB_RDCSELFSTATS_H_
+#define INCLUDE_RDC_LIB_RDCSELFSTATS_H_
+
+#include <atomic>
+#include <cstdint>
+
+#include "rdc/rdc.h"
+
+namespace amd {
+namespace rdc {
+
+//!< The telemetry modules whose fetch latency is tracked separately
+enum RdcSelfModule {
+  RDC_SELF_MODULE_SMI = 0,
+  RDC_SELF_MODULE_PROF,
+  RDC_SELF_MODULE_OTHER,
+  RDC_SELF_MODULE_COUNT
+};
+
+//!< Process wide counters describing RDC itself. The watch table, the
+//!< telemetry dispatcher and the handler record into it, and RdcSelfLib
+//!< reports it as the RDC_FI_RDC_* fields. All members are atomics so the
+//!< recording side never takes a lock.
+class RdcSelfStats {
+ public:
+  static RdcSelfStats& get_instance() {
+    static RdcSelfStats stats;
+    return stats;
+  }
+
+  //!< Called at the end of each update tick
+  void record_tick(uint64_t duration_us, uint64_t fetch_us, uint64_t queue_depth, bool overrun);
+  void record_module_fetch(RdcSelfModule module, uint64_t latency_us);
+  void record_samples(uint64_t count) { samples_.fetch_add(count, std::memory_order_relaxed); }
+  void record_api_call() { api_calls_.fetch_add(1, std::memory_order_relaxed); }
+  void record_event_queue_depth(uint64_t depth) {
+    event_queue_depth_.store(depth, std::memory_order_relaxed);
+  }
+  void record_cache_usage(uint64_t num_samples, uint64_t num_bytes);
+  void record_export(uint64_t sent, uint64_t dropped) {
+    export_samples_.fetch_add(sent, std::memory_order_relaxed);
+    export_dropped_.fetch_add(dropped, std::memory_order_relaxed);
+  }
+
+  //!< Turn the counters into per second rates. Called about once per second.
+  void update_rates(uint64_t now_ms);
+
+  //!< Returns RDC_ST_NOT_SUPPORTED for fields which are not RDC_FI_RDC_*
+  rdc_status_t get_value(rdc_field_t field_id, int64_t* value) const;
+
+ private:
+  RdcSelfStats();
+
+  std::atomic<uint64_t> tick_duration_us_;
+  std::atomic<uint64_t> tick_overruns_;
+  std::atomic<uint64_t> fetch_latency_us_;
+  std::atomic<uint64_t> module_latency_us_[RDC_SELF_MODULE_COUNT];
+  std::atomic<uint64_t> fetch_queue_depth_;
+  std::atomic<uint64_t> event_queue_depth_;
+  std::atomic<uint64_t> cache_samples_;
+  std::atomic<uint64_t> cache_bytes_;
+  std::atomic<uint64_t> export_samples_;
+  std::atomic<uint64_t> export_dropped_;
+
+  //!< Running totals and the rates derived from them
+  std::atomic<uint64_t> samples_;
+  std::atomic<uint64_t> api_calls_;
+  std::atomic<uint64_t> samples_per_sec_;
+  std::atomic<uint64_t> api_calls_per_sec_;
+  uint64_t last_rate_time_;
+  uint64_t last_samples_;
+  uint64_t last_api_calls_;
+};
+
+}  // namespace rdc
+}  // namespace amd
+
+#endif  // INCLUDE_RDC_LIB_RDCSELFSTATS_H_
@@ -49,6 +49,13 @@ class RdcWatchTable {
                                        uint32_t max_keep_samples) = 0;
   virtual rdc_status_t rdc_field_unwatch(rdc_gpu_group_t group_id,
                                          rdc_field_grp_t field_group_id) = 0;
+  virtual rdc_status_t rdc_field_ingest(uint32_t gpu_index, const rdc_field_value* values,
+                                        uint32_t num_values, double max_keep_age,
+                                        uint32_t max_keep_samples) = 0;
+  //!< The update interval in microseconds of a watched field, RDC_ST_NOT_FOUND
+  //!< when it is not watched
+  virtual rdc_status_t rdc_field_get_update_freq(uint32_t gpu_index, rdc_field_t field_id,
+                                                 uint64_t* update_freq) = 0;
 
   virtual ~RdcWatchTable() {}
 };
@@ -0,0 +1,130 @@
+/*
+Copyright (c) 2024 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#ifndef INCLUDE_RDC_LIB_SMIBACKEND_H_
+#define INCLUDE_RDC_LIB_SMIBACKEND_H_
+
+#include <memory>
+
+#include "amd_smi/amdsmi.h"
+
+namespace amd {
+namespace rdc {
+
+//!< Thin wrapper over the amd_smi_lib calls used by RDC. Each method mirrors
+//!< the amdsmi_* function of the same name, so the real backend is a plain
+//!< forwarder and a fake backend can stand in when no GPU is present.
+class SmiBackend {
+ public:
+  virtual amdsmi_status_t init(uint64_t init_flags) = 0;
+  virtual amdsmi_status_t shut_down() = 0;
+  virtual amdsmi_status_t get_lib_version(amdsmi_version_t* version) = 0;
+
+  // Discovery
+  virtual amdsmi_status_t get_socket_handles(uint32_t* socket_count,
+                                             amdsmi_socket_handle* socket_handles) = 0;
+  virtual amdsmi_status_t get_processor_handles(amdsmi_socket_handle socket_handle,
+                                                uint32_t* processor_count,
+                                                amdsmi_processor_handle* processor_handles) = 0;
+  virtual amdsmi_status_t get_processor_type(amdsmi_processor_handle processor_handle,
+                                             processor_type_t* processor_type) = 0;
+  virtual amdsmi_status_t get_gpu_bdf_id(amdsmi_processor_handle processor_handle,
+                                         uint64_t* bdfid) = 0;
+  virtual amdsmi_status_t get_gpu_asic_info(amdsmi_processor_handle processor_handle,
+                                            amdsmi_asic_info_t* info) = 0;
+
+  // Metrics
+  virtual amdsmi_status_t get_gpu_metrics_info(amdsmi_processor_handle processor_handle,
+                                               amdsmi_gpu_metrics_t* metrics) = 0;
+  virtual amdsmi_status_t get_gpu_memory_usage(amdsmi_processor_handle processor_handle,
+                                               amdsmi_memory_type_t mem_type, uint64_t* used) = 0;
+  virtual amdsmi_status_t get_gpu_memory_total(amdsmi_processor_handle processor_handle,
+                                               amdsmi_memory_type_t mem_type, uint64_t* total) = 0;
+  virtual amdsmi_status_t get_gpu_activity(amdsmi_processor_handle processor_handle,
+                                           amdsmi_engine_usage_t* info) = 0;
+  virtual amdsmi_status_t get_power_info(amdsmi_processor_handle processor_handle,
+                                         amdsmi_power_info_t* info) = 0;
+  virtual amdsmi_status_t get_clk_freq(amdsmi_processor_handle processor_handle,
+                                       amdsmi_clk_type_t clk_type, amdsmi_frequencies_t* f) = 0;
+  virtual amdsmi_status_t get_temp_metric(amdsmi_processor_handle processor_handle,
+                                          amdsmi_temperature_type_t sensor_type,
+                                          amdsmi_temperature_metric_t metric,
+                                          int64_t* temperature) = 0;
+  virtual amdsmi_status_t get_gpu_volt_metric(amdsmi_processor_handle processor_handle,
+                                              amdsmi_voltage_type_t sensor_type,
+                                              amdsmi_voltage_metric_t metric,
+                                              int64_t* voltage) = 0;
+  virtual amdsmi_status_t get_utilization_count(amdsmi_processor_handle processor_handle,
+                                                amdsmi_utilization_counter_t utilization_counters[],
+                                                uint32_t count, uint64_t* timestamp) = 0;
+  virtual amdsmi_status_t get_gpu_pci_throughput(amdsmi_processor_handle processor_handle,
+                                                 uint64_t* sent, uint64_t* received,
+                                                 uint64_t* max_pkt_sz) = 0;
+  virtual amdsmi_status_t get_gpu_ecc_status(amdsmi_processor_handle processor_handle,
+                                             amdsmi_gpu_block_t block,
+                                             amdsmi_ras_err_state_t* state) = 0;
+  virtual amdsmi_status_t get_gpu_ecc_count(amdsmi_processor_handle processor_handle,
+                                            amdsmi_gpu_block_t block,
+                                            amdsmi_error_count_t* ec) = 0;
+  virtual amdsmi_status_t topo_get_link_weight(amdsmi_processor_handle processor_handle_src,
+                                               amdsmi_processor_handle processor_handle_dst,
+                                               uint64_t* weight) = 0;
+
+  // Processes
+  virtual amdsmi_status_t get_gpu_compute_process_info(amdsmi_process_info_t* procs,
+                                                       uint32_t* num_items) = 0;
+  virtual amdsmi_status_t get_gpu_compute_process_gpus(uint32_t pid, uint32_t* dv_indices,
+                                                       uint32_t* num_devices) = 0;
+
+  // Hardware event counters
+  virtual amdsmi_status_t gpu_counter_group_supported(amdsmi_processor_handle processor_handle,
+                                                      amdsmi_event_group_t group) = 0;
+  virtual amdsmi_status_t get_gpu_available_counters(amdsmi_processor_handle processor_handle,
+                                                     amdsmi_event_group_t grp,
+                                                     uint32_t* available) = 0;
+  virtual amdsmi_status_t gpu_create_counter(amdsmi_processor_handle processor_handle,
+                                             amdsmi_event_type_t type,
+                                             amdsmi_event_handle_t* evnt_handle) = 0;
+  virtual amdsmi_status_t gpu_control_counter(amdsmi_event_handle_t evt_handle,
+                                              amdsmi_counter_command_t cmd, void* cmd_args) = 0;
+  virtual amdsmi_status_t gpu_read_counter(amdsmi_event_handle_t evt_handle,
+                                           amdsmi_counter_value_t* value) = 0;
+  virtual amdsmi_status_t gpu_destroy_counter(amdsmi_event_handle_t evnt_handle) = 0;
+
+  // Event notification
+  virtual amdsmi_status_t init_gpu_event_notification(
+      amdsmi_processor_handle processor_handle) = 0;
+  virtual amdsmi_status_t set_gpu_event_notification_mask(
+      amdsmi_processor_handle processor_handle, uint64_t mask) = 0;
+  virtual amdsmi_status_t get_gpu_event_notification(int timeout_ms, uint32_t* num_elem,
+                                                     amdsmi_evt_notification_data_t* data) = 0;
+  virtual amdsmi_status_t stop_gpu_event_notification(
+      amdsmi_processor_handle processor_handle) = 0;
+
+  virtual ~SmiBackend() {}
+};
+
+typedef std::shared_ptr<SmiBackend> SmiBackendPtr;
+
+}  // namespace rdc
+}  // namespace amd
+
+#endif  // INCLUDE_RDC_LIB_SMIBACKEND_H_
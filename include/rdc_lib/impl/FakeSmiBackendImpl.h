@@ -0,0 +1,175 @@
+/*
+Copyright (c) 2024 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#ifndef INCLUDE_RDC_LIB_IMPL_FAKESMIBACKENDIMPL_H_
+#define INCLUDE_RDC_LIB_IMPL_FAKESMIBACKENDIMPL_H_
+
+#include <atomic>
+#include <condition_variable>  // NOLINT(build/c++11)
+#include <map>
+#include <mutex>  // NOLINT(build/c++11)
+#include <set>
+#include <string>
+
+#include "amd_smi/amdsmi.h"
+#include "rdc/rdc.h"
+#include "rdc_lib/SmiBackend.h"
+
+namespace amd {
+namespace rdc {
+
+//!< Knobs of the simulated device model. from_env() reads:
+//!<   RDC_FAKE_SMI_GPUS               number of GPUs, 1..RDC_MAX_NUM_DEVICES (8)
+//!<   RDC_FAKE_SMI_LATENCY_US         latency added to every call (0)
+//!<   RDC_FAKE_SMI_UNSUPPORTED        comma separated calls that return
+//!<                                   NOT_SUPPORTED, e.g. "get_power_info"
+//!<   RDC_FAKE_SMI_EVENT_INTERVAL_MS  period of the generated notification
+//!<                                   events, 0 disables them (0)
+struct FakeSmiConfig {
+  uint32_t num_gpus = 8;
+  uint32_t call_latency_us = 0;
+  std::set<std::string> unsupported_calls;
+  uint32_t event_interval_ms = 0;
+
+  static FakeSmiConfig from_env();
+};
+
+//!< A GPU-less stand-in for amd_smi_lib. Every GPU reports a deterministic
+//!< waveform derived from its index and the elapsed time, so the whole
+//!< watch/cache/job pipeline can run without hardware.
+class FakeSmiBackendImpl final : public SmiBackend {
+ public:
+  explicit FakeSmiBackendImpl(const FakeSmiConfig& config);
+  ~FakeSmiBackendImpl();
+
+  amdsmi_status_t init(uint64_t init_flags) override;
+  amdsmi_status_t shut_down() override;
+  amdsmi_status_t get_lib_version(amdsmi_version_t* version) override;
+
+  amdsmi_status_t get_socket_handles(uint32_t* socket_count,
+                                     amdsmi_socket_handle* socket_handles) override;
+  amdsmi_status_t get_processor_handles(amdsmi_socket_handle socket_handle,
+                                        uint32_t* processor_count,
+                                        amdsmi_processor_handle* processor_handles) override;
+  amdsmi_status_t get_processor_type(amdsmi_processor_handle processor_handle,
+                                     processor_type_t* processor_type) override;
+  amdsmi_status_t get_gpu_bdf_id(amdsmi_processor_handle processor_handle,
+                                 uint64_t* bdfid) override;
+  amdsmi_status_t get_gpu_asic_info(amdsmi_processor_handle processor_handle,
+                                    amdsmi_asic_info_t* info) override;
+
+  amdsmi_status_t get_gpu_metrics_info(amdsmi_processor_handle processor_handle,
+                                       amdsmi_gpu_metrics_t* metrics) override;
+  amdsmi_status_t get_gpu_memory_usage(amdsmi_processor_handle processor_handle,
+                                       amdsmi_memory_type_t mem_type, uint64_t* used) override;
+  amdsmi_status_t get_gpu_memory_total(amdsmi_processor_handle processor_handle,
+                                       amdsmi_memory_type_t mem_type, uint64_t* total) override;
+  amdsmi_status_t get_gpu_activity(amdsmi_processor_handle processor_handle,
+                                   amdsmi_engine_usage_t* info) override;
+  amdsmi_status_t get_power_info(amdsmi_processor_handle processor_handle,
+                                 amdsmi_power_info_t* info) override;
+  amdsmi_status_t get_clk_freq(amdsmi_processor_handle processor_handle,
+                               amdsmi_clk_type_t clk_type, amdsmi_frequencies_t* f) override;
+  amdsmi_status_t get_temp_metric(amdsmi_processor_handle processor_handle,
+                                  amdsmi_temperature_type_t sensor_type,
+                                  amdsmi_temperature_metric_t metric,
+                                  int64_t* temperature) override;
+  amdsmi_status_t get_gpu_volt_metric(amdsmi_processor_handle processor_handle,
+                                      amdsmi_voltage_type_t sensor_type,
+                                      amdsmi_voltage_metric_t metric, int64_t* voltage) override;
+  amdsmi_status_t get_utilization_count(amdsmi_processor_handle processor_handle,
+                                        amdsmi_utilization_counter_t utilization_counters[],
+                                        uint32_t count, uint64_t* timestamp) override;
+  amdsmi_status_t get_gpu_pci_throughput(amdsmi_processor_handle processor_handle, uint64_t* sent,
+                                         uint64_t* received, uint64_t* max_pkt_sz) override;
+  amdsmi_status_t get_gpu_ecc_status(amdsmi_processor_handle processor_handle,
+                                     amdsmi_gpu_block_t block,
+                                     amdsmi_ras_err_state_t* state) override;
+  amdsmi_status_t get_gpu_ecc_count(amdsmi_processor_handle processor_handle,
+                                    amdsmi_gpu_block_t block, amdsmi_error_count_t* ec) override;
+  amdsmi_status_t topo_get_link_weight(amdsmi_processor_handle processor_handle_src,
+                                       amdsmi_processor_handle processor_handle_dst,
+                                       uint64_t* weight) override;
+
+  amdsmi_status_t get_gpu_compute_process_info(amdsmi_process_info_t* procs,
+                                               uint32_t* num_items) override;
+  amdsmi_status_t get_gpu_compute_process_gpus(uint32_t pid, uint32_t* dv_indices,
+                                               uint32_t* num_devices) override;
+
+  amdsmi_status_t gpu_counter_group_supported(amdsmi_processor_handle processor_handle,
+                                              amdsmi_event_group_t group) override;
+  amdsmi_status_t get_gpu_available_counters(amdsmi_processor_handle processor_handle,
+                                             amdsmi_event_group_t grp,
+                                             uint32_t* available) override;
+  amdsmi_status_t gpu_create_counter(amdsmi_processor_handle processor_handle,
+                                     amdsmi_event_type_t type,
+                                     amdsmi_event_handle_t* evnt_handle) override;
+  amdsmi_status_t gpu_control_counter(amdsmi_event_handle_t evt_handle,
+                                      amdsmi_counter_command_t cmd, void* cmd_args) override;
+  amdsmi_status_t gpu_read_counter(amdsmi_event_handle_t evt_handle,
+                                   amdsmi_counter_value_t* value) override;
+  amdsmi_status_t gpu_destroy_counter(amdsmi_event_handle_t evnt_handle) override;
+
+  amdsmi_status_t init_gpu_event_notification(amdsmi_processor_handle processor_handle) override;
+  amdsmi_status_t set_gpu_event_notification_mask(amdsmi_processor_handle processor_handle,
+                                                  uint64_t mask) override;
+  amdsmi_status_t get_gpu_event_notification(int timeout_ms, uint32_t* num_elem,
+                                             amdsmi_evt_notification_data_t* data) override;
+  amdsmi_status_t stop_gpu_event_notification(amdsmi_processor_handle processor_handle) override;
+
+ private:
+  struct FakeCounter {
+    uint32_t gpu_index;
+    amdsmi_event_type_t type;
+    bool running;
+    uint64_t start_ns;
+    uint64_t value;
+  };
+
+  //!< Apply the configured latency and return NOT_SUPPORTED for disabled
+  //!< calls. Every entry point goes through this.
+  amdsmi_status_t enter(const char* call) const;
+  //!< Map a processor handle back to the GPU index, false if invalid
+  bool gpu_of(amdsmi_processor_handle handle, uint32_t* gpu_index) const;
+  amdsmi_processor_handle handle_of(uint32_t gpu_index) const;
+  uint64_t elapsed_ns() const;
+  //!< Simulated gfx activity in percent for the GPU at this moment
+  uint32_t activity(uint32_t gpu_index) const;
+
+  FakeSmiConfig config_;
+  uint64_t start_ns_;
+  std::atomic<bool> initialized_;
+
+  std::mutex counter_mutex_;
+  std::map<amdsmi_event_handle_t, FakeCounter> counters_;
+  amdsmi_event_handle_t next_counter_;
+
+  std::mutex notif_mutex_;
+  std::condition_variable notif_cv_;
+  uint64_t notif_masks_[RDC_MAX_NUM_DEVICES];
+  uint64_t last_event_ns_;
+  uint32_t next_event_gpu_;
+};
+
+}  // namespace rdc
+}  // namespace amd
+
+#endif  // INCLUDE_RDC_LIB_IMPL_FAKESMIBACKENDIMPL_H_
@@ -0,0 +1,111 @@
+/*
+Copyright (c) 2024 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#ifndef INCLUDE_RDC_LIB_IMPL_RDCANOMALYDETECTOR_H_
+#define INCLUDE_RDC_LIB_IMPL_RDCANOMALYDETECTOR_H_
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>  // NOLINT(build/c++11)
+#include <unordered_map>
+#include <vector>
+
+#include "rdc/rdc.h"
+#include "rdc_lib/RdcNotification.h"
+#include "rdc_lib/RdcTelemetry.h"
+
+namespace amd {
+namespace rdc {
+
+//!< Scores every cached sample of the fields with a detector against an
+//!< EWMA of their mean and variance. The state per (detector, GPU) has a
+//!< fixed size, so a sample costs a few multiplications whatever the
+//!< history. The scores are served as the RDC_FI_ANOMALY_SCORE_* fields by
+//!< this telemetry module, and the anomalies are returned to the ingest
+//!< path as RDC_EVNT_NOTIF_ANOMALY events.
+class RdcAnomalyDetector : public RdcTelemetry {
+ public:
+  RdcAnomalyDetector();
+
+  rdc_status_t set_detector(uint32_t detector_id, const rdc_anomaly_config_t& config);
+  rdc_status_t clear_detector(uint32_t detector_id);
+
+  //!< Called by the ingest path for every sample it caches. Appends an
+  //!< event to events when the sample is anomalous.
+  void evaluate(uint32_t gpu_index, const rdc_field_value& value,
+                std::vector<rdc_evnt_notification_t>* events);
+
+  rdc_status_t rdc_telemetry_fields_query(uint32_t field_ids[MAX_NUM_FIELDS],
+                                          uint32_t* field_count) override;
+
+  rdc_status_t rdc_telemetry_fields_value_get(rdc_gpu_field_t* fields, uint32_t fields_count,
+                                              rdc_field_value_f callback, void* user_data) override;
+
+  rdc_status_t rdc_telemetry_fields_watch(rdc_gpu_field_t* fields, uint32_t fields_count) override;
+  rdc_status_t rdc_telemetry_fields_unwatch(rdc_gpu_field_t* fields,
+                                            uint32_t fields_count) override;
+
+ private:
+  //!< Number of slices of the seasonal period
+  static const uint32_t kSeasonSlices = 24;
+
+  struct Baseline {
+    uint64_t count;
+    double mean;
+    double variance;
+  };
+
+  struct State {
+    //!< The variance of the global baseline is the spread around level, a
+    //!< faster EWMA, so a slow drift of the mean is not learnt as noise
+    Baseline global;
+    double level;
+    std::array<Baseline, kSeasonSlices> season;
+    bool has_score;
+    uint64_t score_ts;
+    double score;
+    bool raised;  //!< An event was raised and the score has not dropped since
+  };
+
+  struct Detector {
+    bool enabled;
+    rdc_anomaly_config_t config;
+    std::unordered_map<uint32_t, State> states;  //!< By GPU index
+  };
+
+  static void learn(Baseline* baseline, double alpha, double v);
+  static void learn_global(State* state, double alpha, double v);
+  static double score(const Baseline& baseline, double v);
+
+  //!< Lets evaluate() skip the lock when there is no detector
+  std::atomic<uint32_t> num_detectors_;
+
+  std::mutex mutex_;
+  std::array<Detector, RDC_MAX_ANOMALY_DETECTORS> detectors_;
+};
+
+typedef std::shared_ptr<RdcAnomalyDetector> RdcAnomalyDetectorPtr;
+
+}  // namespace rdc
+}  // namespace amd
+
+#endif  // INCLUDE_RDC_LIB_IMPL_RDCANOMALYDETECTOR_H_
@@ -22,14 +22,22 @@ THE SOFTWARE.
 #ifndef INCLUDE_RDC_LIB_IMPL_RDCCACHEMANAGERIMPL_H_
 #define INCLUDE_RDC_LIB_IMPL_RDCCACHEMANAGERIMPL_H_
 
+#include <atomic>
+#include <deque>
 #include <map>
 #include <memory>
 #include <mutex>  // NOLINT(build/c++11)
+#include <set>
 #include <string>
 #include <vector>
 
 #include "rdc/rdc.h"
 #include "rdc_lib/RdcCacheManager.h"
+#include "rdc_lib/impl/RdcCompressedBlock.h"
+#include "rdc_lib/impl/RdcJobStore.h"
+#include "rdc_lib/impl/RdcJobTimeline.h"
+#include "rdc_lib/impl/RdcPersistentStore.h"
+#include "rdc_lib/impl/RdcQuantileSketch.h"
 #include "rdc_lib/rdc_common.h"
 
 namespace amd {
@@ -46,6 +54,33 @@ struct RdcCacheEntry {
 
 typedef std::map<RdcFieldKey, std::vector<RdcCacheEntry>> RdcCacheSamples;
 
+//!< Samples older than the cold age, sealed into compressed blocks. They
+//!< are older than every sample still in RdcCacheSamples.
+typedef std::map<RdcFieldKey, std::deque<RdcCompressedBlock>> RdcColdSamples;
+
+//!< The numeric samples of a field which fell into one time bucket
+struct RdcRollupBucket {
+  uint64_t start_time;  //!< Aligned to the width of the tier
+  uint64_t last_time;
+  uint64_t count;
+  double min_value;
+  double max_value;
+  double sum;
+  double last_value;
+};
+
+//!< Bucket width and how long buckets are kept, in milliseconds
+struct RdcRollupTier {
+  uint64_t width;
+  uint64_t retention;
+};
+
+struct RdcFieldRollups {
+  uint64_t first_time;  //!< The first sample ever rolled up
+  std::vector<std::deque<RdcRollupBucket>> tiers;  //!< Oldest bucket first
+};
+typedef std::map<RdcFieldKey, RdcFieldRollups> RdcRollupCache;
+
 struct FieldSummaryStats {
   int64_t max_value;
   int64_t min_value;
@@ -61,6 +96,8 @@ struct FieldSummaryStats {
 
   uint64_t last_time;
   uint64_t count;
+
+  RdcQuantileSketch sketch;  //!< For the percentiles
 };
 
 struct GpuSummaryStats {
@@ -69,6 +106,7 @@ struct GpuSummaryStats {
   uint64_t ecc_correct_init;    // Init counter when job starts
   uint64_t ecc_uncorrect_init;  // Init counter when job starts
   std::map<uint32_t, FieldSummaryStats> field_summaries;
+  std::map<uint32_t, RdcJobTimeline> timelines;
 };
 
 // Per job entry
@@ -76,6 +114,7 @@ struct RdcJobStatsCacheEntry {
   uint64_t start_time;
   uint64_t end_time;
   std::map<uint32_t, GpuSummaryStats> gpu_stats;
+  uint64_t last_used;  //!< For the LRU eviction of the stopped jobs, not persisted
 };
 
 // <job_id, job_stats>
@@ -83,15 +122,29 @@ typedef std::map<std::string, RdcJobStatsCacheEntry> RdcJobStatsCache;
 
 class RdcCacheManagerImpl : public RdcCacheManager {
  public:
+  RdcCacheManagerImpl();
+  ~RdcCacheManagerImpl();
+
   rdc_status_t rdc_field_get_latest_value(uint32_t gpu_index, rdc_field_t field,
                                           rdc_field_value* value) override;
   rdc_status_t rdc_field_get_value_since(uint32_t gpu_index, rdc_field_t field,
                                          uint64_t since_time_stamp, uint64_t* next_since_time_stamp,
                                          rdc_field_value* value) override;
+  rdc_status_t rdc_field_get_rollup(uint32_t gpu_index, rdc_field_t field, uint64_t start_ts,
+                                    uint64_t end_ts, rdc_field_rollups_t* rollups) override;
+  rdc_status_t rdc_field_get_group_aggregate(const std::vector<uint32_t>& gpu_indexes,
+                                             const std::vector<rdc_field_t>& field_ids,
+                                             uint64_t window_ms, const rdc_aggregate_spec_t* specs,
+                                             uint32_t num_specs,
+                                             rdc_group_aggregate_t* aggregate) override;
   rdc_status_t rdc_update_cache(uint32_t gpu_index, const rdc_field_value& value) override;
   rdc_status_t evict_cache(uint32_t gpu_index, rdc_field_t field_id, uint64_t max_keep_samples,
                            double max_keep_age) override;
   std::string get_cache_stats() override;
+  void get_cache_usage(uint64_t* num_samples, uint64_t* num_bytes) override;
+  uint64_t get_generation(const RdcFieldKey& field) const override {
+    return generations_[generation_stripe(field)].load(std::memory_order_acquire);
+  }
 
   rdc_status_t rdc_job_get_stats(const char job_id[64], const rdc_gpu_gauges_t& gpu_gauges,
                                  rdc_job_info_t* p_job_info) override;
@@ -100,20 +153,81 @@ class RdcCacheManagerImpl : public RdcCacheManager {
                                    const rdc_gpu_gauges_t& gpu_gauges) override;
   rdc_status_t rdc_job_stop_stats(const char job_id[64],
                                   const rdc_gpu_gauges_t& gpu_gauge) override;
+  rdc_status_t rdc_job_get_timeline(const char job_id[64], uint32_t gpu_index, rdc_field_t field,
+                                    const rdc_gpu_gauges_t& gpu_gauges,
+                                    rdc_job_timeline_t* timeline) override;
   rdc_status_t rdc_update_job_stats(uint32_t gpu_index, const std::string& job_id,
                                     const rdc_field_value& value) override;
   rdc_status_t rdc_job_remove(const char job_id[64]) override;
+  rdc_status_t rdc_job_get_gpus(const char job_id[64], std::vector<uint32_t>* gpu_indexes,
+                                bool* is_running) override;
   rdc_status_t rdc_job_remove_all() override;
+  rdc_status_t rdc_job_list(const rdc_job_filter_t& filter, rdc_job_list_t* jobs) override;
 
  private:
+  //!< merged accumulates the sketches of the GPUs for the job summary
   void set_summary(const FieldSummaryStats& stats, rdc_stats_summary_t& gpu,
                    rdc_stats_summary_t& summary,  // NOLINT
-                   unsigned int adjuster);
+                   unsigned int adjuster, RdcQuantileSketch* merged);
   void set_average_summary(rdc_stats_summary_t& summary,
                            uint32_t num_gpus);  // NOLINT
+  //!< The job stats as reported by rdc_job_get_stats, called with
+  //!< cache_mutex_ held
+  rdc_status_t fill_job_info(const RdcJobStatsCacheEntry& job, const rdc_gpu_gauges_t& gpu_gauges,
+                             rdc_job_info_t* p_job_info);
+  //!< Drop the least recently used stopped jobs beyond max_stopped_jobs_,
+  //!< called with cache_mutex_ held. Only the jobs in the job store are
+  //!< dropped, rdc_job_get_stats reads them back from it.
+  void evict_stopped_jobs();
+  //!< Fold a sample into every tier, computed at ingest so a query never
+  //!< has to revisit the raw samples
+  void update_rollups(const RdcFieldKey& field, const rdc_field_value& value);
+  //!< Drop the buckets which fell out of the retention of their tier
+  void trim_rollups(RdcFieldRollups* rollups, uint64_t now);
+  //!< Move the samples older than cold_age_ into the compressed blocks,
+  //!< always leaving the latest sample uncompressed
+  void seal_cold_samples(const RdcFieldKey& field, std::vector<RdcCacheEntry>* samples,
+                         uint64_t now);
+  void cache_sample(const RdcFieldKey& field, const rdc_field_value& value);
+  //!< Append the numeric samples of a field since start_ts, or only its
+  //!< latest one, called with cache_mutex_ held
+  void gather_samples(const RdcFieldKey& field, uint64_t start_ts, bool latest_only,
+                      std::vector<double>* values, std::vector<uint64_t>* times);
+  //!< Called with cache_mutex_ held
+  rdc_status_t evict_samples(const RdcFieldKey& field, uint64_t max_keep_samples,
+                             double max_keep_age, uint64_t now);
+  //!< Persistence, called with cache_mutex_ held
+  void persist_record(RdcPersistRecordKind kind, const void* payload, uint32_t length);
+  void persist_job(const std::string& job_id, const RdcJobStatsCacheEntry& job);
+  void persist_dirty_jobs();
+  void replay_record(RdcPersistRecordKind kind, const uint8_t* payload, uint32_t length);
+  //!< The job watches are not persisted, so the jobs which were running
+  //!< are stopped at their last persisted sample once replayed
+  void stop_restored_jobs();
   RdcCacheSamples cache_samples_;
+  RdcColdSamples cold_samples_;
+  uint64_t cold_age_;  //!< In milliseconds, 0 keeps every sample uncompressed
+  std::vector<RdcRollupTier> rollup_tiers_;  //!< Finest first
+  RdcRollupCache rollups_;
   RdcJobStatsCache cache_jobs_;
+  std::set<std::string> dirty_jobs_;  //!< Updated since they were last persisted
+  uint64_t job_use_count_;            //!< The clock of RdcJobStatsCacheEntry::last_used
+  uint32_t max_stopped_jobs_;         //!< Kept in memory when there is a job store
+  std::unique_ptr<RdcJobStore> job_store_;
   std::mutex cache_mutex_;
+  //!< The generations of the fields, hashed into stripes so they are read
+  //!< without cache_mutex_. Fields sharing a stripe only rebuild more often.
+  static const size_t kGenerationStripes = 1024;
+  static size_t generation_stripe(const RdcFieldKey& field) {
+    return (field.first * 2654435761u + field.second) % kGenerationStripes;
+  }
+  //!< Bumped under cache_mutex_ after a sample is cached or a field emptied
+  void bump_generation(const RdcFieldKey& field) {
+    generations_[generation_stripe(field)].fetch_add(1, std::memory_order_release);
+  }
+  std::atomic<uint64_t> generations_[kGenerationStripes] = {};
+  //!< Last, so its flusher stops before the members it reads are destroyed
+  std::unique_ptr<RdcPersistentStore> store_;
 };
 
 }  // namespace rdc
@@ -0,0 +1,111 @@
+/*
+Copyright (c) 2024 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#ifndef INCLUDE_RDC_LIB_IMPL_RDCCOMPRESSEDBLOCK_H_
+#define INCLUDE_RDC_LIB_IMPL_RDCCOMPRESSEDBLOCK_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "rdc/rdc.h"
+
+namespace amd {
+namespace rdc {
+
+//!< An append only, bit packed block of the samples of one numeric field,
+//!< using the encoding of the Gorilla paper. Timestamps are stored as the
+//!< delta of their delta, so a steady sampling interval costs one bit:
+//!<   '0'                   delta of delta is 0
+//!<   '10'   + 7 bits       [-63, 64]
+//!<   '110'  + 9 bits       [-255, 256]
+//!<   '1110' + 12 bits      [-2047, 2048]
+//!<   '1111' + 64 bits      anything else
+//!< DOUBLE values are XORed with the previous value:
+//!<   '0'                   same value
+//!<   '10'  + bits          the meaningful bits fit the previous window
+//!<   '11'  + 5 bits leading zeros + 6 bits length - 1 + bits
+//!< INTEGER values are zigzag encoded deltas:
+//!<   '0'                   same value
+//!<   '1'   + varint        7 bits per group plus a continuation bit
+//!< The first sample of a block is stored as two raw 64 bit words.
+class RdcCompressedBlock {
+ public:
+  static const uint32_t kMaxSamples = 1024;
+
+  //!< type is INTEGER or DOUBLE
+  explicit RdcCompressedBlock(rdc_field_type_t type);
+  //!< A block read back from data(), it can only be decoded
+  RdcCompressedBlock(rdc_field_type_t type, uint32_t count, const uint8_t* data, size_t length);
+
+  //!< Samples must be appended oldest first. Returns false when full.
+  bool append(uint64_t ts, const rdc_field_value_data& value);
+
+  bool full() const { return count_ >= kMaxSamples; }
+  uint32_t count() const { return count_; }
+  uint64_t first_time() const { return first_time_; }
+  uint64_t last_time() const { return last_time_; }
+  rdc_field_type_t type() const { return type_; }
+  size_t size_bytes() const { return bits_.capacity(); }
+  const std::vector<uint8_t>& data() const { return bits_; }
+
+  //!< Decodes the samples of a block oldest first. The block must outlive
+  //!< the reader and must not be appended to while it is read.
+  class Reader {
+   public:
+    explicit Reader(const RdcCompressedBlock& block);
+    bool next(uint64_t* ts, rdc_field_value_data* value);
+
+   private:
+    uint64_t read_bits(uint32_t num_bits);
+
+    const RdcCompressedBlock& block_;
+    size_t pos_;
+    uint32_t index_;
+    uint64_t ts_;
+    int64_t delta_;
+    uint64_t value_;
+    uint32_t leading_;
+    uint32_t trailing_;
+  };
+
+ private:
+  void write_bits(uint64_t bits, uint32_t num_bits);
+  void write_timestamp(uint64_t ts);
+  void write_double(uint64_t bits);
+  void write_integer(int64_t value);
+
+  rdc_field_type_t type_;
+  std::vector<uint8_t> bits_;
+  size_t num_bits_;
+  uint32_t count_;
+  uint64_t first_time_;
+  uint64_t last_time_;
+  int64_t last_delta_;
+  uint64_t last_value_;  //!< The raw bits of the double or the int64_t
+  uint32_t leading_;
+  uint32_t trailing_;
+};
+
+}  // namespace rdc
+}  // namespace amd
+
+#endif  // INCLUDE_RDC_LIB_IMPL_RDCCOMPRESSEDBLOCK_H_
@@ -0,0 +1,148 @@
+/*
+Copyright (c) 2024 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#ifndef INCLUDE_RDC_LIB_IMPL_RDCDERIVEDFIELDS_H_
+#define INCLUDE_RDC_LIB_IMPL_RDCDERIVEDFIELDS_H_
+
+#include <array>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>  // NOLINT(build/c++11)
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "rdc/rdc.h"
+#include "rdc_lib/RdcTelemetry.h"
+#include "rdc_lib/rdc_common.h"
+
+namespace amd {
+namespace rdc {
+
+//!< Computes the RDC_FI_DERIVED_* fields. Each expression is compiled once
+//!< into a postfix program, which runs on the latest sample of its fields
+//!< whenever one of them is cached. The results are served to the watch
+//!< table by this telemetry module, so the derived fields are watched and
+//!< cached like the others. A derived field is only computed on the GPUs it
+//!< is watched on, and its aggregates run over those GPUs.
+class RdcDerivedFields : public RdcTelemetry {
+ public:
+  RdcDerivedFields();
+
+  rdc_status_t set_expression(rdc_field_t field_id, const std::string& expression);
+  rdc_status_t clear_expression(rdc_field_t field_id);
+
+  //!< Sets the expressions of a file, one "<field> = <expression>" per line
+  rdc_status_t load_file(const std::string& path);
+
+  //!< Called by the ingest path for every sample it caches
+  void evaluate(uint32_t gpu_index, const rdc_field_value& value);
+
+  //!< Sets the watched fields with their update interval in microseconds,
+  //!< on every watch and unwatch. The other fields than the derived ones
+  //!< are ignored.
+  void set_watched(const std::map<RdcFieldKey, uint64_t>& update_freqs);
+
+  //!< Appends the fields read by a derived field, and by the derived fields
+  //!< it reads, so they are watched with it
+  void get_inputs(rdc_field_t field_id, std::vector<rdc_field_t>* inputs);
+
+  rdc_status_t rdc_telemetry_fields_query(uint32_t field_ids[MAX_NUM_FIELDS],
+                                          uint32_t* field_count) override;
+
+  rdc_status_t rdc_telemetry_fields_value_get(rdc_gpu_field_t* fields, uint32_t fields_count,
+                                              rdc_field_value_f callback, void* user_data) override;
+
+  rdc_status_t rdc_telemetry_fields_watch(rdc_gpu_field_t* fields, uint32_t fields_count) override;
+  rdc_status_t rdc_telemetry_fields_unwatch(rdc_gpu_field_t* fields,
+                                            uint32_t fields_count) override;
+
+ private:
+  enum OpCode {
+    OP_CONST,  //!< Push the constant
+    OP_FIELD,  //!< Push the latest sample of the field on the GPU
+    OP_SUM,    //!< Push an aggregate of the latest samples of the field on
+    OP_AVG,    //!< the GPUs the derived field is watched on
+    OP_MIN,
+    OP_MAX,
+    OP_ADD,  //!< Pop two operands and push the result
+    OP_SUB,
+    OP_MUL,
+    OP_DIV,
+    OP_NEG,  //!< Negate the top of the stack
+  };
+
+  struct Op {
+    OpCode code;
+    uint32_t field_id;
+    double constant;
+  };
+
+  struct Program {
+    bool enabled;
+    std::string expression;
+    std::vector<Op> ops;
+    std::vector<uint32_t> inputs;  //!< The fields read by ops
+    bool has_aggregate;            //!< The result of a GPU depends on the others
+  };
+
+  struct Sample {
+    uint64_t ts;
+    double value;
+  };
+
+  struct Result {
+    uint64_t ts;  //!< Timestamp of the sample which triggered the run
+    double value;
+  };
+
+  //!< Compiles an expression into postfix ops, logging why it does not parse
+  static rdc_status_t compile(const std::string& expression, std::vector<Op>* ops);
+  //!< Runs a program for a GPU, false when one of its fields has no sample
+  //!< newer than min_ts or the result is not a number. The aggregates run
+  //!< over the watched GPUs. Called with mutex_ held.
+  bool run(const Program& program, uint32_t gpu_index, uint64_t min_ts,
+           const std::map<uint32_t, uint64_t>& watched, double* result) const;
+  //!< Called with mutex_ held
+  void update_dependents();
+
+  //!< Lets evaluate() skip the lock when there is no expression
+  std::atomic<uint32_t> num_programs_;
+
+  std::mutex mutex_;
+  std::array<Program, RDC_MAX_DERIVED_FIELDS> programs_;
+  //!< The derived fields to run per field read by an expression
+  std::unordered_map<uint32_t, std::vector<uint32_t>> dependents_;
+  //!< The latest sample of those fields per GPU
+  std::unordered_map<uint32_t, std::map<uint32_t, Sample>> latest_;
+  //!< The GPUs each derived field is watched on, with its update interval
+  //!< in milliseconds
+  std::array<std::map<uint32_t, uint64_t>, RDC_MAX_DERIVED_FIELDS> watched_;
+  std::array<std::unordered_map<uint32_t, Result>, RDC_MAX_DERIVED_FIELDS> results_;
+};
+
+typedef std::shared_ptr<RdcDerivedFields> RdcDerivedFieldsPtr;
+
+}  // namespace rdc
+}  // namespace amd
+
+#endif  // INCLUDE_RDC_LIB_IMPL_RDCDERIVEDFIELDS_H_
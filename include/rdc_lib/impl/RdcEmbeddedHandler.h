@@ -32,6 +32,11 @@ THE SOFTWARE.
 #include "rdc_lib/RdcModuleMgr.h"
 #include "rdc_lib/RdcNotification.h"
 #include "rdc_lib/RdcWatchTable.h"
+#include "rdc_lib/impl/RdcAnomalyDetector.h"
+#include "rdc_lib/impl/RdcDerivedFields.h"
+#include "rdc_lib/impl/RdcHistoryLog.h"
+#include "rdc_lib/impl/RdcJobGauges.h"
+#include "rdc_lib/impl/RdcPolicyEngine.h"
 
 namespace amd {
 namespace rdc {
@@ -43,6 +48,9 @@ class RdcEmbeddedHandler final : public RdcHandler {
                                    uint64_t update_freq) override;
   rdc_status_t rdc_job_get_stats(const char jobId[64], rdc_job_info_t* p_job_info) override;
   rdc_status_t rdc_job_stop_stats(const char job_id[64]) override;
+  rdc_status_t rdc_job_get_timeline(const char job_id[64], uint32_t gpu_index, rdc_field_t field,
+                                    rdc_job_timeline_t* timeline) override;
+  rdc_status_t rdc_job_list(const rdc_job_filter_t* filter, rdc_job_list_t* jobs) override;
   rdc_status_t rdc_job_remove(const char job_id[64]) override;
   rdc_status_t rdc_job_remove_all() override;
 
@@ -79,6 +87,29 @@ class RdcEmbeddedHandler final : public RdcHandler {
   rdc_status_t rdc_field_get_value_since(uint32_t gpu_index, rdc_field_t field,
                                          uint64_t since_time_stamp, uint64_t* next_since_time_stamp,
                                          rdc_field_value* value) override;
+  rdc_status_t rdc_field_get_rollup(uint32_t gpu_index, rdc_field_t field, uint64_t start_ts,
+                                    uint64_t end_ts, rdc_field_rollups_t* rollups) override;
+  rdc_status_t rdc_field_get_history(uint32_t gpu_index, rdc_field_t field, uint64_t since_ts,
+                                     uint64_t until_ts, rdc_field_history_t* history) override;
+  rdc_status_t rdc_policy_add_rule(const rdc_policy_rule_t* rule, uint32_t* rule_id) override;
+  rdc_status_t rdc_policy_delete_rule(uint32_t rule_id) override;
+  rdc_status_t rdc_policy_get_violations(uint64_t since_seq, uint32_t timeout_ms,
+                                         rdc_policy_violations_t* violations) override;
+  rdc_status_t rdc_anomaly_set_detector(uint32_t detector_id,
+                                        const rdc_anomaly_config_t* config) override;
+  rdc_status_t rdc_anomaly_clear_detector(uint32_t detector_id) override;
+  rdc_status_t rdc_field_derived_set(rdc_field_t field_id, const char* expression) override;
+  rdc_status_t rdc_field_derived_clear(rdc_field_t field_id) override;
+  rdc_status_t rdc_field_ingest(uint32_t gpu_index, const rdc_field_value* values,
+                                uint32_t num_values, double max_keep_age,
+                                uint32_t max_keep_samples) override;
+  rdc_status_t rdc_aggregate_get_hosts(rdc_aggregate_hosts_t* hosts) override;
+  rdc_status_t rdc_aggregate_get_field(rdc_field_t field, rdc_aggregate_op_t op,
+                                       rdc_cluster_aggregate_t* aggregate) override;
+  rdc_status_t rdc_field_get_group_aggregate(rdc_gpu_group_t group_id,
+                                             rdc_field_grp_t field_group_id, uint64_t window_ms,
+                                             const rdc_aggregate_spec_t* specs, uint32_t num_specs,
+                                             rdc_group_aggregate_t* aggregate) override;
   rdc_status_t rdc_field_unwatch(rdc_gpu_group_t group_id, rdc_field_grp_t field_group_id) override;
   // Diagnostic API
   rdc_status_t rdc_diagnostic_run(rdc_gpu_group_t group_id, rdc_diag_level_t level,
@@ -90,24 +121,35 @@ class RdcEmbeddedHandler final : public RdcHandler {
 
   // Control API
   rdc_status_t rdc_field_update_all(uint32_t wait_for_update) override;
+  rdc_status_t rdc_perf_stats_get(rdc_perf_stats_t* stats) override;
+  rdc_status_t rdc_pipeline_trace_set(uint32_t enabled) override;
+  rdc_status_t rdc_pipeline_trace_get(uint64_t start_seq, rdc_pipeline_events_t* events) override;
+  rdc_status_t rdc_log_level_set(rdc_log_level_t level) override;
 
   // It is just a client interface under the GRPC framework and is not used as an RDC API.
   // Pure virtual functions need to be overridden.
   rdc_status_t get_mixed_component_version(mixed_component_t component, mixed_component_version_t* p_mixed_compv) override;
+  rdc_status_t get_cache_generation(uint32_t gpu_index, rdc_field_t field_id,
+                                    uint64_t* cache_generation,
+                                    uint64_t* group_generation) override;
 
   explicit RdcEmbeddedHandler(rdc_operation_mode_t op_mode);
   ~RdcEmbeddedHandler() final;
 
  private:
-  rdc_status_t get_gpu_gauges(rdc_gpu_gauges_t* gpu_gauges);
   RdcGroupSettingsPtr group_settings_;
   RdcCacheManagerPtr cache_mgr_;
   RdcMetricFetcherPtr metric_fetcher_;
+  RdcAnomalyDetectorPtr anomaly_;
+  RdcDerivedFieldsPtr derived_;
   RdcModuleMgrPtr rdc_module_mgr_;
   RdcNotificationPtr rdc_notif_;
+  RdcHistoryLogPtr history_log_;
+  RdcPolicyEnginePtr policy_;
   RdcWatchTablePtr watch_table_;
   RdcMetricsUpdaterPtr metrics_updater_;
   std::future<void> updater_;
+  RdcJobGaugesPtr job_gauges_;
 };
 
 }  // namespace rdc
@@ -0,0 +1,136 @@
+/*
+Copyright (c) 2024 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#ifndef INCLUDE_RDC_LIB_IMPL_RDCENCODING_H_
+#define INCLUDE_RDC_LIB_IMPL_RDCENCODING_H_
+
+#include <string.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+
+#include "rdc_lib/RdcLogger.h"
+
+namespace amd {
+namespace rdc {
+
+//!< The positive integer in the environment variable name, or default_value
+//!< if it is unset or invalid
+inline uint64_t env_or_default(const char* name, uint64_t default_value) {
+  const char* value = getenv(name);
+  if (value == nullptr) {
+    return default_value;
+  }
+  char* end = nullptr;
+  uint64_t parsed = strtoull(value, &end, 10);
+  if (end == value || *end != '\0' || parsed == 0) {
+    RDC_LOG(RDC_ERROR, "Invalid " << name << " " << value << ", using " << default_value);
+    return default_value;
+  }
+  return parsed;
+}
+
+//!< Maps small negative numbers to small varints
+inline uint64_t zigzag(int64_t v) {
+  return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+}
+
+inline int64_t unzigzag(uint64_t v) {
+  return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+}
+
+//!< 7 bits per byte, lowest first, with the high bit set on all but the
+//!< last byte. Buffer is a std::string or a std::vector<uint8_t>.
+template <typename Buffer>
+void put_varint(Buffer* buf, uint64_t v) {
+  while (v >= 0x80) {
+    buf->push_back(static_cast<typename Buffer::value_type>((v & 0x7f) | 0x80));
+    v >>= 7;
+  }
+  buf->push_back(static_cast<typename Buffer::value_type>(v));
+}
+
+//!< The bytes of a trivially copyable value, read back by PayloadReader::get
+template <typename T>
+void put_raw(std::string* buf, const T& v) {
+  buf->append(reinterpret_cast<const char*>(&v), sizeof(T));
+}
+
+//!< Bounds checked reads of an encoded record. A failed read consumes
+//!< nothing.
+class PayloadReader {
+ public:
+  PayloadReader(const uint8_t* data, size_t length) : cur_(data), end_(data + length) {}
+
+  bool eof() const { return cur_ >= end_; }
+  size_t remaining() const { return end_ - cur_; }
+
+  bool get_byte(uint8_t* v) {
+    if (cur_ >= end_) return false;
+    *v = *cur_++;
+    return true;
+  }
+
+  bool get_varint(uint64_t* v) {
+    const uint8_t* cur = cur_;
+    *v = 0;
+    for (uint32_t shift = 0; shift < 64 && cur < end_; shift += 7) {
+      uint8_t b = *cur++;
+      *v |= static_cast<uint64_t>(b & 0x7f) << shift;
+      if ((b & 0x80) == 0) {
+        cur_ = cur;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  template <typename T>
+  bool get(T* v) {
+    return get_bytes(v, sizeof(T));
+  }
+
+  bool get_bytes(void* dst, size_t len) {
+    if (remaining() < len) return false;
+    memcpy(dst, cur_, len);
+    cur_ += len;
+    return true;
+  }
+
+  //!< The next len bytes in place, nullptr if there are fewer
+  const uint8_t* get_bytes(size_t len) {
+    if (remaining() < len) return nullptr;
+    const uint8_t* bytes = cur_;
+    cur_ += len;
+    return bytes;
+  }
+
+ private:
+  const uint8_t* cur_;
+  const uint8_t* end_;
+};
+
+}  // namespace rdc
+}  // namespace amd
+
+#endif  // INCLUDE_RDC_LIB_IMPL_RDCENCODING_H_
@@ -22,6 +22,7 @@ THE SOFTWARE.
 #ifndef INCLUDE_RDC_LIB_IMPL_RDCGROUPSETTINGSIMPL_H_
 #define INCLUDE_RDC_LIB_IMPL_RDCGROUPSETTINGSIMPL_H_
 
+#include <atomic>
 #include <map>
 #include <memory>
 #include <mutex>  // NOLINT
@@ -50,6 +51,9 @@ class RdcGroupSettingsImpl : public RdcGroupSettings {
                                         rdc_field_group_info_t* field_group_info) override;
   rdc_status_t rdc_group_field_get_all_ids(rdc_field_grp_t field_group_id_list[],
                                            uint32_t* count) override;
+  uint64_t get_generation() const override {
+    return generation_.load(std::memory_order_acquire);
+  }
 
   RdcGroupSettingsImpl();
 
@@ -60,6 +64,7 @@ class RdcGroupSettingsImpl : public RdcGroupSettings {
   uint32_t cur_field_group_id_ = 0;
   std::mutex group_mutex_;
   std::mutex field_group_mutex_;
+  std::atomic<uint64_t> generation_{0};
 };
 
 }  // namespace rdc
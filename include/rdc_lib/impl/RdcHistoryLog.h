@@ -0,0 +1,147 @@
+/*
+Copyright (c) 2024 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#ifndef INCLUDE_RDC_LIB_IMPL_RDCHISTORYLOG_H_
+#define INCLUDE_RDC_LIB_IMPL_RDCHISTORYLOG_H_
+
+#include <condition_variable>  // NOLINT(build/c++11)
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <mutex>  // NOLINT(build/c++11)
+#include <string>
+#include <thread>  // NOLINT(build/c++11)
+#include <tuple>
+#include <vector>
+
+#include "rdc/rdc.h"
+#include "rdc_lib/impl/RdcCompressedBlock.h"
+
+namespace amd {
+namespace rdc {
+
+//!< The span of one block in a segment, the sparse time index
+struct RdcHistoryIndexEntry {
+  uint64_t min_ts;
+  uint64_t max_ts;
+  uint64_t offset;
+};
+
+//!< Long term log of every ingested field value and event, for post-mortem
+//!< analysis after the cache evicted them. Samples are queued by the
+//!< collection threads and written by a dedicated I/O thread into segment
+//!< files named history.<seq>.log. A segment is:
+//!<   header     8 byte magic "RDCHST01", 8 byte seq
+//!<   blocks     32 byte header (magic, payload bytes, min_ts, max_ts,
+//!<              number of samples, CRC32 of the payload), then payload
+//!<   index      a RdcHistoryIndexEntry per block and a 24 byte trailer,
+//!<              written when the segment is sealed
+//!< A block holds a few seconds of samples grouped by series. INTEGER and
+//!< DOUBLE series are RdcCompressedBlock data, STRING and BLOB series are
+//!< varint timestamps and lengths followed by the bytes. A segment without
+//!< an index, left by a crash, is indexed by walking its block headers.
+class RdcHistoryLog {
+ public:
+  //!< Throws RdcException if the directory cannot be used
+  RdcHistoryLog(const std::string& dir, uint64_t segment_bytes, uint32_t max_segments,
+                uint32_t block_ms);
+  ~RdcHistoryLog();
+
+  //!< Returns a log if RDC_HISTORY_DIR names a directory, nullptr otherwise
+  static std::shared_ptr<RdcHistoryLog> from_env();
+
+  //!< Queue a value for the I/O thread, never blocks on the disk
+  void append(uint32_t gpu_index, const rdc_field_value& value);
+
+  //!< The values of a field with since_ts <= ts <= until_ts, oldest first.
+  //!< Only the blocks already written are searched. A page ends before the
+  //!< first timestamp it cannot hold entirely, which is next_since_ts.
+  rdc_status_t query(uint32_t gpu_index, rdc_field_t field_id, uint64_t since_ts,
+                     uint64_t until_ts, rdc_field_history_t* history);
+
+ private:
+  struct PendingSample {
+    uint64_t ts;
+    uint32_t gpu_index;
+    rdc_field_t field_id;
+    rdc_field_type_t type;
+    int64_t l_int;  //!< Also the bits of a DOUBLE
+    std::string str;
+  };
+
+  struct Series {
+    uint32_t count;
+    std::vector<RdcCompressedBlock> numeric;
+    std::string raw;  //!< STRING and BLOB samples
+    uint64_t last_ts;
+  };
+  typedef std::tuple<uint32_t, uint32_t, uint32_t> SeriesKey;  //!< gpu, field, type
+
+  struct Segment {
+    std::string path;
+    uint64_t seq;
+    uint64_t min_ts;
+    uint64_t max_ts;
+    std::vector<RdcHistoryIndexEntry> index;
+  };
+
+  void io_loop();
+  void add_to_block(const PendingSample& sample);
+  void write_block();
+  void seal_segment();
+  bool open_segment();
+  bool load_segment(Segment* segment);
+
+  std::string dir_;
+  uint64_t segment_bytes_;
+  uint32_t max_segments_;
+  uint32_t block_ms_;
+
+  //!< Filled by append(), drained by the I/O thread
+  std::mutex pending_mutex_;
+  std::condition_variable pending_cv_;
+  std::vector<PendingSample> pending_;
+  uint64_t dropped_;
+  bool stop_;
+
+  //!< Owned by the I/O thread
+  std::map<SeriesKey, Series> block_;
+  uint32_t block_samples_;
+  uint64_t block_min_ts_;
+  uint64_t block_max_ts_;
+  uint64_t block_start_;  //!< When the first sample of the block was queued
+  std::FILE* file_;
+  uint64_t file_bytes_;
+
+  //!< The segments oldest first, the last one is being written
+  std::mutex segments_mutex_;
+  std::vector<Segment> segments_;
+  uint64_t next_seq_;
+
+  std::thread io_thread_;
+};
+
+typedef std::shared_ptr<RdcHistoryLog> RdcHistoryLogPtr;
+
+}  // namespace rdc
+}  // namespace amd
+
+#endif  // INCLUDE_RDC_LIB_IMPL_RDCHISTORYLOG_H_
@@ -0,0 +1,81 @@
+/*
+Copyright (c) 2024 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#ifndef INCLUDE_RDC_LIB_IMPL_RDCJOBGAUGES_H_
+#define INCLUDE_RDC_LIB_IMPL_RDCJOBGAUGES_H_
+
+#include <map>
+#include <memory>
+#include <mutex>  // NOLINT(build/c++11)
+#include <vector>
+
+#include "rdc/rdc.h"
+#include "rdc_lib/RdcCacheManager.h"
+#include "rdc_lib/RdcMetricFetcher.h"
+#include "rdc_lib/RdcWatchTable.h"
+#include "rdc_lib/rdc_common.h"
+
+namespace amd {
+namespace rdc {
+
+//!< How RdcJobGauges::get reads the ECC totals
+enum RdcEccGauges : uint8_t {
+  RDC_ECC_GAUGES_NONE = 0,
+  //!< For the start and the stop of a job, which bound its ECC counts: a
+  //!< watch cache sample no older than the update interval of its watch,
+  //!< otherwise fetched
+  RDC_ECC_GAUGES_FRESH,
+  //!< For the stats of a running job: a watch cache sample or a fetched
+  //!< one no older than RDC_JOB_GAUGE_MAX_AGE seconds, 10 by default
+  RDC_ECC_GAUGES_MEMOIZED,
+};
+
+//!< The gauges the job stats are computed with: the total memory of the
+//!< GPUs, and their ECC totals. Every RAS block is read for an ECC total,
+//!< so the samples of the watches are reused where they are recent enough.
+class RdcJobGauges {
+ public:
+  RdcJobGauges(const RdcCacheManagerPtr& cache_mgr, const RdcMetricFetcherPtr& metric_fetcher,
+               const RdcWatchTablePtr& watch_table);
+
+  rdc_status_t get(const std::vector<uint32_t>& gpu_indexes, RdcEccGauges ecc,
+                   rdc_gpu_gauges_t* gpu_gauges);
+
+ private:
+  rdc_status_t get_ecc(uint32_t gpu_index, rdc_field_t field, RdcEccGauges ecc, uint64_t now,
+                       uint64_t* value);
+
+  RdcCacheManagerPtr cache_mgr_;
+  RdcMetricFetcherPtr metric_fetcher_;
+  RdcWatchTablePtr watch_table_;
+
+  std::mutex mutex_;
+  std::map<uint32_t, uint64_t> memory_totals_;  //!< Static, fetched once per GPU
+  std::map<RdcFieldKey, rdc_field_value> ecc_gauges_;
+  uint64_t max_age_;  //!< In milliseconds
+};
+
+typedef std::shared_ptr<RdcJobGauges> RdcJobGaugesPtr;
+
+}  // namespace rdc
+}  // namespace amd
+
+#endif  // INCLUDE_RDC_LIB_IMPL_RDCJOBGAUGES_H_
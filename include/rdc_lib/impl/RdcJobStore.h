@@ -0,0 +1,107 @@
+/*
+Copyright (c) 2024 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#ifndef INCLUDE_RDC_LIB_IMPL_RDCJOBSTORE_H_
+#define INCLUDE_RDC_LIB_IMPL_RDCJOBSTORE_H_
+
+#include <map>
+#include <memory>
+#include <mutex>  // NOLINT(build/c++11)
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "rdc/rdc.h"
+#include "rdc_lib/impl/RdcJobTimeline.h"
+
+namespace amd {
+namespace rdc {
+
+//!< The timelines of a job by <GPU index, field id>
+typedef std::map<std::pair<uint32_t, uint32_t>, RdcJobTimeline> RdcJobTimelines;
+
+//!< Indexed log of the stopped jobs, so their stats outlive rdc_job_remove
+//!< and rdcd itself without being kept in memory. The jobs are appended to
+//!< <dir>/jobs.log:
+//!<   header     8 byte magic "RDCJOB01", 8 reserved bytes
+//!<   records    16 byte header (magic, payload bytes, CRC32 of the
+//!<              payload, reserved), then the payload: job_id[64], the
+//!<              number of GPUs, the summary rdc_gpu_usage_info_t, per
+//!<              GPU its index and rdc_gpu_usage_info_t, then the number of
+//!<              timelines and per timeline its GPU index, field id and
+//!<              RdcJobTimeline. The records written before the timelines
+//!<              end after the GPUs.
+//!< Only the indexes on the job id and on the start time are in memory.
+//!< They are rebuilt by walking the records when the log is opened, and a
+//!< torn record at the tail, left by a crash, is cut off.
+class RdcJobStore {
+ public:
+  //!< Throws RdcException if the directory cannot be used
+  explicit RdcJobStore(const std::string& dir);
+  ~RdcJobStore();
+
+  //!< Returns a store if RDC_JOB_STORE_DIR names a directory, nullptr otherwise
+  static std::unique_ptr<RdcJobStore> from_env();
+
+  //!< Append a stopped job. A job id seen before now reads this record, the
+  //!< older ones are still listed.
+  bool append(const std::string& job_id, const std::vector<uint32_t>& gpu_indexes,
+              const rdc_job_info_t& info, const RdcJobTimelines& timelines);
+
+  //!< The latest record of a job
+  rdc_status_t get(const std::string& job_id, rdc_job_info_t* info);
+
+  //!< The timeline of a field on a GPU in the latest record of a job
+  rdc_status_t get_timeline(const std::string& job_id, uint32_t gpu_index, uint32_t field_id,
+                            RdcJobTimeline* timeline);
+
+  //!< One page of the jobs matching the filter, by start time
+  rdc_status_t list(const rdc_job_filter_t& filter, rdc_job_list_t* jobs);
+
+  bool contains(const std::string& job_id);
+  size_t num_records();
+
+ private:
+  struct Record {
+    uint64_t start_time;
+    uint32_t payload_bytes;
+  };
+
+  //!< Read and check the payload of a record, called with mutex_ held
+  bool read_payload(uint64_t offset, uint32_t payload_bytes, std::string* payload);
+  void index_record(uint64_t offset, const std::string& job_id, uint64_t start_time,
+                    uint32_t payload_bytes);
+
+  std::string path_;
+  int fd_;
+  uint64_t file_bytes_;
+
+  std::mutex mutex_;
+  std::map<uint64_t, Record> records_;                     //!< By offset
+  std::map<std::string, uint64_t> by_job_id_;              //!< Offset of the latest record
+  std::set<std::pair<uint64_t, uint64_t>> by_start_time_;  //!< Start time, offset
+};
+
+}  // namespace rdc
+}  // namespace amd
+
+#endif  // INCLUDE_RDC_LIB_IMPL_RDCJOBSTORE_H_
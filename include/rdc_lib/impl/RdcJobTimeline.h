@@ -0,0 +1,74 @@
+/*
+Copyright (c) 2024 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#ifndef INCLUDE_RDC_LIB_IMPL_RDCJOBTIMELINE_H_
+#define INCLUDE_RDC_LIB_IMPL_RDCJOBTIMELINE_H_
+
+#include <cstdint>
+#include <type_traits>
+
+namespace amd {
+namespace rdc {
+
+//!< A fixed size, downsampled timeline of one field over the life of a
+//!< job. The samples are folded into kMaxBuckets buckets of equal width,
+//!< starting at kInitialWidth. When a sample falls past the last bucket,
+//!< adjacent buckets are merged in pairs and the width doubles, so a job of
+//!< any length keeps between half and all of the buckets.
+class RdcJobTimeline {
+ public:
+  static const uint32_t kMaxBuckets = 128;
+  static const uint64_t kInitialWidth = 1000;  //!< In milliseconds
+
+  struct Bucket {
+    double sum;
+    float min_value;
+    float max_value;
+    uint32_t count;
+  };
+
+  RdcJobTimeline();
+
+  //!< ts in milliseconds. Samples older than the first one are counted in
+  //!< the first bucket.
+  void add(uint64_t ts, int64_t value);
+
+  uint64_t start_time() const { return start_time_; }
+  uint64_t width() const { return width_; }
+  uint32_t num_buckets() const { return num_buckets_; }
+  //!< Buckets without a sample have a count of 0
+  const Bucket& bucket(uint32_t i) const { return buckets_[i]; }
+
+ private:
+  void merge_pairs();
+
+  uint64_t start_time_;
+  uint64_t width_;
+  uint32_t num_buckets_;
+  Bucket buckets_[kMaxBuckets];
+};
+static_assert(std::is_trivially_copyable<RdcJobTimeline>::value,
+              "RdcJobTimeline is persisted as is");
+
+}  // namespace rdc
+}  // namespace amd
+
+#endif  // INCLUDE_RDC_LIB_IMPL_RDCJOBTIMELINE_H_
@@ -27,6 +27,8 @@ THE SOFTWARE.
 #include "rdc_lib/RdcMetricFetcher.h"
 #include "rdc_lib/RdcModuleMgr.h"
 #include "rdc_lib/RdcTelemetry.h"
+#include "rdc_lib/impl/RdcAnomalyDetector.h"
+#include "rdc_lib/impl/RdcDerivedFields.h"
 
 namespace amd {
 namespace rdc {
@@ -35,7 +37,8 @@ class RdcModuleMgrImpl : public RdcModuleMgr {
  public:
   RdcTelemetryPtr get_telemetry_module() override;
   RdcDiagnosticPtr get_diagnostic_module() override;
-  explicit RdcModuleMgrImpl(const RdcMetricFetcherPtr& fetcher);
+  RdcModuleMgrImpl(const RdcMetricFetcherPtr& fetcher, const RdcAnomalyDetectorPtr& anomaly,
+                   const RdcDerivedFieldsPtr& derived);
 
  private:
   //  Modules
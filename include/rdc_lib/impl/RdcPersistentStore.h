@@ -0,0 +1,119 @@
+/*
+Copyright (c) 2024 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#ifndef INCLUDE_RDC_LIB_IMPL_RDCPERSISTENTSTORE_H_
+#define INCLUDE_RDC_LIB_IMPL_RDCPERSISTENTSTORE_H_
+
+#include <condition_variable>  // NOLINT(build/c++11)
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>  // NOLINT(build/c++11)
+#include <string>
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+namespace amd {
+namespace rdc {
+
+enum RdcPersistRecordKind : uint8_t {
+  RDC_PERSIST_SAMPLE = 1,      //!< A cached field value
+  RDC_PERSIST_JOB = 2,         //!< The full stats of a job, the last one wins
+  RDC_PERSIST_JOB_REMOVE = 3,  //!< A job id
+  RDC_PERSIST_JOB_REMOVE_ALL = 4,
+};
+
+//!< Append only log of records in memory mapped segment files named
+//!< cache.<seq>.seg. A segment starts with a 64 byte header carrying its
+//!< own CRC32, followed by 8 byte aligned records:
+//!<   length     4 bytes, 16 plus the payload length, written last
+//!<   checksum   4 bytes, CRC32 of kind and payload
+//!<   kind       1 byte, one of RdcPersistRecordKind, then 7 reserved bytes
+//!<   payload    length bytes
+//!< A zero length ends the segment, and a record failing its checksum is
+//!< a torn write which ends it too. Records reach the page cache as they
+//!< are appended and the disk every flush interval, never per record.
+class RdcPersistentStore {
+ public:
+  typedef std::function<void(RdcPersistRecordKind kind, const uint8_t* payload, uint32_t length)>
+      RecordVisitor;
+
+  //!< Maps the newest segment to keep appending to it. Throws RdcException
+  //!< if the directory cannot be used.
+  RdcPersistentStore(const std::string& dir, uint64_t segment_bytes, uint32_t max_segments,
+                     uint32_t flush_interval_ms);
+  ~RdcPersistentStore();
+
+  //!< Returns a store if RDC_CACHE_PERSIST_DIR names a directory
+  static std::unique_ptr<RdcPersistentStore> from_env();
+
+  //!< Visits every valid record, oldest segment first
+  void replay(const RecordVisitor& visitor);
+
+  //!< Starts a new segment if the record does not fit. Returns false if the
+  //!< record is larger than a segment or the store is disabled.
+  bool append(RdcPersistRecordKind kind, const void* payload, uint32_t length);
+
+  //!< True once a new segment could not be created, such as when the disk
+  //!< is full. Nothing is appended after that.
+  bool disabled();
+
+  //!< True once after append() started a new segment. The caller must then
+  //!< append again the state it needs to survive the oldest segments.
+  bool take_new_segment();
+
+  //!< Calls before_sync every flush interval, then sync()
+  void start_flusher(std::function<void()> before_sync);
+
+  //!< Writes the appended records to disk, then deletes the segments
+  //!< beyond max_segments
+  void sync();
+
+ private:
+  struct Segment;
+
+  std::shared_ptr<Segment> create_segment(uint64_t seq);
+  std::shared_ptr<Segment> map_segment(const std::string& path, bool writable);
+  std::string segment_path(uint64_t seq) const;
+  void flusher_loop(std::function<void()> before_sync);
+
+  std::string dir_;
+  uint64_t segment_bytes_;
+  uint32_t max_segments_;
+  uint32_t flush_interval_ms_;
+
+  std::mutex mutex_;
+  std::vector<std::string> sealed_;  //!< Oldest first
+  std::vector<std::shared_ptr<Segment>> unsynced_;  //!< Sealed since the last sync
+  std::shared_ptr<Segment> current_;
+  uint64_t next_seq_;
+  bool new_segment_;
+  bool disabled_;
+
+  std::thread flusher_;
+  std::condition_variable flusher_cv_;
+  bool stop_;
+};
+
+}  // namespace rdc
+}  // namespace amd
+
+#endif  // INCLUDE_RDC_LIB_IMPL_RDCPERSISTENTSTORE_H_
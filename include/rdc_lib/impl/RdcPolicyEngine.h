@@ -0,0 +1,100 @@
+/*
+Copyright (c) 2024 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#ifndef INCLUDE_RDC_LIB_IMPL_RDCPOLICYENGINE_H_
+#define INCLUDE_RDC_LIB_IMPL_RDCPOLICYENGINE_H_
+
+#include <atomic>
+#include <condition_variable>  // NOLINT(build/c++11)
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>  // NOLINT(build/c++11)
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "rdc/rdc.h"
+#include "rdc_lib/RdcNotification.h"
+
+namespace amd {
+namespace rdc {
+
+//!< Evaluates the policy rules on every cached sample. The rules are
+//!< compiled into a slot per (GPU, field, rule) holding the state of the
+//!< rule, so a sample costs one hash lookup plus its slots. The slots of a
+//!< (GPU, field) are built on its first sample. The violations go to a
+//!< bounded queue read with get_violations(), and are returned to the
+//!< ingest path as RDC_EVNT_NOTIF_POLICY_* events.
+class RdcPolicyEngine {
+ public:
+  RdcPolicyEngine();
+
+  rdc_status_t add_rule(const rdc_policy_rule_t& rule, uint32_t* rule_id);
+  rdc_status_t delete_rule(uint32_t rule_id);
+
+  //!< Called by the ingest path for every sample it caches. The violations
+  //!< raised or cleared by the sample are appended to events.
+  void evaluate(uint32_t gpu_index, const rdc_field_value& value,
+                std::vector<rdc_evnt_notification_t>* events);
+
+  //!< The violations with a seq above since_seq, waiting up to timeout_ms
+  //!< when there is none
+  rdc_status_t get_violations(uint64_t since_seq, uint32_t timeout_ms,
+                              rdc_policy_violations_t* violations);
+
+ private:
+  struct Slot {
+    uint32_t rule_id;
+    rdc_policy_rule_t rule;
+    uint64_t since_ts;  //!< When the condition started to hold, 0 if it does not
+    bool active;        //!< A violation was raised and not cleared yet
+    bool has_last;
+    double last_value;  //!< For RDC_POLICY_INCREASED
+  };
+
+  static uint64_t slot_key(uint32_t gpu_index, uint32_t field_id) {
+    return (static_cast<uint64_t>(gpu_index) << 32) | field_id;
+  }
+  static bool rule_matches(const rdc_policy_rule_t& rule, uint32_t gpu_index);
+  //!< Called with mutex_ held
+  void raise(const Slot& slot, uint32_t gpu_index, const rdc_field_value& value, double v,
+             bool cleared, std::vector<rdc_evnt_notification_t>* events);
+
+  //!< Lets evaluate() skip the lock when there is no rule
+  std::atomic<uint32_t> num_rules_;
+
+  std::mutex mutex_;
+  std::condition_variable violation_cv_;
+  uint32_t next_rule_id_;
+  std::map<uint32_t, rdc_policy_rule_t> rules_;
+  std::unordered_set<uint32_t> rule_fields_;  //!< The fields with a rule
+  std::unordered_map<uint64_t, std::vector<Slot>> slots_;
+  std::deque<rdc_policy_violation_t> violations_;  //!< Oldest first
+  uint64_t next_seq_;
+};
+
+typedef std::shared_ptr<RdcPolicyEngine> RdcPolicyEnginePtr;
+
+}  // namespace rdc
+}  // namespace amd
+
+#endif  // INCLUDE_RDC_LIB_IMPL_RDCPOLICYENGINE_H_
@@ -0,0 +1,116 @@
+/*
+Copyright (c) 2024 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#ifndef INCLUDE_RDC_LIB_IMPL_RDCPUSHEXPORTER_H_
+#define INCLUDE_RDC_LIB_IMPL_RDCPUSHEXPORTER_H_
+
+#include <condition_variable>  // NOLINT(build/c++11)
+#include <map>
+#include <memory>
+#include <mutex>  // NOLINT(build/c++11)
+#include <string>
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+#include "rdc/rdc.h"
+
+namespace amd {
+namespace rdc {
+
+enum RdcPushFormat {
+  RDC_PUSH_INFLUX = 0,  //!< InfluxDB line protocol
+  RDC_PUSH_STATSD,      //!< StatsD gauges, the GPU in the metric name
+  RDC_PUSH_DOGSTATSD    //!< DogStatsD gauges, the GPU as a tag
+};
+
+enum RdcPushTransport { RDC_PUSH_UDP = 0, RDC_PUSH_TCP, RDC_PUSH_UNIX, RDC_PUSH_UNIXGRAM };
+
+//!< Pushes the ingested INTEGER and DOUBLE samples to a local agent, such
+//!< as Telegraf or the Datadog agent. The collection threads only queue the
+//!< samples; a push thread formats and sends them every flush_ms, or as
+//!< soon as batch_size samples are queued. When the agent is down or slow
+//!< the queue is bounded by max_pending, and the samples over it are
+//!< dropped and counted in RDC_FI_RDC_EXPORT_DROPPED.
+class RdcPushExporter {
+ public:
+  //!< The target is udp://host:port, tcp://host:port, unix:///path or
+  //!< unixgram:///path. Throws RdcException if it cannot be parsed.
+  RdcPushExporter(const std::string& target, RdcPushFormat format, uint32_t flush_ms,
+                  uint32_t batch_size, uint32_t max_pending);
+  ~RdcPushExporter();
+
+  //!< Returns an exporter if RDC_EXPORT_TARGET is set, nullptr otherwise
+  static std::shared_ptr<RdcPushExporter> from_env();
+
+  //!< Queue a value for the push thread, never blocks on the agent
+  void append(uint32_t gpu_index, const rdc_field_value& value);
+
+ private:
+  struct PendingSample {
+    uint64_t ts;
+    uint32_t gpu_index;
+    rdc_field_t field_id;
+    rdc_field_type_t type;
+    int64_t l_int;
+    double dbl;
+  };
+
+  void push_loop();
+  //!< Format and send a batch, returns the samples sent
+  uint64_t push(const std::vector<PendingSample>& batch);
+  void format(const PendingSample& sample, const PendingSample* previous, std::string* out);
+  const std::string& metric_name(rdc_field_t field_id);
+  bool connect_target();
+  void disconnect();
+  bool send_payload(const char* data, size_t size);
+
+  RdcPushTransport transport_;
+  std::string host_;  //!< Or the socket path
+  std::string port_;
+  RdcPushFormat format_;
+  uint32_t flush_ms_;
+  uint32_t batch_size_;
+  uint32_t max_pending_;
+  //!< The largest datagram sent, a batch is split on line boundaries
+  size_t max_datagram_;
+
+  //!< Filled by append(), drained by the push thread
+  std::mutex pending_mutex_;
+  std::condition_variable pending_cv_;
+  std::vector<PendingSample> pending_;
+  uint64_t dropped_;
+  bool stop_;
+
+  //!< Owned by the push thread
+  int fd_;
+  std::string hostname_;
+  std::string payload_;
+  std::map<rdc_field_t, std::string> names_;
+
+  std::thread push_thread_;
+};
+
+typedef std::shared_ptr<RdcPushExporter> RdcPushExporterPtr;
+
+}  // namespace rdc
+}  // namespace amd
+
+#endif  // INCLUDE_RDC_LIB_IMPL_RDCPUSHEXPORTER_H_
@@ -0,0 +1,68 @@
+/*
+Copyright (c) 2024 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#ifndef INCLUDE_RDC_LIB_IMPL_RDCQUANTILESKETCH_H_
+#define INCLUDE_RDC_LIB_IMPL_RDCQUANTILESKETCH_H_
+
+#include <cstdint>
+
+namespace amd {
+namespace rdc {
+
+//!< A fixed size, mergeable quantile sketch following DDSketch. A positive
+//!< value v goes to the bucket i = ceil(log(v) / log(gamma)), whose bounds
+//!< are within kRelativeAccuracy of any value inside, so every quantile is
+//!< within 1% of a value which was added. Values of 0 or less are counted
+//!< apart. Only a window of kNumBuckets consecutive buckets is kept, which
+//!< spans a ratio of about 160 between the smallest and largest value; past
+//!< that the lowest buckets are collapsed, which only affects the quantiles
+//!< at the very bottom.
+//!< The sketch is trivially copyable so it can be persisted as is.
+class RdcQuantileSketch {
+ public:
+  static constexpr double kRelativeAccuracy = 0.01;
+  static const uint32_t kNumBuckets = 256;
+
+  RdcQuantileSketch();
+
+  void add(int64_t value);
+  void merge(const RdcQuantileSketch& other);
+  //!< q in [0, 1]. Returns 0 when empty.
+  double quantile(double q) const;
+  uint64_t count() const { return count_; }
+
+ private:
+  void add_to_bucket(int32_t index, uint64_t count);
+  //!< Move the window to start at new_min, folding the buckets below it
+  //!< into the lowest one
+  void move_window(int32_t new_min);
+
+  uint64_t count_;
+  uint64_t zero_count_;  //!< Values of 0 or less
+  int32_t min_index_;    //!< The index of buckets_[0]
+  int32_t max_index_;    //!< The largest index with a count
+  uint32_t buckets_[kNumBuckets];
+};
+
+}  // namespace rdc
+}  // namespace amd
+
+#endif  // INCLUDE_RDC_LIB_IMPL_RDCQUANTILESKETCH_H_
@@ -0,0 +1,88 @@
+/*
+Copyright (c) 2024 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#ifndef INCLUDE_RDC_LIB_IMPL_RDCREPLAYLIB_H_
+#define INCLUDE_RDC_LIB_IMPL_RDCREPLAYLIB_H_
+
+#include <map>
+#include <memory>
+#include <mutex>  // NOLINT(build/c++11)
+#include <string>
+#include <vector>
+
+#include "rdc_lib/RdcTelemetry.h"
+#include "rdc_lib/impl/RdcTraceFile.h"
+#include "rdc_lib/rdc_common.h"
+
+namespace amd {
+namespace rdc {
+
+//!< Telemetry module which plays back a trace written by RdcTraceWriter.
+//!< The trace clock starts at the first fetch and advances at `speed` times
+//!< wall clock, wrapping around at the end of the trace. A fetch returns the
+//!< latest recorded value of each field, and every recorded event once.
+//!< Returned values carry the current time as their timestamp.
+class RdcReplayLib : public RdcTelemetry {
+ public:
+  rdc_status_t rdc_telemetry_fields_query(uint32_t field_ids[MAX_NUM_FIELDS],
+                                          uint32_t* field_count) override;
+
+  rdc_status_t rdc_telemetry_fields_value_get(rdc_gpu_field_t* fields, uint32_t fields_count,
+                                              rdc_field_value_f callback, void* user_data) override;
+
+  //!< The fetch above at the wall clock time now, in milliseconds
+  rdc_status_t fields_value_get_at(uint64_t now, rdc_gpu_field_t* fields, uint32_t fields_count,
+                                   rdc_field_value_f callback, void* user_data);
+
+  rdc_status_t rdc_telemetry_fields_watch(rdc_gpu_field_t* fields, uint32_t fields_count) override;
+  rdc_status_t rdc_telemetry_fields_unwatch(rdc_gpu_field_t* fields,
+                                            uint32_t fields_count) override;
+
+  //!< Throws RdcException if the trace cannot be loaded or is empty
+  RdcReplayLib(const std::string& path, double speed);
+
+  //!< Returns a module if RDC_TRACE_REPLAY names a trace, nullptr otherwise.
+  //!< RDC_TRACE_REPLAY_SPEED sets the playback speed, 1.0 by default.
+  static std::shared_ptr<RdcReplayLib> from_env();
+
+ private:
+  //!< Map the wall clock to a position in the trace
+  uint64_t trace_position(uint64_t now_ms);
+
+  std::vector<RdcTraceRecord> records_;
+  //!< Indexes into records_ in time order, per field
+  std::map<RdcFieldKey, std::vector<uint32_t>> field_index_;
+  //!< Number of events of a field already returned in the current loop
+  std::map<RdcFieldKey, uint32_t> events_served_;
+  double speed_;
+  uint64_t first_ts_;
+  uint64_t duration_ms_;
+  uint64_t start_ms_;
+  uint64_t loop_;
+  std::mutex mutex_;
+};
+
+typedef std::shared_ptr<RdcReplayLib> RdcReplayLibPtr;
+
+}  // namespace rdc
+}  // namespace amd
+
+#endif  // INCLUDE_RDC_LIB_IMPL_RDCREPLAYLIB_H_
@@ -27,7 +27,10 @@ THE SOFTWARE.
 #include <memory>
 #include <vector>
 
+#include "common/rdc_perf_histogram.h"
 #include "rdc_lib/RdcMetricFetcher.h"
+#include "rdc_lib/RdcPerfTimer.h"
+#include "rdc_lib/RdcSelfStats.h"
 #include "rdc_lib/RdcTelemetry.h"
 #include "rdc_lib/impl/RdcSmiLib.h"
 
@@ -56,6 +59,18 @@ class RdcTelemetryModule : public RdcTelemetry {
       std::vector<rdc_gpu_field_value_t>& unsupport_fields);  // NOLINT
   std::list<RdcTelemetryPtr> telemetry_modules_;
   std::map<uint32_t, RdcTelemetryPtr> fields_id_module_;
+
+  //!< Times the fetch of each module for the RDC_FI_RDC_*_FETCH_LATENCY
+  //!< fields and the module_fetch.* histograms. Fetches only happen from
+  //!< the update tick, so the timers are never used concurrently.
+  struct ModuleTiming {
+    int timer;
+    RdcSelfModule self_module;
+    RdcPerfHistogram* histogram;
+    const char* name;  //!< Histogram and pipeline trace span name
+  };
+  RdcPerfTimer fetch_timer_;
+  std::map<RdcTelemetryPtr, ModuleTiming> module_timers_;
 };
 
 typedef std::shared_ptr<RdcTelemetryModule> RdcTelemetryModulePtr;
@@ -0,0 +1,95 @@
+/*
+Copyright (c) 2024 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#ifndef INCLUDE_RDC_LIB_IMPL_RDCTRACEFILE_H_
+#define INCLUDE_RDC_LIB_IMPL_RDCTRACEFILE_H_
+
+#include <cstdio>
+#include <memory>
+#include <mutex>  // NOLINT(build/c++11)
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "rdc/rdc.h"
+#include "rdc_lib/RdcNotification.h"
+#include "rdc_lib/RdcTelemetryLibInterface.h"
+
+namespace amd {
+namespace rdc {
+
+//!< Binary trace of the raw field values and events entering the watch
+//!< table. The file starts with the 8 byte magic "RDCTRC01", followed by
+//!< records of the form:
+//!<   kind       1 byte, one of RdcTraceRecordKind
+//!<   string     varint length + bytes, defines the next string table index
+//!<   field      varint zigzag(ts - previous ts), varint gpu_index,
+//!<   / event    varint field_id, varint zigzag(status), 1 byte type, value
+//!< INTEGER values are zigzag varints, DOUBLE values are 8 raw bytes and
+//!< STRING/BLOB values are varint indexes into the string table.
+enum RdcTraceRecordKind : uint8_t {
+  RDC_TRACE_STRING = 1,
+  RDC_TRACE_FIELD = 2,
+  RDC_TRACE_EVENT = 3,
+};
+
+struct RdcTraceRecord {
+  bool is_event;
+  uint32_t gpu_index;
+  rdc_field_value field;
+};
+
+//!< Appends records to a trace file. Thread safe: the bulk fetch callback
+//!< and the notification listener write from different threads.
+class RdcTraceWriter {
+ public:
+  //!< Throws RdcException if the file cannot be created
+  explicit RdcTraceWriter(const std::string& path);
+  ~RdcTraceWriter();
+
+  void write_fields(const rdc_gpu_field_value_t* values, uint32_t num_values);
+  void write_events(const rdc_evnt_notification_t* events, uint32_t num_events);
+
+  //!< Returns a writer if RDC_TRACE_RECORD names a file, nullptr otherwise
+  static std::shared_ptr<RdcTraceWriter> from_env();
+
+ private:
+  void write_record(RdcTraceRecordKind kind, uint32_t gpu_index, const rdc_field_value& field);
+  uint32_t string_index(const char* str, size_t len);
+
+  std::FILE* file_;
+  std::vector<uint8_t> buf_;
+  std::unordered_map<std::string, uint32_t> strings_;
+  uint64_t last_ts_;
+  uint64_t last_flush_ts_;
+  std::mutex mutex_;
+};
+
+typedef std::shared_ptr<RdcTraceWriter> RdcTraceWriterPtr;
+
+//!< Loads a whole trace file into memory.
+//!< Throws RdcException if the file is missing or malformed.
+std::vector<RdcTraceRecord> rdc_trace_read(const std::string& path);
+
+}  // namespace rdc
+}  // namespace amd
+
+#endif  // INCLUDE_RDC_LIB_IMPL_RDCTRACEFILE_H_
@@ -36,7 +36,14 @@ THE SOFTWARE.
 #include "rdc_lib/RdcMetricFetcher.h"
 #include "rdc_lib/RdcModuleMgr.h"
 #include "rdc_lib/RdcNotification.h"
+#include "rdc_lib/RdcPerfTimer.h"
 #include "rdc_lib/RdcWatchTable.h"
+#include "rdc_lib/impl/RdcAnomalyDetector.h"
+#include "rdc_lib/impl/RdcDerivedFields.h"
+#include "rdc_lib/impl/RdcHistoryLog.h"
+#include "rdc_lib/impl/RdcPolicyEngine.h"
+#include "rdc_lib/impl/RdcPushExporter.h"
+#include "rdc_lib/impl/RdcTraceFile.h"
 
 namespace amd {
 namespace rdc {
@@ -50,6 +57,12 @@ struct FieldSettings {
   uint64_t last_update_time;
 };
 
+//!< The previous sample of a cumulative counter, to compute its rate
+struct RdcCounterState {
+  uint64_t last_time;
+  uint64_t last_value;
+};
+
 struct JobWatchTableEntry {
   uint32_t group_id;
   std::vector<RdcFieldKey> fields;  //< store fields for faster query
@@ -74,6 +87,16 @@ class RdcWatchTableImpl : public RdcWatchTable {
   //!< is reached, which will be handled in the clean_up() function.
   rdc_status_t rdc_field_unwatch(rdc_gpu_group_t group_id, rdc_field_grp_t field_group_id) override;
 
+  //!< Cache the samples collected elsewhere as if they were fetched. The
+  //!< (GPU, field) is tracked as unwatched in fields_to_watch_, so
+  //!< clean_up() evicts its samples and drops it once it stops coming.
+  rdc_status_t rdc_field_ingest(uint32_t gpu_index, const rdc_field_value* values,
+                                uint32_t num_values, double max_keep_age,
+                                uint32_t max_keep_samples) override;
+
+  rdc_status_t rdc_field_get_update_freq(uint32_t gpu_index, rdc_field_t field_id,
+                                         uint64_t* update_freq) override;
+
   //!< When the RDC is running as RDC_OPERATION_MODE_MANUAL, the user will
   //!< call this function periodically. Instead of providing other APIs to
   //!< cleanup the cache, this function will update and cleanup the cache.
@@ -85,7 +108,9 @@ class RdcWatchTableImpl : public RdcWatchTable {
   rdc_status_t rdc_field_listen_notif(uint32_t timeout_ms) override;
 
   RdcWatchTableImpl(const RdcGroupSettingsPtr& group_settings, const RdcCacheManagerPtr& cache_mgr,
-                    const RdcModuleMgrPtr& module_mgr, const RdcNotificationPtr& notif);
+                    const RdcModuleMgrPtr& module_mgr, const RdcNotificationPtr& notif,
+                    const RdcHistoryLogPtr& history_log, const RdcPolicyEnginePtr& policy,
+                    const RdcAnomalyDetectorPtr& anomaly, const RdcDerivedFieldsPtr& derived);
 
  private:
   //!< Helper function to Update the fields_in_table when unwatch tables
@@ -97,6 +122,9 @@ class RdcWatchTableImpl : public RdcWatchTable {
   //!< Helper function for debug information in watch table and cache
   void debug_status();
 
+  //!< Tells the derived fields the GPUs and update intervals they are watched with
+  void update_derived_watches();
+
   //!< Helper function to get the fields using the group and the field group.
   rdc_status_t get_fields_from_group(rdc_gpu_group_t group_id, rdc_field_grp_t field_group_id,
                                      std::vector<RdcFieldKey>& fields);  // NOLINT
@@ -105,6 +133,19 @@ class RdcWatchTableImpl : public RdcWatchTable {
                           std::string& job_id) const;  // NOLINT
 
   rdc_status_t rdc_notif_update_cache(rdc_evnt_notification_t* events, uint32_t num_events);
+
+  //!< Caches, logs and exports the policy and anomaly events raised by the
+  //!< ingest, like the notifications
+  void cache_raised_events(const std::vector<rdc_evnt_notification_t>& events);
+
+  //!< Caches a valid value, and hands it to the history log, the exporter,
+  //!< the policy engine, the anomaly detector and the derived fields
+  void cache_value(uint32_t gpu_index, const rdc_field_value& value,
+                   std::vector<rdc_evnt_notification_t>* raised);
+
+  //!< Computes the rate of a cumulative counter since its previous sample,
+  //!< false for the other fields and the first sample of a counter
+  bool update_rate(uint32_t gpu_index, const rdc_field_value& value, rdc_field_value* rate);
   //!< The function will be pass as the callback for bulk fetch
   static rdc_status_t handle_fields(rdc_gpu_field_value_t* values, uint32_t num_values,
                                     void* user_data);
@@ -114,6 +155,29 @@ class RdcWatchTableImpl : public RdcWatchTable {
   RdcModuleMgrPtr rdc_module_mgr_;
   RdcNotificationPtr notifications_;
 
+  //!< Records the raw field values and events when RDC_TRACE_RECORD is set
+  RdcTraceWriterPtr trace_writer_;
+
+  //!< Logs the cached values to disk when RDC_HISTORY_DIR is set
+  RdcHistoryLogPtr history_log_;
+
+  //!< Pushes the cached values to an agent when RDC_EXPORT_TARGET is set
+  RdcPushExporterPtr exporter_;
+
+  //!< Evaluates the policy rules on every cached value, when set
+  RdcPolicyEnginePtr policy_;
+
+  //!< Scores the cached values of the fields with an anomaly detector, when set
+  RdcAnomalyDetectorPtr anomaly_;
+
+  //!< Runs the expressions of the derived fields reading the cached values, when set
+  RdcDerivedFieldsPtr derived_;
+
+  //!< Times the update tick and its bulk fetch for the RDC_FI_RDC_* fields
+  RdcPerfTimer perf_timer_;
+  int tick_timer_;
+  int fetch_timer_;
+
   //!< The watch table to store the watch settings.
   std::map<RdcFieldGroupKey, FieldSettings> watch_table_;
 
@@ -126,6 +190,9 @@ class RdcWatchTableImpl : public RdcWatchTable {
   //!< Those settings will only be updated when watching or unwatching.
   std::map<RdcFieldKey, FieldSettings> fields_to_watch_;
 
+  //!< The previous sample of the counters with a rate field
+  std::map<RdcFieldKey, RdcCounterState> counters_;
+
   //!< The last clean up time
   std::atomic<uint64_t> last_cleanup_time_;
   std::mutex watch_mutex_;
@@ -25,10 +25,15 @@ THE SOFTWARE.
 
 #include "amd_smi/amdsmi.h"
 #include "rdc/rdc.h"
+#include "rdc_lib/SmiBackend.h"
 
 namespace amd {
 namespace rdc {
 
+//!< The SMI backend used by the process. It is amd_smi_lib unless
+//!< RDC_SMI_BACKEND=fake selects the simulated devices.
+const SmiBackendPtr& get_smi_backend();
+
 rdc_status_t Smi2RdcError(amdsmi_status_t rsmi);
 amdsmi_status_t get_processor_handle_from_id(uint32_t gpu_id,
                                              amdsmi_processor_handle* processor_handle);
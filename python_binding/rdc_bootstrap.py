@@ -148,6 +148,43 @@ class rdc_field_t(c_int):
      RDC_FI_PROF_EVAL_FLOPS_16 = 807
      RDC_FI_PROF_EVAL_FLOPS_32 = 808
      RDC_FI_PROF_EVAL_FLOPS_64 = 809
+     RDC_FI_RDC_TICK_DURATION = 900
+     RDC_FI_RDC_TICK_OVERRUNS = 901
+     RDC_FI_RDC_FETCH_LATENCY = 902
+     RDC_FI_RDC_SMI_FETCH_LATENCY = 903
+     RDC_FI_RDC_PROF_FETCH_LATENCY = 904
+     RDC_FI_RDC_SAMPLES_PER_SEC = 905
+     RDC_FI_RDC_CACHE_SAMPLES = 906
+     RDC_FI_RDC_CACHE_BYTES = 907
+     RDC_FI_RDC_API_CALLS_PER_SEC = 908
+     RDC_FI_RDC_FETCH_QUEUE_DEPTH = 909
+     RDC_FI_RDC_EVENT_QUEUE_DEPTH = 910
+     RDC_FI_RDC_EXPORT_SAMPLES = 911
+     RDC_FI_RDC_EXPORT_DROPPED = 912
+     RDC_FI_ANOMALY_SCORE_0 = 950
+     RDC_FI_ANOMALY_SCORE_1 = 951
+     RDC_FI_ANOMALY_SCORE_2 = 952
+     RDC_FI_ANOMALY_SCORE_3 = 953
+     RDC_FI_ANOMALY_SCORE_4 = 954
+     RDC_FI_ANOMALY_SCORE_5 = 955
+     RDC_FI_ANOMALY_SCORE_6 = 956
+     RDC_FI_ANOMALY_SCORE_7 = 957
+     RDC_FI_DERIVED_0 = 960
+     RDC_FI_DERIVED_1 = 961
+     RDC_FI_DERIVED_2 = 962
+     RDC_FI_DERIVED_3 = 963
+     RDC_FI_DERIVED_4 = 964
+     RDC_FI_DERIVED_5 = 965
+     RDC_FI_DERIVED_6 = 966
+     RDC_FI_DERIVED_7 = 967
+     RDC_FI_DERIVED_8 = 968
+     RDC_FI_DERIVED_9 = 969
+     RDC_FI_DERIVED_10 = 970
+     RDC_FI_DERIVED_11 = 971
+     RDC_FI_DERIVED_12 = 972
+     RDC_FI_DERIVED_13 = 973
+     RDC_FI_DERIVED_14 = 974
+     RDC_FI_DERIVED_15 = 975
      RDC_EVNT_XGMI_0_NOP_TX = 1000
      RDC_EVNT_XGMI_0_REQ_TX = 1001
      RDC_EVNT_XGMI_0_RESP_TX = 1002
@@ -163,6 +200,37 @@ class rdc_field_t(c_int):
      RDC_EVNT_NOTIF_PRE_RESET = 2002
      RDC_EVNT_NOTIF_POST_RESET = 2003
      RDC_EVNT_NOTIF_RING_HANG = 2004
+     RDC_EVNT_NOTIF_ANOMALY = 2005
+     RDC_EVNT_NOTIF_POLICY_VIOLATION = 2006
+     RDC_EVNT_NOTIF_POLICY_CLEARED = 2007
+     RDC_FI_ECC_CORRECT_RATE = 3000
+     RDC_FI_ECC_UNCORRECT_RATE = 3001
+     RDC_FI_XGMI_0_READ_RATE = 3100
+     RDC_FI_XGMI_1_READ_RATE = 3101
+     RDC_FI_XGMI_2_READ_RATE = 3102
+     RDC_FI_XGMI_3_READ_RATE = 3103
+     RDC_FI_XGMI_4_READ_RATE = 3104
+     RDC_FI_XGMI_5_READ_RATE = 3105
+     RDC_FI_XGMI_6_READ_RATE = 3106
+     RDC_FI_XGMI_7_READ_RATE = 3107
+     RDC_FI_XGMI_0_WRITE_RATE = 3108
+     RDC_FI_XGMI_1_WRITE_RATE = 3109
+     RDC_FI_XGMI_2_WRITE_RATE = 3110
+     RDC_FI_XGMI_3_WRITE_RATE = 3111
+     RDC_FI_XGMI_4_WRITE_RATE = 3112
+     RDC_FI_XGMI_5_WRITE_RATE = 3113
+     RDC_FI_XGMI_6_WRITE_RATE = 3114
+     RDC_FI_XGMI_7_WRITE_RATE = 3115
+     RDC_FI_XGMI_TOTAL_READ_RATE = 3116
+     RDC_FI_XGMI_TOTAL_WRITE_RATE = 3117
+     RDC_EVNT_XGMI_0_NOP_TX_RATE = 3400
+     RDC_EVNT_XGMI_0_REQ_TX_RATE = 3401
+     RDC_EVNT_XGMI_0_RESP_TX_RATE = 3402
+     RDC_EVNT_XGMI_0_BEATS_TX_RATE = 3403
+     RDC_EVNT_XGMI_1_NOP_TX_RATE = 3404
+     RDC_EVNT_XGMI_1_REQ_TX_RATE = 3405
+     RDC_EVNT_XGMI_1_RESP_TX_RATE = 3406
+     RDC_EVNT_XGMI_1_BEATS_TX_RATE = 3407
 
 rdc_handle_t = c_void_p
 rdc_gpu_group_t = c_uint32
@@ -185,6 +253,10 @@ class rdc_stats_summary_t(Structure):
             ,("min_value", c_uint64)
             ,("average", c_uint64)
             ,("standard_deviation", c_double)
+            ,("p50", c_uint64)
+            ,("p90", c_uint64)
+            ,("p95", c_uint64)
+            ,("p99", c_uint64)
             ]
 
 class rdc_gpu_usage_info_t(Structure):
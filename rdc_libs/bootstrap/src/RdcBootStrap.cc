@@ -20,6 +20,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 THE SOFTWARE.
 */
 #include <dlfcn.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include <map>
@@ -34,7 +35,14 @@ THE SOFTWARE.
 
 static amd::rdc::RdcLibraryLoader rdc_lib_loader;
 
-rdc_status_t rdc_init(uint64_t) { return RDC_ST_OK; }
+rdc_status_t rdc_init(uint64_t init_flags) {
+  // librdc.so is loaded later by rdc_start_embedded() and picks its SMI
+  // backend from the environment. An explicit RDC_SMI_BACKEND still wins.
+  if (init_flags & RDC_INIT_FLAG_FAKE_SMI) {
+    setenv("RDC_SMI_BACKEND", "fake", 0);
+  }
+  return RDC_ST_OK;
+}
 
 rdc_status_t rdc_shutdown() { return rdc_lib_loader.unload(); }
 
@@ -101,6 +109,40 @@ rdc_status_t rdc_field_update_all(rdc_handle_t p_rdc_handle, uint32_t wait_for_u
   return static_cast<amd::rdc::RdcHandler*>(p_rdc_handle)->rdc_field_update_all(wait_for_update);
 }
 
+rdc_status_t rdc_perf_stats_get(rdc_handle_t p_rdc_handle, rdc_perf_stats_t* stats) {
+  if (!p_rdc_handle) {
+    return RDC_ST_INVALID_HANDLER;
+  }
+
+  return static_cast<amd::rdc::RdcHandler*>(p_rdc_handle)->rdc_perf_stats_get(stats);
+}
+
+rdc_status_t rdc_pipeline_trace_set(rdc_handle_t p_rdc_handle, uint32_t enabled) {
+  if (!p_rdc_handle) {
+    return RDC_ST_INVALID_HANDLER;
+  }
+
+  return static_cast<amd::rdc::RdcHandler*>(p_rdc_handle)->rdc_pipeline_trace_set(enabled);
+}
+
+rdc_status_t rdc_pipeline_trace_get(rdc_handle_t p_rdc_handle, uint64_t start_seq,
+                                    rdc_pipeline_events_t* events) {
+  if (!p_rdc_handle) {
+    return RDC_ST_INVALID_HANDLER;
+  }
+
+  return static_cast<amd::rdc::RdcHandler*>(p_rdc_handle)
+      ->rdc_pipeline_trace_get(start_seq, events);
+}
+
+rdc_status_t rdc_log_level_set(rdc_handle_t p_rdc_handle, rdc_log_level_t level) {
+  if (!p_rdc_handle) {
+    return RDC_ST_INVALID_HANDLER;
+  }
+
+  return static_cast<amd::rdc::RdcHandler*>(p_rdc_handle)->rdc_log_level_set(level);
+}
+
 rdc_status_t rdc_job_get_stats(rdc_handle_t p_rdc_handle, const char job_id[64],
                                rdc_job_info_t* p_job_info) {
   if (!p_rdc_handle) {
@@ -144,6 +186,26 @@ rdc_status_t rdc_job_stop_stats(rdc_handle_t p_rdc_handle, const char job_id[64]
   return static_cast<amd::rdc::RdcHandler*>(p_rdc_handle)->rdc_job_stop_stats(job_id);
 }
 
+rdc_status_t rdc_job_get_timeline(rdc_handle_t p_rdc_handle, const char job_id[64],
+                                  uint32_t gpu_index, rdc_field_t field,
+                                  rdc_job_timeline_t* timeline) {
+  if (!p_rdc_handle || !timeline) {
+    return RDC_ST_INVALID_HANDLER;
+  }
+
+  return static_cast<amd::rdc::RdcHandler*>(p_rdc_handle)
+      ->rdc_job_get_timeline(job_id, gpu_index, field, timeline);
+}
+
+rdc_status_t rdc_job_list(rdc_handle_t p_rdc_handle, const rdc_job_filter_t* filter,
+                          rdc_job_list_t* jobs) {
+  if (!p_rdc_handle || !filter || !jobs) {
+    return RDC_ST_INVALID_HANDLER;
+  }
+
+  return static_cast<amd::rdc::RdcHandler*>(p_rdc_handle)->rdc_job_list(filter, jobs);
+}
+
 rdc_status_t rdc_group_gpu_create(rdc_handle_t p_rdc_handle, rdc_group_type_t type,
                                   const char* group_name, rdc_gpu_group_t* p_rdc_group_id) {
   if (!p_rdc_handle) {
@@ -275,6 +337,133 @@ rdc_status_t rdc_field_get_value_since(rdc_handle_t p_rdc_handle, uint32_t gpu_i
       ->rdc_field_get_value_since(gpu_index, field, since_time_stamp, next_since_time_stamp, value);
 }
 
+rdc_status_t rdc_field_get_rollup(rdc_handle_t p_rdc_handle, uint32_t gpu_index,
+                                  rdc_field_t field, uint64_t start_ts, uint64_t end_ts,
+                                  rdc_field_rollups_t* rollups) {
+  if (!p_rdc_handle || !rollups) {
+    return RDC_ST_INVALID_HANDLER;
+  }
+
+  return static_cast<amd::rdc::RdcHandler*>(p_rdc_handle)
+      ->rdc_field_get_rollup(gpu_index, field, start_ts, end_ts, rollups);
+}
+
+rdc_status_t rdc_field_get_history(rdc_handle_t p_rdc_handle, uint32_t gpu_index,
+                                   rdc_field_t field, uint64_t since_ts, uint64_t until_ts,
+                                   rdc_field_history_t* history) {
+  if (!p_rdc_handle || !history) {
+    return RDC_ST_INVALID_HANDLER;
+  }
+
+  return static_cast<amd::rdc::RdcHandler*>(p_rdc_handle)
+      ->rdc_field_get_history(gpu_index, field, since_ts, until_ts, history);
+}
+
+rdc_status_t rdc_policy_add_rule(rdc_handle_t p_rdc_handle, const rdc_policy_rule_t* rule,
+                                 uint32_t* rule_id) {
+  if (!p_rdc_handle || !rule || !rule_id) {
+    return RDC_ST_INVALID_HANDLER;
+  }
+
+  return static_cast<amd::rdc::RdcHandler*>(p_rdc_handle)->rdc_policy_add_rule(rule, rule_id);
+}
+
+rdc_status_t rdc_policy_delete_rule(rdc_handle_t p_rdc_handle, uint32_t rule_id) {
+  if (!p_rdc_handle) {
+    return RDC_ST_INVALID_HANDLER;
+  }
+
+  return static_cast<amd::rdc::RdcHandler*>(p_rdc_handle)->rdc_policy_delete_rule(rule_id);
+}
+
+rdc_status_t rdc_policy_get_violations(rdc_handle_t p_rdc_handle, uint64_t since_seq,
+                                       uint32_t timeout_ms, rdc_policy_violations_t* violations) {
+  if (!p_rdc_handle || !violations) {
+    return RDC_ST_INVALID_HANDLER;
+  }
+
+  return static_cast<amd::rdc::RdcHandler*>(p_rdc_handle)
+      ->rdc_policy_get_violations(since_seq, timeout_ms, violations);
+}
+
+rdc_status_t rdc_anomaly_set_detector(rdc_handle_t p_rdc_handle, uint32_t detector_id,
+                                      const rdc_anomaly_config_t* config) {
+  if (!p_rdc_handle || !config) {
+    return RDC_ST_INVALID_HANDLER;
+  }
+
+  return static_cast<amd::rdc::RdcHandler*>(p_rdc_handle)
+      ->rdc_anomaly_set_detector(detector_id, config);
+}
+
+rdc_status_t rdc_anomaly_clear_detector(rdc_handle_t p_rdc_handle, uint32_t detector_id) {
+  if (!p_rdc_handle) {
+    return RDC_ST_INVALID_HANDLER;
+  }
+
+  return static_cast<amd::rdc::RdcHandler*>(p_rdc_handle)->rdc_anomaly_clear_detector(detector_id);
+}
+
+rdc_status_t rdc_field_derived_set(rdc_handle_t p_rdc_handle, rdc_field_t field_id,
+                                   const char* expression) {
+  if (!p_rdc_handle || !expression) {
+    return RDC_ST_INVALID_HANDLER;
+  }
+
+  return static_cast<amd::rdc::RdcHandler*>(p_rdc_handle)
+      ->rdc_field_derived_set(field_id, expression);
+}
+
+rdc_status_t rdc_field_derived_clear(rdc_handle_t p_rdc_handle, rdc_field_t field_id) {
+  if (!p_rdc_handle) {
+    return RDC_ST_INVALID_HANDLER;
+  }
+
+  return static_cast<amd::rdc::RdcHandler*>(p_rdc_handle)->rdc_field_derived_clear(field_id);
+}
+
+rdc_status_t rdc_field_ingest(rdc_handle_t p_rdc_handle, uint32_t gpu_index,
+                              const rdc_field_value* values, uint32_t num_values,
+                              double max_keep_age, uint32_t max_keep_samples) {
+  if (!p_rdc_handle || !values) {
+    return RDC_ST_INVALID_HANDLER;
+  }
+
+  return static_cast<amd::rdc::RdcHandler*>(p_rdc_handle)
+      ->rdc_field_ingest(gpu_index, values, num_values, max_keep_age, max_keep_samples);
+}
+
+rdc_status_t rdc_aggregate_get_hosts(rdc_handle_t p_rdc_handle, rdc_aggregate_hosts_t* hosts) {
+  if (!p_rdc_handle || !hosts) {
+    return RDC_ST_INVALID_HANDLER;
+  }
+
+  return static_cast<amd::rdc::RdcHandler*>(p_rdc_handle)->rdc_aggregate_get_hosts(hosts);
+}
+
+rdc_status_t rdc_aggregate_get_field(rdc_handle_t p_rdc_handle, rdc_field_t field,
+                                     rdc_aggregate_op_t op, rdc_cluster_aggregate_t* aggregate) {
+  if (!p_rdc_handle || !aggregate) {
+    return RDC_ST_INVALID_HANDLER;
+  }
+
+  return static_cast<amd::rdc::RdcHandler*>(p_rdc_handle)
+      ->rdc_aggregate_get_field(field, op, aggregate);
+}
+
+rdc_status_t rdc_field_get_group_aggregate(rdc_handle_t p_rdc_handle, rdc_gpu_group_t group_id,
+                                           rdc_field_grp_t field_group_id, uint64_t window_ms,
+                                           const rdc_aggregate_spec_t* specs, uint32_t num_specs,
+                                           rdc_group_aggregate_t* aggregate) {
+  if (!p_rdc_handle || !specs || !aggregate) {
+    return RDC_ST_INVALID_HANDLER;
+  }
+
+  return static_cast<amd::rdc::RdcHandler*>(p_rdc_handle)
+      ->rdc_field_get_group_aggregate(group_id, field_group_id, window_ms, specs, num_specs,
+                                      aggregate);
+}
+
 rdc_status_t rdc_field_unwatch(rdc_handle_t p_rdc_handle, rdc_gpu_group_t group_id,
                                rdc_field_grp_t field_group_id) {
   if (!p_rdc_handle) {
@@ -334,6 +523,17 @@ rdc_status_t get_mixed_component_version(rdc_handle_t p_rdc_handle, mixed_compon
       ->get_mixed_component_version(component, p_mixed_compv);
 }
 
+rdc_status_t get_cache_generation(rdc_handle_t p_rdc_handle, uint32_t gpu_index,
+                                  rdc_field_t field_id, uint64_t* cache_generation,
+                                  uint64_t* group_generation) {
+  if (!p_rdc_handle || !cache_generation || !group_generation) {
+    return RDC_ST_INVALID_HANDLER;
+  }
+
+  return static_cast<amd::rdc::RdcHandler*>(p_rdc_handle)
+      ->get_cache_generation(gpu_index, field_id, cache_generation, group_generation);
+}
+
 const char* rdc_status_string(rdc_status_t result) {
   switch (result) {
     case RDC_ST_OK:
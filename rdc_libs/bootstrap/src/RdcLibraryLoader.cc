@@ -53,6 +53,8 @@ rdc_status_t RdcLibraryLoader::load(const char* filename) {
 rdc_status_t RdcLibraryLoader::unload() {
   std::lock_guard<std::mutex> guard(library_mutex_);
   if (libHandler_) {
+    // Queued messages point at file names inside the library
+    RdcLogger::getLogger().flush();
     dlclose(libHandler_);
     libHandler_ = nullptr;
   }
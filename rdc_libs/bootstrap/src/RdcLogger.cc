@@ -21,20 +21,46 @@ THE SOFTWARE.
 */
 #include "rdc_lib/RdcLogger.h"
 
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <syslog.h>
 
-#include <chrono>  // NOLINT
-#include <iomanip>
-#include <iostream>
-#include <sstream>
+#include <algorithm>
+#include <functional>
+#include <thread>  // NOLINT
 
+#include "rdc/rdc.h"
 #include "rdc_lib/rdc_common.h"
 
 namespace amd {
 namespace rdc {
 
-RdcLogger::RdcLogger(std::ostream& os) : os_(os) {
+static_assert(RDC_LOG_LEVEL_ERROR == RDC_ERROR && RDC_LOG_LEVEL_INFO == RDC_INFO &&
+                  RDC_LOG_LEVEL_DEBUG == RDC_DEBUG,
+              "rdc_log_level_t must match the RDC_LOG levels");
+
+static const uint32_t kDefaultRateLimit = 10;
+static const uint64_t kRateWindowMs = 1000;
+static const std::chrono::milliseconds kFlushInterval(50);
+
+static uint64_t now_ms() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+RdcLogger& RdcLogger::getLogger() {
+  // Never destroyed, so threads may still log while the process exits
+  static RdcLogger* logger = new RdcLogger();
+  return *logger;
+}
+
+static void flush_at_exit() { RdcLogger::getLogger().flush(); }
+
+RdcLogger::RdcLogger() : log_level_(RDC_ERROR), rate_limit_(kDefaultRateLimit) {
   char* verbose = getenv("RDC_LOG");
   if (verbose == nullptr) {
     log_level_ = RDC_ERROR;
@@ -45,33 +71,289 @@ RdcLogger::RdcLogger(std::ostream& os) : os_(os) {
   } else {
     log_level_ = RDC_ERROR;
   }
+
+  char* rate_limit = getenv("RDC_LOG_RATE_LIMIT");
+  if (rate_limit != nullptr) {
+    rate_limit_ = strtoul(rate_limit, nullptr, 10);
+  }
+
+  output_ = OUTPUT_STDOUT;
+  char* output = getenv("RDC_LOG_OUTPUT");
+  if (output != nullptr && strcmp(output, "syslog") == 0) {
+    openlog("rdc", LOG_PID, LOG_DAEMON);
+    output_ = OUTPUT_SYSLOG;
+  } else if (output != nullptr && strcmp(output, "stdout") != 0) {
+    file_.open(output, std::ios::app);
+    if (file_) {
+      output_ = OUTPUT_FILE;
+    } else {
+      std::cerr << "Fail to open the log file " << output << ", logging to stdout" << std::endl;
+    }
+  }
+
+  pthread_atfork(prepare_fork, parent_after_fork, child_after_fork);
+  atexit(flush_at_exit);
+}
+
+//!< Marks the ring of an exiting thread, which the logger thread drains
+//!< and then drops
+struct RdcLogRingHolder {
+  std::shared_ptr<RdcLogger::Ring> ring;
+  ~RdcLogRingHolder() {
+    if (ring) {
+      ring->orphaned.store(true, std::memory_order_release);
+    }
+  }
+};
+
+RdcLogger::Ring* RdcLogger::local_ring() {
+  thread_local RdcLogRingHolder holder;
+  if (!holder.ring) {
+    holder.ring = std::make_shared<Ring>();
+    std::lock_guard<std::mutex> guard(rings_mutex_);
+    rings_.push_back(holder.ring);
+  }
+  return holder.ring.get();
 }
 
-std::string RdcLogger::get_log_header(uint32_t severity, const char* file, int line) {
-  std::stringstream strstream;
-  auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-                std::chrono::system_clock::now().time_since_epoch())
-                .count();
-  strstream << std::fixed << std::setprecision(3) << (ms / 1000.0) << " ";
-  if (severity == RDC_DEBUG) {
-    strstream << "DEBUG ";
-  } else if (severity == RDC_INFO) {
-    strstream << "INFO ";
+bool RdcLogger::rate_limited(RdcLogSite* site, const std::string& text, uint64_t now,
+                             uint32_t* suppressed) {
+  *suppressed = 0;
+  if (rate_limit_ == 0 || site == nullptr) {
+    return false;
+  }
+
+  // 0 marks a call site which has not logged yet
+  uint64_t hash = std::hash<std::string>()(text) | 1;
+  uint64_t window_start = site->window_start_ms.load(std::memory_order_relaxed);
+  if (hash != site->last_hash.load(std::memory_order_relaxed) ||
+      now - window_start >= kRateWindowMs) {
+    site->last_hash.store(hash, std::memory_order_relaxed);
+    site->window_start_ms.store(now, std::memory_order_relaxed);
+    site->repeats.store(1, std::memory_order_relaxed);
+    *suppressed = site->suppressed.exchange(0, std::memory_order_relaxed);
+    return false;
+  }
+  if (site->repeats.fetch_add(1, std::memory_order_relaxed) < rate_limit_) {
+    return false;
+  }
+  site->suppressed.fetch_add(1, std::memory_order_relaxed);
+  return true;
+}
+
+void RdcLogger::log(uint32_t severity, const char* file, int line, RdcLogSite* site,
+                    const std::string& text) {
+  uint64_t now = now_ms();
+  uint32_t suppressed = 0;
+  if (rate_limited(site, text, now, &suppressed)) {
+    return;
+  }
+  if (!worker_running_.load(std::memory_order_relaxed)) {
+    start_worker();
+  }
+
+  Ring* ring = local_ring();
+  uint64_t head = ring->head.load(std::memory_order_relaxed);
+  uint64_t tail = ring->tail.load(std::memory_order_acquire);
+  if (head - tail >= Ring::kSlots) {
+    // Errors are never dropped; their thread waits for its ring to drain
+    if (severity != RDC_ERROR) {
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    flush();
+    tail = ring->tail.load(std::memory_order_acquire);
+  }
+
+  Record& record = ring->slots[head % Ring::kSlots];
+  record.ts_ms = now;
+  record.severity = severity;
+  record.file = file;
+  record.line = line;
+  if (suppressed > 0) {
+    record.text.assign("(previous message repeated ");
+    record.text.append(std::to_string(suppressed));
+    record.text.append(" more times) ");
+    record.text.append(text);
   } else {
-    strstream << "ERROR ";
+    record.text.assign(text);
+  }
+  ring->head.store(head + 1, std::memory_order_release);
+
+  // Errors go out right away, and a filling ring is drained early
+  if (severity == RDC_ERROR || head + 1 - tail >= Ring::kSlots / 2) {
+    worker_cv_.notify_one();
+  }
+}
+
+void RdcLogger::start_worker() {
+  if (worker_running_.exchange(true)) {
+    return;
+  }
+  std::thread([this]() { worker_loop(); }).detach();
+}
+
+void RdcLogger::worker_loop() {
+  while (true) {
+    do {
+      std::unique_lock<std::mutex> lock(worker_mutex_);
+      worker_cv_.wait_for(lock, kFlushInterval);
+    } while (0);
+    flush();
+  }
+}
+
+void RdcLogger::flush() {
+  std::lock_guard<std::mutex> guard(drain_mutex_);
+  drain_locked();
+}
+
+void RdcLogger::append_header(const Record& record, std::string* out) const {
+  const char* severity = "ERROR ";
+  if (record.severity == RDC_DEBUG) {
+    severity = "DEBUG ";
+  } else if (record.severity == RDC_INFO) {
+    severity = "INFO ";
   }
 
   //  extract out the file path as it may be very long.
+  const char* file = record.file ? strrchr(record.file, '/') : nullptr;
+  file = file ? file + 1 : record.file;
+
+  char header[256];
+  int len;
   if (file != nullptr) {
-    std::string file_str(file);
-    auto found = file_str.find_last_of("/");
-    if (found != std::string::npos) {
-      file_str = file_str.substr(found + 1);
+    len = snprintf(header, sizeof(header), "%" PRIu64 ".%03" PRIu64 " %s%s(%d): ",
+                   record.ts_ms / 1000, record.ts_ms % 1000, severity, file, record.line);
+  } else {
+    len = snprintf(header, sizeof(header), "%" PRIu64 ".%03" PRIu64 " %s", record.ts_ms / 1000,
+                   record.ts_ms % 1000, severity);
+  }
+  out->append(header, std::min(len, static_cast<int>(sizeof(header)) - 1));
+}
+
+void RdcLogger::drain_locked() {
+  std::vector<std::shared_ptr<Ring>> rings;
+  do {
+    std::lock_guard<std::mutex> guard(rings_mutex_);
+    rings = rings_;
+  } while (0);
+
+  std::string batch;
+  for (auto& ring : rings) {
+    // Read the flag first, so the last messages of an exited thread are seen
+    bool orphaned = ring->orphaned.load(std::memory_order_acquire);
+    uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+    uint64_t head = ring->head.load(std::memory_order_acquire);
+    for (; tail < head; tail++) {
+      const Record& record = ring->slots[tail % Ring::kSlots];
+      if (output_ == OUTPUT_SYSLOG) {
+        int priority = record.severity == RDC_ERROR  ? LOG_ERR
+                       : record.severity == RDC_INFO ? LOG_INFO
+                                                     : LOG_DEBUG;
+        const char* file = record.file ? strrchr(record.file, '/') : nullptr;
+        file = file ? file + 1 : (record.file ? record.file : "");
+        syslog(priority, "%s(%d): %s", file, record.line, record.text.c_str());
+      } else {
+        append_header(record, &batch);
+        batch.append(record.text);
+        batch.push_back('\n');
+      }
     }
-    strstream << file_str << "(" << line << "): ";
+    ring->tail.store(tail, std::memory_order_release);
+
+    if (orphaned) {
+      std::lock_guard<std::mutex> guard(rings_mutex_);
+      rings_.erase(std::remove(rings_.begin(), rings_.end(), ring), rings_.end());
+    }
+  }
+
+  uint64_t dropped = dropped_.exchange(0, std::memory_order_relaxed);
+  if (dropped > 0) {
+    Record record = {now_ms(), RDC_ERROR, nullptr, 0, std::string()};
+    if (output_ == OUTPUT_SYSLOG) {
+      syslog(LOG_ERR, "Dropped %" PRIu64 " log messages", dropped);
+    } else {
+      append_header(record, &batch);
+      batch.append("Dropped " + std::to_string(dropped) + " log messages\n");
+    }
+  }
+
+  if (!batch.empty()) {
+    write_batch(batch);
   }
+}
+
+void RdcLogger::write_batch(const std::string& batch) {
+  if (output_ == OUTPUT_FILE) {
+    file_.write(batch.data(), batch.size());
+    file_.flush();
+  } else {
+    std::cout.write(batch.data(), batch.size());
+    std::cout.flush();
+  }
+}
 
-  return strstream.str();
+// Hold every logger lock across fork(), so the child never inherits one
+// which a thread that does not exist there had taken.
+void RdcLogger::prepare_fork() {
+  RdcLogger& logger = getLogger();
+  logger.drain_mutex_.lock();
+  logger.drain_locked();
+  logger.rings_mutex_.lock();
+  logger.worker_mutex_.lock();
+}
+
+void RdcLogger::parent_after_fork() {
+  RdcLogger& logger = getLogger();
+  logger.worker_mutex_.unlock();
+  logger.rings_mutex_.unlock();
+  logger.drain_mutex_.unlock();
+}
+
+void RdcLogger::child_after_fork() {
+  parent_after_fork();
+  // The logger thread did not survive the fork, the next message starts one
+  getLogger().worker_running_.store(false);
+}
+
+namespace {
+struct ThreadLogStream {
+  std::ostringstream stream;
+  bool in_use = false;
+};
+}  // namespace
+
+static ThreadLogStream& thread_log_stream() {
+  thread_local ThreadLogStream stream;
+  return stream;
+}
+
+RdcLogMessage::RdcLogMessage(RdcLogger& logger, uint32_t severity, const char* file, int line,
+                             RdcLogSite* site)
+    : logger_(logger), severity_(severity), file_(file), line_(line), site_(site) {
+  ThreadLogStream& local = thread_log_stream();
+  if (!local.in_use) {
+    local.in_use = true;
+    local.stream.str(std::string());
+    local.stream.clear();
+    // Drop the manipulators the previous message left behind
+    local.stream.flags(std::ios_base::dec | std::ios_base::skipws);
+    local.stream.precision(6);
+    local.stream.width(0);
+    local.stream.fill(' ');
+    stream_ = &local.stream;
+  } else {
+    nested_stream_.reset(new std::ostringstream());
+    stream_ = nested_stream_.get();
+  }
+}
+
+RdcLogMessage::~RdcLogMessage() {
+  logger_.log(severity_, file_, line_, site_, stream_->str());
+  if (!nested_stream_) {
+    thread_log_stream().in_use = false;
+  }
 }
 
 }  // namespace rdc
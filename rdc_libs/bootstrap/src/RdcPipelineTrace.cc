@@ -0,0 +1,149 @@
+/*
+Copyright (c) 2024 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "rdc_lib/RdcPipelineTrace.h"
+
+#include <stdlib.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <fstream>
+#include <memory>
+
+#include "rdc_lib/RdcLogger.h"
+#include "rdc_lib/rdc_common.h"
+
+namespace amd {
+namespace rdc {
+
+static const uint32_t kDefaultPipelineTraceEvents = 65536;
+
+std::atomic<bool> RdcPipelineTrace::enabled_(false);
+
+RdcPipelineTrace& RdcPipelineTrace::get_instance() {
+  static RdcPipelineTrace instance;
+  return instance;
+}
+
+static uint32_t current_tid() {
+  thread_local uint32_t tid = static_cast<uint32_t>(syscall(SYS_gettid));
+  return tid;
+}
+
+void RdcPipelineTrace::set_enabled(bool enabled) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  if (enabled) {
+    if (ring_.empty()) {
+      uint32_t capacity = kDefaultPipelineTraceEvents;
+      const char* env = getenv("RDC_PIPELINE_TRACE_EVENTS");
+      if (env != nullptr && atoi(env) > 0) {
+        capacity = atoi(env);
+      }
+      ring_.resize(capacity);
+    }
+    first_seq_ = next_seq_;
+  }
+  enabled_.store(enabled, std::memory_order_relaxed);
+  RDC_LOG(RDC_INFO, "Pipeline trace " << (enabled ? "started" : "stopped"));
+}
+
+void RdcPipelineTrace::record(const char* name, uint64_t start_us, uint64_t end_us,
+                              uint32_t gpu_index, uint32_t field_id) {
+  uint32_t tid = current_tid();
+  std::lock_guard<std::mutex> guard(mutex_);
+  if (ring_.empty()) {
+    return;
+  }
+  rdc_pipeline_event_t& event = ring_[next_seq_ % ring_.size()];
+  strncpy_with_null(event.name, name, RDC_MAX_PERF_STAT_NAME);
+  event.seq = next_seq_;
+  event.ts_us = start_us;
+  event.dur_us = end_us - start_us;
+  event.tid = tid;
+  event.gpu_index = gpu_index;
+  event.field_id = static_cast<rdc_field_t>(field_id);
+  next_seq_++;
+  if (next_seq_ - first_seq_ > ring_.size()) {
+    first_seq_ = next_seq_ - ring_.size();
+  }
+}
+
+void RdcPipelineTrace::get_events(uint64_t start_seq, rdc_pipeline_events_t* events) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  uint64_t seq = std::max(start_seq, first_seq_);
+  events->num_events = 0;
+  for (; seq < next_seq_ && events->num_events < RDC_MAX_NUM_PIPELINE_EVENTS; seq++) {
+    events->events[events->num_events++] = ring_[seq % ring_.size()];
+  }
+  events->next_seq = seq;
+}
+
+void RdcPipelineTrace::write_chrome_json(const std::vector<rdc_pipeline_event_t>& events,
+                                         std::ostream& os) {
+  // Complete ("X") events carry both the begin and end of a span. Spans of
+  // one thread nest by time, so a slow tick shows the slow field under it.
+  os << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  os << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":0,\"args\":{\"name\":\"rdc\"}}";
+  for (const rdc_pipeline_event_t& event : events) {
+    os << ",\n{\"name\":\"" << event.name << "\",\"cat\":\"rdc\",\"ph\":\"X\",\"pid\":0"
+       << ",\"tid\":" << event.tid << ",\"ts\":" << event.ts_us << ",\"dur\":" << event.dur_us;
+    if (event.gpu_index != static_cast<uint32_t>(GPU_ID_INVALID) ||
+        event.field_id != RDC_FI_INVALID) {
+      os << ",\"args\":{";
+      if (event.gpu_index != static_cast<uint32_t>(GPU_ID_INVALID)) {
+        os << "\"gpu\":" << event.gpu_index;
+        if (event.field_id != RDC_FI_INVALID) {
+          os << ",";
+        }
+      }
+      if (event.field_id != RDC_FI_INVALID) {
+        os << "\"field\":\"" << field_id_string(event.field_id) << "\"";
+      }
+      os << "}";
+    }
+    os << "}";
+  }
+  os << "]}\n";
+}
+
+rdc_status_t RdcPipelineTrace::dump_chrome_json(const char* path) {
+  std::vector<rdc_pipeline_event_t> events;
+  std::unique_ptr<rdc_pipeline_events_t> batch(new rdc_pipeline_events_t);
+  uint64_t seq = 0;
+  do {
+    get_events(seq, batch.get());
+    events.insert(events.end(), batch->events, batch->events + batch->num_events);
+    seq = batch->next_seq;
+  } while (batch->num_events > 0);
+
+  std::ofstream file(path);
+  if (!file) {
+    RDC_LOG(RDC_ERROR, "Fail to open " << path << " for the pipeline trace");
+    return RDC_ST_FILE_ERROR;
+  }
+  write_chrome_json(events, file);
+  RDC_LOG(RDC_INFO, "Wrote " << events.size() << " pipeline trace events to " << path);
+  return RDC_ST_OK;
+}
+
+}  // namespace rdc
+}  // namespace amd
@@ -0,0 +1,203 @@
+/*
+Copyright (c) 2024 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "rdc_lib/impl/AmdSmiBackendImpl.h"
+
+#include "amd_smi/amdsmi.h"
+
+namespace amd {
+namespace rdc {
+
+amdsmi_status_t AmdSmiBackendImpl::init(uint64_t init_flags) { return amdsmi_init(init_flags); }
+
+amdsmi_status_t AmdSmiBackendImpl::shut_down() { return amdsmi_shut_down(); }
+
+amdsmi_status_t AmdSmiBackendImpl::get_lib_version(amdsmi_version_t* version) {
+  return amdsmi_get_lib_version(version);
+}
+
+amdsmi_status_t AmdSmiBackendImpl::get_socket_handles(uint32_t* socket_count,
+                                                      amdsmi_socket_handle* socket_handles) {
+  return amdsmi_get_socket_handles(socket_count, socket_handles);
+}
+
+amdsmi_status_t AmdSmiBackendImpl::get_processor_handles(
+    amdsmi_socket_handle socket_handle, uint32_t* processor_count,
+    amdsmi_processor_handle* processor_handles) {
+  return amdsmi_get_processor_handles(socket_handle, processor_count, processor_handles);
+}
+
+amdsmi_status_t AmdSmiBackendImpl::get_processor_type(amdsmi_processor_handle processor_handle,
+                                                      processor_type_t* processor_type) {
+  return amdsmi_get_processor_type(processor_handle, processor_type);
+}
+
+amdsmi_status_t AmdSmiBackendImpl::get_gpu_bdf_id(amdsmi_processor_handle processor_handle,
+                                                  uint64_t* bdfid) {
+  return amdsmi_get_gpu_bdf_id(processor_handle, bdfid);
+}
+
+amdsmi_status_t AmdSmiBackendImpl::get_gpu_asic_info(amdsmi_processor_handle processor_handle,
+                                                     amdsmi_asic_info_t* info) {
+  return amdsmi_get_gpu_asic_info(processor_handle, info);
+}
+
+amdsmi_status_t AmdSmiBackendImpl::get_gpu_metrics_info(amdsmi_processor_handle processor_handle,
+                                                        amdsmi_gpu_metrics_t* metrics) {
+  return amdsmi_get_gpu_metrics_info(processor_handle, metrics);
+}
+
+amdsmi_status_t AmdSmiBackendImpl::get_gpu_memory_usage(amdsmi_processor_handle processor_handle,
+                                                        amdsmi_memory_type_t mem_type,
+                                                        uint64_t* used) {
+  return amdsmi_get_gpu_memory_usage(processor_handle, mem_type, used);
+}
+
+amdsmi_status_t AmdSmiBackendImpl::get_gpu_memory_total(amdsmi_processor_handle processor_handle,
+                                                        amdsmi_memory_type_t mem_type,
+                                                        uint64_t* total) {
+  return amdsmi_get_gpu_memory_total(processor_handle, mem_type, total);
+}
+
+amdsmi_status_t AmdSmiBackendImpl::get_gpu_activity(amdsmi_processor_handle processor_handle,
+                                                    amdsmi_engine_usage_t* info) {
+  return amdsmi_get_gpu_activity(processor_handle, info);
+}
+
+amdsmi_status_t AmdSmiBackendImpl::get_power_info(amdsmi_processor_handle processor_handle,
+                                                  amdsmi_power_info_t* info) {
+  return amdsmi_get_power_info(processor_handle, info);
+}
+
+amdsmi_status_t AmdSmiBackendImpl::get_clk_freq(amdsmi_processor_handle processor_handle,
+                                                amdsmi_clk_type_t clk_type,
+                                                amdsmi_frequencies_t* f) {
+  return amdsmi_get_clk_freq(processor_handle, clk_type, f);
+}
+
+amdsmi_status_t AmdSmiBackendImpl::get_temp_metric(amdsmi_processor_handle processor_handle,
+                                                   amdsmi_temperature_type_t sensor_type,
+                                                   amdsmi_temperature_metric_t metric,
+                                                   int64_t* temperature) {
+  return amdsmi_get_temp_metric(processor_handle, sensor_type, metric, temperature);
+}
+
+amdsmi_status_t AmdSmiBackendImpl::get_gpu_volt_metric(amdsmi_processor_handle processor_handle,
+                                                       amdsmi_voltage_type_t sensor_type,
+                                                       amdsmi_voltage_metric_t metric,
+                                                       int64_t* voltage) {
+  return amdsmi_get_gpu_volt_metric(processor_handle, sensor_type, metric, voltage);
+}
+
+amdsmi_status_t AmdSmiBackendImpl::get_utilization_count(
+    amdsmi_processor_handle processor_handle, amdsmi_utilization_counter_t utilization_counters[],
+    uint32_t count, uint64_t* timestamp) {
+  return amdsmi_get_utilization_count(processor_handle, utilization_counters, count, timestamp);
+}
+
+amdsmi_status_t AmdSmiBackendImpl::get_gpu_pci_throughput(amdsmi_processor_handle processor_handle,
+                                                          uint64_t* sent, uint64_t* received,
+                                                          uint64_t* max_pkt_sz) {
+  return amdsmi_get_gpu_pci_throughput(processor_handle, sent, received, max_pkt_sz);
+}
+
+amdsmi_status_t AmdSmiBackendImpl::get_gpu_ecc_status(amdsmi_processor_handle processor_handle,
+                                                      amdsmi_gpu_block_t block,
+                                                      amdsmi_ras_err_state_t* state) {
+  return amdsmi_get_gpu_ecc_status(processor_handle, block, state);
+}
+
+amdsmi_status_t AmdSmiBackendImpl::get_gpu_ecc_count(amdsmi_processor_handle processor_handle,
+                                                     amdsmi_gpu_block_t block,
+                                                     amdsmi_error_count_t* ec) {
+  return amdsmi_get_gpu_ecc_count(processor_handle, block, ec);
+}
+
+amdsmi_status_t AmdSmiBackendImpl::topo_get_link_weight(
+    amdsmi_processor_handle processor_handle_src, amdsmi_processor_handle processor_handle_dst,
+    uint64_t* weight) {
+  return amdsmi_topo_get_link_weight(processor_handle_src, processor_handle_dst, weight);
+}
+
+amdsmi_status_t AmdSmiBackendImpl::get_gpu_compute_process_info(amdsmi_process_info_t* procs,
+                                                                uint32_t* num_items) {
+  return amdsmi_get_gpu_compute_process_info(procs, num_items);
+}
+
+amdsmi_status_t AmdSmiBackendImpl::get_gpu_compute_process_gpus(uint32_t pid,
+                                                                uint32_t* dv_indices,
+                                                                uint32_t* num_devices) {
+  return amdsmi_get_gpu_compute_process_gpus(pid, dv_indices, num_devices);
+}
+
+amdsmi_status_t AmdSmiBackendImpl::gpu_counter_group_supported(
+    amdsmi_processor_handle processor_handle, amdsmi_event_group_t group) {
+  return amdsmi_gpu_counter_group_supported(processor_handle, group);
+}
+
+amdsmi_status_t AmdSmiBackendImpl::get_gpu_available_counters(
+    amdsmi_processor_handle processor_handle, amdsmi_event_group_t grp, uint32_t* available) {
+  return amdsmi_get_gpu_available_counters(processor_handle, grp, available);
+}
+
+amdsmi_status_t AmdSmiBackendImpl::gpu_create_counter(amdsmi_processor_handle processor_handle,
+                                                      amdsmi_event_type_t type,
+                                                      amdsmi_event_handle_t* evnt_handle) {
+  return amdsmi_gpu_create_counter(processor_handle, type, evnt_handle);
+}
+
+amdsmi_status_t AmdSmiBackendImpl::gpu_control_counter(amdsmi_event_handle_t evt_handle,
+                                                       amdsmi_counter_command_t cmd,
+                                                       void* cmd_args) {
+  return amdsmi_gpu_control_counter(evt_handle, cmd, cmd_args);
+}
+
+amdsmi_status_t AmdSmiBackendImpl::gpu_read_counter(amdsmi_event_handle_t evt_handle,
+                                                    amdsmi_counter_value_t* value) {
+  return amdsmi_gpu_read_counter(evt_handle, value);
+}
+
+amdsmi_status_t AmdSmiBackendImpl::gpu_destroy_counter(amdsmi_event_handle_t evnt_handle) {
+  return amdsmi_gpu_destroy_counter(evnt_handle);
+}
+
+amdsmi_status_t AmdSmiBackendImpl::init_gpu_event_notification(
+    amdsmi_processor_handle processor_handle) {
+  return amdsmi_init_gpu_event_notification(processor_handle);
+}
+
+amdsmi_status_t AmdSmiBackendImpl::set_gpu_event_notification_mask(
+    amdsmi_processor_handle processor_handle, uint64_t mask) {
+  return amdsmi_set_gpu_event_notification_mask(processor_handle, mask);
+}
+
+amdsmi_status_t AmdSmiBackendImpl::get_gpu_event_notification(
+    int timeout_ms, uint32_t* num_elem, amdsmi_evt_notification_data_t* data) {
+  return amdsmi_get_gpu_event_notification(timeout_ms, num_elem, data);
+}
+
+amdsmi_status_t AmdSmiBackendImpl::stop_gpu_event_notification(
+    amdsmi_processor_handle processor_handle) {
+  return amdsmi_stop_gpu_event_notification(processor_handle);
+}
+
+}  // namespace rdc
+}  // namespace amd
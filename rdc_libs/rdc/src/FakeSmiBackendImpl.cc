@@ -0,0 +1,620 @@
+/*
+Copyright (c) 2024 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "rdc_lib/impl/FakeSmiBackendImpl.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>  // NOLINT(build/c++11)
+#include <cmath>
+#include <cstdint>
+#include <sstream>
+#include <thread>  // NOLINT(build/c++11)
+
+#include "rdc_lib/RdcLogger.h"
+
+namespace amd {
+namespace rdc {
+
+namespace {
+const uint64_t kFakeMemoryTotal = 64ULL * 1024 * 1024 * 1024;  // 64 GiB of VRAM
+const double kFakeWavePeriodSec = 60.0;                         // activity waveform period
+const uint32_t kFakeCountersAvailable = 4;
+
+uint32_t env_to_uint(const char* name, uint32_t default_value) {
+  const char* env = getenv(name);
+  if (env == nullptr || *env == '\0') {
+    return default_value;
+  }
+  char* end = nullptr;
+  unsigned long v = strtoul(env, &end, 10);  // NOLINT(runtime/int)
+  if (end == env || *end != '\0' || *env == '-' || v > UINT32_MAX) {
+    RDC_LOG(RDC_ERROR, "Ignore invalid " << name << "=" << env);
+    return default_value;
+  }
+  return static_cast<uint32_t>(v);
+}
+}  // namespace
+
+FakeSmiConfig FakeSmiConfig::from_env() {
+  FakeSmiConfig config;
+  const uint32_t default_gpus = config.num_gpus;
+  config.num_gpus = env_to_uint("RDC_FAKE_SMI_GPUS", default_gpus);
+  if (config.num_gpus == 0) {
+    RDC_LOG(RDC_ERROR, "RDC_FAKE_SMI_GPUS must be at least 1, use " << default_gpus);
+    config.num_gpus = default_gpus;
+  } else if (config.num_gpus > RDC_MAX_NUM_DEVICES) {
+    RDC_LOG(RDC_ERROR, "RDC_FAKE_SMI_GPUS must be at most " << RDC_MAX_NUM_DEVICES << ", use "
+                                                            << RDC_MAX_NUM_DEVICES);
+    config.num_gpus = RDC_MAX_NUM_DEVICES;
+  }
+  config.call_latency_us = env_to_uint("RDC_FAKE_SMI_LATENCY_US", config.call_latency_us);
+  config.event_interval_ms =
+      env_to_uint("RDC_FAKE_SMI_EVENT_INTERVAL_MS", config.event_interval_ms);
+
+  const char* unsupported = getenv("RDC_FAKE_SMI_UNSUPPORTED");
+  if (unsupported != nullptr) {
+    std::stringstream ss(unsupported);
+    std::string call;
+    while (std::getline(ss, call, ',')) {
+      if (!call.empty()) {
+        config.unsupported_calls.insert(call);
+      }
+    }
+  }
+  return config;
+}
+
+FakeSmiBackendImpl::FakeSmiBackendImpl(const FakeSmiConfig& config)
+    : config_(config),
+      start_ns_(0),
+      initialized_(false),
+      next_counter_(1),
+      notif_masks_{},
+      last_event_ns_(0),
+      next_event_gpu_(0) {
+  start_ns_ = elapsed_ns();
+  RDC_LOG(RDC_INFO, "Use the fake SMI backend with " << config_.num_gpus << " GPUs, "
+                                                    << config_.call_latency_us
+                                                    << "us call latency");
+}
+
+FakeSmiBackendImpl::~FakeSmiBackendImpl() { shut_down(); }
+
+uint64_t FakeSmiBackendImpl::elapsed_ns() const {
+  auto now = std::chrono::steady_clock::now().time_since_epoch();
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(now).count() - start_ns_;
+}
+
+amdsmi_status_t FakeSmiBackendImpl::enter(const char* call) const {
+  if (config_.call_latency_us > 0) {
+    std::this_thread::sleep_for(std::chrono::microseconds(config_.call_latency_us));
+  }
+  if (!config_.unsupported_calls.empty() &&
+      config_.unsupported_calls.find(call) != config_.unsupported_calls.end()) {
+    return AMDSMI_STATUS_NOT_SUPPORTED;
+  }
+  return AMDSMI_STATUS_SUCCESS;
+}
+
+amdsmi_processor_handle FakeSmiBackendImpl::handle_of(uint32_t gpu_index) const {
+  // Never hand out a null handle
+  return reinterpret_cast<amdsmi_processor_handle>(static_cast<uintptr_t>(gpu_index) + 1);
+}
+
+bool FakeSmiBackendImpl::gpu_of(amdsmi_processor_handle handle, uint32_t* gpu_index) const {
+  uintptr_t v = reinterpret_cast<uintptr_t>(handle);
+  if (v == 0 || v > config_.num_gpus) {
+    return false;
+  }
+  *gpu_index = static_cast<uint32_t>(v - 1);
+  return true;
+}
+
+uint32_t FakeSmiBackendImpl::activity(uint32_t gpu_index) const {
+  double t = static_cast<double>(elapsed_ns()) / 1e9;
+  double phase = 2 * M_PI * t / kFakeWavePeriodSec + gpu_index * 0.7;
+  return static_cast<uint32_t>(50 + 45 * std::sin(phase));
+}
+
+#define FAKE_SMI_ENTER(call)                \
+  do {                                      \
+    amdsmi_status_t st__ = enter(call);     \
+    if (st__ != AMDSMI_STATUS_SUCCESS) {    \
+      return st__;                          \
+    }                                       \
+  } while (0)
+
+#define FAKE_SMI_GPU(handle, gpu)           \
+  uint32_t gpu = 0;                         \
+  if (!gpu_of(handle, &gpu)) {              \
+    return AMDSMI_STATUS_INVAL;             \
+  }
+
+amdsmi_status_t FakeSmiBackendImpl::init(uint64_t) {
+  initialized_ = true;
+  return AMDSMI_STATUS_SUCCESS;
+}
+
+amdsmi_status_t FakeSmiBackendImpl::shut_down() {
+  do {
+    std::lock_guard<std::mutex> guard(notif_mutex_);
+    initialized_ = false;
+  } while (0);
+  notif_cv_.notify_all();
+  return AMDSMI_STATUS_SUCCESS;
+}
+
+amdsmi_status_t FakeSmiBackendImpl::get_lib_version(amdsmi_version_t* version) {
+  FAKE_SMI_ENTER("get_lib_version");
+  if (version == nullptr) {
+    return AMDSMI_STATUS_INVAL;
+  }
+  version->major = 0;
+  version->minor = 0;
+  version->release = 0;
+  version->build = "fake";
+  return AMDSMI_STATUS_SUCCESS;
+}
+
+// One socket per GPU, as amdsmi reports in AMDSMI_INIT_AMD_GPUS mode
+amdsmi_status_t FakeSmiBackendImpl::get_socket_handles(uint32_t* socket_count,
+                                                       amdsmi_socket_handle* socket_handles) {
+  FAKE_SMI_ENTER("get_socket_handles");
+  if (socket_count == nullptr) {
+    return AMDSMI_STATUS_INVAL;
+  }
+  if (socket_handles == nullptr) {
+    *socket_count = config_.num_gpus;
+    return AMDSMI_STATUS_SUCCESS;
+  }
+  uint32_t count = std::min(*socket_count, config_.num_gpus);
+  for (uint32_t i = 0; i < count; i++) {
+    socket_handles[i] = handle_of(i);
+  }
+  *socket_count = count;
+  return AMDSMI_STATUS_SUCCESS;
+}
+
+amdsmi_status_t FakeSmiBackendImpl::get_processor_handles(
+    amdsmi_socket_handle socket_handle, uint32_t* processor_count,
+    amdsmi_processor_handle* processor_handles) {
+  FAKE_SMI_ENTER("get_processor_handles");
+  FAKE_SMI_GPU(socket_handle, gpu);
+  if (processor_count == nullptr) {
+    return AMDSMI_STATUS_INVAL;
+  }
+  if (processor_handles != nullptr && *processor_count >= 1) {
+    processor_handles[0] = handle_of(gpu);
+  }
+  *processor_count = 1;
+  return AMDSMI_STATUS_SUCCESS;
+}
+
+amdsmi_status_t FakeSmiBackendImpl::get_processor_type(amdsmi_processor_handle processor_handle,
+                                                       processor_type_t* processor_type) {
+  FAKE_SMI_ENTER("get_processor_type");
+  FAKE_SMI_GPU(processor_handle, gpu);
+  (void)gpu;
+  *processor_type = AMDSMI_PROCESSOR_TYPE_AMD_GPU;
+  return AMDSMI_STATUS_SUCCESS;
+}
+
+amdsmi_status_t FakeSmiBackendImpl::get_gpu_bdf_id(amdsmi_processor_handle processor_handle,
+                                                   uint64_t* bdfid) {
+  FAKE_SMI_ENTER("get_gpu_bdf_id");
+  FAKE_SMI_GPU(processor_handle, gpu);
+  *bdfid = gpu;
+  return AMDSMI_STATUS_SUCCESS;
+}
+
+amdsmi_status_t FakeSmiBackendImpl::get_gpu_asic_info(amdsmi_processor_handle processor_handle,
+                                                      amdsmi_asic_info_t* info) {
+  FAKE_SMI_ENTER("get_gpu_asic_info");
+  FAKE_SMI_GPU(processor_handle, gpu);
+  memset(info, 0, sizeof(*info));
+  snprintf(info->market_name, sizeof(info->market_name), "Fake AMD GPU %u", gpu);
+  info->vendor_id = 0x1002;
+  info->oam_id = gpu;
+  return AMDSMI_STATUS_SUCCESS;
+}
+
+amdsmi_status_t FakeSmiBackendImpl::get_gpu_metrics_info(amdsmi_processor_handle processor_handle,
+                                                         amdsmi_gpu_metrics_t* metrics) {
+  FAKE_SMI_ENTER("get_gpu_metrics_info");
+  FAKE_SMI_GPU(processor_handle, gpu);
+  uint32_t util = activity(gpu);
+  uint64_t elapsed_sec = elapsed_ns() / 1000000000;
+
+  // All ones is how gpu metrics flags a value as not available
+  memset(metrics, 0xFF, sizeof(*metrics));
+  metrics->temperature_edge = 35 + util / 2;
+  metrics->temperature_mem = 40 + util / 2;
+  metrics->average_gfx_activity = util;
+  metrics->average_socket_power = 100 + 4 * util;
+  metrics->current_socket_power = 100 + 4 * util;
+  metrics->current_gfxclk = 800 + 15 * util;
+  metrics->pcie_bandwidth_inst = 16000;
+  for (uint32_t i = 0; i < AMDSMI_MAX_NUM_XGMI_LINKS; i++) {
+    metrics->xgmi_read_data_acc[i] = elapsed_sec * 1024 * (gpu + 1);
+    metrics->xgmi_write_data_acc[i] = elapsed_sec * 512 * (gpu + 1);
+  }
+  return AMDSMI_STATUS_SUCCESS;
+}
+
+amdsmi_status_t FakeSmiBackendImpl::get_gpu_memory_usage(amdsmi_processor_handle processor_handle,
+                                                         amdsmi_memory_type_t,
+                                                         uint64_t* used) {
+  FAKE_SMI_ENTER("get_gpu_memory_usage");
+  FAKE_SMI_GPU(processor_handle, gpu);
+  *used = kFakeMemoryTotal / 100 * (20 + activity(gpu) * 6 / 10);
+  return AMDSMI_STATUS_SUCCESS;
+}
+
+amdsmi_status_t FakeSmiBackendImpl::get_gpu_memory_total(amdsmi_processor_handle processor_handle,
+                                                         amdsmi_memory_type_t,
+                                                         uint64_t* total) {
+  FAKE_SMI_ENTER("get_gpu_memory_total");
+  FAKE_SMI_GPU(processor_handle, gpu);
+  (void)gpu;
+  *total = kFakeMemoryTotal;
+  return AMDSMI_STATUS_SUCCESS;
+}
+
+amdsmi_status_t FakeSmiBackendImpl::get_gpu_activity(amdsmi_processor_handle processor_handle,
+                                                     amdsmi_engine_usage_t* info) {
+  FAKE_SMI_ENTER("get_gpu_activity");
+  FAKE_SMI_GPU(processor_handle, gpu);
+  uint32_t util = activity(gpu);
+  memset(info, 0, sizeof(*info));
+  info->gfx_activity = util;
+  info->umc_activity = util / 2;
+  return AMDSMI_STATUS_SUCCESS;
+}
+
+amdsmi_status_t FakeSmiBackendImpl::get_power_info(amdsmi_processor_handle processor_handle,
+                                                   amdsmi_power_info_t* info) {
+  FAKE_SMI_ENTER("get_power_info");
+  FAKE_SMI_GPU(processor_handle, gpu);
+  uint32_t util = activity(gpu);
+  memset(info, 0, sizeof(*info));
+  info->average_socket_power = 100 + 4 * util;
+  info->current_socket_power = 100 + 4 * util;
+  return AMDSMI_STATUS_SUCCESS;
+}
+
+amdsmi_status_t FakeSmiBackendImpl::get_clk_freq(amdsmi_processor_handle processor_handle,
+                                                 amdsmi_clk_type_t clk_type,
+                                                 amdsmi_frequencies_t* f) {
+  FAKE_SMI_ENTER("get_clk_freq");
+  FAKE_SMI_GPU(processor_handle, gpu);
+  memset(f, 0, sizeof(*f));
+  if (clk_type == AMDSMI_CLK_TYPE_MEM) {
+    f->num_supported = 1;
+    f->current = 0;
+    f->frequency[0] = 1600ULL * 1000000;
+    return AMDSMI_STATUS_SUCCESS;
+  }
+  f->num_supported = 2;
+  f->current = 1;
+  f->frequency[0] = 500ULL * 1000000;
+  f->frequency[1] = (800ULL + 15 * activity(gpu)) * 1000000;
+  return AMDSMI_STATUS_SUCCESS;
+}
+
+amdsmi_status_t FakeSmiBackendImpl::get_temp_metric(amdsmi_processor_handle processor_handle,
+                                                    amdsmi_temperature_type_t sensor_type,
+                                                    amdsmi_temperature_metric_t metric,
+                                                    int64_t* temperature) {
+  FAKE_SMI_ENTER("get_temp_metric");
+  FAKE_SMI_GPU(processor_handle, gpu);
+  switch (metric) {
+    case AMDSMI_TEMP_CURRENT: {
+      int64_t edge = 35 + activity(gpu) / 2;
+      if (sensor_type == AMDSMI_TEMPERATURE_TYPE_JUNCTION) {
+        *temperature = edge + 10;
+      } else if (sensor_type == AMDSMI_TEMPERATURE_TYPE_VRAM) {
+        *temperature = edge + 5;
+      } else {
+        *temperature = edge;
+      }
+      return AMDSMI_STATUS_SUCCESS;
+    }
+    case AMDSMI_TEMP_MAX:
+      *temperature = 100;
+      return AMDSMI_STATUS_SUCCESS;
+    case AMDSMI_TEMP_MIN:
+    case AMDSMI_TEMP_CRIT_MIN:
+      *temperature = 0;
+      return AMDSMI_STATUS_SUCCESS;
+    case AMDSMI_TEMP_CRITICAL:
+      *temperature = 105;
+      return AMDSMI_STATUS_SUCCESS;
+    case AMDSMI_TEMP_EMERGENCY:
+      *temperature = 110;
+      return AMDSMI_STATUS_SUCCESS;
+    default:
+      return AMDSMI_STATUS_NOT_SUPPORTED;
+  }
+}
+
+amdsmi_status_t FakeSmiBackendImpl::get_gpu_volt_metric(amdsmi_processor_handle processor_handle,
+                                                        amdsmi_voltage_type_t,
+                                                        amdsmi_voltage_metric_t metric,
+                                                        int64_t* voltage) {
+  FAKE_SMI_ENTER("get_gpu_volt_metric");
+  FAKE_SMI_GPU(processor_handle, gpu);
+  (void)gpu;
+  switch (metric) {
+    case AMDSMI_VOLT_CURRENT:
+      *voltage = 800;
+      return AMDSMI_STATUS_SUCCESS;
+    case AMDSMI_VOLT_MAX:
+      *voltage = 1100;
+      return AMDSMI_STATUS_SUCCESS;
+    case AMDSMI_VOLT_MIN:
+      *voltage = 600;
+      return AMDSMI_STATUS_SUCCESS;
+    case AMDSMI_VOLT_MAX_CRIT:
+      *voltage = 1200;
+      return AMDSMI_STATUS_SUCCESS;
+    case AMDSMI_VOLT_MIN_CRIT:
+      *voltage = 500;
+      return AMDSMI_STATUS_SUCCESS;
+    default:
+      return AMDSMI_STATUS_NOT_SUPPORTED;
+  }
+}
+
+amdsmi_status_t FakeSmiBackendImpl::get_utilization_count(
+    amdsmi_processor_handle processor_handle, amdsmi_utilization_counter_t utilization_counters[],
+    uint32_t count, uint64_t* timestamp) {
+  FAKE_SMI_ENTER("get_utilization_count");
+  FAKE_SMI_GPU(processor_handle, gpu);
+  uint64_t elapsed_sec = elapsed_ns() / 1000000000;
+  for (uint32_t i = 0; i < count; i++) {
+    if (utilization_counters[i].type == AMDSMI_COARSE_DECODER_ACTIVITY) {
+      utilization_counters[i].value = 0;
+    } else {
+      utilization_counters[i].value = elapsed_sec * activity(gpu);
+    }
+  }
+  *timestamp = elapsed_ns();
+  return AMDSMI_STATUS_SUCCESS;
+}
+
+amdsmi_status_t FakeSmiBackendImpl::get_gpu_pci_throughput(
+    amdsmi_processor_handle processor_handle, uint64_t* sent, uint64_t* received,
+    uint64_t* max_pkt_sz) {
+  FAKE_SMI_ENTER("get_gpu_pci_throughput");
+  FAKE_SMI_GPU(processor_handle, gpu);
+  uint32_t util = activity(gpu);
+  *sent = 1000ULL * (gpu + 1) * util;
+  *received = 2000ULL * (gpu + 1) * util;
+  *max_pkt_sz = 256;
+  return AMDSMI_STATUS_SUCCESS;
+}
+
+amdsmi_status_t FakeSmiBackendImpl::get_gpu_ecc_status(amdsmi_processor_handle processor_handle,
+                                                       amdsmi_gpu_block_t,
+                                                       amdsmi_ras_err_state_t* state) {
+  FAKE_SMI_ENTER("get_gpu_ecc_status");
+  FAKE_SMI_GPU(processor_handle, gpu);
+  (void)gpu;
+  *state = AMDSMI_RAS_ERR_STATE_ENABLED;
+  return AMDSMI_STATUS_SUCCESS;
+}
+
+amdsmi_status_t FakeSmiBackendImpl::get_gpu_ecc_count(amdsmi_processor_handle processor_handle,
+                                                      amdsmi_gpu_block_t,
+                                                      amdsmi_error_count_t* ec) {
+  FAKE_SMI_ENTER("get_gpu_ecc_count");
+  FAKE_SMI_GPU(processor_handle, gpu);
+  (void)gpu;
+  memset(ec, 0, sizeof(*ec));
+  return AMDSMI_STATUS_SUCCESS;
+}
+
+amdsmi_status_t FakeSmiBackendImpl::topo_get_link_weight(
+    amdsmi_processor_handle processor_handle_src, amdsmi_processor_handle processor_handle_dst,
+    uint64_t* weight) {
+  FAKE_SMI_ENTER("topo_get_link_weight");
+  FAKE_SMI_GPU(processor_handle_src, src);
+  FAKE_SMI_GPU(processor_handle_dst, dst);
+  // Fully connected over XGMI
+  *weight = (src == dst) ? 0 : 15;
+  return AMDSMI_STATUS_SUCCESS;
+}
+
+// No process ever runs on a fake GPU
+amdsmi_status_t FakeSmiBackendImpl::get_gpu_compute_process_info(amdsmi_process_info_t*,
+                                                                 uint32_t* num_items) {
+  FAKE_SMI_ENTER("get_gpu_compute_process_info");
+  *num_items = 0;
+  return AMDSMI_STATUS_SUCCESS;
+}
+
+amdsmi_status_t FakeSmiBackendImpl::get_gpu_compute_process_gpus(uint32_t, uint32_t*,
+                                                                 uint32_t* num_devices) {
+  FAKE_SMI_ENTER("get_gpu_compute_process_gpus");
+  *num_devices = 0;
+  return AMDSMI_STATUS_SUCCESS;
+}
+
+amdsmi_status_t FakeSmiBackendImpl::gpu_counter_group_supported(
+    amdsmi_processor_handle processor_handle, amdsmi_event_group_t) {
+  FAKE_SMI_ENTER("gpu_counter_group_supported");
+  FAKE_SMI_GPU(processor_handle, gpu);
+  (void)gpu;
+  return AMDSMI_STATUS_SUCCESS;
+}
+
+amdsmi_status_t FakeSmiBackendImpl::get_gpu_available_counters(
+    amdsmi_processor_handle processor_handle, amdsmi_event_group_t, uint32_t* available) {
+  FAKE_SMI_ENTER("get_gpu_available_counters");
+  FAKE_SMI_GPU(processor_handle, gpu);
+  (void)gpu;
+  *available = kFakeCountersAvailable;
+  return AMDSMI_STATUS_SUCCESS;
+}
+
+amdsmi_status_t FakeSmiBackendImpl::gpu_create_counter(amdsmi_processor_handle processor_handle,
+                                                       amdsmi_event_type_t type,
+                                                       amdsmi_event_handle_t* evnt_handle) {
+  FAKE_SMI_ENTER("gpu_create_counter");
+  FAKE_SMI_GPU(processor_handle, gpu);
+  std::lock_guard<std::mutex> guard(counter_mutex_);
+  *evnt_handle = next_counter_++;
+  counters_[*evnt_handle] = {gpu, type, false, 0, 0};
+  return AMDSMI_STATUS_SUCCESS;
+}
+
+amdsmi_status_t FakeSmiBackendImpl::gpu_control_counter(amdsmi_event_handle_t evt_handle,
+                                                        amdsmi_counter_command_t cmd, void*) {
+  FAKE_SMI_ENTER("gpu_control_counter");
+  std::lock_guard<std::mutex> guard(counter_mutex_);
+  auto it = counters_.find(evt_handle);
+  if (it == counters_.end()) {
+    return AMDSMI_STATUS_INVAL;
+  }
+  if (cmd == AMDSMI_CNTR_CMD_START) {
+    it->second.running = true;
+    it->second.start_ns = elapsed_ns();
+  } else {
+    it->second.running = false;
+  }
+  return AMDSMI_STATUS_SUCCESS;
+}
+
+amdsmi_status_t FakeSmiBackendImpl::gpu_read_counter(amdsmi_event_handle_t evt_handle,
+                                                     amdsmi_counter_value_t* value) {
+  FAKE_SMI_ENTER("gpu_read_counter");
+  std::lock_guard<std::mutex> guard(counter_mutex_);
+  auto it = counters_.find(evt_handle);
+  if (it == counters_.end()) {
+    return AMDSMI_STATUS_INVAL;
+  }
+  FakeCounter& c = it->second;
+  uint64_t running = c.running ? elapsed_ns() - c.start_ns : 0;
+  // About one 32 byte beat per microsecond and GPU index
+  c.value = running / 1000 * (c.gpu_index + 1);
+  value->value = c.value;
+  value->time_enabled = running;
+  value->time_running = running;
+  return AMDSMI_STATUS_SUCCESS;
+}
+
+amdsmi_status_t FakeSmiBackendImpl::gpu_destroy_counter(amdsmi_event_handle_t evnt_handle) {
+  FAKE_SMI_ENTER("gpu_destroy_counter");
+  std::lock_guard<std::mutex> guard(counter_mutex_);
+  if (counters_.erase(evnt_handle) == 0) {
+    return AMDSMI_STATUS_INVAL;
+  }
+  return AMDSMI_STATUS_SUCCESS;
+}
+
+amdsmi_status_t FakeSmiBackendImpl::init_gpu_event_notification(
+    amdsmi_processor_handle processor_handle) {
+  FAKE_SMI_ENTER("init_gpu_event_notification");
+  FAKE_SMI_GPU(processor_handle, gpu);
+  (void)gpu;
+  return AMDSMI_STATUS_SUCCESS;
+}
+
+amdsmi_status_t FakeSmiBackendImpl::set_gpu_event_notification_mask(
+    amdsmi_processor_handle processor_handle, uint64_t mask) {
+  FAKE_SMI_ENTER("set_gpu_event_notification_mask");
+  FAKE_SMI_GPU(processor_handle, gpu);
+  do {
+    std::lock_guard<std::mutex> guard(notif_mutex_);
+    notif_masks_[gpu] = mask;
+  } while (0);
+  notif_cv_.notify_all();
+  return AMDSMI_STATUS_SUCCESS;
+}
+
+amdsmi_status_t FakeSmiBackendImpl::get_gpu_event_notification(
+    int timeout_ms, uint32_t* num_elem, amdsmi_evt_notification_data_t* data) {
+  FAKE_SMI_ENTER("get_gpu_event_notification");
+  if (num_elem == nullptr || data == nullptr) {
+    return AMDSMI_STATUS_INVAL;
+  }
+  uint32_t capacity = *num_elem;
+  *num_elem = 0;
+
+  std::unique_lock<std::mutex> lk(notif_mutex_);
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+  if (config_.event_interval_ms == 0) {
+    // Nothing is ever raised, just honor the timeout like a quiet GPU would
+    notif_cv_.wait_until(lk, deadline, [this] { return !initialized_; });
+    return AMDSMI_STATUS_SUCCESS;
+  }
+
+  const uint64_t interval_ns = static_cast<uint64_t>(config_.event_interval_ms) * 1000000;
+  auto now = std::chrono::steady_clock::now();
+  while (initialized_ && now < deadline) {
+    uint64_t cur = elapsed_ns();
+    if (cur >= last_event_ns_ + interval_ns) {
+      break;
+    }
+    auto wake = now + std::chrono::nanoseconds(last_event_ns_ + interval_ns - cur);
+    notif_cv_.wait_until(lk, std::min(wake, deadline));
+    now = std::chrono::steady_clock::now();
+  }
+  if (!initialized_ || elapsed_ns() < last_event_ns_ + interval_ns) {
+    return AMDSMI_STATUS_SUCCESS;
+  }
+  last_event_ns_ = elapsed_ns();
+
+  // One event for every listening GPU, cycling through the enabled types
+  for (uint32_t n = 0; n < config_.num_gpus && *num_elem < capacity; n++) {
+    uint32_t gpu = (next_event_gpu_ + n) % config_.num_gpus;
+    uint64_t mask = notif_masks_[gpu];
+    if (mask == 0) {
+      continue;
+    }
+    uint32_t bit = static_cast<uint32_t>((last_event_ns_ / interval_ns) % 64);
+    while ((mask & (1ULL << bit)) == 0) {
+      bit = (bit + 1) % 64;
+    }
+    amdsmi_evt_notification_data_t& evt = data[*num_elem];
+    evt.processor_handle = handle_of(gpu);
+    evt.event = static_cast<amdsmi_evt_notification_type_t>(bit + 1);
+    snprintf(evt.message, sizeof(evt.message), "Simulated event %u on GPU %u", bit + 1, gpu);
+    (*num_elem)++;
+  }
+  next_event_gpu_ = (next_event_gpu_ + 1) % config_.num_gpus;
+  return AMDSMI_STATUS_SUCCESS;
+}
+
+amdsmi_status_t FakeSmiBackendImpl::stop_gpu_event_notification(
+    amdsmi_processor_handle processor_handle) {
+  FAKE_SMI_ENTER("stop_gpu_event_notification");
+  FAKE_SMI_GPU(processor_handle, gpu);
+  std::lock_guard<std::mutex> guard(notif_mutex_);
+  notif_masks_[gpu] = 0;
+  return AMDSMI_STATUS_SUCCESS;
+}
+
+}  // namespace rdc
+}  // namespace amd
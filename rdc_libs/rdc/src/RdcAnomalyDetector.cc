@@ -0,0 +1,249 @@
+/*
+Copyright (c) 2024 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "rdc_lib/impl/RdcAnomalyDetector.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "rdc_lib/RdcLogger.h"
+
+namespace amd {
+namespace rdc {
+
+namespace {
+
+//!< The standard deviation is at least this fraction of the mean, so a
+//!< field which was constant does not score a tiny change as huge
+const double kMinRelativeDeviation = 0.01;
+const double kMaxScore = 1000.0;
+//!< How much faster the level of the global baseline moves than its mean
+const double kLevelSpeedup = 10.0;
+
+bool is_score_field(uint32_t field_id) {
+  return field_id >= RDC_FI_ANOMALY_SCORE_0 &&
+         field_id < RDC_FI_ANOMALY_SCORE_0 + RDC_MAX_ANOMALY_DETECTORS;
+}
+
+}  // namespace
+
+RdcAnomalyDetector::RdcAnomalyDetector() : num_detectors_(0) {
+  for (auto& detector : detectors_) {
+    detector.enabled = false;
+  }
+}
+
+rdc_status_t RdcAnomalyDetector::set_detector(uint32_t detector_id,
+                                              const rdc_anomaly_config_t& config) {
+  if (detector_id >= RDC_MAX_ANOMALY_DETECTORS || !(config.alpha > 0 && config.alpha <= 1) ||
+      !(config.threshold > 0) || is_score_field(config.field_id) ||
+      RDC_EVNT_IS_NOTIF_FIELD(config.field_id)) {
+    return RDC_ST_BAD_PARAMETER;
+  }
+
+  std::lock_guard<std::mutex> guard(mutex_);
+  Detector& detector = detectors_[detector_id];
+  detector.enabled = true;
+  detector.config = config;
+  detector.states.clear();
+  num_detectors_ = std::count_if(detectors_.begin(), detectors_.end(),
+                                 [](const Detector& d) { return d.enabled; });
+  RDC_LOG(RDC_INFO,
+          "Set the anomaly detector " << detector_id << " on the field " << config.field_id);
+  return RDC_ST_OK;
+}
+
+rdc_status_t RdcAnomalyDetector::clear_detector(uint32_t detector_id) {
+  if (detector_id >= RDC_MAX_ANOMALY_DETECTORS) {
+    return RDC_ST_BAD_PARAMETER;
+  }
+
+  std::lock_guard<std::mutex> guard(mutex_);
+  Detector& detector = detectors_[detector_id];
+  if (!detector.enabled) {
+    return RDC_ST_NOT_FOUND;
+  }
+  detector.enabled = false;
+  detector.states.clear();
+  num_detectors_--;
+  return RDC_ST_OK;
+}
+
+void RdcAnomalyDetector::learn(Baseline* baseline, double alpha, double v) {
+  // The first samples are averaged evenly, so the baseline does not start
+  // biased towards the very first one
+  baseline->count++;
+  double a = std::max(alpha, 1.0 / baseline->count);
+  double diff = v - baseline->mean;
+  double incr = a * diff;
+  baseline->mean += incr;
+  baseline->variance = (1 - a) * (baseline->variance + diff * incr);
+}
+
+void RdcAnomalyDetector::learn_global(State* state, double alpha, double v) {
+  Baseline& global = state->global;
+  global.count++;
+  double a = std::max(alpha, 1.0 / global.count);
+  double b = std::min(1.0, std::max(kLevelSpeedup * alpha, 1.0 / global.count));
+  if (global.count == 1) {
+    state->level = v;
+  }
+  // The level lags white noise of variance s2 by (v - level)^2 = 2 * s2 / (2 - b)
+  double dev = v - state->level;
+  global.mean += a * (v - global.mean);
+  global.variance += a * (dev * dev * (2 - b) / 2 - global.variance);
+  state->level += b * dev;
+}
+
+double RdcAnomalyDetector::score(const Baseline& baseline, double v) {
+  double deviation = std::max(std::sqrt(baseline.variance),
+                              kMinRelativeDeviation * std::fabs(baseline.mean));
+  if (deviation == 0) {
+    return v == baseline.mean ? 0 : std::copysign(kMaxScore, v - baseline.mean);
+  }
+  return std::max(-kMaxScore, std::min(kMaxScore, (v - baseline.mean) / deviation));
+}
+
+void RdcAnomalyDetector::evaluate(uint32_t gpu_index, const rdc_field_value& value,
+                                  std::vector<rdc_evnt_notification_t>* events) {
+  if (num_detectors_ == 0) {
+    return;
+  }
+
+  double v = 0;
+  if (value.type == INTEGER) {
+    v = static_cast<double>(value.value.l_int);
+  } else if (value.type == DOUBLE) {
+    v = value.value.dbl;
+  } else {
+    return;
+  }
+
+  std::lock_guard<std::mutex> guard(mutex_);
+  for (auto& detector : detectors_) {
+    const rdc_anomaly_config_t& config = detector.config;
+    if (!detector.enabled || config.field_id != value.field_id) {
+      continue;
+    }
+
+    State& state = detector.states[gpu_index];
+    Baseline* season = nullptr;
+    if (config.season_period_s > 0) {
+      uint64_t phase = (value.ts / 1000) % config.season_period_s;
+      season = &state.season[phase * kSeasonSlices / config.season_period_s];
+    }
+
+    // Score against the baseline of the slice once it is warm, so a
+    // periodic workload is compared with the same point of its period
+    uint64_t warmup = std::max<uint64_t>(config.warmup_samples, 2);
+    const Baseline* baseline = nullptr;
+    if (season && season->count >= warmup) {
+      baseline = season;
+    } else if (state.global.count >= warmup) {
+      baseline = &state.global;
+    }
+    if (baseline) {
+      state.has_score = true;
+      state.score_ts = value.ts;
+      state.score = score(*baseline, v);
+      double magnitude = std::fabs(state.score);
+      if (magnitude >= config.threshold && !state.raised) {
+        state.raised = true;
+        rdc_evnt_notification_t event;
+        event.gpu_id = gpu_index;
+        event.field.field_id = RDC_EVNT_NOTIF_ANOMALY;
+        event.field.status = RDC_ST_OK;
+        event.field.ts = value.ts;
+        event.field.type = INTEGER;
+        event.field.value.l_int = value.field_id;
+        events->push_back(event);
+      } else if (magnitude < config.threshold / 2) {
+        state.raised = false;
+      }
+    }
+
+    learn_global(&state, config.alpha, v);
+    if (season) {
+      learn(season, config.alpha, v);
+    }
+  }
+}
+
+rdc_status_t RdcAnomalyDetector::rdc_telemetry_fields_query(uint32_t field_ids[MAX_NUM_FIELDS],
+                                                            uint32_t* field_count) {
+  if (field_count == nullptr) {
+    return RDC_ST_BAD_PARAMETER;
+  }
+  *field_count = 0;
+  for (uint32_t i = 0; i < RDC_MAX_ANOMALY_DETECTORS; i++) {
+    field_ids[(*field_count)++] = RDC_FI_ANOMALY_SCORE_0 + i;
+  }
+  return RDC_ST_OK;
+}
+
+rdc_status_t RdcAnomalyDetector::rdc_telemetry_fields_value_get(rdc_gpu_field_t* fields,
+                                                                uint32_t fields_count,
+                                                                rdc_field_value_f callback,
+                                                                void* user_data) {
+  if (fields == nullptr || callback == nullptr) {
+    return RDC_ST_BAD_PARAMETER;
+  }
+
+  std::vector<rdc_gpu_field_value_t> values(fields_count);
+  do {  //< lock guard scope; the callback evaluates the scores again
+    std::lock_guard<std::mutex> guard(mutex_);
+    for (uint32_t i = 0; i < fields_count; i++) {
+      rdc_gpu_field_value_t& value = values[i];
+      value.gpu_index = fields[i].gpu_index;
+      value.field_value.field_id = fields[i].field_id;
+      value.field_value.type = DOUBLE;
+      value.field_value.ts = 0;
+      value.field_value.status = RDC_ST_NOT_FOUND;
+      if (!is_score_field(fields[i].field_id)) {
+        value.field_value.status = RDC_ST_NOT_SUPPORTED;
+        continue;
+      }
+      const Detector& detector = detectors_[fields[i].field_id - RDC_FI_ANOMALY_SCORE_0];
+      auto state = detector.states.find(fields[i].gpu_index);
+      if (detector.enabled && state != detector.states.end() && state->second.has_score) {
+        value.field_value.ts = state->second.score_ts;
+        value.field_value.value.dbl = state->second.score;
+        value.field_value.status = RDC_ST_OK;
+      }
+    }
+  } while (0);
+
+  if (values.empty()) {
+    return RDC_ST_OK;
+  }
+  return callback(&values[0], values.size(), user_data);
+}
+
+rdc_status_t RdcAnomalyDetector::rdc_telemetry_fields_watch(rdc_gpu_field_t*, uint32_t) {
+  return RDC_ST_OK;
+}
+
+rdc_status_t RdcAnomalyDetector::rdc_telemetry_fields_unwatch(rdc_gpu_field_t*, uint32_t) {
+  return RDC_ST_OK;
+}
+
+}  // namespace rdc
+}  // namespace amd
@@ -21,18 +21,351 @@ THE SOFTWARE.
 */
 #include "rdc_lib/impl/RdcCacheManagerImpl.h"
 
+#include <string.h>
 #include <sys/time.h>
 
+#include <algorithm>
 #include <cmath>
+#include <cstdlib>
 #include <ctime>
+#include <limits>
 #include <sstream>
 
+#include "common/rdc_fields_supported.h"
+#include "common/rdc_perf_histogram.h"
 #include "rdc_lib/RdcLogger.h"
+#include "rdc_lib/RdcPipelineTrace.h"
+#include "rdc_lib/impl/RdcEncoding.h"
 #include "rdc_lib/rdc_common.h"
 
 namespace amd {
 namespace rdc {
 
+// 10 seconds for 1 hour, 1 minute for 6 hours and 10 minutes for 24 hours
+static const RdcRollupTier kDefaultRollupTiers[] = {
+    {10 * 1000, 3600 * 1000}, {60 * 1000, 6 * 3600 * 1000}, {600 * 1000, 24 * 3600 * 1000}};
+
+// Parse RDC_ROLLUP_TIERS, a comma separated list of <width>:<retention> in
+// seconds, such as "10:3600,60:21600,600:86400". "none" disables rollups.
+static bool parse_rollup_tiers(const char* spec, std::vector<RdcRollupTier>* tiers) {
+  tiers->clear();
+  if (strcmp(spec, "none") == 0) {
+    return true;
+  }
+
+  std::stringstream ss(spec);
+  std::string item;
+  while (std::getline(ss, item, ',')) {
+    char* end = nullptr;
+    uint64_t width = strtoull(item.c_str(), &end, 10);
+    if (end == nullptr || *end != ':') {
+      return false;
+    }
+    uint64_t retention = strtoull(end + 1, &end, 10);
+    if (*end != '\0' || width == 0 || retention < width) {
+      return false;
+    }
+    if (!tiers->empty() && width <= tiers->back().width / 1000) {
+      return false;
+    }
+    tiers->push_back({width * 1000, retention * 1000});
+  }
+  return !tiers->empty();
+}
+
+RdcCacheManagerImpl::RdcCacheManagerImpl()
+    : cold_age_(0), job_use_count_(0), max_stopped_jobs_(64) {
+  // RDC_CACHE_COLD_AGE is in seconds
+  const char* cold_age = getenv("RDC_CACHE_COLD_AGE");
+  if (cold_age != nullptr) {
+    char* end = nullptr;
+    uint64_t seconds = strtoull(cold_age, &end, 10);
+    if (end == cold_age || *end != '\0') {
+      RDC_LOG(RDC_ERROR,
+              "Invalid RDC_CACHE_COLD_AGE " << cold_age << ", samples stay uncompressed");
+    } else {
+      cold_age_ = seconds * 1000;
+    }
+  }
+
+  const char* spec = getenv("RDC_ROLLUP_TIERS");
+  if (spec == nullptr || !parse_rollup_tiers(spec, &rollup_tiers_)) {
+    if (spec != nullptr) {
+      RDC_LOG(RDC_ERROR, "Invalid RDC_ROLLUP_TIERS " << spec << ", using the default tiers");
+    }
+    rollup_tiers_.assign(std::begin(kDefaultRollupTiers), std::end(kDefaultRollupTiers));
+  }
+
+  job_store_ = RdcJobStore::from_env();
+  const char* max_stopped = getenv("RDC_MAX_STOPPED_JOBS");
+  if (max_stopped != nullptr) {
+    char* end = nullptr;
+    uint64_t jobs = strtoull(max_stopped, &end, 10);
+    if (end == max_stopped || *end != '\0' || jobs > UINT32_MAX) {
+      RDC_LOG(RDC_ERROR, "Invalid RDC_MAX_STOPPED_JOBS " << max_stopped << ", keeping "
+                                                         << max_stopped_jobs_);
+    } else {
+      max_stopped_jobs_ = jobs;
+    }
+  }
+
+  store_ = RdcPersistentStore::from_env();
+  if (store_ != nullptr) {
+    store_->replay([this](RdcPersistRecordKind kind, const uint8_t* payload, uint32_t length) {
+      replay_record(kind, payload, length);
+    });
+    stop_restored_jobs();
+    RDC_LOG(RDC_INFO, "Restored " << cache_samples_.size() << " cached fields and "
+                                  << cache_jobs_.size() << " jobs");
+    store_->start_flusher([this]() {
+      std::lock_guard<std::mutex> guard(cache_mutex_);
+      persist_dirty_jobs();
+    });
+  }
+}
+
+RdcCacheManagerImpl::~RdcCacheManagerImpl() {
+  if (store_ != nullptr) {
+    do {  //< lock guard for thread safe
+      std::lock_guard<std::mutex> guard(cache_mutex_);
+      persist_dirty_jobs();
+    } while (0);
+    store_.reset();
+  }
+}
+
+namespace {
+
+// The payload of a RDC_PERSIST_SAMPLE record, followed by the value: 8
+// bytes for INTEGER and DOUBLE, the characters for STRING and the whole
+// array for BLOB
+struct RdcPersistSample {
+  uint32_t gpu_index;
+  uint32_t field_id;
+  uint64_t ts;
+  uint32_t type;
+  uint32_t reserved;
+};
+
+// The divisor from the cached units to the ones of rdc_stats_summary_t, as
+// applied by rdc_job_get_stats
+double job_stats_adjuster(uint32_t field_id, uint64_t memory_total) {
+  switch (field_id) {
+    case RDC_FI_POWER_USAGE:
+    case RDC_FI_GPU_CLOCK:
+    case RDC_FI_MEM_CLOCK:
+      return 1000000;
+    case RDC_FI_GPU_MEMORY_USAGE:
+      return memory_total / 100.0;
+    case RDC_FI_GPU_TEMP:
+      return 1000;
+    case RDC_FI_PCIE_TX:
+    case RDC_FI_PCIE_RX:
+      return 1024 * 1024;
+    default:
+      return 1;
+  }
+}
+
+// The sketch is within 1% of the samples, clamp it to the exact range
+void set_percentiles(const RdcQuantileSketch& sketch, unsigned int adjuster,
+                     rdc_stats_summary_t* s) {
+  auto percentile = [&](double q) {
+    uint64_t v = static_cast<uint64_t>(std::llround(sketch.quantile(q) / adjuster));
+    return std::max(s->min_value, std::min(s->max_value, v));
+  };
+  s->p50 = percentile(0.50);
+  s->p90 = percentile(0.90);
+  s->p95 = percentile(0.95);
+  s->p99 = percentile(0.99);
+}
+
+}  // namespace
+
+void RdcCacheManagerImpl::persist_record(RdcPersistRecordKind kind, const void* payload,
+                                         uint32_t length) {
+  if (!store_->append(kind, payload, length)) {
+    if (!store_->disabled()) {
+      RDC_LOG(RDC_ERROR, "Fail to persist a record of " << length << " bytes");
+    }
+    return;
+  }
+  // The oldest segments holding the job stats will be deleted
+  if (store_->take_new_segment()) {
+    for (auto ite = cache_jobs_.begin(); ite != cache_jobs_.end(); ite++) {
+      persist_job(ite->first, ite->second);
+    }
+  }
+}
+
+// job_id[64], start_time, end_time, the number of GPUs, then per GPU its
+// index, energy and ECC counters, the number of fields and per field its id
+// and FieldSummaryStats. The timelines follow all the GPUs, so the records
+// written without them still replay: their number, then per timeline its
+// GPU index, field id and RdcJobTimeline.
+void RdcCacheManagerImpl::persist_job(const std::string& job_id, const RdcJobStatsCacheEntry& job) {
+  std::string buf;
+  char id[64] = {0};
+  strncpy_with_null(id, job_id.c_str(), sizeof(id));
+  buf.append(id, sizeof(id));
+  put_raw(&buf, job.start_time);
+  put_raw(&buf, job.end_time);
+  put_raw(&buf, static_cast<uint32_t>(job.gpu_stats.size()));
+  for (const auto& gpu : job.gpu_stats) {
+    put_raw(&buf, gpu.first);
+    put_raw(&buf, gpu.second.energy_consumed);
+    put_raw(&buf, gpu.second.energy_last_time);
+    put_raw(&buf, gpu.second.ecc_correct_init);
+    put_raw(&buf, gpu.second.ecc_uncorrect_init);
+    put_raw(&buf, static_cast<uint32_t>(gpu.second.field_summaries.size()));
+    for (const auto& field : gpu.second.field_summaries) {
+      put_raw(&buf, field.first);
+      put_raw(&buf, field.second);
+    }
+  }
+  uint32_t num_timelines = 0;
+  for (const auto& gpu : job.gpu_stats) {
+    num_timelines += gpu.second.timelines.size();
+  }
+  put_raw(&buf, num_timelines);
+  for (const auto& gpu : job.gpu_stats) {
+    for (const auto& timeline : gpu.second.timelines) {
+      put_raw(&buf, gpu.first);
+      put_raw(&buf, timeline.first);
+      put_raw(&buf, timeline.second);
+    }
+  }
+  dirty_jobs_.erase(job_id);
+  persist_record(RDC_PERSIST_JOB, buf.data(), buf.size());
+}
+
+void RdcCacheManagerImpl::persist_dirty_jobs() {
+  while (!dirty_jobs_.empty()) {
+    std::string job_id = *dirty_jobs_.begin();
+    auto ite = cache_jobs_.find(job_id);
+    if (ite == cache_jobs_.end()) {
+      dirty_jobs_.erase(job_id);
+    } else {
+      persist_job(job_id, ite->second);
+    }
+  }
+}
+
+void RdcCacheManagerImpl::replay_record(RdcPersistRecordKind kind, const uint8_t* payload,
+                                        uint32_t length) {
+  PayloadReader reader(payload, length);
+  if (kind == RDC_PERSIST_SAMPLE) {
+    RdcPersistSample sample;
+    if (!reader.get(&sample) || reader.remaining() > sizeof(rdc_field_value_data)) {
+      return;
+    }
+    rdc_field_value value;
+    memset(&value, 0, sizeof(value));
+    value.field_id = static_cast<rdc_field_t>(sample.field_id);
+    value.ts = sample.ts;
+    value.type = static_cast<rdc_field_type_t>(sample.type);
+    reader.get_bytes(&value.value, reader.remaining());
+    cache_sample({sample.gpu_index, value.field_id}, value);
+  } else if (kind == RDC_PERSIST_JOB) {
+    char id[64];
+    RdcJobStatsCacheEntry job;
+    uint32_t num_gpus = 0;
+    if (!reader.get_bytes(id, sizeof(id)) || !reader.get(&job.start_time) ||
+        !reader.get(&job.end_time) || !reader.get(&num_gpus)) {
+      return;
+    }
+    id[sizeof(id) - 1] = '\0';
+    for (uint32_t g = 0; g < num_gpus; g++) {
+      uint32_t gpu_index = 0;
+      uint32_t num_fields = 0;
+      GpuSummaryStats gpu;
+      if (!reader.get(&gpu_index) || !reader.get(&gpu.energy_consumed) ||
+          !reader.get(&gpu.energy_last_time) || !reader.get(&gpu.ecc_correct_init) ||
+          !reader.get(&gpu.ecc_uncorrect_init) || !reader.get(&num_fields)) {
+        return;
+      }
+      for (uint32_t f = 0; f < num_fields; f++) {
+        uint32_t field_id = 0;
+        FieldSummaryStats stats;
+        if (!reader.get(&field_id) || !reader.get(&stats)) {
+          return;
+        }
+        gpu.field_summaries[field_id] = stats;
+      }
+      job.gpu_stats[gpu_index] = gpu;
+    }
+    uint32_t num_timelines = 0;
+    if (reader.get(&num_timelines)) {
+      for (uint32_t t = 0; t < num_timelines; t++) {
+        uint32_t gpu_index = 0;
+        uint32_t field_id = 0;
+        RdcJobTimeline timeline;
+        if (!reader.get(&gpu_index) || !reader.get(&field_id) || !reader.get(&timeline)) {
+          break;
+        }
+        auto gpu = job.gpu_stats.find(gpu_index);
+        if (gpu != job.gpu_stats.end()) {
+          gpu->second.timelines[field_id] = timeline;
+        }
+      }
+    }
+    job.last_used = 0;
+    cache_jobs_[id] = job;
+  } else if (kind == RDC_PERSIST_JOB_REMOVE) {
+    char id[64];
+    if (reader.get_bytes(id, sizeof(id))) {
+      id[sizeof(id) - 1] = '\0';
+      cache_jobs_.erase(id);
+    }
+  } else if (kind == RDC_PERSIST_JOB_REMOVE_ALL) {
+    cache_jobs_.clear();
+  }
+}
+
+void RdcCacheManagerImpl::stop_restored_jobs() {
+  for (auto& job : cache_jobs_) {
+    if (job.second.end_time != 0) {
+      continue;
+    }
+    // The job ends with the newest sample persisted for it or its GPUs
+    uint64_t last_time = 0;
+    for (auto& gpu : job.second.gpu_stats) {
+      for (const auto& field : gpu.second.field_summaries) {
+        if (field.second.count > 0) {
+          last_time = std::max(last_time, field.second.last_time);
+        }
+      }
+      for (auto ite = cache_samples_.lower_bound({gpu.first, static_cast<rdc_field_t>(0)});
+           ite != cache_samples_.end() && ite->first.first == gpu.first; ite++) {
+        if (!ite->second.empty()) {
+          last_time = std::max(last_time, ite->second.back().last_time);
+        }
+      }
+
+      // The ECC counters hold their value at the start until the job stops,
+      // take the difference to the last cached one if any
+      auto ecc_delta = [&](rdc_field_t field_id, uint64_t init) -> uint64_t {
+        auto ite = cache_samples_.find({gpu.first, field_id});
+        if (ite == cache_samples_.end() || ite->second.empty() ||
+            ite->second.back().type != INTEGER ||
+            static_cast<uint64_t>(ite->second.back().value.l_int) < init) {
+          return 0;
+        }
+        return ite->second.back().value.l_int - init;
+      };
+      gpu.second.ecc_correct_init =
+          ecc_delta(RDC_FI_ECC_CORRECT_TOTAL, gpu.second.ecc_correct_init);
+      gpu.second.ecc_uncorrect_init =
+          ecc_delta(RDC_FI_ECC_UNCORRECT_TOTAL, gpu.second.ecc_uncorrect_init);
+    }
+    job.second.end_time = std::max(job.second.start_time, last_time / 1000);
+    job.second.last_used = ++job_use_count_;
+    dirty_jobs_.insert(job.first);
+    RDC_LOG(RDC_INFO, "The job " << job.first << " was running when rdcd stopped, it is stopped at "
+                                 << job.second.end_time);
+  }
+}
+
 rdc_status_t RdcCacheManagerImpl::rdc_field_get_value_since(uint32_t gpu_index,
                                                             rdc_field_t field_id,
                                                             uint64_t since_time_stamp,
@@ -45,66 +378,594 @@ rdc_status_t RdcCacheManagerImpl::rdc_field_get_value_since(uint32_t gpu_index,
   std::lock_guard<std::mutex> guard(cache_mutex_);
   RdcFieldKey field{gpu_index, field_id};
   auto cache_samples_ite = cache_samples_.find(field);
-  if (cache_samples_ite == cache_samples_.end() || cache_samples_ite->second.size() == 0) {
+  auto cold_ite = cold_samples_.find(field);
+  bool has_hot = cache_samples_ite != cache_samples_.end() && cache_samples_ite->second.size() > 0;
+  bool has_cold = cold_ite != cold_samples_.end() && !cold_ite->second.empty();
+  if (!has_hot && !has_cold) {
     return RDC_ST_NOT_FOUND;
   }
 
-  // TODO(bill_liu): Optimize it using the binary search
-  auto cache_values = cache_samples_ite->second;
-  for (auto cache_value = cache_values.begin(); cache_value != cache_values.end(); cache_value++) {
-    if (cache_value->last_time >= since_time_stamp) {
-      // move to next potential timestamp
-      auto next_iter = std::next(cache_value);
-      if (next_iter != cache_values.end()) {
-        *next_since_time_stamp = next_iter->last_time;
-      } else {  // Last item, set it to the future by adding 1us
-        *next_since_time_stamp = cache_value->last_time + 1;
-      }
-      value->ts = cache_value->last_time;
-      value->type = cache_value->type;
-
-      if (value->type == STRING) {
-        strncpy_with_null(value->value.str, cache_value->value.str, RDC_MAX_STR_LENGTH);
-      } else {
-        value->value.l_int = cache_value->value.l_int;
-      }
-      value->field_id = field_id;
-      return RDC_ST_OK;
+  // The sample is in a sealed block, decode the block up to it
+  if (has_cold && since_time_stamp <= cold_ite->second.back().last_time()) {
+    const auto& blocks = cold_ite->second;
+    auto block = std::partition_point(blocks.begin(), blocks.end(),
+                                      [&](const RdcCompressedBlock& b) {
+                                        return b.last_time() < since_time_stamp;
+                                      });
+    RdcCompressedBlock::Reader reader(*block);
+    uint64_t ts = 0;
+    while (reader.next(&ts, &value->value) && ts < since_time_stamp) {
     }
+    value->ts = ts;
+    value->type = block->type();
+    value->field_id = field_id;
+
+    uint64_t next_ts = 0;
+    rdc_field_value_data next_value;
+    if (reader.next(&next_ts, &next_value)) {
+      *next_since_time_stamp = next_ts;
+    } else if (std::next(block) != blocks.end()) {
+      *next_since_time_stamp = std::next(block)->first_time();
+    } else if (has_hot) {
+      *next_since_time_stamp = cache_samples_ite->second.front().last_time;
+    } else {
+      *next_since_time_stamp = ts + 1;
+    }
+    return RDC_ST_OK;
   }
 
-  *next_since_time_stamp = since_time_stamp;
-  return RDC_ST_NOT_FOUND;
+  if (!has_hot) {
+    *next_since_time_stamp = since_time_stamp;
+    return RDC_ST_NOT_FOUND;
+  }
+
+  const auto& cache_values = cache_samples_ite->second;
+  auto cache_value = std::lower_bound(
+      cache_values.begin(), cache_values.end(), since_time_stamp,
+      [](const RdcCacheEntry& entry, uint64_t ts) { return entry.last_time < ts; });
+  if (cache_value == cache_values.end()) {
+    *next_since_time_stamp = since_time_stamp;
+    return RDC_ST_NOT_FOUND;
+  }
+
+  // move to next potential timestamp
+  auto next_iter = std::next(cache_value);
+  if (next_iter != cache_values.end()) {
+    *next_since_time_stamp = next_iter->last_time;
+  } else {  // Last item, set it to the future by adding 1us
+    *next_since_time_stamp = cache_value->last_time + 1;
+  }
+  value->ts = cache_value->last_time;
+  value->type = cache_value->type;
+
+  if (value->type == STRING) {
+    strncpy_with_null(value->value.str, cache_value->value.str, RDC_MAX_STR_LENGTH);
+  } else {
+    value->value.l_int = cache_value->value.l_int;
+  }
+  value->field_id = field_id;
+  return RDC_ST_OK;
 }
 
 rdc_status_t RdcCacheManagerImpl::evict_cache(uint32_t gpu_index, rdc_field_t field_id,
                                               uint64_t max_keep_samples, double max_keep_age) {
+  RDC_PERF_SCOPE("cache_evict");
   std::lock_guard<std::mutex> guard(cache_mutex_);
 
-  RdcFieldKey field{gpu_index, field_id};
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  uint64_t now = static_cast<uint64_t>(tv.tv_sec) * 1000 + tv.tv_usec / 1000;
+
+  // The rate of a counter is only cached along with the counter
+  rdc_field_t rate_field;
+  if (get_rate_field(field_id, &rate_field)) {
+    evict_samples({gpu_index, rate_field}, max_keep_samples, max_keep_age, now);
+  }
+  return evict_samples({gpu_index, field_id}, max_keep_samples, max_keep_age, now);
+}
+
+rdc_status_t RdcCacheManagerImpl::evict_samples(const RdcFieldKey& field,
+                                                uint64_t max_keep_samples, double max_keep_age,
+                                                uint64_t now) {
+  // The rollups outlive the raw samples, so they are trimmed by their own
+  // retention rather than by max_keep_samples and max_keep_age
+  auto rollups_ite = rollups_.find(field);
+  if (rollups_ite != rollups_.end()) {
+    trim_rollups(&rollups_ite->second, now);
+  }
+
   auto cache_samples_ite = cache_samples_.find(field);
   if (cache_samples_ite == cache_samples_.end() || cache_samples_ite->second.size() == 0) {
     return RDC_ST_NOT_FOUND;
   }
+  auto& cache_values = cache_samples_ite->second;
+
+  // The sealed blocks are dropped whole, so up to a block of samples more
+  // than max_keep_samples and max_keep_age may be kept
+  auto cold_ite = cold_samples_.find(field);
+  if (cold_ite != cold_samples_.end()) {
+    auto& blocks = cold_ite->second;
+    uint64_t total = cache_values.size();
+    for (const auto& block : blocks) {
+      total += block.count();
+    }
+    while (!blocks.empty() && (total - blocks.front().count() >= max_keep_samples ||
+                               blocks.front().last_time() + max_keep_age * 1000 < now)) {
+      total -= blocks.front().count();
+      blocks.pop_front();
+    }
+    if (blocks.empty()) {
+      cold_samples_.erase(cold_ite);
+    }
+  }
 
   // Check max_keep_samples
-  auto& cache_values = cache_samples_ite->second;
   int item_remove = cache_values.size() - max_keep_samples;
   if (item_remove > 0) {
     cache_values.erase(cache_values.begin(), cache_values.begin() + item_remove);
   }
 
   // Check max_keep_age
+  auto ite = cache_values.begin();
+  while (ite != cache_values.end() && ite->last_time + max_keep_age * 1000 < now) {
+    ite++;
+  }
+  cache_values.erase(cache_values.begin(), ite);
+  if (cache_values.empty()) {
+    bump_generation(field);
+  }
+
+  if (cold_age_ > 0) {
+    seal_cold_samples(field, &cache_values, now);
+  }
+
+  return RDC_ST_OK;
+}
+
+void RdcCacheManagerImpl::seal_cold_samples(const RdcFieldKey& field,
+                                            std::vector<RdcCacheEntry>* samples, uint64_t now) {
+  if (samples->size() < 2 ||
+      (samples->front().type != INTEGER && samples->front().type != DOUBLE)) {
+    return;
+  }
+
+  auto last = samples->begin();
+  while (last + 1 != samples->end() && last->last_time + cold_age_ < now) {
+    last++;
+  }
+  if (last == samples->begin()) {
+    return;
+  }
+
+  auto& blocks = cold_samples_[field];
+  for (auto ite = samples->begin(); ite != last; ite++) {
+    if (blocks.empty() || blocks.back().full() || blocks.back().type() != ite->type) {
+      blocks.emplace_back(ite->type);
+    }
+    blocks.back().append(ite->last_time, ite->value);
+  }
+  samples->erase(samples->begin(), last);
+  // Give back the memory of the moved samples
+  if (samples->capacity() > 2 * samples->size()) {
+    samples->shrink_to_fit();
+  }
+}
+
+void RdcCacheManagerImpl::trim_rollups(RdcFieldRollups* rollups, uint64_t now) {
+  for (size_t t = 0; t < rollups->tiers.size() && t < rollup_tiers_.size(); t++) {
+    auto& buckets = rollups->tiers[t];
+    const RdcRollupTier& tier = rollup_tiers_[t];
+    while (!buckets.empty() && buckets.front().start_time + tier.width + tier.retention <= now) {
+      buckets.pop_front();
+    }
+  }
+}
+
+void RdcCacheManagerImpl::update_rollups(const RdcFieldKey& field, const rdc_field_value& value) {
+  if (rollup_tiers_.empty() || (value.type != INTEGER && value.type != DOUBLE)) {
+    return;
+  }
+
+  double sample =
+      value.type == INTEGER ? static_cast<double>(value.value.l_int) : value.value.dbl;
+  auto rollups_ite = rollups_.find(field);
+  if (rollups_ite == rollups_.end()) {
+    RdcFieldRollups empty;
+    empty.first_time = value.ts;
+    empty.tiers.resize(rollup_tiers_.size());
+    rollups_ite = rollups_.insert({field, empty}).first;
+  }
+  RdcFieldRollups& rollups = rollups_ite->second;
+
+  for (size_t t = 0; t < rollup_tiers_.size(); t++) {
+    auto& buckets = rollups.tiers[t];
+    uint64_t start_time = value.ts - value.ts % rollup_tiers_[t].width;
+    if (buckets.empty() || buckets.back().start_time < start_time) {
+      buckets.push_back({start_time, value.ts, 1, sample, sample, sample, sample});
+    } else if (buckets.back().start_time == start_time) {
+      RdcRollupBucket& bucket = buckets.back();
+      bucket.count++;
+      bucket.min_value = std::min(bucket.min_value, sample);
+      bucket.max_value = std::max(bucket.max_value, sample);
+      bucket.sum += sample;
+      if (value.ts >= bucket.last_time) {
+        bucket.last_time = value.ts;
+        bucket.last_value = sample;
+      }
+    }
+    // A sample older than the newest bucket arrived too late and is skipped
+  }
+  trim_rollups(&rollups, value.ts);
+}
+
+rdc_status_t RdcCacheManagerImpl::rdc_field_get_rollup(uint32_t gpu_index, rdc_field_t field_id,
+                                                       uint64_t start_ts, uint64_t end_ts,
+                                                       rdc_field_rollups_t* rollups) {
+  if (rollups == nullptr || start_ts > end_ts) {
+    return RDC_ST_BAD_PARAMETER;
+  }
+
+  std::lock_guard<std::mutex> guard(cache_mutex_);
+  RdcFieldKey field{gpu_index, field_id};
+
+  // The candidates are the raw samples, then each tier from finest to
+  // coarsest. Pick the first one which reaches back to start_ts and fits.
+  struct Candidate {
+    int tier;         //!< -1 for the raw samples
+    uint64_t oldest;  //!< The oldest sample the candidate holds
+    size_t first;
+    size_t count;
+  };
+  std::vector<Candidate> candidates;
+
+  // The sealed blocks hold the oldest raw samples. Only the blocks at the
+  // edges of the range are decoded to count them.
+  uint64_t raw_oldest = std::numeric_limits<uint64_t>::max();
+  size_t raw_count = 0;
+  size_t cold_first = 0;
+  size_t cold_last = 0;
+  auto cold_ite = cold_samples_.find(field);
+  if (cold_ite != cold_samples_.end() && !cold_ite->second.empty()) {
+    const auto& blocks = cold_ite->second;
+    auto first = std::partition_point(
+        blocks.begin(), blocks.end(),
+        [&](const RdcCompressedBlock& block) { return block.last_time() < start_ts; });
+    auto last = std::partition_point(
+        first, blocks.end(),
+        [&](const RdcCompressedBlock& block) { return block.first_time() <= end_ts; });
+    cold_first = first - blocks.begin();
+    cold_last = last - blocks.begin();
+    for (auto block = first; block != last; block++) {
+      if (block->first_time() >= start_ts && block->last_time() <= end_ts) {
+        raw_count += block->count();
+        continue;
+      }
+      RdcCompressedBlock::Reader reader(*block);
+      uint64_t ts = 0;
+      rdc_field_value_data value;
+      while (reader.next(&ts, &value) && ts <= end_ts) {
+        raw_count += ts >= start_ts ? 1 : 0;
+      }
+    }
+    raw_oldest = blocks.front().first_time();
+  }
+
+  size_t hot_first = 0;
+  auto samples_ite = cache_samples_.find(field);
+  if (samples_ite != cache_samples_.end() && !samples_ite->second.empty() &&
+      (samples_ite->second.front().type == INTEGER ||
+       samples_ite->second.front().type == DOUBLE)) {
+    const auto& samples = samples_ite->second;
+    auto first = std::lower_bound(
+        samples.begin(), samples.end(), start_ts,
+        [](const RdcCacheEntry& entry, uint64_t ts) { return entry.last_time < ts; });
+    auto last = std::upper_bound(
+        first, samples.end(), end_ts,
+        [](uint64_t ts, const RdcCacheEntry& entry) { return ts < entry.last_time; });
+    hot_first = first - samples.begin();
+    raw_count += last - first;
+    raw_oldest = std::min(raw_oldest, samples.front().last_time);
+  }
+  if (raw_count > 0) {
+    candidates.push_back({-1, raw_oldest, hot_first, raw_count});
+  }
+
+  auto rollups_ite = rollups_.find(field);
+  if (rollups_ite != rollups_.end()) {
+    const RdcFieldRollups& rollups = rollups_ite->second;
+    for (size_t t = 0; t < rollups.tiers.size(); t++) {
+      const auto& buckets = rollups.tiers[t];
+      uint64_t width = rollup_tiers_[t].width;
+      // The buckets overlapping [start_ts, end_ts]
+      auto first = std::partition_point(
+          buckets.begin(), buckets.end(),
+          [&](const RdcRollupBucket& bucket) { return bucket.start_time + width <= start_ts; });
+      auto last = std::partition_point(
+          first, buckets.end(),
+          [&](const RdcRollupBucket& bucket) { return bucket.start_time <= end_ts; });
+      if (first != last) {
+        // A bucket starts before its first sample, which matters until the
+        // tier drops its first bucket
+        candidates.push_back({static_cast<int>(t),
+                              std::max(buckets.front().start_time, rollups.first_time),
+                              static_cast<size_t>(first - buckets.begin()),
+                              static_cast<size_t>(last - first)});
+      }
+    }
+  }
+
+  if (candidates.empty()) {
+    return RDC_ST_NOT_FOUND;
+  }
+
+  // Otherwise the one reaching back the furthest, or the coarsest
+  const Candidate* chosen = nullptr;
+  const Candidate* furthest = nullptr;
+  for (const Candidate& candidate : candidates) {
+    if (candidate.count > RDC_MAX_ROLLUP_BUCKETS) {
+      continue;
+    }
+    if (candidate.oldest <= start_ts) {
+      chosen = &candidate;
+      break;
+    }
+    if (furthest == nullptr || candidate.oldest < furthest->oldest) {
+      furthest = &candidate;
+    }
+  }
+  if (chosen == nullptr) {
+    chosen = furthest != nullptr ? furthest : &candidates.back();
+  }
+
+  rollups->num_buckets = 0;
+  size_t count = std::min(chosen->count, static_cast<size_t>(RDC_MAX_ROLLUP_BUCKETS));
+  if (chosen->tier < 0) {
+    rollups->resolution_ms = 0;
+    auto emit = [&](uint64_t ts, rdc_field_type_t type, const rdc_field_value_data& value) {
+      double sample = type == INTEGER ? static_cast<double>(value.l_int) : value.dbl;
+      rollups->buckets[rollups->num_buckets++] = {ts, ts, 1, sample, sample, sample, sample};
+    };
+    for (size_t b = cold_first; b < cold_last && rollups->num_buckets < count; b++) {
+      const RdcCompressedBlock& block = cold_ite->second[b];
+      RdcCompressedBlock::Reader reader(block);
+      uint64_t ts = 0;
+      rdc_field_value_data value;
+      while (rollups->num_buckets < count && reader.next(&ts, &value) && ts <= end_ts) {
+        if (ts >= start_ts) {
+          emit(ts, block.type(), value);
+        }
+      }
+    }
+    if (samples_ite != cache_samples_.end()) {
+      const auto& samples = samples_ite->second;
+      for (size_t i = chosen->first; i < samples.size() && rollups->num_buckets < count &&
+                                     samples[i].last_time <= end_ts;
+           i++) {
+        emit(samples[i].last_time, samples[i].type, samples[i].value);
+      }
+    }
+  } else {
+    rollups->resolution_ms = rollup_tiers_[chosen->tier].width;
+    const auto& buckets = rollups_ite->second.tiers[chosen->tier];
+    for (size_t i = chosen->first; i < chosen->first + count; i++) {
+      const RdcRollupBucket& bucket = buckets[i];
+      rollups->buckets[rollups->num_buckets++] = {
+          bucket.start_time, bucket.last_time, bucket.count,     bucket.min_value,
+          bucket.max_value,  bucket.sum,       bucket.last_value};
+    }
+  }
+
+  return RDC_ST_OK;
+}
+
+namespace {
+
+// The samples of one GPU among those gathered for a field
+struct GpuSampleRange {
+  uint32_t gpu_index;
+  size_t first;
+  size_t count;
+};
+
+// Four partial sums, so the compiler can keep them in a vector register
+// without -ffast-math reordering a single running sum
+double sum_values(const double* values, size_t count) {
+  double partial[4] = {0, 0, 0, 0};
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    partial[0] += values[i];
+    partial[1] += values[i + 1];
+    partial[2] += values[i + 2];
+    partial[3] += values[i + 3];
+  }
+  for (; i < count; i++) {
+    partial[0] += values[i];
+  }
+  return (partial[0] + partial[1]) + (partial[2] + partial[3]);
+}
+
+// The index of the first smallest or largest value. The branchless loop
+// vectorizes, the index is then found in a second pass.
+size_t extreme_index(const double* values, size_t count, bool largest) {
+  double best = values[0];
+  if (largest) {
+    for (size_t i = 1; i < count; i++) {
+      best = values[i] > best ? values[i] : best;
+    }
+  } else {
+    for (size_t i = 1; i < count; i++) {
+      best = values[i] < best ? values[i] : best;
+    }
+  }
+  return std::find(values, values + count, best) - values;
+}
+
+}  // namespace
+
+void RdcCacheManagerImpl::gather_samples(const RdcFieldKey& field, uint64_t start_ts,
+                                         bool latest_only, std::vector<double>* values,
+                                         std::vector<uint64_t>* times) {
+  auto append = [&](uint64_t ts, rdc_field_type_t type, const rdc_field_value_data& value) {
+    if (type != INTEGER && type != DOUBLE) {
+      return;
+    }
+    double sample = type == INTEGER ? static_cast<double>(value.l_int) : value.dbl;
+    if (std::isnan(sample)) {
+      return;
+    }
+    values->push_back(sample);
+    times->push_back(ts);
+  };
+
+  // The latest sample is never sealed, see seal_cold_samples
+  auto samples_ite = cache_samples_.find(field);
+  if (latest_only) {
+    if (samples_ite != cache_samples_.end() && !samples_ite->second.empty()) {
+      const RdcCacheEntry& entry = samples_ite->second.back();
+      append(entry.last_time, entry.type, entry.value);
+    }
+    return;
+  }
+
+  auto cold_ite = cold_samples_.find(field);
+  if (cold_ite != cold_samples_.end()) {
+    const auto& blocks = cold_ite->second;
+    auto block = std::partition_point(blocks.begin(), blocks.end(),
+                                      [&](const RdcCompressedBlock& b) {
+                                        return b.last_time() < start_ts;
+                                      });
+    for (; block != blocks.end(); block++) {
+      RdcCompressedBlock::Reader reader(*block);
+      uint64_t ts = 0;
+      rdc_field_value_data value;
+      while (reader.next(&ts, &value)) {
+        if (ts >= start_ts) {
+          append(ts, block->type(), value);
+        }
+      }
+    }
+  }
+
+  if (samples_ite != cache_samples_.end()) {
+    const auto& samples = samples_ite->second;
+    auto first = std::lower_bound(
+        samples.begin(), samples.end(), start_ts,
+        [](const RdcCacheEntry& entry, uint64_t ts) { return entry.last_time < ts; });
+    for (; first != samples.end(); first++) {
+      append(first->last_time, first->type, first->value);
+    }
+  }
+}
+
+rdc_status_t RdcCacheManagerImpl::rdc_field_get_group_aggregate(
+    const std::vector<uint32_t>& gpu_indexes, const std::vector<rdc_field_t>& field_ids,
+    uint64_t window_ms, const rdc_aggregate_spec_t* specs, uint32_t num_specs,
+    rdc_group_aggregate_t* aggregate) {
+  if (specs == nullptr || aggregate == nullptr || num_specs > RDC_MAX_GROUP_AGGREGATE_OPS ||
+      field_ids.size() > RDC_MAX_FIELD_IDS_PER_FIELD_GROUP) {
+    return RDC_ST_BAD_PARAMETER;
+  }
+  for (uint32_t s = 0; s < num_specs; s++) {
+    // Written so that a NaN percentile is rejected too
+    if (specs[s].op > RDC_AGGREGATE_PERCENTILE ||
+        (specs[s].op == RDC_AGGREGATE_PERCENTILE &&
+         !(specs[s].percentile >= 0 && specs[s].percentile <= 100))) {
+      return RDC_ST_BAD_PARAMETER;
+    }
+  }
+
   struct timeval tv;
   gettimeofday(&tv, NULL);
   uint64_t now = static_cast<uint64_t>(tv.tv_sec) * 1000 + tv.tv_usec / 1000;
-
-  auto ite = cache_values.begin();
-  while (ite != cache_values.end()) {
-    if (ite->last_time + max_keep_age * 1000 >= now) {
-      break;
-    } else {
-      ite = cache_values.erase(ite);
+  uint64_t start_ts = window_ms < now ? now - window_ms : 0;
+
+  // The samples are gathered into flat arrays under the lock, and reduced
+  // after it is released
+  std::vector<double> values;
+  std::vector<uint64_t> times;
+  std::vector<GpuSampleRange> gpus;
+  std::vector<double> sorted;
+  aggregate->num_values = 0;
+  for (rdc_field_t field_id : field_ids) {
+    values.clear();
+    times.clear();
+    gpus.clear();
+    sorted.clear();
+    do {  //< lock guard for thread safe
+      std::lock_guard<std::mutex> guard(cache_mutex_);
+      for (uint32_t gpu_index : gpu_indexes) {
+        size_t first = values.size();
+        gather_samples({gpu_index, field_id}, start_ts, window_ms == 0, &values, &times);
+        if (values.size() > first) {
+          gpus.push_back({gpu_index, first, values.size() - first});
+        }
+      }
+    } while (0);
+
+    size_t total = values.size();
+    uint64_t newest_ts = total > 0 ? *std::max_element(times.begin(), times.end()) : 0;
+    auto gpu_of = [&](size_t i) {
+      for (const GpuSampleRange& gpu : gpus) {
+        if (i < gpu.first + gpu.count) {
+          return gpu.gpu_index;
+        }
+      }
+      return gpus.back().gpu_index;
+    };
+
+    for (uint32_t s = 0; s < num_specs; s++) {
+      rdc_group_aggregate_value_t& out = aggregate->values[aggregate->num_values++];
+      out = {};
+      out.field_id = field_id;
+      out.spec = specs[s];
+      out.num_gpus = gpus.size();
+      out.num_samples = total;
+      if (total == 0) {
+        out.status = RDC_ST_NOT_FOUND;
+        continue;
+      }
+      out.status = RDC_ST_OK;
+      out.ts = newest_ts;
+
+      switch (specs[s].op) {
+        case RDC_AGGREGATE_SUM:
+        case RDC_AGGREGATE_AVG: {
+          double sum = 0;
+          for (const GpuSampleRange& gpu : gpus) {
+            sum += sum_values(values.data() + gpu.first, gpu.count) / gpu.count;
+          }
+          out.value = specs[s].op == RDC_AGGREGATE_SUM ? sum : sum / gpus.size();
+          break;
+        }
+        case RDC_AGGREGATE_MIN:
+        case RDC_AGGREGATE_MAX: {
+          size_t i = extreme_index(values.data(), total, specs[s].op == RDC_AGGREGATE_MAX);
+          out.value = values[i];
+          out.gpu_index = gpu_of(i);
+          out.ts = times[i];
+          break;
+        }
+        case RDC_AGGREGATE_LAST: {
+          size_t i = std::max_element(times.begin(), times.end()) - times.begin();
+          out.value = values[i];
+          out.gpu_index = gpu_of(i);
+          out.ts = times[i];
+          break;
+        }
+        case RDC_AGGREGATE_PERCENTILE: {
+          // Sorted once for all the percentiles of the field, nearest rank
+          if (sorted.empty()) {
+            sorted = values;
+            std::sort(sorted.begin(), sorted.end());
+          }
+          size_t rank = static_cast<size_t>(std::ceil(specs[s].percentile / 100 * total));
+          out.value = sorted[std::min(std::max<size_t>(rank, 1), total) - 1];
+          break;
+        }
+        default:
+          out.status = RDC_ST_BAD_PARAMETER;
+          break;
+      }
     }
   }
 
@@ -154,15 +1015,71 @@ std::string RdcCacheManagerImpl::get_cache_stats() {
   return strstream.str();
 }
 
+void RdcCacheManagerImpl::get_cache_usage(uint64_t* num_samples, uint64_t* num_bytes) {
+  uint64_t samples = 0;
+  uint64_t bytes = 0;
+  do {  //< lock guard for thread safe
+    std::lock_guard<std::mutex> guard(cache_mutex_);
+    for (auto ite = cache_samples_.begin(); ite != cache_samples_.end(); ite++) {
+      samples += ite->second.size();
+      // The map node plus the reserved vector storage
+      bytes += sizeof(RdcCacheSamples::value_type) + 4 * sizeof(void*) +
+               ite->second.capacity() * sizeof(RdcCacheEntry);
+    }
+    for (auto ite = cold_samples_.begin(); ite != cold_samples_.end(); ite++) {
+      bytes += sizeof(RdcColdSamples::value_type) + 4 * sizeof(void*);
+      for (const auto& block : ite->second) {
+        samples += block.count();
+        bytes += sizeof(block) + block.size_bytes();
+      }
+    }
+    for (auto ite = rollups_.begin(); ite != rollups_.end(); ite++) {
+      bytes += sizeof(RdcRollupCache::value_type) + 4 * sizeof(void*);
+      for (const auto& buckets : ite->second.tiers) {
+        bytes += sizeof(buckets) + buckets.size() * sizeof(RdcRollupBucket);
+      }
+    }
+  } while (0);
+
+  if (num_samples != nullptr) {
+    *num_samples = samples;
+  }
+  if (num_bytes != nullptr) {
+    *num_bytes = bytes;
+  }
+}
+
 rdc_status_t RdcCacheManagerImpl::rdc_update_cache(uint32_t gpu_index,
                                                    const rdc_field_value& value) {
+  RDC_PERF_SCOPE("cache_ingest");
+  RDC_PIPELINE_SCOPE("cache_ingest", gpu_index, value.field_id);
+  std::lock_guard<std::mutex> guard(cache_mutex_);
+  cache_sample({gpu_index, value.field_id}, value);
+
+  if (store_ != nullptr) {
+    char buf[sizeof(RdcPersistSample) + sizeof(rdc_field_value_data)];
+    RdcPersistSample sample{gpu_index, static_cast<uint32_t>(value.field_id), value.ts,
+                            static_cast<uint32_t>(value.type), 0};
+    size_t value_bytes = sizeof(value.value.l_int);
+    if (value.type == STRING) {
+      value_bytes = strnlen(value.value.str, RDC_MAX_STR_LENGTH - 1);
+    } else if (value.type == BLOB) {
+      value_bytes = sizeof(value.value);
+    }
+    memcpy(buf, &sample, sizeof(sample));
+    memcpy(buf + sizeof(sample), &value.value, value_bytes);
+    persist_record(RDC_PERSIST_SAMPLE, buf, sizeof(sample) + value_bytes);
+  }
+
+  return RDC_ST_OK;
+}
+
+void RdcCacheManagerImpl::cache_sample(const RdcFieldKey& field, const rdc_field_value& value) {
   RdcCacheEntry entry;
   entry.last_time = value.ts;
   entry.value = value.value;
   entry.type = value.type;
 
-  std::lock_guard<std::mutex> guard(cache_mutex_);
-  RdcFieldKey field{gpu_index, value.field_id};
   auto cache_samples_ite = cache_samples_.find(field);
   if (cache_samples_ite == cache_samples_.end()) {
     std::vector<RdcCacheEntry> ve;
@@ -171,19 +1088,29 @@ rdc_status_t RdcCacheManagerImpl::rdc_update_cache(uint32_t gpu_index,
   } else {
     cache_samples_ite->second.push_back(entry);
   }
-
-  return RDC_ST_OK;
+  update_rollups(field, value);
+  bump_generation(field);
 }
 
 rdc_status_t RdcCacheManagerImpl::rdc_job_remove(const char job_id[64]) {
   std::lock_guard<std::mutex> guard(cache_mutex_);
   cache_jobs_.erase(job_id);
+  if (store_ != nullptr) {
+    char id[64] = {0};
+    strncpy_with_null(id, job_id, sizeof(id));
+    dirty_jobs_.erase(id);
+    persist_record(RDC_PERSIST_JOB_REMOVE, id, sizeof(id));
+  }
   return RDC_ST_OK;
 }
 
 rdc_status_t RdcCacheManagerImpl::rdc_job_remove_all() {
   std::lock_guard<std::mutex> guard(cache_mutex_);
   cache_jobs_.clear();
+  if (store_ != nullptr) {
+    dirty_jobs_.clear();
+    persist_record(RDC_PERSIST_JOB_REMOVE_ALL, nullptr, 0);
+  }
   return RDC_ST_OK;
 }
 
@@ -205,6 +1132,8 @@ rdc_status_t RdcCacheManagerImpl::rdc_update_job_stats(uint32_t gpu_index,
   if (fsummary == gpu_iter->second.field_summaries.end()) {
     return RDC_ST_NOT_FOUND;
   }
+  fsummary->second.sketch.add(value.value.l_int);
+  gpu_iter->second.timelines[value.field_id].add(value.ts, value.value.l_int);
   if (fsummary->second.count == 0) {  // first item
     fsummary->second.count = 1;
     fsummary->second.max_value = value.value.l_int;
@@ -218,6 +1147,9 @@ rdc_status_t RdcCacheManagerImpl::rdc_update_job_stats(uint32_t gpu_index,
     // https://www.johndcook.com/blog/standard_deviation/
     fsummary->second.old_s = 0;
     fsummary->second.old_m = fsummary->second.new_m = value.value.l_int;
+    if (store_ != nullptr) {
+      dirty_jobs_.insert(job_id);
+    }
     return RDC_ST_OK;
   }
   if (value.field_id == RDC_FI_POWER_USAGE) {
@@ -241,15 +1173,20 @@ rdc_status_t RdcCacheManagerImpl::rdc_update_job_stats(uint32_t gpu_index,
       (value.value.l_int - fsummary->second.old_m) * (value.value.l_int - fsummary->second.new_m);
   fsummary->second.old_m = fsummary->second.new_m;
   fsummary->second.old_s = fsummary->second.new_s;
+  if (store_ != nullptr) {
+    dirty_jobs_.insert(job_id);
+  }
 
   return RDC_ST_OK;
 }
 
 void RdcCacheManagerImpl::set_summary(const FieldSummaryStats& stats, rdc_stats_summary_t& gpu,
-                                      rdc_stats_summary_t& summary, unsigned int adjuster) {
+                                      rdc_stats_summary_t& summary, unsigned int adjuster,
+                                      RdcQuantileSketch* merged) {
   if (stats.count == 0) {
     gpu.min_value = std::numeric_limits<uint64_t>::max();
     gpu.max_value = gpu.average = 0;
+    gpu.p50 = gpu.p90 = gpu.p95 = gpu.p99 = 0;
     return;
   }
 
@@ -265,47 +1202,70 @@ void RdcCacheManagerImpl::set_summary(const FieldSummaryStats& stats, rdc_stats_
   gpu.standard_deviation =
       std::sqrt((stats.count > 1) ? stats.new_s / (stats.count - 1) : 0.0) / adjuster;
   summary.standard_deviation += gpu.standard_deviation;
+
+  set_percentiles(stats.sketch, adjuster, &gpu);
+  // Redone for every GPU, the last one has merged them all
+  merged->merge(stats.sketch);
+  set_percentiles(*merged, adjuster, &summary);
 }
 
 rdc_status_t RdcCacheManagerImpl::rdc_job_get_stats(const char jobId[64],
                                                     const rdc_gpu_gauges_t& gpu_gauges,
                                                     rdc_job_info_t* p_job_info) {
-  std::lock_guard<std::mutex> guard(cache_mutex_);
-  auto job_stats = cache_jobs_.find(jobId);
+  RDC_LOG(RDC_DEBUG, "rdc_job_get_stats for job " << jobId);
+  do {  //< lock guard for thread safe
+    std::lock_guard<std::mutex> guard(cache_mutex_);
+    auto job_stats = cache_jobs_.find(jobId);
+    if (job_stats != cache_jobs_.end()) {
+      job_stats->second.last_used = ++job_use_count_;
+      return fill_job_info(job_stats->second, gpu_gauges, p_job_info);
+    }
+  } while (0);
 
-  if (job_stats == cache_jobs_.end()) {
-    return RDC_ST_NOT_FOUND;
+  // A stopped job which is no longer in memory
+  if (job_store_ != nullptr) {
+    return job_store_->get(jobId, p_job_info);
   }
+  return RDC_ST_NOT_FOUND;
+}
 
+rdc_status_t RdcCacheManagerImpl::fill_job_info(const RdcJobStatsCacheEntry& job,
+                                                const rdc_gpu_gauges_t& gpu_gauges,
+                                                rdc_job_info_t* p_job_info) {
   //< Init the summary info
-  bool is_job_stopped = (job_stats->second.end_time != 0);
-  RDC_LOG(RDC_DEBUG, "rdc_job_get_stats for job " << jobId);
+  bool is_job_stopped = (job.end_time != 0);
   auto& summary_info = p_job_info->summary;
-  summary_info.start_time = job_stats->second.start_time;
-  if (job_stats->second.end_time == 0) {
+  summary_info.start_time = job.start_time;
+  if (job.end_time == 0) {
     summary_info.end_time = time(nullptr);
   } else {
-    summary_info.end_time = job_stats->second.end_time;
+    summary_info.end_time = job.end_time;
   }
   summary_info.energy_consumed = 0;
   summary_info.max_gpu_memory_used = 0;
   summary_info.ecc_correct = 0;
   summary_info.ecc_uncorrect = 0;
-  summary_info.power_usage = {0, std::numeric_limits<uint64_t>::max(), 0, 0};
-  summary_info.pcie_tx = {0, std::numeric_limits<uint64_t>::max(), 0, 0};
-  summary_info.pcie_rx = {0, std::numeric_limits<uint64_t>::max(), 0, 0};
-  summary_info.gpu_temperature = {0, std::numeric_limits<uint64_t>::max(), 0, 0};
-  summary_info.memory_clock = {0, std::numeric_limits<uint64_t>::max(), 0, 0};
-  summary_info.gpu_clock = {0, std::numeric_limits<uint64_t>::max(), 0, 0};
-  summary_info.gpu_utilization = {0, std::numeric_limits<uint64_t>::max(), 0, 0};
-  summary_info.memory_utilization = {0, std::numeric_limits<uint64_t>::max(), 0, 0};
-
-  p_job_info->num_gpus = job_stats->second.gpu_stats.size();
+  const rdc_stats_summary_t empty_summary = {0, std::numeric_limits<uint64_t>::max(), 0, 0,
+                                             0, 0, 0, 0};
+  summary_info.power_usage = empty_summary;
+  summary_info.pcie_tx = empty_summary;
+  summary_info.pcie_rx = empty_summary;
+  summary_info.gpu_temperature = empty_summary;
+  summary_info.memory_clock = empty_summary;
+  summary_info.gpu_clock = empty_summary;
+  summary_info.gpu_utilization = empty_summary;
+  summary_info.memory_utilization = empty_summary;
+
+  p_job_info->num_gpus = job.gpu_stats.size();
+  // The sketches of every GPU merged per field, for the summary percentiles.
+  // The memory ones are scaled by the total of the last GPU, as the GPUs of
+  // a node have the same memory.
+  std::map<uint32_t, RdcQuantileSketch> merged;
 
   //< Populate information for each GPUs
 
-  auto gpus = job_stats->second.gpu_stats.begin();
-  for (; gpus != job_stats->second.gpu_stats.end(); gpus++) {
+  auto gpus = job.gpu_stats.begin();
+  for (; gpus != job.gpu_stats.end(); gpus++) {
     auto& gpu_info = p_job_info->gpus[gpus->first];
     gpu_info.start_time = summary_info.start_time;
     gpu_info.end_time = summary_info.end_time;
@@ -342,26 +1302,34 @@ rdc_status_t RdcCacheManagerImpl::rdc_job_get_stats(const char jobId[64],
 
     auto ite = gpus->second.field_summaries.begin();
     for (; ite != gpus->second.field_summaries.end(); ite++) {
+      RdcQuantileSketch* merged_sketch = &merged[ite->first];
       if (ite->first == RDC_FI_POWER_USAGE) {
-        set_summary(ite->second, gpu_info.power_usage, summary_info.power_usage, 1000000);
+        set_summary(ite->second, gpu_info.power_usage, summary_info.power_usage, 1000000,
+                    merged_sketch);
       } else if (ite->first == RDC_FI_GPU_MEMORY_USAGE) {
         set_summary(ite->second, gpu_info.memory_utilization, summary_info.memory_utilization,
-                    tmemory / 100);
+                    tmemory / 100, merged_sketch);
         gpu_info.max_gpu_memory_used = ite->second.max_value;
         summary_info.max_gpu_memory_used =
             std::max(summary_info.max_gpu_memory_used, gpu_info.max_gpu_memory_used);
       } else if (ite->first == RDC_FI_GPU_CLOCK) {
-        set_summary(ite->second, gpu_info.gpu_clock, summary_info.gpu_clock, 1000000);
+        set_summary(ite->second, gpu_info.gpu_clock, summary_info.gpu_clock, 1000000,
+                    merged_sketch);
       } else if (ite->first == RDC_FI_GPU_UTIL) {
-        set_summary(ite->second, gpu_info.gpu_utilization, summary_info.gpu_utilization, 1);
+        set_summary(ite->second, gpu_info.gpu_utilization, summary_info.gpu_utilization, 1,
+                    merged_sketch);
       } else if (ite->first == RDC_FI_GPU_TEMP) {
-        set_summary(ite->second, gpu_info.gpu_temperature, summary_info.gpu_temperature, 1000);
+        set_summary(ite->second, gpu_info.gpu_temperature, summary_info.gpu_temperature, 1000,
+                    merged_sketch);
       } else if (ite->first == RDC_FI_MEM_CLOCK) {
-        set_summary(ite->second, gpu_info.memory_clock, summary_info.memory_clock, 1000000);
+        set_summary(ite->second, gpu_info.memory_clock, summary_info.memory_clock, 1000000,
+                    merged_sketch);
       } else if (ite->first == RDC_FI_PCIE_TX) {
-        set_summary(ite->second, gpu_info.pcie_tx, summary_info.pcie_tx, 1024 * 1024);
+        set_summary(ite->second, gpu_info.pcie_tx, summary_info.pcie_tx, 1024 * 1024,
+                    merged_sketch);
       } else if (ite->first == RDC_FI_PCIE_RX) {
-        set_summary(ite->second, gpu_info.pcie_rx, summary_info.pcie_rx, 1024 * 1024);
+        set_summary(ite->second, gpu_info.pcie_rx, summary_info.pcie_rx, 1024 * 1024,
+                    merged_sketch);
       }
     }
   }
@@ -383,6 +1351,92 @@ void RdcCacheManagerImpl::set_average_summary(rdc_stats_summary_t& summary, uint
   summary.standard_deviation = summary.standard_deviation / num_gpus;
 }
 
+rdc_status_t RdcCacheManagerImpl::rdc_job_get_timeline(const char job_id[64], uint32_t gpu_index,
+                                                       rdc_field_t field,
+                                                       const rdc_gpu_gauges_t& gpu_gauges,
+                                                       rdc_job_timeline_t* timeline) {
+  if (timeline == nullptr) {
+    return RDC_ST_BAD_PARAMETER;
+  }
+
+  uint64_t memory_total = 0;
+  if (field == RDC_FI_GPU_MEMORY_USAGE) {
+    auto gauge = gpu_gauges.find({gpu_index, RDC_FI_GPU_MEMORY_TOTAL});
+    if (gauge == gpu_gauges.end() || gauge->second < 100) {
+      RDC_LOG(RDC_ERROR, "Cannot find the total memory");
+      return RDC_ST_BAD_PARAMETER;
+    }
+    memory_total = gauge->second;
+  }
+  double adjuster = job_stats_adjuster(field, memory_total);
+
+  RdcJobTimeline source;
+  bool in_cache = false;
+  do {  //< lock guard for thread safe
+    std::lock_guard<std::mutex> guard(cache_mutex_);
+    auto job_stats = cache_jobs_.find(job_id);
+    if (job_stats == cache_jobs_.end()) {
+      break;
+    }
+    in_cache = true;
+    job_stats->second.last_used = ++job_use_count_;
+    auto gpu = job_stats->second.gpu_stats.find(gpu_index);
+    if (gpu == job_stats->second.gpu_stats.end()) {
+      return RDC_ST_NOT_FOUND;
+    }
+    auto ite = gpu->second.timelines.find(field);
+    if (ite == gpu->second.timelines.end()) {
+      return RDC_ST_NOT_FOUND;
+    }
+    source = ite->second;
+  } while (0);
+
+  // The stopped jobs evicted from the cache are read back from the job store
+  if (!in_cache) {
+    if (job_store_ == nullptr) {
+      return RDC_ST_NOT_FOUND;
+    }
+    rdc_status_t status = job_store_->get_timeline(job_id, gpu_index, field, &source);
+    if (status != RDC_ST_OK) {
+      return status;
+    }
+  }
+
+  timeline->bucket_ms = source.width();
+  timeline->num_points = source.num_buckets();
+  for (uint32_t i = 0; i < source.num_buckets(); i++) {
+    const RdcJobTimeline::Bucket& b = source.bucket(i);
+    rdc_timeline_point_t& point = timeline->points[i];
+    point.start_ts = source.start_time() + i * source.width();
+    point.count = b.count;
+    point.min_value = b.count ? b.min_value / adjuster : 0;
+    point.max_value = b.count ? b.max_value / adjuster : 0;
+    point.average = b.count ? b.sum / b.count / adjuster : 0;
+  }
+  return RDC_ST_OK;
+}
+
+rdc_status_t RdcCacheManagerImpl::rdc_job_get_gpus(const char job_id[64],
+                                                   std::vector<uint32_t>* gpu_indexes,
+                                                   bool* is_running) {
+  if (gpu_indexes == nullptr || is_running == nullptr) {
+    return RDC_ST_BAD_PARAMETER;
+  }
+
+  std::lock_guard<std::mutex> guard(cache_mutex_);
+  auto job_stats = cache_jobs_.find(job_id);
+  if (job_stats == cache_jobs_.end()) {
+    return RDC_ST_NOT_FOUND;
+  }
+
+  gpu_indexes->clear();
+  for (const auto& gpu : job_stats->second.gpu_stats) {
+    gpu_indexes->push_back(gpu.first);
+  }
+  *is_running = job_stats->second.end_time == 0;
+  return RDC_ST_OK;
+}
+
 rdc_status_t RdcCacheManagerImpl::rdc_job_start_stats(const char job_id[64],
                                                       const rdc_group_info_t& ginfo,
                                                       const rdc_field_group_info_t& finfo,
@@ -398,6 +1452,7 @@ rdc_status_t RdcCacheManagerImpl::rdc_job_start_stats(const char job_id[64],
       FieldSummaryStats s;
       s.count = 0;
       s.max_value = s.min_value = s.total_value = 0;
+      s.last_time = 0;
       gstats.field_summaries.insert({finfo.field_ids[j], s});
     }
 
@@ -415,39 +1470,109 @@ rdc_status_t RdcCacheManagerImpl::rdc_job_start_stats(const char job_id[64],
   }
 
   std::lock_guard<std::mutex> guard(cache_mutex_);
+  cacheEntry.last_used = ++job_use_count_;
   // Remove the old stats if it exists
   cache_jobs_.erase(job_id);
   cache_jobs_.insert({job_id, cacheEntry});
+  if (store_ != nullptr) {
+    persist_job(job_id, cacheEntry);
+  }
   return RDC_ST_OK;
 }
 
 rdc_status_t RdcCacheManagerImpl::rdc_job_stop_stats(const char job_id[64],
                                                      const rdc_gpu_gauges_t& gpu_gauges) {
-  std::lock_guard<std::mutex> guard(cache_mutex_);
-  auto job_stats = cache_jobs_.find(job_id);
+  // Filled under the lock, written to the job store after it
+  std::unique_ptr<rdc_job_info_t> job_info;
+  std::vector<uint32_t> gpu_indexes;
+  RdcJobTimelines timelines;
+  do {  //< lock guard for thread safe
+    std::lock_guard<std::mutex> guard(cache_mutex_);
+    auto job_stats = cache_jobs_.find(job_id);
+
+    if (job_stats == cache_jobs_.end()) {
+      return RDC_ST_NOT_FOUND;
+    }
 
-  if (job_stats == cache_jobs_.end()) {
-    return RDC_ST_NOT_FOUND;
-  }
+    job_stats->second.end_time = std::time(nullptr);
+    job_stats->second.last_used = ++job_use_count_;
 
-  job_stats->second.end_time = std::time(nullptr);
+    // update the ecc errors
+    auto gpus = job_stats->second.gpu_stats.begin();
+    for (; gpus != job_stats->second.gpu_stats.end(); gpus++) {
+      if (gpu_gauges.find({gpus->first, RDC_FI_ECC_CORRECT_TOTAL}) != gpu_gauges.end()) {
+        gpus->second.ecc_correct_init =
+            gpu_gauges.at({gpus->first, RDC_FI_ECC_CORRECT_TOTAL}) - gpus->second.ecc_correct_init;
+      }
 
-  // update the ecc errors
-  auto gpus = job_stats->second.gpu_stats.begin();
-  for (; gpus != job_stats->second.gpu_stats.end(); gpus++) {
-    if (gpu_gauges.find({gpus->first, RDC_FI_ECC_CORRECT_TOTAL}) != gpu_gauges.end()) {
-      gpus->second.ecc_correct_init =
-          gpu_gauges.at({gpus->first, RDC_FI_ECC_CORRECT_TOTAL}) - gpus->second.ecc_correct_init;
+      if (gpu_gauges.find({gpus->first, RDC_FI_ECC_UNCORRECT_TOTAL}) != gpu_gauges.end()) {
+        gpus->second.ecc_uncorrect_init =
+            gpu_gauges.at({gpus->first, RDC_FI_ECC_UNCORRECT_TOTAL}) -
+            gpus->second.ecc_uncorrect_init;
+      }
+      gpu_indexes.push_back(gpus->first);
+    }
+    if (store_ != nullptr) {
+      persist_job(job_stats->first, job_stats->second);
     }
 
-    if (gpu_gauges.find({gpus->first, RDC_FI_ECC_UNCORRECT_TOTAL}) != gpu_gauges.end()) {
-      gpus->second.ecc_uncorrect_init = gpu_gauges.at({gpus->first, RDC_FI_ECC_UNCORRECT_TOTAL}) -
-                                        gpus->second.ecc_uncorrect_init;
+    if (job_store_ != nullptr) {
+      job_info.reset(new rdc_job_info_t);
+      if (fill_job_info(job_stats->second, gpu_gauges, job_info.get()) != RDC_ST_OK) {
+        RDC_LOG(RDC_ERROR, "The job " << job_id << " is not written to the job store");
+        job_info.reset();
+      }
+      for (const auto& gpu : job_stats->second.gpu_stats) {
+        for (const auto& timeline : gpu.second.timelines) {
+          timelines.insert({{gpu.first, timeline.first}, timeline.second});
+        }
+      }
     }
+  } while (0);
+
+  if (job_info != nullptr && job_store_->append(job_id, gpu_indexes, *job_info, timelines)) {
+    std::lock_guard<std::mutex> guard(cache_mutex_);
+    evict_stopped_jobs();
   }
 
   return RDC_ST_OK;
 }
 
+void RdcCacheManagerImpl::evict_stopped_jobs() {
+  std::vector<std::pair<uint64_t, std::string>> stopped;  // last_used, job_id
+  for (const auto& job : cache_jobs_) {
+    if (job.second.end_time != 0 && job_store_->contains(job.first)) {
+      stopped.push_back({job.second.last_used, job.first});
+    }
+  }
+  if (stopped.size() <= max_stopped_jobs_) {
+    return;
+  }
+
+  std::sort(stopped.begin(), stopped.end());
+  for (size_t i = 0; i + max_stopped_jobs_ < stopped.size(); i++) {
+    const std::string& job_id = stopped[i].second;
+    RDC_LOG(RDC_DEBUG, "Evict the stopped job " << job_id << ", it is in the job store");
+    cache_jobs_.erase(job_id);
+    if (store_ != nullptr) {
+      char id[64] = {0};
+      strncpy_with_null(id, job_id.c_str(), sizeof(id));
+      dirty_jobs_.erase(job_id);
+      persist_record(RDC_PERSIST_JOB_REMOVE, id, sizeof(id));
+    }
+  }
+}
+
+rdc_status_t RdcCacheManagerImpl::rdc_job_list(const rdc_job_filter_t& filter,
+                                               rdc_job_list_t* jobs) {
+  if (jobs == nullptr) {
+    return RDC_ST_BAD_PARAMETER;
+  }
+  if (job_store_ == nullptr) {
+    return RDC_ST_NOT_SUPPORTED;
+  }
+  return job_store_->list(filter, jobs);
+}
+
 }  // namespace rdc
 }  // namespace amd
@@ -0,0 +1,255 @@
+/*
+Copyright (c) 2024 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "rdc_lib/impl/RdcCompressedBlock.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+namespace amd {
+namespace rdc {
+
+RdcCompressedBlock::RdcCompressedBlock(rdc_field_type_t type)
+    : type_(type),
+      num_bits_(0),
+      count_(0),
+      first_time_(0),
+      last_time_(0),
+      last_delta_(0),
+      last_value_(0),
+      leading_(64),
+      trailing_(0) {}
+
+RdcCompressedBlock::RdcCompressedBlock(rdc_field_type_t type, uint32_t count, const uint8_t* data,
+                                       size_t length)
+    : type_(type),
+      bits_(data, data + length),
+      num_bits_(length * 8),
+      count_(count),
+      first_time_(0),
+      last_time_(0),
+      last_delta_(0),
+      last_value_(0),
+      leading_(64),
+      trailing_(0) {}
+
+void RdcCompressedBlock::write_bits(uint64_t bits, uint32_t num_bits) {
+  while (num_bits > 0) {
+    if (num_bits_ % 8 == 0) {
+      bits_.push_back(0);
+    }
+    uint32_t room = 8 - num_bits_ % 8;
+    uint32_t take = std::min(room, num_bits);
+    uint8_t chunk = (bits >> (num_bits - take)) & ((1u << take) - 1);
+    bits_.back() |= chunk << (room - take);
+    num_bits_ += take;
+    num_bits -= take;
+  }
+}
+
+void RdcCompressedBlock::write_timestamp(uint64_t ts) {
+  int64_t delta = static_cast<int64_t>(ts - last_time_);
+  int64_t dod = delta - last_delta_;
+  if (dod == 0) {
+    write_bits(0, 1);
+  } else if (dod >= -63 && dod <= 64) {
+    write_bits(0x2, 2);
+    write_bits(dod + 63, 7);
+  } else if (dod >= -255 && dod <= 256) {
+    write_bits(0x6, 3);
+    write_bits(dod + 255, 9);
+  } else if (dod >= -2047 && dod <= 2048) {
+    write_bits(0xe, 4);
+    write_bits(dod + 2047, 12);
+  } else {
+    write_bits(0xf, 4);
+    write_bits(static_cast<uint64_t>(dod), 64);
+  }
+  last_delta_ = delta;
+}
+
+void RdcCompressedBlock::write_double(uint64_t bits) {
+  uint64_t x = bits ^ last_value_;
+  if (x == 0) {
+    write_bits(0, 1);
+    return;
+  }
+
+  // The leading zeros must fit in 5 bits
+  uint32_t leading = std::min(__builtin_clzll(x), 31);
+  uint32_t trailing = __builtin_ctzll(x);
+  if (leading >= leading_ && trailing >= trailing_) {
+    write_bits(0x2, 2);
+    write_bits(x >> trailing_, 64 - leading_ - trailing_);
+  } else {
+    uint32_t length = 64 - leading - trailing;
+    write_bits(0x3, 2);
+    write_bits(leading, 5);
+    write_bits(length - 1, 6);
+    write_bits(x >> trailing, length);
+    leading_ = leading;
+    trailing_ = trailing;
+  }
+}
+
+void RdcCompressedBlock::write_integer(int64_t value) {
+  uint64_t delta = static_cast<uint64_t>(value) - last_value_;
+  if (delta == 0) {
+    write_bits(0, 1);
+    return;
+  }
+
+  int64_t signed_delta = static_cast<int64_t>(delta);
+  uint64_t zigzag = (delta << 1) ^ static_cast<uint64_t>(signed_delta >> 63);
+  write_bits(1, 1);
+  do {
+    uint64_t group = zigzag & 0x7f;
+    zigzag >>= 7;
+    write_bits(zigzag != 0 ? group | 0x80 : group, 8);
+  } while (zigzag != 0);
+}
+
+bool RdcCompressedBlock::append(uint64_t ts, const rdc_field_value_data& value) {
+  if (full()) {
+    return false;
+  }
+
+  uint64_t bits = 0;
+  if (type_ == DOUBLE) {
+    memcpy(&bits, &value.dbl, sizeof(bits));
+  } else {
+    bits = static_cast<uint64_t>(value.l_int);
+  }
+
+  if (count_ == 0) {
+    write_bits(ts, 64);
+    write_bits(bits, 64);
+    first_time_ = ts;
+  } else {
+    write_timestamp(ts);
+    if (type_ == DOUBLE) {
+      write_double(bits);
+    } else {
+      write_integer(static_cast<int64_t>(bits));
+    }
+  }
+  last_time_ = ts;
+  last_value_ = bits;
+  count_++;
+
+  // A full block is never written again
+  if (full()) {
+    bits_.shrink_to_fit();
+  }
+  return true;
+}
+
+RdcCompressedBlock::Reader::Reader(const RdcCompressedBlock& block)
+    : block_(block),
+      pos_(0),
+      index_(0),
+      ts_(0),
+      delta_(0),
+      value_(0),
+      leading_(0),
+      trailing_(0) {}
+
+uint64_t RdcCompressedBlock::Reader::read_bits(uint32_t num_bits) {
+  // A block read back from disk may be truncated
+  if (pos_ + num_bits > block_.num_bits_) {
+    pos_ = block_.num_bits_ + 1;
+    return 0;
+  }
+
+  uint64_t bits = 0;
+  while (num_bits > 0) {
+    uint32_t room = 8 - pos_ % 8;
+    uint32_t take = std::min(room, num_bits);
+    uint8_t chunk = (block_.bits_[pos_ / 8] >> (room - take)) & ((1u << take) - 1);
+    bits = (bits << take) | chunk;
+    pos_ += take;
+    num_bits -= take;
+  }
+  return bits;
+}
+
+bool RdcCompressedBlock::Reader::next(uint64_t* ts, rdc_field_value_data* value) {
+  if (index_ >= block_.count_) {
+    return false;
+  }
+
+  if (index_ == 0) {
+    ts_ = read_bits(64);
+    value_ = read_bits(64);
+  } else {
+    int64_t dod = 0;
+    if (read_bits(1) == 0) {
+      dod = 0;
+    } else if (read_bits(1) == 0) {
+      dod = static_cast<int64_t>(read_bits(7)) - 63;
+    } else if (read_bits(1) == 0) {
+      dod = static_cast<int64_t>(read_bits(9)) - 255;
+    } else if (read_bits(1) == 0) {
+      dod = static_cast<int64_t>(read_bits(12)) - 2047;
+    } else {
+      dod = static_cast<int64_t>(read_bits(64));
+    }
+    delta_ += dod;
+    ts_ += delta_;
+
+    if (read_bits(1) != 0) {
+      if (block_.type_ == DOUBLE) {
+        if (read_bits(1) != 0) {
+          leading_ = read_bits(5);
+          uint32_t length = read_bits(6) + 1;
+          trailing_ = 64 - leading_ - length;
+        }
+        value_ ^= read_bits(64 - leading_ - trailing_) << trailing_;
+      } else {
+        uint64_t zigzag = 0;
+        uint32_t shift = 0;
+        uint64_t group = 0;
+        do {
+          group = read_bits(8);
+          zigzag |= (group & 0x7f) << shift;
+          shift += 7;
+        } while ((group & 0x80) != 0);
+        value_ += (zigzag >> 1) ^ (~(zigzag & 1) + 1);
+      }
+    }
+  }
+  if (pos_ > block_.num_bits_) {
+    return false;
+  }
+  index_++;
+
+  *ts = ts_;
+  if (block_.type_ == DOUBLE) {
+    memcpy(&value->dbl, &value_, sizeof(value_));
+  } else {
+    value->l_int = static_cast<int64_t>(value_);
+  }
+  return true;
+}
+
+}  // namespace rdc
+}  // namespace amd
@@ -0,0 +1,525 @@
+/*
+Copyright (c) 2024 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "rdc_lib/impl/RdcDerivedFields.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <fstream>
+#include <iterator>
+#include <set>
+
+#include "common/rdc_fields_supported.h"
+#include "rdc_lib/RdcLogger.h"
+
+namespace amd {
+namespace rdc {
+
+namespace {
+
+//!< Bounds the operand stack of a program, so it can live on the stack
+const size_t kMaxStackDepth = 32;
+
+bool is_derived_field(uint32_t field_id) {
+  return field_id >= RDC_FI_DERIVED_0 && field_id < RDC_FI_DERIVED_0 + RDC_MAX_DERIVED_FIELDS;
+}
+
+std::string trim(const std::string& s) {
+  size_t begin = s.find_first_not_of(" \t\r\n");
+  if (begin == std::string::npos) {
+    return "";
+  }
+  size_t end = s.find_last_not_of(" \t\r\n");
+  return s.substr(begin, end - begin + 1);
+}
+
+}  // namespace
+
+RdcDerivedFields::RdcDerivedFields() : num_programs_(0) {
+  for (auto& program : programs_) {
+    program.enabled = false;
+    program.has_aggregate = false;
+  }
+}
+
+rdc_status_t RdcDerivedFields::compile(const std::string& expression, std::vector<Op>* ops) {
+  // A recursive descent parser emitting the ops in postfix order:
+  //   expr    := term (('+' | '-') term)*
+  //   term    := unary (('*' | '/') unary)*
+  //   unary   := '-' unary | primary
+  //   primary := number | field | aggregate '(' field ')' | '(' expr ')'
+  struct Parser {
+    const std::string& text;
+    size_t pos;
+    std::vector<Op>* ops;
+    size_t depth;
+    size_t max_depth;
+    std::string error;
+
+    void skip_space() {
+      while (pos < text.size() && isspace(static_cast<unsigned char>(text[pos]))) pos++;
+    }
+    bool accept(char c) {
+      skip_space();
+      if (pos < text.size() && text[pos] == c) {
+        pos++;
+        return true;
+      }
+      return false;
+    }
+    std::string identifier() {
+      skip_space();
+      size_t begin = pos;
+      while (pos < text.size() &&
+             (isalnum(static_cast<unsigned char>(text[pos])) || text[pos] == '_')) {
+        pos++;
+      }
+      return text.substr(begin, pos - begin);
+    }
+    void emit(OpCode code, uint32_t field_id = 0, double constant = 0) {
+      ops->push_back({code, field_id, constant});
+      // Operands push one value, binary operators pop one
+      if (code <= OP_MAX) {
+        max_depth = std::max(max_depth, ++depth);
+      } else if (code != OP_NEG) {
+        depth--;
+      }
+    }
+    bool field(uint32_t* field_id) {
+      std::string name = identifier();
+      rdc_field_t id;
+      if (name.empty() || !get_field_id_from_name(name, &id)) {
+        error = "unknown field '" + name + "'";
+        return false;
+      }
+      *field_id = id;
+      return true;
+    }
+    bool primary() {
+      skip_space();
+      if (pos >= text.size()) {
+        error = "unexpected end";
+        return false;
+      }
+      if (accept('(')) {
+        if (!expr()) return false;
+        if (!accept(')')) {
+          error = "missing ')'";
+          return false;
+        }
+        return true;
+      }
+      if (isdigit(static_cast<unsigned char>(text[pos])) || text[pos] == '.') {
+        const char* begin = text.c_str() + pos;
+        char* end = nullptr;
+        double constant = strtod(begin, &end);
+        pos += end - begin;
+        emit(OP_CONST, 0, constant);
+        return true;
+      }
+
+      size_t start = pos;
+      std::string name = identifier();
+      static const std::map<std::string, OpCode> kAggregates = {
+          {"sum", OP_SUM}, {"avg", OP_AVG}, {"min", OP_MIN}, {"max", OP_MAX}};
+      auto aggregate = kAggregates.find(name);
+      if (aggregate != kAggregates.end() && accept('(')) {
+        uint32_t field_id;
+        if (!field(&field_id)) return false;
+        if (!accept(')')) {
+          error = "missing ')'";
+          return false;
+        }
+        emit(aggregate->second, field_id);
+        return true;
+      }
+      pos = start;
+      uint32_t field_id;
+      if (!field(&field_id)) return false;
+      emit(OP_FIELD, field_id);
+      return true;
+    }
+    bool unary() {
+      if (accept('-')) {
+        if (!unary()) return false;
+        emit(OP_NEG);
+        return true;
+      }
+      return primary();
+    }
+    bool term() {
+      if (!unary()) return false;
+      while (true) {
+        if (accept('*')) {
+          if (!unary()) return false;
+          emit(OP_MUL);
+        } else if (accept('/')) {
+          if (!unary()) return false;
+          emit(OP_DIV);
+        } else {
+          return true;
+        }
+      }
+    }
+    bool expr() {
+      if (!term()) return false;
+      while (true) {
+        if (accept('+')) {
+          if (!term()) return false;
+          emit(OP_ADD);
+        } else if (accept('-')) {
+          if (!term()) return false;
+          emit(OP_SUB);
+        } else {
+          return true;
+        }
+      }
+    }
+  };
+
+  Parser parser{expression, 0, ops, 0, 0, ""};
+  bool ok = parser.expr();
+  parser.skip_space();
+  if (ok && parser.pos != expression.size()) {
+    parser.error = "unexpected '" + expression.substr(parser.pos, 1) + "'";
+    ok = false;
+  }
+  if (ok && parser.max_depth > kMaxStackDepth) {
+    parser.error = "too deeply nested";
+    ok = false;
+  }
+  if (!ok) {
+    RDC_LOG(RDC_ERROR, "Invalid derived field expression '" << expression << "': "
+                                                            << parser.error);
+    return RDC_ST_BAD_PARAMETER;
+  }
+  return RDC_ST_OK;
+}
+
+rdc_status_t RdcDerivedFields::set_expression(rdc_field_t field_id,
+                                              const std::string& expression) {
+  if (!is_derived_field(field_id) || expression.size() >= RDC_MAX_STR_LENGTH) {
+    return RDC_ST_BAD_PARAMETER;
+  }
+
+  Program program;
+  program.enabled = true;
+  program.expression = expression;
+  rdc_status_t status = compile(expression, &program.ops);
+  if (status != RDC_ST_OK) {
+    return status;
+  }
+  std::set<uint32_t> inputs;
+  program.has_aggregate = false;
+  for (const auto& op : program.ops) {
+    if (op.code <= OP_MAX && op.code != OP_CONST) {
+      inputs.insert(op.field_id);
+    }
+    program.has_aggregate |= op.code >= OP_SUM && op.code <= OP_MAX;
+  }
+  if (inputs.count(field_id)) {
+    RDC_LOG(RDC_ERROR, "The derived field " << field_id << " cannot read itself");
+    return RDC_ST_BAD_PARAMETER;
+  }
+  program.inputs.assign(inputs.begin(), inputs.end());
+
+  std::lock_guard<std::mutex> guard(mutex_);
+  uint32_t slot = field_id - RDC_FI_DERIVED_0;
+  programs_[slot] = std::move(program);
+  results_[slot].clear();
+  update_dependents();
+  RDC_LOG(RDC_INFO, "Set the derived field " << field_id_string(field_id) << " = " << expression);
+  return RDC_ST_OK;
+}
+
+rdc_status_t RdcDerivedFields::clear_expression(rdc_field_t field_id) {
+  if (!is_derived_field(field_id)) {
+    return RDC_ST_BAD_PARAMETER;
+  }
+
+  std::lock_guard<std::mutex> guard(mutex_);
+  uint32_t slot = field_id - RDC_FI_DERIVED_0;
+  if (!programs_[slot].enabled) {
+    return RDC_ST_NOT_FOUND;
+  }
+  programs_[slot] = Program();
+  programs_[slot].enabled = false;
+  results_[slot].clear();
+  update_dependents();
+  return RDC_ST_OK;
+}
+
+rdc_status_t RdcDerivedFields::load_file(const std::string& path) {
+  std::ifstream file(path);
+  if (!file) {
+    RDC_LOG(RDC_ERROR, "Fail to open the derived fields file " << path);
+    return RDC_ST_FILE_ERROR;
+  }
+
+  rdc_status_t result = RDC_ST_OK;
+  std::string line;
+  for (uint32_t line_number = 1; std::getline(file, line); line_number++) {
+    line = trim(line.substr(0, line.find('#')));
+    if (line.empty()) {
+      continue;
+    }
+    size_t equal = line.find('=');
+    rdc_field_t field_id;
+    if (equal == std::string::npos || !get_field_id_from_name(trim(line.substr(0, equal)),
+                                                              &field_id)) {
+      RDC_LOG(RDC_ERROR, path << ":" << line_number << ": expected <field> = <expression>");
+      result = RDC_ST_BAD_PARAMETER;
+      continue;
+    }
+    rdc_status_t status = set_expression(field_id, trim(line.substr(equal + 1)));
+    if (status != RDC_ST_OK) {
+      RDC_LOG(RDC_ERROR, path << ":" << line_number << ": fail to set " << line);
+      result = status;
+    }
+  }
+  return result;
+}
+
+void RdcDerivedFields::update_dependents() {
+  dependents_.clear();
+  num_programs_ = 0;
+  for (uint32_t slot = 0; slot < programs_.size(); slot++) {
+    if (!programs_[slot].enabled) {
+      continue;
+    }
+    num_programs_++;
+    for (auto input : programs_[slot].inputs) {
+      dependents_[input].push_back(slot);
+    }
+  }
+  // Forget the samples no expression reads anymore
+  for (auto ite = latest_.begin(); ite != latest_.end();) {
+    ite = dependents_.count(ite->first) ? std::next(ite) : latest_.erase(ite);
+  }
+}
+
+bool RdcDerivedFields::run(const Program& program, uint32_t gpu_index, uint64_t min_ts,
+                           const std::map<uint32_t, uint64_t>& watched, double* result) const {
+  double stack[kMaxStackDepth];
+  size_t top = 0;
+  for (const auto& op : program.ops) {
+    switch (op.code) {
+      case OP_CONST:
+        stack[top++] = op.constant;
+        break;
+      case OP_FIELD: {
+        auto samples = latest_.find(op.field_id);
+        if (samples == latest_.end()) return false;
+        auto sample = samples->second.find(gpu_index);
+        if (sample == samples->second.end() || sample->second.ts < min_ts) return false;
+        stack[top++] = sample->second.value;
+        break;
+      }
+      case OP_SUM:
+      case OP_AVG:
+      case OP_MIN:
+      case OP_MAX: {
+        auto samples = latest_.find(op.field_id);
+        if (samples == latest_.end()) return false;
+        uint32_t count = 0;
+        double sum = 0;
+        double min = 0;
+        double max = 0;
+        for (const auto& gpu : watched) {
+          auto sample = samples->second.find(gpu.first);
+          if (sample == samples->second.end() || sample->second.ts < min_ts) {
+            continue;
+          }
+          double v = sample->second.value;
+          min = count == 0 ? v : std::min(min, v);
+          max = count == 0 ? v : std::max(max, v);
+          sum += v;
+          count++;
+        }
+        if (count == 0) return false;
+        double values[] = {sum, sum / count, min, max};
+        stack[top++] = values[op.code - OP_SUM];
+        break;
+      }
+      case OP_ADD:
+        top--;
+        stack[top - 1] += stack[top];
+        break;
+      case OP_SUB:
+        top--;
+        stack[top - 1] -= stack[top];
+        break;
+      case OP_MUL:
+        top--;
+        stack[top - 1] *= stack[top];
+        break;
+      case OP_DIV:
+        top--;
+        if (stack[top] == 0) return false;
+        stack[top - 1] /= stack[top];
+        break;
+      case OP_NEG:
+        stack[top - 1] = -stack[top - 1];
+        break;
+    }
+  }
+  *result = stack[0];
+  return std::isfinite(*result);
+}
+
+void RdcDerivedFields::evaluate(uint32_t gpu_index, const rdc_field_value& value) {
+  if (num_programs_ == 0) {
+    return;
+  }
+
+  double v = 0;
+  if (value.type == INTEGER) {
+    v = static_cast<double>(value.value.l_int);
+  } else if (value.type == DOUBLE) {
+    v = value.value.dbl;
+  } else {
+    return;
+  }
+
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto dependents = dependents_.find(value.field_id);
+  if (dependents == dependents_.end()) {
+    return;
+  }
+  latest_[value.field_id][gpu_index] = {value.ts, v};
+  for (auto slot : dependents->second) {
+    const auto& watched = watched_[slot];
+    if (watched.find(gpu_index) == watched.end()) {
+      continue;
+    }
+    // A sample of a GPU changes the aggregates of all the watched GPUs
+    for (const auto& gpu : watched) {
+      if (gpu.first != gpu_index && !programs_[slot].has_aggregate) {
+        continue;
+      }
+      // The inputs older than the update interval are dropped, with a half
+      // interval of slack for the inputs fetched in the previous tick
+      uint64_t max_age = gpu.second + gpu.second / 2;
+      uint64_t min_ts = value.ts > max_age ? value.ts - max_age : 0;
+      double result;
+      if (run(programs_[slot], gpu.first, min_ts, watched, &result)) {
+        results_[slot][gpu.first] = {value.ts, result};
+      }
+    }
+  }
+}
+
+void RdcDerivedFields::set_watched(const std::map<RdcFieldKey, uint64_t>& update_freqs) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  for (auto& watched : watched_) {
+    watched.clear();
+  }
+  for (const auto& field : update_freqs) {
+    if (is_derived_field(field.first.second)) {
+      watched_[field.first.second - RDC_FI_DERIVED_0][field.first.first] = field.second / 1000;
+    }
+  }
+}
+
+void RdcDerivedFields::get_inputs(rdc_field_t field_id, std::vector<rdc_field_t>* inputs) {
+  if (!is_derived_field(field_id)) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> guard(mutex_);
+  std::vector<uint32_t> pending = {field_id};
+  std::set<uint32_t> seen = {field_id};
+  while (!pending.empty()) {
+    const Program& program = programs_[pending.back() - RDC_FI_DERIVED_0];
+    pending.pop_back();
+    for (auto input : program.inputs) {
+      if (!seen.insert(input).second) {
+        continue;
+      }
+      inputs->push_back(static_cast<rdc_field_t>(input));
+      if (is_derived_field(input)) {
+        pending.push_back(input);
+      }
+    }
+  }
+}
+
+rdc_status_t RdcDerivedFields::rdc_telemetry_fields_query(uint32_t field_ids[MAX_NUM_FIELDS],
+                                                          uint32_t* field_count) {
+  if (field_count == nullptr) {
+    return RDC_ST_BAD_PARAMETER;
+  }
+  *field_count = 0;
+  for (uint32_t i = 0; i < RDC_MAX_DERIVED_FIELDS; i++) {
+    field_ids[(*field_count)++] = RDC_FI_DERIVED_0 + i;
+  }
+  return RDC_ST_OK;
+}
+
+rdc_status_t RdcDerivedFields::rdc_telemetry_fields_value_get(rdc_gpu_field_t* fields,
+                                                              uint32_t fields_count,
+                                                              rdc_field_value_f callback,
+                                                              void* user_data) {
+  if (fields == nullptr || callback == nullptr) {
+    return RDC_ST_BAD_PARAMETER;
+  }
+
+  std::vector<rdc_gpu_field_value_t> values(fields_count);
+  do {  //< lock guard scope; the callback evaluates the expressions again
+    std::lock_guard<std::mutex> guard(mutex_);
+    for (uint32_t i = 0; i < fields_count; i++) {
+      rdc_gpu_field_value_t& value = values[i];
+      value.gpu_index = fields[i].gpu_index;
+      value.field_value.field_id = fields[i].field_id;
+      value.field_value.type = DOUBLE;
+      value.field_value.ts = 0;
+      value.field_value.status = RDC_ST_NOT_FOUND;
+      if (!is_derived_field(fields[i].field_id)) {
+        value.field_value.status = RDC_ST_NOT_SUPPORTED;
+        continue;
+      }
+      const auto& results = results_[fields[i].field_id - RDC_FI_DERIVED_0];
+      auto result = results.find(fields[i].gpu_index);
+      if (result != results.end()) {
+        value.field_value.ts = result->second.ts;
+        value.field_value.value.dbl = result->second.value;
+        value.field_value.status = RDC_ST_OK;
+      }
+    }
+  } while (0);
+
+  if (values.empty()) {
+    return RDC_ST_OK;
+  }
+  return callback(&values[0], values.size(), user_data);
+}
+
+rdc_status_t RdcDerivedFields::rdc_telemetry_fields_watch(rdc_gpu_field_t*, uint32_t) {
+  return RDC_ST_OK;
+}
+
+rdc_status_t RdcDerivedFields::rdc_telemetry_fields_unwatch(rdc_gpu_field_t*, uint32_t) {
+  return RDC_ST_OK;
+}
+
+}  // namespace rdc
+}  // namespace amd
@@ -25,9 +25,12 @@ THE SOFTWARE.
 
 #include "amd_smi/amdsmi.h"
 #include "common/rdc_fields_supported.h"
+#include "common/rdc_perf_histogram.h"
 #include "rdc_lib/RdcException.h"
 #include "rdc_lib/RdcLogger.h"
 #include "rdc_lib/RdcNotification.h"
+#include "rdc_lib/RdcPipelineTrace.h"
+#include "rdc_lib/RdcSelfStats.h"
 #include "rdc_lib/impl/RdcCacheManagerImpl.h"
 #include "rdc_lib/impl/RdcGroupSettingsImpl.h"
 #include "rdc_lib/impl/RdcMetricFetcherImpl.h"
@@ -35,6 +38,7 @@ THE SOFTWARE.
 #include "rdc_lib/impl/RdcModuleMgrImpl.h"
 #include "rdc_lib/impl/RdcNotificationImpl.h"
 #include "rdc_lib/impl/RdcWatchTableImpl.h"
+#include "rdc_lib/impl/SmiUtils.h"
 #include "rdc_lib/rdc_common.h"
 
 namespace {
@@ -43,13 +47,13 @@ namespace {
 class smi_initializer {
   smi_initializer() {
     // Make sure smi will not be initialized multiple times
-    amdsmi_shut_down();
-    amdsmi_status_t ret = amdsmi_init(AMDSMI_INIT_AMD_GPUS);
+    amd::rdc::get_smi_backend()->shut_down();
+    amdsmi_status_t ret = amd::rdc::get_smi_backend()->init(AMDSMI_INIT_AMD_GPUS);
     if (ret != AMDSMI_STATUS_SUCCESS) {
       throw amd::rdc::RdcException(RDC_ST_FAIL_LOAD_MODULE, "SMI initialize fail");
     }
   }
-  ~smi_initializer() { amdsmi_shut_down(); }
+  ~smi_initializer() { amd::rdc::get_smi_backend()->shut_down(); }
 
  public:
   static smi_initializer& getInstance() {
@@ -75,10 +79,20 @@ RdcEmbeddedHandler::RdcEmbeddedHandler(rdc_operation_mode_t mode)
     : group_settings_(new RdcGroupSettingsImpl()),
       cache_mgr_(new RdcCacheManagerImpl()),
       metric_fetcher_(new RdcMetricFetcherImpl()),
-      rdc_module_mgr_(new RdcModuleMgrImpl(metric_fetcher_)),
+      anomaly_(new RdcAnomalyDetector()),
+      derived_(new RdcDerivedFields()),
+      rdc_module_mgr_(new RdcModuleMgrImpl(metric_fetcher_, anomaly_, derived_)),
       rdc_notif_(new RdcNotificationImpl()),
-      watch_table_(new RdcWatchTableImpl(group_settings_, cache_mgr_, rdc_module_mgr_, rdc_notif_)),
-      metrics_updater_(new RdcMetricsUpdaterImpl(watch_table_, METIC_UPDATE_FREQUENCY)) {
+      history_log_(RdcHistoryLog::from_env()),
+      policy_(new RdcPolicyEngine()),
+      watch_table_(new RdcWatchTableImpl(group_settings_, cache_mgr_, rdc_module_mgr_, rdc_notif_,
+                                         history_log_, policy_, anomaly_, derived_)),
+      metrics_updater_(new RdcMetricsUpdaterImpl(watch_table_, METIC_UPDATE_FREQUENCY)),
+      job_gauges_(new RdcJobGauges(cache_mgr_, metric_fetcher_, watch_table_)) {
+  const char* derived_fields = getenv("RDC_DERIVED_FIELDS");
+  if (derived_fields != nullptr) {
+    derived_->load_file(derived_fields);
+  }
   if (mode == RDC_OPERATION_MODE_AUTO) {
     RDC_LOG(RDC_DEBUG, "Run RDC with RDC_OPERATION_MODE_AUTO");
     metrics_updater_->start();
@@ -90,73 +104,88 @@ RdcEmbeddedHandler::~RdcEmbeddedHandler() { metrics_updater_->stop(); }
 // JOB API
 rdc_status_t RdcEmbeddedHandler::rdc_job_start_stats(rdc_gpu_group_t groupId, const char job_id[64],
                                                      uint64_t update_freq) {
+  rdc_group_info_t ginfo;
+  rdc_status_t status = group_settings_->rdc_group_gpu_get_info(groupId, &ginfo);
+  if (status != RDC_ST_OK) return status;
+
   rdc_gpu_gauges_t gpu_gauges;
-  rdc_status_t status = get_gpu_gauges(&gpu_gauges);
+  std::vector<uint32_t> gpu_indexes(ginfo.entity_ids, ginfo.entity_ids + ginfo.count);
+  status = job_gauges_->get(gpu_indexes, RDC_ECC_GAUGES_FRESH, &gpu_gauges);
   if (status != RDC_ST_OK) return status;
 
   return watch_table_->rdc_job_start_stats(groupId, job_id, update_freq, gpu_gauges);
 }
 
-rdc_status_t RdcEmbeddedHandler::get_gpu_gauges(rdc_gpu_gauges_t* gpu_gauges) {
-  uint32_t gpu_index_list[RDC_MAX_NUM_DEVICES];
-  uint32_t count = 0;
-
-  if (gpu_gauges == nullptr) {
-    return RDC_ST_BAD_PARAMETER;
-  }
-  rdc_status_t status = rdc_device_get_all(gpu_index_list, &count);
-  if (status != RDC_ST_OK) {
-    return status;
-  }
-
-  // Fetch total memory and current ecc errors
-  for (uint32_t i = 0; i < count; i++) {
-    rdc_field_value value;
-    status = metric_fetcher_->fetch_smi_field(gpu_index_list[i], RDC_FI_GPU_MEMORY_TOTAL, &value);
-    if (status != RDC_ST_OK) {
-      RDC_LOG(RDC_ERROR, "Fail to get total memory of GPU " << gpu_index_list[i]);
-      return status;
-    }
-    gpu_gauges->insert(
-        {{gpu_index_list[i], RDC_FI_GPU_MEMORY_TOTAL}, static_cast<uint64_t>(value.value.l_int)});
-
-    status = metric_fetcher_->fetch_smi_field(gpu_index_list[i], RDC_FI_ECC_CORRECT_TOTAL, &value);
-    if (status == RDC_ST_OK) {
-      gpu_gauges->insert({{gpu_index_list[i], RDC_FI_ECC_CORRECT_TOTAL},
-                          static_cast<uint64_t>(value.value.l_int)});
-    }
-    status =
-        metric_fetcher_->fetch_smi_field(gpu_index_list[i], RDC_FI_ECC_UNCORRECT_TOTAL, &value);
-    if (status == RDC_ST_OK) {
-      gpu_gauges->insert({{gpu_index_list[i], RDC_FI_ECC_UNCORRECT_TOTAL},
-                          static_cast<uint64_t>(value.value.l_int)});
-    }
-  }
-  return RDC_ST_OK;
-}
-
 rdc_status_t RdcEmbeddedHandler::rdc_job_get_stats(const char job_id[64],
                                                    rdc_job_info_t* p_job_info) {
+  RdcSelfStats::get_instance().record_api_call();
   if (p_job_info == nullptr) {
     return RDC_ST_BAD_PARAMETER;
   }
 
+  // A stopped job already holds its ECC counts, so it needs no SMI call
+  std::vector<uint32_t> gpu_indexes;
+  bool is_running = false;
+  rdc_status_t status = cache_mgr_->rdc_job_get_gpus(job_id, &gpu_indexes, &is_running);
+  if (status == RDC_ST_NOT_FOUND) {
+    // Not in memory, the job store may still have it
+    return cache_mgr_->rdc_job_get_stats(job_id, rdc_gpu_gauges_t(), p_job_info);
+  }
+  if (status != RDC_ST_OK) return status;
+
   rdc_gpu_gauges_t gpu_gauges;
-  rdc_status_t status = get_gpu_gauges(&gpu_gauges);
+  status = job_gauges_->get(gpu_indexes, is_running ? RDC_ECC_GAUGES_MEMOIZED : RDC_ECC_GAUGES_NONE,
+                            &gpu_gauges);
   if (status != RDC_ST_OK) return status;
 
   return cache_mgr_->rdc_job_get_stats(job_id, gpu_gauges, p_job_info);
 }
 
 rdc_status_t RdcEmbeddedHandler::rdc_job_stop_stats(const char job_id[64]) {
+  std::vector<uint32_t> gpu_indexes;
+  bool is_running = false;
+  rdc_status_t status = cache_mgr_->rdc_job_get_gpus(job_id, &gpu_indexes, &is_running);
+  if (status != RDC_ST_OK) return status;
+
   rdc_gpu_gauges_t gpu_gauges;
-  rdc_status_t status = get_gpu_gauges(&gpu_gauges);
+  status = job_gauges_->get(gpu_indexes, is_running ? RDC_ECC_GAUGES_FRESH : RDC_ECC_GAUGES_NONE,
+                            &gpu_gauges);
   if (status != RDC_ST_OK) return status;
 
   return watch_table_->rdc_job_stop_stats(job_id, gpu_gauges);
 }
 
+rdc_status_t RdcEmbeddedHandler::rdc_job_get_timeline(const char job_id[64], uint32_t gpu_index,
+                                                      rdc_field_t field,
+                                                      rdc_job_timeline_t* timeline) {
+  RdcSelfStats::get_instance().record_api_call();
+  if (timeline == nullptr) {
+    return RDC_ST_BAD_PARAMETER;
+  }
+
+  // Only the memory usage needs a gauge, the cached total memory
+  rdc_gpu_gauges_t gpu_gauges;
+  if (field == RDC_FI_GPU_MEMORY_USAGE) {
+    rdc_status_t status = job_gauges_->get({gpu_index}, RDC_ECC_GAUGES_NONE, &gpu_gauges);
+    if (status != RDC_ST_OK) return status;
+  }
+
+  return cache_mgr_->rdc_job_get_timeline(job_id, gpu_index, field, gpu_gauges, timeline);
+}
+
+rdc_status_t RdcEmbeddedHandler::rdc_job_list(const rdc_job_filter_t* filter,
+                                              rdc_job_list_t* jobs) {
+  RdcSelfStats::get_instance().record_api_call();
+  if (filter == nullptr || jobs == nullptr) {
+    return RDC_ST_BAD_PARAMETER;
+  }
+  return cache_mgr_->rdc_job_list(*filter, jobs);
+}
+
 rdc_status_t RdcEmbeddedHandler::rdc_job_remove(const char job_id[64]) {
+  // Stop a running job with its gauges first, so the job store gets its
+  // final stats. It fails harmlessly on a stopped job.
+  rdc_job_stop_stats(job_id);
   return watch_table_->rdc_job_remove(job_id);
 }
 
@@ -203,7 +232,7 @@ rdc_status_t RdcEmbeddedHandler::rdc_device_get_component_version(rdc_component_
     amdsmi_status_t ret;
     amdsmi_version_t ver = {0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, nullptr};
 
-    ret = amdsmi_get_lib_version(&ver);
+    ret = get_smi_backend()->get_lib_version(&ver);
 
     if (ret != AMDSMI_STATUS_SUCCESS) {
       RDC_LOG(RDC_ERROR, "Failed to obtain the version of the server's amd-smi library. reason: " << (ret == AMDSMI_STATUS_INVAL ? "Invalid parameters" : "unknown"));
@@ -344,6 +373,7 @@ rdc_status_t RdcEmbeddedHandler::rdc_field_watch(rdc_gpu_group_t group_id,
 
 rdc_status_t RdcEmbeddedHandler::rdc_field_get_latest_value(uint32_t gpu_index, rdc_field_t field,
                                                             rdc_field_value* value) {
+  RdcSelfStats::get_instance().record_api_call();
   if (!value) {
     return RDC_ST_BAD_PARAMETER;
   }
@@ -358,6 +388,7 @@ rdc_status_t RdcEmbeddedHandler::rdc_field_get_value_since(uint32_t gpu_index, r
                                                            uint64_t since_time_stamp,
                                                            uint64_t* next_since_time_stamp,
                                                            rdc_field_value* value) {
+  RdcSelfStats::get_instance().record_api_call();
   if (!next_since_time_stamp || !value) {
     return RDC_ST_BAD_PARAMETER;
   }
@@ -369,6 +400,159 @@ rdc_status_t RdcEmbeddedHandler::rdc_field_get_value_since(uint32_t gpu_index, r
                                                next_since_time_stamp, value);
 }
 
+rdc_status_t RdcEmbeddedHandler::rdc_field_get_rollup(uint32_t gpu_index, rdc_field_t field,
+                                                      uint64_t start_ts, uint64_t end_ts,
+                                                      rdc_field_rollups_t* rollups) {
+  RdcSelfStats::get_instance().record_api_call();
+  if (!rollups) {
+    return RDC_ST_BAD_PARAMETER;
+  }
+  if (!is_field_valid(field)) {
+    RDC_LOG(RDC_INFO, "Fail to get rollup with unknown field id " << field);
+    return RDC_ST_NOT_SUPPORTED;
+  }
+  return cache_mgr_->rdc_field_get_rollup(gpu_index, field, start_ts, end_ts, rollups);
+}
+
+rdc_status_t RdcEmbeddedHandler::rdc_field_get_history(uint32_t gpu_index, rdc_field_t field,
+                                                       uint64_t since_ts, uint64_t until_ts,
+                                                       rdc_field_history_t* history) {
+  RdcSelfStats::get_instance().record_api_call();
+  if (!history) {
+    return RDC_ST_BAD_PARAMETER;
+  }
+  if (!history_log_) {
+    RDC_LOG(RDC_INFO, "Fail to get the history, RDC_HISTORY_DIR is not set");
+    return RDC_ST_NOT_SUPPORTED;
+  }
+  if (!is_field_valid(field)) {
+    RDC_LOG(RDC_INFO, "Fail to get history with unknown field id " << field);
+    return RDC_ST_NOT_SUPPORTED;
+  }
+  return history_log_->query(gpu_index, field, since_ts, until_ts, history);
+}
+
+rdc_status_t RdcEmbeddedHandler::rdc_policy_add_rule(const rdc_policy_rule_t* rule,
+                                                     uint32_t* rule_id) {
+  RdcSelfStats::get_instance().record_api_call();
+  if (!rule || !rule_id) {
+    return RDC_ST_BAD_PARAMETER;
+  }
+  if (!is_field_valid(rule->field_id)) {
+    RDC_LOG(RDC_INFO, "Fail to add a policy rule with unknown field id " << rule->field_id);
+    return RDC_ST_NOT_SUPPORTED;
+  }
+  return policy_->add_rule(*rule, rule_id);
+}
+
+rdc_status_t RdcEmbeddedHandler::rdc_policy_delete_rule(uint32_t rule_id) {
+  RdcSelfStats::get_instance().record_api_call();
+  return policy_->delete_rule(rule_id);
+}
+
+rdc_status_t RdcEmbeddedHandler::rdc_policy_get_violations(uint64_t since_seq, uint32_t timeout_ms,
+                                                           rdc_policy_violations_t* violations) {
+  RdcSelfStats::get_instance().record_api_call();
+  return policy_->get_violations(since_seq, timeout_ms, violations);
+}
+
+rdc_status_t RdcEmbeddedHandler::rdc_anomaly_set_detector(uint32_t detector_id,
+                                                          const rdc_anomaly_config_t* config) {
+  RdcSelfStats::get_instance().record_api_call();
+  if (!config) {
+    return RDC_ST_BAD_PARAMETER;
+  }
+  if (!is_field_valid(config->field_id)) {
+    RDC_LOG(RDC_INFO, "Fail to set an anomaly detector with unknown field id "
+                          << config->field_id);
+    return RDC_ST_NOT_SUPPORTED;
+  }
+  return anomaly_->set_detector(detector_id, *config);
+}
+
+rdc_status_t RdcEmbeddedHandler::rdc_anomaly_clear_detector(uint32_t detector_id) {
+  RdcSelfStats::get_instance().record_api_call();
+  return anomaly_->clear_detector(detector_id);
+}
+
+rdc_status_t RdcEmbeddedHandler::rdc_field_derived_set(rdc_field_t field_id,
+                                                       const char* expression) {
+  RdcSelfStats::get_instance().record_api_call();
+  if (!expression) {
+    return RDC_ST_BAD_PARAMETER;
+  }
+  return derived_->set_expression(field_id, expression);
+}
+
+rdc_status_t RdcEmbeddedHandler::rdc_field_derived_clear(rdc_field_t field_id) {
+  RdcSelfStats::get_instance().record_api_call();
+  return derived_->clear_expression(field_id);
+}
+
+rdc_status_t RdcEmbeddedHandler::rdc_field_ingest(uint32_t gpu_index, const rdc_field_value* values,
+                                                  uint32_t num_values, double max_keep_age,
+                                                  uint32_t max_keep_samples) {
+  RdcSelfStats::get_instance().record_api_call();
+  if (!values) {
+    return RDC_ST_BAD_PARAMETER;
+  }
+  for (uint32_t i = 0; i < num_values; i++) {
+    if (!is_field_valid(values[i].field_id)) {
+      RDC_LOG(RDC_INFO, "Fail to ingest the unknown field id " << values[i].field_id);
+      return RDC_ST_NOT_SUPPORTED;
+    }
+  }
+  return watch_table_->rdc_field_ingest(gpu_index, values, num_values, max_keep_age,
+                                        max_keep_samples);
+}
+
+// The aggregator lives in rdcd, which answers these from its own state
+rdc_status_t RdcEmbeddedHandler::rdc_aggregate_get_hosts(rdc_aggregate_hosts_t* hosts) {
+  (void)(hosts);
+  return RDC_ST_NOT_SUPPORTED;
+}
+
+rdc_status_t RdcEmbeddedHandler::rdc_aggregate_get_field(rdc_field_t field, rdc_aggregate_op_t op,
+                                                         rdc_cluster_aggregate_t* aggregate) {
+  (void)(field);
+  (void)(op);
+  (void)(aggregate);
+  return RDC_ST_NOT_SUPPORTED;
+}
+
+rdc_status_t RdcEmbeddedHandler::rdc_field_get_group_aggregate(
+    rdc_gpu_group_t group_id, rdc_field_grp_t field_group_id, uint64_t window_ms,
+    const rdc_aggregate_spec_t* specs, uint32_t num_specs, rdc_group_aggregate_t* aggregate) {
+  RdcSelfStats::get_instance().record_api_call();
+  if (!specs || !aggregate || num_specs == 0 || num_specs > RDC_MAX_GROUP_AGGREGATE_OPS) {
+    return RDC_ST_BAD_PARAMETER;
+  }
+  for (uint32_t i = 0; i < num_specs; i++) {
+    if (specs[i].op > RDC_AGGREGATE_PERCENTILE ||
+        (specs[i].op == RDC_AGGREGATE_PERCENTILE &&
+         !(specs[i].percentile >= 0 && specs[i].percentile <= 100))) {
+      RDC_LOG(RDC_INFO, "Fail to aggregate with the invalid reduction " << specs[i].op);
+      return RDC_ST_BAD_PARAMETER;
+    }
+  }
+
+  rdc_group_info_t ginfo;
+  rdc_status_t status = group_settings_->rdc_group_gpu_get_info(group_id, &ginfo);
+  if (status != RDC_ST_OK) {
+    return status;
+  }
+  rdc_field_group_info_t finfo;
+  status = group_settings_->rdc_group_field_get_info(field_group_id, &finfo);
+  if (status != RDC_ST_OK) {
+    return status;
+  }
+
+  std::vector<uint32_t> gpu_indexes(ginfo.entity_ids, ginfo.entity_ids + ginfo.count);
+  std::vector<rdc_field_t> field_ids(finfo.field_ids, finfo.field_ids + finfo.count);
+  return cache_mgr_->rdc_field_get_group_aggregate(gpu_indexes, field_ids, window_ms, specs,
+                                                   num_specs, aggregate);
+}
+
 rdc_status_t RdcEmbeddedHandler::rdc_field_unwatch(rdc_gpu_group_t group_id,
                                                    rdc_field_grp_t field_group_id) {
   return watch_table_->rdc_field_unwatch(group_id, field_group_id);
@@ -421,6 +605,37 @@ rdc_status_t RdcEmbeddedHandler::rdc_field_update_all(uint32_t wait_for_update)
   return RDC_ST_OK;
 }
 
+rdc_status_t RdcEmbeddedHandler::rdc_perf_stats_get(rdc_perf_stats_t* stats) {
+  if (stats == nullptr) {
+    return RDC_ST_BAD_PARAMETER;
+  }
+  stats->num_stats = 0;
+  RdcPerfRegistry::get_instance().get_stats(stats);
+  return RDC_ST_OK;
+}
+
+rdc_status_t RdcEmbeddedHandler::rdc_pipeline_trace_set(uint32_t enabled) {
+  RdcPipelineTrace::get_instance().set_enabled(enabled != 0);
+  return RDC_ST_OK;
+}
+
+rdc_status_t RdcEmbeddedHandler::rdc_pipeline_trace_get(uint64_t start_seq,
+                                                        rdc_pipeline_events_t* events) {
+  if (events == nullptr) {
+    return RDC_ST_BAD_PARAMETER;
+  }
+  RdcPipelineTrace::get_instance().get_events(start_seq, events);
+  return RDC_ST_OK;
+}
+
+rdc_status_t RdcEmbeddedHandler::rdc_log_level_set(rdc_log_level_t level) {
+  if (level > RDC_LOG_LEVEL_DEBUG) {
+    return RDC_ST_BAD_PARAMETER;
+  }
+  RdcLogger::getLogger().set_log_level(level);
+  return RDC_ST_OK;
+}
+
 // It is just a client interface under the GRPC framework and is not used as an RDC API.
 // Just write an empty function to solve compilation errors
 rdc_status_t RdcEmbeddedHandler::get_mixed_component_version(mixed_component_t component, mixed_component_version_t* p_mixed_compv) {
@@ -429,5 +644,16 @@ rdc_status_t RdcEmbeddedHandler::get_mixed_component_version(mixed_component_t c
   return RDC_ST_OK;
 }
 
+rdc_status_t RdcEmbeddedHandler::get_cache_generation(uint32_t gpu_index, rdc_field_t field_id,
+                                                      uint64_t* cache_generation,
+                                                      uint64_t* group_generation) {
+  if (!cache_generation || !group_generation) {
+    return RDC_ST_BAD_PARAMETER;
+  }
+  *cache_generation = cache_mgr_->get_generation({gpu_index, field_id});
+  *group_generation = group_settings_->get_generation();
+  return RDC_ST_OK;
+}
+
 }  // namespace rdc
 }  // namespace amd
@@ -54,6 +54,7 @@ rdc_status_t RdcGroupSettingsImpl::rdc_group_gpu_create(const char* group_name,
   gpu_group_.emplace(cur_group_id_, ginfo);
   *p_rdc_group_id = cur_group_id_;
   cur_group_id_++;
+  generation_++;
 
   return RDC_ST_OK;
 }
@@ -61,6 +62,7 @@ rdc_status_t RdcGroupSettingsImpl::rdc_group_gpu_create(const char* group_name,
 rdc_status_t RdcGroupSettingsImpl::rdc_group_gpu_destroy(rdc_gpu_group_t p_rdc_group_id) {
   std::lock_guard<std::mutex> guard(group_mutex_);
   if (!gpu_group_.erase(p_rdc_group_id)) return RDC_ST_NOT_FOUND;
+  generation_++;
   return RDC_ST_OK;
 }
 
@@ -79,6 +81,7 @@ rdc_status_t RdcGroupSettingsImpl::rdc_group_gpu_add(rdc_gpu_group_t groupId, ui
     if (ite->second.count < RDC_GROUP_MAX_ENTITIES) {
       ite->second.entity_ids[ite->second.count] = gpu_index;
       ite->second.count++;
+      generation_++;
     } else {
       return RDC_ST_MAX_LIMIT;
     }
@@ -150,6 +153,7 @@ rdc_status_t RdcGroupSettingsImpl::rdc_group_field_create(uint32_t num_field_ids
   field_group_.emplace(cur_field_group_id_, finfo);
   *rdc_field_group_id = cur_field_group_id_;
   cur_field_group_id_++;
+  generation_++;
 
   return RDC_ST_OK;
 }
@@ -161,6 +165,7 @@ rdc_status_t RdcGroupSettingsImpl::rdc_group_field_destroy(rdc_field_grp_t rdc_f
   }
   std::lock_guard<std::mutex> guard(field_group_mutex_);
   if (!field_group_.erase(rdc_field_group_id)) return RDC_ST_NOT_FOUND;
+  generation_++;
   return RDC_ST_OK;
 }
 
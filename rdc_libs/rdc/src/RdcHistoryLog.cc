@@ -0,0 +1,544 @@
+/*
+Copyright (c) 2024 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "rdc_lib/impl/RdcHistoryLog.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>  // NOLINT(build/c++11)
+#include <cstdlib>
+
+#include "rdc_lib/RdcException.h"
+#include "rdc_lib/RdcLogger.h"
+#include "rdc_lib/impl/RdcChecksum.h"
+#include "rdc_lib/impl/RdcEncoding.h"
+#include "rdc_lib/rdc_common.h"
+
+namespace amd {
+namespace rdc {
+
+namespace {
+
+const char kSegmentMagic[8] = {'R', 'D', 'C', 'H', 'S', 'T', '0', '1'};
+const uint32_t kBlockMagic = 0x4b424852;  // "RHBK"
+const uint32_t kIndexMagic = 0x58494852;  // "RHIX"
+const uint32_t kMaxBlockSamples = 256 * 1024;
+const uint32_t kWakeSamples = 16 * 1024;
+const uint32_t kMaxPendingSamples = 1024 * 1024;
+
+struct RdcHistorySegmentHeader {
+  char magic[8];
+  uint64_t seq;
+};
+
+struct RdcHistoryBlockHeader {
+  uint32_t magic;
+  uint32_t payload_bytes;
+  uint64_t min_ts;
+  uint64_t max_ts;
+  uint32_t num_samples;
+  uint32_t checksum;  //!< CRC32 of the payload
+};
+static_assert(sizeof(RdcHistoryBlockHeader) == 32, "The block header must be 32 bytes");
+
+struct RdcHistoryIndexTrailer {
+  uint64_t index_offset;
+  uint32_t num_entries;
+  uint32_t checksum;  //!< CRC32 of the index entries
+  uint32_t magic;
+  uint32_t reserved;
+};
+static_assert(sizeof(RdcHistoryIndexTrailer) == 24, "The index trailer must be 24 bytes");
+
+uint64_t now_ms() {
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return static_cast<uint64_t>(tv.tv_sec) * 1000 + tv.tv_usec / 1000;
+}
+
+}  // namespace
+
+RdcHistoryLog::RdcHistoryLog(const std::string& dir, uint64_t segment_bytes,
+                             uint32_t max_segments, uint32_t block_ms)
+    : dir_(dir),
+      segment_bytes_(segment_bytes),
+      max_segments_(std::max(max_segments, 2u)),
+      block_ms_(block_ms),
+      dropped_(0),
+      stop_(false),
+      block_samples_(0),
+      block_min_ts_(UINT64_MAX),
+      block_max_ts_(0),
+      block_start_(0),
+      file_(nullptr),
+      file_bytes_(0),
+      next_seq_(0) {
+  if (mkdir(dir_.c_str(), 0750) != 0 && errno != EEXIST) {
+    throw RdcException(RDC_ST_FILE_ERROR,
+                       "Fail to create the history directory " + dir_ + ": " + strerror(errno));
+  }
+
+  DIR* d = opendir(dir_.c_str());
+  if (d == nullptr) {
+    throw RdcException(RDC_ST_FILE_ERROR, "Fail to open the history directory " + dir_);
+  }
+  while (struct dirent* entry = readdir(d)) {
+    uint64_t seq = 0;
+    char suffix[8] = {0};
+    if (sscanf(entry->d_name, "history.%16" SCNx64 ".%3s", &seq, suffix) == 2 &&
+        strcmp(suffix, "log") == 0) {
+      Segment segment{dir_ + "/" + entry->d_name, seq, UINT64_MAX, 0, {}};
+      if (load_segment(&segment)) {
+        segments_.push_back(segment);
+      }
+      next_seq_ = std::max(next_seq_, seq + 1);
+    }
+  }
+  closedir(d);
+  std::sort(segments_.begin(), segments_.end(),
+            [](const Segment& a, const Segment& b) { return a.seq < b.seq; });
+
+  // A new segment per run, the older ones are only read
+  if (!open_segment()) {
+    throw RdcException(RDC_ST_FILE_ERROR, "Fail to create a history segment in " + dir_);
+  }
+  RDC_LOG(RDC_INFO, "History log in " << dir_ << " with " << segments_.size() << " segments");
+  io_thread_ = std::thread(&RdcHistoryLog::io_loop, this);
+}
+
+RdcHistoryLog::~RdcHistoryLog() {
+  do {  //< lock guard for thread safe
+    std::lock_guard<std::mutex> guard(pending_mutex_);
+    stop_ = true;
+  } while (0);
+  pending_cv_.notify_all();
+  if (io_thread_.joinable()) {
+    io_thread_.join();
+  }
+}
+
+std::shared_ptr<RdcHistoryLog> RdcHistoryLog::from_env() {
+  const char* dir = getenv("RDC_HISTORY_DIR");
+  if (dir == nullptr || dir[0] == '\0') {
+    return nullptr;
+  }
+  uint64_t segment_mb = env_or_default("RDC_HISTORY_SEGMENT_MB", 64);
+  uint64_t max_segments = env_or_default("RDC_HISTORY_SEGMENTS", 16);
+  uint64_t block_seconds = env_or_default("RDC_HISTORY_BLOCK_SEC", 10);
+  try {
+    return std::make_shared<RdcHistoryLog>(dir, segment_mb * 1024 * 1024, max_segments,
+                                           block_seconds * 1000);
+  } catch (const RdcException& e) {
+    RDC_LOG(RDC_ERROR, e.what() << ", the history log is off");
+  }
+  return nullptr;
+}
+
+bool RdcHistoryLog::load_segment(Segment* segment) {
+  std::FILE* f = std::fopen(segment->path.c_str(), "rb");
+  if (f == nullptr) {
+    return false;
+  }
+  RdcHistorySegmentHeader header;
+  bool valid = std::fread(&header, sizeof(header), 1, f) == 1 &&
+               memcmp(header.magic, kSegmentMagic, sizeof(kSegmentMagic)) == 0;
+  std::fseek(f, 0, SEEK_END);
+  uint64_t size = std::ftell(f);
+
+  // The index written when the segment was sealed
+  RdcHistoryIndexTrailer trailer;
+  if (valid && size >= sizeof(header) + sizeof(trailer) &&
+      std::fseek(f, size - sizeof(trailer), SEEK_SET) == 0 &&
+      std::fread(&trailer, sizeof(trailer), 1, f) == 1 && trailer.magic == kIndexMagic &&
+      trailer.index_offset + trailer.num_entries * sizeof(RdcHistoryIndexEntry) ==
+          size - sizeof(trailer)) {
+    segment->index.resize(trailer.num_entries);
+    if (std::fseek(f, trailer.index_offset, SEEK_SET) != 0 ||
+        std::fread(segment->index.data(), sizeof(RdcHistoryIndexEntry), trailer.num_entries, f) !=
+            trailer.num_entries ||
+        rdc_crc32(0, segment->index.data(), trailer.num_entries * sizeof(RdcHistoryIndexEntry)) !=
+            trailer.checksum) {
+      segment->index.clear();
+    }
+  }
+
+  // No index, walk the block headers
+  if (valid && segment->index.empty()) {
+    uint64_t pos = sizeof(header);
+    RdcHistoryBlockHeader block;
+    while (pos + sizeof(block) <= size && std::fseek(f, pos, SEEK_SET) == 0 &&
+           std::fread(&block, sizeof(block), 1, f) == 1 && block.magic == kBlockMagic &&
+           pos + sizeof(block) + block.payload_bytes <= size) {
+      segment->index.push_back({block.min_ts, block.max_ts, pos});
+      pos += sizeof(block) + block.payload_bytes;
+    }
+  }
+  std::fclose(f);
+
+  for (const auto& entry : segment->index) {
+    segment->min_ts = std::min(segment->min_ts, entry.min_ts);
+    segment->max_ts = std::max(segment->max_ts, entry.max_ts);
+  }
+  if (!valid) {
+    RDC_LOG(RDC_ERROR, "Ignore " << segment->path << " with a bad header");
+  }
+  return valid;
+}
+
+bool RdcHistoryLog::open_segment() {
+  uint64_t seq = next_seq_++;
+  char name[64];
+  snprintf(name, sizeof(name), "history.%016" PRIx64 ".log", seq);
+  std::string path = dir_ + "/" + name;
+  file_ = std::fopen(path.c_str(), "wb");
+  if (file_ == nullptr) {
+    RDC_LOG(RDC_ERROR, "Fail to create " << path << ": " << strerror(errno));
+    return false;
+  }
+  RdcHistorySegmentHeader header;
+  memcpy(header.magic, kSegmentMagic, sizeof(kSegmentMagic));
+  header.seq = seq;
+  std::fwrite(&header, sizeof(header), 1, file_);
+  file_bytes_ = sizeof(header);
+
+  std::lock_guard<std::mutex> guard(segments_mutex_);
+  segments_.push_back({path, seq, UINT64_MAX, 0, {}});
+  while (segments_.size() > max_segments_) {
+    unlink(segments_.front().path.c_str());
+    segments_.erase(segments_.begin());
+  }
+  return true;
+}
+
+void RdcHistoryLog::seal_segment() {
+  if (file_ == nullptr) {
+    return;
+  }
+  std::vector<RdcHistoryIndexEntry> index;
+  do {  //< lock guard for thread safe
+    std::lock_guard<std::mutex> guard(segments_mutex_);
+    index = segments_.back().index;
+    // Do not keep the segments of the runs which logged nothing
+    if (index.empty()) {
+      std::fclose(file_);
+      file_ = nullptr;
+      unlink(segments_.back().path.c_str());
+      segments_.pop_back();
+      return;
+    }
+  } while (0);
+
+  RdcHistoryIndexTrailer trailer;
+  trailer.index_offset = file_bytes_;
+  trailer.num_entries = index.size();
+  trailer.checksum = rdc_crc32(0, index.data(), index.size() * sizeof(RdcHistoryIndexEntry));
+  trailer.magic = kIndexMagic;
+  trailer.reserved = 0;
+  std::fwrite(index.data(), sizeof(RdcHistoryIndexEntry), index.size(), file_);
+  std::fwrite(&trailer, sizeof(trailer), 1, file_);
+  std::fclose(file_);
+  file_ = nullptr;
+}
+
+void RdcHistoryLog::append(uint32_t gpu_index, const rdc_field_value& value) {
+  PendingSample sample{value.ts, gpu_index, value.field_id, value.type, value.value.l_int, {}};
+  if (value.type == STRING) {
+    sample.str.assign(value.value.str, strnlen(value.value.str, RDC_MAX_STR_LENGTH));
+  } else if (value.type == BLOB) {
+    sample.str.assign(value.value.str, sizeof(value.value.str));
+  }
+
+  std::lock_guard<std::mutex> guard(pending_mutex_);
+  if (pending_.size() >= kMaxPendingSamples) {
+    // The disk fell behind, drop rather than stall the collection
+    if (dropped_++ % kWakeSamples == 0) {
+      RDC_LOG(RDC_ERROR, "The history log dropped " << dropped_ << " samples");
+    }
+    return;
+  }
+  pending_.push_back(std::move(sample));
+  if (pending_.size() == kWakeSamples) {
+    pending_cv_.notify_one();
+  }
+}
+
+void RdcHistoryLog::add_to_block(const PendingSample& sample) {
+  if (block_samples_ == 0) {
+    block_start_ = now_ms();
+  }
+  Series& series = block_[SeriesKey{sample.gpu_index, sample.field_id, sample.type}];
+  if (sample.type == INTEGER || sample.type == DOUBLE) {
+    if (series.numeric.empty() || series.numeric.back().full()) {
+      series.numeric.emplace_back(sample.type);
+    }
+    rdc_field_value_data value;
+    value.l_int = sample.l_int;
+    series.numeric.back().append(sample.ts, value);
+  } else {
+    put_varint(&series.raw, zigzag(static_cast<int64_t>(sample.ts - series.last_ts)));
+    put_varint(&series.raw, sample.str.size());
+    series.raw.append(sample.str);
+  }
+  series.count++;
+  series.last_ts = sample.ts;
+
+  block_samples_++;
+  block_min_ts_ = std::min(block_min_ts_, sample.ts);
+  block_max_ts_ = std::max(block_max_ts_, sample.ts);
+}
+
+// The payload is the number of series entries, then per entry the gpu
+// index, field id, type, number of samples, number of bytes and the bytes.
+// A numeric series spans an entry per RdcCompressedBlock.
+void RdcHistoryLog::write_block() {
+  std::string payload;
+  uint64_t num_entries = 0;
+  for (const auto& ite : block_) {
+    num_entries += ite.second.numeric.empty() ? 1 : ite.second.numeric.size();
+  }
+  put_varint(&payload, num_entries);
+  for (const auto& ite : block_) {
+    const Series& series = ite.second;
+    auto put_entry = [&](uint32_t count, const void* data, size_t length) {
+      put_varint(&payload, std::get<0>(ite.first));
+      put_varint(&payload, std::get<1>(ite.first));
+      put_varint(&payload, std::get<2>(ite.first));
+      put_varint(&payload, count);
+      put_varint(&payload, length);
+      payload.append(static_cast<const char*>(data), length);
+    };
+    if (series.numeric.empty()) {
+      put_entry(series.count, series.raw.data(), series.raw.size());
+    }
+    for (const auto& numeric : series.numeric) {
+      put_entry(numeric.count(), numeric.data().data(), numeric.data().size());
+    }
+  }
+
+  RdcHistoryBlockHeader header{kBlockMagic,   static_cast<uint32_t>(payload.size()),
+                               block_min_ts_, block_max_ts_,
+                               block_samples_, rdc_crc32(0, payload.data(), payload.size())};
+  bool written = std::fwrite(&header, sizeof(header), 1, file_) == 1 &&
+                 std::fwrite(payload.data(), 1, payload.size(), file_) == payload.size() &&
+                 std::fflush(file_) == 0;
+  if (!written) {
+    RDC_LOG(RDC_ERROR, "Fail to write " << block_samples_ << " samples to the history log");
+  } else {
+    // Published once the block is complete in the file
+    std::lock_guard<std::mutex> guard(segments_mutex_);
+    Segment& segment = segments_.back();
+    segment.index.push_back({block_min_ts_, block_max_ts_, file_bytes_});
+    segment.min_ts = std::min(segment.min_ts, block_min_ts_);
+    segment.max_ts = std::max(segment.max_ts, block_max_ts_);
+  }
+  file_bytes_ += sizeof(header) + payload.size();
+
+  block_.clear();
+  block_samples_ = 0;
+  block_min_ts_ = UINT64_MAX;
+  block_max_ts_ = 0;
+
+  if (file_bytes_ >= segment_bytes_) {
+    seal_segment();
+    open_segment();
+  }
+}
+
+void RdcHistoryLog::io_loop() {
+  std::vector<PendingSample> batch;
+  std::unique_lock<std::mutex> lock(pending_mutex_);
+  while (true) {
+    pending_cv_.wait_for(lock, std::chrono::milliseconds(block_ms_),
+                         [this]() { return stop_ || pending_.size() >= kWakeSamples; });
+    batch.swap(pending_);
+    bool stop = stop_;
+    lock.unlock();
+
+    if (file_ != nullptr) {
+      for (const PendingSample& sample : batch) {
+        add_to_block(sample);
+      }
+      if (block_samples_ > 0 && (stop || block_samples_ >= kMaxBlockSamples ||
+                                 now_ms() - block_start_ >= block_ms_)) {
+        write_block();
+      }
+    }
+    batch.clear();
+    if (stop) {
+      seal_segment();
+      return;
+    }
+    lock.lock();
+  }
+}
+
+rdc_status_t RdcHistoryLog::query(uint32_t gpu_index, rdc_field_t field_id, uint64_t since_ts,
+                                  uint64_t until_ts, rdc_field_history_t* history) {
+  if (history == nullptr || since_ts > until_ts) {
+    return RDC_ST_BAD_PARAMETER;
+  }
+
+  // The blocks overlapping the range, skipping whole segments by their span
+  std::vector<std::pair<std::string, std::vector<RdcHistoryIndexEntry>>> candidates;
+  do {  //< lock guard for thread safe
+    std::lock_guard<std::mutex> guard(segments_mutex_);
+    for (const Segment& segment : segments_) {
+      if (segment.index.empty() || segment.max_ts < since_ts || segment.min_ts > until_ts) {
+        continue;
+      }
+      std::vector<RdcHistoryIndexEntry> entries;
+      for (const auto& entry : segment.index) {
+        if (entry.max_ts >= since_ts && entry.min_ts <= until_ts) {
+          entries.push_back(entry);
+        }
+      }
+      candidates.push_back({segment.path, entries});
+    }
+  } while (0);
+
+  // The blocks are not ordered by time across series and segments, so all
+  // of them are scanned. Once more than two pages are found, only the
+  // values up to the one following the first page are kept, and the
+  // blocks starting after it are skipped.
+  const size_t kPage = RDC_MAX_HISTORY_VALUES;
+  std::vector<rdc_field_value> values;
+  uint64_t cutoff = until_ts;
+  auto by_time = [](const rdc_field_value& a, const rdc_field_value& b) { return a.ts < b.ts; };
+  auto emit = [&](uint64_t ts, rdc_field_type_t type, const void* data, size_t length) {
+    if (ts < since_ts || ts > cutoff) {
+      return;
+    }
+    rdc_field_value value;
+    memset(&value, 0, sizeof(value));
+    value.field_id = field_id;
+    value.status = RDC_ST_OK;
+    value.ts = ts;
+    value.type = type;
+    memcpy(&value.value, data, std::min(length, sizeof(value.value)));
+    if (type == STRING) {
+      value.value.str[RDC_MAX_STR_LENGTH - 1] = '\0';
+    }
+    values.push_back(value);
+  };
+
+  std::vector<uint8_t> payload;
+  for (const auto& candidate : candidates) {
+    std::FILE* f = std::fopen(candidate.first.c_str(), "rb");
+    if (f == nullptr) {
+      continue;  // Rotated out meanwhile
+    }
+    for (const auto& entry : candidate.second) {
+      if (entry.min_ts > cutoff) {
+        continue;
+      }
+      RdcHistoryBlockHeader header;
+      if (std::fseek(f, entry.offset, SEEK_SET) != 0 ||
+          std::fread(&header, sizeof(header), 1, f) != 1 || header.magic != kBlockMagic) {
+        break;
+      }
+      payload.resize(header.payload_bytes);
+      if (std::fread(payload.data(), 1, payload.size(), f) != payload.size() ||
+          rdc_crc32(0, payload.data(), payload.size()) != header.checksum) {
+        RDC_LOG(RDC_ERROR, "Skip a corrupted block in " << candidate.first);
+        continue;
+      }
+
+      PayloadReader reader(payload.data(), payload.size());
+      uint64_t num_entries = 0;
+      reader.get_varint(&num_entries);
+      for (uint64_t e = 0; e < num_entries; e++) {
+        uint64_t gpu = 0, field = 0, type = 0, count = 0, length = 0;
+        const uint8_t* data = nullptr;
+        if (!reader.get_varint(&gpu) || !reader.get_varint(&field) ||
+            !reader.get_varint(&type) || !reader.get_varint(&count) ||
+            !reader.get_varint(&length) || (data = reader.get_bytes(length)) == nullptr) {
+          break;
+        }
+        if (gpu != gpu_index || field != field_id) {
+          continue;
+        }
+        rdc_field_type_t field_type = static_cast<rdc_field_type_t>(type);
+        if (field_type == INTEGER || field_type == DOUBLE) {
+          RdcCompressedBlock block(field_type, count, data, length);
+          RdcCompressedBlock::Reader samples(block);
+          uint64_t ts = 0;
+          rdc_field_value_data value;
+          while (samples.next(&ts, &value)) {
+            emit(ts, field_type, &value.l_int, sizeof(value.l_int));
+          }
+        } else {
+          PayloadReader samples(data, length);
+          uint64_t ts = 0;
+          for (uint64_t i = 0; i < count; i++) {
+            uint64_t delta = 0, size = 0;
+            const uint8_t* bytes = nullptr;
+            if (!samples.get_varint(&delta) || !samples.get_varint(&size) ||
+                (bytes = samples.get_bytes(size)) == nullptr) {
+              break;
+            }
+            ts += unzigzag(delta);
+            emit(ts, field_type, bytes, size);
+          }
+        }
+      }
+      if (values.size() > 2 * kPage) {
+        std::nth_element(values.begin(), values.begin() + kPage, values.end(), by_time);
+        cutoff = values[kPage].ts;
+        values.erase(std::remove_if(values.begin(), values.end(),
+                                    [&](const rdc_field_value& v) { return v.ts > cutoff; }),
+                     values.end());
+      }
+    }
+    std::fclose(f);
+  }
+
+  std::stable_sort(values.begin(), values.end(), by_time);
+  size_t num_values = values.size();
+  history->next_since_ts = 0;
+  if (num_values > kPage) {
+    // The page ends before the first timestamp it cannot hold entirely, so
+    // the next page starts at that timestamp without repeating a value
+    uint64_t next_ts = values[kPage].ts;
+    num_values = std::lower_bound(values.begin(), values.begin() + kPage, values[kPage], by_time) -
+                 values.begin();
+    if (num_values == 0) {
+      RDC_LOG(RDC_ERROR, "More than " << kPage << " values of GPU " << gpu_index << " field "
+                                      << field_id << " at " << next_ts
+                                      << ", the next page skips the rest");
+      num_values = kPage;
+      next_ts++;
+    }
+    history->next_since_ts = next_ts;
+  }
+  history->num_values = num_values;
+  std::copy(values.begin(), values.begin() + num_values, history->values);
+  return RDC_ST_OK;
+}
+
+}  // namespace rdc
+}  // namespace amd
@@ -0,0 +1,139 @@
+/*
+Copyright (c) 2024 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "rdc_lib/impl/RdcJobGauges.h"
+
+#include <stdlib.h>
+#include <sys/time.h>
+
+#include "rdc_lib/RdcLogger.h"
+
+namespace amd {
+namespace rdc {
+
+RdcJobGauges::RdcJobGauges(const RdcCacheManagerPtr& cache_mgr,
+                           const RdcMetricFetcherPtr& metric_fetcher,
+                           const RdcWatchTablePtr& watch_table)
+    : cache_mgr_(cache_mgr),
+      metric_fetcher_(metric_fetcher),
+      watch_table_(watch_table),
+      max_age_(10 * 1000) {
+  const char* max_age = getenv("RDC_JOB_GAUGE_MAX_AGE");
+  if (max_age != nullptr) {
+    char* end = nullptr;
+    uint64_t seconds = strtoull(max_age, &end, 10);
+    if (end == max_age || *end != '\0') {
+      RDC_LOG(RDC_ERROR, "Invalid RDC_JOB_GAUGE_MAX_AGE " << max_age << ", using 10 seconds");
+    } else {
+      max_age_ = seconds * 1000;
+    }
+  }
+}
+
+rdc_status_t RdcJobGauges::get_ecc(uint32_t gpu_index, rdc_field_t field, RdcEccGauges ecc,
+                                   uint64_t now, uint64_t* value) {
+  // A job boundary takes a watch sample only as old as a fetch the watch
+  // itself would make, a running job takes any recent one
+  uint64_t max_age = max_age_;
+  bool usable = true;
+  if (ecc == RDC_ECC_GAUGES_FRESH) {
+    uint64_t update_freq = 0;
+    usable = watch_table_->rdc_field_get_update_freq(gpu_index, field, &update_freq) == RDC_ST_OK;
+    max_age = update_freq / 1000;
+  }
+
+  rdc_field_value sample;
+  if (usable && cache_mgr_->rdc_field_get_latest_value(gpu_index, field, &sample) == RDC_ST_OK &&
+      sample.type == INTEGER && sample.ts + max_age >= now) {
+    *value = sample.value.l_int;
+    return RDC_ST_OK;
+  }
+
+  if (ecc == RDC_ECC_GAUGES_MEMOIZED) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto gauge = ecc_gauges_.find({gpu_index, field});
+    if (gauge != ecc_gauges_.end() && gauge->second.ts + max_age_ >= now) {
+      *value = gauge->second.value.l_int;
+      return RDC_ST_OK;
+    }
+  }
+
+  rdc_status_t status = metric_fetcher_->fetch_smi_field(gpu_index, field, &sample);
+  if (status != RDC_ST_OK) {
+    return status;
+  }
+  sample.ts = now;
+  *value = sample.value.l_int;
+  std::lock_guard<std::mutex> guard(mutex_);
+  ecc_gauges_[{gpu_index, field}] = sample;
+  return RDC_ST_OK;
+}
+
+rdc_status_t RdcJobGauges::get(const std::vector<uint32_t>& gpu_indexes, RdcEccGauges ecc,
+                               rdc_gpu_gauges_t* gpu_gauges) {
+  if (gpu_gauges == nullptr) {
+    return RDC_ST_BAD_PARAMETER;
+  }
+
+  struct timeval tv;
+  gettimeofday(&tv, nullptr);
+  uint64_t now = static_cast<uint64_t>(tv.tv_sec) * 1000 + tv.tv_usec / 1000;
+
+  for (auto gpu_index : gpu_indexes) {
+    uint64_t total = 0;
+    bool cached = false;
+    do {
+      std::lock_guard<std::mutex> guard(mutex_);
+      auto memory_total = memory_totals_.find(gpu_index);
+      if (memory_total != memory_totals_.end()) {
+        total = memory_total->second;
+        cached = true;
+      }
+    } while (0);
+    if (!cached) {
+      rdc_field_value value;
+      rdc_status_t status =
+          metric_fetcher_->fetch_smi_field(gpu_index, RDC_FI_GPU_MEMORY_TOTAL, &value);
+      if (status != RDC_ST_OK) {
+        RDC_LOG(RDC_ERROR, "Fail to get total memory of GPU " << gpu_index);
+        return status;
+      }
+      total = static_cast<uint64_t>(value.value.l_int);
+      std::lock_guard<std::mutex> guard(mutex_);
+      memory_totals_[gpu_index] = total;
+    }
+    gpu_gauges->insert({{gpu_index, RDC_FI_GPU_MEMORY_TOTAL}, total});
+
+    if (ecc == RDC_ECC_GAUGES_NONE) {
+      continue;
+    }
+    for (auto field : {RDC_FI_ECC_CORRECT_TOTAL, RDC_FI_ECC_UNCORRECT_TOTAL}) {
+      uint64_t count = 0;
+      if (get_ecc(gpu_index, field, ecc, now, &count) == RDC_ST_OK) {
+        gpu_gauges->insert({{gpu_index, field}, count});
+      }
+    }
+  }
+  return RDC_ST_OK;
+}
+
+}  // namespace rdc
+}  // namespace amd
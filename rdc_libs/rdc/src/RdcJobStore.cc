@@ -0,0 +1,409 @@
+/*
+Copyright (c) 2024 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "rdc_lib/impl/RdcJobStore.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdlib>
+
+#include "rdc_lib/RdcException.h"
+#include "rdc_lib/RdcLogger.h"
+#include "rdc_lib/impl/RdcChecksum.h"
+#include "rdc_lib/rdc_common.h"
+
+namespace amd {
+namespace rdc {
+
+namespace {
+
+// The magic is bumped whenever rdc_gpu_usage_info_t changes, as the records
+// hold it as is
+const char kFileMagic[8] = {'R', 'D', 'C', 'J', 'O', 'B', '0', '1'};
+const uint32_t kRecordMagic = 0x424f4a52;  // "RJOB"
+const uint32_t kMaxPayloadBytes = 1024 * 1024;
+const uint32_t kMaxJobGpus = sizeof(rdc_job_info_t::gpus) / sizeof(rdc_gpu_usage_info_t);
+
+struct RdcJobFileHeader {
+  char magic[8];
+  uint64_t reserved;
+};
+
+struct RdcJobRecordHeader {
+  uint32_t magic;
+  uint32_t payload_bytes;
+  uint32_t checksum;  //!< CRC32 of the payload
+  uint32_t reserved;
+};
+static_assert(sizeof(RdcJobRecordHeader) == 16, "The record header must be 16 bytes");
+
+struct RdcJobRecordPrefix {
+  char job_id[64];
+  uint32_t num_gpus;
+  uint32_t reserved;
+  rdc_gpu_usage_info_t summary;
+};
+
+struct RdcJobRecordGpu {
+  uint32_t gpu_index;
+  uint32_t reserved;
+  rdc_gpu_usage_info_t usage;
+};
+
+struct RdcJobRecordTimeline {
+  uint32_t gpu_index;
+  uint32_t field_id;
+  RdcJobTimeline timeline;
+};
+
+bool pread_all(int fd, void* buf, size_t length, uint64_t offset) {
+  char* dst = static_cast<char*>(buf);
+  while (length > 0) {
+    ssize_t n = pread(fd, dst, length, offset);
+    if (n < 0 && errno == EINTR) continue;
+    if (n <= 0) return false;
+    dst += n;
+    length -= n;
+    offset += n;
+  }
+  return true;
+}
+
+bool pwrite_all(int fd, const void* buf, size_t length, uint64_t offset) {
+  const char* src = static_cast<const char*>(buf);
+  while (length > 0) {
+    ssize_t n = pwrite(fd, src, length, offset);
+    if (n < 0 && errno == EINTR) continue;
+    if (n <= 0) return false;
+    src += n;
+    length -= n;
+    offset += n;
+  }
+  return true;
+}
+
+// The summary a filter applies to, nullptr if the field is not in the job stats
+const rdc_stats_summary_t* filtered_summary(const rdc_gpu_usage_info_t& info,
+                                            rdc_field_t field_id) {
+  switch (field_id) {
+    case RDC_FI_POWER_USAGE:
+      return &info.power_usage;
+    case RDC_FI_GPU_CLOCK:
+      return &info.gpu_clock;
+    case RDC_FI_MEM_CLOCK:
+      return &info.memory_clock;
+    case RDC_FI_GPU_UTIL:
+      return &info.gpu_utilization;
+    case RDC_FI_GPU_MEMORY_USAGE:
+      return &info.memory_utilization;
+    case RDC_FI_GPU_TEMP:
+      return &info.gpu_temperature;
+    case RDC_FI_PCIE_TX:
+      return &info.pcie_tx;
+    case RDC_FI_PCIE_RX:
+      return &info.pcie_rx;
+    default:
+      return nullptr;
+  }
+}
+
+}  // namespace
+
+RdcJobStore::RdcJobStore(const std::string& dir)
+    : path_(dir + "/jobs.log"), fd_(-1), file_bytes_(0) {
+  if (mkdir(dir.c_str(), 0750) != 0 && errno != EEXIST) {
+    throw RdcException(RDC_ST_FILE_ERROR,
+                       "Fail to create the job store directory " + dir + ": " + strerror(errno));
+  }
+  fd_ = open(path_.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0640);
+  if (fd_ < 0) {
+    throw RdcException(RDC_ST_FILE_ERROR, "Fail to open " + path_ + ": " + strerror(errno));
+  }
+
+  struct stat st;
+  RdcJobFileHeader header;
+  if (fstat(fd_, &st) != 0) {
+    close(fd_);
+    throw RdcException(RDC_ST_FILE_ERROR, "Fail to stat " + path_);
+  }
+  if (st.st_size == 0) {
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, kFileMagic, sizeof(kFileMagic));
+    if (!pwrite_all(fd_, &header, sizeof(header), 0)) {
+      close(fd_);
+      throw RdcException(RDC_ST_FILE_ERROR, "Fail to write " + path_);
+    }
+    file_bytes_ = sizeof(header);
+    return;
+  }
+  if (!pread_all(fd_, &header, sizeof(header), 0) ||
+      memcmp(header.magic, kFileMagic, sizeof(kFileMagic)) != 0) {
+    close(fd_);
+    throw RdcException(RDC_ST_FILE_ERROR, path_ + " is not a job store of this version");
+  }
+
+  // Rebuild the indexes, stopping at the first record which does not check
+  uint64_t offset = sizeof(header);
+  std::string payload;
+  while (offset + sizeof(RdcJobRecordHeader) <= static_cast<uint64_t>(st.st_size)) {
+    RdcJobRecordHeader rh;
+    if (!pread_all(fd_, &rh, sizeof(rh), offset) || rh.magic != kRecordMagic ||
+        rh.payload_bytes < sizeof(RdcJobRecordPrefix) ||
+        !read_payload(offset, rh.payload_bytes, &payload)) {
+      break;
+    }
+    RdcJobRecordPrefix prefix;
+    memcpy(&prefix, payload.data(), sizeof(prefix));
+    prefix.job_id[sizeof(prefix.job_id) - 1] = '\0';
+    index_record(offset, prefix.job_id, prefix.summary.start_time, rh.payload_bytes);
+    offset += sizeof(rh) + rh.payload_bytes;
+  }
+  if (offset < static_cast<uint64_t>(st.st_size)) {
+    RDC_LOG(RDC_ERROR, "Cut " << st.st_size - offset << " bytes of torn records from " << path_);
+    if (ftruncate(fd_, offset) != 0) {
+      RDC_LOG(RDC_ERROR, "Fail to truncate " << path_ << ": " << strerror(errno));
+    }
+  }
+  file_bytes_ = offset;
+  RDC_LOG(RDC_INFO, "Job store " << path_ << " with " << records_.size() << " jobs");
+}
+
+RdcJobStore::~RdcJobStore() {
+  if (fd_ >= 0) {
+    close(fd_);
+  }
+}
+
+std::unique_ptr<RdcJobStore> RdcJobStore::from_env() {
+  const char* dir = getenv("RDC_JOB_STORE_DIR");
+  if (dir == nullptr || dir[0] == '\0') {
+    return nullptr;
+  }
+  try {
+    return std::unique_ptr<RdcJobStore>(new RdcJobStore(dir));
+  } catch (const RdcException& e) {
+    RDC_LOG(RDC_ERROR, e.what() << ", the job store is off");
+  }
+  return nullptr;
+}
+
+bool RdcJobStore::read_payload(uint64_t offset, uint32_t payload_bytes, std::string* payload) {
+  RdcJobRecordHeader rh;
+  if (payload_bytes > kMaxPayloadBytes || !pread_all(fd_, &rh, sizeof(rh), offset) ||
+      rh.magic != kRecordMagic || rh.payload_bytes != payload_bytes) {
+    return false;
+  }
+  payload->resize(payload_bytes);
+  if (!pread_all(fd_, &(*payload)[0], payload_bytes, offset + sizeof(rh))) {
+    return false;
+  }
+  return rdc_crc32(0, payload->data(), payload_bytes) == rh.checksum;
+}
+
+void RdcJobStore::index_record(uint64_t offset, const std::string& job_id, uint64_t start_time,
+                               uint32_t payload_bytes) {
+  records_[offset] = {start_time, payload_bytes};
+  by_job_id_[job_id] = offset;
+  by_start_time_.insert({start_time, offset});
+}
+
+bool RdcJobStore::append(const std::string& job_id, const std::vector<uint32_t>& gpu_indexes,
+                         const rdc_job_info_t& info, const RdcJobTimelines& timelines) {
+  std::string payload;
+  RdcJobRecordPrefix prefix;
+  memset(&prefix, 0, sizeof(prefix));
+  strncpy_with_null(prefix.job_id, job_id.c_str(), sizeof(prefix.job_id));
+  prefix.num_gpus = 0;
+  prefix.summary = info.summary;
+  payload.append(reinterpret_cast<const char*>(&prefix), sizeof(prefix));
+  for (uint32_t gpu_index : gpu_indexes) {
+    if (gpu_index >= kMaxJobGpus) continue;
+    RdcJobRecordGpu gpu;
+    memset(&gpu, 0, sizeof(gpu));
+    gpu.gpu_index = gpu_index;
+    gpu.usage = info.gpus[gpu_index];
+    payload.append(reinterpret_cast<const char*>(&gpu), sizeof(gpu));
+    prefix.num_gpus++;
+  }
+  memcpy(&payload[0], &prefix, sizeof(prefix));
+
+  // The timelines which do not fit in a record are dropped
+  uint32_t num_timelines = 0;
+  size_t count_at = payload.size();
+  payload.append(reinterpret_cast<const char*>(&num_timelines), sizeof(num_timelines));
+  for (const auto& timeline : timelines) {
+    if (payload.size() + sizeof(RdcJobRecordTimeline) > kMaxPayloadBytes) {
+      RDC_LOG(RDC_ERROR, "Drop " << timelines.size() - num_timelines << " timelines of the job "
+                                 << job_id << ", they do not fit in its record");
+      break;
+    }
+    RdcJobRecordTimeline record;
+    record.gpu_index = timeline.first.first;
+    record.field_id = timeline.first.second;
+    record.timeline = timeline.second;
+    payload.append(reinterpret_cast<const char*>(&record), sizeof(record));
+    num_timelines++;
+  }
+  memcpy(&payload[count_at], &num_timelines, sizeof(num_timelines));
+
+  RdcJobRecordHeader rh;
+  rh.magic = kRecordMagic;
+  rh.payload_bytes = payload.size();
+  rh.checksum = rdc_crc32(0, payload.data(), payload.size());
+  rh.reserved = 0;
+  payload.insert(0, reinterpret_cast<const char*>(&rh), sizeof(rh));
+
+  std::lock_guard<std::mutex> guard(mutex_);
+  if (!pwrite_all(fd_, payload.data(), payload.size(), file_bytes_)) {
+    RDC_LOG(RDC_ERROR, "Fail to append the job " << job_id << " to " << path_ << ": "
+                                                  << strerror(errno));
+    // A partial record is overwritten by the next one
+    return false;
+  }
+  index_record(file_bytes_, prefix.job_id, info.summary.start_time, rh.payload_bytes);
+  file_bytes_ += payload.size();
+  return true;
+}
+
+rdc_status_t RdcJobStore::get(const std::string& job_id, rdc_job_info_t* info) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto ite = by_job_id_.find(job_id);
+  if (ite == by_job_id_.end()) {
+    return RDC_ST_NOT_FOUND;
+  }
+  std::string payload;
+  if (!read_payload(ite->second, records_[ite->second].payload_bytes, &payload)) {
+    RDC_LOG(RDC_ERROR, "Fail to read the job " << job_id << " from " << path_);
+    return RDC_ST_FILE_ERROR;
+  }
+
+  RdcJobRecordPrefix prefix;
+  memcpy(&prefix, payload.data(), sizeof(prefix));
+  info->num_gpus = 0;
+  info->summary = prefix.summary;
+  for (uint32_t i = 0; i < prefix.num_gpus; i++) {
+    size_t at = sizeof(prefix) + i * sizeof(RdcJobRecordGpu);
+    if (at + sizeof(RdcJobRecordGpu) > payload.size()) break;
+    RdcJobRecordGpu gpu;
+    memcpy(&gpu, payload.data() + at, sizeof(gpu));
+    if (gpu.gpu_index >= kMaxJobGpus) continue;
+    info->gpus[gpu.gpu_index] = gpu.usage;
+    info->num_gpus++;
+  }
+  return RDC_ST_OK;
+}
+
+rdc_status_t RdcJobStore::list(const rdc_job_filter_t& filter, rdc_job_list_t* jobs) {
+  const rdc_gpu_usage_info_t probe = {};
+  if (filter.field_id != RDC_FI_INVALID && filtered_summary(probe, filter.field_id) == nullptr) {
+    return RDC_ST_BAD_PARAMETER;
+  }
+
+  jobs->num_jobs = 0;
+  jobs->next_cursor = 0;
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto ite = by_start_time_.lower_bound({filter.start_since, 0});
+  if (filter.cursor != 0) {
+    auto record = records_.find(filter.cursor);
+    if (record == records_.end()) {
+      return RDC_ST_BAD_PARAMETER;
+    }
+    ite = by_start_time_.lower_bound({record->second.start_time, filter.cursor});
+  }
+
+  std::string payload;
+  for (; ite != by_start_time_.end(); ite++) {
+    if (filter.start_until != 0 && ite->first > filter.start_until) break;
+    if (jobs->num_jobs == RDC_MAX_JOB_LIST) {
+      jobs->next_cursor = ite->second;
+      break;
+    }
+    if (!read_payload(ite->second, records_[ite->second].payload_bytes, &payload)) {
+      RDC_LOG(RDC_ERROR, "Skip the unreadable job record at " << ite->second << " of " << path_);
+      continue;
+    }
+    RdcJobRecordPrefix prefix;
+    memcpy(&prefix, payload.data(), sizeof(prefix));
+    if (filter.field_id != RDC_FI_INVALID) {
+      uint64_t average = filtered_summary(prefix.summary, filter.field_id)->average;
+      if (average < filter.min_average ||
+          (filter.max_average != 0 && average > filter.max_average)) {
+        continue;
+      }
+    }
+    rdc_job_record_t& job = jobs->jobs[jobs->num_jobs++];
+    strncpy_with_null(job.job_id, prefix.job_id, sizeof(job.job_id));
+    job.num_gpus = prefix.num_gpus;
+    job.summary = prefix.summary;
+  }
+  return RDC_ST_OK;
+}
+
+rdc_status_t RdcJobStore::get_timeline(const std::string& job_id, uint32_t gpu_index,
+                                       uint32_t field_id, RdcJobTimeline* timeline) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto ite = by_job_id_.find(job_id);
+  if (ite == by_job_id_.end()) {
+    return RDC_ST_NOT_FOUND;
+  }
+  std::string payload;
+  if (!read_payload(ite->second, records_[ite->second].payload_bytes, &payload)) {
+    RDC_LOG(RDC_ERROR, "Fail to read the job " << job_id << " from " << path_);
+    return RDC_ST_FILE_ERROR;
+  }
+
+  RdcJobRecordPrefix prefix;
+  memcpy(&prefix, payload.data(), sizeof(prefix));
+  size_t at = sizeof(prefix) + static_cast<size_t>(prefix.num_gpus) * sizeof(RdcJobRecordGpu);
+  uint32_t num_timelines = 0;
+  if (at + sizeof(num_timelines) > payload.size()) {
+    return RDC_ST_NOT_FOUND;
+  }
+  memcpy(&num_timelines, payload.data() + at, sizeof(num_timelines));
+  at += sizeof(num_timelines);
+  for (uint32_t i = 0; i < num_timelines; i++, at += sizeof(RdcJobRecordTimeline)) {
+    if (at + sizeof(RdcJobRecordTimeline) > payload.size()) break;
+    RdcJobRecordTimeline record;
+    memcpy(&record, payload.data() + at, sizeof(record));
+    if (record.gpu_index == gpu_index && record.field_id == field_id) {
+      *timeline = record.timeline;
+      return RDC_ST_OK;
+    }
+  }
+  return RDC_ST_NOT_FOUND;
+}
+
+bool RdcJobStore::contains(const std::string& job_id) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return by_job_id_.find(job_id) != by_job_id_.end();
+}
+
+size_t RdcJobStore::num_records() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return records_.size();
+}
+
+}  // namespace rdc
+}  // namespace amd
@@ -0,0 +1,84 @@
+/*
+Copyright (c) 2024 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "rdc_lib/impl/RdcJobTimeline.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+namespace amd {
+namespace rdc {
+
+RdcJobTimeline::RdcJobTimeline() : start_time_(0), width_(kInitialWidth), num_buckets_(0) {
+  memset(buckets_, 0, sizeof(buckets_));
+}
+
+void RdcJobTimeline::merge_pairs() {
+  for (uint32_t i = 0; i < kMaxBuckets / 2; i++) {
+    const Bucket& a = buckets_[2 * i];
+    const Bucket& b = buckets_[2 * i + 1];
+    Bucket merged;
+    merged.sum = a.sum + b.sum;
+    merged.count = a.count + b.count;
+    if (a.count == 0) {
+      merged.min_value = b.min_value;
+      merged.max_value = b.max_value;
+    } else if (b.count == 0) {
+      merged.min_value = a.min_value;
+      merged.max_value = a.max_value;
+    } else {
+      merged.min_value = std::min(a.min_value, b.min_value);
+      merged.max_value = std::max(a.max_value, b.max_value);
+    }
+    buckets_[i] = merged;
+  }
+  memset(buckets_ + kMaxBuckets / 2, 0, sizeof(buckets_) / 2);
+  num_buckets_ = (num_buckets_ + 1) / 2;
+  width_ *= 2;
+}
+
+void RdcJobTimeline::add(uint64_t ts, int64_t value) {
+  if (num_buckets_ == 0) {
+    start_time_ = ts;
+  }
+
+  uint64_t offset = ts > start_time_ ? ts - start_time_ : 0;
+  while (offset / width_ >= kMaxBuckets) {
+    merge_pairs();
+  }
+
+  uint32_t index = static_cast<uint32_t>(offset / width_);
+  Bucket& b = buckets_[index];
+  float v = static_cast<float>(value);
+  if (b.count == 0) {
+    b.min_value = b.max_value = v;
+  } else {
+    b.min_value = std::min(b.min_value, v);
+    b.max_value = std::max(b.max_value, v);
+  }
+  b.sum += value;
+  b.count++;
+  num_buckets_ = std::max(num_buckets_, index + 1);
+}
+
+}  // namespace rdc
+}  // namespace amd
@@ -32,8 +32,10 @@ THE SOFTWARE.
 #include "amd_smi/amdsmi.h"
 #include "common/rdc_capabilities.h"
 #include "common/rdc_fields_supported.h"
+#include "common/rdc_perf_histogram.h"
 #include "rdc/rdc.h"
 #include "rdc_lib/RdcLogger.h"
+#include "rdc_lib/RdcPipelineTrace.h"
 #include "rdc_lib/impl/SmiUtils.h"
 #include "rdc_lib/rdc_common.h"
 
@@ -176,7 +178,7 @@ void RdcMetricFetcherImpl::get_ecc(uint32_t gpu_index, rdc_field_t field_id,
     value->status = AMDSMI_STATUS_INPUT_OUT_OF_BOUNDS;
   }
 
-  err = amdsmi_get_gpu_ecc_status(processor_handle, gpu_block, &err_state);
+  err = get_smi_backend()->get_gpu_ecc_status(processor_handle, gpu_block, &err_state);
   if (err != AMDSMI_STATUS_SUCCESS) {
     RDC_LOG(RDC_INFO, "Error in ecc status [" << gpu_block << "]:" << err);
     value->status = err;
@@ -184,7 +186,7 @@ void RdcMetricFetcherImpl::get_ecc(uint32_t gpu_index, rdc_field_t field_id,
   }
 
   amdsmi_error_count_t ec;
-  err = amdsmi_get_gpu_ecc_count(processor_handle, gpu_block, &ec);
+  err = get_smi_backend()->get_gpu_ecc_count(processor_handle, gpu_block, &ec);
   if (err != AMDSMI_STATUS_SUCCESS) {
     RDC_LOG(RDC_ERROR, "Error in ecc count [" << gpu_block << "]:" << err);
     value->status = err;
@@ -214,15 +216,16 @@ void RdcMetricFetcherImpl::get_ecc_total(uint32_t gpu_index, rdc_field_t field_i
     return;
   }
   for (uint32_t b = AMDSMI_GPU_BLOCK_FIRST; b <= AMDSMI_GPU_BLOCK_LAST; b = b * 2) {
-    err =
-        amdsmi_get_gpu_ecc_status(processor_handle, static_cast<amdsmi_gpu_block_t>(b), &err_state);
+    err = get_smi_backend()->get_gpu_ecc_status(processor_handle,
+                                                static_cast<amdsmi_gpu_block_t>(b), &err_state);
     if (err != AMDSMI_STATUS_SUCCESS) {
       RDC_LOG(RDC_INFO, "Get the ecc Status error " << b << ":" << err);
       continue;
     }
 
     amdsmi_error_count_t ec;
-    err = amdsmi_get_gpu_ecc_count(processor_handle, static_cast<amdsmi_gpu_block_t>(b), &ec);
+    err = get_smi_backend()->get_gpu_ecc_count(processor_handle,
+                                               static_cast<amdsmi_gpu_block_t>(b), &ec);
 
     if (err == AMDSMI_STATUS_SUCCESS) {
       correctable_count += ec.correctable_count;
@@ -292,7 +295,7 @@ void RdcMetricFetcherImpl::get_pcie_throughput(const RdcFieldKey& key) {
     }
   } while (0);
 
-  ret = amdsmi_get_gpu_pci_throughput(processor_handle, &sent, &received, &max_pkt_sz);
+  ret = get_smi_backend()->get_gpu_pci_throughput(processor_handle, &sent, &received, &max_pkt_sz);
 
   uint64_t curTime = now();
   MetricValue value;
@@ -335,9 +338,24 @@ void RdcMetricFetcherImpl::get_pcie_throughput(const RdcFieldKey& key) {
   } while (0);
 }
 
+// The fetch latency histogram of a field, looked up once per thread and field
+static RdcPerfHistogram& fetch_field_histogram(rdc_field_t field_id) {
+  thread_local std::unordered_map<uint32_t, RdcPerfHistogram*> histograms;
+  auto ite = histograms.find(field_id);
+  if (ite != histograms.end()) {
+    return *ite->second;
+  }
+  RdcPerfHistogram& histogram = RdcPerfRegistry::get_instance().get_histogram(
+      std::string("fetch_smi_field.") + field_id_string(field_id));
+  histograms[field_id] = &histogram;
+  return histogram;
+}
+
 rdc_status_t RdcMetricFetcherImpl::bulk_fetch_smi_fields(
     rdc_gpu_field_t* fields, uint32_t fields_count,
     std::vector<rdc_gpu_field_value_t>& results) {  // NOLINT
+  RDC_PERF_SCOPE("bulk_fetch_smi_fields");
+  RDC_PIPELINE_SCOPE("bulk_fetch_smi_fields");
   const std::set<rdc_field_t> rdc_bulk_fields = {
       RDC_FI_GPU_CLOCK,    // current_gfxclk * 1000000
       RDC_FI_MEMORY_TEMP,  // temperature_mem
@@ -370,7 +388,7 @@ rdc_status_t RdcMetricFetcherImpl::bulk_fetch_smi_fields(
     amdsmi_processor_handle processor_handle;
     rs = get_processor_handle_from_id(ite->first, &processor_handle);
 
-    rs = amdsmi_get_gpu_metrics_info(processor_handle, &gpu_metrics);
+    rs = get_smi_backend()->get_gpu_metrics_info(processor_handle, &gpu_metrics);
     if (rs != AMDSMI_STATUS_SUCCESS) {
       results.clear();
       return RDC_ST_NOT_SUPPORTED;
@@ -481,6 +499,8 @@ rdc_status_t RdcMetricFetcherImpl::fetch_smi_field(uint32_t gpu_index, rdc_field
     RDC_LOG(RDC_ERROR, "Fail to fetch field " << field_id << " which is not supported");
     return RDC_ST_NOT_SUPPORTED;
   }
+  RdcScopedPerfTimer perf_timer(fetch_field_histogram(field_id));
+  RDC_PIPELINE_SCOPE("fetch_smi_field", gpu_index, field_id);
 
   value->ts = now();
   value->field_id = field_id;
@@ -494,14 +514,15 @@ rdc_status_t RdcMetricFetcherImpl::fetch_smi_field(uint32_t gpu_index, rdc_field
       return;
     }
 
-    value->status = amdsmi_gpu_read_counter(smi_data->evt_handle, &smi_data->counter_val);
+    value->status =
+        get_smi_backend()->gpu_read_counter(smi_data->evt_handle, &smi_data->counter_val);
     value->value.l_int = smi_data->counter_val.value;
     value->type = INTEGER;
   };
 
   auto read_gpu_metrics_uint64_t = [&](void) {
     amdsmi_gpu_metrics_t gpu_metrics;
-    value->status = amdsmi_get_gpu_metrics_info(processor_handle, &gpu_metrics);
+    value->status = get_smi_backend()->get_gpu_metrics_info(processor_handle, &gpu_metrics);
     RDC_LOG(RDC_DEBUG, "Read the gpu metrics:" << value->status);
     if (value->status != AMDSMI_STATUS_SUCCESS) {
       return;
@@ -548,7 +569,8 @@ rdc_status_t RdcMetricFetcherImpl::fetch_smi_field(uint32_t gpu_index, rdc_field
   switch (field_id) {
     case RDC_FI_GPU_MEMORY_USAGE: {
       uint64_t u64 = 0;
-      value->status = amdsmi_get_gpu_memory_usage(processor_handle, AMDSMI_MEM_TYPE_VRAM, &u64);
+      value->status =
+          get_smi_backend()->get_gpu_memory_usage(processor_handle, AMDSMI_MEM_TYPE_VRAM, &u64);
       value->type = INTEGER;
       if (value->status == AMDSMI_STATUS_SUCCESS) {
         value->value.l_int = static_cast<int64_t>(u64);
@@ -557,7 +579,8 @@ rdc_status_t RdcMetricFetcherImpl::fetch_smi_field(uint32_t gpu_index, rdc_field
     }
     case RDC_FI_GPU_MEMORY_TOTAL: {
       uint64_t u64 = 0;
-      value->status = amdsmi_get_gpu_memory_total(processor_handle, AMDSMI_MEM_TYPE_VRAM, &u64);
+      value->status =
+          get_smi_backend()->get_gpu_memory_total(processor_handle, AMDSMI_MEM_TYPE_VRAM, &u64);
       value->type = INTEGER;
       if (value->status == AMDSMI_STATUS_SUCCESS) {
         value->value.l_int = static_cast<int64_t>(u64);
@@ -566,7 +589,7 @@ rdc_status_t RdcMetricFetcherImpl::fetch_smi_field(uint32_t gpu_index, rdc_field
     }
     case RDC_FI_GPU_MEMORY_ACTIVITY: {
       amdsmi_engine_usage_t engine_usage;
-      value->status = amdsmi_get_gpu_activity(processor_handle, &engine_usage);
+      value->status = get_smi_backend()->get_gpu_activity(processor_handle, &engine_usage);
       value->type = INTEGER;
       if (value->status == AMDSMI_STATUS_SUCCESS) {
         value->value.l_int = static_cast<int64_t>(engine_usage.umc_activity);
@@ -584,7 +607,7 @@ rdc_status_t RdcMetricFetcherImpl::fetch_smi_field(uint32_t gpu_index, rdc_field
     } break;
     case RDC_FI_POWER_USAGE: {
       amdsmi_power_info_t power_info = {};
-      value->status = amdsmi_get_power_info(processor_handle, &power_info);
+      value->status = get_smi_backend()->get_power_info(processor_handle, &power_info);
       value->type = INTEGER;
       if (value->status != AMDSMI_STATUS_SUCCESS) {
         RDC_LOG(RDC_ERROR, "amdsmi_get_power_info failed!");
@@ -615,7 +638,7 @@ rdc_status_t RdcMetricFetcherImpl::fetch_smi_field(uint32_t gpu_index, rdc_field
         clk_type = AMDSMI_CLK_TYPE_MEM;
       }
       amdsmi_frequencies_t f = {};
-      value->status = amdsmi_get_clk_freq(processor_handle, clk_type, &f);
+      value->status = get_smi_backend()->get_clk_freq(processor_handle, clk_type, &f);
       value->type = INTEGER;
       if (value->status == AMDSMI_STATUS_SUCCESS) {
         value->value.l_int = f.frequency[f.current];
@@ -624,7 +647,7 @@ rdc_status_t RdcMetricFetcherImpl::fetch_smi_field(uint32_t gpu_index, rdc_field
     }
     case RDC_FI_GPU_UTIL: {
       amdsmi_engine_usage_t engine_usage;
-      value->status = amdsmi_get_gpu_activity(processor_handle, &engine_usage);
+      value->status = get_smi_backend()->get_gpu_activity(processor_handle, &engine_usage);
       value->type = INTEGER;
       if (value->status == AMDSMI_STATUS_SUCCESS) {
         value->value.l_int = static_cast<int64_t>(engine_usage.gfx_activity);
@@ -633,7 +656,7 @@ rdc_status_t RdcMetricFetcherImpl::fetch_smi_field(uint32_t gpu_index, rdc_field
     }
     case RDC_FI_DEV_NAME: {
       amdsmi_asic_info_t asic_info;
-      value->status = amdsmi_get_gpu_asic_info(processor_handle, &asic_info);
+      value->status = get_smi_backend()->get_gpu_asic_info(processor_handle, &asic_info);
       value->type = STRING;
       if (value->status == AMDSMI_STATUS_SUCCESS) {
         memcpy(value->value.str, asic_info.market_name, sizeof(asic_info.market_name));
@@ -647,15 +670,15 @@ rdc_status_t RdcMetricFetcherImpl::fetch_smi_field(uint32_t gpu_index, rdc_field
       if (field_id == RDC_FI_MEMORY_TEMP) {
         sensor_type = AMDSMI_TEMPERATURE_TYPE_VRAM;
       }
-      value->status =
-          amdsmi_get_temp_metric(processor_handle, sensor_type, AMDSMI_TEMP_CURRENT, &i64);
+      value->status = get_smi_backend()->get_temp_metric(processor_handle, sensor_type,
+                                                         AMDSMI_TEMP_CURRENT, &i64);
 
       // fallback to hotspot temperature as some card may not have edge temperature.
       if (sensor_type == AMDSMI_TEMPERATURE_TYPE_EDGE &&
           value->status == AMDSMI_STATUS_NOT_SUPPORTED) {
         sensor_type = AMDSMI_TEMPERATURE_TYPE_JUNCTION;
-        value->status =
-            amdsmi_get_temp_metric(processor_handle, sensor_type, AMDSMI_TEMP_CURRENT, &i64);
+        value->status = get_smi_backend()->get_temp_metric(processor_handle, sensor_type,
+                                                           AMDSMI_TEMP_CURRENT, &i64);
       }
 
       value->type = INTEGER;
@@ -666,7 +689,7 @@ rdc_status_t RdcMetricFetcherImpl::fetch_smi_field(uint32_t gpu_index, rdc_field
     }
     case RDC_FI_OAM_ID: {
       amdsmi_asic_info_t asic_info;
-      value->status = amdsmi_get_gpu_asic_info(processor_handle, &asic_info);
+      value->status = get_smi_backend()->get_gpu_asic_info(processor_handle, &asic_info);
       value->type = INTEGER;
       if (value->status == AMDSMI_STATUS_SUCCESS) {
         // 0xFFFF means not supported for OAM ID
@@ -689,8 +712,8 @@ rdc_status_t RdcMetricFetcherImpl::fetch_smi_field(uint32_t gpu_index, rdc_field
       utilization_counters[0].type = AMDSMI_COARSE_DECODER_ACTIVITY;
       uint64_t timestamp;
 
-      value->status = amdsmi_get_utilization_count(processor_handle, utilization_counters,
-                                                  kUTILIZATION_COUNTERS, &timestamp);
+      value->status = get_smi_backend()->get_utilization_count(
+          processor_handle, utilization_counters, kUTILIZATION_COUNTERS, &timestamp);
       value->type = INTEGER;
       if (value->status == AMDSMI_STATUS_SUCCESS) {
         value->value.l_int = static_cast<int64_t>(utilization_counters[0].value);
@@ -843,13 +866,13 @@ static rdc_status_t init_smi_counter(RdcFieldKey fk, amdsmi_event_group_t grp,
   amdsmi_processor_handle processor_handle;
   ret = get_processor_handle_from_id(dv_ind, &processor_handle);
 
-  ret = amdsmi_gpu_counter_group_supported(processor_handle, grp);
+  ret = get_smi_backend()->gpu_counter_group_supported(processor_handle, grp);
 
   if (ret != AMDSMI_STATUS_SUCCESS) {
     return Smi2RdcError(ret);
   }
 
-  ret = amdsmi_get_gpu_available_counters(processor_handle, grp, &counters_available);
+  ret = get_smi_backend()->get_gpu_available_counters(processor_handle, grp, &counters_available);
   if (ret != AMDSMI_STATUS_SUCCESS) {
     return Smi2RdcError(ret);
   }
@@ -867,12 +890,12 @@ static rdc_status_t init_smi_counter(RdcFieldKey fk, amdsmi_event_group_t grp,
     return RDC_ST_PERM_ERROR;
   }
 
-  ret = amdsmi_gpu_create_counter(processor_handle, evt, handle);
+  ret = get_smi_backend()->gpu_create_counter(processor_handle, evt, handle);
   if (ret != AMDSMI_STATUS_SUCCESS) {
     return Smi2RdcError(ret);
   }
 
-  ret = amdsmi_gpu_control_counter(*handle, AMDSMI_CNTR_CMD_START, nullptr);
+  ret = get_smi_backend()->gpu_control_counter(*handle, AMDSMI_CNTR_CMD_START, nullptr);
 
   // Release DAC capability
   sc.Relinquish();
@@ -911,7 +934,7 @@ rdc_status_t RdcMetricFetcherImpl::delete_smi_handle(RdcFieldKey fk) {
       h = smi_data_[fk]->evt_handle;
 
       // Stop counting.
-      ret = amdsmi_gpu_control_counter(h, AMDSMI_CNTR_CMD_STOP, nullptr);
+      ret = get_smi_backend()->gpu_control_counter(h, AMDSMI_CNTR_CMD_STOP, nullptr);
       if (ret != AMDSMI_STATUS_SUCCESS) {
         smi_data_.erase(fk);
 
@@ -921,7 +944,7 @@ rdc_status_t RdcMetricFetcherImpl::delete_smi_handle(RdcFieldKey fk) {
 
       // Release all resources (e.g., counter and memory resources) associated
       // with evnt_handle.
-      ret = amdsmi_gpu_destroy_counter(h);
+      ret = get_smi_backend()->gpu_destroy_counter(h);
 
       smi_data_.erase(fk);
       return Smi2RdcError(ret);
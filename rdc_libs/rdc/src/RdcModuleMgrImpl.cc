@@ -29,8 +29,10 @@ THE SOFTWARE.
 #include "rdc_lib/RdcException.h"
 #include "rdc_lib/RdcTelemetry.h"
 #include "rdc_lib/impl/RdcDiagnosticModule.h"
+#include "rdc_lib/impl/RdcReplayLib.h"
 #include "rdc_lib/impl/RdcRocpLib.h"
 #include "rdc_lib/impl/RdcRocrLib.h"
+#include "rdc_lib/impl/RdcSelfLib.h"
 #include "rdc_lib/impl/RdcSmiLib.h"
 #include "rdc_lib/impl/RdcTelemetryModule.h"
 
@@ -77,7 +79,17 @@ rdc_status_t RdcModuleMgrImpl::insert_modules() {
   return status;
 }
 
-RdcModuleMgrImpl::RdcModuleMgrImpl(const RdcMetricFetcherPtr& fetcher) : fetcher_(fetcher) {
+RdcModuleMgrImpl::RdcModuleMgrImpl(const RdcMetricFetcherPtr& fetcher,
+                                   const RdcAnomalyDetectorPtr& anomaly,
+                                   const RdcDerivedFieldsPtr& derived)
+    : fetcher_(fetcher) {
+  // A replayed trace is inserted first so that it serves the recorded
+  // fields instead of the modules which would read them from the GPUs
+  auto replay_module = RdcReplayLib::from_env();
+  if (replay_module) {
+    insert_modules(replay_module);
+  }
+
   // this module has a unique constructor and must be initialized explicitly
   try {
     auto smi_module = std::make_shared<RdcSmiLib>(fetcher);
@@ -87,7 +99,16 @@ RdcModuleMgrImpl::RdcModuleMgrImpl(const RdcMetricFetcherPtr& fetcher) : fetcher
   }
 
   // all other modules get initialized by insert_modules
-  insert_modules<RdcRocrLib, RdcRocpLib>();
+  insert_modules<RdcRocrLib, RdcRocpLib, RdcSelfLib>();
+
+  // The anomaly scores and derived fields are computed from the samples of
+  // the other modules
+  if (anomaly) {
+    insert_modules(anomaly);
+  }
+  if (derived) {
+    insert_modules(derived);
+  }
 }
 
 RdcTelemetryPtr RdcModuleMgrImpl::get_telemetry_module() {
@@ -108,7 +108,7 @@ rdc_status_t RdcNotificationImpl::set_listen_events(const std::vector<RdcFieldKe
       return RDC_ST_PERM_ERROR;
     }
 
-    ret = amdsmi_init_gpu_event_notification(processor_handle);
+    ret = get_smi_backend()->init_gpu_event_notification(processor_handle);
     if (ret != AMDSMI_STATUS_SUCCESS) {
       RDC_LOG(RDC_ERROR, "amdsmi_init_gpu_event_notification() returned "
                              << ret << " for device " << it->first << ". " << std::endl
@@ -116,7 +116,7 @@ rdc_status_t RdcNotificationImpl::set_listen_events(const std::vector<RdcFieldKe
       continue;
     }
 
-    ret = amdsmi_set_gpu_event_notification_mask(processor_handle, it->second);
+    ret = get_smi_backend()->set_gpu_event_notification_mask(processor_handle, it->second);
     // Release DAC capability
     sc.Relinquish();
 
@@ -148,7 +148,8 @@ rdc_status_t RdcNotificationImpl::listen(rdc_evnt_notification_t* events, uint32
   uint32_t f_cnt = std::min(*num_events, kMaxRSMIEvents);
   amdsmi_evt_notification_data_t smi_events[kMaxRSMIEvents];
 
-  amdsmi_status_t ret = amdsmi_get_gpu_event_notification(timeout_ms, &f_cnt, smi_events);
+  amdsmi_status_t ret =
+      get_smi_backend()->get_gpu_event_notification(timeout_ms, &f_cnt, smi_events);
 
   if (ret != AMDSMI_STATUS_SUCCESS) {
     return Smi2RdcError(ret);
@@ -161,7 +162,7 @@ rdc_status_t RdcNotificationImpl::listen(rdc_evnt_notification_t* events, uint32
   for (uint32_t i = 0; i < f_cnt; ++i) {
     assert(smi_event_notif_2_rdc_map.find(smi_events[i].event) != smi_event_notif_2_rdc_map.end());
     uint64_t bdfid;
-    amdsmi_get_gpu_bdf_id(smi_events[i].processor_handle, &bdfid);
+    get_smi_backend()->get_gpu_bdf_id(smi_events[i].processor_handle, &bdfid);
     events[i].gpu_id = bdfid;
     events[i].field.field_id = smi_event_notif_2_rdc_map[smi_events[i].event];
     events[i].field.status = RDC_ST_OK;
@@ -184,13 +185,13 @@ rdc_status_t RdcNotificationImpl::stop_listening(uint32_t gpu_id) {
     return Smi2RdcError(ret);
   }
 
-  ret = amdsmi_set_gpu_event_notification_mask(processor_handle, 0);
+  ret = get_smi_backend()->set_gpu_event_notification_mask(processor_handle, 0);
   if (ret != AMDSMI_STATUS_SUCCESS) {
     RDC_LOG(RDC_ERROR, "amdsmi_set_gpu_event_notification_mask() returned " << ret << " for device "
                                                                             << gpu_id);
   }
 
-  ret = amdsmi_stop_gpu_event_notification(processor_handle);
+  ret = get_smi_backend()->stop_gpu_event_notification(processor_handle);
   if (ret == AMDSMI_STATUS_SUCCESS) {
     std::lock_guard<std::mutex> guard(notif_mutex_);
     gpu_evnt_notif_masks_[gpu_id] = 0;
@@ -29,7 +29,13 @@ namespace rdc {
 
 static const uint64_t kNanosecondsPerSecond = 1000000000;
 
-RdcPerfTimer::RdcPerfTimer(void) { freq_in_100mhz = MeasureTSCFreqHz(); }
+RdcPerfTimer::RdcPerfTimer(void) : freq_in_100mhz(0) {
+  // Measuring the TSC frequency spins for about a gigacycle, so only pay
+  // for it when the rdtscp timing method is used
+#ifdef _AMD
+  freq_in_100mhz = MeasureTSCFreqHz();
+#endif
+}
 
 RdcPerfTimer::~RdcPerfTimer() {
   while (!_timers.empty()) {
@@ -0,0 +1,397 @@
+/*
+Copyright (c) 2024 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "rdc_lib/impl/RdcPersistentStore.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>  // NOLINT(build/c++11)
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+
+#include "rdc_lib/RdcException.h"
+#include "rdc_lib/RdcLogger.h"
+#include "rdc_lib/impl/RdcChecksum.h"
+#include "rdc_lib/impl/RdcEncoding.h"
+
+namespace amd {
+namespace rdc {
+
+namespace {
+
+const char kSegmentMagic[8] = {'R', 'D', 'C', 'S', 'E', 'G', '0', '1'};
+// 2: FieldSummaryStats carries a RdcQuantileSketch
+const uint32_t kSegmentVersion = 2;
+const uint32_t kRecordHeaderBytes = 16;
+
+struct RdcSegmentHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t header_bytes;
+  uint64_t seq;
+  uint64_t size;
+  uint64_t create_time;
+  uint8_t reserved[20];
+  uint32_t checksum;  //!< CRC32 of the bytes above
+};
+static_assert(sizeof(RdcSegmentHeader) == 64, "The segment header must be 64 bytes");
+
+uint64_t align8(uint64_t v) { return (v + 7) & ~static_cast<uint64_t>(7); }
+
+//!< Returns the offset after the last valid record
+uint64_t scan_records(const uint8_t* base, uint64_t size,
+                      const RdcPersistentStore::RecordVisitor* visitor) {
+  uint64_t pos = sizeof(RdcSegmentHeader);
+  while (pos + kRecordHeaderBytes <= size) {
+    uint32_t length = 0;
+    uint32_t checksum = 0;
+    memcpy(&length, base + pos, sizeof(length));
+    memcpy(&checksum, base + pos + 4, sizeof(checksum));
+    if (length < kRecordHeaderBytes || pos + length > size) {
+      break;
+    }
+    if (rdc_crc32(0, base + pos + 8, length - 8) != checksum) {
+      RDC_LOG(RDC_INFO, "Persistent cache ends with a torn record at offset " << pos);
+      break;
+    }
+    if (visitor != nullptr) {
+      (*visitor)(static_cast<RdcPersistRecordKind>(base[pos + 8]), base + pos + kRecordHeaderBytes,
+                 length - kRecordHeaderBytes);
+    }
+    pos += align8(length);
+  }
+  return pos;
+}
+
+}  // namespace
+
+struct RdcPersistentStore::Segment {
+  std::string path;
+  uint8_t* base = nullptr;
+  uint64_t size = 0;
+  uint64_t used = 0;    //!< The end of the records
+  uint64_t synced = 0;  //!< The end of the records written to disk
+
+  ~Segment() {
+    if (base != nullptr) {
+      munmap(base, size);
+    }
+  }
+};
+
+RdcPersistentStore::RdcPersistentStore(const std::string& dir, uint64_t segment_bytes,
+                                       uint32_t max_segments, uint32_t flush_interval_ms)
+    : dir_(dir),
+      segment_bytes_(segment_bytes),
+      max_segments_(std::max(max_segments, 2u)),
+      flush_interval_ms_(flush_interval_ms),
+      next_seq_(0),
+      new_segment_(false),
+      disabled_(false),
+      stop_(false) {
+  if (mkdir(dir_.c_str(), 0750) != 0 && errno != EEXIST) {
+    throw RdcException(RDC_ST_FILE_ERROR,
+                       "Fail to create the persistent cache directory " + dir_ + ": " +
+                           strerror(errno));
+  }
+
+  DIR* d = opendir(dir_.c_str());
+  if (d == nullptr) {
+    throw RdcException(RDC_ST_FILE_ERROR, "Fail to open the persistent cache directory " + dir_);
+  }
+  std::vector<uint64_t> seqs;
+  while (struct dirent* entry = readdir(d)) {
+    uint64_t seq = 0;
+    char suffix[8] = {0};
+    if (sscanf(entry->d_name, "cache.%16" SCNx64 ".%3s", &seq, suffix) == 2 &&
+        strcmp(suffix, "seg") == 0) {
+      seqs.push_back(seq);
+    }
+  }
+  closedir(d);
+  std::sort(seqs.begin(), seqs.end());
+
+  for (uint64_t seq : seqs) {
+    sealed_.push_back(segment_path(seq));
+  }
+  if (!seqs.empty()) {
+    next_seq_ = seqs.back() + 1;
+    // Keep appending to the newest segment after its last valid record
+    current_ = map_segment(sealed_.back(), true);
+    if (current_ != nullptr) {
+      sealed_.pop_back();
+      current_->used = scan_records(current_->base, current_->size, nullptr);
+      current_->synced = current_->used;
+    }
+  }
+  if (current_ == nullptr) {
+    current_ = create_segment(next_seq_++);
+    if (current_ == nullptr) {
+      throw RdcException(RDC_ST_FILE_ERROR, "Fail to create a persistent cache segment in " + dir_);
+    }
+  }
+  RDC_LOG(RDC_INFO, "Persistent cache in " << dir_ << " with " << sealed_.size() + 1
+                                           << " segments");
+}
+
+RdcPersistentStore::~RdcPersistentStore() {
+  do {  //< lock guard for thread safe
+    std::lock_guard<std::mutex> guard(mutex_);
+    stop_ = true;
+  } while (0);
+  flusher_cv_.notify_all();
+  if (flusher_.joinable()) {
+    flusher_.join();
+  }
+  sync();
+}
+
+std::unique_ptr<RdcPersistentStore> RdcPersistentStore::from_env() {
+  const char* dir = getenv("RDC_CACHE_PERSIST_DIR");
+  if (dir == nullptr || dir[0] == '\0') {
+    return nullptr;
+  }
+  uint64_t segment_mb = env_or_default("RDC_CACHE_PERSIST_SEGMENT_MB", 8);
+  uint64_t max_segments = env_or_default("RDC_CACHE_PERSIST_SEGMENTS", 8);
+  uint64_t flush_seconds = env_or_default("RDC_CACHE_PERSIST_FLUSH", 5);
+  try {
+    return std::make_unique<RdcPersistentStore>(dir, segment_mb * 1024 * 1024, max_segments,
+                                                flush_seconds * 1000);
+  } catch (const RdcException& e) {
+    RDC_LOG(RDC_ERROR, e.what() << ", the cache will not persist");
+  }
+  return nullptr;
+}
+
+std::string RdcPersistentStore::segment_path(uint64_t seq) const {
+  char name[64];
+  snprintf(name, sizeof(name), "cache.%016" PRIx64 ".seg", seq);
+  return dir_ + "/" + name;
+}
+
+std::shared_ptr<RdcPersistentStore::Segment> RdcPersistentStore::map_segment(
+    const std::string& path, bool writable) {
+  int fd = open(path.c_str(), writable ? O_RDWR : O_RDONLY);
+  if (fd < 0) {
+    RDC_LOG(RDC_ERROR, "Fail to open " << path << ": " << strerror(errno));
+    return nullptr;
+  }
+  struct stat st;
+  auto segment = std::make_shared<Segment>();
+  segment->path = path;
+  if (fstat(fd, &st) == 0 && static_cast<uint64_t>(st.st_size) >= sizeof(RdcSegmentHeader)) {
+    segment->size = st.st_size;
+    void* base = mmap(nullptr, segment->size, writable ? PROT_READ | PROT_WRITE : PROT_READ,
+                      MAP_SHARED, fd, 0);
+    segment->base = base == MAP_FAILED ? nullptr : static_cast<uint8_t*>(base);
+  }
+  close(fd);
+  if (segment->base == nullptr) {
+    RDC_LOG(RDC_ERROR, "Fail to map " << path);
+    return nullptr;
+  }
+
+  RdcSegmentHeader header;
+  memcpy(&header, segment->base, sizeof(header));
+  if (memcmp(header.magic, kSegmentMagic, sizeof(kSegmentMagic)) != 0 ||
+      header.version != kSegmentVersion || header.header_bytes != sizeof(header) ||
+      header.size != segment->size ||
+      rdc_crc32(0, segment->base, offsetof(RdcSegmentHeader, checksum)) != header.checksum) {
+    RDC_LOG(RDC_ERROR, "Ignore " << path << " with a bad header");
+    return nullptr;
+  }
+  return segment;
+}
+
+std::shared_ptr<RdcPersistentStore::Segment> RdcPersistentStore::create_segment(uint64_t seq) {
+  std::string path = segment_path(seq);
+  int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0640);
+  if (fd < 0) {
+    RDC_LOG(RDC_ERROR, "Fail to create " << path << ": " << strerror(errno));
+    return nullptr;
+  }
+  auto segment = std::make_shared<Segment>();
+  segment->path = path;
+  segment->size = segment_bytes_;
+  // Allocate the blocks up front, a write to a hole of a shared mapping
+  // raises SIGBUS when the disk is full
+  int err = posix_fallocate(fd, 0, segment_bytes_);
+  if (err != 0) {
+    RDC_LOG(RDC_ERROR, "Fail to allocate " << segment_bytes_ << " bytes for " << path << ": "
+                                           << strerror(err));
+    close(fd);
+    unlink(path.c_str());
+    return nullptr;
+  }
+  void* base = mmap(nullptr, segment_bytes_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  segment->base = base == MAP_FAILED ? nullptr : static_cast<uint8_t*>(base);
+  close(fd);
+  if (segment->base == nullptr) {
+    RDC_LOG(RDC_ERROR, "Fail to map " << path << ": " << strerror(errno));
+    unlink(path.c_str());
+    return nullptr;
+  }
+
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  RdcSegmentHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, kSegmentMagic, sizeof(kSegmentMagic));
+  header.version = kSegmentVersion;
+  header.header_bytes = sizeof(header);
+  header.seq = seq;
+  header.size = segment_bytes_;
+  header.create_time = static_cast<uint64_t>(tv.tv_sec) * 1000 + tv.tv_usec / 1000;
+  header.checksum = rdc_crc32(0, &header, offsetof(RdcSegmentHeader, checksum));
+  memcpy(segment->base, &header, sizeof(header));
+  segment->used = sizeof(header);
+  return segment;
+}
+
+void RdcPersistentStore::replay(const RecordVisitor& visitor) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  for (const std::string& path : sealed_) {
+    auto segment = map_segment(path, false);
+    if (segment != nullptr) {
+      scan_records(segment->base, segment->size, &visitor);
+    }
+  }
+  scan_records(current_->base, current_->used, &visitor);
+}
+
+bool RdcPersistentStore::append(RdcPersistRecordKind kind, const void* payload, uint32_t length) {
+  uint64_t record_bytes = align8(kRecordHeaderBytes + length);
+  if (record_bytes + sizeof(RdcSegmentHeader) > segment_bytes_) {
+    return false;
+  }
+
+  std::lock_guard<std::mutex> guard(mutex_);
+  if (disabled_) {
+    return false;
+  }
+  if (current_->used + record_bytes > current_->size) {
+    auto segment = create_segment(next_seq_);
+    if (segment == nullptr) {
+      disabled_ = true;
+      RDC_LOG(RDC_ERROR, "The cache stops persisting to " << dir_);
+      return false;
+    }
+    next_seq_++;
+    sealed_.push_back(current_->path);
+    unsynced_.push_back(current_);
+    current_ = segment;
+    new_segment_ = true;
+  }
+
+  uint8_t* record = current_->base + current_->used;
+  memset(record + 8, 0, 8);
+  record[8] = kind;
+  memcpy(record + kRecordHeaderBytes, payload, length);
+  uint32_t checksum = rdc_crc32(0, record + 8, kRecordHeaderBytes - 8 + length);
+  memcpy(record + 4, &checksum, sizeof(checksum));
+  // A stale record left by a crash must not follow this one
+  if (current_->used + record_bytes + 4 <= current_->size) {
+    memset(record + record_bytes, 0, 4);
+  }
+  __atomic_store_n(reinterpret_cast<uint32_t*>(record),
+                   static_cast<uint32_t>(kRecordHeaderBytes + length), __ATOMIC_RELEASE);
+  current_->used += record_bytes;
+  return true;
+}
+
+bool RdcPersistentStore::disabled() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return disabled_;
+}
+
+bool RdcPersistentStore::take_new_segment() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  bool new_segment = new_segment_;
+  new_segment_ = false;
+  return new_segment;
+}
+
+void RdcPersistentStore::sync() {
+  std::vector<std::shared_ptr<Segment>> sealed;
+  std::vector<std::string> expired;
+  std::shared_ptr<Segment> current;
+  uint64_t from = 0;
+  uint64_t to = 0;
+  do {  //< lock guard for thread safe
+    std::lock_guard<std::mutex> guard(mutex_);
+    sealed.swap(unsynced_);
+    current = current_;
+    from = current->synced;
+    to = current->used;
+    while (sealed_.size() + 1 > max_segments_) {
+      expired.push_back(sealed_.front());
+      sealed_.erase(sealed_.begin());
+    }
+  } while (0);
+
+  // msync outside of the lock, the segments stay mapped while referenced
+  for (const auto& segment : sealed) {
+    msync(segment->base, segment->size, MS_SYNC);
+  }
+  if (to > from) {
+    uint64_t page = sysconf(_SC_PAGESIZE);
+    uint64_t start = from - from % page;
+    if (msync(current->base + start, to - start, MS_SYNC) == 0) {
+      std::lock_guard<std::mutex> guard(mutex_);
+      current->synced = std::max(current->synced, to);
+    }
+  }
+  // The records superseding the expired segments are on disk by now
+  for (const std::string& path : expired) {
+    unlink(path.c_str());
+  }
+}
+
+void RdcPersistentStore::start_flusher(std::function<void()> before_sync) {
+  flusher_ = std::thread(&RdcPersistentStore::flusher_loop, this, std::move(before_sync));
+}
+
+void RdcPersistentStore::flusher_loop(std::function<void()> before_sync) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!stop_) {
+    flusher_cv_.wait_for(lock, std::chrono::milliseconds(flush_interval_ms_));
+    if (stop_) {
+      break;
+    }
+    lock.unlock();
+    before_sync();
+    sync();
+    lock.lock();
+  }
+}
+
+}  // namespace rdc
+}  // namespace amd
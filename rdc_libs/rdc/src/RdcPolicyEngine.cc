@@ -0,0 +1,216 @@
+/*
+Copyright (c) 2024 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "rdc_lib/impl/RdcPolicyEngine.h"
+
+#include <chrono>  // NOLINT(build/c++11)
+
+#include "rdc_lib/RdcLogger.h"
+
+namespace amd {
+namespace rdc {
+
+namespace {
+
+const size_t kMaxViolations = 4096;
+
+}  // namespace
+
+RdcPolicyEngine::RdcPolicyEngine() : num_rules_(0), next_rule_id_(1), next_seq_(1) {}
+
+bool RdcPolicyEngine::rule_matches(const rdc_policy_rule_t& rule, uint32_t gpu_index) {
+  return rule.gpu_index == static_cast<uint32_t>(GPU_ID_INVALID) || rule.gpu_index == gpu_index;
+}
+
+rdc_status_t RdcPolicyEngine::add_rule(const rdc_policy_rule_t& rule, uint32_t* rule_id) {
+  if (rule_id == nullptr || rule.field_id == RDC_FI_INVALID || rule.hysteresis < 0 ||
+      rule.condition > RDC_POLICY_INCREASED) {
+    return RDC_ST_BAD_PARAMETER;
+  }
+
+  std::lock_guard<std::mutex> guard(mutex_);
+  *rule_id = next_rule_id_++;
+  rules_[*rule_id] = rule;
+  rule_fields_.insert(rule.field_id);
+  // Add a slot to the (GPU, field) already seen, the others get it on
+  // their first sample
+  for (auto& ite : slots_) {
+    uint32_t gpu_index = static_cast<uint32_t>(ite.first >> 32);
+    if (static_cast<uint32_t>(ite.first) == rule.field_id && rule_matches(rule, gpu_index)) {
+      ite.second.push_back({*rule_id, rule, 0, false, false, 0});
+    }
+  }
+  num_rules_ = rules_.size();
+  RDC_LOG(RDC_INFO, "Add the policy rule " << *rule_id << " on the field " << rule.field_id);
+  return RDC_ST_OK;
+}
+
+rdc_status_t RdcPolicyEngine::delete_rule(uint32_t rule_id) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto rule = rules_.find(rule_id);
+  if (rule == rules_.end()) {
+    return RDC_ST_NOT_FOUND;
+  }
+  rdc_field_t field_id = rule->second.field_id;
+  rules_.erase(rule);
+
+  bool field_has_rule = false;
+  for (const auto& r : rules_) {
+    field_has_rule = field_has_rule || r.second.field_id == field_id;
+  }
+  if (!field_has_rule) {
+    rule_fields_.erase(field_id);
+  }
+  for (auto& ite : slots_) {
+    auto& slots = ite.second;
+    for (auto slot = slots.begin(); slot != slots.end();) {
+      slot = slot->rule_id == rule_id ? slots.erase(slot) : slot + 1;
+    }
+  }
+  num_rules_ = rules_.size();
+  return RDC_ST_OK;
+}
+
+void RdcPolicyEngine::raise(const Slot& slot, uint32_t gpu_index, const rdc_field_value& value,
+                            double v, bool cleared,
+                            std::vector<rdc_evnt_notification_t>* events) {
+  rdc_policy_violation_t violation;
+  violation.seq = next_seq_++;
+  violation.rule_id = slot.rule_id;
+  violation.gpu_index = gpu_index;
+  violation.field_id = value.field_id;
+  violation.ts = value.ts;
+  violation.value = v;
+  violation.cleared = cleared ? 1 : 0;
+  violations_.push_back(violation);
+  if (violations_.size() > kMaxViolations) {
+    violations_.pop_front();
+  }
+  violation_cv_.notify_all();
+
+  rdc_evnt_notification_t event;
+  event.gpu_id = gpu_index;
+  event.field.field_id = cleared ? RDC_EVNT_NOTIF_POLICY_CLEARED : RDC_EVNT_NOTIF_POLICY_VIOLATION;
+  event.field.status = RDC_ST_OK;
+  event.field.ts = value.ts;
+  event.field.type = INTEGER;
+  event.field.value.l_int = slot.rule_id;
+  events->push_back(event);
+}
+
+void RdcPolicyEngine::evaluate(uint32_t gpu_index, const rdc_field_value& value,
+                               std::vector<rdc_evnt_notification_t>* events) {
+  if (num_rules_ == 0) {
+    return;
+  }
+
+  double v = 0;
+  if (value.type == INTEGER) {
+    v = static_cast<double>(value.value.l_int);
+  } else if (value.type == DOUBLE) {
+    v = value.value.dbl;
+  } else {
+    return;
+  }
+
+  std::lock_guard<std::mutex> guard(mutex_);
+  if (rule_fields_.find(value.field_id) == rule_fields_.end()) {
+    return;
+  }
+  uint64_t key = slot_key(gpu_index, value.field_id);
+  auto ite = slots_.find(key);
+  if (ite == slots_.end()) {
+    std::vector<Slot> slots;
+    for (const auto& rule : rules_) {
+      if (rule.second.field_id == value.field_id && rule_matches(rule.second, gpu_index)) {
+        slots.push_back({rule.first, rule.second, 0, false, false, 0});
+      }
+    }
+    ite = slots_.emplace(key, std::move(slots)).first;
+  }
+
+  for (auto& slot : ite->second) {
+    const rdc_policy_rule_t& rule = slot.rule;
+    if (rule.condition == RDC_POLICY_INCREASED) {
+      if (slot.has_last && v > slot.last_value) {
+        raise(slot, gpu_index, value, v, false, events);
+      }
+      slot.has_last = true;
+      slot.last_value = v;
+      continue;
+    }
+
+    bool above = rule.condition == RDC_POLICY_ABOVE;
+    if (slot.active) {
+      bool back = above ? v <= rule.threshold - rule.hysteresis
+                        : v >= rule.threshold + rule.hysteresis;
+      if (back) {
+        slot.active = false;
+        slot.since_ts = 0;
+        raise(slot, gpu_index, value, v, true, events);
+      }
+      continue;
+    }
+
+    bool holds = above ? v > rule.threshold : v < rule.threshold;
+    if (!holds) {
+      slot.since_ts = 0;
+      continue;
+    }
+    if (slot.since_ts == 0) {
+      slot.since_ts = value.ts;
+    }
+    if (value.ts >= slot.since_ts + rule.duration_ms) {
+      slot.active = true;
+      raise(slot, gpu_index, value, v, false, events);
+    }
+  }
+}
+
+rdc_status_t RdcPolicyEngine::get_violations(uint64_t since_seq, uint32_t timeout_ms,
+                                             rdc_policy_violations_t* violations) {
+  if (violations == nullptr) {
+    return RDC_ST_BAD_PARAMETER;
+  }
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  violation_cv_.wait_for(lock, std::chrono::milliseconds(timeout_ms),
+                         [&] { return next_seq_ - 1 > since_seq; });
+
+  violations->num_violations = 0;
+  violations->num_missed = 0;
+  if (violations_.empty()) {
+    return RDC_ST_OK;
+  }
+  uint64_t first_seq = violations_.front().seq;
+  if (since_seq + 1 < first_seq) {
+    violations->num_missed = first_seq - since_seq - 1;
+  }
+  size_t start = since_seq < first_seq ? 0 : since_seq - first_seq + 1;
+  for (size_t i = start;
+       i < violations_.size() && violations->num_violations < RDC_MAX_POLICY_VIOLATIONS; i++) {
+    violations->violations[violations->num_violations++] = violations_[i];
+  }
+  return RDC_ST_OK;
+}
+
+}  // namespace rdc
+}  // namespace amd
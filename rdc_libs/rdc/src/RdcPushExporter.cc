@@ -0,0 +1,376 @@
+/*
+Copyright (c) 2024 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "rdc_lib/impl/RdcPushExporter.h"
+
+#include <netdb.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>  // NOLINT(build/c++11)
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+#include "common/rdc_fields_supported.h"
+#include "rdc_lib/RdcException.h"
+#include "rdc_lib/RdcLogger.h"
+#include "rdc_lib/RdcSelfStats.h"
+#include "rdc_lib/impl/RdcEncoding.h"
+
+namespace amd {
+namespace rdc {
+
+namespace {
+
+// Fits the Ethernet MTU, so a datagram is never fragmented
+const size_t kMaxUdpDatagram = 1432;
+const size_t kMaxUnixDatagram = 8192;
+const int kSendTimeoutMs = 1000;
+const char* kMeasurement = "rdc";
+
+// The tag values of the line protocol escape commas, spaces and '='
+std::string escape_tag(const std::string& value) {
+  std::string escaped;
+  for (char c : value) {
+    if (c == ',' || c == ' ' || c == '=') {
+      escaped += '\\';
+    }
+    escaped += c;
+  }
+  return escaped;
+}
+
+void append_number(std::string* out, int64_t value) {
+  char buf[24];
+  auto res = std::to_chars(buf, buf + sizeof(buf), value);
+  out->append(buf, res.ptr - buf);
+}
+
+void append_number(std::string* out, double value) {
+  char buf[32];
+  int len = snprintf(buf, sizeof(buf), "%.15g", value);
+  out->append(buf, len);
+}
+
+}  // namespace
+
+RdcPushExporter::RdcPushExporter(const std::string& target, RdcPushFormat format,
+                                 uint32_t flush_ms, uint32_t batch_size, uint32_t max_pending)
+    : format_(format),
+      flush_ms_(flush_ms),
+      batch_size_(batch_size),
+      max_pending_(max_pending),
+      max_datagram_(kMaxUdpDatagram),
+      dropped_(0),
+      stop_(false),
+      fd_(-1) {
+  size_t scheme_end = target.find("://");
+  std::string scheme = target.substr(0, scheme_end);
+  std::string address = scheme_end == std::string::npos ? "" : target.substr(scheme_end + 3);
+  if (scheme == "unix" || scheme == "unixgram") {
+    transport_ = scheme == "unix" ? RDC_PUSH_UNIX : RDC_PUSH_UNIXGRAM;
+    max_datagram_ = kMaxUnixDatagram;
+    host_ = address;
+    if (host_.empty() || host_.size() >= sizeof(sockaddr_un::sun_path)) {
+      throw RdcException(RDC_ST_BAD_PARAMETER, "Invalid push exporter socket " + target);
+    }
+  } else if (scheme == "udp" || scheme == "tcp") {
+    transport_ = scheme == "udp" ? RDC_PUSH_UDP : RDC_PUSH_TCP;
+    size_t colon = address.rfind(':');
+    if (colon == std::string::npos || colon == 0 || colon + 1 == address.size()) {
+      throw RdcException(RDC_ST_BAD_PARAMETER, "Invalid push exporter address " + target);
+    }
+    // [::1]:8125 for IPv6
+    host_ = address.substr(0, colon);
+    if (host_.front() == '[' && host_.back() == ']') {
+      host_ = host_.substr(1, host_.size() - 2);
+    }
+    port_ = address.substr(colon + 1);
+  } else {
+    throw RdcException(RDC_ST_BAD_PARAMETER, "Invalid push exporter target " + target);
+  }
+
+  char hostname[256] = {};
+  if (gethostname(hostname, sizeof(hostname) - 1) == 0) {
+    hostname_ = hostname;
+  }
+  pending_.reserve(batch_size_);
+  push_thread_ = std::thread(&RdcPushExporter::push_loop, this);
+}
+
+RdcPushExporter::~RdcPushExporter() {
+  do {  //< lock guard for thread safe
+    std::lock_guard<std::mutex> guard(pending_mutex_);
+    stop_ = true;
+  } while (0);
+  pending_cv_.notify_all();
+  if (push_thread_.joinable()) {
+    push_thread_.join();
+  }
+  disconnect();
+}
+
+std::shared_ptr<RdcPushExporter> RdcPushExporter::from_env() {
+  const char* target = getenv("RDC_EXPORT_TARGET");
+  if (target == nullptr || target[0] == '\0') {
+    return nullptr;
+  }
+  RdcPushFormat format = RDC_PUSH_INFLUX;
+  const char* format_env = getenv("RDC_EXPORT_FORMAT");
+  std::string format_name = format_env == nullptr ? "influx" : format_env;
+  if (format_name == "statsd") {
+    format = RDC_PUSH_STATSD;
+  } else if (format_name == "dogstatsd") {
+    format = RDC_PUSH_DOGSTATSD;
+  } else if (format_name != "influx") {
+    RDC_LOG(RDC_ERROR, "Invalid RDC_EXPORT_FORMAT " << format_name << ", using influx");
+  }
+  uint64_t flush_ms = env_or_default("RDC_EXPORT_FLUSH_MS", 1000);
+  uint64_t batch_size = env_or_default("RDC_EXPORT_BATCH", 5000);
+  uint64_t max_pending = env_or_default("RDC_EXPORT_BUFFER", 100000);
+  try {
+    auto exporter = std::make_shared<RdcPushExporter>(target, format, flush_ms, batch_size,
+                                                      std::max(max_pending, batch_size));
+    RDC_LOG(RDC_INFO, "Push the samples to " << target << " as " << format_name);
+    return exporter;
+  } catch (const RdcException& e) {
+    RDC_LOG(RDC_ERROR, e.what() << ", the push exporter is off");
+  }
+  return nullptr;
+}
+
+void RdcPushExporter::append(uint32_t gpu_index, const rdc_field_value& value) {
+  if (value.type != INTEGER && value.type != DOUBLE) {
+    return;
+  }
+  // Neither the line protocol nor StatsD can carry them
+  if (value.type == DOUBLE && !std::isfinite(value.value.dbl)) {
+    return;
+  }
+  PendingSample sample{value.ts,         gpu_index,
+                       value.field_id,   value.type,
+                       value.value.l_int, value.type == DOUBLE ? value.value.dbl : 0};
+
+  std::lock_guard<std::mutex> guard(pending_mutex_);
+  if (pending_.size() >= max_pending_) {
+    // The agent fell behind, drop rather than stall the collection
+    RdcSelfStats::get_instance().record_export(0, 1);
+    if (dropped_++ % batch_size_ == 0) {
+      RDC_LOG(RDC_ERROR, "The push exporter dropped " << dropped_ << " samples");
+    }
+    return;
+  }
+  pending_.push_back(sample);
+  if (pending_.size() == batch_size_) {
+    pending_cv_.notify_one();
+  }
+}
+
+void RdcPushExporter::push_loop() {
+  std::vector<PendingSample> batch;
+  batch.reserve(batch_size_);
+  std::unique_lock<std::mutex> lock(pending_mutex_);
+  while (true) {
+    pending_cv_.wait_for(lock, std::chrono::milliseconds(flush_ms_),
+                         [this]() { return stop_ || pending_.size() >= batch_size_; });
+    batch.swap(pending_);
+    bool stop = stop_;
+    lock.unlock();
+
+    if (!batch.empty()) {
+      uint64_t sent = push(batch);
+      RdcSelfStats::get_instance().record_export(sent, batch.size() - sent);
+      batch.clear();
+    }
+    if (stop) {
+      return;
+    }
+    lock.lock();
+  }
+}
+
+const std::string& RdcPushExporter::metric_name(rdc_field_t field_id) {
+  auto ite = names_.find(field_id);
+  if (ite == names_.end()) {
+    fld_id2name_map_t& descriptions = get_field_id_description_from_id();
+    auto desc = descriptions.find(field_id);
+    std::string name = desc == descriptions.end() ? "field_" + std::to_string(field_id)
+                                                  : get_field_metric_name(desc->second.label);
+    ite = names_.emplace(field_id, name).first;
+  }
+  return ite->second;
+}
+
+void RdcPushExporter::format(const PendingSample& sample, const PendingSample* previous,
+                             std::string* out) {
+  const std::string& name = metric_name(sample.field_id);
+  if (format_ == RDC_PUSH_INFLUX) {
+    // One line per GPU and timestamp, the fields fetched together share it:
+    //   rdc,gpu=0,host=node1 gpu_temp=45000i,power_usage=210000000i 1700000000000000000
+    if (previous != nullptr && previous->gpu_index == sample.gpu_index &&
+        previous->ts == sample.ts) {
+      out->resize(out->size() - 1);  // The '\n' of the previous sample
+      out->erase(out->rfind(' '));   // and its timestamp
+      *out += ',';
+    } else {
+      *out += kMeasurement;
+      *out += ",gpu=";
+      append_number(out, static_cast<int64_t>(sample.gpu_index));
+      if (!hostname_.empty()) {
+        *out += ",host=" + escape_tag(hostname_);
+      }
+      *out += ' ';
+    }
+    *out += name;
+    *out += '=';
+    if (sample.type == INTEGER) {
+      append_number(out, sample.l_int);
+      *out += 'i';
+    } else {
+      append_number(out, sample.dbl);
+    }
+    *out += ' ';
+    append_number(out, static_cast<int64_t>(sample.ts * 1000000));
+    *out += '\n';
+    return;
+  }
+
+  std::string metric = std::string(kMeasurement) + ".";
+  if (format_ == RDC_PUSH_STATSD) {
+    // No tags in plain StatsD
+    metric += "gpu" + std::to_string(sample.gpu_index) + ".";
+  }
+  metric += name;
+  bool negative = sample.type == INTEGER ? sample.l_int < 0 : sample.dbl < 0;
+  if (negative && format_ == RDC_PUSH_STATSD) {
+    // A signed gauge is a delta in StatsD, so it is set from 0
+    *out += metric + ":0|g\n";
+  }
+  *out += metric;
+  *out += ':';
+  if (sample.type == INTEGER) {
+    append_number(out, sample.l_int);
+  } else {
+    append_number(out, sample.dbl);
+  }
+  *out += "|g";
+  if (format_ == RDC_PUSH_DOGSTATSD) {
+    *out += "|#gpu:" + std::to_string(sample.gpu_index);
+    if (!hostname_.empty()) {
+      *out += ",host:" + hostname_;
+    }
+  }
+  *out += '\n';
+}
+
+uint64_t RdcPushExporter::push(const std::vector<PendingSample>& batch) {
+  if (fd_ < 0 && !connect_target()) {
+    return 0;
+  }
+  uint64_t sent = 0;
+  for (size_t start = 0; start < batch.size(); start += batch_size_) {
+    size_t end = std::min(batch.size(), start + static_cast<size_t>(batch_size_));
+    payload_.clear();
+    for (size_t i = start; i < end; i++) {
+      format(batch[i], i > start ? &batch[i - 1] : nullptr, &payload_);
+    }
+    if (!send_payload(payload_.data(), payload_.size())) {
+      break;
+    }
+    sent += end - start;
+  }
+  return sent;
+}
+
+bool RdcPushExporter::send_payload(const char* data, size_t size) {
+  bool datagram = transport_ == RDC_PUSH_UDP || transport_ == RDC_PUSH_UNIXGRAM;
+  while (size > 0) {
+    size_t len = size;
+    if (datagram && len > max_datagram_) {
+      // Cut on a line, or send the line alone when it is longer
+      const char* cut = static_cast<const char*>(memrchr(data, '\n', max_datagram_));
+      if (cut == nullptr) {
+        cut = static_cast<const char*>(memchr(data, '\n', size));
+      }
+      len = cut == nullptr ? size : cut - data + 1;
+    }
+    ssize_t n = send(fd_, data, len, MSG_NOSIGNAL);
+    if (n <= 0) {
+      RDC_LOG(RDC_ERROR, "Fail to push the samples: " << strerror(errno));
+      disconnect();
+      return false;
+    }
+    data += n;
+    size -= n;
+  }
+  return true;
+}
+
+bool RdcPushExporter::connect_target() {
+  if (transport_ == RDC_PUSH_UNIX || transport_ == RDC_PUSH_UNIXGRAM) {
+    struct sockaddr_un addr = {};
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, host_.c_str(), sizeof(addr.sun_path) - 1);
+    int type = transport_ == RDC_PUSH_UNIX ? SOCK_STREAM : SOCK_DGRAM;
+    fd_ = socket(AF_UNIX, type | SOCK_CLOEXEC, 0);
+    if (fd_ >= 0 && connect(fd_, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) != 0) {
+      disconnect();
+    }
+  } else {
+    struct addrinfo hints = {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = transport_ == RDC_PUSH_TCP ? SOCK_STREAM : SOCK_DGRAM;
+    struct addrinfo* addrs = nullptr;
+    if (getaddrinfo(host_.c_str(), port_.c_str(), &hints, &addrs) == 0) {
+      for (struct addrinfo* a = addrs; a != nullptr && fd_ < 0; a = a->ai_next) {
+        fd_ = socket(a->ai_family, a->ai_socktype | SOCK_CLOEXEC, a->ai_protocol);
+        if (fd_ >= 0 && connect(fd_, a->ai_addr, a->ai_addrlen) != 0) {
+          disconnect();
+        }
+      }
+      freeaddrinfo(addrs);
+    }
+  }
+  if (fd_ < 0) {
+    RDC_LOG(RDC_DEBUG, "Fail to connect to the push exporter agent " << host_ << ":" << port_);
+    return false;
+  }
+  // A stalled agent delays the next batches, never the collection
+  struct timeval timeout = {kSendTimeoutMs / 1000, (kSendTimeoutMs % 1000) * 1000};
+  setsockopt(fd_, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+  return true;
+}
+
+void RdcPushExporter::disconnect() {
+  if (fd_ >= 0) {
+    close(fd_);
+    fd_ = -1;
+  }
+}
+
+}  // namespace rdc
+}  // namespace amd
@@ -0,0 +1,132 @@
+/*
+Copyright (c) 2024 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "rdc_lib/impl/RdcQuantileSketch.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace amd {
+namespace rdc {
+
+namespace {
+
+const double kGamma =
+    (1 + RdcQuantileSketch::kRelativeAccuracy) / (1 - RdcQuantileSketch::kRelativeAccuracy);
+const double kLogGamma = std::log(kGamma);
+const int32_t kEmpty = std::numeric_limits<int32_t>::min();
+
+}  // namespace
+
+RdcQuantileSketch::RdcQuantileSketch()
+    : count_(0), zero_count_(0), min_index_(kEmpty), max_index_(kEmpty) {
+  memset(buckets_, 0, sizeof(buckets_));
+}
+
+void RdcQuantileSketch::add(int64_t value) {
+  if (value <= 0) {
+    zero_count_++;
+  } else {
+    add_to_bucket(
+        static_cast<int32_t>(std::ceil(std::log(static_cast<double>(value)) / kLogGamma)), 1);
+  }
+  count_++;
+}
+
+void RdcQuantileSketch::move_window(int32_t new_min) {
+  uint32_t saturated = std::numeric_limits<uint32_t>::max();
+  uint32_t moved[kNumBuckets] = {0};
+  for (uint32_t i = 0; i < kNumBuckets; i++) {
+    if (buckets_[i] == 0) continue;
+    int64_t slot = std::max<int64_t>(0, static_cast<int64_t>(min_index_) + i - new_min);
+    moved[slot] = static_cast<uint32_t>(
+        std::min<uint64_t>(static_cast<uint64_t>(moved[slot]) + buckets_[i], saturated));
+  }
+  memcpy(buckets_, moved, sizeof(buckets_));
+  min_index_ = new_min;
+}
+
+void RdcQuantileSketch::add_to_bucket(int32_t index, uint64_t count) {
+  const int32_t width = static_cast<int32_t>(kNumBuckets);
+  if (max_index_ == kEmpty) {
+    min_index_ = index;
+    max_index_ = index;
+  } else if (index > max_index_) {
+    max_index_ = index;
+    if (index >= min_index_ + width) {
+      move_window(index - width + 1);
+    }
+  } else if (index < min_index_) {
+    // Extend the window down as far as the largest value allows
+    move_window(std::max(index, max_index_ - width + 1));
+  }
+
+  uint32_t slot = index < min_index_ ? 0 : index - min_index_;
+  buckets_[slot] = static_cast<uint32_t>(std::min<uint64_t>(
+      static_cast<uint64_t>(buckets_[slot]) + count, std::numeric_limits<uint32_t>::max()));
+}
+
+void RdcQuantileSketch::merge(const RdcQuantileSketch& other) {
+  if (max_index_ == kEmpty) {
+    *this = other;
+    return;
+  }
+  if (other.max_index_ != kEmpty) {
+    // Place the window once for both, then add the buckets of other
+    max_index_ = std::max(max_index_, other.max_index_);
+    move_window(std::max(std::min(min_index_, other.min_index_),
+                         max_index_ - static_cast<int32_t>(kNumBuckets) + 1));
+    for (uint32_t i = 0; i < kNumBuckets; i++) {
+      if (other.buckets_[i] != 0) {
+        add_to_bucket(other.min_index_ + static_cast<int32_t>(i), other.buckets_[i]);
+      }
+    }
+  }
+  zero_count_ += other.zero_count_;
+  count_ += other.count_;
+}
+
+double RdcQuantileSketch::quantile(double q) const {
+  if (count_ == 0) {
+    return 0;
+  }
+
+  q = std::max(0.0, std::min(1.0, q));
+  uint64_t rank = static_cast<uint64_t>(q * (count_ - 1));
+  if (rank < zero_count_) {
+    return 0;
+  }
+
+  uint64_t seen = zero_count_;
+  uint32_t i = 0;
+  for (; i < kNumBuckets - 1; i++) {
+    seen += buckets_[i];
+    if (seen > rank) break;
+  }
+  // The middle of the bucket in relative terms
+  return 2 * std::pow(kGamma, min_index_ + static_cast<int32_t>(i)) / (kGamma + 1);
+}
+
+}  // namespace rdc
+}  // namespace amd
@@ -0,0 +1,206 @@
+/*
+Copyright (c) 2024 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "rdc_lib/impl/RdcReplayLib.h"
+
+#include <sys/time.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <set>
+
+#include "rdc_lib/RdcException.h"
+#include "rdc_lib/RdcLogger.h"
+
+namespace amd {
+namespace rdc {
+
+namespace {
+
+uint64_t now_msec() {
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return static_cast<uint64_t>(tv.tv_sec) * 1000 + tv.tv_usec / 1000;
+}
+
+}  // namespace
+
+RdcReplayLib::RdcReplayLib(const std::string& path, double speed)
+    : records_(rdc_trace_read(path)),
+      speed_(speed),
+      first_ts_(0),
+      duration_ms_(0),
+      start_ms_(0),
+      loop_(0) {
+  if (records_.empty()) {
+    throw RdcException(RDC_ST_NO_DATA, "Trace file " + path + " has no records");
+  }
+  if (speed_ <= 0) {
+    throw RdcException(RDC_ST_BAD_PARAMETER, "Replay speed must be positive");
+  }
+
+  // Field and event records come from different threads, so the trace is
+  // only roughly ordered.
+  std::stable_sort(records_.begin(), records_.end(),
+                   [](const RdcTraceRecord& a, const RdcTraceRecord& b) {
+                     return a.field.ts < b.field.ts;
+                   });
+  first_ts_ = records_.front().field.ts;
+  // Add one so that the last record is reached before wrapping around
+  duration_ms_ = records_.back().field.ts - first_ts_ + 1;
+
+  for (uint32_t i = 0; i < records_.size(); i++) {
+    field_index_[{records_[i].gpu_index, records_[i].field.field_id}].push_back(i);
+  }
+
+  RDC_LOG(RDC_INFO, "Replaying " << records_.size() << " records over " << duration_ms_ / 1000
+                                 << " seconds from " << path << " at " << speed_ << "x speed");
+}
+
+RdcReplayLibPtr RdcReplayLib::from_env() {
+  const char* path = getenv("RDC_TRACE_REPLAY");
+  if (path == nullptr || path[0] == '\0') {
+    return nullptr;
+  }
+  double speed = 1.0;
+  const char* speed_env = getenv("RDC_TRACE_REPLAY_SPEED");
+  if (speed_env != nullptr) {
+    speed = strtod(speed_env, nullptr);
+  }
+  try {
+    return std::make_shared<RdcReplayLib>(path, speed);
+  } catch (const RdcException& e) {
+    RDC_LOG(RDC_ERROR, e.what());
+  }
+  return nullptr;
+}
+
+uint64_t RdcReplayLib::trace_position(uint64_t now_ms) {
+  if (start_ms_ == 0) {
+    start_ms_ = now_ms;
+  }
+  uint64_t elapsed = static_cast<uint64_t>((now_ms - start_ms_) * speed_);
+  uint64_t loop = elapsed / duration_ms_;
+  if (loop != loop_) {
+    loop_ = loop;
+    events_served_.clear();
+  }
+  return first_ts_ + elapsed % duration_ms_;
+}
+
+rdc_status_t RdcReplayLib::rdc_telemetry_fields_query(uint32_t field_ids[MAX_NUM_FIELDS],
+                                                      uint32_t* field_count) {
+  if (field_count == nullptr) {
+    return RDC_ST_BAD_PARAMETER;
+  }
+  std::set<uint32_t> ids;
+  for (auto ite = field_index_.begin(); ite != field_index_.end(); ite++) {
+    ids.insert(ite->first.second);
+  }
+  *field_count = 0;
+  for (auto id : ids) {
+    if (*field_count >= MAX_NUM_FIELDS) {
+      break;
+    }
+    field_ids[(*field_count)++] = id;
+  }
+  return RDC_ST_OK;
+}
+
+rdc_status_t RdcReplayLib::rdc_telemetry_fields_value_get(rdc_gpu_field_t* fields,
+                                                          uint32_t fields_count,
+                                                          rdc_field_value_f callback,
+                                                          void* user_data) {
+  return fields_value_get_at(now_msec(), fields, fields_count, callback, user_data);
+}
+
+rdc_status_t RdcReplayLib::fields_value_get_at(uint64_t now, rdc_gpu_field_t* fields,
+                                               uint32_t fields_count, rdc_field_value_f callback,
+                                               void* user_data) {
+  if (fields == nullptr || callback == nullptr) {
+    return RDC_ST_BAD_PARAMETER;
+  }
+
+  std::vector<rdc_gpu_field_value_t> values;
+  do {  //< lock guard for thread safe
+    std::lock_guard<std::mutex> guard(mutex_);
+    uint64_t pos = trace_position(now);
+
+    for (uint32_t i = 0; i < fields_count; i++) {
+      RdcFieldKey key{fields[i].gpu_index, fields[i].field_id};
+      rdc_gpu_field_value_t value;
+      value.gpu_index = fields[i].gpu_index;
+      value.field_value.field_id = fields[i].field_id;
+      value.field_value.ts = now;
+      value.field_value.type = INTEGER;
+      value.field_value.value.l_int = 0;
+
+      // The trace never recorded this field
+      auto ite = field_index_.find(key);
+      if (ite == field_index_.end()) {
+        value.field_value.status = RDC_ST_NOT_SUPPORTED;
+        values.push_back(value);
+        continue;
+      }
+      const std::vector<uint32_t>& idx = ite->second;
+      // Records of this field at or before the trace position
+      uint32_t reached = std::upper_bound(idx.begin(), idx.end(), pos,
+                                          [this](uint64_t p, uint32_t r) {
+                                            return p < records_[r].field.ts;
+                                          }) -
+                         idx.begin();
+
+      if (records_[idx[0]].is_event) {
+        uint32_t& served = events_served_[key];
+        for (; served < reached; served++) {
+          value.field_value = records_[idx[served]].field;
+          value.field_value.ts = now;
+          values.push_back(value);
+        }
+        continue;
+      }
+
+      if (reached == 0) {
+        value.field_value.status = RDC_ST_NO_DATA;
+      } else {
+        value.field_value = records_[idx[reached - 1]].field;
+        value.field_value.ts = now;
+      }
+      values.push_back(value);
+    }
+  } while (0);
+
+  if (values.empty()) {
+    return RDC_ST_OK;
+  }
+  return callback(&values[0], values.size(), user_data);
+}
+
+rdc_status_t RdcReplayLib::rdc_telemetry_fields_watch(rdc_gpu_field_t*, uint32_t) {
+  return RDC_ST_OK;
+}
+
+rdc_status_t RdcReplayLib::rdc_telemetry_fields_unwatch(rdc_gpu_field_t*, uint32_t) {
+  return RDC_ST_OK;
+}
+
+}  // namespace rdc
+}  // namespace amd
@@ -0,0 +1,95 @@
+/*
+Copyright (c) 2024 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "rdc_lib/impl/RdcSelfLib.h"
+
+#include <sys/time.h>
+
+#include <vector>
+
+namespace amd {
+namespace rdc {
+
+namespace {
+
+const rdc_field_t kSelfFields[] = {
+    RDC_FI_RDC_TICK_DURATION,     RDC_FI_RDC_TICK_OVERRUNS,      RDC_FI_RDC_FETCH_LATENCY,
+    RDC_FI_RDC_SMI_FETCH_LATENCY, RDC_FI_RDC_PROF_FETCH_LATENCY, RDC_FI_RDC_SAMPLES_PER_SEC,
+    RDC_FI_RDC_CACHE_SAMPLES,     RDC_FI_RDC_CACHE_BYTES,        RDC_FI_RDC_API_CALLS_PER_SEC,
+    RDC_FI_RDC_FETCH_QUEUE_DEPTH, RDC_FI_RDC_EVENT_QUEUE_DEPTH,  RDC_FI_RDC_EXPORT_SAMPLES,
+    RDC_FI_RDC_EXPORT_DROPPED,
+};
+
+}  // namespace
+
+RdcSelfLib::RdcSelfLib() : stats_(RdcSelfStats::get_instance()) {}
+
+rdc_status_t RdcSelfLib::rdc_telemetry_fields_query(uint32_t field_ids[MAX_NUM_FIELDS],
+                                                    uint32_t* field_count) {
+  if (field_count == nullptr) {
+    return RDC_ST_BAD_PARAMETER;
+  }
+  *field_count = 0;
+  for (auto field_id : kSelfFields) {
+    field_ids[(*field_count)++] = field_id;
+  }
+  return RDC_ST_OK;
+}
+
+rdc_status_t RdcSelfLib::rdc_telemetry_fields_value_get(rdc_gpu_field_t* fields,
+                                                        uint32_t fields_count,
+                                                        rdc_field_value_f callback,
+                                                        void* user_data) {
+  if (fields == nullptr || callback == nullptr) {
+    return RDC_ST_BAD_PARAMETER;
+  }
+
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  uint64_t now = static_cast<uint64_t>(tv.tv_sec) * 1000 + tv.tv_usec / 1000;
+
+  std::vector<rdc_gpu_field_value_t> values(fields_count);
+  for (uint32_t i = 0; i < fields_count; i++) {
+    rdc_gpu_field_value_t& value = values[i];
+    value.gpu_index = fields[i].gpu_index;
+    value.field_value.field_id = fields[i].field_id;
+    value.field_value.ts = now;
+    value.field_value.type = INTEGER;
+    value.field_value.status =
+        stats_.get_value(fields[i].field_id, &value.field_value.value.l_int);
+  }
+
+  if (values.empty()) {
+    return RDC_ST_OK;
+  }
+  return callback(&values[0], values.size(), user_data);
+}
+
+rdc_status_t RdcSelfLib::rdc_telemetry_fields_watch(rdc_gpu_field_t*, uint32_t) {
+  return RDC_ST_OK;
+}
+
+rdc_status_t RdcSelfLib::rdc_telemetry_fields_unwatch(rdc_gpu_field_t*, uint32_t) {
+  return RDC_ST_OK;
+}
+
+}  // namespace rdc
+}  // namespace amd
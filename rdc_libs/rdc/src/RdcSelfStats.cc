@@ -0,0 +1,140 @@
+/*
+Copyright (c) 2024 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "rdc_lib/RdcSelfStats.h"
+
+namespace amd {
+namespace rdc {
+
+RdcSelfStats::RdcSelfStats()
+    : tick_duration_us_(0),
+      tick_overruns_(0),
+      fetch_latency_us_(0),
+      fetch_queue_depth_(0),
+      event_queue_depth_(0),
+      cache_samples_(0),
+      cache_bytes_(0),
+      export_samples_(0),
+      export_dropped_(0),
+      samples_(0),
+      api_calls_(0),
+      samples_per_sec_(0),
+      api_calls_per_sec_(0),
+      last_rate_time_(0),
+      last_samples_(0),
+      last_api_calls_(0) {
+  for (auto& latency : module_latency_us_) {
+    latency.store(0);
+  }
+}
+
+void RdcSelfStats::record_tick(uint64_t duration_us, uint64_t fetch_us, uint64_t queue_depth,
+                               bool overrun) {
+  tick_duration_us_.store(duration_us, std::memory_order_relaxed);
+  fetch_latency_us_.store(fetch_us, std::memory_order_relaxed);
+  fetch_queue_depth_.store(queue_depth, std::memory_order_relaxed);
+  if (overrun) {
+    tick_overruns_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void RdcSelfStats::record_module_fetch(RdcSelfModule module, uint64_t latency_us) {
+  if (module >= RDC_SELF_MODULE_COUNT) {
+    return;
+  }
+  module_latency_us_[module].store(latency_us, std::memory_order_relaxed);
+}
+
+void RdcSelfStats::record_cache_usage(uint64_t num_samples, uint64_t num_bytes) {
+  cache_samples_.store(num_samples, std::memory_order_relaxed);
+  cache_bytes_.store(num_bytes, std::memory_order_relaxed);
+}
+
+// Only the update thread calls this, so the last_* members need no lock
+void RdcSelfStats::update_rates(uint64_t now_ms) {
+  uint64_t samples = samples_.load(std::memory_order_relaxed);
+  uint64_t api_calls = api_calls_.load(std::memory_order_relaxed);
+  if (last_rate_time_ != 0 && now_ms > last_rate_time_) {
+    uint64_t elapsed = now_ms - last_rate_time_;
+    samples_per_sec_.store((samples - last_samples_) * 1000 / elapsed, std::memory_order_relaxed);
+    api_calls_per_sec_.store((api_calls - last_api_calls_) * 1000 / elapsed,
+                             std::memory_order_relaxed);
+  }
+  last_rate_time_ = now_ms;
+  last_samples_ = samples;
+  last_api_calls_ = api_calls;
+}
+
+rdc_status_t RdcSelfStats::get_value(rdc_field_t field_id, int64_t* value) const {
+  if (value == nullptr) {
+    return RDC_ST_BAD_PARAMETER;
+  }
+
+  uint64_t v = 0;
+  switch (field_id) {
+    case RDC_FI_RDC_TICK_DURATION:
+      v = tick_duration_us_.load(std::memory_order_relaxed);
+      break;
+    case RDC_FI_RDC_TICK_OVERRUNS:
+      v = tick_overruns_.load(std::memory_order_relaxed);
+      break;
+    case RDC_FI_RDC_FETCH_LATENCY:
+      v = fetch_latency_us_.load(std::memory_order_relaxed);
+      break;
+    case RDC_FI_RDC_SMI_FETCH_LATENCY:
+      v = module_latency_us_[RDC_SELF_MODULE_SMI].load(std::memory_order_relaxed);
+      break;
+    case RDC_FI_RDC_PROF_FETCH_LATENCY:
+      v = module_latency_us_[RDC_SELF_MODULE_PROF].load(std::memory_order_relaxed);
+      break;
+    case RDC_FI_RDC_SAMPLES_PER_SEC:
+      v = samples_per_sec_.load(std::memory_order_relaxed);
+      break;
+    case RDC_FI_RDC_CACHE_SAMPLES:
+      v = cache_samples_.load(std::memory_order_relaxed);
+      break;
+    case RDC_FI_RDC_CACHE_BYTES:
+      v = cache_bytes_.load(std::memory_order_relaxed);
+      break;
+    case RDC_FI_RDC_API_CALLS_PER_SEC:
+      v = api_calls_per_sec_.load(std::memory_order_relaxed);
+      break;
+    case RDC_FI_RDC_FETCH_QUEUE_DEPTH:
+      v = fetch_queue_depth_.load(std::memory_order_relaxed);
+      break;
+    case RDC_FI_RDC_EVENT_QUEUE_DEPTH:
+      v = event_queue_depth_.load(std::memory_order_relaxed);
+      break;
+    case RDC_FI_RDC_EXPORT_SAMPLES:
+      v = export_samples_.load(std::memory_order_relaxed);
+      break;
+    case RDC_FI_RDC_EXPORT_DROPPED:
+      v = export_dropped_.load(std::memory_order_relaxed);
+      break;
+    default:
+      return RDC_ST_NOT_SUPPORTED;
+  }
+  *value = static_cast<int64_t>(v);
+  return RDC_ST_OK;
+}
+
+}  // namespace rdc
+}  // namespace amd
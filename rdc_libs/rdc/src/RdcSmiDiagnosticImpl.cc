@@ -48,7 +48,7 @@ rdc_status_t RdcSmiDiagnosticImpl::check_smi_process_info(uint32_t gpu_index[RDC
   result->per_gpu_result_count = 0;
   amdsmi_status_t err = AMDSMI_STATUS_SUCCESS;
   uint32_t num_items = 0;
-  err = amdsmi_get_gpu_compute_process_info(nullptr, &num_items);
+  err = get_smi_backend()->get_gpu_compute_process_info(nullptr, &num_items);
   if (err != AMDSMI_STATUS_SUCCESS) {
     RDC_LOG(RDC_ERROR, "Fail to get process information: " << err);
     strncpy_with_null(result->info, "Fail to retreive process information from amd_smi_lib",
@@ -67,8 +67,8 @@ rdc_status_t RdcSmiDiagnosticImpl::check_smi_process_info(uint32_t gpu_index[RDC
   std::string info;
   // Find details of the process running on each GPU
   std::vector<amdsmi_process_info_t> procs(num_items);
-  err = amdsmi_get_gpu_compute_process_info(reinterpret_cast<amdsmi_process_info_t*>(&procs[0]),
-                                            &num_items);
+  err = get_smi_backend()->get_gpu_compute_process_info(
+      reinterpret_cast<amdsmi_process_info_t*>(&procs[0]), &num_items);
   if (err != AMDSMI_STATUS_SUCCESS) {
     RDC_LOG(RDC_INFO, "Fail to get process detail information: " << err);
     strncpy_with_null(result->info, info.c_str(), MAX_DIAG_MSG_LENGTH);
@@ -89,7 +89,8 @@ rdc_status_t RdcSmiDiagnosticImpl::check_smi_process_info(uint32_t gpu_index[RDC
     // Get the num_devices the process is running
     uint32_t num_devices = 0;
     amdsmi_status_t err;
-    err = amdsmi_get_gpu_compute_process_gpus(procs[i].process_id, nullptr, &num_devices);
+    err =
+        get_smi_backend()->get_gpu_compute_process_gpus(procs[i].process_id, nullptr, &num_devices);
     if (err != AMDSMI_STATUS_SUCCESS || num_devices == 0) {
       RDC_LOG(RDC_INFO, "Fail to get process GPUs detail information: " << err);
       continue;
@@ -97,7 +98,7 @@ rdc_status_t RdcSmiDiagnosticImpl::check_smi_process_info(uint32_t gpu_index[RDC
 
     // Get the details of devices
     std::vector<uint32_t> device_details(num_devices);
-    err = amdsmi_get_gpu_compute_process_gpus(
+    err = get_smi_backend()->get_gpu_compute_process_gpus(
         procs[i].process_id, reinterpret_cast<uint32_t*>(&device_details[0]), &num_devices);
     if (err != AMDSMI_STATUS_SUCCESS) {
       RDC_LOG(RDC_INFO, "Fail to get process GPUs detail information: " << err);
@@ -202,7 +203,7 @@ rdc_status_t RdcSmiDiagnosticImpl::check_smi_topo_info(uint32_t gpu_index[RDC_MA
       err = get_processor_handle_from_id(gpu_index[i], &ph.second);
 
       uint64_t weight;
-      err = amdsmi_topo_get_link_weight(ph.first, ph.second, &weight);
+      err = get_smi_backend()->topo_get_link_weight(ph.first, ph.second, &weight);
       if (err != AMDSMI_STATUS_SUCCESS) {
         result->status = RDC_DIAG_RESULT_FAIL;
         result->details.code = err;
@@ -284,13 +285,13 @@ rdc_diag_result_t RdcSmiDiagnosticImpl::check_temperature_level(
   amdsmi_processor_handle processor_handle;
   get_processor_handle_from_id(gpu_index, &processor_handle);
 
-  err = amdsmi_get_temp_metric(processor_handle, type, met, &current_temp);
+  err = get_smi_backend()->get_temp_metric(processor_handle, type, met, &current_temp);
   if (err != AMDSMI_STATUS_SUCCESS) return result;
 
   // Max temperature
   met = AMDSMI_TEMP_MAX;
   int64_t max_temp = 0;
-  err = amdsmi_get_temp_metric(processor_handle, type, met, &max_temp);
+  err = get_smi_backend()->get_temp_metric(processor_handle, type, met, &max_temp);
   if (err == AMDSMI_STATUS_SUCCESS) {
     if (current_temp >= max_temp) {
       result = RDC_DIAG_RESULT_WARN;
@@ -315,7 +316,7 @@ rdc_diag_result_t RdcSmiDiagnosticImpl::check_temperature_level(
 
   met = AMDSMI_TEMP_MIN;
   int64_t min_temp = 0;
-  err = amdsmi_get_temp_metric(processor_handle, type, met, &min_temp);
+  err = get_smi_backend()->get_temp_metric(processor_handle, type, met, &min_temp);
   if (err == AMDSMI_STATUS_SUCCESS) {
     if (current_temp <= min_temp) {
       result = RDC_DIAG_RESULT_WARN;
@@ -339,7 +340,7 @@ rdc_diag_result_t RdcSmiDiagnosticImpl::check_temperature_level(
 
   met = AMDSMI_TEMP_CRITICAL;
   int64_t critical_temp = 0;
-  err = amdsmi_get_temp_metric(processor_handle, type, met, &critical_temp);
+  err = get_smi_backend()->get_temp_metric(processor_handle, type, met, &critical_temp);
   if (err == AMDSMI_STATUS_SUCCESS) {
     if (current_temp >= critical_temp) {
       result = RDC_DIAG_RESULT_FAIL;
@@ -363,7 +364,7 @@ rdc_diag_result_t RdcSmiDiagnosticImpl::check_temperature_level(
 
   met = AMDSMI_TEMP_EMERGENCY;
   int64_t emergency_temp = 0;
-  err = amdsmi_get_temp_metric(processor_handle, type, met, &emergency_temp);
+  err = get_smi_backend()->get_temp_metric(processor_handle, type, met, &emergency_temp);
   if (err == AMDSMI_STATUS_SUCCESS) {
     if (current_temp >= critical_temp) {
       result = RDC_DIAG_RESULT_FAIL;
@@ -387,7 +388,7 @@ rdc_diag_result_t RdcSmiDiagnosticImpl::check_temperature_level(
 
   met = AMDSMI_TEMP_CRIT_MIN;
   int64_t critical_min_temp = 0;
-  err = amdsmi_get_temp_metric(processor_handle, type, met, &critical_min_temp);
+  err = get_smi_backend()->get_temp_metric(processor_handle, type, met, &critical_min_temp);
   if (err == AMDSMI_STATUS_SUCCESS) {
     if (current_temp <= critical_min_temp) {
       result = RDC_DIAG_RESULT_FAIL;
@@ -428,13 +429,13 @@ rdc_diag_result_t RdcSmiDiagnosticImpl::check_voltage_level(uint32_t gpu_index,
   amdsmi_processor_handle processor_handle;
   get_processor_handle_from_id(gpu_index, &processor_handle);
 
-  err = amdsmi_get_gpu_volt_metric(processor_handle, type, met, &current_voltage);
+  err = get_smi_backend()->get_gpu_volt_metric(processor_handle, type, met, &current_voltage);
   if (err != AMDSMI_STATUS_SUCCESS) return result;
 
   // Max voltage
   met = AMDSMI_VOLT_MAX;
   int64_t max_volt = 0;
-  err = amdsmi_get_gpu_volt_metric(processor_handle, type, met, &max_volt);
+  err = get_smi_backend()->get_gpu_volt_metric(processor_handle, type, met, &max_volt);
   if (err == AMDSMI_STATUS_SUCCESS) {
     if (current_voltage >= max_volt) {
       result = RDC_DIAG_RESULT_WARN;
@@ -460,7 +461,7 @@ rdc_diag_result_t RdcSmiDiagnosticImpl::check_voltage_level(uint32_t gpu_index,
   // Min voltage
   met = AMDSMI_VOLT_MIN;
   int64_t min_volt = 0;
-  err = amdsmi_get_gpu_volt_metric(processor_handle, type, met, &min_volt);
+  err = get_smi_backend()->get_gpu_volt_metric(processor_handle, type, met, &min_volt);
   if (err == AMDSMI_STATUS_SUCCESS) {
     if (current_voltage <= min_volt) {
       result = RDC_DIAG_RESULT_WARN;
@@ -486,7 +487,7 @@ rdc_diag_result_t RdcSmiDiagnosticImpl::check_voltage_level(uint32_t gpu_index,
   // Max Critical voltage
   met = AMDSMI_VOLT_MAX_CRIT;
   int64_t critical_max_volt = 0;
-  err = amdsmi_get_gpu_volt_metric(nullptr, type, met, &critical_max_volt);
+  err = get_smi_backend()->get_gpu_volt_metric(nullptr, type, met, &critical_max_volt);
   if (err == AMDSMI_STATUS_SUCCESS) {
     if (current_voltage >= critical_max_volt) {
       result = RDC_DIAG_RESULT_FAIL;
@@ -512,7 +513,7 @@ rdc_diag_result_t RdcSmiDiagnosticImpl::check_voltage_level(uint32_t gpu_index,
   // Min Critical voltage
   met = AMDSMI_VOLT_MIN_CRIT;
   int64_t critical_min_volt = 0;
-  err = amdsmi_get_gpu_volt_metric(nullptr, type, met, &critical_min_volt);
+  err = get_smi_backend()->get_gpu_volt_metric(nullptr, type, met, &critical_min_volt);
   if (err == AMDSMI_STATUS_SUCCESS) {
     if (current_voltage <= critical_min_volt) {
       result = RDC_DIAG_RESULT_FAIL;
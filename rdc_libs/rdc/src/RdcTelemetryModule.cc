@@ -26,6 +26,8 @@ THE SOFTWARE.
 #include "rdc_lib/RdcException.h"
 #include "rdc_lib/RdcLogger.h"
 #include "rdc_lib/RdcMetricFetcher.h"
+#include "rdc_lib/RdcPipelineTrace.h"
+#include "rdc_lib/impl/RdcRocpLib.h"
 #include "rdc_lib/impl/RdcSmiLib.h"
 
 namespace amd {
@@ -94,6 +96,19 @@ RdcTelemetryModule::RdcTelemetryModule(std::list<RdcTelemetryPtr> telemetry_modu
     : telemetry_modules_(telemetry_modules) {
   auto ite = telemetry_modules_.begin();
   for (; ite != telemetry_modules_.end(); ite++) {
+    RdcSelfModule self_module = RDC_SELF_MODULE_OTHER;
+    const char* histogram_name = "module_fetch.other";
+    if (std::dynamic_pointer_cast<RdcSmiLib>(*ite)) {
+      self_module = RDC_SELF_MODULE_SMI;
+      histogram_name = "module_fetch.smi";
+    } else if (std::dynamic_pointer_cast<RdcRocpLib>(*ite)) {
+      self_module = RDC_SELF_MODULE_PROF;
+      histogram_name = "module_fetch.rocprofiler";
+    }
+    module_timers_[*ite] = {fetch_timer_.CreateTimer(), self_module,
+                            &RdcPerfRegistry::get_instance().get_histogram(histogram_name),
+                            histogram_name};
+
     uint32_t field_ids[MAX_NUM_FIELDS];
     uint32_t field_count = 0;
     rdc_status_t status = (*ite)->rdc_telemetry_fields_query(field_ids, &field_count);
@@ -141,7 +156,17 @@ rdc_status_t RdcTelemetryModule::rdc_telemetry_fields_value_get(rdc_gpu_field_t*
   for (; ite != fields_to_fetch.end(); ite++) {
     rdc_gpu_field_t f[MAX_NUM_FIELDS];
     std::copy(ite->second.begin(), ite->second.end(), f);
-    ite->first->rdc_telemetry_fields_value_get(f, ite->second.size(), callback, user_data);
+    const ModuleTiming& timing = module_timers_[ite->first];
+    fetch_timer_.ResetTimer(timing.timer);
+    fetch_timer_.StartTimer(timing.timer);
+    do {
+      RDC_PIPELINE_SCOPE(timing.name);
+      ite->first->rdc_telemetry_fields_value_get(f, ite->second.size(), callback, user_data);
+    } while (0);
+    fetch_timer_.StopTimer(timing.timer);
+    uint64_t latency_ns = static_cast<uint64_t>(fetch_timer_.ReadTimer(timing.timer) * 1000000000);
+    timing.histogram->record(latency_ns);
+    RdcSelfStats::get_instance().record_module_fetch(timing.self_module, latency_ns / 1000);
   }
 
   // Notify the caller unsupported fields
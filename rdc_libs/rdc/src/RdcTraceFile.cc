@@ -0,0 +1,247 @@
+/*
+Copyright (c) 2024 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "rdc_lib/impl/RdcTraceFile.h"
+
+#include <string.h>
+
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+
+#include "rdc_lib/RdcException.h"
+#include "rdc_lib/RdcLogger.h"
+#include "rdc_lib/impl/RdcEncoding.h"
+
+namespace amd {
+namespace rdc {
+
+namespace {
+
+const char kTraceMagic[8] = {'R', 'D', 'C', 'T', 'R', 'C', '0', '1'};
+// Write to the file when the buffer grows past this size or the trace
+// advances by kFlushIntervalMs, whichever comes first.
+const size_t kFlushBytes = 64 * 1024;
+const uint64_t kFlushIntervalMs = 1000;
+
+}  // namespace
+
+RdcTraceWriter::RdcTraceWriter(const std::string& path)
+    : file_(nullptr), last_ts_(0), last_flush_ts_(0) {
+  file_ = std::fopen(path.c_str(), "wb");
+  if (file_ == nullptr) {
+    throw RdcException(RDC_ST_FILE_ERROR, "Fail to create trace file " + path);
+  }
+  std::fwrite(kTraceMagic, 1, sizeof(kTraceMagic), file_);
+  buf_.reserve(kFlushBytes * 2);
+  RDC_LOG(RDC_INFO, "Recording field trace to " << path);
+}
+
+RdcTraceWriter::~RdcTraceWriter() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  if (!buf_.empty()) {
+    std::fwrite(buf_.data(), 1, buf_.size(), file_);
+  }
+  std::fclose(file_);
+}
+
+RdcTraceWriterPtr RdcTraceWriter::from_env() {
+  const char* path = getenv("RDC_TRACE_RECORD");
+  if (path == nullptr || path[0] == '\0') {
+    return nullptr;
+  }
+  try {
+    return std::make_shared<RdcTraceWriter>(path);
+  } catch (const RdcException& e) {
+    RDC_LOG(RDC_ERROR, e.what());
+  }
+  return nullptr;
+}
+
+uint32_t RdcTraceWriter::string_index(const char* str, size_t len) {
+  std::string s(str, len);
+  auto ite = strings_.find(s);
+  if (ite != strings_.end()) {
+    return ite->second;
+  }
+  uint32_t index = strings_.size();
+  buf_.push_back(RDC_TRACE_STRING);
+  put_varint(&buf_, len);
+  buf_.insert(buf_.end(), str, str + len);
+  strings_.emplace(std::move(s), index);
+  return index;
+}
+
+void RdcTraceWriter::write_record(RdcTraceRecordKind kind, uint32_t gpu_index,
+                                  const rdc_field_value& field) {
+  // Strings must be defined before the record which refers to them
+  uint32_t str_index = 0;
+  bool has_value = field.status == RDC_ST_OK;
+  if (has_value && (field.type == STRING || field.type == BLOB)) {
+    str_index = string_index(field.value.str, strnlen(field.value.str, RDC_MAX_STR_LENGTH));
+  }
+
+  // Failed fetches may not carry a timestamp
+  uint64_t ts = has_value ? field.ts : last_ts_;
+  buf_.push_back(kind);
+  put_varint(&buf_, zigzag(static_cast<int64_t>(ts - last_ts_)));
+  last_ts_ = ts;
+  put_varint(&buf_, gpu_index);
+  put_varint(&buf_, field.field_id);
+  put_varint(&buf_, zigzag(field.status));
+  if (!has_value) {
+    return;
+  }
+  buf_.push_back(static_cast<uint8_t>(field.type));
+  switch (field.type) {
+    case INTEGER:
+      put_varint(&buf_, zigzag(field.value.l_int));
+      break;
+    case DOUBLE: {
+      const uint8_t* p = reinterpret_cast<const uint8_t*>(&field.value.dbl);
+      buf_.insert(buf_.end(), p, p + sizeof(double));
+      break;
+    }
+    default:
+      put_varint(&buf_, str_index);
+      break;
+  }
+}
+
+void RdcTraceWriter::write_fields(const rdc_gpu_field_value_t* values, uint32_t num_values) {
+  if (values == nullptr) {
+    return;
+  }
+  std::lock_guard<std::mutex> guard(mutex_);
+  for (uint32_t i = 0; i < num_values; i++) {
+    write_record(RDC_TRACE_FIELD, values[i].gpu_index, values[i].field_value);
+  }
+  if (buf_.size() >= kFlushBytes || last_ts_ - last_flush_ts_ >= kFlushIntervalMs) {
+    std::fwrite(buf_.data(), 1, buf_.size(), file_);
+    std::fflush(file_);
+    buf_.clear();
+    last_flush_ts_ = last_ts_;
+  }
+}
+
+void RdcTraceWriter::write_events(const rdc_evnt_notification_t* events, uint32_t num_events) {
+  if (events == nullptr) {
+    return;
+  }
+  std::lock_guard<std::mutex> guard(mutex_);
+  for (uint32_t i = 0; i < num_events; i++) {
+    write_record(RDC_TRACE_EVENT, events[i].gpu_id, events[i].field);
+  }
+  // Events are rare, always write them out
+  std::fwrite(buf_.data(), 1, buf_.size(), file_);
+  std::fflush(file_);
+  buf_.clear();
+  last_flush_ts_ = last_ts_;
+}
+
+std::vector<RdcTraceRecord> rdc_trace_read(const std::string& path) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) {
+    throw RdcException(RDC_ST_FILE_ERROR, "Fail to open trace file " + path);
+  }
+  std::vector<uint8_t> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  if (data.size() < sizeof(kTraceMagic) || memcmp(data.data(), kTraceMagic, sizeof(kTraceMagic))) {
+    throw RdcException(RDC_ST_FILE_ERROR, "Not a RDC trace file " + path);
+  }
+
+  PayloadReader input(data.data() + sizeof(kTraceMagic), data.size() - sizeof(kTraceMagic));
+  std::vector<std::string> strings;
+  std::vector<RdcTraceRecord> records;
+  uint64_t ts = 0;
+  bool complete = true;
+  while (!input.eof()) {
+    uint8_t kind;
+    input.get_byte(&kind);
+    uint64_t v;
+    if (kind == RDC_TRACE_STRING) {
+      std::string s;
+      if (!input.get_varint(&v) || v > RDC_MAX_STR_LENGTH) {
+        complete = false;
+        break;
+      }
+      s.resize(v);
+      if (!input.get_bytes(&s[0], v)) {
+        complete = false;
+        break;
+      }
+      strings.push_back(std::move(s));
+      continue;
+    }
+    if (kind != RDC_TRACE_FIELD && kind != RDC_TRACE_EVENT) {
+      complete = false;
+      break;
+    }
+
+    RdcTraceRecord r = {};
+    r.is_event = kind == RDC_TRACE_EVENT;
+    uint64_t gpu, field_id, status;
+    if (!input.get_varint(&v) || !input.get_varint(&gpu) || !input.get_varint(&field_id) ||
+        !input.get_varint(&status)) {
+      complete = false;
+      break;
+    }
+    ts += unzigzag(v);
+    r.gpu_index = static_cast<uint32_t>(gpu);
+    r.field.ts = ts;
+    r.field.field_id = static_cast<rdc_field_t>(field_id);
+    r.field.status = static_cast<int>(unzigzag(status));
+    if (r.field.status == RDC_ST_OK) {
+      uint8_t type;
+      if (!input.get_byte(&type)) {
+        complete = false;
+        break;
+      }
+      r.field.type = static_cast<rdc_field_type_t>(type);
+      bool ok;
+      if (type == INTEGER) {
+        ok = input.get_varint(&v);
+        r.field.value.l_int = unzigzag(v);
+      } else if (type == DOUBLE) {
+        ok = input.get_bytes(&r.field.value.dbl, sizeof(double));
+      } else {
+        ok = input.get_varint(&v) && v < strings.size();
+        if (ok) {
+          strncpy(r.field.value.str, strings[v].c_str(), RDC_MAX_STR_LENGTH - 1);
+        }
+      }
+      if (!ok) {
+        complete = false;
+        break;
+      }
+    }
+    records.push_back(r);
+  }
+
+  // A recorder killed mid-write leaves a partial record at the end
+  if (!complete) {
+    RDC_LOG(RDC_ERROR, "Trace file " << path << " is truncated after " << records.size()
+                                     << " records");
+  }
+  return records;
+}
+
+}  // namespace rdc
+}  // namespace amd
@@ -26,13 +26,18 @@ THE SOFTWARE.
 
 #include <algorithm>
 #include <ctime>
+#include <iterator>
 #include <map>
 #include <sstream>
 #include <unordered_map>
 
+#include "common/rdc_fields_supported.h"
+#include "common/rdc_perf_histogram.h"
 #include "common/rdc_utils.h"
 #include "rdc/rdc.h"
 #include "rdc_lib/RdcLogger.h"
+#include "rdc_lib/RdcPipelineTrace.h"
+#include "rdc_lib/RdcSelfStats.h"
 #include "rdc_lib/impl/RdcMetricFetcherImpl.h"
 #include "rdc_lib/rdc_common.h"
 
@@ -42,11 +47,23 @@ namespace rdc {
 RdcWatchTableImpl::RdcWatchTableImpl(const RdcGroupSettingsPtr& group_settings,
                                      const RdcCacheManagerPtr& cache_mgr,
                                      const RdcModuleMgrPtr& module_mgr,
-                                     const RdcNotificationPtr& notif)
+                                     const RdcNotificationPtr& notif,
+                                     const RdcHistoryLogPtr& history_log,
+                                     const RdcPolicyEnginePtr& policy,
+                                     const RdcAnomalyDetectorPtr& anomaly,
+                                     const RdcDerivedFieldsPtr& derived)
     : group_settings_(group_settings),
       cache_mgr_(cache_mgr),
       rdc_module_mgr_(module_mgr),
       notifications_(notif),
+      trace_writer_(RdcTraceWriter::from_env()),
+      history_log_(history_log),
+      exporter_(RdcPushExporter::from_env()),
+      policy_(policy),
+      anomaly_(anomaly),
+      derived_(derived),
+      tick_timer_(perf_timer_.CreateTimer()),
+      fetch_timer_(perf_timer_.CreateTimer()),
       last_cleanup_time_(0) {}
 
 rdc_status_t RdcWatchTableImpl::rdc_job_start_stats(rdc_gpu_group_t group_id, const char job_id[64],
@@ -165,9 +182,23 @@ rdc_status_t RdcWatchTableImpl::get_fields_from_group(rdc_gpu_group_t group_id,
     return result;
   }
 
-  for (uint32_t i = 0; i < ginfo.count; i++) {    // GPUs
-    for (uint32_t j = 0; j < finfo.count; j++) {  // Fields
-      fields.push_back(RdcFieldKey({ginfo.entity_ids[i], finfo.field_ids[j]}));
+  // A derived field is computed from the samples of its inputs
+  std::vector<rdc_field_t> field_ids(finfo.field_ids, finfo.field_ids + finfo.count);
+  if (derived_) {
+    for (uint32_t j = 0; j < finfo.count; j++) {
+      derived_->get_inputs(finfo.field_ids[j], &field_ids);
+    }
+  }
+
+  for (uint32_t i = 0; i < ginfo.count; i++) {  // GPUs
+    for (auto input : field_ids) {              // Fields
+      // A rate is computed by the cache from the samples of its counter
+      rdc_field_t field_id = input;
+      get_rate_counter_field(input, &field_id);
+      RdcFieldKey key({ginfo.entity_ids[i], field_id});
+      if (std::find(fields.begin(), fields.end(), key) == fields.end()) {
+        fields.push_back(key);
+      }
     }
   }
 
@@ -278,10 +309,24 @@ rdc_status_t RdcWatchTableImpl::rdc_field_watch(rdc_gpu_group_t group_id,
     }
     rdc_telemetry->rdc_telemetry_fields_watch(&fields[0], fields.size());
   }
+  update_derived_watches();
 
   return RDC_ST_OK;
 }
 
+void RdcWatchTableImpl::update_derived_watches() {
+  if (!derived_) {
+    return;
+  }
+  std::map<RdcFieldKey, uint64_t> update_freqs;
+  for (const auto& field : fields_to_watch_) {
+    if (field.second.is_watching) {
+      update_freqs.insert({field.first, field.second.update_freq});
+    }
+  }
+  derived_->set_watched(update_freqs);
+}
+
 rdc_status_t RdcWatchTableImpl::update_field_in_table_when_unwatch(const RdcFieldGroupKey& entry) {
   // Get individual fields for this unwatch
   std::vector<RdcFieldKey> fields;
@@ -350,10 +395,26 @@ rdc_status_t RdcWatchTableImpl::update_field_in_table_when_unwatch(const RdcFiel
   if (rdc_telemetry) {
     rdc_telemetry->rdc_telemetry_fields_unwatch(&unwatch_fields[0], unwatch_fields.size());
   }
+  update_derived_watches();
 
   return RDC_ST_OK;
 }
 
+rdc_status_t RdcWatchTableImpl::rdc_field_get_update_freq(uint32_t gpu_index,
+                                                         rdc_field_t field_id,
+                                                         uint64_t* update_freq) {
+  if (update_freq == nullptr) {
+    return RDC_ST_BAD_PARAMETER;
+  }
+  std::lock_guard<std::mutex> guard(watch_mutex_);
+  auto field = fields_to_watch_.find({gpu_index, field_id});
+  if (field == fields_to_watch_.end() || !field->second.is_watching) {
+    return RDC_ST_NOT_FOUND;
+  }
+  *update_freq = field->second.update_freq;
+  return RDC_ST_OK;
+}
+
 rdc_status_t RdcWatchTableImpl::rdc_field_unwatch(rdc_gpu_group_t group_id,
                                                   rdc_field_grp_t field_group_id) {
   struct timeval tv;
@@ -373,6 +434,29 @@ rdc_status_t RdcWatchTableImpl::rdc_field_unwatch(rdc_gpu_group_t group_id,
   return update_field_in_table_when_unwatch(ite->first);
 }
 
+rdc_status_t RdcWatchTableImpl::rdc_field_ingest(uint32_t gpu_index, const rdc_field_value* values,
+                                                 uint32_t num_values, double max_keep_age,
+                                                 uint32_t max_keep_samples) {
+  if (values == nullptr) {
+    return RDC_ST_BAD_PARAMETER;
+  }
+  std::vector<rdc_gpu_field_value_t> fields(num_values);
+  for (uint32_t i = 0; i < num_values; i++) {
+    fields[i].gpu_index = gpu_index;
+    fields[i].field_value = values[i];
+  }
+
+  std::lock_guard<std::mutex> guard(watch_mutex_);
+  for (uint32_t i = 0; i < num_values; i++) {
+    // Never fetched by rdc_field_update_all(), but evicted by clean_up()
+    RdcFieldKey key{gpu_index, values[i].field_id};
+    if (fields_to_watch_.find(key) == fields_to_watch_.end()) {
+      fields_to_watch_.insert({key, {0, max_keep_samples, max_keep_age, false, 0}});
+    }
+  }
+  return num_values == 0 ? RDC_ST_OK : handle_fields(fields.data(), num_values, this);
+}
+
 bool RdcWatchTableImpl::is_job_watch_field(uint32_t gpu_index, rdc_field_t field_id,
                                            std::string& job_id) const {
   RdcFieldKey key{gpu_index, field_id};
@@ -394,7 +478,12 @@ rdc_status_t RdcWatchTableImpl::handle_fields(rdc_gpu_field_value_t* values, uin
     return RDC_ST_BAD_PARAMETER;
   }
   RdcWatchTableImpl* watchTable = static_cast<RdcWatchTableImpl*>(user_data);
+  if (watchTable->trace_writer_) {
+    watchTable->trace_writer_->write_fields(values, num_values);
+  }
 
+  uint64_t num_cached = 0;
+  std::vector<rdc_evnt_notification_t> raised;
   for (uint32_t i = 0; i < num_values; i++) {
     auto gpu_index = values[i].gpu_index;
     auto field_id = values[i].field_value.field_id;
@@ -414,7 +503,15 @@ rdc_status_t RdcWatchTableImpl::handle_fields(rdc_gpu_field_value_t* values, uin
     }
 
     // Update the cache
-    watchTable->cache_mgr_->rdc_update_cache(gpu_index, values[i].field_value);
+    watchTable->cache_value(gpu_index, values[i].field_value, &raised);
+    num_cached++;
+
+    // The rate of a counter goes through the same path as the counter
+    rdc_field_value rate;
+    if (watchTable->update_rate(gpu_index, values[i].field_value, &rate)) {
+      watchTable->cache_value(gpu_index, rate, &raised);
+      num_cached++;
+    }
 
     // Update the job stats cache
     std::string job_id;
@@ -422,9 +519,94 @@ rdc_status_t RdcWatchTableImpl::handle_fields(rdc_gpu_field_value_t* values, uin
       watchTable->cache_mgr_->rdc_update_job_stats(gpu_index, job_id, values[i].field_value);
     }
   }
+
+  watchTable->cache_raised_events(raised);
+  RdcSelfStats::get_instance().record_samples(num_cached + raised.size());
   return RDC_ST_OK;
 }
 
+void RdcWatchTableImpl::cache_value(uint32_t gpu_index, const rdc_field_value& value,
+                                    std::vector<rdc_evnt_notification_t>* raised) {
+  cache_mgr_->rdc_update_cache(gpu_index, value);
+  if (history_log_) {
+    history_log_->append(gpu_index, value);
+  }
+  if (exporter_) {
+    exporter_->append(gpu_index, value);
+  }
+  if (policy_) {
+    policy_->evaluate(gpu_index, value, raised);
+  }
+  if (anomaly_) {
+    anomaly_->evaluate(gpu_index, value, raised);
+  }
+  if (derived_) {
+    derived_->evaluate(gpu_index, value);
+  }
+}
+
+bool RdcWatchTableImpl::update_rate(uint32_t gpu_index, const rdc_field_value& value,
+                                    rdc_field_value* rate) {
+  rdc_field_t rate_field;
+  if (value.type != INTEGER || !get_rate_field(value.field_id, &rate_field)) {
+    return false;
+  }
+
+  RdcFieldKey field = {gpu_index, value.field_id};
+  uint64_t counter = static_cast<uint64_t>(value.value.l_int);
+  auto ite = counters_.find(field);
+  if (ite == counters_.end()) {
+    counters_[field] = {value.ts, counter};
+    return false;
+  }
+  RdcCounterState& last = ite->second;
+  if (value.ts <= last.last_time) {
+    return false;
+  }
+
+  // The delta is taken modulo 2^64, which is right across a wrap of the
+  // counter. A counter going back by less than half its range was reset
+  // instead, by the driver or a GPU reset: the rate restarts from there.
+  uint64_t delta = counter - last.last_value;
+  bool reset = counter < last.last_value && last.last_value - counter < (1ULL << 63);
+  uint64_t elapsed = value.ts - last.last_time;
+  last = {value.ts, counter};
+  if (reset) {
+    RDC_LOG(RDC_DEBUG, "The counter " << value.field_id << " of GPU " << gpu_index
+                                      << " was reset");
+    return false;
+  }
+
+  rate->field_id = rate_field;
+  rate->status = RDC_ST_OK;
+  rate->ts = value.ts;
+  rate->type = DOUBLE;
+  rate->value.dbl = static_cast<double>(delta) * 1000 / elapsed;
+  return true;
+}
+
+void RdcWatchTableImpl::cache_raised_events(const std::vector<rdc_evnt_notification_t>& events) {
+  // The events are cached as events of their GPU, like the notifications
+  for (const auto& event : events) {
+    if (event.field.field_id == RDC_EVNT_NOTIF_ANOMALY) {
+      RDC_LOG(RDC_INFO, "Anomaly of the field " << event.field.value.l_int << " on GPU "
+                                                << event.gpu_id);
+    } else {
+      const char* what =
+          event.field.field_id == RDC_EVNT_NOTIF_POLICY_CLEARED ? " cleared" : " violated";
+      RDC_LOG(RDC_INFO, "Policy rule " << event.field.value.l_int << what << " on GPU "
+                                       << event.gpu_id);
+    }
+    cache_mgr_->rdc_update_cache(event.gpu_id, event.field);
+    if (history_log_) {
+      history_log_->append(event.gpu_id, event.field);
+    }
+    if (exporter_) {
+      exporter_->append(event.gpu_id, event.field);
+    }
+  }
+}
+
 rdc_status_t RdcWatchTableImpl::rdc_field_update_all() {
   struct timeval tv;
   gettimeofday(&tv, NULL);
@@ -433,6 +615,14 @@ rdc_status_t RdcWatchTableImpl::rdc_field_update_all() {
   // Collect all fields need to be updated for bulk fetch
   std::vector<rdc_gpu_field_t> fields;
   std::lock_guard<std::mutex> guard(watch_mutex_);
+  RDC_PERF_SCOPE("field_update_all");
+  RDC_PIPELINE_SCOPE("field_update_all");
+  perf_timer_.ResetTimer(tick_timer_);
+  perf_timer_.ResetTimer(fetch_timer_);
+  perf_timer_.StartTimer(tick_timer_);
+
+  // The shortest interval among the fetched fields, in milliseconds
+  uint64_t min_track_freq = UINT64_MAX;
   auto fite = fields_to_watch_.begin();
   for (; fite != fields_to_watch_.end(); fite++) {
     // Is this field need to be updated?
@@ -441,24 +631,40 @@ rdc_status_t RdcWatchTableImpl::rdc_field_update_all() {
       continue;
     }
     fields.push_back({fite->first.first, fite->first.second});
+    min_track_freq = std::min(min_track_freq, track_freq);
   }
 
   if (fields.size() != 0) {
     auto rdc_telemetry = rdc_module_mgr_->get_telemetry_module();
     if (rdc_telemetry) {
+      perf_timer_.StartTimer(fetch_timer_);
       rdc_telemetry->rdc_telemetry_fields_value_get(&fields[0], fields.size(),
                                                     RdcWatchTableImpl::handle_fields, this);
+      perf_timer_.StopTimer(fetch_timer_);
     } else {
       RDC_LOG(RDC_ERROR, "RdcWatchTableImpl: Fail to get the telemetry module");
     }
   }
 
   // Clean up is expensive, only do it once per second
+  auto& self_stats = RdcSelfStats::get_instance();
   if (now - last_cleanup_time_ > 1000) {
     clean_up();
     last_cleanup_time_ = now;
+
+    uint64_t num_samples = 0;
+    uint64_t num_bytes = 0;
+    cache_mgr_->get_cache_usage(&num_samples, &num_bytes);
+    self_stats.record_cache_usage(num_samples, num_bytes);
+    self_stats.update_rates(now);
   }
 
+  perf_timer_.StopTimer(tick_timer_);
+  uint64_t tick_us = static_cast<uint64_t>(perf_timer_.ReadTimer(tick_timer_) * 1000000);
+  uint64_t fetch_us = static_cast<uint64_t>(perf_timer_.ReadTimer(fetch_timer_) * 1000000);
+  bool overrun = fields.size() != 0 && tick_us > min_track_freq * 1000;
+  self_stats.record_tick(tick_us, fetch_us, fields.size(), overrun);
+
   return RDC_ST_OK;
 }
 
@@ -467,8 +673,12 @@ rdc_status_t RdcWatchTableImpl::rdc_notif_update_cache(rdc_evnt_notification_t*
   if (events == nullptr || num_events == 0) {
     return RDC_ST_BAD_PARAMETER;
   }
+  if (trace_writer_) {
+    trace_writer_->write_events(events, num_events);
+  }
   std::lock_guard<std::mutex> guard(watch_mutex_);
 
+  std::vector<rdc_evnt_notification_t> raised;
   for (uint32_t i = 0; i < num_events; i++) {
     auto gpu_index = events[i].gpu_id;
     auto field_id = events[i].field.field_id;
@@ -484,8 +694,15 @@ rdc_status_t RdcWatchTableImpl::rdc_notif_update_cache(rdc_evnt_notification_t*
       continue;
     }
 
+    // A GPU reset restarts its counters, so their rates start over
+    if (field_id == RDC_EVNT_NOTIF_PRE_RESET || field_id == RDC_EVNT_NOTIF_POST_RESET) {
+      for (auto counter = counters_.begin(); counter != counters_.end();) {
+        counter = counter->first.first == gpu_index ? counters_.erase(counter) : std::next(counter);
+      }
+    }
+
     // Update the cache
-    cache_mgr_->rdc_update_cache(gpu_index, events[i].field);
+    cache_value(gpu_index, events[i].field, &raised);
 
     // Update the job stats cache
     std::string job_id;
@@ -493,6 +710,7 @@ rdc_status_t RdcWatchTableImpl::rdc_notif_update_cache(rdc_evnt_notification_t*
       cache_mgr_->rdc_update_job_stats(gpu_index, job_id, events[i].field);
     }
   }
+  cache_raised_events(raised);
   return RDC_ST_OK;
 }
 
@@ -502,6 +720,9 @@ rdc_status_t RdcWatchTableImpl::rdc_field_listen_notif(uint32_t timeout_ms) {
   uint32_t num_events = kMaxRSMIEvents;
 
   ret = notifications_->listen(events, &num_events, timeout_ms);
+  if (ret == RDC_ST_OK) {
+    RdcSelfStats::get_instance().record_event_queue_depth(num_events);
+  }
 
   // Update cache
   if (ret == RDC_ST_OK && num_events) {
@@ -522,6 +743,7 @@ void RdcWatchTableImpl::clean_up() {
                             fite->second.max_keep_age);
     if (!fite->second.is_watching &&
         fite->second.last_update_time + fite->second.max_keep_age * 1000 < now) {
+      counters_.erase(fite->first);
       fite = fields_to_watch_.erase(fite);
     } else {
       ++fite;
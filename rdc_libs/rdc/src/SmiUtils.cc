@@ -22,16 +22,32 @@ THE SOFTWARE.
 
 #include "rdc_lib/impl/SmiUtils.h"
 
+#include <string.h>
+
 #include <cstdint>
+#include <cstdlib>
 #include <vector>
 
 #include "amd_smi/amdsmi.h"
 #include "rdc/rdc.h"
 #include "rdc_lib/RdcLogger.h"
+#include "rdc_lib/impl/AmdSmiBackendImpl.h"
+#include "rdc_lib/impl/FakeSmiBackendImpl.h"
 
 namespace amd {
 namespace rdc {
 
+const SmiBackendPtr& get_smi_backend() {
+  static const SmiBackendPtr backend = []() -> SmiBackendPtr {
+    const char* env = getenv("RDC_SMI_BACKEND");
+    if (env != nullptr && strcasecmp(env, "fake") == 0) {
+      return std::make_shared<FakeSmiBackendImpl>(FakeSmiConfig::from_env());
+    }
+    return std::make_shared<AmdSmiBackendImpl>();
+  }();
+  return backend;
+}
+
 rdc_status_t Smi2RdcError(amdsmi_status_t rsmi) {
   switch (rsmi) {
     case AMDSMI_STATUS_SUCCESS:
@@ -78,27 +94,27 @@ amdsmi_status_t get_processor_handle_from_id(uint32_t gpu_id,
                                              amdsmi_processor_handle* processor_handle) {
   uint32_t socket_count;
   uint32_t processor_count;
-  auto ret = amdsmi_get_socket_handles(&socket_count, nullptr);
+  auto ret = get_smi_backend()->get_socket_handles(&socket_count, nullptr);
   if (ret != AMDSMI_STATUS_SUCCESS) {
     return ret;
   }
   std::vector<amdsmi_socket_handle> sockets(socket_count);
   std::vector<amdsmi_processor_handle> all_processors{};
-  ret = amdsmi_get_socket_handles(&socket_count, sockets.data());
+  ret = get_smi_backend()->get_socket_handles(&socket_count, sockets.data());
   for (auto& socket : sockets) {
-    ret = amdsmi_get_processor_handles(socket, &processor_count, nullptr);
+    ret = get_smi_backend()->get_processor_handles(socket, &processor_count, nullptr);
     if (ret != AMDSMI_STATUS_SUCCESS) {
       return ret;
     }
     std::vector<amdsmi_processor_handle> processors(processor_count);
-    ret = amdsmi_get_processor_handles(socket, &processor_count, processors.data());
+    ret = get_smi_backend()->get_processor_handles(socket, &processor_count, processors.data());
     if (ret != AMDSMI_STATUS_SUCCESS) {
       return ret;
     }
 
     for (auto& processor : processors) {
       processor_type_t processor_type = {};
-      ret = amdsmi_get_processor_type(processor, &processor_type);
+      ret = get_smi_backend()->get_processor_type(processor, &processor_type);
       if (processor_type != AMDSMI_PROCESSOR_TYPE_AMD_GPU) {
         RDC_LOG(RDC_ERROR, "Expect AMD_GPU device type!");
         return AMDSMI_STATUS_NOT_SUPPORTED;
@@ -120,15 +136,15 @@ amdsmi_status_t get_processor_handle_from_id(uint32_t gpu_id,
 amdsmi_status_t get_processor_count(uint32_t& all_processor_count) {
   uint32_t total_processor_count = 0;
   uint32_t socket_count;
-  auto ret = amdsmi_get_socket_handles(&socket_count, nullptr);
+  auto ret = get_smi_backend()->get_socket_handles(&socket_count, nullptr);
   if (ret != AMDSMI_STATUS_SUCCESS) {
     return ret;
   }
   std::vector<amdsmi_socket_handle> sockets(socket_count);
-  ret = amdsmi_get_socket_handles(&socket_count, sockets.data());
+  ret = get_smi_backend()->get_socket_handles(&socket_count, sockets.data());
   for (auto& socket : sockets) {
     uint32_t processor_count;
-    ret = amdsmi_get_processor_handles(socket, &processor_count, nullptr);
+    ret = get_smi_backend()->get_processor_handles(socket, &processor_count, nullptr);
     if (ret != AMDSMI_STATUS_SUCCESS) {
       return ret;
     }
@@ -45,7 +45,9 @@ RdcStandaloneHandler::RdcStandaloneHandler(const char* ip_and_port, const char*
     sslOpts.pem_cert_chain = client_cert;
     cred = grpc::SslCredentials(sslOpts);
   }
-  stub_ = ::rdc::RdcAPI::NewStub(grpc::CreateChannel(ip_and_port, cred));
+  auto channel = grpc::CreateChannel(ip_and_port, cred);
+  stub_ = ::rdc::RdcAPI::NewStub(channel);
+  admin_stub_ = ::rdc::RdcAdmin::NewStub(channel);
 }
 
 rdc_status_t RdcStandaloneHandler::error_handle(::grpc::Status status, uint32_t rdc_status) {
@@ -74,6 +76,21 @@ rdc_status_t RdcStandaloneHandler::rdc_job_start_stats(rdc_gpu_group_t groupId,
   return err_status;
 }
 
+namespace {
+
+void copy_stats_summary(const ::rdc::JobStatsSummary& src, rdc_stats_summary_t* target) {
+  target->max_value = src.max_value();
+  target->min_value = src.min_value();
+  target->average = src.average();
+  target->standard_deviation = src.standard_deviation();
+  target->p50 = src.p50();
+  target->p90 = src.p90();
+  target->p95 = src.p95();
+  target->p99 = src.p99();
+}
+
+}  // namespace
+
 bool RdcStandaloneHandler::copy_gpu_usage_info(const ::rdc::GpuUsageInfo& src,
                                                rdc_gpu_usage_info_t* target) {
   if (target == nullptr) {
@@ -88,53 +105,14 @@ bool RdcStandaloneHandler::copy_gpu_usage_info(const ::rdc::GpuUsageInfo& src,
   target->ecc_correct = src.ecc_correct();
   target->ecc_uncorrect = src.ecc_uncorrect();
 
-  const ::rdc::JobStatsSummary& pstats = src.power_usage();
-  target->power_usage.max_value = pstats.max_value();
-  target->power_usage.min_value = pstats.min_value();
-  target->power_usage.average = pstats.average();
-  target->power_usage.standard_deviation = pstats.standard_deviation();
-
-  const ::rdc::JobStatsSummary& cstats = src.gpu_clock();
-  target->gpu_clock.max_value = cstats.max_value();
-  target->gpu_clock.min_value = cstats.min_value();
-  target->gpu_clock.average = cstats.average();
-  target->gpu_clock.standard_deviation = cstats.standard_deviation();
-
-  const ::rdc::JobStatsSummary& ustats = src.gpu_utilization();
-  target->gpu_utilization.max_value = ustats.max_value();
-  target->gpu_utilization.min_value = ustats.min_value();
-  target->gpu_utilization.average = ustats.average();
-  target->gpu_utilization.standard_deviation = ustats.standard_deviation();
-
-  const ::rdc::JobStatsSummary& mstats = src.memory_utilization();
-  target->memory_utilization.max_value = mstats.max_value();
-  target->memory_utilization.min_value = mstats.min_value();
-  target->memory_utilization.average = mstats.average();
-  target->memory_utilization.standard_deviation = mstats.standard_deviation();
-
-  const ::rdc::JobStatsSummary& txstats = src.pcie_tx();
-  target->pcie_tx.max_value = txstats.max_value();
-  target->pcie_tx.min_value = txstats.min_value();
-  target->pcie_tx.average = txstats.average();
-  target->pcie_tx.standard_deviation = txstats.standard_deviation();
-
-  const ::rdc::JobStatsSummary& rxstats = src.pcie_rx();
-  target->pcie_rx.max_value = rxstats.max_value();
-  target->pcie_rx.min_value = rxstats.min_value();
-  target->pcie_rx.average = rxstats.average();
-  target->pcie_rx.standard_deviation = rxstats.standard_deviation();
-
-  const ::rdc::JobStatsSummary& mcstats = src.memory_clock();
-  target->memory_clock.max_value = mcstats.max_value();
-  target->memory_clock.min_value = mcstats.min_value();
-  target->memory_clock.average = mcstats.average();
-  target->memory_clock.standard_deviation = mcstats.standard_deviation();
-
-  const ::rdc::JobStatsSummary& gtstats = src.gpu_temperature();
-  target->gpu_temperature.max_value = gtstats.max_value();
-  target->gpu_temperature.min_value = gtstats.min_value();
-  target->gpu_temperature.average = gtstats.average();
-  target->gpu_temperature.standard_deviation = gtstats.standard_deviation();
+  copy_stats_summary(src.power_usage(), &target->power_usage);
+  copy_stats_summary(src.gpu_clock(), &target->gpu_clock);
+  copy_stats_summary(src.gpu_utilization(), &target->gpu_utilization);
+  copy_stats_summary(src.memory_utilization(), &target->memory_utilization);
+  copy_stats_summary(src.pcie_tx(), &target->pcie_tx);
+  copy_stats_summary(src.pcie_rx(), &target->pcie_rx);
+  copy_stats_summary(src.memory_clock(), &target->memory_clock);
+  copy_stats_summary(src.gpu_temperature(), &target->gpu_temperature);
 
   return true;
 }
@@ -174,6 +152,72 @@ rdc_status_t RdcStandaloneHandler::rdc_job_stop_stats(const char job_id[64]) {
   return err_status;
 }
 
+rdc_status_t RdcStandaloneHandler::rdc_job_get_timeline(const char job_id[64], uint32_t gpu_index,
+                                                        rdc_field_t field,
+                                                        rdc_job_timeline_t* timeline) {
+  if (!timeline) {
+    return RDC_ST_BAD_PARAMETER;
+  }
+
+  ::rdc::GetJobTimelineRequest request;
+  ::rdc::GetJobTimelineResponse reply;
+  ::grpc::ClientContext context;
+
+  request.set_job_id(job_id);
+  request.set_gpu_index(gpu_index);
+  request.set_field_id(field);
+  ::grpc::Status status = stub_->GetJobTimeline(&context, request, &reply);
+  rdc_status_t err_status = error_handle(status, reply.status());
+  if (err_status != RDC_ST_OK) return err_status;
+
+  timeline->bucket_ms = reply.bucket_ms();
+  timeline->num_points = 0;
+  for (int i = 0; i < reply.points_size() && i < RDC_MAX_TIMELINE_POINTS; i++) {
+    const ::rdc::TimelinePoint& src = reply.points(i);
+    rdc_timeline_point_t& point = timeline->points[timeline->num_points++];
+    point.start_ts = src.start_ts();
+    point.count = src.count();
+    point.min_value = src.min_value();
+    point.max_value = src.max_value();
+    point.average = src.average();
+  }
+
+  return RDC_ST_OK;
+}
+
+rdc_status_t RdcStandaloneHandler::rdc_job_list(const rdc_job_filter_t* filter,
+                                                rdc_job_list_t* jobs) {
+  if (!filter || !jobs) {
+    return RDC_ST_BAD_PARAMETER;
+  }
+
+  ::rdc::ListJobsRequest request;
+  ::rdc::ListJobsResponse reply;
+  ::grpc::ClientContext context;
+
+  request.set_start_since(filter->start_since);
+  request.set_start_until(filter->start_until);
+  request.set_field_id(filter->field_id);
+  request.set_min_average(filter->min_average);
+  request.set_max_average(filter->max_average);
+  request.set_cursor(filter->cursor);
+  ::grpc::Status status = stub_->ListJobs(&context, request, &reply);
+  rdc_status_t err_status = error_handle(status, reply.status());
+  if (err_status != RDC_ST_OK) return err_status;
+
+  jobs->next_cursor = reply.next_cursor();
+  jobs->num_jobs = 0;
+  for (int i = 0; i < reply.jobs_size() && i < RDC_MAX_JOB_LIST; i++) {
+    const ::rdc::JobRecord& src = reply.jobs(i);
+    rdc_job_record_t& job = jobs->jobs[jobs->num_jobs++];
+    strncpy_with_null(job.job_id, src.job_id().c_str(), sizeof(job.job_id));
+    job.num_gpus = src.num_gpus();
+    copy_gpu_usage_info(src.summary(), &job.summary);
+  }
+
+  return RDC_ST_OK;
+}
+
 rdc_status_t RdcStandaloneHandler::rdc_job_remove(const char job_id[64]) {
   ::rdc::RemoveJobRequest request;
   ::rdc::RemoveJobResponse reply;
@@ -534,6 +578,315 @@ rdc_status_t RdcStandaloneHandler::rdc_field_get_value_since(uint32_t gpu_index,
   return RDC_ST_OK;
 }
 
+rdc_status_t RdcStandaloneHandler::rdc_field_get_rollup(uint32_t gpu_index, rdc_field_t field,
+                                                        uint64_t start_ts, uint64_t end_ts,
+                                                        rdc_field_rollups_t* rollups) {
+  if (!rollups) {
+    return RDC_ST_BAD_PARAMETER;
+  }
+
+  ::rdc::GetFieldRollupRequest request;
+  ::rdc::GetFieldRollupResponse reply;
+  ::grpc::ClientContext context;
+
+  request.set_gpu_index(gpu_index);
+  request.set_field_id(field);
+  request.set_start_ts(start_ts);
+  request.set_end_ts(end_ts);
+  ::grpc::Status status = stub_->GetFieldRollup(&context, request, &reply);
+  rdc_status_t err_status = error_handle(status, reply.status());
+  if (err_status != RDC_ST_OK) return err_status;
+
+  rollups->resolution_ms = reply.resolution_ms();
+  rollups->num_buckets = 0;
+  for (int i = 0; i < reply.buckets_size() && i < RDC_MAX_ROLLUP_BUCKETS; i++) {
+    const ::rdc::FieldRollup& src = reply.buckets(i);
+    rdc_field_rollup_t& bucket = rollups->buckets[rollups->num_buckets++];
+    bucket.start_ts = src.start_ts();
+    bucket.last_ts = src.last_ts();
+    bucket.count = src.count();
+    bucket.min_value = src.min_value();
+    bucket.max_value = src.max_value();
+    bucket.sum = src.sum();
+    bucket.last_value = src.last_value();
+  }
+
+  return RDC_ST_OK;
+}
+
+rdc_status_t RdcStandaloneHandler::rdc_field_get_history(uint32_t gpu_index, rdc_field_t field,
+                                                         uint64_t since_ts, uint64_t until_ts,
+                                                         rdc_field_history_t* history) {
+  if (!history) {
+    return RDC_ST_BAD_PARAMETER;
+  }
+
+  ::rdc::GetFieldHistoryRequest request;
+  ::rdc::GetFieldHistoryResponse reply;
+  ::grpc::ClientContext context;
+
+  request.set_gpu_index(gpu_index);
+  request.set_field_id(field);
+  request.set_since_ts(since_ts);
+  request.set_until_ts(until_ts);
+  ::grpc::Status status = stub_->GetFieldHistory(&context, request, &reply);
+  rdc_status_t err_status = error_handle(status, reply.status());
+  if (err_status != RDC_ST_OK) return err_status;
+
+  history->next_since_ts = reply.next_since_ts();
+  history->num_values = 0;
+  for (int i = 0; i < reply.values_size() && i < RDC_MAX_HISTORY_VALUES; i++) {
+    const ::rdc::GetLatestFieldValueResponse& src = reply.values(i);
+    rdc_field_value& value = history->values[history->num_values++];
+    value.field_id = static_cast<rdc_field_t>(src.field_id());
+    value.status = src.rdc_status();
+    value.ts = src.ts();
+    value.type = static_cast<rdc_field_type_t>(src.type());
+    if (value.type == INTEGER) {
+      value.value.l_int = src.l_int();
+    } else if (value.type == DOUBLE) {
+      value.value.dbl = src.dbl();
+    } else if (value.type == STRING || value.type == BLOB) {
+      strncpy_with_null(value.value.str, src.str().c_str(), RDC_MAX_STR_LENGTH);
+    }
+  }
+
+  return RDC_ST_OK;
+}
+
+rdc_status_t RdcStandaloneHandler::rdc_policy_add_rule(const rdc_policy_rule_t* rule,
+                                                       uint32_t* rule_id) {
+  if (!rule || !rule_id) {
+    return RDC_ST_BAD_PARAMETER;
+  }
+
+  ::rdc::AddPolicyRuleRequest request;
+  ::rdc::AddPolicyRuleResponse reply;
+  ::grpc::ClientContext context;
+
+  request.set_gpu_index(rule->gpu_index);
+  request.set_field_id(rule->field_id);
+  request.set_condition(rule->condition);
+  request.set_threshold(rule->threshold);
+  request.set_hysteresis(rule->hysteresis);
+  request.set_duration_ms(rule->duration_ms);
+  ::grpc::Status status = stub_->AddPolicyRule(&context, request, &reply);
+  rdc_status_t err_status = error_handle(status, reply.status());
+  if (err_status != RDC_ST_OK) return err_status;
+
+  *rule_id = reply.rule_id();
+  return RDC_ST_OK;
+}
+
+rdc_status_t RdcStandaloneHandler::rdc_policy_delete_rule(uint32_t rule_id) {
+  ::rdc::DeletePolicyRuleRequest request;
+  ::rdc::DeletePolicyRuleResponse reply;
+  ::grpc::ClientContext context;
+
+  request.set_rule_id(rule_id);
+  ::grpc::Status status = stub_->DeletePolicyRule(&context, request, &reply);
+  return error_handle(status, reply.status());
+}
+
+rdc_status_t RdcStandaloneHandler::rdc_policy_get_violations(uint64_t since_seq,
+                                                             uint32_t timeout_ms,
+                                                             rdc_policy_violations_t* violations) {
+  if (!violations) {
+    return RDC_ST_BAD_PARAMETER;
+  }
+
+  ::rdc::GetPolicyViolationsRequest request;
+  ::rdc::GetPolicyViolationsResponse reply;
+  ::grpc::ClientContext context;
+
+  request.set_since_seq(since_seq);
+  request.set_timeout_ms(timeout_ms);
+  ::grpc::Status status = stub_->GetPolicyViolations(&context, request, &reply);
+  rdc_status_t err_status = error_handle(status, reply.status());
+  if (err_status != RDC_ST_OK) return err_status;
+
+  violations->num_missed = reply.num_missed();
+  violations->num_violations = 0;
+  for (int i = 0; i < reply.violations_size() && i < RDC_MAX_POLICY_VIOLATIONS; i++) {
+    const ::rdc::PolicyViolation& src = reply.violations(i);
+    rdc_policy_violation_t& violation = violations->violations[violations->num_violations++];
+    violation.seq = src.seq();
+    violation.rule_id = src.rule_id();
+    violation.gpu_index = src.gpu_index();
+    violation.field_id = static_cast<rdc_field_t>(src.field_id());
+    violation.ts = src.ts();
+    violation.value = src.value();
+    violation.cleared = src.cleared();
+  }
+
+  return RDC_ST_OK;
+}
+
+rdc_status_t RdcStandaloneHandler::rdc_anomaly_set_detector(uint32_t detector_id,
+                                                            const rdc_anomaly_config_t* config) {
+  if (!config) {
+    return RDC_ST_BAD_PARAMETER;
+  }
+
+  ::rdc::SetAnomalyDetectorRequest request;
+  ::rdc::SetAnomalyDetectorResponse reply;
+  ::grpc::ClientContext context;
+
+  request.set_detector_id(detector_id);
+  request.set_field_id(config->field_id);
+  request.set_alpha(config->alpha);
+  request.set_threshold(config->threshold);
+  request.set_warmup_samples(config->warmup_samples);
+  request.set_season_period_s(config->season_period_s);
+  ::grpc::Status status = stub_->SetAnomalyDetector(&context, request, &reply);
+  return error_handle(status, reply.status());
+}
+
+rdc_status_t RdcStandaloneHandler::rdc_anomaly_clear_detector(uint32_t detector_id) {
+  ::rdc::ClearAnomalyDetectorRequest request;
+  ::rdc::ClearAnomalyDetectorResponse reply;
+  ::grpc::ClientContext context;
+
+  request.set_detector_id(detector_id);
+  ::grpc::Status status = stub_->ClearAnomalyDetector(&context, request, &reply);
+  return error_handle(status, reply.status());
+}
+
+rdc_status_t RdcStandaloneHandler::rdc_field_derived_set(rdc_field_t field_id,
+                                                         const char* expression) {
+  if (!expression) {
+    return RDC_ST_BAD_PARAMETER;
+  }
+
+  ::rdc::SetDerivedFieldRequest request;
+  ::rdc::SetDerivedFieldResponse reply;
+  ::grpc::ClientContext context;
+
+  request.set_field_id(field_id);
+  request.set_expression(expression);
+  ::grpc::Status status = stub_->SetDerivedField(&context, request, &reply);
+  return error_handle(status, reply.status());
+}
+
+rdc_status_t RdcStandaloneHandler::rdc_field_derived_clear(rdc_field_t field_id) {
+  ::rdc::ClearDerivedFieldRequest request;
+  ::rdc::ClearDerivedFieldResponse reply;
+  ::grpc::ClientContext context;
+
+  request.set_field_id(field_id);
+  ::grpc::Status status = stub_->ClearDerivedField(&context, request, &reply);
+  return error_handle(status, reply.status());
+}
+
+// Only rdcd ingests, the downstream samples reach it by StreamFieldValues
+rdc_status_t RdcStandaloneHandler::rdc_field_ingest(uint32_t gpu_index,
+                                                    const rdc_field_value* values,
+                                                    uint32_t num_values, double max_keep_age,
+                                                    uint32_t max_keep_samples) {
+  (void)(gpu_index);
+  (void)(values);
+  (void)(num_values);
+  (void)(max_keep_age);
+  (void)(max_keep_samples);
+  return RDC_ST_NOT_SUPPORTED;
+}
+
+rdc_status_t RdcStandaloneHandler::rdc_aggregate_get_hosts(rdc_aggregate_hosts_t* hosts) {
+  if (!hosts) {
+    return RDC_ST_BAD_PARAMETER;
+  }
+
+  ::rdc::Empty request;
+  ::rdc::GetAggregateHostsResponse reply;
+  ::grpc::ClientContext context;
+
+  ::grpc::Status status = stub_->GetAggregateHosts(&context, request, &reply);
+  rdc_status_t err_status = error_handle(status, reply.status());
+  if (err_status != RDC_ST_OK) return err_status;
+
+  hosts->num_hosts = 0;
+  for (int i = 0; i < reply.hosts_size() && i < RDC_MAX_AGGREGATE_HOSTS; i++) {
+    const ::rdc::AggregateHost& src = reply.hosts(i);
+    rdc_aggregate_host_t& host = hosts->hosts[hosts->num_hosts++];
+    strncpy_with_null(host.host, src.host().c_str(), RDC_MAX_STR_LENGTH);
+    host.host_id = src.host_id();
+    host.gpu_base = src.gpu_base();
+    host.connected = src.connected();
+    host.num_gpus = src.num_gpus();
+    host.last_sample_ts = src.last_sample_ts();
+    host.num_samples = src.num_samples();
+    host.num_reconnects = src.num_reconnects();
+  }
+
+  return RDC_ST_OK;
+}
+
+rdc_status_t RdcStandaloneHandler::rdc_aggregate_get_field(rdc_field_t field,
+                                                           rdc_aggregate_op_t op,
+                                                           rdc_cluster_aggregate_t* aggregate) {
+  if (!aggregate) {
+    return RDC_ST_BAD_PARAMETER;
+  }
+
+  ::rdc::GetClusterAggregateRequest request;
+  ::rdc::GetClusterAggregateResponse reply;
+  ::grpc::ClientContext context;
+
+  request.set_field_id(field);
+  request.set_op(op);
+  ::grpc::Status status = stub_->GetClusterAggregate(&context, request, &reply);
+  rdc_status_t err_status = error_handle(status, reply.status());
+  if (err_status != RDC_ST_OK) return err_status;
+
+  aggregate->value = reply.value();
+  aggregate->num_gpus = reply.num_gpus();
+  aggregate->gpu_index = reply.gpu_index();
+  aggregate->host_id = reply.host_id();
+  aggregate->ts = reply.ts();
+  return RDC_ST_OK;
+}
+
+rdc_status_t RdcStandaloneHandler::rdc_field_get_group_aggregate(
+    rdc_gpu_group_t group_id, rdc_field_grp_t field_group_id, uint64_t window_ms,
+    const rdc_aggregate_spec_t* specs, uint32_t num_specs, rdc_group_aggregate_t* aggregate) {
+  if (!specs || !aggregate) {
+    return RDC_ST_BAD_PARAMETER;
+  }
+
+  ::rdc::GetGroupAggregateRequest request;
+  ::rdc::GetGroupAggregateResponse reply;
+  ::grpc::ClientContext context;
+
+  request.set_group_id(group_id);
+  request.set_field_group_id(field_group_id);
+  request.set_window_ms(window_ms);
+  for (uint32_t i = 0; i < num_specs; i++) {
+    ::rdc::AggregateSpec* spec = request.add_specs();
+    spec->set_op(specs[i].op);
+    spec->set_percentile(specs[i].percentile);
+  }
+  ::grpc::Status status = stub_->GetGroupAggregate(&context, request, &reply);
+  rdc_status_t err_status = error_handle(status, reply.status());
+  if (err_status != RDC_ST_OK) return err_status;
+
+  const int max_values = RDC_MAX_FIELD_IDS_PER_FIELD_GROUP * RDC_MAX_GROUP_AGGREGATE_OPS;
+  aggregate->num_values = 0;
+  for (int i = 0; i < reply.values_size() && i < max_values; i++) {
+    const ::rdc::GroupAggregateValue& src = reply.values(i);
+    rdc_group_aggregate_value_t& value = aggregate->values[aggregate->num_values++];
+    value.field_id = static_cast<rdc_field_t>(src.field_id());
+    value.spec.op = static_cast<rdc_aggregate_op_t>(src.spec().op());
+    value.spec.percentile = src.spec().percentile();
+    value.status = static_cast<rdc_status_t>(src.status());
+    value.value = src.value();
+    value.num_gpus = src.num_gpus();
+    value.num_samples = src.num_samples();
+    value.gpu_index = src.gpu_index();
+    value.ts = src.ts();
+  }
+  return RDC_ST_OK;
+}
+
 rdc_status_t RdcStandaloneHandler::rdc_field_unwatch(rdc_gpu_group_t group_id,
                                                      rdc_field_grp_t field_group_id) {
   ::rdc::UnWatchFieldsRequest request;
@@ -684,5 +1037,96 @@ rdc_status_t RdcStandaloneHandler::get_mixed_component_version(mixed_component_t
 
 }
 
+// The generations only exist in rdcd, which serves its replies from them.
+rdc_status_t RdcStandaloneHandler::get_cache_generation(uint32_t gpu_index, rdc_field_t field_id,
+                                                        uint64_t* cache_generation,
+                                                        uint64_t* group_generation) {
+  (void)(gpu_index);
+  (void)(field_id);
+  (void)(cache_generation);
+  (void)(group_generation);
+  return RDC_ST_NOT_SUPPORTED;
+}
+
+rdc_status_t RdcStandaloneHandler::rdc_perf_stats_get(rdc_perf_stats_t* stats) {
+  if (!stats) {
+    return RDC_ST_BAD_PARAMETER;
+  }
+
+  ::rdc::Empty request;
+  ::rdc::GetPerfStatsResponse reply;
+  ::grpc::ClientContext context;
+
+  ::grpc::Status status = admin_stub_->GetPerfStats(&context, request, &reply);
+  rdc_status_t err_status = error_handle(status, reply.status());
+  if (err_status != RDC_ST_OK) return err_status;
+
+  stats->num_stats = 0;
+  for (int i = 0; i < reply.stats_size() && i < RDC_MAX_NUM_PERF_STATS; i++) {
+    const ::rdc::PerfStat& src = reply.stats(i);
+    rdc_perf_stat_t& stat = stats->stats[stats->num_stats++];
+    strncpy_with_null(stat.name, src.name().c_str(), RDC_MAX_PERF_STAT_NAME);
+    stat.count = src.count();
+    stat.total_ns = src.total_ns();
+    stat.max_ns = src.max_ns();
+    stat.p50_ns = src.p50_ns();
+    stat.p90_ns = src.p90_ns();
+    stat.p99_ns = src.p99_ns();
+    stat.p999_ns = src.p999_ns();
+  }
+  return RDC_ST_OK;
+}
+
+rdc_status_t RdcStandaloneHandler::rdc_pipeline_trace_set(uint32_t enabled) {
+  ::rdc::SetPipelineTraceRequest request;
+  ::rdc::SetPipelineTraceResponse reply;
+  ::grpc::ClientContext context;
+
+  request.set_enabled(enabled != 0);
+  ::grpc::Status status = admin_stub_->SetPipelineTrace(&context, request, &reply);
+  return error_handle(status, reply.status());
+}
+
+rdc_status_t RdcStandaloneHandler::rdc_pipeline_trace_get(uint64_t start_seq,
+                                                          rdc_pipeline_events_t* events) {
+  if (!events) {
+    return RDC_ST_BAD_PARAMETER;
+  }
+
+  ::rdc::GetPipelineTraceRequest request;
+  ::rdc::GetPipelineTraceResponse reply;
+  ::grpc::ClientContext context;
+
+  request.set_start_seq(start_seq);
+  ::grpc::Status status = admin_stub_->GetPipelineTrace(&context, request, &reply);
+  rdc_status_t err_status = error_handle(status, reply.status());
+  if (err_status != RDC_ST_OK) return err_status;
+
+  events->num_events = 0;
+  for (int i = 0; i < reply.events_size() && i < RDC_MAX_NUM_PIPELINE_EVENTS; i++) {
+    const ::rdc::PipelineEvent& src = reply.events(i);
+    rdc_pipeline_event_t& event = events->events[events->num_events++];
+    strncpy_with_null(event.name, src.name().c_str(), RDC_MAX_PERF_STAT_NAME);
+    event.seq = src.seq();
+    event.ts_us = src.ts_us();
+    event.dur_us = src.dur_us();
+    event.tid = src.tid();
+    event.gpu_index = src.gpu_index();
+    event.field_id = static_cast<rdc_field_t>(src.field_id());
+  }
+  events->next_seq = reply.next_seq();
+  return RDC_ST_OK;
+}
+
+rdc_status_t RdcStandaloneHandler::rdc_log_level_set(rdc_log_level_t level) {
+  ::rdc::SetLogLevelRequest request;
+  ::rdc::SetLogLevelResponse reply;
+  ::grpc::ClientContext context;
+
+  request.set_level(level);
+  ::grpc::Status status = admin_stub_->SetLogLevel(&context, request, &reply);
+  return error_handle(status, reply.status());
+}
+
 }  // namespace rdc
 }  // namespace amd
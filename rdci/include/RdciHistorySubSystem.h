@@ -0,0 +1,54 @@
+/*
+Copyright (c) 2024 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#ifndef RDCI_INCLUDE_RDCIHISTORYSUBSYSTEM_H_
+#define RDCI_INCLUDE_RDCIHISTORYSUBSYSTEM_H_
+
+#include <string>
+#include <vector>
+
+#include "RdciSubSystem.h"
+
+namespace amd {
+namespace rdc {
+
+class RdciHistorySubSystem : public RdciSubSystem {
+ public:
+  RdciHistorySubSystem();
+  void parse_cmd_opts(int argc, char** argv) override;
+  void process() override;
+
+ private:
+  bool show_help_;
+  uint64_t since_ts_;  //!< In milliseconds
+  uint64_t until_ts_;  //!< In milliseconds
+  std::vector<uint32_t> gpu_indexes_;
+  std::vector<rdc_field_t> field_ids_;
+  void show_help() const;
+
+  //!< Parse either epoch seconds or a time relative to now such as -10m
+  uint64_t parse_time(const std::string& value, uint64_t now) const;
+};
+
+}  // namespace rdc
+}  // namespace amd
+
+#endif  // RDCI_INCLUDE_RDCIHISTORYSUBSYSTEM_H_
@@ -0,0 +1,58 @@
+/*
+Copyright (c) 2024 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#ifndef RDCI_INCLUDE_RDCIPERFSUBSYSTEM_H_
+#define RDCI_INCLUDE_RDCIPERFSUBSYSTEM_H_
+
+#include <string>
+
+#include "RdciSubSystem.h"
+
+namespace amd {
+namespace rdc {
+
+class RdciPerfSubSystem : public RdciSubSystem {
+ public:
+  RdciPerfSubSystem();
+  void parse_cmd_opts(int argc, char** argv) override;
+  void process() override;
+
+ private:
+  enum OPERATIONS {
+    PERF_STATS = 0,
+    PERF_TRACE_START,
+    PERF_TRACE_STOP,
+    PERF_TRACE_DUMP,
+    PERF_LOG_LEVEL,
+  } perf_ops_;
+
+  bool show_help_;
+  std::string trace_file_;
+  rdc_log_level_t log_level_;
+  void show_help() const;
+  void show_perf_stats();
+  void dump_pipeline_trace();
+};
+
+}  // namespace rdc
+}  // namespace amd
+
+#endif  // RDCI_INCLUDE_RDCIPERFSUBSYSTEM_H_
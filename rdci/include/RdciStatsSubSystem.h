@@ -41,6 +41,10 @@ class RdciStatsSubSystem : public RdciSubSystem {
   void show_help() const;
   void show_job_stats(const rdc_gpu_usage_info_t& gpu_info) const;
   void show_job_stats_json(const rdc_gpu_usage_info_t& gpu_info) const;
+  void show_percentiles(const rdc_stats_summary_t& stats) const;
+  void show_percentiles_json(const std::string& name, const rdc_stats_summary_t& stats) const;
+  void export_timelines() const;
+  void list_jobs() const;
 
   enum OPERATIONS {
     STATS_UNKNOWN = 0,
@@ -48,11 +52,15 @@ class RdciStatsSubSystem : public RdciSubSystem {
     STATS_START_RECORDING,
     STATS_STOP_RECORDING,
     STATS_DISPLAY,
+    STATS_TIMELINE,
+    STATS_LIST,
     STATS_REMOVE,
     STATS_REMOVE_ALL
   } stats_ops_;
 
   std::string job_id_;
+  std::string timeline_file_;
+  rdc_job_filter_t job_filter_ = {};  //!< For STATS_LIST
   uint32_t group_id_;
   bool is_verbose_ = false;
 };
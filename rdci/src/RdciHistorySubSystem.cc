@@ -0,0 +1,257 @@
+/*
+Copyright (c) 2024 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "RdciHistorySubSystem.h"
+
+#include <getopt.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <iomanip>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/rdc_fields_supported.h"
+#include "common/rdc_utils.h"
+#include "rdc/rdc.h"
+#include "rdc_lib/RdcException.h"
+#include "rdc_lib/rdc_common.h"
+
+namespace amd {
+namespace rdc {
+
+RdciHistorySubSystem::RdciHistorySubSystem() : show_help_(false), since_ts_(0), until_ts_(0) {}
+
+uint64_t RdciHistorySubSystem::parse_time(const std::string& value, uint64_t now) const {
+  if (value.empty()) {
+    throw RdcException(RDC_ST_BAD_PARAMETER, "The time cannot be empty");
+  }
+
+  if (value[0] != '-') {
+    if (!IsNumber(value)) {
+      throw RdcException(RDC_ST_BAD_PARAMETER, "The time " + value + " is not valid");
+    }
+    return std::stoull(value) * 1000;
+  }
+
+  std::string amount = value.substr(1);
+  uint64_t unit_ms = 1000;
+  if (!amount.empty()) {
+    switch (amount.back()) {
+      case 's':
+        amount.pop_back();
+        break;
+      case 'm':
+        unit_ms = 60 * 1000;
+        amount.pop_back();
+        break;
+      case 'h':
+        unit_ms = 3600 * 1000;
+        amount.pop_back();
+        break;
+      default:
+        break;
+    }
+  }
+  if (amount.empty() || !IsNumber(amount)) {
+    throw RdcException(RDC_ST_BAD_PARAMETER, "The time " + value + " is not valid");
+  }
+
+  uint64_t offset = std::stoull(amount) * unit_ms;
+  return offset > now ? 0 : now - offset;
+}
+
+void RdciHistorySubSystem::parse_cmd_opts(int argc, char** argv) {
+  const int HOST_OPTIONS = 1000;
+  const int JSON_OPTIONS = 1001;
+  const int SINCE_OPTIONS = 1002;
+  const int UNTIL_OPTIONS = 1003;
+  const struct option long_options[] = {{"host", required_argument, nullptr, HOST_OPTIONS},
+                                        {"help", optional_argument, nullptr, 'h'},
+                                        {"unauth", optional_argument, nullptr, 'u'},
+                                        {"json", optional_argument, nullptr, JSON_OPTIONS},
+                                        {"since", required_argument, nullptr, SINCE_OPTIONS},
+                                        {"until", required_argument, nullptr, UNTIL_OPTIONS},
+                                        {"gpu", required_argument, nullptr, 'i'},
+                                        {"field", required_argument, nullptr, 'e'},
+                                        {nullptr, 0, nullptr, 0}};
+
+  int option_index = 0;
+  int opt = 0;
+  std::string since = "-1h";
+  std::string until;
+  std::string gpu_indexes;
+  std::string field_ids;
+
+  while ((opt = getopt_long(argc, argv, "hui:e:", long_options, &option_index)) != -1) {
+    switch (opt) {
+      case HOST_OPTIONS:
+        ip_port_ = optarg;
+        break;
+      case JSON_OPTIONS:
+        set_json_output(true);
+        break;
+      case SINCE_OPTIONS:
+        since = optarg;
+        break;
+      case UNTIL_OPTIONS:
+        until = optarg;
+        break;
+      case 'i':
+        gpu_indexes = optarg;
+        break;
+      case 'e':
+        field_ids = optarg;
+        break;
+      case 'h':
+        show_help_ = true;
+        return;
+      case 'u':
+        use_auth_ = false;
+        break;
+      default:
+        show_help();
+        throw RdcException(RDC_ST_BAD_PARAMETER, "Unknown command line options");
+    }
+  }
+
+  if (gpu_indexes == "" || field_ids == "") {
+    show_help();
+    throw RdcException(RDC_ST_BAD_PARAMETER, "Need to specify the GPUs and the fields");
+  }
+
+  std::vector<std::string> vec_ids = split_string(field_ids, ',');
+  for (uint32_t i = 0; i < vec_ids.size(); i++) {
+    if (!IsNumber(vec_ids[i])) {
+      rdc_field_t field_id = RDC_FI_INVALID;
+      if (!amd::rdc::get_field_id_from_name(vec_ids[i], &field_id)) {
+        throw RdcException(RDC_ST_BAD_PARAMETER, "The field name " + vec_ids[i] + " is not valid");
+      }
+      field_ids_.push_back(field_id);
+    } else {
+      field_ids_.push_back(static_cast<rdc_field_t>(std::stoi(vec_ids[i])));
+    }
+  }
+
+  vec_ids = split_string(gpu_indexes, ',');
+  for (uint32_t i = 0; i < vec_ids.size(); i++) {
+    if (!IsNumber(vec_ids[i])) {
+      throw RdcException(RDC_ST_BAD_PARAMETER,
+                         "The GPU index " + vec_ids[i] + " needs to be a number");
+    }
+    gpu_indexes_.push_back(std::stoi(vec_ids[i]));
+  }
+
+  struct timeval tv;
+  gettimeofday(&tv, nullptr);
+  uint64_t now = static_cast<uint64_t>(tv.tv_sec) * 1000 + tv.tv_usec / 1000;
+  since_ts_ = parse_time(since, now);
+  until_ts_ = until == "" ? now : parse_time(until, now);
+  if (since_ts_ > until_ts_) {
+    throw RdcException(RDC_ST_BAD_PARAMETER, "The --since time is after the --until time");
+  }
+}
+
+void RdciHistorySubSystem::show_help() const {
+  if (is_json_output()) return;
+  std::cout << " history -- Used to read the samples rdcd wrote to its on-disk history\n"
+            << "            log, which outlives the in-memory cache.\n\n";
+  std::cout << "Usage\n";
+  std::cout << "    rdci history [--host <IP/FQDN>:port] [--json] [-u] -i <gpuIndex>\n"
+            << "                 -e <fieldIds> [--since <time>] [--until <time>]\n";
+  std::cout << "\nFlags:\n";
+  show_common_usage();
+  std::cout << "  --json                         "
+            << "Output using json.\n";
+  std::cout << "  -i  --gpu   gpuIndex           "
+            << "The comma separated GPU indexes to read.\n";
+  std::cout << "  -e  --field fieldIds           "
+            << "The comma separated field ids or names to read.\n";
+  std::cout << "  --since     time               "
+            << "Epoch seconds, or relative to now such as -30s,\n"
+            << "                                 -10m or -2h. Defaults to -1h.\n";
+  std::cout << "  --until     time               "
+            << "Same format as --since. Defaults to now.\n";
+}
+
+void RdciHistorySubSystem::process() {
+  if (show_help_) {
+    return show_help();
+  }
+
+  std::unique_ptr<rdc_field_history_t> history(new rdc_field_history_t);
+  bool first = true;
+  if (is_json_output()) {
+    std::cout << "\"history\" : [";
+  } else {
+    std::cout << std::left << std::setw(16) << "TIMESTAMP(ms)" << std::setw(6) << "GPU"
+              << std::setw(40) << "FIELD"
+              << "VALUE" << std::endl;
+  }
+
+  for (auto gpu_index : gpu_indexes_) {
+    for (auto field_id : field_ids_) {
+      uint64_t since_ts = since_ts_;
+      do {
+        rdc_status_t result =
+            rdc_field_get_history(rdc_handle_, gpu_index, field_id, since_ts, until_ts_,
+                                  history.get());
+        if (result != RDC_ST_OK) {
+          throw RdcException(result, "Fail to read the history of " +
+                                         std::string(field_id_string(field_id)) + " on GPU " +
+                                         std::to_string(gpu_index));
+        }
+
+        for (uint32_t i = 0; i < history->num_values; i++) {
+          const rdc_field_value& v = history->values[i];
+          std::string value;
+          if (v.type == INTEGER) {
+            value = std::to_string(v.value.l_int);
+          } else if (v.type == DOUBLE) {
+            value = std::to_string(v.value.dbl);
+          } else {
+            value = v.value.str;
+          }
+
+          if (is_json_output()) {
+            if (!first) std::cout << ",";
+            std::cout << "{\"ts\": " << v.ts << ", \"gpu_index\": " << gpu_index
+                      << ", \"field\": \"" << field_id_string(field_id) << "\", \"value\": \""
+                      << value << "\"}";
+          } else {
+            std::cout << std::left << std::setw(16) << v.ts << std::setw(6) << gpu_index
+                      << std::setw(40) << field_id_string(field_id) << value << std::endl;
+          }
+          first = false;
+        }
+        since_ts = history->next_since_ts;
+      } while (since_ts != 0 && history->num_values > 0);
+    }
+  }
+
+  if (is_json_output()) {
+    std::cout << "], \"status\": \"ok\"";
+  }
+}
+
+}  // namespace rdc
+}  // namespace amd
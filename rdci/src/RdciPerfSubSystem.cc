@@ -0,0 +1,240 @@
+/*
+Copyright (c) 2024 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "RdciPerfSubSystem.h"
+
+#include <getopt.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <vector>
+
+#include "rdc/rdc.h"
+#include "rdc_lib/RdcException.h"
+#include "rdc_lib/RdcPipelineTrace.h"
+#include "rdc_lib/rdc_common.h"
+
+namespace amd {
+namespace rdc {
+
+RdciPerfSubSystem::RdciPerfSubSystem()
+    : perf_ops_(PERF_STATS), show_help_(false), log_level_(RDC_LOG_LEVEL_ERROR) {}
+
+void RdciPerfSubSystem::parse_cmd_opts(int argc, char** argv) {
+  const int HOST_OPTIONS = 1000;
+  const int JSON_OPTIONS = 1001;
+  const int TRACE_START = 1002;
+  const int TRACE_STOP = 1003;
+  const int TRACE_DUMP = 1004;
+  const int LOG_LEVEL = 1005;
+  const struct option long_options[] = {{"host", required_argument, nullptr, HOST_OPTIONS},
+                                        {"help", optional_argument, nullptr, 'h'},
+                                        {"unauth", optional_argument, nullptr, 'u'},
+                                        {"json", optional_argument, nullptr, JSON_OPTIONS},
+                                        {"trace-start", no_argument, nullptr, TRACE_START},
+                                        {"trace-stop", no_argument, nullptr, TRACE_STOP},
+                                        {"trace-dump", required_argument, nullptr, TRACE_DUMP},
+                                        {"log-level", required_argument, nullptr, LOG_LEVEL},
+                                        {nullptr, 0, nullptr, 0}};
+
+  int option_index = 0;
+  int opt = 0;
+
+  while ((opt = getopt_long(argc, argv, "hu", long_options, &option_index)) != -1) {
+    switch (opt) {
+      case HOST_OPTIONS:
+        ip_port_ = optarg;
+        break;
+      case JSON_OPTIONS:
+        set_json_output(true);
+        break;
+      case TRACE_START:
+        perf_ops_ = PERF_TRACE_START;
+        break;
+      case TRACE_STOP:
+        perf_ops_ = PERF_TRACE_STOP;
+        break;
+      case TRACE_DUMP:
+        perf_ops_ = PERF_TRACE_DUMP;
+        trace_file_ = optarg;
+        break;
+      case LOG_LEVEL:
+        perf_ops_ = PERF_LOG_LEVEL;
+        if (strcmp(optarg, "ERROR") == 0) {
+          log_level_ = RDC_LOG_LEVEL_ERROR;
+        } else if (strcmp(optarg, "INFO") == 0) {
+          log_level_ = RDC_LOG_LEVEL_INFO;
+        } else if (strcmp(optarg, "DEBUG") == 0) {
+          log_level_ = RDC_LOG_LEVEL_DEBUG;
+        } else {
+          show_help();
+          throw RdcException(RDC_ST_BAD_PARAMETER, "The log level must be ERROR, INFO or DEBUG");
+        }
+        break;
+      case 'h':
+        show_help_ = true;
+        return;
+      case 'u':
+        use_auth_ = false;
+        break;
+      default:
+        show_help();
+        throw RdcException(RDC_ST_BAD_PARAMETER, "Unknown command line options");
+    }
+  }
+}
+
+void RdciPerfSubSystem::show_help() const {
+  if (is_json_output()) return;
+  std::cout << " perf -- Used to show the latency percentiles of the field fetches,\n"
+            << "         cache operations and gRPC handlers inside rdcd.\n\n";
+  std::cout << "Usage\n";
+  std::cout << "    rdci perf [--host <IP/FQDN>:port] [--json] [-u]\n";
+  std::cout << "    rdci perf [--host <IP/FQDN>:port] [-u] --trace-start\n";
+  std::cout << "    rdci perf [--host <IP/FQDN>:port] [-u] --trace-stop\n";
+  std::cout << "    rdci perf [--host <IP/FQDN>:port] [-u] --trace-dump <file>\n";
+  std::cout << "    rdci perf [--host <IP/FQDN>:port] [-u] --log-level <ERROR|INFO|DEBUG>\n";
+  std::cout << "\nFlags:\n";
+  show_common_usage();
+  std::cout << "  --json                         "
+            << "Output using json.\n";
+  std::cout << "  --trace-start                  "
+            << "Start tracing the collection pipeline.\n";
+  std::cout << "  --trace-stop                   "
+            << "Stop tracing the collection pipeline.\n";
+  std::cout << "  --trace-dump <file>            "
+            << "Write the pipeline trace as Chrome trace-event\n"
+            << "                                 JSON, to be loaded in Perfetto.\n";
+  std::cout << "  --log-level <level>            "
+            << "Change the log level of rdcd to ERROR, INFO or DEBUG.\n";
+}
+
+void RdciPerfSubSystem::show_perf_stats() {
+  std::unique_ptr<rdc_perf_stats_t> stats(new rdc_perf_stats_t);
+  rdc_status_t result = rdc_perf_stats_get(rdc_handle_, stats.get());
+  if (result != RDC_ST_OK) {
+    throw RdcException(result, "Fail to get the perf stats");
+  }
+
+  // The code paths which used the most time first
+  std::vector<const rdc_perf_stat_t*> sorted;
+  for (uint32_t i = 0; i < stats->num_stats; i++) {
+    sorted.push_back(&stats->stats[i]);
+  }
+  std::sort(sorted.begin(), sorted.end(), [](const rdc_perf_stat_t* a, const rdc_perf_stat_t* b) {
+    return a->total_ns > b->total_ns;
+  });
+
+  if (is_json_output()) {
+    std::cout << "\"perf\" : [";
+    for (size_t i = 0; i < sorted.size(); i++) {
+      const rdc_perf_stat_t& s = *sorted[i];
+      std::cout << "{\"name\": \"" << s.name << "\", \"count\": " << s.count
+                << ", \"total_ns\": " << s.total_ns << ", \"p50_ns\": " << s.p50_ns
+                << ", \"p90_ns\": " << s.p90_ns << ", \"p99_ns\": " << s.p99_ns
+                << ", \"p999_ns\": " << s.p999_ns << ", \"max_ns\": " << s.max_ns << "}";
+      if (i != sorted.size() - 1) {
+        std::cout << ",";
+      }
+    }
+    std::cout << "], \"status\": \"ok\"";
+    return;
+  }
+
+  std::cout << std::left << std::setw(40) << "NAME" << std::right << std::setw(12) << "COUNT"
+            << std::setw(12) << "TOTAL(ms)" << std::setw(10) << "P50(us)" << std::setw(10)
+            << "P90(us)" << std::setw(10) << "P99(us)" << std::setw(10) << "P99.9(us)"
+            << std::setw(10) << "MAX(us)" << std::endl;
+  std::cout << std::fixed << std::setprecision(1);
+  for (auto stat : sorted) {
+    const rdc_perf_stat_t& s = *stat;
+    std::cout << std::left << std::setw(40) << s.name << std::right << std::setw(12) << s.count
+              << std::setw(12) << s.total_ns / 1e6 << std::setw(10) << s.p50_ns / 1e3
+              << std::setw(10) << s.p90_ns / 1e3 << std::setw(10) << s.p99_ns / 1e3
+              << std::setw(10) << s.p999_ns / 1e3 << std::setw(10) << s.max_ns / 1e3
+              << std::endl;
+  }
+}
+
+void RdciPerfSubSystem::dump_pipeline_trace() {
+  std::vector<rdc_pipeline_event_t> events;
+  std::unique_ptr<rdc_pipeline_events_t> batch(new rdc_pipeline_events_t);
+  uint64_t seq = 0;
+  do {
+    rdc_status_t result = rdc_pipeline_trace_get(rdc_handle_, seq, batch.get());
+    if (result != RDC_ST_OK) {
+      throw RdcException(result, "Fail to get the pipeline trace");
+    }
+    events.insert(events.end(), batch->events, batch->events + batch->num_events);
+    seq = batch->next_seq;
+  } while (batch->num_events > 0);
+
+  std::ofstream file(trace_file_);
+  if (!file) {
+    throw RdcException(RDC_ST_FILE_ERROR, "Fail to open " + trace_file_);
+  }
+  RdcPipelineTrace::write_chrome_json(events, file);
+  std::cout << "Wrote " << events.size() << " events to " << trace_file_ << std::endl;
+}
+
+void RdciPerfSubSystem::process() {
+  if (show_help_) {
+    return show_help();
+  }
+
+  rdc_status_t result = RDC_ST_OK;
+  switch (perf_ops_) {
+    case PERF_TRACE_START:
+      result = rdc_pipeline_trace_set(rdc_handle_, 1);
+      if (result != RDC_ST_OK) {
+        throw RdcException(result, "Fail to start the pipeline trace");
+      }
+      std::cout << "Pipeline trace started." << std::endl;
+      break;
+    case PERF_TRACE_STOP:
+      result = rdc_pipeline_trace_set(rdc_handle_, 0);
+      if (result != RDC_ST_OK) {
+        throw RdcException(result, "Fail to stop the pipeline trace");
+      }
+      std::cout << "Pipeline trace stopped." << std::endl;
+      break;
+    case PERF_TRACE_DUMP:
+      dump_pipeline_trace();
+      break;
+    case PERF_LOG_LEVEL:
+      result = rdc_log_level_set(rdc_handle_, log_level_);
+      if (result != RDC_ST_OK) {
+        throw RdcException(result, "Fail to set the log level");
+      }
+      std::cout << "Log level changed." << std::endl;
+      break;
+    default:
+      show_perf_stats();
+      break;
+  }
+}
+
+}  // namespace rdc
+}  // namespace amd
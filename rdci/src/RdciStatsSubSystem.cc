@@ -26,8 +26,10 @@ THE SOFTWARE.
 #include <unistd.h>
 
 #include <ctime>
+#include <fstream>
 #include <iomanip>
 #include <limits>
+#include <memory>
 
 #include "common/rdc_utils.h"
 #include "rdc/rdc.h"
@@ -44,6 +46,10 @@ RdciStatsSubSystem::~RdciStatsSubSystem() {}
 void RdciStatsSubSystem::parse_cmd_opts(int argc, char** argv) {
   const int HOST_OPTIONS = 1000;
   const int JSON_OPTIONS = 1001;
+  const int TIMELINE_OPTIONS = 1002;
+  const int SINCE_OPTIONS = 1003;
+  const int UNTIL_OPTIONS = 1004;
+  const int FILTER_OPTIONS = 1005;
   const struct option long_options[] = {{"host", required_argument, nullptr, HOST_OPTIONS},
                                         {"help", optional_argument, nullptr, 'h'},
                                         {"unauth", optional_argument, nullptr, 'u'},
@@ -55,13 +61,18 @@ void RdciStatsSubSystem::parse_cmd_opts(int argc, char** argv) {
                                         {"verbose", optional_argument, nullptr, 'v'},
                                         {"group", required_argument, nullptr, 'g'},
                                         {"json", optional_argument, nullptr, JSON_OPTIONS},
+                                        {"timeline", required_argument, nullptr, TIMELINE_OPTIONS},
+                                        {"list", optional_argument, nullptr, 'l'},
+                                        {"since", required_argument, nullptr, SINCE_OPTIONS},
+                                        {"until", required_argument, nullptr, UNTIL_OPTIONS},
+                                        {"filter", required_argument, nullptr, FILTER_OPTIONS},
                                         {nullptr, 0, nullptr, 0}};
 
   bool is_group_id_set = false;
   int option_index = 0;
   int opt = 0;
 
-  while ((opt = getopt_long(argc, argv, "huvas:x:j:r:g:", long_options, &option_index)) != -1) {
+  while ((opt = getopt_long(argc, argv, "huvlas:x:j:r:g:", long_options, &option_index)) != -1) {
     switch (opt) {
       case HOST_OPTIONS:
         ip_port_ = optarg;
@@ -69,6 +80,38 @@ void RdciStatsSubSystem::parse_cmd_opts(int argc, char** argv) {
       case JSON_OPTIONS:
         set_json_output(true);
         break;
+      case TIMELINE_OPTIONS:
+        timeline_file_ = optarg;
+        break;
+      case SINCE_OPTIONS:
+      case UNTIL_OPTIONS:
+        if (!IsNumber(optarg)) {
+          show_help();
+          throw RdcException(RDC_ST_BAD_PARAMETER, "The time needs to be in seconds since 1970");
+        }
+        if (opt == SINCE_OPTIONS) {
+          job_filter_.start_since = std::stoull(optarg);
+        } else {
+          job_filter_.start_until = std::stoull(optarg);
+        }
+        break;
+      case FILTER_OPTIONS: {
+        // <fieldId>:<min>[:<max>]
+        std::vector<std::string> parts = split_string(optarg, ':');
+        if (parts.size() < 2 || parts.size() > 3 || !IsNumber(parts[0]) || !IsNumber(parts[1]) ||
+            (parts.size() == 3 && !IsNumber(parts[2]))) {
+          show_help();
+          throw RdcException(RDC_ST_BAD_PARAMETER,
+                             "The filter needs to be <fieldId>:<min>[:<max>]");
+        }
+        job_filter_.field_id = static_cast<rdc_field_t>(std::stoul(parts[0]));
+        job_filter_.min_average = std::stoull(parts[1]);
+        job_filter_.max_average = parts.size() == 3 ? std::stoull(parts[2]) : 0;
+        break;
+      }
+      case 'l':
+        stats_ops_ = STATS_LIST;
+        break;
       case 'h':
         stats_ops_ = STATS_HELP;
         return;
@@ -111,6 +154,14 @@ void RdciStatsSubSystem::parse_cmd_opts(int argc, char** argv) {
     }
   }
 
+  if (timeline_file_ != "") {
+    if (stats_ops_ != STATS_DISPLAY) {
+      show_help();
+      throw RdcException(RDC_ST_BAD_PARAMETER, "The --timeline option needs a job id with -j");
+    }
+    stats_ops_ = STATS_TIMELINE;
+  }
+
   if (stats_ops_ == STATS_START_RECORDING && is_group_id_set == false) {
     show_help();
     throw RdcException(RDC_ST_BAD_PARAMETER, "Need to specify the group id to start recording");
@@ -127,6 +178,10 @@ void RdciStatsSubSystem::show_help() const {
             << "-x <jobId>\n";
   std::cout << "    rdci stats [--host <IP/FQDN>:port] [-u] [--json] [-v] "
             << "-j <jobId>\n";
+  std::cout << "    rdci stats [--host <IP/FQDN>:port] [-u] -j <jobId> "
+            << "--timeline <file.csv>\n";
+  std::cout << "    rdci stats [--host <IP/FQDN>:port] [-u] [--json] -l "
+            << "[--since <seconds>] [--until <seconds>] [--filter <fieldId>:<min>[:<max>]]\n";
   std::cout << "    rdci stats [--host <IP/FQDN>:port] [-u] [--json] "
             << "-r <jobId>\n";
   std::cout << "    rdci stats [--host <IP/FQDN>:port] [-u] [--json] -a\n";
@@ -144,6 +199,17 @@ void RdciStatsSubSystem::show_help() const {
             << "job statistics.\n";
   std::cout << "  -v  --verbose                  Show job information "
             << "for each GPU.\n";
+  std::cout << "  --timeline <file.csv>          Write the downsampled "
+            << "timelines of the job\n"
+            << "                                 fields on each GPU to a CSV file.\n";
+  std::cout << "  -l  --list                     List the stopped jobs "
+            << "kept in the job store.\n";
+  std::cout << "  --since, --until               Only the jobs started "
+            << "in this range, in seconds since 1970.\n";
+  std::cout << "  --filter <fieldId>:<min>[:<max>] Only the jobs whose "
+            << "average of the field is in range,\n"
+            << "                                 such as 300:250 for a "
+            << "power of 250 Watts or more.\n";
   std::cout << "  -r  --jremove                  Remove "
             << "job statistics.\n";
   std::cout << "  -a  --jremoveall               Remove "
@@ -161,23 +227,27 @@ void RdciStatsSubSystem::show_job_stats_json(const rdc_gpu_usage_info_t& gpu_inf
   std::cout << "\"power_usage_avg\": " << gpu_info.power_usage.average << ",";
   std::cout << "\"power_usage_stanard_deviation\": " << gpu_info.power_usage.standard_deviation
             << ",";
+  show_percentiles_json("power_usage", gpu_info.power_usage);
 
   std::cout << "\"gpu_clock_max\": " << gpu_info.gpu_clock.max_value << ",";
   std::cout << "\"gpu_clock_min\": " << gpu_info.gpu_clock.min_value << ",";
   std::cout << "\"gpu_clock_avg\": " << gpu_info.gpu_clock.average << ",";
   std::cout << "\"gpu_clock_stanard_deviation\": " << gpu_info.gpu_clock.standard_deviation << ",";
+  show_percentiles_json("gpu_clock", gpu_info.gpu_clock);
 
   std::cout << "\"memory_clock_max\": " << gpu_info.memory_clock.max_value << ",";
   std::cout << "\"memory_clock_min\": " << gpu_info.memory_clock.min_value << ",";
   std::cout << "\"memory_clock_avg\": " << gpu_info.memory_clock.average << ",";
   std::cout << "\"memory_clock_stanard_deviation\": " << gpu_info.memory_clock.standard_deviation
             << ",";
+  show_percentiles_json("memory_clock", gpu_info.memory_clock);
 
   std::cout << "\"gpu_utilization_max\": " << gpu_info.gpu_utilization.max_value << ",";
   std::cout << "\"gpu_utilization_min\": " << gpu_info.gpu_utilization.min_value << ",";
   std::cout << "\"gpu_utilization_avg\": " << gpu_info.gpu_utilization.average << ",";
   std::cout << "\"gpu_utilization_deviation\": " << gpu_info.gpu_utilization.standard_deviation
             << ",";
+  show_percentiles_json("gpu_utilization", gpu_info.gpu_utilization);
 
   std::cout << "\"max_gpu_memory_used\": " << gpu_info.max_gpu_memory_used << ",";
 
@@ -186,27 +256,45 @@ void RdciStatsSubSystem::show_job_stats_json(const rdc_gpu_usage_info_t& gpu_inf
   std::cout << "\"memory_utilization_avg\": " << gpu_info.memory_utilization.average << ",";
   std::cout << "\"memory_utilization_stanard_deviation\": "
             << gpu_info.memory_utilization.standard_deviation << ",";
+  show_percentiles_json("memory_utilization", gpu_info.memory_utilization);
 
   std::cout << "\"gpu_temperature_max\": " << gpu_info.gpu_temperature.max_value << ",";
   std::cout << "\"gpu_temperature_min\": " << gpu_info.gpu_temperature.min_value << ",";
   std::cout << "\"gpu_temperature_avg\": " << gpu_info.gpu_temperature.average << ",";
   std::cout << "\"gpu_temperature_stanard_deviation\": "
             << gpu_info.gpu_temperature.standard_deviation << ",";
+  show_percentiles_json("gpu_temperature", gpu_info.gpu_temperature);
 
   std::cout << "\"pcie_rx_max\": " << gpu_info.pcie_rx.max_value << ",";
   std::cout << "\"pcie_rx_min\": " << gpu_info.pcie_rx.min_value << ",";
   std::cout << "\"pcie_rx_avg\": " << gpu_info.pcie_rx.average << ",";
   std::cout << "\"pcie_rx_stanard_deviation\": " << gpu_info.pcie_rx.standard_deviation << ",";
+  show_percentiles_json("pcie_rx", gpu_info.pcie_rx);
 
   std::cout << "\"pcie_tx_max\": " << gpu_info.pcie_tx.max_value << ",";
   std::cout << "\"pcie_tx_min\": " << gpu_info.pcie_tx.min_value << ",";
   std::cout << "\"pcie_tx_avg\": " << gpu_info.pcie_tx.average << ",";
   std::cout << "\"pcie_tx_stanard_deviation\": " << gpu_info.pcie_tx.standard_deviation << ",";
+  show_percentiles_json("pcie_tx", gpu_info.pcie_tx);
 
   std::cout << "\"ecc_correct\": " << gpu_info.ecc_correct << ",";
   std::cout << "\"ecc_uncorrect\": " << gpu_info.ecc_uncorrect;
 }
 
+void RdciStatsSubSystem::show_percentiles_json(const std::string& name,
+                                               const rdc_stats_summary_t& stats) const {
+  std::cout << "\"" << name << "_p50\": " << stats.p50 << ",";
+  std::cout << "\"" << name << "_p90\": " << stats.p90 << ",";
+  std::cout << "\"" << name << "_p95\": " << stats.p95 << ",";
+  std::cout << "\"" << name << "_p99\": " << stats.p99 << ",";
+}
+
+void RdciStatsSubSystem::show_percentiles(const rdc_stats_summary_t& stats) const {
+  std::cout << "|                                  | "
+            << "P50: " << stats.p50 << " P90: " << stats.p90 << " P95: " << stats.p95
+            << " P99: " << stats.p99 << "\n";
+}
+
 void RdciStatsSubSystem::show_job_stats(const rdc_gpu_usage_info_t& gpu_info) const {
   std::cout << "|------- Execution Stats ----------"
             << "+------------------------------------\n";
@@ -228,45 +316,133 @@ void RdciStatsSubSystem::show_job_stats(const rdc_gpu_usage_info_t& gpu_info) co
             << " Min: " << gpu_info.power_usage.min_value
             << " Avg: " << gpu_info.power_usage.average << " SD: " << std::fixed
             << std::setprecision(2) << gpu_info.power_usage.standard_deviation << "\n";
+  show_percentiles(gpu_info.power_usage);
   std::cout << "| GPU Clock (MHz)                  | "
             << "Max: " << gpu_info.gpu_clock.max_value << " Min: " << gpu_info.gpu_clock.min_value
             << " Avg: " << gpu_info.gpu_clock.average << " SD: " << std::fixed
             << std::setprecision(2) << gpu_info.gpu_clock.standard_deviation << "\n";
+  show_percentiles(gpu_info.gpu_clock);
   std::cout << "| Memory Clock (MHz)               | "
             << "Max: " << gpu_info.memory_clock.max_value
             << " Min: " << gpu_info.memory_clock.min_value
             << " Avg: " << gpu_info.memory_clock.average << " SD: " << std::fixed
             << std::setprecision(2) << gpu_info.memory_clock.standard_deviation << "\n";
+  show_percentiles(gpu_info.memory_clock);
   std::cout << "| GPU Utilization (%)              | "
             << "Max: " << gpu_info.gpu_utilization.max_value
             << " Min: " << gpu_info.gpu_utilization.min_value
             << " Avg: " << gpu_info.gpu_utilization.average << " SD: " << std::fixed
             << std::setprecision(2) << gpu_info.gpu_utilization.standard_deviation << "\n";
+  show_percentiles(gpu_info.gpu_utilization);
   std::cout << "| Max GPU Memory Used (bytes)      | " << gpu_info.max_gpu_memory_used << "\n";
   std::cout << "| Memory Utilization (%)           | "
             << "Max: " << gpu_info.memory_utilization.max_value
             << " Min: " << gpu_info.memory_utilization.min_value
             << " Avg: " << gpu_info.memory_utilization.average << " SD: " << std::fixed
             << std::setprecision(2) << gpu_info.memory_utilization.standard_deviation << "\n";
+  show_percentiles(gpu_info.memory_utilization);
   std::cout << "| GPU Temperature (Celsius)        | "
             << "Max: " << gpu_info.gpu_temperature.max_value
             << " Min: " << gpu_info.gpu_temperature.min_value
             << " Avg: " << gpu_info.gpu_temperature.average << " SD: " << std::fixed
             << std::setprecision(2) << gpu_info.gpu_temperature.standard_deviation << "\n";
+  show_percentiles(gpu_info.gpu_temperature);
   std::cout << "| PCIe Rx Bandwidth (megabytes)    | "
             << "Max: " << gpu_info.pcie_rx.max_value << " Min: " << gpu_info.pcie_rx.min_value
             << " Avg: " << gpu_info.pcie_rx.average << " SD: " << std::fixed << std::setprecision(2)
             << gpu_info.pcie_rx.standard_deviation << "\n";
+  show_percentiles(gpu_info.pcie_rx);
   std::cout << "| PCIe Tx Bandwidth (megabytes)    | "
             << "Max: " << gpu_info.pcie_tx.max_value << " Min: " << gpu_info.pcie_tx.min_value
             << " Avg: " << gpu_info.pcie_tx.average << " SD: " << std::fixed << std::setprecision(2)
             << gpu_info.pcie_tx.standard_deviation << "\n";
+  show_percentiles(gpu_info.pcie_tx);
   std::cout << "| Correctable ECC Errors           | " << gpu_info.ecc_correct << "\n";
   std::cout << "| Uncorrectable ECC Errors         | " << gpu_info.ecc_uncorrect << "\n";
   std::cout << "+----------------------------------"
             << "+------------------------------------\n";
 }
 
+void RdciStatsSubSystem::export_timelines() const {
+  const rdc_field_t job_fields[] = {RDC_FI_POWER_USAGE, RDC_FI_GPU_UTIL,  RDC_FI_GPU_MEMORY_USAGE,
+                                    RDC_FI_GPU_CLOCK,   RDC_FI_MEM_CLOCK, RDC_FI_GPU_TEMP,
+                                    RDC_FI_PCIE_TX,     RDC_FI_PCIE_RX};
+  uint32_t gpu_index_list[RDC_MAX_NUM_DEVICES];
+  uint32_t count = 0;
+  rdc_status_t result = rdc_device_get_all(rdc_handle_, gpu_index_list, &count);
+  if (result != RDC_ST_OK) {
+    throw RdcException(result, rdc_status_string(result));
+  }
+
+  std::ofstream file(timeline_file_);
+  if (!file) {
+    throw RdcException(RDC_ST_FILE_ERROR, "Fail to open " + timeline_file_);
+  }
+  WriteTimelineCsvHeader(&file);
+
+  // The GPUs and fields which are not part of the job are skipped
+  std::unique_ptr<rdc_job_timeline_t> timeline(new rdc_job_timeline_t);
+  uint32_t num_points = 0;
+  for (uint32_t i = 0; i < count; i++) {
+    for (auto field : job_fields) {
+      result = rdc_job_get_timeline(rdc_handle_, job_id_.c_str(), gpu_index_list[i], field,
+                                    timeline.get());
+      if (result == RDC_ST_NOT_FOUND) {
+        continue;
+      }
+      if (result != RDC_ST_OK) {
+        throw RdcException(result, rdc_status_string(result));
+      }
+      num_points += WriteTimelineCsv(&file, gpu_index_list[i], field, *timeline);
+    }
+  }
+  std::cout << "Wrote " << num_points << " points of job " << job_id_ << " to "
+            << timeline_file_ << std::endl;
+}
+
+void RdciStatsSubSystem::list_jobs() const {
+  rdc_job_filter_t filter = job_filter_;
+  std::unique_ptr<rdc_job_list_t> jobs(new rdc_job_list_t);
+  bool first = true;
+  if (is_json_output()) {
+    std::cout << "\"jobs\": [";
+  } else {
+    std::cout << std::left << std::setw(24) << "JOB" << std::setw(26) << "START"
+              << std::setw(10) << "SECONDS" << std::setw(6) << "GPUS" << std::setw(12)
+              << "ENERGY(J)" << std::setw(12) << "POWER(W)" << "UTIL(%)\n";
+  }
+  do {
+    rdc_status_t result = rdc_job_list(rdc_handle_, &filter, jobs.get());
+    if (result != RDC_ST_OK) {
+      throw RdcException(result, rdc_status_string(result));
+    }
+    for (uint32_t i = 0; i < jobs->num_jobs; i++) {
+      const rdc_job_record_t& job = jobs->jobs[i];
+      if (is_json_output()) {
+        std::cout << (first ? "" : ",") << "{\"job_id\": \"" << job.job_id
+                  << "\", \"num_gpus\": " << job.num_gpus << ",";
+        show_job_stats_json(job.summary);
+        std::cout << "}";
+      } else {
+        std::cout << std::left << std::setw(24) << job.job_id << std::setw(26)
+                  << std::put_time(
+                         std::gmtime(reinterpret_cast<const time_t*>(&job.summary.start_time)),
+                         "%F %T %Z")
+                  << std::setw(10) << (job.summary.end_time - job.summary.start_time)
+                  << std::setw(6) << job.num_gpus << std::setw(12)
+                  << job.summary.energy_consumed << std::setw(12)
+                  << job.summary.power_usage.average << job.summary.gpu_utilization.average
+                  << "\n";
+      }
+      first = false;
+    }
+    filter.cursor = jobs->next_cursor;
+  } while (filter.cursor != 0);
+  if (is_json_output()) {
+    std::cout << "]";
+  }
+}
+
 void RdciStatsSubSystem::process() {
   if (stats_ops_ == STATS_HELP || stats_ops_ == STATS_UNKNOWN) {
     show_help();
@@ -335,6 +511,16 @@ void RdciStatsSubSystem::process() {
     return;
   }
 
+  if (stats_ops_ == STATS_LIST) {
+    list_jobs();
+    return;
+  }
+
+  if (stats_ops_ == STATS_TIMELINE) {
+    export_timelines();
+    return;
+  }
+
   if (stats_ops_ == STATS_REMOVE) {
     result = rdc_job_remove(rdc_handle_, const_cast<char*>(job_id_.c_str()));
     if (result != RDC_ST_OK) {
@@ -29,6 +29,8 @@ THE SOFTWARE.
 #include "RdciDmonSubSystem.h"
 #include "RdciFieldGroupSubSystem.h"
 #include "RdciGroupSubSystem.h"
+#include "RdciHistorySubSystem.h"
+#include "RdciPerfSubSystem.h"
 #include "RdciStatsSubSystem.h"
 #include "rdc/rdc.h"
 #include "rdc_lib/RdcException.h"
@@ -49,7 +51,7 @@ int main(int argc, char** argv) {
   const std::string usage_help =
       "Usage:\trdci <subsystem>|<options>\n"
       "subsystem: \n"
-      "          discovery, dmon, group, fieldgroup, stats, diag\n"
+      "          discovery, dmon, group, fieldgroup, stats, diag, perf, history\n"
       "options: \n"
       "        -v(--version) : Print client version information only\n";
 
@@ -82,6 +84,10 @@ int main(int argc, char** argv) {
       subsystem.reset(new amd::rdc::RdciFieldGroupSubSystem());
     } else if (subsystem_name == "stats") {
       subsystem.reset(new amd::rdc::RdciStatsSubSystem());
+    } else if (subsystem_name == "perf") {
+      subsystem.reset(new amd::rdc::RdciPerfSubSystem());
+    } else if (subsystem_name == "history") {
+      subsystem.reset(new amd::rdc::RdciHistorySubSystem());
     } else {
       std::cout << usage_help;
       exit(0);
@@ -24,7 +24,7 @@ THE SOFTWARE.
 
 #include "amd_smi/amdsmi.h"
 #include "rdc.grpc.pb.h"  // NOLINT
-#include "rdc/rdc_admin_service.h"
+#include "rdc/rdc.h"
 
 namespace amd {
 namespace rdc {
@@ -37,7 +37,26 @@ class RDCAdminServiceImpl final : public ::rdc::RdcAdmin::Service {
                                   const ::rdc::VerifyConnectionRequest* request,
                                   ::rdc::VerifyConnectionResponse* reply) override;
 
+  ::grpc::Status GetPerfStats(::grpc::ServerContext* context, const ::rdc::Empty* request,
+                              ::rdc::GetPerfStatsResponse* reply) override;
+
+  ::grpc::Status SetPipelineTrace(::grpc::ServerContext* context,
+                                  const ::rdc::SetPipelineTraceRequest* request,
+                                  ::rdc::SetPipelineTraceResponse* reply) override;
+
+  ::grpc::Status GetPipelineTrace(::grpc::ServerContext* context,
+                                  const ::rdc::GetPipelineTraceRequest* request,
+                                  ::rdc::GetPipelineTraceResponse* reply) override;
+
+  ::grpc::Status SetLogLevel(::grpc::ServerContext* context,
+                             const ::rdc::SetLogLevelRequest* request,
+                             ::rdc::SetLogLevelResponse* reply) override;
+
+  //!< The embedded RDC whose perf stats are reported with the ones of rdcd
+  void set_rdc_handle(rdc_handle_t rdc_handle) { rdc_handle_ = rdc_handle; }
+
  private:
+  rdc_handle_t rdc_handle_;
 };
 
 }  // namespace rdc
@@ -0,0 +1,96 @@
+/*
+Copyright (c) 2024 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#ifndef SERVER_INCLUDE_RDC_RDC_AGGREGATOR_H_
+#define SERVER_INCLUDE_RDC_RDC_AGGREGATOR_H_
+
+#include <grpcpp/grpcpp.h>
+
+#include <condition_variable>  // NOLINT(build/c++11)
+#include <memory>
+#include <mutex>  // NOLINT(build/c++11)
+#include <set>
+#include <string>
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+#include "rdc.grpc.pb.h"  // NOLINT
+#include "rdc/rdc.h"
+
+namespace amd {
+namespace rdc {
+
+//!< Fans in from downstream rdcds. Each one is read over a StreamFieldValues
+//!< stream on its own thread and channel, so a slow or dead rdcd does not
+//!< hold the others back, and the stream is opened again after a failure
+//!< with an exponential backoff. The samples are ingested into the local
+//!< cache under the GPU indexes offset by the gpu_base of their host.
+class RdcAggregator {
+ public:
+  explicit RdcAggregator(rdc_handle_t rdc_handle);
+  ~RdcAggregator();
+
+  //!< Read the downstream rdcds from the file, one host:port per line, and
+  //!< stream the fields set by RDC_AGGREGATE_FIELDS from each
+  rdc_status_t start(const std::string& hosts_file, bool secure);
+  void stop();
+
+  rdc_status_t get_hosts(rdc_aggregate_hosts_t* hosts);
+  rdc_status_t get_field(rdc_field_t field_id, rdc_aggregate_op_t op,
+                         rdc_cluster_aggregate_t* aggregate);
+
+ private:
+  struct Downstream {
+    std::string address;
+    uint32_t host_id;
+    uint32_t gpu_base;
+    std::thread thread;
+    //!< The stream being read, cancelled by stop()
+    ::grpc::ClientContext* context;
+    bool connected;
+    std::set<uint32_t> gpus;
+    uint64_t last_sample_ts;
+    uint64_t num_samples;
+    uint64_t num_reconnects;
+  };
+
+  rdc_status_t read_hosts(const std::string& hosts_file);
+  rdc_status_t make_credentials(bool secure);
+  void run(Downstream* downstream);
+  bool read_stream(Downstream* downstream, ::rdc::RdcAPI::Stub* stub);
+  void ingest(Downstream* downstream, const ::rdc::FieldValueBatch& batch);
+
+  rdc_handle_t rdc_handle_;
+  std::vector<rdc_field_t> field_ids_;
+  uint64_t update_freq_ms_;
+  std::shared_ptr<::grpc::ChannelCredentials> credentials_;
+  std::vector<std::unique_ptr<Downstream>> downstreams_;
+
+  //!< Guards stopping_ and the state of the downstreams
+  std::mutex mutex_;
+  std::condition_variable stop_cv_;
+  bool stopping_;
+};
+
+}  // namespace rdc
+}  // namespace amd
+
+#endif  // SERVER_INCLUDE_RDC_RDC_AGGREGATOR_H_
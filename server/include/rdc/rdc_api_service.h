@@ -22,12 +22,19 @@ THE SOFTWARE.
 #ifndef SERVER_INCLUDE_RDC_RDC_API_SERVICE_H_
 #define SERVER_INCLUDE_RDC_RDC_API_SERVICE_H_
 
+#include <map>
+#include <mutex>  // NOLINT(build/c++11)
+#include <utility>
+#include <vector>
+
 #include "rdc.grpc.pb.h"  // NOLINT
 #include "rdc/rdc.h"
 
 namespace amd {
 namespace rdc {
 
+class RdcAggregator;
+
 class RdcAPIServiceImpl final : public ::rdc::RdcAPI::Service {
  public:
   RdcAPIServiceImpl();
@@ -35,6 +42,11 @@ class RdcAPIServiceImpl final : public ::rdc::RdcAPI::Service {
 
   rdc_status_t Initialize(uint64_t rdcd_init_flags = 0);
 
+  rdc_handle_t rdc_handle() const { return rdc_handle_; }
+
+  //!< Answer the aggregate RPCs from the aggregator, when rdcd runs as one
+  void set_aggregator(RdcAggregator* aggregator) { aggregator_ = aggregator; }
+
   ::grpc::Status GetAllDevices(::grpc::ServerContext* context, const ::rdc::Empty* request,
                                ::rdc::GetAllDevicesResponse* reply) override;
 
@@ -91,6 +103,61 @@ class RdcAPIServiceImpl final : public ::rdc::RdcAPI::Service {
                                const ::rdc::GetFieldSinceRequest* request,
                                ::rdc::GetFieldSinceResponse* reply) override;
 
+  ::grpc::Status GetFieldRollup(::grpc::ServerContext* context,
+                                const ::rdc::GetFieldRollupRequest* request,
+                                ::rdc::GetFieldRollupResponse* reply) override;
+
+  ::grpc::Status GetFieldHistory(::grpc::ServerContext* context,
+                                 const ::rdc::GetFieldHistoryRequest* request,
+                                 ::rdc::GetFieldHistoryResponse* reply) override;
+
+  ::grpc::Status AddPolicyRule(::grpc::ServerContext* context,
+                               const ::rdc::AddPolicyRuleRequest* request,
+                               ::rdc::AddPolicyRuleResponse* reply) override;
+
+  ::grpc::Status DeletePolicyRule(::grpc::ServerContext* context,
+                                  const ::rdc::DeletePolicyRuleRequest* request,
+                                  ::rdc::DeletePolicyRuleResponse* reply) override;
+
+  ::grpc::Status GetPolicyViolations(::grpc::ServerContext* context,
+                                     const ::rdc::GetPolicyViolationsRequest* request,
+                                     ::rdc::GetPolicyViolationsResponse* reply) override;
+
+  ::grpc::Status WatchPolicyViolations(
+      ::grpc::ServerContext* context, const ::rdc::WatchPolicyViolationsRequest* request,
+      ::grpc::ServerWriter<::rdc::PolicyViolation>* writer) override;
+
+  ::grpc::Status SetAnomalyDetector(::grpc::ServerContext* context,
+                                    const ::rdc::SetAnomalyDetectorRequest* request,
+                                    ::rdc::SetAnomalyDetectorResponse* reply) override;
+
+  ::grpc::Status ClearAnomalyDetector(::grpc::ServerContext* context,
+                                      const ::rdc::ClearAnomalyDetectorRequest* request,
+                                      ::rdc::ClearAnomalyDetectorResponse* reply) override;
+
+  ::grpc::Status SetDerivedField(::grpc::ServerContext* context,
+                                 const ::rdc::SetDerivedFieldRequest* request,
+                                 ::rdc::SetDerivedFieldResponse* reply) override;
+
+  ::grpc::Status ClearDerivedField(::grpc::ServerContext* context,
+                                   const ::rdc::ClearDerivedFieldRequest* request,
+                                   ::rdc::ClearDerivedFieldResponse* reply) override;
+
+  ::grpc::Status StreamFieldValues(::grpc::ServerContext* context,
+                                   const ::rdc::StreamFieldValuesRequest* request,
+                                   ::grpc::ServerWriter<::rdc::FieldValueBatch>* writer) override;
+
+  ::grpc::Status GetAggregateHosts(::grpc::ServerContext* context, const ::rdc::Empty* request,
+                                   ::rdc::GetAggregateHostsResponse* reply) override;
+
+  ::grpc::Status GetClusterAggregate(::grpc::ServerContext* context,
+                                     const ::rdc::GetClusterAggregateRequest* request,
+                                     ::rdc::GetClusterAggregateResponse* reply) override;
+
+  ::grpc::Status GetGroupAggregate(::grpc::ServerContext* context,
+                                   const ::rdc::GetGroupAggregateRequest* request,
+                                   ::rdc::GetGroupAggregateResponse* reply) override;
+
   ::grpc::Status UnWatchFields(::grpc::ServerContext* context,
                                const ::rdc::UnWatchFieldsRequest* request,
                                ::rdc::UnWatchFieldsResponse* reply) override;
@@ -111,6 +178,13 @@ class RdcAPIServiceImpl final : public ::rdc::RdcAPI::Service {
                               const ::rdc::StopJobStatsRequest* request,
                               ::rdc::StopJobStatsResponse* reply) override;
 
+  ::grpc::Status GetJobTimeline(::grpc::ServerContext* context,
+                                const ::rdc::GetJobTimelineRequest* request,
+                                ::rdc::GetJobTimelineResponse* reply) override;
+
+  ::grpc::Status ListJobs(::grpc::ServerContext* context, const ::rdc::ListJobsRequest* request,
+                          ::rdc::ListJobsResponse* reply) override;
+
   ::grpc::Status RemoveJob(::grpc::ServerContext* context, const ::rdc::RemoveJobRequest* request,
                            ::rdc::RemoveJobResponse* reply) override;
 
@@ -128,8 +202,38 @@ class RdcAPIServiceImpl final : public ::rdc::RdcAPI::Service {
   ::grpc::Status GetMixedComponentVersion(::grpc::ServerContext* context, const ::rdc::GetMixedComponentVersionRequest* request,
                                ::rdc::GetMixedComponentVersionResponse* reply) override;
  private:
+  //!< A reply built at a generation of the samples of a field or of the groups
+  template <typename Reply>
+  struct CachedReply {
+    uint64_t generation;
+    Reply reply;
+  };
+  template <typename Key, typename Reply>
+  using ReplyCache = std::map<Key, CachedReply<Reply>>;
+
+  //!< Copy the reply cached for key while its generation is current, else
+  //!< build it into reply and cache it. Without a generation, just build it.
+  //!< field is the <GPU, field> whose samples the reply reads, or nullptr
+  //!< for a reply read from the groups.
+  template <typename Key, typename Reply, typename Build>
+  void serve_cached(ReplyCache<Key, Reply>* cache, const Key& key,
+                    const std::pair<uint32_t, uint32_t>* field, Reply* reply, Build build);
   bool copy_gpu_usage_info(const rdc_gpu_usage_info_t& src, ::rdc::GpuUsageInfo* target);
+  //!< Write the new samples of the group every update_freq, until cancelled
+  rdc_status_t write_field_values(::grpc::ServerContext* context,
+                                  ::grpc::ServerWriter<::rdc::FieldValueBatch>* writer,
+                                  rdc_gpu_group_t group_id,
+                                  const std::vector<rdc_field_t>& field_ids, uint64_t update_freq);
   rdc_handle_t rdc_handle_;
+  RdcAggregator* aggregator_;
+
+  //!< The replies of the hot read RPCs, which scrapers repeat within an
+  //!< update interval
+  std::mutex reply_cache_mutex_;
+  ReplyCache<std::pair<uint32_t, uint32_t>, ::rdc::GetLatestFieldValueResponse>
+      latest_value_replies_;
+  ReplyCache<uint32_t, ::rdc::GetGroupAllIdsResponse> group_ids_replies_;
+  ReplyCache<uint32_t, ::rdc::GetFieldGroupInfoResponse> field_group_info_replies_;
 };
 
 }  // namespace rdc
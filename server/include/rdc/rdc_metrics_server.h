@@ -0,0 +1,105 @@
+/*
+Copyright (c) 2024 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#ifndef SERVER_INCLUDE_RDC_RDC_METRICS_SERVER_H_
+#define SERVER_INCLUDE_RDC_RDC_METRICS_SERVER_H_
+
+#include <zlib.h>
+
+#include <string>
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+#include "rdc/rdc.h"
+
+namespace amd {
+namespace rdc {
+
+//!< Serves the latest cached values in the Prometheus text format on
+//!< /metrics. The fields are watched when the server starts, and a scrape
+//!< only reads the cache, so it never waits on amd_smi_lib. The scrapes in
+//!< flight are served by one thread polling non-blocking sockets, so a slow
+//!< scraper does not hold back the others.
+class RdcMetricsServer {
+ public:
+  explicit RdcMetricsServer(rdc_handle_t rdc_handle);
+  ~RdcMetricsServer();
+
+  //!< Watch the fields set by RDC_METRICS_FIELDS and listen on the port
+  rdc_status_t start(const std::string& address, const std::string& port);
+  void stop();
+
+ private:
+  //!< The HELP and TYPE lines of a field, and the name and labels of its
+  //!< series on each GPU, built once at start
+  struct Family {
+    rdc_field_t field_id;
+    std::string header;
+    std::vector<std::string> series;
+  };
+
+  //!< A scrape in flight. The slots and their buffers are reused.
+  struct Connection {
+    int fd;             //!< -1 when the slot is free
+    uint64_t deadline;  //!< In milliseconds, the connection is dropped past it
+    std::string request;
+    std::string response;  //!< Empty while the request is being read
+    size_t sent;
+  };
+
+  rdc_status_t watch_fields();
+  void build_families(const std::vector<rdc_field_t>& field_ids);
+  int listen_on(const std::string& address, const std::string& port);
+  void serve();
+  void accept_connections(uint64_t now);
+  //!< Reads what the socket has, false when the connection is done
+  bool read_request(Connection* conn);
+  //!< Sends what the socket takes, false when the connection is done
+  bool write_response(Connection* conn);
+  void build_response(Connection* conn);
+  void close_connection(Connection* conn);
+  void render();
+  bool gzip_body();
+
+  rdc_handle_t rdc_handle_;
+  rdc_gpu_group_t gpu_group_;
+  rdc_field_grp_t field_group_;
+  bool watching_;
+  uint64_t update_freq_ms_;
+  std::vector<uint32_t> gpu_indexes_;
+  std::vector<Family> families_;
+
+  int listen_fd_;
+  int wake_fd_[2];
+  std::thread thread_;
+  std::vector<Connection> connections_;
+
+  //!< Reused by every scrape, so a scrape does not allocate once warm
+  std::string body_;
+  std::string gzip_;
+  z_stream zstream_;
+  bool zstream_ready_;
+};
+
+}  // namespace rdc
+}  // namespace amd
+
+#endif  // SERVER_INCLUDE_RDC_RDC_METRICS_SERVER_H_
@@ -28,7 +28,9 @@ THE SOFTWARE.
 #include <string>
 
 #include "rdc/rdc_admin_service.h"
+#include "rdc/rdc_aggregator.h"
 #include "rdc/rdc_api_service.h"
+#include "rdc/rdc_metrics_server.h"
 
 #define RDC_SERVER_VERSION_MAJOR 1
 #define RDC_SERVER_VERSION_MINOR 0
@@ -44,9 +46,12 @@ THE SOFTWARE.
 typedef struct {
   std::string listen_address;
   std::string listen_port;
+  std::string metrics_port;
+  std::string aggregate_hosts;
   bool no_authentication;
   bool use_pinned_certs;
   bool log_dbg;
+  bool fake_smi;
 } RdcdCmdLineOpts;
 
 class RDCServer {
@@ -82,6 +87,10 @@ class RDCServer {
 
   bool start_api_service_;
   amd::rdc::RdcAPIServiceImpl* api_service_;
+
+  amd::rdc::RdcMetricsServer* metrics_server_;
+
+  amd::rdc::RdcAggregator* aggregator_;
 };
 
 #endif  // SERVER_INCLUDE_RDC_RDC_SERVER_MAIN_H_
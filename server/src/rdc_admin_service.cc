@@ -32,12 +32,15 @@ THE SOFTWARE.
 #include <sstream>
 #include <string>
 
+#include "common/rdc_perf_histogram.h"
 #include "rdc.grpc.pb.h"  // NOLINT
+#include "rdc_lib/RdcLogger.h"
+#include "rdc_lib/RdcPipelineTrace.h"
 
 namespace amd {
 namespace rdc {
 
-RDCAdminServiceImpl::RDCAdminServiceImpl() {}
+RDCAdminServiceImpl::RDCAdminServiceImpl() : rdc_handle_(nullptr) {}
 
 RDCAdminServiceImpl::~RDCAdminServiceImpl() {}
 ::grpc::Status RDCAdminServiceImpl::VerifyConnection(::grpc::ServerContext* context,
@@ -49,5 +52,102 @@ RDCAdminServiceImpl::~RDCAdminServiceImpl() {}
   return ::grpc::Status::OK;
 }
 
+::grpc::Status RDCAdminServiceImpl::GetPerfStats(::grpc::ServerContext* context,
+                                                 const ::rdc::Empty* request,
+                                                 ::rdc::GetPerfStatsResponse* reply) {
+  (void)(context);
+  (void)(request);
+  if (!reply) {
+    return ::grpc::Status(::grpc::StatusCode::INTERNAL, "Empty reply");
+  }
+
+  // The library paths come from the embedded RDC, the handlers from rdcd
+  std::unique_ptr<rdc_perf_stats_t> stats(new rdc_perf_stats_t);
+  stats->num_stats = 0;
+  if (rdc_handle_) {
+    rdc_status_t result = rdc_perf_stats_get(rdc_handle_, stats.get());
+    if (result != RDC_ST_OK) {
+      reply->set_status(result);
+      return ::grpc::Status::OK;
+    }
+  }
+  RdcPerfRegistry::get_instance().get_stats(stats.get());
+
+  for (uint32_t i = 0; i < stats->num_stats; i++) {
+    const rdc_perf_stat_t& src = stats->stats[i];
+    ::rdc::PerfStat* stat = reply->add_stats();
+    stat->set_name(src.name);
+    stat->set_count(src.count);
+    stat->set_total_ns(src.total_ns);
+    stat->set_max_ns(src.max_ns);
+    stat->set_p50_ns(src.p50_ns);
+    stat->set_p90_ns(src.p90_ns);
+    stat->set_p99_ns(src.p99_ns);
+    stat->set_p999_ns(src.p999_ns);
+  }
+  reply->set_status(RDC_ST_OK);
+  return ::grpc::Status::OK;
+}
+
+// rdcd and the embedded RDC share the ring of the bootstrap library, so the
+// trace is driven directly rather than through rdc_handle_.
+::grpc::Status RDCAdminServiceImpl::SetPipelineTrace(::grpc::ServerContext* context,
+                                                     const ::rdc::SetPipelineTraceRequest* request,
+                                                     ::rdc::SetPipelineTraceResponse* reply) {
+  (void)(context);
+  if (!reply || !request) {
+    return ::grpc::Status(::grpc::StatusCode::INTERNAL, "Empty contents");
+  }
+
+  RdcPipelineTrace::get_instance().set_enabled(request->enabled());
+  reply->set_status(RDC_ST_OK);
+  return ::grpc::Status::OK;
+}
+
+::grpc::Status RDCAdminServiceImpl::GetPipelineTrace(::grpc::ServerContext* context,
+                                                     const ::rdc::GetPipelineTraceRequest* request,
+                                                     ::rdc::GetPipelineTraceResponse* reply) {
+  (void)(context);
+  if (!reply || !request) {
+    return ::grpc::Status(::grpc::StatusCode::INTERNAL, "Empty contents");
+  }
+
+  std::unique_ptr<rdc_pipeline_events_t> events(new rdc_pipeline_events_t);
+  RdcPipelineTrace::get_instance().get_events(request->start_seq(), events.get());
+  for (uint32_t i = 0; i < events->num_events; i++) {
+    const rdc_pipeline_event_t& src = events->events[i];
+    ::rdc::PipelineEvent* event = reply->add_events();
+    event->set_name(src.name);
+    event->set_seq(src.seq);
+    event->set_ts_us(src.ts_us);
+    event->set_dur_us(src.dur_us);
+    event->set_tid(src.tid);
+    event->set_gpu_index(src.gpu_index);
+    event->set_field_id(src.field_id);
+  }
+  reply->set_next_seq(events->next_seq);
+  reply->set_status(RDC_ST_OK);
+  return ::grpc::Status::OK;
+}
+
+// Like the pipeline trace, the logger is shared with the embedded RDC
+::grpc::Status RDCAdminServiceImpl::SetLogLevel(::grpc::ServerContext* context,
+                                                const ::rdc::SetLogLevelRequest* request,
+                                                ::rdc::SetLogLevelResponse* reply) {
+  (void)(context);
+  if (!reply || !request) {
+    return ::grpc::Status(::grpc::StatusCode::INTERNAL, "Empty contents");
+  }
+
+  if (request->level() > RDC_LOG_LEVEL_DEBUG) {
+    reply->set_status(RDC_ST_BAD_PARAMETER);
+    return ::grpc::Status::OK;
+  }
+  RdcLogger::getLogger().set_log_level(request->level());
+  RDC_LOG(RDC_INFO, "Log level set to " << request->level());
+  reply->set_status(RDC_ST_OK);
+  return ::grpc::Status::OK;
+}
+
 }  // namespace rdc
 }  // namespace amd
@@ -0,0 +1,424 @@
+/*
+Copyright (c) 2024 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "rdc/rdc_aggregator.h"
+
+#include <sys/time.h>
+
+#include <algorithm>
+#include <chrono>  // NOLINT(build/c++11)
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <sstream>
+
+#include "common/rdc_fields_supported.h"
+#include "common/rdc_utils.h"
+#include "rdc_lib/RdcLogger.h"
+#include "rdc_lib/rdc_common.h"
+
+namespace amd {
+namespace rdc {
+
+namespace {
+
+const uint64_t kDefaultUpdateFreqMs = 1000;
+const double kMaxKeepAge = 60;
+const uint32_t kMaxKeepSamples = 60;
+// A GPU whose latest sample is older than this many update periods is left
+// out of the cluster aggregates
+const uint64_t kStalePeriods = 10;
+const uint64_t kMinBackoffMs = 1000;
+const uint64_t kMaxBackoffMs = 60 * 1000;
+// Notice a downstream host which went away without closing its connection
+const int kKeepaliveTimeMs = 30 * 1000;
+const int kKeepaliveTimeoutMs = 10 * 1000;
+
+// The credentials of rdci
+const char* kRootCaPath = "/etc/rdc/client/certs/rdc_cacert.pem";
+const char* kClientCertPath = "/etc/rdc/client/certs/rdc_client_cert.pem";
+const char* kClientKeyPath = "/etc/rdc/client/private/rdc_client_cert.key";
+
+const rdc_field_t kDefaultFields[] = {
+    RDC_FI_GPU_MEMORY_USAGE, RDC_FI_GPU_MEMORY_TOTAL, RDC_FI_POWER_USAGE,
+    RDC_FI_GPU_CLOCK,        RDC_FI_GPU_UTIL,         RDC_FI_GPU_TEMP,
+};
+
+uint64_t now_ms() {
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return static_cast<uint64_t>(tv.tv_sec) * 1000 + tv.tv_usec / 1000;
+}
+
+std::vector<rdc_field_t> fields_from_env() {
+  const char* env = getenv("RDC_AGGREGATE_FIELDS");
+  if (env == nullptr) {
+    return std::vector<rdc_field_t>(std::begin(kDefaultFields), std::end(kDefaultFields));
+  }
+  std::vector<rdc_field_t> field_ids;
+  std::string names(env);
+  std::replace(names.begin(), names.end(), ',', ' ');
+  std::stringstream ss(names);
+  std::string name;
+  while (ss >> name) {
+    rdc_field_t field_id;
+    if (!get_field_id_from_name(name, &field_id)) {
+      RDC_LOG(RDC_ERROR, "Ignore the unknown aggregate field " << name);
+      continue;
+    }
+    if (std::find(field_ids.begin(), field_ids.end(), field_id) == field_ids.end()) {
+      field_ids.push_back(field_id);
+    }
+  }
+  return field_ids;
+}
+
+void copy_field_value(const ::rdc::GetLatestFieldValueResponse& src, rdc_field_value* value) {
+  value->field_id = static_cast<rdc_field_t>(src.field_id());
+  value->status = RDC_ST_OK;
+  value->ts = src.ts();
+  value->type = static_cast<rdc_field_type_t>(src.type());
+  if (value->type == INTEGER) {
+    value->value.l_int = static_cast<int64_t>(src.l_int());
+  } else if (value->type == DOUBLE) {
+    value->value.dbl = src.dbl();
+  } else {
+    strncpy_with_null(value->value.str, src.str().c_str(), RDC_MAX_STR_LENGTH);
+  }
+}
+
+}  // namespace
+
+RdcAggregator::RdcAggregator(rdc_handle_t rdc_handle)
+    : rdc_handle_(rdc_handle), update_freq_ms_(kDefaultUpdateFreqMs), stopping_(false) {}
+
+RdcAggregator::~RdcAggregator() { stop(); }
+
+rdc_status_t RdcAggregator::start(const std::string& hosts_file, bool secure) {
+  const char* freq = getenv("RDC_AGGREGATE_UPDATE_FREQ");
+  if (freq != nullptr && strtoull(freq, nullptr, 10) > 0) {
+    update_freq_ms_ = strtoull(freq, nullptr, 10);
+  }
+
+  field_ids_ = fields_from_env();
+  if (field_ids_.empty()) {
+    RDC_LOG(RDC_ERROR, "No valid field in RDC_AGGREGATE_FIELDS");
+    return RDC_ST_BAD_PARAMETER;
+  }
+  if (field_ids_.size() > RDC_MAX_FIELD_IDS_PER_FIELD_GROUP) {
+    RDC_LOG(RDC_ERROR, "Only the first " << RDC_MAX_FIELD_IDS_PER_FIELD_GROUP
+                                         << " aggregate fields are streamed");
+    field_ids_.resize(RDC_MAX_FIELD_IDS_PER_FIELD_GROUP);
+  }
+
+  rdc_status_t result = read_hosts(hosts_file);
+  if (result != RDC_ST_OK) {
+    return result;
+  }
+  result = make_credentials(secure);
+  if (result != RDC_ST_OK) {
+    return result;
+  }
+
+  for (auto& downstream : downstreams_) {
+    downstream->thread = std::thread(&RdcAggregator::run, this, downstream.get());
+  }
+  RDC_LOG(RDC_INFO, "Aggregate " << field_ids_.size() << " fields from " << downstreams_.size()
+                                 << " rdcd");
+  return RDC_ST_OK;
+}
+
+void RdcAggregator::stop() {
+  do {  //< lock guard for thread safe
+    std::lock_guard<std::mutex> guard(mutex_);
+    stopping_ = true;
+    for (auto& downstream : downstreams_) {
+      if (downstream->context) {
+        downstream->context->TryCancel();
+      }
+    }
+  } while (0);
+  stop_cv_.notify_all();
+
+  for (auto& downstream : downstreams_) {
+    if (downstream->thread.joinable()) {
+      downstream->thread.join();
+    }
+  }
+}
+
+rdc_status_t RdcAggregator::read_hosts(const std::string& hosts_file) {
+  std::ifstream file(hosts_file);
+  if (!file.is_open()) {
+    RDC_LOG(RDC_ERROR, "Fail to open the aggregate hosts file " << hosts_file);
+    return RDC_ST_FILE_ERROR;
+  }
+
+  std::string line;
+  while (std::getline(file, line)) {
+    line = line.substr(0, line.find('#'));
+    std::stringstream ss(line);
+    std::string address;
+    if (!(ss >> address)) {
+      continue;
+    }
+    auto same = [&address](const std::unique_ptr<Downstream>& d) { return d->address == address; };
+    if (std::any_of(downstreams_.begin(), downstreams_.end(), same)) {
+      RDC_LOG(RDC_ERROR, "Ignore the duplicated aggregate host " << address);
+      continue;
+    }
+    if (downstreams_.size() == RDC_MAX_AGGREGATE_HOSTS) {
+      RDC_LOG(RDC_ERROR, "Only the first " << RDC_MAX_AGGREGATE_HOSTS
+                                           << " aggregate hosts are read");
+      break;
+    }
+
+    std::unique_ptr<Downstream> downstream(new Downstream());
+    downstream->address = address;
+    downstream->host_id = downstreams_.size();
+    downstream->gpu_base = (downstream->host_id + 1) * RDC_AGGREGATE_GPU_BASE;
+    downstream->context = nullptr;
+    downstream->connected = false;
+    downstream->last_sample_ts = 0;
+    downstream->num_samples = 0;
+    downstream->num_reconnects = 0;
+    downstreams_.push_back(std::move(downstream));
+  }
+
+  if (downstreams_.empty()) {
+    RDC_LOG(RDC_ERROR, "No host in the aggregate hosts file " << hosts_file);
+    return RDC_ST_BAD_PARAMETER;
+  }
+  return RDC_ST_OK;
+}
+
+rdc_status_t RdcAggregator::make_credentials(bool secure) {
+  if (!secure) {
+    credentials_ = ::grpc::InsecureChannelCredentials();
+    return RDC_ST_OK;
+  }
+
+  ::grpc::SslCredentialsOptions ssl_opts{};
+  if (ReadFile(kRootCaPath, &ssl_opts.pem_root_certs) ||
+      ReadFile(kClientCertPath, &ssl_opts.pem_cert_chain) ||
+      ReadFile(kClientKeyPath, &ssl_opts.pem_private_key)) {
+    RDC_LOG(RDC_ERROR, "Fail to read the client certificates of the aggregator in "
+                           << "/etc/rdc/client");
+    return RDC_ST_FILE_ERROR;
+  }
+  credentials_ = ::grpc::SslCredentials(ssl_opts);
+  return RDC_ST_OK;
+}
+
+void RdcAggregator::run(Downstream* downstream) {
+  ::grpc::ChannelArguments args;
+  args.SetInt(GRPC_ARG_KEEPALIVE_TIME_MS, kKeepaliveTimeMs);
+  args.SetInt(GRPC_ARG_KEEPALIVE_TIMEOUT_MS, kKeepaliveTimeoutMs);
+  auto channel = ::grpc::CreateCustomChannel(downstream->address, credentials_, args);
+  std::unique_ptr<::rdc::RdcAPI::Stub> stub = ::rdc::RdcAPI::NewStub(channel);
+
+  std::minstd_rand random(downstream->host_id + static_cast<uint32_t>(now_ms()));
+  uint64_t backoff_ms = kMinBackoffMs;
+  while (true) {
+    if (read_stream(downstream, stub.get())) {
+      backoff_ms = kMinBackoffMs;
+    }
+
+    // Wait between half and all of the backoff, so the hosts lost together
+    // do not all come back together
+    uint64_t wait_ms = backoff_ms / 2 + random() % (backoff_ms / 2 + 1);
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (stop_cv_.wait_for(lock, std::chrono::milliseconds(wait_ms), [this] { return stopping_; })) {
+      return;
+    }
+    downstream->num_reconnects++;
+    backoff_ms = std::min(backoff_ms * 2, kMaxBackoffMs);
+  }
+}
+
+bool RdcAggregator::read_stream(Downstream* downstream, ::rdc::RdcAPI::Stub* stub) {
+  ::rdc::StreamFieldValuesRequest request;
+  for (rdc_field_t field_id : field_ids_) {
+    request.add_field_ids(field_id);
+  }
+  request.set_update_freq(update_freq_ms_ * 1000);
+
+  ::grpc::ClientContext context;
+  do {  //< lock guard for thread safe
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (stopping_) {
+      return false;
+    }
+    downstream->context = &context;
+  } while (0);
+
+  std::unique_ptr<::grpc::ClientReader<::rdc::FieldValueBatch>> reader(
+      stub->StreamFieldValues(&context, request));
+  ::rdc::FieldValueBatch batch;
+  bool received = false;
+  while (reader->Read(&batch)) {
+    if (!received) {
+      RDC_LOG(RDC_INFO, "Stream the fields of " << downstream->address);
+      std::lock_guard<std::mutex> guard(mutex_);
+      downstream->connected = true;
+      received = true;
+    }
+    ingest(downstream, batch);
+  }
+  ::grpc::Status status = reader->Finish();
+
+  do {  //< lock guard for thread safe
+    std::lock_guard<std::mutex> guard(mutex_);
+    downstream->context = nullptr;
+    downstream->connected = false;
+    if (stopping_) {
+      return received;
+    }
+  } while (0);
+  RDC_LOG(RDC_ERROR, "Lost the stream of " << downstream->address << ": "
+                                           << status.error_message());
+  return received;
+}
+
+void RdcAggregator::ingest(Downstream* downstream, const ::rdc::FieldValueBatch& batch) {
+  // The batch is sorted by GPU, ingest a run of values per GPU
+  std::vector<rdc_field_value> values;
+  int i = 0;
+  while (i < batch.values_size()) {
+    uint32_t gpu_index = batch.values(i).gpu_index();
+    values.clear();
+    uint64_t last_ts = 0;
+    for (; i < batch.values_size() && batch.values(i).gpu_index() == gpu_index; i++) {
+      rdc_field_value value;
+      copy_field_value(batch.values(i).value(), &value);
+      last_ts = std::max(last_ts, value.ts);
+      values.push_back(value);
+    }
+    // The GPUs of a downstream aggregator are not fanned in again
+    if (gpu_index >= RDC_AGGREGATE_GPU_BASE) {
+      continue;
+    }
+
+    rdc_status_t result = rdc_field_ingest(rdc_handle_, downstream->gpu_base + gpu_index,
+                                           values.data(), values.size(), kMaxKeepAge,
+                                           kMaxKeepSamples);
+    if (result != RDC_ST_OK) {
+      RDC_LOG(RDC_DEBUG, "Fail to ingest the GPU " << gpu_index << " of "
+                                                   << downstream->address << ": "
+                                                   << rdc_status_string(result));
+      continue;
+    }
+    std::lock_guard<std::mutex> guard(mutex_);
+    downstream->gpus.insert(gpu_index);
+    downstream->num_samples += values.size();
+    downstream->last_sample_ts = std::max(downstream->last_sample_ts, last_ts);
+  }
+}
+
+rdc_status_t RdcAggregator::get_hosts(rdc_aggregate_hosts_t* hosts) {
+  if (hosts == nullptr) {
+    return RDC_ST_BAD_PARAMETER;
+  }
+
+  std::lock_guard<std::mutex> guard(mutex_);
+  hosts->num_hosts = 0;
+  for (const auto& downstream : downstreams_) {
+    rdc_aggregate_host_t& host = hosts->hosts[hosts->num_hosts++];
+    strncpy_with_null(host.host, downstream->address.c_str(), RDC_MAX_STR_LENGTH);
+    host.host_id = downstream->host_id;
+    host.gpu_base = downstream->gpu_base;
+    host.connected = downstream->connected ? 1 : 0;
+    host.num_gpus = downstream->gpus.size();
+    host.last_sample_ts = downstream->last_sample_ts;
+    host.num_samples = downstream->num_samples;
+    host.num_reconnects = downstream->num_reconnects;
+  }
+  return RDC_ST_OK;
+}
+
+rdc_status_t RdcAggregator::get_field(rdc_field_t field_id, rdc_aggregate_op_t op,
+                                      rdc_cluster_aggregate_t* aggregate) {
+  if (aggregate == nullptr || op > RDC_AGGREGATE_MAX) {
+    return RDC_ST_BAD_PARAMETER;
+  }
+
+  // <host_id, GPU index> of every downstream GPU, read outside the lock
+  std::vector<std::pair<uint32_t, uint32_t>> gpus;
+  do {  //< lock guard for thread safe
+    std::lock_guard<std::mutex> guard(mutex_);
+    for (const auto& downstream : downstreams_) {
+      for (uint32_t gpu_index : downstream->gpus) {
+        gpus.push_back({downstream->host_id, downstream->gpu_base + gpu_index});
+      }
+    }
+  } while (0);
+
+  uint64_t now = now_ms();
+  uint64_t oldest_ts = now - std::min(now, kStalePeriods * update_freq_ms_);
+  double sum = 0;
+  double best = 0;
+  aggregate->num_gpus = 0;
+  aggregate->gpu_index = GPU_ID_INVALID;
+  aggregate->host_id = GPU_ID_INVALID;
+  aggregate->ts = 0;
+  for (const auto& gpu : gpus) {
+    rdc_field_value value;
+    if (rdc_field_get_latest_value(rdc_handle_, gpu.second, field_id, &value) != RDC_ST_OK ||
+        value.ts < oldest_ts) {
+      continue;
+    }
+    double v = 0;
+    if (value.type == INTEGER) {
+      v = static_cast<double>(value.value.l_int);
+    } else if (value.type == DOUBLE) {
+      v = value.value.dbl;
+    } else {
+      return RDC_ST_NOT_SUPPORTED;
+    }
+
+    bool first = aggregate->num_gpus == 0;
+    if (first || (op == RDC_AGGREGATE_MIN && v < best) || (op == RDC_AGGREGATE_MAX && v > best)) {
+      best = v;
+      if (op == RDC_AGGREGATE_MIN || op == RDC_AGGREGATE_MAX) {
+        aggregate->gpu_index = gpu.second;
+        aggregate->host_id = gpu.first;
+      }
+    }
+    sum += v;
+    aggregate->ts = first ? value.ts : std::min(aggregate->ts, value.ts);
+    aggregate->num_gpus++;
+  }
+
+  if (aggregate->num_gpus == 0) {
+    return RDC_ST_NOT_FOUND;
+  }
+  if (op == RDC_AGGREGATE_SUM) {
+    aggregate->value = sum;
+  } else if (op == RDC_AGGREGATE_AVG) {
+    aggregate->value = sum / aggregate->num_gpus;
+  } else {
+    aggregate->value = best;
+  }
+  return RDC_ST_OK;
+}
+
+}  // namespace rdc
+}  // namespace amd
@@ -24,21 +24,29 @@ THE SOFTWARE.
 #include <assert.h>
 #include <grpcpp/grpcpp.h>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT(build/c++11)
 #include <csignal>
 #include <iostream>
 #include <memory>
 #include <string>
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
 
+#include "common/rdc_perf_histogram.h"
 #include "rdc.grpc.pb.h"  // NOLINT
 #include "rdc/rdc.h"
+#include "rdc/rdc_aggregator.h"
 #include "rdc/rdc_private.h"
 #include "rdc_lib/RdcLogger.h"
+#include "rdc_lib/RdcPipelineTrace.h"
 #include "rdc_lib/rdc_common.h"
 
 namespace amd {
 namespace rdc {
 
-RdcAPIServiceImpl::RdcAPIServiceImpl() : rdc_handle_(nullptr) {}
+RdcAPIServiceImpl::RdcAPIServiceImpl() : rdc_handle_(nullptr), aggregator_(nullptr) {}
 
 rdc_status_t RdcAPIServiceImpl::Initialize(uint64_t rdcd_init_flags) {
   rdc_status_t result = rdc_init(rdcd_init_flags);
@@ -63,9 +71,52 @@ RdcAPIServiceImpl::~RdcAPIServiceImpl() {
   rdc_shutdown();
 }
 
+namespace {
+// The replies cached per RPC, beyond which its cache starts over
+const size_t kMaxCachedReplies = 4096;
+}  // namespace
+
+template <typename Key, typename Reply, typename Build>
+void RdcAPIServiceImpl::serve_cached(ReplyCache<Key, Reply>* cache, const Key& key,
+                                     const std::pair<uint32_t, uint32_t>* field, Reply* reply,
+                                     Build build) {
+  // Read before building, so a reply racing an update is cached at the
+  // older generation and built again by the next request
+  uint64_t cache_generation = 0;
+  uint64_t group_generation = 0;
+  uint32_t gpu_index = field ? field->first : 0;
+  rdc_field_t field_id = field ? static_cast<rdc_field_t>(field->second) : RDC_FI_INVALID;
+  if (get_cache_generation(rdc_handle_, gpu_index, field_id, &cache_generation,
+                           &group_generation) != RDC_ST_OK) {
+    build();
+    return;
+  }
+  uint64_t generation = field ? cache_generation : group_generation;
+
+  do {  //< lock guard for thread safe
+    std::lock_guard<std::mutex> guard(reply_cache_mutex_);
+    auto ite = cache->find(key);
+    if (ite != cache->end() && ite->second.generation == generation) {
+      reply->CopyFrom(ite->second.reply);
+      return;
+    }
+  } while (0);
+
+  build();
+  std::lock_guard<std::mutex> guard(reply_cache_mutex_);
+  if (cache->size() >= kMaxCachedReplies) {
+    cache->clear();
+  }
+  CachedReply<Reply>& cached = (*cache)[key];
+  cached.generation = generation;
+  cached.reply.CopyFrom(*reply);
+}
+
 ::grpc::Status RdcAPIServiceImpl::GetAllDevices(::grpc::ServerContext* context,
                                                 const ::rdc::Empty* request,
                                                 ::rdc::GetAllDevicesResponse* reply) {
+  RDC_PERF_SCOPE("grpc.GetAllDevices");
+  RDC_PIPELINE_SCOPE("grpc.GetAllDevices");
   (void)(context);
   (void)(request);
   if (!reply) {
@@ -88,6 +139,8 @@ RdcAPIServiceImpl::~RdcAPIServiceImpl() {
 ::grpc::Status RdcAPIServiceImpl::GetDeviceAttributes(
     ::grpc::ServerContext* context, const ::rdc::GetDeviceAttributesRequest* request,
     ::rdc::GetDeviceAttributesResponse* reply) {
+  RDC_PERF_SCOPE("grpc.GetDeviceAttributes");
+  RDC_PIPELINE_SCOPE("grpc.GetDeviceAttributes");
   (void)(context);
   if (!reply || !request) {
     return ::grpc::Status(::grpc::StatusCode::INTERNAL, "Empty contents");
@@ -107,6 +160,8 @@ RdcAPIServiceImpl::~RdcAPIServiceImpl() {
 ::grpc::Status RdcAPIServiceImpl::GetComponentVersion(::grpc::ServerContext* context,
                                                 const ::rdc::GetComponentVersionRequest* request,
                                                 ::rdc::GetComponentVersionResponse* reply) {
+  RDC_PERF_SCOPE("grpc.GetComponentVersion");
+  RDC_PIPELINE_SCOPE("grpc.GetComponentVersion");
   (void)(context);
   if (!reply) {
     return ::grpc::Status(::grpc::StatusCode::INTERNAL, "Empty reply");
@@ -124,6 +179,8 @@ RdcAPIServiceImpl::~RdcAPIServiceImpl() {
 ::grpc::Status RdcAPIServiceImpl::CreateGpuGroup(::grpc::ServerContext* context,
                                                  const ::rdc::CreateGpuGroupRequest* request,
                                                  ::rdc::CreateGpuGroupResponse* reply) {
+  RDC_PERF_SCOPE("grpc.CreateGpuGroup");
+  RDC_PIPELINE_SCOPE("grpc.CreateGpuGroup");
   (void)(context);
   if (!reply || !request) {
     return ::grpc::Status(::grpc::StatusCode::INTERNAL, "Empty contents");
@@ -146,6 +203,8 @@ RdcAPIServiceImpl::~RdcAPIServiceImpl() {
 ::grpc::Status RdcAPIServiceImpl::AddToGpuGroup(::grpc::ServerContext* context,
                                                 const ::rdc::AddToGpuGroupRequest* request,
                                                 ::rdc::AddToGpuGroupResponse* reply) {
+  RDC_PERF_SCOPE("grpc.AddToGpuGroup");
+  RDC_PIPELINE_SCOPE("grpc.AddToGpuGroup");
   (void)(context);
   if (!reply || !request) {
     return ::grpc::Status(::grpc::StatusCode::INTERNAL, "Empty contents");
@@ -160,6 +219,8 @@ RdcAPIServiceImpl::~RdcAPIServiceImpl() {
 ::grpc::Status RdcAPIServiceImpl::GetGpuGroupInfo(::grpc::ServerContext* context,
                                                   const ::rdc::GetGpuGroupInfoRequest* request,
                                                   ::rdc::GetGpuGroupInfoResponse* reply) {
+  RDC_PERF_SCOPE("grpc.GetGpuGroupInfo");
+  RDC_PIPELINE_SCOPE("grpc.GetGpuGroupInfo");
   (void)(context);
   if (!reply || !request) {
     return ::grpc::Status(::grpc::StatusCode::INTERNAL, "Empty contents");
@@ -183,21 +244,25 @@ RdcAPIServiceImpl::~RdcAPIServiceImpl() {
 ::grpc::Status RdcAPIServiceImpl::GetGroupAllIds(::grpc::ServerContext* context,
                                                  const ::rdc::Empty* request,
                                                  ::rdc::GetGroupAllIdsResponse* reply) {
+  RDC_PERF_SCOPE("grpc.GetGroupAllIds");
+  RDC_PIPELINE_SCOPE("grpc.GetGroupAllIds");
   if (!reply || !request || !context) {
     return ::grpc::Status(::grpc::StatusCode::INTERNAL, "Empty contents");
   }
 
-  rdc_gpu_group_t group_id_list[RDC_MAX_NUM_GROUPS];
-  uint32_t count = 0;
-  rdc_status_t result = rdc_group_get_all_ids(rdc_handle_, group_id_list, &count);
-  reply->set_status(result);
-  if (result != RDC_ST_OK) {
-    return ::grpc::Status::OK;
-  }
+  serve_cached(&group_ids_replies_, 0u, nullptr, reply, [&]() {
+    rdc_gpu_group_t group_id_list[RDC_MAX_NUM_GROUPS];
+    uint32_t count = 0;
+    rdc_status_t result = rdc_group_get_all_ids(rdc_handle_, group_id_list, &count);
+    reply->set_status(result);
+    if (result != RDC_ST_OK) {
+      return;
+    }
 
-  for (uint32_t i = 0; i < count; i++) {
-    reply->add_group_ids(group_id_list[i]);
-  }
+    for (uint32_t i = 0; i < count; i++) {
+      reply->add_group_ids(group_id_list[i]);
+    }
+  });
 
   return ::grpc::Status::OK;
 }
@@ -205,6 +270,8 @@ RdcAPIServiceImpl::~RdcAPIServiceImpl() {
 ::grpc::Status RdcAPIServiceImpl::GetFieldGroupAllIds(::grpc::ServerContext* context,
                                                       const ::rdc::Empty* request,
                                                       ::rdc::GetFieldGroupAllIdsResponse* reply) {
+  RDC_PERF_SCOPE("grpc.GetFieldGroupAllIds");
+  RDC_PIPELINE_SCOPE("grpc.GetFieldGroupAllIds");
   if (!reply || !request || !context) {
     return ::grpc::Status(::grpc::StatusCode::INTERNAL, "Empty contents");
   }
@@ -227,6 +294,8 @@ RdcAPIServiceImpl::~RdcAPIServiceImpl() {
 ::grpc::Status RdcAPIServiceImpl::DestroyGpuGroup(::grpc::ServerContext* context,
                                                   const ::rdc::DestroyGpuGroupRequest* request,
                                                   ::rdc::DestroyGpuGroupResponse* reply) {
+  RDC_PERF_SCOPE("grpc.DestroyGpuGroup");
+  RDC_PIPELINE_SCOPE("grpc.DestroyGpuGroup");
   (void)(context);
   if (!reply || !request) {
     return ::grpc::Status(::grpc::StatusCode::INTERNAL, "Empty contents");
@@ -241,6 +310,8 @@ RdcAPIServiceImpl::~RdcAPIServiceImpl() {
 ::grpc::Status RdcAPIServiceImpl::CreateFieldGroup(::grpc::ServerContext* context,
                                                    const ::rdc::CreateFieldGroupRequest* request,
                                                    ::rdc::CreateFieldGroupResponse* reply) {
+  RDC_PERF_SCOPE("grpc.CreateFieldGroup");
+  RDC_PIPELINE_SCOPE("grpc.CreateFieldGroup");
   (void)(context);
   if (!reply || !request) {
     return ::grpc::Status(::grpc::StatusCode::INTERNAL, "Empty contents");
@@ -267,23 +338,27 @@ RdcAPIServiceImpl::~RdcAPIServiceImpl() {
 ::grpc::Status RdcAPIServiceImpl::GetFieldGroupInfo(::grpc::ServerContext* context,
                                                     const ::rdc::GetFieldGroupInfoRequest* request,
                                                     ::rdc::GetFieldGroupInfoResponse* reply) {
+  RDC_PERF_SCOPE("grpc.GetFieldGroupInfo");
+  RDC_PIPELINE_SCOPE("grpc.GetFieldGroupInfo");
   (void)(context);
   if (!reply || !request) {
     return ::grpc::Status(::grpc::StatusCode::INTERNAL, "Empty contents");
   }
 
-  rdc_field_group_info_t field_info;
-  rdc_status_t result =
-      rdc_group_field_get_info(rdc_handle_, request->field_group_id(), &field_info);
-  reply->set_status(result);
-  if (result != RDC_ST_OK) {
-    return ::grpc::Status::OK;
-  }
+  uint32_t field_group_id = request->field_group_id();
+  serve_cached(&field_group_info_replies_, field_group_id, nullptr, reply, [&]() {
+    rdc_field_group_info_t field_info;
+    rdc_status_t result = rdc_group_field_get_info(rdc_handle_, field_group_id, &field_info);
+    reply->set_status(result);
+    if (result != RDC_ST_OK) {
+      return;
+    }
 
-  reply->set_filed_group_name(field_info.group_name);
-  for (uint32_t i = 0; i < field_info.count; i++) {
-    reply->add_field_ids(field_info.field_ids[i]);
-  }
+    reply->set_filed_group_name(field_info.group_name);
+    for (uint32_t i = 0; i < field_info.count; i++) {
+      reply->add_field_ids(field_info.field_ids[i]);
+    }
+  });
 
   return ::grpc::Status::OK;
 }
@@ -291,6 +366,8 @@ RdcAPIServiceImpl::~RdcAPIServiceImpl() {
 ::grpc::Status RdcAPIServiceImpl::DestroyFieldGroup(::grpc::ServerContext* context,
                                                     const ::rdc::DestroyFieldGroupRequest* request,
                                                     ::rdc::DestroyFieldGroupResponse* reply) {
+  RDC_PERF_SCOPE("grpc.DestroyFieldGroup");
+  RDC_PIPELINE_SCOPE("grpc.DestroyFieldGroup");
   (void)(context);
   if (!reply || !request) {
     return ::grpc::Status(::grpc::StatusCode::INTERNAL, "Empty contents");
@@ -305,6 +382,8 @@ RdcAPIServiceImpl::~RdcAPIServiceImpl() {
 ::grpc::Status RdcAPIServiceImpl::WatchFields(::grpc::ServerContext* context,
                                               const ::rdc::WatchFieldsRequest* request,
                                               ::rdc::WatchFieldsResponse* reply) {
+  RDC_PERF_SCOPE("grpc.WatchFields");
+  RDC_PIPELINE_SCOPE("grpc.WatchFields");
   (void)(context);
   if (!reply || !request) {
     return ::grpc::Status(::grpc::StatusCode::INTERNAL, "Empty contents");
@@ -321,30 +400,35 @@ RdcAPIServiceImpl::~RdcAPIServiceImpl() {
 ::grpc::Status RdcAPIServiceImpl::GetLatestFieldValue(
     ::grpc::ServerContext* context, const ::rdc::GetLatestFieldValueRequest* request,
     ::rdc::GetLatestFieldValueResponse* reply) {
+  RDC_PERF_SCOPE("grpc.GetLatestFieldValue");
+  RDC_PIPELINE_SCOPE("grpc.GetLatestFieldValue");
   (void)(context);
   if (!reply || !request) {
     return ::grpc::Status(::grpc::StatusCode::INTERNAL, "Empty contents");
   }
 
-  rdc_field_value value;
-  rdc_status_t result = rdc_field_get_latest_value(
-      rdc_handle_, request->gpu_index(), static_cast<rdc_field_t>(request->field_id()), &value);
-  reply->set_status(result);
-  if (result != RDC_ST_OK) {
-    return ::grpc::Status::OK;
-  }
+  std::pair<uint32_t, uint32_t> key(request->gpu_index(), request->field_id());
+  serve_cached(&latest_value_replies_, key, &key, reply, [&]() {
+    rdc_field_value value;
+    rdc_status_t result = rdc_field_get_latest_value(
+        rdc_handle_, key.first, static_cast<rdc_field_t>(key.second), &value);
+    reply->set_status(result);
+    if (result != RDC_ST_OK) {
+      return;
+    }
 
-  reply->set_field_id(value.field_id);
-  reply->set_rdc_status(value.status);
-  reply->set_ts(value.ts);
-  reply->set_type(static_cast<::rdc::GetLatestFieldValueResponse_FieldType>(value.type));
-  if (value.type == INTEGER) {
-    reply->set_l_int(value.value.l_int);
-  } else if (value.type == DOUBLE) {
-    reply->set_dbl(value.value.dbl);
-  } else if (value.type == STRING || value.type == BLOB) {
-    reply->set_str(value.value.str);
-  }
+    reply->set_field_id(value.field_id);
+    reply->set_rdc_status(value.status);
+    reply->set_ts(value.ts);
+    reply->set_type(static_cast<::rdc::GetLatestFieldValueResponse_FieldType>(value.type));
+    if (value.type == INTEGER) {
+      reply->set_l_int(value.value.l_int);
+    } else if (value.type == DOUBLE) {
+      reply->set_dbl(value.value.dbl);
+    } else if (value.type == STRING || value.type == BLOB) {
+      reply->set_str(value.value.str);
+    }
+  });
 
   return ::grpc::Status::OK;
 }
@@ -352,6 +436,8 @@ RdcAPIServiceImpl::~RdcAPIServiceImpl() {
 ::grpc::Status RdcAPIServiceImpl::GetFieldSince(::grpc::ServerContext* context,
                                                 const ::rdc::GetFieldSinceRequest* request,
                                                 ::rdc::GetFieldSinceResponse* reply) {
+  RDC_PERF_SCOPE("grpc.GetFieldSince");
+  RDC_PIPELINE_SCOPE("grpc.GetFieldSince");
   (void)(context);
   if (!reply || !request) {
     return ::grpc::Status(::grpc::StatusCode::INTERNAL, "Empty contents");
@@ -386,9 +472,500 @@ RdcAPIServiceImpl::~RdcAPIServiceImpl() {
   return ::grpc::Status::OK;
 }
 
+::grpc::Status RdcAPIServiceImpl::GetFieldRollup(::grpc::ServerContext* context,
+                                                 const ::rdc::GetFieldRollupRequest* request,
+                                                 ::rdc::GetFieldRollupResponse* reply) {
+  RDC_PERF_SCOPE("grpc.GetFieldRollup");
+  RDC_PIPELINE_SCOPE("grpc.GetFieldRollup");
+  (void)(context);
+  if (!reply || !request) {
+    return ::grpc::Status(::grpc::StatusCode::INTERNAL, "Empty contents");
+  }
+
+  std::unique_ptr<rdc_field_rollups_t> rollups(new rdc_field_rollups_t);
+  rdc_status_t result = rdc_field_get_rollup(
+      rdc_handle_, request->gpu_index(), static_cast<rdc_field_t>(request->field_id()),
+      request->start_ts(), request->end_ts(), rollups.get());
+  reply->set_status(result);
+  if (result != RDC_ST_OK) {
+    return ::grpc::Status::OK;
+  }
+
+  reply->set_resolution_ms(rollups->resolution_ms);
+  reply->mutable_buckets()->Reserve(rollups->num_buckets);
+  for (uint32_t i = 0; i < rollups->num_buckets; i++) {
+    const rdc_field_rollup_t& src = rollups->buckets[i];
+    ::rdc::FieldRollup* bucket = reply->add_buckets();
+    bucket->set_start_ts(src.start_ts);
+    bucket->set_last_ts(src.last_ts);
+    bucket->set_count(src.count);
+    bucket->set_min_value(src.min_value);
+    bucket->set_max_value(src.max_value);
+    bucket->set_sum(src.sum);
+    bucket->set_last_value(src.last_value);
+  }
+
+  return ::grpc::Status::OK;
+}
+
+namespace {
+
+void copy_field_value(const rdc_field_value& src, ::rdc::GetLatestFieldValueResponse* target) {
+  target->set_field_id(src.field_id);
+  target->set_rdc_status(src.status);
+  target->set_ts(src.ts);
+  target->set_type(static_cast<::rdc::GetLatestFieldValueResponse_FieldType>(src.type));
+  if (src.type == INTEGER) {
+    target->set_l_int(src.value.l_int);
+  } else if (src.type == DOUBLE) {
+    target->set_dbl(src.value.dbl);
+  } else if (src.type == STRING || src.type == BLOB) {
+    target->set_str(src.value.str);
+  }
+}
+
+}  // namespace
+
+::grpc::Status RdcAPIServiceImpl::GetFieldHistory(::grpc::ServerContext* context,
+                                                  const ::rdc::GetFieldHistoryRequest* request,
+                                                  ::rdc::GetFieldHistoryResponse* reply) {
+  RDC_PERF_SCOPE("grpc.GetFieldHistory");
+  RDC_PIPELINE_SCOPE("grpc.GetFieldHistory");
+  (void)(context);
+  if (!reply || !request) {
+    return ::grpc::Status(::grpc::StatusCode::INTERNAL, "Empty contents");
+  }
+
+  std::unique_ptr<rdc_field_history_t> history(new rdc_field_history_t);
+  rdc_status_t result = rdc_field_get_history(
+      rdc_handle_, request->gpu_index(), static_cast<rdc_field_t>(request->field_id()),
+      request->since_ts(), request->until_ts(), history.get());
+  reply->set_status(result);
+  if (result != RDC_ST_OK) {
+    return ::grpc::Status::OK;
+  }
+
+  reply->set_next_since_ts(history->next_since_ts);
+  reply->mutable_values()->Reserve(history->num_values);
+  for (uint32_t i = 0; i < history->num_values; i++) {
+    copy_field_value(history->values[i], reply->add_values());
+  }
+
+  return ::grpc::Status::OK;
+}
+
+::grpc::Status RdcAPIServiceImpl::AddPolicyRule(::grpc::ServerContext* context,
+                                                const ::rdc::AddPolicyRuleRequest* request,
+                                                ::rdc::AddPolicyRuleResponse* reply) {
+  RDC_PERF_SCOPE("grpc.AddPolicyRule");
+  RDC_PIPELINE_SCOPE("grpc.AddPolicyRule");
+  (void)(context);
+  if (!reply || !request) {
+    return ::grpc::Status(::grpc::StatusCode::INTERNAL, "Empty contents");
+  }
+
+  rdc_policy_rule_t rule;
+  rule.gpu_index = request->gpu_index();
+  rule.field_id = static_cast<rdc_field_t>(request->field_id());
+  rule.condition = static_cast<rdc_policy_condition_t>(request->condition());
+  rule.threshold = request->threshold();
+  rule.hysteresis = request->hysteresis();
+  rule.duration_ms = request->duration_ms();
+  uint32_t rule_id = 0;
+  rdc_status_t result = rdc_policy_add_rule(rdc_handle_, &rule, &rule_id);
+  reply->set_status(result);
+  reply->set_rule_id(rule_id);
+
+  return ::grpc::Status::OK;
+}
+
+::grpc::Status RdcAPIServiceImpl::DeletePolicyRule(::grpc::ServerContext* context,
+                                                   const ::rdc::DeletePolicyRuleRequest* request,
+                                                   ::rdc::DeletePolicyRuleResponse* reply) {
+  RDC_PERF_SCOPE("grpc.DeletePolicyRule");
+  RDC_PIPELINE_SCOPE("grpc.DeletePolicyRule");
+  (void)(context);
+  if (!reply || !request) {
+    return ::grpc::Status(::grpc::StatusCode::INTERNAL, "Empty contents");
+  }
+
+  rdc_status_t result = rdc_policy_delete_rule(rdc_handle_, request->rule_id());
+  reply->set_status(result);
+
+  return ::grpc::Status::OK;
+}
+
+namespace {
+
+void copy_policy_violation(const rdc_policy_violation_t& src, ::rdc::PolicyViolation* target) {
+  target->set_seq(src.seq);
+  target->set_rule_id(src.rule_id);
+  target->set_gpu_index(src.gpu_index);
+  target->set_field_id(src.field_id);
+  target->set_ts(src.ts);
+  target->set_value(src.value);
+  target->set_cleared(src.cleared != 0);
+}
+
+}  // namespace
+
+::grpc::Status RdcAPIServiceImpl::GetPolicyViolations(
+    ::grpc::ServerContext* context, const ::rdc::GetPolicyViolationsRequest* request,
+    ::rdc::GetPolicyViolationsResponse* reply) {
+  RDC_PERF_SCOPE("grpc.GetPolicyViolations");
+  RDC_PIPELINE_SCOPE("grpc.GetPolicyViolations");
+  (void)(context);
+  if (!reply || !request) {
+    return ::grpc::Status(::grpc::StatusCode::INTERNAL, "Empty contents");
+  }
+
+  std::unique_ptr<rdc_policy_violations_t> violations(new rdc_policy_violations_t);
+  rdc_status_t result = rdc_policy_get_violations(rdc_handle_, request->since_seq(),
+                                                  request->timeout_ms(), violations.get());
+  reply->set_status(result);
+  if (result != RDC_ST_OK) {
+    return ::grpc::Status::OK;
+  }
+
+  reply->set_num_missed(violations->num_missed);
+  for (uint32_t i = 0; i < violations->num_violations; i++) {
+    copy_policy_violation(violations->violations[i], reply->add_violations());
+  }
+
+  return ::grpc::Status::OK;
+}
+
+::grpc::Status RdcAPIServiceImpl::WatchPolicyViolations(
+    ::grpc::ServerContext* context, const ::rdc::WatchPolicyViolationsRequest* request,
+    ::grpc::ServerWriter<::rdc::PolicyViolation>* writer) {
+  if (!writer || !request) {
+    return ::grpc::Status(::grpc::StatusCode::INTERNAL, "Empty contents");
+  }
+
+  // Wake up every second to notice a cancelled stream
+  const uint32_t kWaitMs = 1000;
+  uint64_t since_seq = request->since_seq();
+  std::unique_ptr<rdc_policy_violations_t> violations(new rdc_policy_violations_t);
+  while (!context->IsCancelled()) {
+    rdc_status_t result =
+        rdc_policy_get_violations(rdc_handle_, since_seq, kWaitMs, violations.get());
+    if (result != RDC_ST_OK) {
+      return ::grpc::Status(::grpc::StatusCode::INTERNAL, rdc_status_string(result));
+    }
+    for (uint32_t i = 0; i < violations->num_violations; i++) {
+      ::rdc::PolicyViolation violation;
+      copy_policy_violation(violations->violations[i], &violation);
+      if (!writer->Write(violation)) {
+        return ::grpc::Status::OK;
+      }
+      since_seq = violations->violations[i].seq;
+    }
+  }
+
+  return ::grpc::Status::OK;
+}
+
+::grpc::Status RdcAPIServiceImpl::SetAnomalyDetector(
+    ::grpc::ServerContext* context, const ::rdc::SetAnomalyDetectorRequest* request,
+    ::rdc::SetAnomalyDetectorResponse* reply) {
+  RDC_PERF_SCOPE("grpc.SetAnomalyDetector");
+  RDC_PIPELINE_SCOPE("grpc.SetAnomalyDetector");
+  (void)(context);
+  if (!reply || !request) {
+    return ::grpc::Status(::grpc::StatusCode::INTERNAL, "Empty contents");
+  }
+
+  rdc_anomaly_config_t config;
+  config.field_id = static_cast<rdc_field_t>(request->field_id());
+  config.alpha = request->alpha();
+  config.threshold = request->threshold();
+  config.warmup_samples = request->warmup_samples();
+  config.season_period_s = request->season_period_s();
+  rdc_status_t result = rdc_anomaly_set_detector(rdc_handle_, request->detector_id(), &config);
+  reply->set_status(result);
+
+  return ::grpc::Status::OK;
+}
+
+::grpc::Status RdcAPIServiceImpl::ClearAnomalyDetector(
+    ::grpc::ServerContext* context, const ::rdc::ClearAnomalyDetectorRequest* request,
+    ::rdc::ClearAnomalyDetectorResponse* reply) {
+  RDC_PERF_SCOPE("grpc.ClearAnomalyDetector");
+  RDC_PIPELINE_SCOPE("grpc.ClearAnomalyDetector");
+  (void)(context);
+  if (!reply || !request) {
+    return ::grpc::Status(::grpc::StatusCode::INTERNAL, "Empty contents");
+  }
+
+  rdc_status_t result = rdc_anomaly_clear_detector(rdc_handle_, request->detector_id());
+  reply->set_status(result);
+
+  return ::grpc::Status::OK;
+}
+
+::grpc::Status RdcAPIServiceImpl::SetDerivedField(::grpc::ServerContext* context,
+                                                  const ::rdc::SetDerivedFieldRequest* request,
+                                                  ::rdc::SetDerivedFieldResponse* reply) {
+  RDC_PERF_SCOPE("grpc.SetDerivedField");
+  RDC_PIPELINE_SCOPE("grpc.SetDerivedField");
+  (void)(context);
+  if (!reply || !request) {
+    return ::grpc::Status(::grpc::StatusCode::INTERNAL, "Empty contents");
+  }
+
+  rdc_status_t result =
+      rdc_field_derived_set(rdc_handle_, static_cast<rdc_field_t>(request->field_id()),
+                            request->expression().c_str());
+  reply->set_status(result);
+
+  return ::grpc::Status::OK;
+}
+
+::grpc::Status RdcAPIServiceImpl::ClearDerivedField(::grpc::ServerContext* context,
+                                                    const ::rdc::ClearDerivedFieldRequest* request,
+                                                    ::rdc::ClearDerivedFieldResponse* reply) {
+  RDC_PERF_SCOPE("grpc.ClearDerivedField");
+  RDC_PIPELINE_SCOPE("grpc.ClearDerivedField");
+  (void)(context);
+  if (!reply || !request) {
+    return ::grpc::Status(::grpc::StatusCode::INTERNAL, "Empty contents");
+  }
+
+  rdc_status_t result =
+      rdc_field_derived_clear(rdc_handle_, static_cast<rdc_field_t>(request->field_id()));
+  reply->set_status(result);
+
+  return ::grpc::Status::OK;
+}
+
+::grpc::Status RdcAPIServiceImpl::StreamFieldValues(
+    ::grpc::ServerContext* context, const ::rdc::StreamFieldValuesRequest* request,
+    ::grpc::ServerWriter<::rdc::FieldValueBatch>* writer) {
+  if (!writer || !request) {
+    return ::grpc::Status(::grpc::StatusCode::INTERNAL, "Empty contents");
+  }
+  if (request->field_ids_size() == 0 ||
+      request->field_ids_size() > RDC_MAX_FIELD_IDS_PER_FIELD_GROUP) {
+    return ::grpc::Status(::grpc::StatusCode::INVALID_ARGUMENT,
+                          rdc_status_string(RDC_ST_BAD_PARAMETER));
+  }
+
+  // Each stream watches its fields in its own groups, so the streams come
+  // and go independently
+  static std::atomic<uint32_t> next_stream(0);
+  std::string name = "rdcd_stream_" + std::to_string(next_stream++);
+  std::vector<rdc_field_t> field_ids;
+  for (uint32_t field_id : request->field_ids()) {
+    field_ids.push_back(static_cast<rdc_field_t>(field_id));
+  }
+  const uint64_t kDefaultUpdateFreq = 1000000;
+  uint64_t update_freq = request->update_freq() ? request->update_freq() : kDefaultUpdateFreq;
+
+  rdc_gpu_group_t group_id;
+  rdc_status_t result =
+      rdc_group_gpu_create(rdc_handle_, RDC_GROUP_DEFAULT, name.c_str(), &group_id);
+  if (result != RDC_ST_OK) {
+    return ::grpc::Status(::grpc::StatusCode::INTERNAL, rdc_status_string(result));
+  }
+  rdc_field_grp_t field_group_id;
+  result = rdc_group_field_create(rdc_handle_, field_ids.size(), field_ids.data(), name.c_str(),
+                                  &field_group_id);
+  if (result == RDC_ST_OK) {
+    // Only the latest sample is streamed, keep a few periods of them
+    const uint32_t kKeepPeriods = 4;
+    result = rdc_field_watch(rdc_handle_, group_id, field_group_id, update_freq,
+                             kKeepPeriods * update_freq / 1000000.0, kKeepPeriods);
+    if (result == RDC_ST_OK) {
+      result = write_field_values(context, writer, group_id, field_ids, update_freq);
+      rdc_field_unwatch(rdc_handle_, group_id, field_group_id);
+    }
+    rdc_group_field_destroy(rdc_handle_, field_group_id);
+  }
+  rdc_group_gpu_destroy(rdc_handle_, group_id);
+
+  if (result != RDC_ST_OK) {
+    return ::grpc::Status(::grpc::StatusCode::INTERNAL, rdc_status_string(result));
+  }
+  return ::grpc::Status::OK;
+}
+
+rdc_status_t RdcAPIServiceImpl::write_field_values(
+    ::grpc::ServerContext* context, ::grpc::ServerWriter<::rdc::FieldValueBatch>* writer,
+    rdc_gpu_group_t group_id, const std::vector<rdc_field_t>& field_ids, uint64_t update_freq) {
+  rdc_group_info_t ginfo;
+  rdc_status_t result = rdc_group_gpu_get_info(rdc_handle_, group_id, &ginfo);
+  if (result != RDC_ST_OK) {
+    return result;
+  }
+
+  // The timestamp of the last sample sent, per GPU and field
+  std::vector<uint64_t> sent_ts(ginfo.count * field_ids.size(), 0);
+  ::rdc::FieldValueBatch batch;
+  auto next = std::chrono::steady_clock::now();
+  while (!context->IsCancelled()) {
+    // Wake up every second to notice a cancelled stream
+    next += std::chrono::microseconds(update_freq);
+    auto now = std::chrono::steady_clock::now();
+    while (now < next && !context->IsCancelled()) {
+      std::this_thread::sleep_until(std::min(next, now + std::chrono::seconds(1)));
+      now = std::chrono::steady_clock::now();
+    }
+
+    batch.Clear();
+    for (uint32_t g = 0; g < ginfo.count; g++) {
+      for (size_t f = 0; f < field_ids.size(); f++) {
+        rdc_field_value value;
+        uint64_t& last_ts = sent_ts[g * field_ids.size() + f];
+        if (rdc_field_get_latest_value(rdc_handle_, ginfo.entity_ids[g], field_ids[f], &value) !=
+                RDC_ST_OK ||
+            value.ts <= last_ts) {
+          continue;
+        }
+        last_ts = value.ts;
+        ::rdc::StreamedFieldValue* streamed = batch.add_values();
+        streamed->set_gpu_index(ginfo.entity_ids[g]);
+        copy_field_value(value, streamed->mutable_value());
+      }
+    }
+    // Also written when empty, so the client sees the stream is alive
+    if (!writer->Write(batch)) {
+      break;
+    }
+  }
+  return RDC_ST_OK;
+}
+
+::grpc::Status RdcAPIServiceImpl::GetAggregateHosts(::grpc::ServerContext* context,
+                                                    const ::rdc::Empty* request,
+                                                    ::rdc::GetAggregateHostsResponse* reply) {
+  RDC_PERF_SCOPE("grpc.GetAggregateHosts");
+  RDC_PIPELINE_SCOPE("grpc.GetAggregateHosts");
+  (void)(context);
+  if (!reply || !request) {
+    return ::grpc::Status(::grpc::StatusCode::INTERNAL, "Empty contents");
+  }
+  if (!aggregator_) {
+    reply->set_status(RDC_ST_NOT_SUPPORTED);
+    return ::grpc::Status::OK;
+  }
+
+  std::unique_ptr<rdc_aggregate_hosts_t> hosts(new rdc_aggregate_hosts_t);
+  rdc_status_t result = aggregator_->get_hosts(hosts.get());
+  reply->set_status(result);
+  if (result != RDC_ST_OK) {
+    return ::grpc::Status::OK;
+  }
+
+  for (uint32_t i = 0; i < hosts->num_hosts; i++) {
+    const rdc_aggregate_host_t& src = hosts->hosts[i];
+    ::rdc::AggregateHost* host = reply->add_hosts();
+    host->set_host(src.host);
+    host->set_host_id(src.host_id);
+    host->set_gpu_base(src.gpu_base);
+    host->set_connected(src.connected);
+    host->set_num_gpus(src.num_gpus);
+    host->set_last_sample_ts(src.last_sample_ts);
+    host->set_num_samples(src.num_samples);
+    host->set_num_reconnects(src.num_reconnects);
+  }
+
+  return ::grpc::Status::OK;
+}
+
+::grpc::Status RdcAPIServiceImpl::GetClusterAggregate(
+    ::grpc::ServerContext* context, const ::rdc::GetClusterAggregateRequest* request,
+    ::rdc::GetClusterAggregateResponse* reply) {
+  RDC_PERF_SCOPE("grpc.GetClusterAggregate");
+  RDC_PIPELINE_SCOPE("grpc.GetClusterAggregate");
+  (void)(context);
+  if (!reply || !request) {
+    return ::grpc::Status(::grpc::StatusCode::INTERNAL, "Empty contents");
+  }
+  if (!aggregator_) {
+    reply->set_status(RDC_ST_NOT_SUPPORTED);
+    return ::grpc::Status::OK;
+  }
+
+  if (request->op() > RDC_AGGREGATE_MAX) {
+    reply->set_status(RDC_ST_BAD_PARAMETER);
+    return ::grpc::Status::OK;
+  }
+
+  rdc_cluster_aggregate_t aggregate;
+  rdc_status_t result = aggregator_->get_field(static_cast<rdc_field_t>(request->field_id()),
+                                               static_cast<rdc_aggregate_op_t>(request->op()),
+                                               &aggregate);
+  reply->set_status(result);
+  if (result != RDC_ST_OK) {
+    return ::grpc::Status::OK;
+  }
+
+  reply->set_value(aggregate.value);
+  reply->set_num_gpus(aggregate.num_gpus);
+  reply->set_gpu_index(aggregate.gpu_index);
+  reply->set_host_id(aggregate.host_id);
+  reply->set_ts(aggregate.ts);
+  return ::grpc::Status::OK;
+}
+
+::grpc::Status RdcAPIServiceImpl::GetGroupAggregate(::grpc::ServerContext* context,
+                                                    const ::rdc::GetGroupAggregateRequest* request,
+                                                    ::rdc::GetGroupAggregateResponse* reply) {
+  RDC_PERF_SCOPE("grpc.GetGroupAggregate");
+  RDC_PIPELINE_SCOPE("grpc.GetGroupAggregate");
+  (void)(context);
+  if (!reply || !request) {
+    return ::grpc::Status(::grpc::StatusCode::INTERNAL, "Empty contents");
+  }
+
+  if (request->specs_size() > RDC_MAX_GROUP_AGGREGATE_OPS) {
+    reply->set_status(RDC_ST_BAD_PARAMETER);
+    return ::grpc::Status::OK;
+  }
+  rdc_aggregate_spec_t specs[RDC_MAX_GROUP_AGGREGATE_OPS];
+  for (int i = 0; i < request->specs_size(); i++) {
+    specs[i].op = static_cast<rdc_aggregate_op_t>(request->specs(i).op());
+    specs[i].percentile = request->specs(i).percentile();
+    // Written so that a NaN percentile is rejected too
+    if (specs[i].op > RDC_AGGREGATE_PERCENTILE ||
+        (specs[i].op == RDC_AGGREGATE_PERCENTILE &&
+         !(specs[i].percentile >= 0 && specs[i].percentile <= 100))) {
+      reply->set_status(RDC_ST_BAD_PARAMETER);
+      return ::grpc::Status::OK;
+    }
+  }
+
+  std::unique_ptr<rdc_group_aggregate_t> aggregate(new rdc_group_aggregate_t);
+  rdc_status_t result = rdc_field_get_group_aggregate(
+      rdc_handle_, request->group_id(), request->field_group_id(), request->window_ms(), specs,
+      request->specs_size(), aggregate.get());
+  reply->set_status(result);
+  if (result != RDC_ST_OK) {
+    return ::grpc::Status::OK;
+  }
+
+  reply->mutable_values()->Reserve(aggregate->num_values);
+  for (uint32_t i = 0; i < aggregate->num_values; i++) {
+    const rdc_group_aggregate_value_t& src = aggregate->values[i];
+    ::rdc::GroupAggregateValue* value = reply->add_values();
+    value->set_field_id(src.field_id);
+    value->mutable_spec()->set_op(src.spec.op);
+    value->mutable_spec()->set_percentile(src.spec.percentile);
+    value->set_status(src.status);
+    value->set_value(src.value);
+    value->set_num_gpus(src.num_gpus);
+    value->set_num_samples(src.num_samples);
+    value->set_gpu_index(src.gpu_index);
+    value->set_ts(src.ts);
+  }
+  return ::grpc::Status::OK;
+}
+
 ::grpc::Status RdcAPIServiceImpl::UnWatchFields(::grpc::ServerContext* context,
                                                 const ::rdc::UnWatchFieldsRequest* request,
                                                 ::rdc::UnWatchFieldsResponse* reply) {
+  RDC_PERF_SCOPE("grpc.UnWatchFields");
+  RDC_PIPELINE_SCOPE("grpc.UnWatchFields");
   (void)(context);
   if (!reply || !request) {
     return ::grpc::Status(::grpc::StatusCode::INTERNAL, "Empty contents");
@@ -404,6 +981,8 @@ RdcAPIServiceImpl::~RdcAPIServiceImpl() {
 ::grpc::Status RdcAPIServiceImpl::UpdateAllFields(::grpc::ServerContext* context,
                                                   const ::rdc::UpdateAllFieldsRequest* request,
                                                   ::rdc::UpdateAllFieldsResponse* reply) {
+  RDC_PERF_SCOPE("grpc.UpdateAllFields");
+  RDC_PIPELINE_SCOPE("grpc.UpdateAllFields");
   (void)(context);
   if (!reply || !request) {
     return ::grpc::Status(::grpc::StatusCode::INTERNAL, "Empty contents");
@@ -418,6 +997,8 @@ RdcAPIServiceImpl::~RdcAPIServiceImpl() {
 ::grpc::Status RdcAPIServiceImpl::StartJobStats(::grpc::ServerContext* context,
                                                 const ::rdc::StartJobStatsRequest* request,
                                                 ::rdc::StartJobStatsResponse* reply) {
+  RDC_PERF_SCOPE("grpc.StartJobStats");
+  RDC_PIPELINE_SCOPE("grpc.StartJobStats");
   (void)(context);
   if (!reply || !request) {
     return ::grpc::Status(::grpc::StatusCode::INTERNAL, "Empty contents");
@@ -433,6 +1014,8 @@ RdcAPIServiceImpl::~RdcAPIServiceImpl() {
 ::grpc::Status RdcAPIServiceImpl::GetJobStats(::grpc::ServerContext* context,
                                               const ::rdc::GetJobStatsRequest* request,
                                               ::rdc::GetJobStatsResponse* reply) {
+  RDC_PERF_SCOPE("grpc.GetJobStats");
+  RDC_PIPELINE_SCOPE("grpc.GetJobStats");
   (void)(context);
   if (!reply || !request) {
     return ::grpc::Status(::grpc::StatusCode::INTERNAL, "Empty contents");
@@ -459,6 +1042,21 @@ RdcAPIServiceImpl::~RdcAPIServiceImpl() {
   return ::grpc::Status::OK;
 }
 
+namespace {
+
+void copy_stats_summary(const rdc_stats_summary_t& src, ::rdc::JobStatsSummary* target) {
+  target->set_max_value(src.max_value);
+  target->set_min_value(src.min_value);
+  target->set_average(src.average);
+  target->set_standard_deviation(src.standard_deviation);
+  target->set_p50(src.p50);
+  target->set_p90(src.p90);
+  target->set_p95(src.p95);
+  target->set_p99(src.p99);
+}
+
+}  // namespace
+
 bool RdcAPIServiceImpl::copy_gpu_usage_info(const rdc_gpu_usage_info_t& src,
                                             ::rdc::GpuUsageInfo* target) {
   if (target == nullptr) {
@@ -473,53 +1071,14 @@ bool RdcAPIServiceImpl::copy_gpu_usage_info(const rdc_gpu_usage_info_t& src,
   target->set_ecc_correct(src.ecc_correct);
   target->set_ecc_uncorrect(src.ecc_uncorrect);
 
-  ::rdc::JobStatsSummary* stats = target->mutable_power_usage();
-  stats->set_max_value(src.power_usage.max_value);
-  stats->set_min_value(src.power_usage.min_value);
-  stats->set_average(src.power_usage.average);
-  stats->set_standard_deviation(src.power_usage.standard_deviation);
-
-  stats = target->mutable_gpu_clock();
-  stats->set_max_value(src.gpu_clock.max_value);
-  stats->set_min_value(src.gpu_clock.min_value);
-  stats->set_average(src.gpu_clock.average);
-  stats->set_standard_deviation(src.gpu_clock.standard_deviation);
-
-  stats = target->mutable_gpu_utilization();
-  stats->set_max_value(src.gpu_utilization.max_value);
-  stats->set_min_value(src.gpu_utilization.min_value);
-  stats->set_average(src.gpu_utilization.average);
-  stats->set_standard_deviation(src.gpu_utilization.standard_deviation);
-
-  stats = target->mutable_memory_utilization();
-  stats->set_max_value(src.memory_utilization.max_value);
-  stats->set_min_value(src.memory_utilization.min_value);
-  stats->set_average(src.memory_utilization.average);
-  stats->set_standard_deviation(src.memory_utilization.standard_deviation);
-
-  stats = target->mutable_pcie_tx();
-  stats->set_max_value(src.pcie_tx.max_value);
-  stats->set_min_value(src.pcie_tx.min_value);
-  stats->set_average(src.pcie_tx.average);
-  stats->set_standard_deviation(src.pcie_tx.standard_deviation);
-
-  stats = target->mutable_pcie_rx();
-  stats->set_max_value(src.pcie_rx.max_value);
-  stats->set_min_value(src.pcie_rx.min_value);
-  stats->set_average(src.pcie_rx.average);
-  stats->set_standard_deviation(src.pcie_rx.standard_deviation);
-
-  stats = target->mutable_memory_clock();
-  stats->set_max_value(src.memory_clock.max_value);
-  stats->set_min_value(src.memory_clock.min_value);
-  stats->set_average(src.memory_clock.average);
-  stats->set_standard_deviation(src.memory_clock.standard_deviation);
-
-  stats = target->mutable_gpu_temperature();
-  stats->set_max_value(src.gpu_temperature.max_value);
-  stats->set_min_value(src.gpu_temperature.min_value);
-  stats->set_average(src.gpu_temperature.average);
-  stats->set_standard_deviation(src.gpu_temperature.standard_deviation);
+  copy_stats_summary(src.power_usage, target->mutable_power_usage());
+  copy_stats_summary(src.gpu_clock, target->mutable_gpu_clock());
+  copy_stats_summary(src.gpu_utilization, target->mutable_gpu_utilization());
+  copy_stats_summary(src.memory_utilization, target->mutable_memory_utilization());
+  copy_stats_summary(src.pcie_tx, target->mutable_pcie_tx());
+  copy_stats_summary(src.pcie_rx, target->mutable_pcie_rx());
+  copy_stats_summary(src.memory_clock, target->mutable_memory_clock());
+  copy_stats_summary(src.gpu_temperature, target->mutable_gpu_temperature());
 
   return true;
 }
@@ -527,6 +1086,8 @@ bool RdcAPIServiceImpl::copy_gpu_usage_info(const rdc_gpu_usage_info_t& src,
 ::grpc::Status RdcAPIServiceImpl::StopJobStats(::grpc::ServerContext* context,
                                                const ::rdc::StopJobStatsRequest* request,
                                                ::rdc::StopJobStatsResponse* reply) {
+  RDC_PERF_SCOPE("grpc.StopJobStats");
+  RDC_PIPELINE_SCOPE("grpc.StopJobStats");
   (void)(context);
   if (!reply || !request) {
     return ::grpc::Status(::grpc::StatusCode::INTERNAL, "Empty contents");
@@ -539,9 +1100,79 @@ bool RdcAPIServiceImpl::copy_gpu_usage_info(const rdc_gpu_usage_info_t& src,
   return ::grpc::Status::OK;
 }
 
+::grpc::Status RdcAPIServiceImpl::GetJobTimeline(::grpc::ServerContext* context,
+                                                 const ::rdc::GetJobTimelineRequest* request,
+                                                 ::rdc::GetJobTimelineResponse* reply) {
+  RDC_PERF_SCOPE("grpc.GetJobTimeline");
+  RDC_PIPELINE_SCOPE("grpc.GetJobTimeline");
+  (void)(context);
+  if (!reply || !request) {
+    return ::grpc::Status(::grpc::StatusCode::INTERNAL, "Empty contents");
+  }
+
+  std::unique_ptr<rdc_job_timeline_t> timeline(new rdc_job_timeline_t);
+  rdc_status_t result = rdc_job_get_timeline(
+      rdc_handle_, const_cast<char*>(request->job_id().c_str()), request->gpu_index(),
+      static_cast<rdc_field_t>(request->field_id()), timeline.get());
+  reply->set_status(result);
+  if (result != RDC_ST_OK) {
+    return ::grpc::Status::OK;
+  }
+
+  reply->set_bucket_ms(timeline->bucket_ms);
+  for (uint32_t i = 0; i < timeline->num_points; i++) {
+    const rdc_timeline_point_t& src = timeline->points[i];
+    ::rdc::TimelinePoint* point = reply->add_points();
+    point->set_start_ts(src.start_ts);
+    point->set_count(src.count);
+    point->set_min_value(src.min_value);
+    point->set_max_value(src.max_value);
+    point->set_average(src.average);
+  }
+
+  return ::grpc::Status::OK;
+}
+
+::grpc::Status RdcAPIServiceImpl::ListJobs(::grpc::ServerContext* context,
+                                           const ::rdc::ListJobsRequest* request,
+                                           ::rdc::ListJobsResponse* reply) {
+  RDC_PERF_SCOPE("grpc.ListJobs");
+  RDC_PIPELINE_SCOPE("grpc.ListJobs");
+  (void)(context);
+  if (!reply || !request) {
+    return ::grpc::Status(::grpc::StatusCode::INTERNAL, "Empty contents");
+  }
+
+  rdc_job_filter_t filter;
+  filter.start_since = request->start_since();
+  filter.start_until = request->start_until();
+  filter.field_id = static_cast<rdc_field_t>(request->field_id());
+  filter.min_average = request->min_average();
+  filter.max_average = request->max_average();
+  filter.cursor = request->cursor();
+  std::unique_ptr<rdc_job_list_t> jobs(new rdc_job_list_t);
+  rdc_status_t result = rdc_job_list(rdc_handle_, &filter, jobs.get());
+  reply->set_status(result);
+  if (result != RDC_ST_OK) {
+    return ::grpc::Status::OK;
+  }
+
+  reply->set_next_cursor(jobs->next_cursor);
+  for (uint32_t i = 0; i < jobs->num_jobs; i++) {
+    ::rdc::JobRecord* job = reply->add_jobs();
+    job->set_job_id(jobs->jobs[i].job_id);
+    job->set_num_gpus(jobs->jobs[i].num_gpus);
+    copy_gpu_usage_info(jobs->jobs[i].summary, job->mutable_summary());
+  }
+
+  return ::grpc::Status::OK;
+}
+
 ::grpc::Status RdcAPIServiceImpl::RemoveJob(::grpc::ServerContext* context,
                                             const ::rdc::RemoveJobRequest* request,
                                             ::rdc::RemoveJobResponse* reply) {
+  RDC_PERF_SCOPE("grpc.RemoveJob");
+  RDC_PIPELINE_SCOPE("grpc.RemoveJob");
   (void)(context);
   if (!reply || !request) {
     return ::grpc::Status(::grpc::StatusCode::INTERNAL, "Empty contents");
@@ -555,6 +1186,8 @@ bool RdcAPIServiceImpl::copy_gpu_usage_info(const rdc_gpu_usage_info_t& src,
 ::grpc::Status RdcAPIServiceImpl::RemoveAllJob(::grpc::ServerContext* context,
                                                const ::rdc::Empty* request,
                                                ::rdc::RemoveAllJobResponse* reply) {
+  RDC_PERF_SCOPE("grpc.RemoveAllJob");
+  RDC_PIPELINE_SCOPE("grpc.RemoveAllJob");
   (void)(context);
   if (!reply || !request) {
     return ::grpc::Status(::grpc::StatusCode::INTERNAL, "Empty contents");
@@ -568,6 +1201,8 @@ bool RdcAPIServiceImpl::copy_gpu_usage_info(const rdc_gpu_usage_info_t& src,
 ::grpc::Status RdcAPIServiceImpl::DiagnosticRun(::grpc::ServerContext* context,
                                                 const ::rdc::DiagnosticRunRequest* request,
                                                 ::rdc::DiagnosticRunResponse* reply) {
+  RDC_PERF_SCOPE("grpc.DiagnosticRun");
+  RDC_PIPELINE_SCOPE("grpc.DiagnosticRun");
   (void)(context);
   if (!reply || !request) {
     return ::grpc::Status(::grpc::StatusCode::INTERNAL, "Empty contents");
@@ -620,6 +1255,8 @@ bool RdcAPIServiceImpl::copy_gpu_usage_info(const rdc_gpu_usage_info_t& src,
 ::grpc::Status RdcAPIServiceImpl::DiagnosticTestCaseRun(
     ::grpc::ServerContext* context, const ::rdc::DiagnosticTestCaseRunRequest* request,
     ::rdc::DiagnosticTestCaseRunResponse* reply) {
+  RDC_PERF_SCOPE("grpc.DiagnosticTestCaseRun");
+  RDC_PIPELINE_SCOPE("grpc.DiagnosticTestCaseRun");
   (void)(context);
   if (!reply || !request) {
     return ::grpc::Status(::grpc::StatusCode::INTERNAL, "Empty contents");
@@ -664,6 +1301,8 @@ bool RdcAPIServiceImpl::copy_gpu_usage_info(const rdc_gpu_usage_info_t& src,
 ::grpc::Status RdcAPIServiceImpl::GetMixedComponentVersion(::grpc::ServerContext* context,
                                                 const ::rdc::GetMixedComponentVersionRequest* request,
                                                 ::rdc::GetMixedComponentVersionResponse* reply) {
+  RDC_PERF_SCOPE("grpc.GetMixedComponentVersion");
+  RDC_PIPELINE_SCOPE("grpc.GetMixedComponentVersion");
   (void)(context);
   if (!reply) {
     return ::grpc::Status(::grpc::StatusCode::INTERNAL, "Empty reply");
@@ -0,0 +1,546 @@
+/*
+Copyright (c) 2024 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "rdc/rdc_metrics_server.h"
+
+#include <netdb.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <set>
+#include <sstream>
+
+#include "common/rdc_fields_supported.h"
+#include "common/rdc_perf_histogram.h"
+#include "rdc_lib/RdcLogger.h"
+
+namespace amd {
+namespace rdc {
+
+namespace {
+
+const char* kGroupName = "rdcd_metrics";
+const uint64_t kDefaultUpdateFreqMs = 1000;
+const double kMaxKeepAge = 60;
+const uint32_t kMaxKeepSamples = 60;
+// A GPU whose latest sample is older than this many update periods is not
+// reported, rather than repeating a stale value
+const uint64_t kStalePeriods = 10;
+const size_t kMaxRequestSize = 8192;
+// A connection is dropped when its scrape is not done by then
+const uint64_t kRequestTimeoutMs = 2000;
+// Past this many scrapes in flight, the new ones wait in the listen backlog
+const size_t kMaxConnections = 64;
+
+// The fields of python_binding/rdc_prometheus.py
+const rdc_field_t kDefaultFields[] = {
+    RDC_FI_GPU_MEMORY_USAGE, RDC_FI_GPU_MEMORY_TOTAL,   RDC_FI_POWER_USAGE,
+    RDC_FI_GPU_CLOCK,        RDC_FI_GPU_UTIL,           RDC_FI_GPU_TEMP,
+    RDC_FI_PROF_ACTIVE_CYCLES, RDC_FI_PROF_ACTIVE_WAVES,
+};
+
+bool is_label_name(const std::string& name) {
+  if (name.empty() || std::isdigit(static_cast<unsigned char>(name[0]))) {
+    return false;
+  }
+  return std::all_of(name.begin(), name.end(),
+                     [](unsigned char c) { return std::isalnum(c) || c == '_'; });
+}
+
+std::string escape_label(const std::string& value) {
+  std::string escaped;
+  for (char c : value) {
+    if (c == '\\' || c == '"') {
+      escaped += '\\';
+      escaped += c;
+    } else if (c == '\n') {
+      escaped += "\\n";
+    } else {
+      escaped += c;
+    }
+  }
+  return escaped;
+}
+
+// "name=value,name=value", added to every series
+std::string static_labels() {
+  const char* env = getenv("RDC_METRICS_LABELS");
+  if (env == nullptr) {
+    return "";
+  }
+  std::string labels;
+  std::stringstream ss(env);
+  std::string item;
+  while (std::getline(ss, item, ',')) {
+    size_t eq = item.find('=');
+    if (eq == std::string::npos || !is_label_name(item.substr(0, eq))) {
+      RDC_LOG(RDC_ERROR, "Ignore the metrics label \"" << item << "\"");
+      continue;
+    }
+    labels += "," + item.substr(0, eq) + "=\"" + escape_label(item.substr(eq + 1)) + "\"";
+  }
+  return labels;
+}
+
+std::vector<rdc_field_t> fields_from_env() {
+  const char* env = getenv("RDC_METRICS_FIELDS");
+  if (env == nullptr) {
+    return std::vector<rdc_field_t>(std::begin(kDefaultFields), std::end(kDefaultFields));
+  }
+  std::vector<rdc_field_t> field_ids;
+  std::string names(env);
+  std::replace(names.begin(), names.end(), ',', ' ');
+  std::stringstream ss(names);
+  std::string name;
+  while (ss >> name) {
+    rdc_field_t field_id;
+    if (!get_field_id_from_name(name, &field_id)) {
+      RDC_LOG(RDC_ERROR, "Ignore the unknown metrics field " << name);
+      continue;
+    }
+    if (std::find(field_ids.begin(), field_ids.end(), field_id) == field_ids.end()) {
+      field_ids.push_back(field_id);
+    }
+  }
+  return field_ids;
+}
+
+void append_value(std::string* out, const rdc_field_value& value) {
+  char buf[32];
+  if (value.type == INTEGER) {
+    auto res = std::to_chars(buf, buf + sizeof(buf), value.value.l_int);
+    out->append(buf, res.ptr - buf);
+  } else if (std::isnan(value.value.dbl)) {
+    out->append("NaN");
+  } else if (std::isinf(value.value.dbl)) {
+    out->append(value.value.dbl > 0 ? "+Inf" : "-Inf");
+  } else {
+    int len = snprintf(buf, sizeof(buf), "%.15g", value.value.dbl);
+    out->append(buf, len);
+  }
+}
+
+void status_response(const char* status, std::string* response) {
+  *response = std::string("HTTP/1.1 ") + status +
+              "\r\nContent-Type: text/plain\r\nContent-Length: " +
+              std::to_string(strlen(status) + 1) + "\r\nConnection: close\r\n\r\n" + status +
+              "\n";
+}
+
+uint64_t now_ms() {
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return static_cast<uint64_t>(tv.tv_sec) * 1000 + tv.tv_usec / 1000;
+}
+
+}  // namespace
+
+RdcMetricsServer::RdcMetricsServer(rdc_handle_t rdc_handle)
+    : rdc_handle_(rdc_handle),
+      gpu_group_(0),
+      field_group_(0),
+      watching_(false),
+      update_freq_ms_(kDefaultUpdateFreqMs),
+      listen_fd_(-1),
+      wake_fd_{-1, -1},
+      connections_(kMaxConnections),
+      zstream_(),
+      zstream_ready_(false) {
+  for (Connection& conn : connections_) {
+    conn.fd = -1;
+    conn.deadline = 0;
+    conn.sent = 0;
+  }
+}
+
+RdcMetricsServer::~RdcMetricsServer() {
+  stop();
+  if (zstream_ready_) {
+    deflateEnd(&zstream_);
+  }
+}
+
+rdc_status_t RdcMetricsServer::start(const std::string& address, const std::string& port) {
+  const char* freq = getenv("RDC_METRICS_UPDATE_FREQ");
+  if (freq != nullptr && strtoull(freq, nullptr, 10) > 0) {
+    update_freq_ms_ = strtoull(freq, nullptr, 10);
+  }
+
+  rdc_status_t result = watch_fields();
+  if (result != RDC_ST_OK) {
+    return result;
+  }
+
+  listen_fd_ = listen_on(address, port);
+  if (listen_fd_ < 0 || pipe(wake_fd_) != 0) {
+    stop();
+    return RDC_ST_CONFLICT;
+  }
+  thread_ = std::thread(&RdcMetricsServer::serve, this);
+  RDC_LOG(RDC_INFO, "Serve the metrics of " << families_.size() << " fields on " << address
+                                            << ":" << port << "/metrics");
+  return RDC_ST_OK;
+}
+
+void RdcMetricsServer::stop() {
+  if (thread_.joinable()) {
+    char c = 0;
+    if (write(wake_fd_[1], &c, 1) != 1) {
+      RDC_LOG(RDC_ERROR, "Fail to wake up the metrics server");
+    }
+    thread_.join();
+  }
+  for (int* fd : {&listen_fd_, &wake_fd_[0], &wake_fd_[1]}) {
+    if (*fd >= 0) {
+      close(*fd);
+      *fd = -1;
+    }
+  }
+  if (watching_) {
+    rdc_field_unwatch(rdc_handle_, gpu_group_, field_group_);
+    rdc_group_field_destroy(rdc_handle_, field_group_);
+    rdc_group_gpu_destroy(rdc_handle_, gpu_group_);
+    watching_ = false;
+  }
+}
+
+rdc_status_t RdcMetricsServer::watch_fields() {
+  std::vector<rdc_field_t> field_ids = fields_from_env();
+  if (field_ids.empty()) {
+    RDC_LOG(RDC_ERROR, "No valid field in RDC_METRICS_FIELDS");
+    return RDC_ST_BAD_PARAMETER;
+  }
+  if (field_ids.size() > RDC_MAX_FIELD_IDS_PER_FIELD_GROUP) {
+    RDC_LOG(RDC_ERROR, "Only the first " << RDC_MAX_FIELD_IDS_PER_FIELD_GROUP
+                                         << " metrics fields are served");
+    field_ids.resize(RDC_MAX_FIELD_IDS_PER_FIELD_GROUP);
+  }
+
+  rdc_status_t result =
+      rdc_group_gpu_create(rdc_handle_, RDC_GROUP_DEFAULT, kGroupName, &gpu_group_);
+  if (result != RDC_ST_OK) {
+    return result;
+  }
+  result = rdc_group_field_create(rdc_handle_, field_ids.size(), field_ids.data(), kGroupName,
+                                  &field_group_);
+  if (result != RDC_ST_OK) {
+    rdc_group_gpu_destroy(rdc_handle_, gpu_group_);
+    return result;
+  }
+  result = rdc_field_watch(rdc_handle_, gpu_group_, field_group_, update_freq_ms_ * 1000,
+                           kMaxKeepAge, kMaxKeepSamples);
+  if (result != RDC_ST_OK) {
+    rdc_group_field_destroy(rdc_handle_, field_group_);
+    rdc_group_gpu_destroy(rdc_handle_, gpu_group_);
+    return result;
+  }
+  watching_ = true;
+
+  rdc_group_info_t ginfo;
+  result = rdc_group_gpu_get_info(rdc_handle_, gpu_group_, &ginfo);
+  if (result != RDC_ST_OK) {
+    return result;
+  }
+  gpu_indexes_.assign(ginfo.entity_ids, ginfo.entity_ids + ginfo.count);
+  build_families(field_ids);
+  return RDC_ST_OK;
+}
+
+void RdcMetricsServer::build_families(const std::vector<rdc_field_t>& field_ids) {
+  std::string labels = static_labels();
+  std::vector<std::string> gpu_labels;
+  for (uint32_t gpu_index : gpu_indexes_) {
+    rdc_device_attributes_t attr;
+    std::string device;
+    if (rdc_device_get_attributes(rdc_handle_, gpu_index, &attr) == RDC_ST_OK) {
+      device = ",device=\"" + escape_label(attr.device_name) + "\"";
+    }
+    gpu_labels.push_back("{gpu_index=\"" + std::to_string(gpu_index) + "\"" + device + labels +
+                         "} ");
+  }
+
+  fld_id2name_map_t& descriptions = get_field_id_description_from_id();
+  std::set<std::string> names;
+  for (rdc_field_t field_id : field_ids) {
+    auto desc = descriptions.find(field_id);
+    // Same names as the rdc_prometheus.py exporter
+    std::string name = get_field_metric_name(desc->second.label);
+    // Two labels may only differ by the characters replaced
+    if (!names.insert(name).second) {
+      name = get_field_metric_name(desc->second.enum_name);
+      names.insert(name);
+    }
+    Family family;
+    family.field_id = field_id;
+    family.header = "# HELP " + name + " " + desc->second.description + "\n# TYPE " + name +
+                    " gauge\n";
+    for (const std::string& gpu_label : gpu_labels) {
+      family.series.push_back(name + gpu_label);
+    }
+    families_.push_back(std::move(family));
+  }
+}
+
+int RdcMetricsServer::listen_on(const std::string& address, const std::string& port) {
+  struct addrinfo hints = {};
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  hints.ai_flags = AI_PASSIVE;
+  struct addrinfo* addrs = nullptr;
+  int ret = getaddrinfo(address.c_str(), port.c_str(), &hints, &addrs);
+  if (ret != 0) {
+    RDC_LOG(RDC_ERROR, "Fail to resolve the metrics address " << address << ":" << port << ": "
+                                                              << gai_strerror(ret));
+    return -1;
+  }
+
+  int fd = -1;
+  for (struct addrinfo* a = addrs; a != nullptr; a = a->ai_next) {
+    fd = socket(a->ai_family, a->ai_socktype | SOCK_NONBLOCK | SOCK_CLOEXEC, a->ai_protocol);
+    if (fd < 0) {
+      continue;
+    }
+    int on = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    if (bind(fd, a->ai_addr, a->ai_addrlen) == 0 && listen(fd, SOMAXCONN) == 0) {
+      break;
+    }
+    close(fd);
+    fd = -1;
+  }
+  freeaddrinfo(addrs);
+  if (fd < 0) {
+    RDC_LOG(RDC_ERROR, "Fail to listen for the metrics on " << address << ":" << port << ": "
+                                                            << strerror(errno));
+  }
+  return fd;
+}
+
+void RdcMetricsServer::serve() {
+  std::vector<struct pollfd> fds;
+  std::vector<Connection*> polled;
+  while (true) {
+    uint64_t now = now_ms();
+    fds.clear();
+    polled.clear();
+    fds.push_back({wake_fd_[0], POLLIN, 0});
+    bool full = true;
+    int timeout = -1;
+    for (Connection& conn : connections_) {
+      if (conn.fd >= 0 && conn.deadline <= now) {
+        close_connection(&conn);
+      }
+      if (conn.fd < 0) {
+        full = false;
+        continue;
+      }
+      int left = static_cast<int>(conn.deadline - now);
+      timeout = timeout < 0 ? left : std::min(timeout, left);
+      fds.push_back({conn.fd, static_cast<short>(conn.response.empty() ? POLLIN : POLLOUT), 0});
+      polled.push_back(&conn);
+    }
+    if (!full) {
+      fds.push_back({listen_fd_, POLLIN, 0});
+    }
+
+    if (poll(fds.data(), fds.size(), timeout) < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      RDC_LOG(RDC_ERROR, "Fail to poll the metrics socket: " << strerror(errno));
+      break;
+    }
+    if (fds[0].revents != 0) {
+      break;
+    }
+    for (size_t i = 0; i < polled.size(); i++) {
+      if (fds[i + 1].revents == 0) {
+        continue;
+      }
+      Connection* conn = polled[i];
+      bool open = conn->response.empty() ? read_request(conn) : write_response(conn);
+      if (!open) {
+        close_connection(conn);
+      }
+    }
+    if (!full && (fds.back().revents & POLLIN)) {
+      accept_connections(now);
+    }
+  }
+
+  for (Connection& conn : connections_) {
+    if (conn.fd >= 0) {
+      close_connection(&conn);
+    }
+  }
+}
+
+void RdcMetricsServer::accept_connections(uint64_t now) {
+  for (Connection& conn : connections_) {
+    if (conn.fd >= 0) {
+      continue;
+    }
+    conn.fd = accept4(listen_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (conn.fd < 0) {
+      return;
+    }
+    conn.deadline = now + kRequestTimeoutMs;
+  }
+}
+
+void RdcMetricsServer::close_connection(Connection* conn) {
+  close(conn->fd);
+  conn->fd = -1;
+  conn->request.clear();
+  conn->response.clear();
+  conn->sent = 0;
+}
+
+bool RdcMetricsServer::read_request(Connection* conn) {
+  char buf[kMaxRequestSize];
+  ssize_t n = recv(conn->fd, buf, kMaxRequestSize - conn->request.size(), 0);
+  if (n <= 0) {
+    return n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR);
+  }
+  conn->request.append(buf, n);
+
+  // Only the request line and the headers matter, a scrape has no body
+  if (conn->request.find("\r\n\r\n") == std::string::npos &&
+      conn->request.size() < kMaxRequestSize) {
+    return true;
+  }
+  build_response(conn);
+  return write_response(conn);
+}
+
+bool RdcMetricsServer::write_response(Connection* conn) {
+  while (conn->sent < conn->response.size()) {
+    ssize_t n = send(conn->fd, conn->response.data() + conn->sent,
+                     conn->response.size() - conn->sent, MSG_NOSIGNAL);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+    }
+    conn->sent += n;
+  }
+  return false;
+}
+
+void RdcMetricsServer::build_response(Connection* conn) {
+  std::string& request = conn->request;
+  std::transform(request.begin(), request.end(), request.begin(),
+                 [](unsigned char c) { return std::tolower(c); });
+
+  bool head = request.compare(0, 5, "head ") == 0;
+  if (request.compare(0, 4, "get ") != 0 && !head) {
+    status_response("405 Method Not Allowed", &conn->response);
+    return;
+  }
+  size_t path_start = request.find(' ') + 1;
+  size_t path_end = request.find_first_of(" ?", path_start);
+  std::string path = request.substr(path_start, path_end - path_start);
+  if (path != "/metrics") {
+    status_response("404 Not Found", &conn->response);
+    return;
+  }
+
+  render();
+  size_t encoding = request.find("\r\naccept-encoding:");
+  bool gzip = encoding != std::string::npos &&
+              request.find("gzip", encoding) < request.find("\r\n", encoding + 2) &&
+              gzip_body();
+  const std::string& body = gzip ? gzip_ : body_;
+  std::string& response = conn->response;
+  response = "HTTP/1.1 200 OK\r\nContent-Type: text/plain; version=0.0.4; charset=utf-8\r\n";
+  if (gzip) {
+    response += "Content-Encoding: gzip\r\n";
+  }
+  response += "Content-Length: ";
+  response += std::to_string(body.size());
+  response += "\r\nConnection: close\r\n\r\n";
+  if (!head) {
+    response += body;
+  }
+}
+
+void RdcMetricsServer::render() {
+  RDC_PERF_SCOPE("metrics.render");
+  body_.clear();
+
+  uint64_t now = now_ms();
+  uint64_t stale_ms = kStalePeriods * update_freq_ms_;
+
+  for (const Family& family : families_) {
+    body_ += family.header;
+    for (size_t i = 0; i < gpu_indexes_.size(); i++) {
+      rdc_field_value value;
+      if (rdc_field_get_latest_value(rdc_handle_, gpu_indexes_[i], family.field_id, &value) !=
+              RDC_ST_OK ||
+          value.status != RDC_ST_OK || (value.type != INTEGER && value.type != DOUBLE) ||
+          value.ts + stale_ms < now) {
+        continue;
+      }
+      body_ += family.series[i];
+      append_value(&body_, value);
+      body_ += '\n';
+    }
+  }
+}
+
+bool RdcMetricsServer::gzip_body() {
+  RDC_PERF_SCOPE("metrics.gzip");
+  int ret;
+  if (zstream_ready_) {
+    ret = deflateReset(&zstream_);
+  } else {
+    // 16 more window bits ask for the gzip wrapper instead of zlib's
+    ret = deflateInit2(&zstream_, Z_BEST_SPEED, Z_DEFLATED, MAX_WBITS + 16, 8, Z_DEFAULT_STRATEGY);
+    zstream_ready_ = ret == Z_OK;
+  }
+  if (ret != Z_OK) {
+    return false;
+  }
+
+  gzip_.resize(deflateBound(&zstream_, body_.size()));
+  zstream_.next_in = reinterpret_cast<Bytef*>(&body_[0]);
+  zstream_.avail_in = body_.size();
+  zstream_.next_out = reinterpret_cast<Bytef*>(&gzip_[0]);
+  zstream_.avail_out = gzip_.size();
+  if (deflate(&zstream_, Z_FINISH) != Z_STREAM_END) {
+    return false;
+  }
+  gzip_.resize(zstream_.total_out);
+  return true;
+}
+
+}  // namespace rdc
+}  // namespace amd
@@ -27,6 +27,7 @@ THE SOFTWARE.
 #include <grpcpp/grpcpp.h>
 #include <pthread.h>
 #include <pwd.h>
+#include <stdlib.h>
 #include <sys/capability.h>
 #include <sys/resource.h>
 #include <sys/stat.h>
@@ -43,6 +44,7 @@ THE SOFTWARE.
 #include "common/rdc_utils.h"
 #include "rdc.grpc.pb.h"  // NOLINT
 #include "rdc/rdc_api_service.h"
+#include "rdc_lib/RdcPipelineTrace.h"
 
 // TODO(cfreehil):
 // The following need to be made configurable (e.g., from YAML):
@@ -56,6 +58,8 @@ THE SOFTWARE.
 
 static bool sShutDownServer = false;
 static bool sRestartServer = false;
+static bool sTogglePipelineTrace = false;
+static const char* kDefaultPipelineTraceFile = "/tmp/rdcd_pipeline_trace.json";
 static const char* kDaemonName = "rdcd";
 static const char* kRDCDHomeDir = "/";
 static const char* kDaemonLockFileRoot = "/var/run/rdcd.lock";
@@ -75,7 +79,12 @@ static const char* kDefaultListenAddress = "0.0.0.0";
 static const char* kDefaultListenPort = "50051";
 static const uint32_t kRSMIUMask = 027;
 
-RDCServer::RDCServer() : secure_creds_(false), rdc_admin_service_(nullptr) {}
+RDCServer::RDCServer()
+    : secure_creds_(false),
+      rdc_admin_service_(nullptr),
+      api_service_(nullptr),
+      metrics_server_(nullptr),
+      aggregator_(nullptr) {}
 
 RDCServer::~RDCServer() {}
 
@@ -198,12 +207,39 @@ void RDCServer::Run() {
     builder.RegisterService(api_service_);
 
     // TODO(bill_liu): pass flags from cnfg file
-    rdc_status_t ret = api_service_->Initialize(0);
+    rdc_status_t ret =
+        api_service_->Initialize(cmd_line_->fake_smi ? RDC_INIT_FLAG_FAKE_SMI : RDC_INIT_FLAG_NONE);
 
     if (ret != RDC_ST_OK) {
       std::cerr << "Failed to start API service" << std::endl;
       return;
     }
+
+    if (rdc_admin_service_) {
+      rdc_admin_service_->set_rdc_handle(api_service_->rdc_handle());
+    }
+
+    if (!cmd_line_->metrics_port.empty()) {
+      metrics_server_ = new amd::rdc::RdcMetricsServer(api_service_->rdc_handle());
+      rdc_status_t result =
+          metrics_server_->start(cmd_line_->listen_address, cmd_line_->metrics_port);
+      if (result != RDC_ST_OK) {
+        std::cerr << "Failed to serve the metrics on port " << cmd_line_->metrics_port
+                  << std::endl;
+        return;
+      }
+    }
+
+    if (!cmd_line_->aggregate_hosts.empty()) {
+      aggregator_ = new amd::rdc::RdcAggregator(api_service_->rdc_handle());
+      rdc_status_t result = aggregator_->start(cmd_line_->aggregate_hosts, secure_creds_);
+      if (result != RDC_ST_OK) {
+        std::cerr << "Failed to aggregate the rdcd listed in " << cmd_line_->aggregate_hosts
+                  << std::endl;
+        return;
+      }
+      api_service_->set_aggregator(aggregator_);
+    }
   }
 
   // Finally assemble the server.
@@ -226,6 +262,11 @@ static void HandleSignal(int sig) {
       sShutDownServer = true;
       break;
 
+    // Start a pipeline trace, or stop it and write it out
+    case SIGUSR2:
+      sTogglePipelineTrace = true;
+      break;
+
       // Grpc doesn't seem to handle stopping and restarting well, so
       // user must manually do these steps
       //    case SIGHUP:
@@ -241,6 +282,7 @@ static void InitializeSignalHandling(void) {
   // signal(SIGHUP, HandleSignal);
   signal(SIGINT, HandleSignal);
   signal(SIGTERM, HandleSignal);
+  signal(SIGUSR2, HandleSignal);
 }
 
 static int FileOwner(const char* fn, std::string* owner) {
@@ -273,6 +315,17 @@ static int FileOwner(const char* fn, std::string* owner) {
 void RDCServer::ShutDown(void) {
   server_->Shutdown();
 
+  // Before the API service, which owns the RDC handle they read from
+  if (metrics_server_) {
+    delete metrics_server_;
+    metrics_server_ = nullptr;
+  }
+
+  if (aggregator_) {
+    delete aggregator_;
+    aggregator_ = nullptr;
+  }
+
   if (rdc_admin_service_) {
     delete rdc_admin_service_;
     rdc_admin_service_ = nullptr;
@@ -304,6 +357,25 @@ static void* ProcessSignalLoop(void* server_ptr) {
 
       sRestartServer = false;
     }
+    if (sTogglePipelineTrace) {
+      sTogglePipelineTrace = false;
+      amd::rdc::RdcPipelineTrace& trace = amd::rdc::RdcPipelineTrace::get_instance();
+      if (!amd::rdc::RdcPipelineTrace::enabled()) {
+        trace.set_enabled(true);
+        std::cout << "Pipeline trace started." << std::endl;
+      } else {
+        trace.set_enabled(false);
+        const char* path = getenv("RDC_PIPELINE_TRACE_FILE");
+        if (path == nullptr) {
+          path = kDefaultPipelineTraceFile;
+        }
+        if (trace.dump_chrome_json(path) == RDC_ST_OK) {
+          std::cout << "Pipeline trace written to " << path << std::endl;
+        } else {
+          std::cerr << "Failed to write the pipeline trace to " << path << std::endl;
+        }
+      }
+    }
     sleep(1);
   }
 
@@ -471,16 +543,19 @@ static void MakeDaemon(bool is_root) {
 //  * no_argument
 static const struct option long_options[] = {{"address", required_argument, nullptr, 'a'},
                                              {"port", required_argument, nullptr, 'p'},
+                                             {"metrics_port", required_argument, nullptr, 'm'},
+                                             {"aggregate", required_argument, nullptr, 'g'},
                                              // Any options with optionals args would go here; e.g.,
                                              // {"start_rdcd", optional_argument, nullptr, 'd'},
                                              {"unauth_comm", no_argument, nullptr, 'u'},
                                              {"pinned_cert", no_argument, nullptr, 'i'},
                                              {"debug", no_argument, nullptr, 'd'},
+                                             {"fake_smi", no_argument, nullptr, 'f'},
                                              {"version", no_argument, nullptr, 'v'},
                                              {"help", no_argument, nullptr, 'h'},
 
                                              {nullptr, 0, nullptr, 0}};
-static const char* short_options = "a:p:uidvh";
+static const char* short_options = "a:p:m:g:uidfvh";
 
 static void PrintHelp(void) {
   std::cout << "Optional rdctst Arguments:\n"
@@ -488,12 +563,20 @@ static void PrintHelp(void) {
                "default is 0.0.0.0\n"
                "--port, -p <port> specify port on which to listen; "
                "default is to listen on port 50051\n"
+               "--metrics_port, -m <port> also serve the watched fields in the "
+               "Prometheus format on http://<address>:<port>/metrics. See "
+               "RDC_METRICS_* environment variables\n"
+               "--aggregate, -g <file> also stream the fields of the rdcd "
+               "listed in the file, one <host>:<port> per line. See "
+               "RDC_AGGREGATE_* environment variables\n"
                "--unauth_comm, -u don't do authentication with communications"
                " with client. When this flag is not specified, by default, "
                "PKI authentication is used\n"
                "--pinned_cert, -i used \"pinned\" certificates instead of PKI "
                "authentication. This is for test purposes.\n"
                "--debug, -d output debug messages\n"
+               "--fake_smi, -f collect from simulated GPUs instead of "
+               "amd_smi_lib. See RDC_FAKE_SMI_* environment variables\n"
                "--version, -v Output version information\n"
                "--help, -h print this message\n";
 }
@@ -528,6 +611,26 @@ uint32_t ProcessCmdline(RdcdCmdLineOpts* cmdl_opts, int arg_cnt, char** arg_list
         cmdl_opts->listen_port = optarg;
         break;
 
+      case 'm':
+        if (!amd::rdc::IsNumber(optarg)) {
+          std::cerr << "\"" << optarg << "\" is not a valid port number." << std::endl;
+          return -1;
+        }
+        cmdl_opts->metrics_port = optarg;
+        break;
+
+      case 'g': {
+        // rdcd changes its directory when it becomes a daemon
+        char* path = realpath(optarg, nullptr);
+        if (path == nullptr) {
+          std::cerr << "\"" << optarg << "\" does not exist." << std::endl;
+          return -1;
+        }
+        cmdl_opts->aggregate_hosts = path;
+        free(path);
+        break;
+      }
+
       case 'u':
         cmdl_opts->no_authentication = true;
         break;
@@ -540,6 +643,10 @@ uint32_t ProcessCmdline(RdcdCmdLineOpts* cmdl_opts, int arg_cnt, char** arg_list
         cmdl_opts->log_dbg = true;
         break;
 
+      case 'f':
+        cmdl_opts->fake_smi = true;
+        break;
+
       case 'v':
 #ifdef CURRENT_GIT_HASH
         std::cout << "RDCD : " << RDC_SERVER_VERSION_STRING << "+" << QUOTE(CURRENT_GIT_HASH) << std::endl;
@@ -571,9 +678,12 @@ static void init_cmd_line_opts(RdcdCmdLineOpts* opts) {
   assert(opts != nullptr);
   opts->listen_address = kDefaultListenAddress;
   opts->listen_port = kDefaultListenPort;
+  opts->metrics_port = "";
+  opts->aggregate_hosts = "";
   opts->no_authentication = false;
   opts->use_pinned_certs = false;
   opts->log_dbg = false;
+  opts->fake_smi = false;
 }
 
 int main(int argc, char** argv) {
@@ -0,0 +1,128 @@
+/*
+Copyright (c) 2024 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include <benchmark/benchmark.h>
+
+#include "rdc_bench/bench_common.h"
+#include "rdc_lib/impl/RdcCacheManagerImpl.h"
+
+using amd::rdc::RdcCacheManagerImpl;
+
+namespace {
+
+const uint32_t kGpus = 8;
+const rdc_field_t kFields[] = {RDC_FI_GPU_MEMORY_USAGE, RDC_FI_POWER_USAGE, RDC_FI_GPU_CLOCK,
+                               RDC_FI_GPU_UTIL,         RDC_FI_PCIE_TX,     RDC_FI_PCIE_RX,
+                               RDC_FI_MEM_CLOCK,        RDC_FI_GPU_TEMP};
+const uint32_t kNumFields = sizeof(kFields) / sizeof(kFields[0]);
+
+// Samples older than this are never evicted by age in these benchmarks
+const double kKeepAge = 3600;
+
+// Fill every (gpu, field) of the cache with `depth` samples, 1 ms apart
+void fill_cache(RdcCacheManagerImpl* cache, int64_t depth, uint64_t first_ts) {
+  for (int64_t s = 0; s < depth; s++) {
+    for (uint32_t g = 0; g < kGpus; g++) {
+      for (uint32_t f = 0; f < kNumFields; f++) {
+        cache->rdc_update_cache(g, rdc_bench::make_value(kFields[f], s, first_ts + s));
+      }
+    }
+  }
+}
+
+}  // namespace
+
+static void BM_CacheUpdate(benchmark::State& state) {
+  RdcCacheManagerImpl cache;
+  uint64_t ts = rdc_bench::now_ms();
+  for (auto _ : state) {
+    for (uint32_t g = 0; g < kGpus; g++) {
+      for (uint32_t f = 0; f < kNumFields; f++) {
+        cache.rdc_update_cache(g, rdc_bench::make_value(kFields[f], ts, ts));
+      }
+    }
+    ts++;
+    // Keep the cache at the requested depth like the watch table does
+    if (ts % state.range(0) == 0) {
+      state.PauseTiming();
+      for (uint32_t g = 0; g < kGpus; g++) {
+        for (uint32_t f = 0; f < kNumFields; f++) {
+          cache.evict_cache(g, kFields[f], state.range(0), kKeepAge);
+        }
+      }
+      state.ResumeTiming();
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kGpus * kNumFields);
+}
+BENCHMARK(BM_CacheUpdate)->Arg(16)->Arg(1024)->Arg(65536);
+
+static void BM_CacheGetLatest(benchmark::State& state) {
+  RdcCacheManagerImpl cache;
+  fill_cache(&cache, state.range(0), rdc_bench::now_ms() - state.range(0));
+  rdc_field_value value;
+  uint32_t i = 0;
+  for (auto _ : state) {
+    cache.rdc_field_get_latest_value(i % kGpus, kFields[i % kNumFields], &value);
+    benchmark::DoNotOptimize(value);
+    i++;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CacheGetLatest)->Arg(16)->Arg(1024)->Arg(65536);
+
+// Query from the middle of the history, as a client polling with
+// next_since_time_stamp would
+static void BM_CacheGetSince(benchmark::State& state) {
+  RdcCacheManagerImpl cache;
+  uint64_t first_ts = rdc_bench::now_ms() - state.range(0);
+  fill_cache(&cache, state.range(0), first_ts);
+  rdc_field_value value;
+  uint64_t next_ts;
+  uint32_t i = 0;
+  for (auto _ : state) {
+    cache.rdc_field_get_value_since(i % kGpus, kFields[i % kNumFields],
+                                    first_ts + state.range(0) / 2, &next_ts, &value);
+    benchmark::DoNotOptimize(value);
+    i++;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CacheGetSince)->Arg(16)->Arg(1024)->Arg(65536);
+
+// Top up every field by 10% and evict back to the depth
+static void BM_CacheEvict(benchmark::State& state) {
+  RdcCacheManagerImpl cache;
+  fill_cache(&cache, state.range(0), rdc_bench::now_ms());
+  uint64_t keep = state.range(0);
+  for (auto _ : state) {
+    state.PauseTiming();
+    fill_cache(&cache, state.range(0) / 10, rdc_bench::now_ms());
+    state.ResumeTiming();
+    for (uint32_t g = 0; g < kGpus; g++) {
+      for (uint32_t f = 0; f < kNumFields; f++) {
+        cache.evict_cache(g, kFields[f], keep, kKeepAge);
+      }
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kGpus * kNumFields);
+}
+BENCHMARK(BM_CacheEvict)->Arg(16)->Arg(1024)->Arg(65536);
@@ -0,0 +1,127 @@
+/*
+Copyright (c) 2024 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#ifndef TESTS_RDC_BENCH_BENCH_COMMON_H_
+#define TESTS_RDC_BENCH_BENCH_COMMON_H_
+
+#include <sys/time.h>
+
+#include <memory>
+#include <vector>
+
+#include "rdc/rdc.h"
+#include "rdc_lib/RdcModuleMgr.h"
+#include "rdc_lib/RdcNotification.h"
+#include "rdc_lib/RdcTelemetry.h"
+
+namespace rdc_bench {
+
+inline uint64_t now_ms() {
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return static_cast<uint64_t>(tv.tv_sec) * 1000 + tv.tv_usec / 1000;
+}
+
+inline rdc_field_value make_value(rdc_field_t field_id, int64_t v, uint64_t ts) {
+  rdc_field_value value;
+  value.field_id = field_id;
+  value.status = RDC_ST_OK;
+  value.ts = ts;
+  value.type = INTEGER;
+  value.value.l_int = v;
+  return value;
+}
+
+//!< Telemetry module which answers every field with a constant, so that the
+//!< benchmarks measure RDC itself rather than amd_smi_lib.
+class MockTelemetry : public amd::rdc::RdcTelemetry {
+ public:
+  MockTelemetry(uint32_t first_field, uint32_t num_fields)
+      : first_field_(first_field), num_fields_(num_fields) {}
+
+  rdc_status_t rdc_telemetry_fields_query(uint32_t field_ids[MAX_NUM_FIELDS],
+                                          uint32_t* field_count) override {
+    *field_count = 0;
+    for (uint32_t i = 0; i < num_fields_ && i < MAX_NUM_FIELDS; i++) {
+      field_ids[(*field_count)++] = first_field_ + i;
+    }
+    return RDC_ST_OK;
+  }
+
+  rdc_status_t rdc_telemetry_fields_value_get(rdc_gpu_field_t* fields, uint32_t fields_count,
+                                              rdc_field_value_f callback,
+                                              void* user_data) override {
+    const uint32_t kChunk = 16;  // Same batching as RdcSmiLib
+    rdc_gpu_field_value_t values[kChunk];
+    uint64_t ts = now_ms();
+    uint32_t n = 0;
+    for (uint32_t i = 0; i < fields_count; i++) {
+      values[n].gpu_index = fields[i].gpu_index;
+      values[n].field_value = make_value(fields[i].field_id, i, ts);
+      if (++n == kChunk) {
+        callback(values, n, user_data);
+        n = 0;
+      }
+    }
+    if (n) {
+      callback(values, n, user_data);
+    }
+    return RDC_ST_OK;
+  }
+
+  rdc_status_t rdc_telemetry_fields_watch(rdc_gpu_field_t*, uint32_t) override {
+    return RDC_ST_OK;
+  }
+  rdc_status_t rdc_telemetry_fields_unwatch(rdc_gpu_field_t*, uint32_t) override {
+    return RDC_ST_OK;
+  }
+
+ private:
+  uint32_t first_field_;
+  uint32_t num_fields_;
+};
+
+class MockNotification : public amd::rdc::RdcNotification {
+ public:
+  bool is_notification_event(rdc_field_t) const override { return false; }
+  rdc_status_t set_listen_events(const std::vector<RdcFieldKey>) override {
+    return RDC_ST_OK;
+  }
+  rdc_status_t listen(amd::rdc::rdc_evnt_notification_t*, uint32_t* num_events, uint32_t) override {
+    *num_events = 0;
+    return RDC_ST_OK;
+  }
+  rdc_status_t stop_listening(uint32_t) override { return RDC_ST_OK; }
+};
+
+class MockModuleMgr : public amd::rdc::RdcModuleMgr {
+ public:
+  explicit MockModuleMgr(const amd::rdc::RdcTelemetryPtr& telemetry) : telemetry_(telemetry) {}
+  amd::rdc::RdcTelemetryPtr get_telemetry_module() override { return telemetry_; }
+  amd::rdc::RdcDiagnosticPtr get_diagnostic_module() override { return nullptr; }
+
+ private:
+  amd::rdc::RdcTelemetryPtr telemetry_;
+};
+
+}  // namespace rdc_bench
+
+#endif  // TESTS_RDC_BENCH_BENCH_COMMON_H_
@@ -0,0 +1,92 @@
+/*
+Copyright (c) 2024 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include <benchmark/benchmark.h>
+
+#include <string>
+
+#include "rdc_bench/bench_common.h"
+#include "rdc_lib/impl/RdcCacheManagerImpl.h"
+#include "rdc_lib/impl/RdcGroupSettingsImpl.h"
+
+using amd::rdc::JOB_FIELD_ID;
+using amd::rdc::RdcCacheManagerImpl;
+using amd::rdc::RdcGroupSettingsImpl;
+
+namespace {
+
+// Start state.range(0) jobs, each over its own 8 GPUs
+void start_jobs(RdcCacheManagerImpl* cache, int64_t num_jobs) {
+  RdcGroupSettingsImpl group_settings;
+  rdc_field_group_info_t finfo;
+  group_settings.rdc_group_field_get_info(JOB_FIELD_ID, &finfo);
+
+  rdc_gpu_gauges_t gauges;
+  for (int64_t j = 0; j < num_jobs; j++) {
+    rdc_group_info_t ginfo;
+    ginfo.count = 8;
+    for (uint32_t g = 0; g < ginfo.count; g++) {
+      ginfo.entity_ids[g] = (j * ginfo.count + g) % RDC_MAX_NUM_DEVICES;
+    }
+    std::string job_id = "job" + std::to_string(j);
+    cache->rdc_job_start_stats(job_id.c_str(), ginfo, finfo, gauges);
+  }
+}
+
+}  // namespace
+
+// Ingest one sample of every job field, as handle_fields does for watched
+// job fields
+static void BM_JobStatsIngest(benchmark::State& state) {
+  RdcCacheManagerImpl cache;
+  start_jobs(&cache, state.range(0));
+  RdcGroupSettingsImpl group_settings;
+  rdc_field_group_info_t finfo;
+  group_settings.rdc_group_field_get_info(JOB_FIELD_ID, &finfo);
+
+  std::string job_id = "job" + std::to_string(state.range(0) / 2);
+  uint32_t gpu_index = (state.range(0) / 2 * 8) % RDC_MAX_NUM_DEVICES;
+  uint64_t ts = rdc_bench::now_ms();
+  for (auto _ : state) {
+    for (uint32_t f = 0; f < finfo.count; f++) {
+      cache.rdc_update_job_stats(gpu_index, job_id,
+                                 rdc_bench::make_value(finfo.field_ids[f], ts % 100, ts));
+    }
+    ts++;
+  }
+  state.SetItemsProcessed(state.iterations() * finfo.count);
+}
+BENCHMARK(BM_JobStatsIngest)->Arg(1)->Arg(16)->Arg(256);
+
+static void BM_JobStatsGet(benchmark::State& state) {
+  RdcCacheManagerImpl cache;
+  start_jobs(&cache, state.range(0));
+  rdc_gpu_gauges_t gauges;
+  for (uint32_t g = 0; g < RDC_MAX_NUM_DEVICES; g++) {
+    gauges[{g, RDC_FI_GPU_MEMORY_TOTAL}] = 64ULL << 30;
+  }
+  rdc_job_info_t job_info;
+  for (auto _ : state) {
+    cache.rdc_job_get_stats("job0", gauges, &job_info);
+    benchmark::DoNotOptimize(job_info);
+  }
+}
+BENCHMARK(BM_JobStatsGet)->Arg(1)->Arg(256);
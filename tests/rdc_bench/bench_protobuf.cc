@@ -0,0 +1,123 @@
+/*
+Copyright (c) 2024 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include <benchmark/benchmark.h>
+
+#include <string>
+
+#include "rdc.pb.h"  // NOLINT
+
+namespace {
+
+void fill_summary(::rdc::JobStatsSummary* s, uint64_t base) {
+  s->set_max_value(base + 100);
+  s->set_min_value(base);
+  s->set_average(base + 50);
+  s->set_standard_deviation(12.5);
+  s->set_p50(base + 48);
+  s->set_p90(base + 85);
+  s->set_p95(base + 92);
+  s->set_p99(base + 98);
+}
+
+void fill_usage(::rdc::GpuUsageInfo* info, uint32_t gpu) {
+  info->set_gpu_id(gpu);
+  info->set_start_time(1700000000000ULL);
+  info->set_end_time(1700003600000ULL);
+  info->set_energy_consumed(123456789);
+  fill_summary(info->mutable_power_usage(), 300);
+  fill_summary(info->mutable_gpu_clock(), 1700);
+  fill_summary(info->mutable_gpu_utilization(), 0);
+  info->set_max_gpu_memory_used(64ULL << 30);
+  fill_summary(info->mutable_memory_utilization(), 0);
+  info->set_ecc_correct(1);
+  info->set_ecc_uncorrect(0);
+  fill_summary(info->mutable_pcie_tx(), 1000000);
+  fill_summary(info->mutable_pcie_rx(), 1000000);
+  fill_summary(info->mutable_memory_clock(), 1600);
+  fill_summary(info->mutable_gpu_temperature(), 40);
+}
+
+// A GetJobStatsResponse over the maximum of 16 GPUs of rdc_job_info_t
+void fill_job_stats(::rdc::GetJobStatsResponse* reply) {
+  const uint32_t kJobGpus = 16;
+  reply->set_status(0);
+  reply->set_num_gpus(kJobGpus);
+  fill_usage(reply->mutable_summary(), 0);
+  for (uint32_t g = 0; g < kJobGpus; g++) {
+    fill_usage(reply->add_gpus(), g);
+  }
+}
+
+// A DiagnosticRunResponse with every test case failing on every GPU
+void fill_diagnostic(::rdc::DiagnosticRunResponse* reply) {
+  const uint32_t kTestCases = 8;
+  const uint32_t kDiagGpus = 32;
+  reply->set_status(0);
+  auto response = reply->mutable_response();
+  response->set_results_count(kTestCases);
+  for (uint32_t t = 0; t < kTestCases; t++) {
+    auto info = response->add_diag_info();
+    info->set_status(1);
+    info->set_test_case(static_cast<::rdc::DiagnosticTestResult::DiagnosticTestCase>(t));
+    info->mutable_details()->set_msg(std::string(128, 'x'));
+    info->set_per_gpu_result_count(kDiagGpus);
+    for (uint32_t g = 0; g < kDiagGpus; g++) {
+      auto r = info->add_gpu_results();
+      r->set_gpu_index(g);
+      r->mutable_gpu_result()->set_msg(std::string(64, 'y'));
+      r->mutable_gpu_result()->set_code(1);
+    }
+    info->set_info(std::string(256, 'z'));
+  }
+}
+
+template <typename T, void (*Fill)(T*)>
+void BM_Serialize(benchmark::State& state) {
+  std::string out;
+  for (auto _ : state) {
+    T reply;
+    Fill(&reply);
+    reply.SerializeToString(&out);
+    benchmark::DoNotOptimize(out);
+  }
+  state.SetBytesProcessed(state.iterations() * out.size());
+}
+
+template <typename T, void (*Fill)(T*)>
+void BM_Parse(benchmark::State& state) {
+  T reply;
+  Fill(&reply);
+  std::string in = reply.SerializeAsString();
+  for (auto _ : state) {
+    T parsed;
+    parsed.ParseFromString(in);
+    benchmark::DoNotOptimize(parsed);
+  }
+  state.SetBytesProcessed(state.iterations() * in.size());
+}
+
+}  // namespace
+
+BENCHMARK_TEMPLATE(BM_Serialize, ::rdc::GetJobStatsResponse, fill_job_stats);
+BENCHMARK_TEMPLATE(BM_Parse, ::rdc::GetJobStatsResponse, fill_job_stats);
+BENCHMARK_TEMPLATE(BM_Serialize, ::rdc::DiagnosticRunResponse, fill_diagnostic);
+BENCHMARK_TEMPLATE(BM_Parse, ::rdc::DiagnosticRunResponse, fill_diagnostic);
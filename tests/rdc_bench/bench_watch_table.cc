@@ -0,0 +1,127 @@
+/*
+Copyright (c) 2024 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rdc_bench/bench_common.h"
+#include "rdc_lib/impl/RdcCacheManagerImpl.h"
+#include "rdc_lib/impl/RdcGroupSettingsImpl.h"
+#include "rdc_lib/impl/RdcTelemetryModule.h"
+#include "rdc_lib/impl/RdcWatchTableImpl.h"
+
+using amd::rdc::RdcCacheManagerImpl;
+using amd::rdc::RdcGroupSettingsImpl;
+using amd::rdc::RdcTelemetryModule;
+using amd::rdc::RdcTelemetryPtr;
+using amd::rdc::RdcWatchTableImpl;
+
+namespace {
+
+const uint32_t kGpus = RDC_GROUP_MAX_ENTITIES;
+const uint32_t kFirstField = 1;
+
+rdc_status_t count_values(rdc_gpu_field_value_t*, uint32_t num_values, void* user_data) {
+  *static_cast<uint64_t*>(user_data) += num_values;
+  return RDC_ST_OK;
+}
+
+}  // namespace
+
+// rdc_field_update_all() over state.range(0) watched (gpu, field) pairs:
+// one group of kGpus GPUs and enough field groups to reach the pair count.
+// The watches use a zero update interval, so every pair is fetched from the
+// mock telemetry module and written to the cache on each call.
+static void BM_WatchTableUpdateAll(benchmark::State& state) {
+  uint32_t num_fields = std::max<uint32_t>(1, state.range(0) / kGpus);
+  auto group_settings = std::make_shared<RdcGroupSettingsImpl>();
+  auto cache_mgr = std::make_shared<RdcCacheManagerImpl>();
+  RdcTelemetryPtr telemetry = std::make_shared<rdc_bench::MockTelemetry>(kFirstField, num_fields);
+  auto module_mgr = std::make_shared<rdc_bench::MockModuleMgr>(telemetry);
+  auto notif = std::make_shared<rdc_bench::MockNotification>();
+  RdcWatchTableImpl watch_table(group_settings, cache_mgr, module_mgr, notif, nullptr, nullptr,
+                                nullptr, nullptr);
+
+  rdc_gpu_group_t group_id;
+  group_settings->rdc_group_gpu_create("bench", &group_id);
+  for (uint32_t g = 0; g < kGpus; g++) {
+    group_settings->rdc_group_gpu_add(group_id, g);
+  }
+
+  for (uint32_t first = 0; first < num_fields; first += RDC_MAX_FIELD_IDS_PER_FIELD_GROUP) {
+    uint32_t count = std::min<uint32_t>(RDC_MAX_FIELD_IDS_PER_FIELD_GROUP, num_fields - first);
+    rdc_field_t field_ids[RDC_MAX_FIELD_IDS_PER_FIELD_GROUP];
+    for (uint32_t f = 0; f < count; f++) {
+      field_ids[f] = static_cast<rdc_field_t>(kFirstField + first + f);
+    }
+    std::string name = "bench" + std::to_string(first);
+    rdc_field_grp_t field_group_id;
+    if (group_settings->rdc_group_field_create(count, field_ids, name.c_str(), &field_group_id) !=
+        RDC_ST_OK) {
+      state.SkipWithError("Too many field groups");
+      return;
+    }
+    // Keep 1 sample, so the cache size is bounded by the pair count
+    watch_table.rdc_field_watch(group_id, field_group_id, 0, 3600, 1);
+  }
+
+  for (auto _ : state) {
+    watch_table.rdc_field_update_all();
+  }
+  state.SetItemsProcessed(state.iterations() * kGpus * num_fields);
+  state.counters["pairs"] = kGpus * num_fields;
+}
+BENCHMARK(BM_WatchTableUpdateAll)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Arg(100000)
+    ->Unit(benchmark::kMillisecond);
+
+// Dispatch of state.range(0) fields through RdcTelemetryModule to two mock
+// modules which own half of the field ids each
+static void BM_TelemetryModuleDispatch(benchmark::State& state) {
+  const uint32_t kFieldsPerModule = 64;
+  std::list<RdcTelemetryPtr> modules;
+  modules.push_back(std::make_shared<rdc_bench::MockTelemetry>(kFirstField, kFieldsPerModule));
+  modules.push_back(
+      std::make_shared<rdc_bench::MockTelemetry>(kFirstField + kFieldsPerModule, kFieldsPerModule));
+  RdcTelemetryModule telemetry(modules);
+
+  std::vector<rdc_gpu_field_t> fields;
+  for (int64_t i = 0; i < state.range(0); i++) {
+    fields.push_back(
+        {static_cast<uint32_t>(i % kGpus),
+         static_cast<rdc_field_t>(kFirstField + (i / kGpus) % (2 * kFieldsPerModule))});
+  }
+
+  uint64_t received = 0;
+  for (auto _ : state) {
+    telemetry.rdc_telemetry_fields_value_get(&fields[0], fields.size(), count_values, &received);
+  }
+  benchmark::DoNotOptimize(received);
+  state.SetItemsProcessed(state.iterations() * fields.size());
+}
+BENCHMARK(BM_TelemetryModuleDispatch)->Arg(64)->Arg(1024)->Arg(MAX_NUM_FIELDS);
@@ -0,0 +1,488 @@
+/*
+Copyright (c) 2024 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+// rdc_loadgen drives an rdcd with N concurrent clients and reports the
+// throughput and latency percentiles of each RPC. Start rdcd without
+// authentication (-u), and with --fake_smi on machines without GPUs.
+
+#include <getopt.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT(build/c++11)
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+#include "rdc/rdc.h"
+
+namespace {
+
+enum LoadOp { OP_LATEST = 0, OP_SINCE, OP_JOB, OP_UPDATE, OP_COUNT };
+const char* const kOpNames[OP_COUNT] = {"GetLatestFieldValue", "GetFieldSince", "GetJobStats",
+                                        "UpdateAllFields"};
+const char* const kOpKeys[OP_COUNT] = {"latest", "since", "job", "update"};
+const char kJobId[64] = "rdc_loadgen";
+
+struct LoadGenOpts {
+  std::string address = "localhost:50051";
+  uint32_t clients = 4;
+  uint32_t duration_s = 10;
+  uint32_t weights[OP_COUNT] = {70, 20, 5, 5};
+  uint64_t update_freq_us = 1000000;
+  std::vector<rdc_field_t> fields = {RDC_FI_GPU_UTIL, RDC_FI_POWER_USAGE, RDC_FI_GPU_TEMP,
+                                     RDC_FI_GPU_CLOCK, RDC_FI_GPU_MEMORY_USAGE};
+  pid_t rdcd_pid = 0;
+  uint32_t report_interval_s = 1;
+};
+
+// Log-linear latency histogram in the spirit of HdrHistogram: values below
+// kSubBuckets are exact, and every following power of two is split into
+// kSubBuckets / 2 linear buckets, so a reported value is within 1/128 of the
+// recorded one.
+class LatencyHistogram {
+ public:
+  static const uint32_t kSubBits = 8;
+  static const uint32_t kSubBuckets = 1 << kSubBits;
+  static const uint32_t kHalf = kSubBuckets / 2;
+
+  LatencyHistogram()
+      : counts_(kSubBuckets + (64 - kSubBits) * kHalf, 0), total_(0), sum_(0), max_(0) {}
+
+  void record(uint64_t v) {
+    counts_[index_of(v)]++;
+    total_++;
+    sum_ += v;
+    max_ = std::max(max_, v);
+  }
+
+  void merge(const LatencyHistogram& o) {
+    for (size_t i = 0; i < counts_.size(); i++) {
+      counts_[i] += o.counts_[i];
+    }
+    total_ += o.total_;
+    sum_ += o.sum_;
+    max_ = std::max(max_, o.max_);
+  }
+
+  uint64_t count() const { return total_; }
+  uint64_t max() const { return max_; }
+  double mean() const { return total_ ? static_cast<double>(sum_) / total_ : 0; }
+
+  // Upper bound of the bucket holding the q-th quantile, q in [0, 1]
+  uint64_t percentile(double q) const {
+    if (total_ == 0) {
+      return 0;
+    }
+    uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(q * total_)));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < counts_.size(); i++) {
+      seen += counts_[i];
+      if (seen >= rank) {
+        return std::min(upper_bound_of(i), max_);
+      }
+    }
+    return max_;
+  }
+
+ private:
+  static size_t index_of(uint64_t v) {
+    if (v < kSubBuckets) {
+      return v;
+    }
+    // Keep the top kSubBits - 1 significant bits, i.e. v >> shift is in
+    // [kHalf, kSubBuckets)
+    uint32_t shift = 63 - __builtin_clzll(v) - (kSubBits - 1);
+    return kSubBuckets + (shift - 1) * kHalf + ((v >> shift) - kHalf);
+  }
+
+  static uint64_t upper_bound_of(size_t i) {
+    if (i < kSubBuckets) {
+      return i;
+    }
+    uint64_t shift = (i - kSubBuckets) / kHalf + 1;
+    uint64_t sub = (i - kSubBuckets) % kHalf + kHalf;
+    return ((sub + 1) << shift) - 1;
+  }
+
+  std::vector<uint64_t> counts_;
+  uint64_t total_;
+  uint64_t sum_;
+  uint64_t max_;
+};
+
+struct ClientStats {
+  LatencyHistogram latency[OP_COUNT];
+  uint64_t errors[OP_COUNT] = {};
+};
+
+std::atomic<bool> g_running(true);
+std::atomic<uint64_t> g_ops_done[OP_COUNT];
+
+uint64_t now_us() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+bool check(rdc_status_t status, const char* what) {
+  if (status != RDC_ST_OK) {
+    std::cerr << what << " failed: " << rdc_status_string(status) << std::endl;
+    return false;
+  }
+  return true;
+}
+
+void client_loop(const LoadGenOpts& opts, const std::vector<uint32_t>& gpus, uint32_t seed,
+                 ClientStats* stats) {
+  rdc_handle_t handle;
+  if (!check(rdc_connect(opts.address.c_str(), &handle, nullptr, nullptr, nullptr),
+             "rdc_connect")) {
+    return;
+  }
+
+  std::mt19937 rng(seed);
+  uint32_t total_weight = 0;
+  for (uint32_t w : opts.weights) {
+    total_weight += w;
+  }
+  std::vector<uint64_t> since(gpus.size() * opts.fields.size(), now_us() / 1000);
+
+  while (g_running) {
+    uint32_t pick = rng() % total_weight;
+    uint32_t op = 0;
+    while (pick >= opts.weights[op]) {
+      pick -= opts.weights[op++];
+    }
+    uint32_t key = rng() % since.size();
+    uint32_t gpu = gpus[key / opts.fields.size()];
+    rdc_field_t field = opts.fields[key % opts.fields.size()];
+
+    rdc_status_t status = RDC_ST_OK;
+    rdc_field_value value;
+    rdc_job_info_t job_info;
+    auto start = std::chrono::steady_clock::now();
+    switch (op) {
+      case OP_LATEST:
+        status = rdc_field_get_latest_value(handle, gpu, field, &value);
+        break;
+      case OP_SINCE: {
+        uint64_t next_since = since[key];
+        status = rdc_field_get_value_since(handle, gpu, field, since[key], &next_since, &value);
+        since[key] = next_since;
+        break;
+      }
+      case OP_JOB:
+        status = rdc_job_get_stats(handle, kJobId, &job_info);
+        break;
+      default:
+        status = rdc_field_update_all(handle, 0);
+        break;
+    }
+    uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      std::chrono::steady_clock::now() - start)
+                      .count();
+    stats->latency[op].record(ns);
+    // No new sample since the last poll is a normal answer
+    if (status != RDC_ST_OK && !(op == OP_SINCE && status == RDC_ST_NOT_FOUND)) {
+      stats->errors[op]++;
+    }
+    g_ops_done[op].fetch_add(1, std::memory_order_relaxed);
+  }
+
+  rdc_disconnect(handle);
+}
+
+// Resident set in KiB and consumed CPU time in clock ticks of a process
+bool read_proc_usage(pid_t pid, uint64_t* rss_kb, uint64_t* cpu_ticks) {
+  std::ifstream status("/proc/" + std::to_string(pid) + "/status");
+  std::string line;
+  *rss_kb = 0;
+  while (std::getline(status, line)) {
+    if (line.compare(0, 6, "VmRSS:") == 0) {
+      *rss_kb = std::strtoull(line.c_str() + 6, nullptr, 10);
+      break;
+    }
+  }
+
+  std::ifstream stat("/proc/" + std::to_string(pid) + "/stat");
+  if (!std::getline(stat, line)) {
+    return false;
+  }
+  // utime and stime are the 14th and 15th fields, counted after the
+  // parenthesized command name which may contain spaces
+  std::istringstream fields(line.substr(line.rfind(')') + 2));
+  std::string skip;
+  for (int i = 3; i < 14; i++) {
+    fields >> skip;
+  }
+  uint64_t utime = 0, stime = 0;
+  fields >> utime >> stime;
+  *cpu_ticks = utime + stime;
+  return true;
+}
+
+bool parse_mix(const std::string& mix, uint32_t weights[OP_COUNT]) {
+  std::fill(weights, weights + OP_COUNT, 0);
+  std::istringstream in(mix);
+  std::string item;
+  uint32_t total = 0;
+  while (std::getline(in, item, ',')) {
+    size_t eq = item.find('=');
+    if (eq == std::string::npos) {
+      return false;
+    }
+    std::string name = item.substr(0, eq);
+    auto key = std::find(kOpKeys, kOpKeys + OP_COUNT, name);
+    if (key == kOpKeys + OP_COUNT) {
+      return false;
+    }
+    weights[key - kOpKeys] = std::strtoul(item.c_str() + eq + 1, nullptr, 10);
+    total += weights[key - kOpKeys];
+  }
+  return total > 0;
+}
+
+const struct option long_options[] = {{"address", required_argument, nullptr, 'a'},
+                                      {"clients", required_argument, nullptr, 'c'},
+                                      {"duration", required_argument, nullptr, 't'},
+                                      {"mix", required_argument, nullptr, 'm'},
+                                      {"fields", required_argument, nullptr, 'e'},
+                                      {"update_freq", required_argument, nullptr, 'f'},
+                                      {"rdcd_pid", required_argument, nullptr, 'p'},
+                                      {"interval", required_argument, nullptr, 'i'},
+                                      {"help", no_argument, nullptr, 'h'},
+                                      {nullptr, 0, nullptr, 0}};
+const char* short_options = "a:c:t:m:e:f:p:i:h";
+
+void print_help() {
+  std::cout << "Usage: rdc_loadgen [options]\n"
+               "rdcd must run without authentication (rdcd -u), optionally with --fake_smi.\n"
+               "--address, -a <host:port> rdcd to connect to, default localhost:50051\n"
+               "--clients, -c <N> concurrent clients, each with its own connection, default 4\n"
+               "--duration, -t <seconds> length of the run, default 10\n"
+               "--mix, -m <op=weight,...> relative weights of latest, since, job and update,\n"
+               "    default latest=70,since=20,job=5,update=5\n"
+               "--fields, -e <id,...> field ids to watch, default 500,300,201,100,503\n"
+               "--update_freq, -f <us> watch update interval, default 1000000\n"
+               "--rdcd_pid, -p <pid> sample RSS and CPU of this rdcd process\n"
+               "--interval, -i <seconds> progress report interval, default 1\n"
+               "--help, -h print this message\n";
+}
+
+bool process_cmdline(int argc, char** argv, LoadGenOpts* opts) {
+  int c;
+  while ((c = getopt_long(argc, argv, short_options, long_options, nullptr)) != -1) {
+    switch (c) {
+      case 'a':
+        opts->address = optarg;
+        break;
+      case 'c':
+        opts->clients = std::max(1UL, std::strtoul(optarg, nullptr, 10));
+        break;
+      case 't':
+        opts->duration_s = std::strtoul(optarg, nullptr, 10);
+        break;
+      case 'm':
+        if (!parse_mix(optarg, opts->weights)) {
+          std::cerr << "Invalid mix \"" << optarg << "\"" << std::endl;
+          return false;
+        }
+        break;
+      case 'e': {
+        opts->fields.clear();
+        std::istringstream in(optarg);
+        std::string id;
+        while (std::getline(in, id, ',')) {
+          opts->fields.push_back(static_cast<rdc_field_t>(std::strtoul(id.c_str(), nullptr, 10)));
+        }
+        if (opts->fields.empty() || opts->fields.size() > RDC_MAX_FIELD_IDS_PER_FIELD_GROUP) {
+          std::cerr << "Invalid field list \"" << optarg << "\"" << std::endl;
+          return false;
+        }
+        break;
+      }
+      case 'f':
+        opts->update_freq_us = std::strtoull(optarg, nullptr, 10);
+        break;
+      case 'p':
+        opts->rdcd_pid = std::strtol(optarg, nullptr, 10);
+        break;
+      case 'i':
+        opts->report_interval_s = std::max(1UL, std::strtoul(optarg, nullptr, 10));
+        break;
+      case 'h':
+        print_help();
+        exit(0);
+      default:
+        print_help();
+        return false;
+    }
+  }
+  return true;
+}
+
+void print_report(const LoadGenOpts& opts, const ClientStats& total, double elapsed_s) {
+  std::cout << "\n"
+            << opts.clients << " clients, " << std::fixed << std::setprecision(1) << elapsed_s
+            << " s\n";
+  std::cout << std::left << std::setw(22) << "RPC" << std::right << std::setw(10) << "count"
+            << std::setw(10) << "errors" << std::setw(12) << "rps" << std::setw(10) << "mean"
+            << std::setw(10) << "p50" << std::setw(10) << "p90" << std::setw(10) << "p99"
+            << std::setw(10) << "p99.9" << std::setw(10) << "max"
+            << "  (latency in us)\n";
+  LatencyHistogram all;
+  uint64_t all_errors = 0;
+  auto row = [&](const std::string& name, const LatencyHistogram& h, uint64_t errors) {
+    std::cout << std::left << std::setw(22) << name << std::right << std::setw(10) << h.count()
+              << std::setw(10) << errors << std::setw(12) << std::setprecision(1)
+              << h.count() / elapsed_s << std::setw(10) << h.mean() / 1000 << std::setw(10)
+              << h.percentile(0.5) / 1000.0 << std::setw(10) << h.percentile(0.9) / 1000.0
+              << std::setw(10) << h.percentile(0.99) / 1000.0 << std::setw(10)
+              << h.percentile(0.999) / 1000.0 << std::setw(10) << h.max() / 1000.0 << "\n";
+  };
+  for (uint32_t op = 0; op < OP_COUNT; op++) {
+    if (total.latency[op].count() == 0) {
+      continue;
+    }
+    row(kOpNames[op], total.latency[op], total.errors[op]);
+    all.merge(total.latency[op]);
+    all_errors += total.errors[op];
+  }
+  row("all", all, all_errors);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  LoadGenOpts opts;
+  if (!process_cmdline(argc, argv, &opts)) {
+    return 1;
+  }
+
+  rdc_handle_t handle;
+  if (!check(rdc_init(0), "rdc_init") ||
+      !check(rdc_connect(opts.address.c_str(), &handle, nullptr, nullptr, nullptr),
+             "rdc_connect")) {
+    return 1;
+  }
+
+  // Watch the fields on all GPUs, and run a job on them for GetJobStats
+  uint32_t gpu_list[RDC_MAX_NUM_DEVICES];
+  uint32_t gpu_count = 0;
+  rdc_gpu_group_t group_id;
+  rdc_field_grp_t field_group_id;
+  if (!check(rdc_device_get_all(handle, gpu_list, &gpu_count), "rdc_device_get_all") ||
+      gpu_count == 0 ||
+      !check(rdc_group_gpu_create(handle, RDC_GROUP_EMPTY, "rdc_loadgen", &group_id),
+             "rdc_group_gpu_create")) {
+    return 1;
+  }
+  std::vector<uint32_t> gpus(gpu_list,
+                             gpu_list + std::min<uint32_t>(gpu_count, RDC_GROUP_MAX_ENTITIES));
+  for (uint32_t gpu : gpus) {
+    rdc_group_gpu_add(handle, group_id, gpu);
+  }
+  if (!check(rdc_group_field_create(handle, opts.fields.size(), &opts.fields[0], "rdc_loadgen",
+                                    &field_group_id),
+             "rdc_group_field_create") ||
+      !check(rdc_field_watch(handle, group_id, field_group_id, opts.update_freq_us, 60, 0),
+             "rdc_field_watch")) {
+    rdc_group_gpu_destroy(handle, group_id);
+    return 1;
+  }
+  check(rdc_job_start_stats(handle, group_id, kJobId, opts.update_freq_us), "rdc_job_start_stats");
+
+  std::cout << "Running " << opts.clients << " clients against " << opts.address << " for "
+            << opts.duration_s << " s, " << gpus.size() << " GPUs x " << opts.fields.size()
+            << " fields" << std::endl;
+
+  std::vector<ClientStats> stats(opts.clients);
+  std::vector<std::thread> clients;
+  auto start = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < opts.clients; i++) {
+    clients.emplace_back(client_loop, std::cref(opts), std::cref(gpus), i + 1, &stats[i]);
+  }
+
+  // Progress report, with the rdcd resource usage when a pid is given
+  uint64_t last_ops = 0, last_ticks = 0, rss_kb = 0, peak_rss_kb = 0;
+  if (opts.rdcd_pid) {
+    read_proc_usage(opts.rdcd_pid, &rss_kb, &last_ticks);
+  }
+  long ticks_per_s = sysconf(_SC_CLK_TCK);  // NOLINT(runtime/int)
+  for (uint32_t t = 0; t < opts.duration_s; t += opts.report_interval_s) {
+    std::this_thread::sleep_for(std::chrono::seconds(opts.report_interval_s));
+    uint64_t ops = 0;
+    for (uint32_t op = 0; op < OP_COUNT; op++) {
+      ops += g_ops_done[op].load(std::memory_order_relaxed);
+    }
+    std::cout << "[" << std::setw(4) << t + opts.report_interval_s << " s] "
+              << (ops - last_ops) / opts.report_interval_s << " rps";
+    last_ops = ops;
+    uint64_t ticks;
+    if (opts.rdcd_pid && read_proc_usage(opts.rdcd_pid, &rss_kb, &ticks)) {
+      peak_rss_kb = std::max(peak_rss_kb, rss_kb);
+      std::cout << ", rdcd rss " << rss_kb / 1024 << " MiB, cpu " << std::setprecision(0)
+                << std::fixed
+                << 100.0 * (ticks - last_ticks) / ticks_per_s / opts.report_interval_s << "%";
+      last_ticks = ticks;
+    }
+    std::cout << std::endl;
+  }
+
+  g_running = false;
+  for (auto& c : clients) {
+    c.join();
+  }
+  double elapsed_s =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  ClientStats total;
+  for (auto& s : stats) {
+    for (uint32_t op = 0; op < OP_COUNT; op++) {
+      total.latency[op].merge(s.latency[op]);
+      total.errors[op] += s.errors[op];
+    }
+  }
+  print_report(opts, total, elapsed_s);
+  if (opts.rdcd_pid) {
+    std::cout << "rdcd peak rss " << peak_rss_kb / 1024 << " MiB" << std::endl;
+  }
+
+  rdc_job_stop_stats(handle, kJobId);
+  rdc_job_remove(handle, kJobId);
+  rdc_field_unwatch(handle, group_id, field_group_id);
+  rdc_group_field_destroy(handle, field_group_id);
+  rdc_group_gpu_destroy(handle, group_id);
+  rdc_disconnect(handle);
+  rdc_shutdown();
+  return 0;
+}
@@ -45,7 +45,13 @@
 
 #include "rdc_tests/test_utils.h"
 
+#include <dirent.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
 #include <map>
+#include <string>
 
 #include "amd_smi/amdsmi.h"
 
@@ -132,3 +138,38 @@ static const std::map<amdsmi_fw_block_t, const char*> kDevFWNameMap = {
 };
 
 const char* NameFromFWEnum(amdsmi_fw_block_t blk) { return kDevFWNameMap.at(blk); }
+
+TempDir::TempDir(const std::string& prefix) {
+  std::string dir = "/tmp/" + prefix + ".XXXXXX";
+  if (mkdtemp(&dir[0]) != nullptr) {
+    path_ = dir;
+  }
+}
+
+TempDir::~TempDir() { remove(); }
+
+void TempDir::remove() {
+  if (path_.empty()) {
+    return;
+  }
+  DIR* d = opendir(path_.c_str());
+  if (d != nullptr) {
+    while (struct dirent* entry = readdir(d)) {
+      if (strcmp(entry->d_name, ".") != 0 && strcmp(entry->d_name, "..") != 0) {
+        unlink((path_ + "/" + entry->d_name).c_str());
+      }
+    }
+    closedir(d);
+  }
+  rmdir(path_.c_str());
+}
+
+rdc_field_value integer_value(rdc_field_t field_id, uint64_t ts, int64_t value) {
+  rdc_field_value field = {};
+  field.field_id = field_id;
+  field.status = RDC_ST_OK;
+  field.type = INTEGER;
+  field.ts = ts;
+  field.value.l_int = value;
+  return field;
+}
@@ -46,8 +46,32 @@
 #ifndef TESTS_RDC_TESTS_TEST_UTILS_H_
 #define TESTS_RDC_TESTS_TEST_UTILS_H_
 
+#include <cstdint>
+#include <string>
+
 #include "amd_smi/amdsmi.h"
+#include "rdc/rdc.h"
 
 const char* NameFromFWEnum(amdsmi_fw_block_t blk);
 
+// A directory made under /tmp, removed along with its files when destroyed
+class TempDir {
+ public:
+  explicit TempDir(const std::string& prefix);
+  ~TempDir();
+  TempDir(const TempDir&) = delete;
+  TempDir& operator=(const TempDir&) = delete;
+
+  // Empty when the directory could not be made
+  const std::string& path() const { return path_; }
+  // Remove the files and the directory before the end of the test
+  void remove();
+
+ private:
+  std::string path_;
+};
+
+// A sample of an INTEGER field
+rdc_field_value integer_value(rdc_field_t field_id, uint64_t ts, int64_t value);
+
 #endif  // TESTS_RDC_TESTS_TEST_UTILS_H_
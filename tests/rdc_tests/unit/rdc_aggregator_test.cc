@@ -0,0 +1,241 @@
+/*
+Copyright (c) 2024 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <grpcpp/grpcpp.h>
+#include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <chrono>  // NOLINT(build/c++11)
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT(build/c++11)
+
+#include "rdc.grpc.pb.h"  // NOLINT
+#include "rdc/rdc.h"
+#include "rdc/rdc_aggregator.h"
+#include "rdc_tests/test_utils.h"
+
+using amd::rdc::RdcAggregator;
+
+namespace {
+
+const uint64_t kWaitTimeoutMs = 10000;
+
+uint64_t now_ms() {
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return static_cast<uint64_t>(tv.tv_sec) * 1000 + tv.tv_usec / 1000;
+}
+
+// Poll the condition until it holds or the wait times out
+bool wait_for(const std::function<bool()>& condition) {
+  uint64_t deadline = now_ms() + kWaitTimeoutMs;
+  while (!condition()) {
+    if (now_ms() > deadline) {
+      return false;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  }
+  return true;
+}
+
+// A free port of the loopback, for a downstream which is started later
+int free_port() {
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  struct sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t len = sizeof(addr);
+  int port = 0;
+  if (fd >= 0 && bind(fd, reinterpret_cast<sockaddr*>(&addr), len) == 0 &&
+      getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len) == 0) {
+    port = ntohs(addr.sin_port);
+  }
+  if (fd >= 0) {
+    close(fd);
+  }
+  return port;
+}
+
+// A downstream rdcd streaming the power and the temperature of its GPUs:
+// GPU g of host h draws 100 * h + g watts at 40 + 10 * h + g degrees
+class FakeDownstream : public ::rdc::RdcAPI::Service {
+ public:
+  FakeDownstream(uint32_t host, uint32_t num_gpus) : host_(host), num_gpus_(num_gpus) {}
+
+  ::grpc::Status StreamFieldValues(::grpc::ServerContext* context,
+                                   const ::rdc::StreamFieldValuesRequest* request,
+                                   ::grpc::ServerWriter<::rdc::FieldValueBatch>* writer) override {
+    while (!context->IsCancelled()) {
+      ::rdc::FieldValueBatch batch;
+      for (uint32_t gpu = 0; gpu < num_gpus_; gpu++) {
+        auto power = batch.add_values();
+        power->set_gpu_index(gpu);
+        power->mutable_value()->set_field_id(RDC_FI_POWER_USAGE);
+        power->mutable_value()->set_ts(now_ms());
+        power->mutable_value()->set_type(::rdc::GetLatestFieldValueResponse_FieldType_DOUBLE);
+        power->mutable_value()->set_dbl(100.0 * host_ + gpu);
+        auto temp = batch.add_values();
+        temp->set_gpu_index(gpu);
+        temp->mutable_value()->set_field_id(RDC_FI_GPU_TEMP);
+        temp->mutable_value()->set_ts(now_ms());
+        temp->mutable_value()->set_type(::rdc::GetLatestFieldValueResponse_FieldType_INTEGER);
+        temp->mutable_value()->set_l_int(40 + 10 * host_ + gpu);
+      }
+      if (!writer->Write(batch)) {
+        break;
+      }
+      std::this_thread::sleep_for(std::chrono::microseconds(request->update_freq()));
+    }
+    return ::grpc::Status::OK;
+  }
+
+  bool start(const std::string& address) {
+    ::grpc::ServerBuilder builder;
+    builder.AddListeningPort(address, ::grpc::InsecureServerCredentials());
+    builder.RegisterService(this);
+    server_ = builder.BuildAndStart();
+    return server_ != nullptr;
+  }
+
+  void shutdown() {
+    if (server_) {
+      server_->Shutdown(std::chrono::system_clock::now());
+      server_.reset();
+    }
+  }
+
+  ~FakeDownstream() { shutdown(); }
+
+ private:
+  uint32_t host_;
+  uint32_t num_gpus_;
+  std::unique_ptr<::grpc::Server> server_;
+};
+
+class AggregatorTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    if (rdc_init(0) != RDC_ST_OK) {
+      GTEST_SKIP() << "Fail to initialize RDC";
+    }
+    if (rdc_start_embedded(RDC_OPERATION_MODE_MANUAL, &rdc_handle_) != RDC_ST_OK) {
+      rdc_handle_ = nullptr;
+      rdc_shutdown();
+      GTEST_SKIP() << "No embedded RDC to ingest the downstream samples";
+    }
+    ASSERT_FALSE(dir_.path().empty());
+    hosts_file_ = dir_.path() + "/hosts";
+    setenv("RDC_AGGREGATE_FIELDS", "RDC_FI_POWER_USAGE,RDC_FI_GPU_TEMP", 1);
+    setenv("RDC_AGGREGATE_UPDATE_FREQ", "100", 1);
+  }
+
+  void TearDown() override {
+    if (rdc_handle_ != nullptr) {
+      rdc_stop_embedded(rdc_handle_);
+      rdc_shutdown();
+    }
+    unsetenv("RDC_AGGREGATE_FIELDS");
+    unsetenv("RDC_AGGREGATE_UPDATE_FREQ");
+  }
+
+  rdc_aggregate_host_t host(RdcAggregator* aggregator, uint32_t host_id) {
+    rdc_aggregate_hosts_t hosts = {};
+    aggregator->get_hosts(&hosts);
+    return host_id < hosts.num_hosts ? hosts.hosts[host_id] : rdc_aggregate_host_t{};
+  }
+
+  rdc_handle_t rdc_handle_ = nullptr;
+  TempDir dir_{"rdctst_aggregator"};
+  std::string hosts_file_;
+};
+
+}  // namespace
+
+TEST_F(AggregatorTest, AggregateOverFakeDownstreams) {
+  FakeDownstream first(0, 2);
+  FakeDownstream second(1, 3);
+  int first_port = free_port();
+  int second_port = free_port();
+  ASSERT_NE(first_port, 0);
+  ASSERT_NE(second_port, 0);
+  std::string first_address = "127.0.0.1:" + std::to_string(first_port);
+  std::string second_address = "127.0.0.1:" + std::to_string(second_port);
+  ASSERT_TRUE(first.start(first_address));
+
+  // Comments, blank lines and a duplicated host are skipped
+  std::ofstream(hosts_file_) << "# rack 1\n"
+                             << first_address << "\n\n"
+                             << "  " << second_address << "   # started later\n"
+                             << first_address << "\n";
+
+  RdcAggregator aggregator(rdc_handle_);
+  ASSERT_EQ(aggregator.start(hosts_file_, false), RDC_ST_OK);
+  rdc_aggregate_hosts_t hosts = {};
+  ASSERT_EQ(aggregator.get_hosts(&hosts), RDC_ST_OK);
+  ASSERT_EQ(hosts.num_hosts, 2u);
+  EXPECT_EQ(std::string(hosts.hosts[0].host), first_address);
+  EXPECT_EQ(hosts.hosts[0].gpu_base, RDC_AGGREGATE_GPU_BASE);
+  EXPECT_EQ(std::string(hosts.hosts[1].host), second_address);
+  EXPECT_EQ(hosts.hosts[1].gpu_base, 2 * RDC_AGGREGATE_GPU_BASE);
+
+  ASSERT_TRUE(wait_for([&] { return host(&aggregator, 0).num_gpus == 2; }));
+  EXPECT_TRUE(host(&aggregator, 0).connected);
+  EXPECT_FALSE(host(&aggregator, 1).connected);
+
+  // The second downstream is picked up once it comes up
+  ASSERT_TRUE(second.start(second_address));
+  ASSERT_TRUE(wait_for([&] { return host(&aggregator, 1).num_gpus == 3; }));
+  EXPECT_TRUE(host(&aggregator, 1).connected);
+  EXPECT_GE(host(&aggregator, 1).num_reconnects, 1u);
+
+  rdc_cluster_aggregate_t aggregate;
+  ASSERT_EQ(aggregator.get_field(RDC_FI_POWER_USAGE, RDC_AGGREGATE_SUM, &aggregate), RDC_ST_OK);
+  EXPECT_EQ(aggregate.num_gpus, 5u);
+  EXPECT_DOUBLE_EQ(aggregate.value, 0 + 1 + 100 + 101 + 102);
+  ASSERT_EQ(aggregator.get_field(RDC_FI_POWER_USAGE, RDC_AGGREGATE_AVG, &aggregate), RDC_ST_OK);
+  EXPECT_DOUBLE_EQ(aggregate.value, 304.0 / 5);
+  ASSERT_EQ(aggregator.get_field(RDC_FI_GPU_TEMP, RDC_AGGREGATE_MIN, &aggregate), RDC_ST_OK);
+  EXPECT_DOUBLE_EQ(aggregate.value, 40);
+  EXPECT_EQ(aggregate.host_id, 0u);
+  EXPECT_EQ(aggregate.gpu_index, RDC_AGGREGATE_GPU_BASE);
+  ASSERT_EQ(aggregator.get_field(RDC_FI_GPU_TEMP, RDC_AGGREGATE_MAX, &aggregate), RDC_ST_OK);
+  EXPECT_DOUBLE_EQ(aggregate.value, 52);
+  EXPECT_EQ(aggregate.host_id, 1u);
+  EXPECT_EQ(aggregate.gpu_index, 2 * RDC_AGGREGATE_GPU_BASE + 2);
+  EXPECT_EQ(aggregator.get_field(RDC_FI_GPU_CLOCK, RDC_AGGREGATE_SUM, &aggregate),
+            RDC_ST_NOT_FOUND);
+
+  // A lost downstream is noticed, and stop does not wait out its backoff
+  first.shutdown();
+  ASSERT_TRUE(wait_for([&] { return !host(&aggregator, 0).connected; }));
+  uint64_t stop_start = now_ms();
+  aggregator.stop();
+  EXPECT_LT(now_ms() - stop_start, 1000u);
+}
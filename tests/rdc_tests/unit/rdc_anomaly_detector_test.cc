@@ -0,0 +1,313 @@
+/*
+Copyright (c) 2024 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "rdc/rdc.h"
+#include "rdc_lib/impl/RdcAnomalyDetector.h"
+
+using amd::rdc::rdc_evnt_notification_t;
+using amd::rdc::RdcAnomalyDetector;
+
+namespace {
+
+rdc_field_value power(uint64_t ts, double value) {
+  rdc_field_value field = {};
+  field.field_id = RDC_FI_POWER_USAGE;
+  field.status = RDC_ST_OK;
+  field.type = DOUBLE;
+  field.ts = ts;
+  field.value.dbl = value;
+  return field;
+}
+
+rdc_anomaly_config_t power_detector(double alpha, double threshold, uint32_t season_period_s) {
+  rdc_anomaly_config_t config = {};
+  config.field_id = RDC_FI_POWER_USAGE;
+  config.alpha = alpha;
+  config.threshold = threshold;
+  config.warmup_samples = 4;
+  config.season_period_s = season_period_s;
+  return config;
+}
+
+rdc_status_t save_value(rdc_gpu_field_value_t* values, uint32_t num_values, void* user_data) {
+  auto saved = static_cast<std::vector<rdc_gpu_field_value_t>*>(user_data);
+  saved->insert(saved->end(), values, values + num_values);
+  return RDC_ST_OK;
+}
+
+//!< The RDC_FI_ANOMALY_SCORE_<detector_id> field of a GPU
+rdc_field_value score_of(RdcAnomalyDetector* detector, uint32_t detector_id, uint32_t gpu_index) {
+  rdc_gpu_field_t field = {gpu_index,
+                           static_cast<rdc_field_t>(RDC_FI_ANOMALY_SCORE_0 + detector_id)};
+  std::vector<rdc_gpu_field_value_t> values;
+  EXPECT_EQ(detector->rdc_telemetry_fields_value_get(&field, 1, save_value, &values), RDC_ST_OK);
+  EXPECT_EQ(values.size(), 1u);
+  return values.empty() ? rdc_field_value{} : values[0].field_value;
+}
+
+//!< Baseline samples alternating one watt around 100 W, one per second
+void learn_noise(RdcAnomalyDetector* detector, uint32_t num_samples, uint64_t* ts) {
+  std::vector<rdc_evnt_notification_t> events;
+  for (uint32_t i = 0; i < num_samples; i++) {
+    *ts += 1000;
+    detector->evaluate(0, power(*ts, i % 2 ? 101 : 99), &events);
+  }
+  ASSERT_TRUE(events.empty());
+}
+
+}  // namespace
+
+TEST(rdctstUnit, AnomalyScoreIsTheZScoreAgainstTheEwma) {
+  RdcAnomalyDetector detector;
+  ASSERT_EQ(detector.set_detector(0, power_detector(0.1, 3, 0)), RDC_ST_OK);
+  EXPECT_EQ(score_of(&detector, 0, 0).status, RDC_ST_NOT_FOUND);
+
+  // The first samples are averaged evenly: mean 11, and with the level
+  // following every sample the variance of the steps is 1.5
+  std::vector<rdc_evnt_notification_t> events;
+  double warmup[] = {10, 12, 10, 12};
+  for (uint32_t i = 0; i < 4; i++) {
+    detector.evaluate(0, power(1000 * (i + 1), warmup[i]), &events);
+    // Not scored until warmup_samples are learnt
+    EXPECT_EQ(score_of(&detector, 0, 0).status, RDC_ST_NOT_FOUND);
+  }
+
+  detector.evaluate(0, power(5000, 14), &events);
+  rdc_field_value score = score_of(&detector, 0, 0);
+  ASSERT_EQ(score.status, RDC_ST_OK);
+  EXPECT_EQ(score.field_id, RDC_FI_ANOMALY_SCORE_0);
+  EXPECT_EQ(score.type, DOUBLE);
+  EXPECT_EQ(score.ts, 5000u);
+  EXPECT_NEAR(score.value.dbl, 3 / std::sqrt(1.5), 1e-9);
+  EXPECT_TRUE(events.empty());
+
+  // 14 moved the mean to 11.6 with a weight of 1/5
+  detector.evaluate(0, power(6000, 11.6), &events);
+  EXPECT_NEAR(score_of(&detector, 0, 0).value.dbl, 0, 1e-9);
+
+  // Below the mean scores negative; the scores are per GPU
+  detector.evaluate(0, power(7000, 0), &events);
+  EXPECT_LT(score_of(&detector, 0, 0).value.dbl, -3);
+  EXPECT_EQ(score_of(&detector, 0, 1).status, RDC_ST_NOT_FOUND);
+  ASSERT_EQ(events.size(), 1u);
+  EXPECT_EQ(events[0].gpu_id, 0u);
+  EXPECT_EQ(events[0].field.field_id, RDC_EVNT_NOTIF_ANOMALY);
+  EXPECT_EQ(events[0].field.ts, 7000u);
+  EXPECT_EQ(events[0].field.value.l_int, RDC_FI_POWER_USAGE);
+
+  // A constant field is scored against one percent of its mean
+  ASSERT_EQ(detector.set_detector(1, power_detector(0.1, 5, 0)), RDC_ST_OK);
+  for (uint32_t i = 0; i < 4; i++) {
+    detector.evaluate(2, power(1000 * (i + 1), 100), &events);
+  }
+  detector.evaluate(2, power(5000, 103), &events);
+  EXPECT_NEAR(score_of(&detector, 1, 2).value.dbl, 3, 1e-9);
+}
+
+TEST(rdctstUnit, AnomalyStepChangeIsRaisedOnce) {
+  RdcAnomalyDetector detector;
+  ASSERT_EQ(detector.set_detector(0, power_detector(0.1, 4, 0)), RDC_ST_OK);
+  uint64_t ts = 0;
+  learn_noise(&detector, 100, &ts);
+
+  // The step is raised once, then learnt until its score is below
+  // threshold / 2, which clears it
+  std::vector<rdc_evnt_notification_t> events;
+  double max_score = 0;
+  for (uint32_t i = 0; i < 100; i++) {
+    ts += 1000;
+    detector.evaluate(0, power(ts, 150), &events);
+    max_score = std::max(max_score, score_of(&detector, 0, 0).value.dbl);
+  }
+  EXPECT_GE(max_score, 4);
+  EXPECT_LT(score_of(&detector, 0, 0).value.dbl, 2);
+  ASSERT_EQ(events.size(), 1u);
+  EXPECT_EQ(events[0].field.field_id, RDC_EVNT_NOTIF_ANOMALY);
+  EXPECT_EQ(events[0].field.ts, 101000u);
+
+  // Cleared, so the step back down is raised again
+  ts += 1000;
+  detector.evaluate(0, power(ts, 100), &events);
+  ASSERT_EQ(events.size(), 2u);
+  EXPECT_EQ(events[1].field.ts, ts);
+}
+
+TEST(rdctstUnit, AnomalyHysteresisIsHalfTheThreshold) {
+  // The baseline barely moves, so the scores follow the samples
+  RdcAnomalyDetector detector;
+  ASSERT_EQ(detector.set_detector(0, power_detector(0.001, 4, 0)), RDC_ST_OK);
+  uint64_t ts = 0;
+  learn_noise(&detector, 1000, &ts);
+
+  std::vector<rdc_evnt_notification_t> events;
+  double samples[] = {105, 103, 105, 100, 105};
+  double scores[5];
+  for (uint32_t i = 0; i < 5; i++) {
+    ts += 1000;
+    detector.evaluate(0, power(ts, samples[i]), &events);
+    scores[i] = score_of(&detector, 0, 0).value.dbl;
+  }
+  EXPECT_GE(scores[0], 4);
+  // Between threshold / 2 and threshold keeps the anomaly raised
+  EXPECT_GT(scores[1], 2);
+  EXPECT_LT(scores[1], 4);
+  EXPECT_GE(scores[2], 4);
+  // Below threshold / 2 clears it
+  EXPECT_LT(scores[3], 2);
+  EXPECT_GE(scores[4], 4);
+  ASSERT_EQ(events.size(), 2u);
+  EXPECT_EQ(events[0].field.ts, ts - 4000);
+  EXPECT_EQ(events[1].field.ts, ts);
+}
+
+TEST(rdctstUnit, AnomalySlowDriftIsDetected) {
+  // The variance is the spread around a level ten times faster than the
+  // mean, so a drift of 0.05 W per second is not learnt as noise
+  RdcAnomalyDetector detector;
+  ASSERT_EQ(detector.set_detector(0, power_detector(0.01, 4, 0)), RDC_ST_OK);
+  uint64_t ts = 0;
+  learn_noise(&detector, 1000, &ts);
+
+  std::vector<rdc_evnt_notification_t> events;
+  for (uint32_t i = 0; i < 500 && events.empty(); i++) {
+    ts += 1000;
+    detector.evaluate(0, power(ts, (i % 2 ? 101 : 99) + 0.05 * i), &events);
+  }
+  ASSERT_EQ(events.size(), 1u);
+  EXPECT_EQ(events[0].field.field_id, RDC_EVNT_NOTIF_ANOMALY);
+}
+
+TEST(rdctstUnit, AnomalySeasonalBaselineLearnsPeriodicSignal) {
+  // A spike every 24 seconds, with noise changing from one period to the next
+  auto sample = [](uint64_t i) -> double {
+    double noise = (i / 24) % 2 ? 1 : -1;
+    return (i % 24 == 0 ? 300 : 100) + noise;
+  };
+
+  RdcAnomalyDetector seasonal;
+  RdcAnomalyDetector global;
+  ASSERT_EQ(seasonal.set_detector(0, power_detector(0.01, 3, 24)), RDC_ST_OK);
+  ASSERT_EQ(global.set_detector(0, power_detector(0.01, 3, 0)), RDC_ST_OK);
+
+  // Warm up every slice of the season
+  std::vector<rdc_evnt_notification_t> events;
+  uint64_t i = 0;
+  for (; i < 24 * 10; i++) {
+    seasonal.evaluate(0, power(i * 1000, sample(i)), &events);
+    global.evaluate(0, power(i * 1000, sample(i)), &events);
+  }
+
+  std::vector<rdc_evnt_notification_t> seasonal_events;
+  std::vector<rdc_evnt_notification_t> global_events;
+  double max_score = 0;
+  for (; i < 24 * 50; i++) {
+    seasonal.evaluate(0, power(i * 1000, sample(i)), &seasonal_events);
+    global.evaluate(0, power(i * 1000, sample(i)), &global_events);
+    max_score = std::max(max_score, std::fabs(score_of(&seasonal, 0, 0).value.dbl));
+  }
+  EXPECT_TRUE(seasonal_events.empty());
+  EXPECT_LT(max_score, 3);
+  // Without a season every spike is an anomaly
+  EXPECT_EQ(global_events.size(), 40u);
+}
+
+TEST(rdctstUnit, AnomalyDetectorsAreSetAndCleared) {
+  RdcAnomalyDetector detector;
+  EXPECT_EQ(detector.set_detector(RDC_MAX_ANOMALY_DETECTORS, power_detector(0.1, 3, 0)),
+            RDC_ST_BAD_PARAMETER);
+  EXPECT_EQ(detector.set_detector(0, power_detector(0, 3, 0)), RDC_ST_BAD_PARAMETER);
+  EXPECT_EQ(detector.set_detector(0, power_detector(1.5, 3, 0)), RDC_ST_BAD_PARAMETER);
+  EXPECT_EQ(detector.set_detector(0, power_detector(NAN, 3, 0)), RDC_ST_BAD_PARAMETER);
+  EXPECT_EQ(detector.set_detector(0, power_detector(0.1, 0, 0)), RDC_ST_BAD_PARAMETER);
+  rdc_anomaly_config_t config = power_detector(0.1, 3, 0);
+  config.field_id = RDC_FI_ANOMALY_SCORE_1;
+  EXPECT_EQ(detector.set_detector(0, config), RDC_ST_BAD_PARAMETER);
+  config.field_id = RDC_EVNT_NOTIF_ANOMALY;
+  EXPECT_EQ(detector.set_detector(0, config), RDC_ST_BAD_PARAMETER);
+  EXPECT_EQ(detector.clear_detector(0), RDC_ST_NOT_FOUND);
+  EXPECT_EQ(detector.clear_detector(RDC_MAX_ANOMALY_DETECTORS), RDC_ST_BAD_PARAMETER);
+
+  // One score field per detector
+  uint32_t field_ids[MAX_NUM_FIELDS];
+  uint32_t field_count = 0;
+  ASSERT_EQ(detector.rdc_telemetry_fields_query(field_ids, &field_count), RDC_ST_OK);
+  ASSERT_EQ(field_count, static_cast<uint32_t>(RDC_MAX_ANOMALY_DETECTORS));
+  EXPECT_EQ(field_ids[0], RDC_FI_ANOMALY_SCORE_0);
+  EXPECT_EQ(field_ids[7], RDC_FI_ANOMALY_SCORE_7);
+
+  rdc_gpu_field_t fields[] = {{0, RDC_FI_ANOMALY_SCORE_3}, {0, RDC_FI_POWER_USAGE}};
+  std::vector<rdc_gpu_field_value_t> values;
+  ASSERT_EQ(detector.rdc_telemetry_fields_value_get(fields, 2, save_value, &values), RDC_ST_OK);
+  ASSERT_EQ(values.size(), 2u);
+  EXPECT_EQ(values[0].field_value.status, RDC_ST_NOT_FOUND);
+  EXPECT_EQ(values[1].field_value.status, RDC_ST_NOT_SUPPORTED);
+
+  ASSERT_EQ(detector.set_detector(3, power_detector(0.1, 3, 0)), RDC_ST_OK);
+  std::vector<rdc_evnt_notification_t> events;
+  for (uint32_t i = 0; i < 5; i++) {
+    detector.evaluate(0, power(1000 * (i + 1), 100 + i), &events);
+  }
+  EXPECT_EQ(score_of(&detector, 3, 0).status, RDC_ST_OK);
+
+  // Setting a detector again restarts its baselines
+  ASSERT_EQ(detector.set_detector(3, power_detector(0.1, 3, 0)), RDC_ST_OK);
+  EXPECT_EQ(score_of(&detector, 3, 0).status, RDC_ST_NOT_FOUND);
+
+  // A cleared detector neither scores nor raises
+  for (uint32_t i = 0; i < 5; i++) {
+    detector.evaluate(0, power(1000 * (i + 1), 100 + i), &events);
+  }
+  ASSERT_EQ(detector.clear_detector(3), RDC_ST_OK);
+  EXPECT_EQ(detector.clear_detector(3), RDC_ST_NOT_FOUND);
+  EXPECT_EQ(score_of(&detector, 3, 0).status, RDC_ST_NOT_FOUND);
+  detector.evaluate(0, power(10000, 1000), &events);
+  EXPECT_TRUE(events.empty());
+}
+
+TEST(rdctstUnit, AnomalyDetectorCApi) {
+  rdc_anomaly_config_t config = power_detector(0.1, 3, 0);
+  EXPECT_EQ(rdc_anomaly_set_detector(nullptr, 0, &config), RDC_ST_INVALID_HANDLER);
+  EXPECT_EQ(rdc_anomaly_clear_detector(nullptr, 0), RDC_ST_INVALID_HANDLER);
+
+  if (rdc_init(0) != RDC_ST_OK) {
+    GTEST_SKIP() << "Fail to initialize RDC";
+  }
+  rdc_handle_t rdc_handle = nullptr;
+  if (rdc_start_embedded(RDC_OPERATION_MODE_MANUAL, &rdc_handle) != RDC_ST_OK) {
+    rdc_shutdown();
+    GTEST_SKIP() << "No embedded RDC to set the detectors on";
+  }
+  EXPECT_EQ(rdc_anomaly_set_detector(rdc_handle, 0, nullptr), RDC_ST_INVALID_HANDLER);
+  EXPECT_EQ(rdc_anomaly_set_detector(rdc_handle, RDC_MAX_ANOMALY_DETECTORS, &config),
+            RDC_ST_BAD_PARAMETER);
+  EXPECT_EQ(rdc_anomaly_set_detector(rdc_handle, 0, &config), RDC_ST_OK);
+  EXPECT_EQ(rdc_anomaly_clear_detector(rdc_handle, 0), RDC_ST_OK);
+  EXPECT_EQ(rdc_anomaly_clear_detector(rdc_handle, 0), RDC_ST_NOT_FOUND);
+  rdc_stop_embedded(rdc_handle);
+  rdc_shutdown();
+}
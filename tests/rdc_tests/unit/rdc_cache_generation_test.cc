@@ -0,0 +1,98 @@
+/*
+Copyright (c) 2024 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <map>
+
+#include "rdc/rdc.h"
+#include "rdc_lib/impl/RdcCacheManagerImpl.h"
+#include "rdc_lib/rdc_common.h"
+#include "rdc_tests/test_utils.h"
+
+using amd::rdc::RdcCacheManagerImpl;
+
+namespace {
+
+const rdc_field_t kFields[] = {
+    RDC_FI_GPU_MEMORY_USAGE, RDC_FI_GPU_MEMORY_TOTAL, RDC_FI_POWER_USAGE,
+    RDC_FI_GPU_CLOCK,        RDC_FI_GPU_UTIL,         RDC_FI_GPU_TEMP,
+};
+
+}  // namespace
+
+TEST(rdctstUnit, CacheGenerationsArePerField) {
+  RdcCacheManagerImpl cache;
+  RdcFieldKey power = {0, RDC_FI_POWER_USAGE};
+  uint64_t generation = cache.get_generation(power);
+
+  // The samples of another GPU or another field leave it alone
+  ASSERT_EQ(cache.rdc_update_cache(1, integer_value(RDC_FI_POWER_USAGE, 1000, 1)), RDC_ST_OK);
+  ASSERT_EQ(cache.rdc_update_cache(0, integer_value(RDC_FI_GPU_TEMP, 1000, 1)), RDC_ST_OK);
+  EXPECT_EQ(cache.get_generation(power), generation);
+
+  ASSERT_EQ(cache.rdc_update_cache(0, integer_value(RDC_FI_POWER_USAGE, 1000, 1)), RDC_ST_OK);
+  EXPECT_GT(cache.get_generation(power), generation);
+
+  // Emptied by the eviction of its old samples
+  generation = cache.get_generation(power);
+  ASSERT_EQ(cache.evict_cache(0, RDC_FI_POWER_USAGE, 10, 1), RDC_ST_OK);
+  EXPECT_GT(cache.get_generation(power), generation);
+}
+
+// 8 GPUs sampled one after another within each update interval, with the
+// latest value of every field read after each GPU is sampled. A reply is
+// reused while the generation of its field has not moved, so only the read
+// following the sample of its own GPU is built again: 7 reads in 8 hit. A
+// single generation of the whole cache would make every read miss.
+TEST(rdctstUnit, CacheGenerationsHitRate) {
+  const uint32_t kGpus = 8;
+  const uint32_t kIntervals = 100;
+  RdcCacheManagerImpl cache;
+  std::map<RdcFieldKey, uint64_t> replies;
+  uint64_t hits = 0;
+  uint64_t reads = 0;
+  for (uint32_t interval = 0; interval < kIntervals; interval++) {
+    for (uint32_t sampled = 0; sampled < kGpus; sampled++) {
+      for (rdc_field_t field_id : kFields) {
+        ASSERT_EQ(cache.rdc_update_cache(sampled, integer_value(field_id, interval, interval)),
+                  RDC_ST_OK);
+      }
+      for (uint32_t gpu = 0; gpu < kGpus; gpu++) {
+        for (rdc_field_t field_id : kFields) {
+          RdcFieldKey field = {gpu, field_id};
+          uint64_t generation = cache.get_generation(field);
+          auto ite = replies.find(field);
+          if (interval > 0 && ite != replies.end() && ite->second == generation) {
+            hits++;
+          }
+          replies[field] = generation;
+          reads += interval > 0 ? 1 : 0;
+        }
+      }
+    }
+  }
+  // Fields sharing a generation stripe may lower it a little
+  EXPECT_GE(static_cast<double>(hits) / reads, 0.8);
+  EXPECT_LE(static_cast<double>(hits) / reads, 7.0 / 8);
+}
@@ -0,0 +1,270 @@
+/*
+Copyright (c) 2024 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <sys/time.h>
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "rdc/rdc.h"
+#include "rdc_lib/impl/RdcCacheManagerImpl.h"
+#include "rdc_lib/impl/RdcCompressedBlock.h"
+#include "rdc_tests/test_utils.h"
+
+using amd::rdc::RdcCacheManagerImpl;
+using amd::rdc::RdcCompressedBlock;
+
+namespace {
+
+uint64_t now_ms() {
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return static_cast<uint64_t>(tv.tv_sec) * 1000 + tv.tv_usec / 1000;
+}
+
+// The environment is read when the cache manager is constructed
+std::unique_ptr<RdcCacheManagerImpl> make_cache(const char* cold_age, const char* tiers) {
+  if (cold_age != nullptr) {
+    setenv("RDC_CACHE_COLD_AGE", cold_age, 1);
+  }
+  if (tiers != nullptr) {
+    setenv("RDC_ROLLUP_TIERS", tiers, 1);
+  }
+  std::unique_ptr<RdcCacheManagerImpl> cache(new RdcCacheManagerImpl());
+  unsetenv("RDC_CACHE_COLD_AGE");
+  unsetenv("RDC_ROLLUP_TIERS");
+  return cache;
+}
+
+}  // namespace
+
+TEST(rdctstUnit, CompressedBlockRoundTrip) {
+  RdcCompressedBlock ints(INTEGER);
+  RdcCompressedBlock doubles(DOUBLE);
+  std::vector<uint64_t> times;
+  std::vector<int64_t> int_values;
+  std::vector<double> double_values;
+
+  // Steady, jittered and large gaps, with repeated and far apart values
+  uint64_t ts = 1700000000000;
+  for (uint32_t i = 0; i < 300; i++) {
+    ts += i % 7 == 0 ? 1000 : (i % 11 == 0 ? 123456789 : 1000 + i % 5);
+    times.push_back(ts);
+    int_values.push_back(i % 3 == 0 ? 42 : static_cast<int64_t>(i) * (i % 2 ? -9973 : 31));
+    double_values.push_back(i % 4 == 0 ? 1.5 : i * 0.1 - 7.25);
+
+    rdc_field_value_data value;
+    value.l_int = int_values.back();
+    ASSERT_TRUE(ints.append(ts, value));
+    value.dbl = double_values.back();
+    ASSERT_TRUE(doubles.append(ts, value));
+  }
+  rdc_field_value_data value;
+  value.l_int = std::numeric_limits<int64_t>::min();
+  ASSERT_TRUE(ints.append(ts + 1, value));
+  times.push_back(ts + 1);
+  int_values.push_back(value.l_int);
+
+  EXPECT_EQ(ints.count(), times.size());
+  EXPECT_EQ(ints.first_time(), times.front());
+  EXPECT_EQ(ints.last_time(), times.back());
+
+  RdcCompressedBlock::Reader int_reader(ints);
+  for (size_t i = 0; i < times.size(); i++) {
+    uint64_t read_ts = 0;
+    ASSERT_TRUE(int_reader.next(&read_ts, &value));
+    EXPECT_EQ(read_ts, times[i]);
+    EXPECT_EQ(value.l_int, int_values[i]);
+  }
+  uint64_t read_ts = 0;
+  EXPECT_FALSE(int_reader.next(&read_ts, &value));
+
+  // A block read back from its bytes decodes the same
+  RdcCompressedBlock copy(DOUBLE, doubles.count(), doubles.data().data(), doubles.data().size());
+  RdcCompressedBlock::Reader double_reader(copy);
+  for (size_t i = 0; i < double_values.size(); i++) {
+    ASSERT_TRUE(double_reader.next(&read_ts, &value));
+    EXPECT_EQ(read_ts, times[i]);
+    EXPECT_EQ(value.dbl, double_values[i]);
+  }
+  EXPECT_FALSE(double_reader.next(&read_ts, &value));
+}
+
+TEST(rdctstUnit, CompressedBlockFull) {
+  RdcCompressedBlock block(INTEGER);
+  rdc_field_value_data value;
+  value.l_int = 1;
+  for (uint32_t i = 0; i < RdcCompressedBlock::kMaxSamples; i++) {
+    ASSERT_TRUE(block.append(1000 + i, value));
+  }
+  EXPECT_TRUE(block.full());
+  // A steady interval and an unchanged value cost two bits per sample
+  EXPECT_LT(block.data().size(), 16 + RdcCompressedBlock::kMaxSamples / 4 + 8);
+  EXPECT_FALSE(block.append(1000 + RdcCompressedBlock::kMaxSamples, value));
+}
+
+TEST(rdctstUnit, ColdSamplesStayReadable) {
+  // Samples older than 10 seconds are sealed when the field is evicted
+  auto cache = make_cache("10", "none");
+  const rdc_field_t field = RDC_FI_GPU_TEMP;
+  const uint64_t start = now_ms() - 100 * 1000;
+  for (uint32_t i = 0; i < 100; i++) {
+    ASSERT_EQ(cache->rdc_update_cache(0, integer_value(field, start + i * 1000, 40 + i % 9)),
+              RDC_ST_OK);
+  }
+  uint64_t hot_samples = 0;
+  uint64_t hot_bytes = 0;
+  cache->get_cache_usage(&hot_samples, &hot_bytes);
+  ASSERT_EQ(cache->evict_cache(0, field, 1000, 3600), RDC_ST_OK);
+  uint64_t samples = 0;
+  uint64_t bytes = 0;
+  cache->get_cache_usage(&samples, &bytes);
+  EXPECT_LT(bytes, hot_bytes);
+
+  // Every sample is still returned in order, across the sealed blocks and
+  // into the uncompressed ones
+  uint64_t since = 0;
+  for (uint32_t i = 0; i < 100; i++) {
+    rdc_field_value value;
+    uint64_t next_since = 0;
+    ASSERT_EQ(cache->rdc_field_get_value_since(0, field, since, &next_since, &value), RDC_ST_OK);
+    EXPECT_EQ(value.ts, start + i * 1000);
+    EXPECT_EQ(value.type, INTEGER);
+    EXPECT_EQ(value.value.l_int, 40 + i % 9);
+    since = next_since;
+  }
+
+  rdc_field_value latest;
+  ASSERT_EQ(cache->rdc_field_get_latest_value(0, field, &latest), RDC_ST_OK);
+  EXPECT_EQ(latest.ts, start + 99 * 1000);
+
+  std::unique_ptr<rdc_field_rollups_t> rollups(new rdc_field_rollups_t);
+  ASSERT_EQ(cache->rdc_field_get_rollup(0, field, start + 5000, start + 95000, rollups.get()),
+            RDC_ST_OK);
+  EXPECT_EQ(rollups->resolution_ms, 0u);
+  ASSERT_EQ(rollups->num_buckets, 91u);
+  for (uint32_t i = 0; i < rollups->num_buckets; i++) {
+    EXPECT_EQ(rollups->buckets[i].start_ts, start + (i + 5) * 1000);
+    EXPECT_EQ(rollups->buckets[i].count, 1u);
+    EXPECT_EQ(rollups->buckets[i].last_value, 40 + (i + 5) % 9);
+  }
+}
+
+TEST(rdctstUnit, ColdBlocksAreEvicted) {
+  auto cache = make_cache("1", "none");
+  const rdc_field_t field = RDC_FI_GPU_TEMP;
+  const uint64_t start = now_ms() - 3000 * 1000;
+  for (uint32_t i = 0; i < 3000; i++) {
+    ASSERT_EQ(cache->rdc_update_cache(0, integer_value(field, start + i * 1000, i)), RDC_ST_OK);
+  }
+  ASSERT_EQ(cache->evict_cache(0, field, 1 << 20, 3600), RDC_ST_OK);
+
+  // Keep about 1000 seconds, the blocks are dropped whole
+  ASSERT_EQ(cache->evict_cache(0, field, 1 << 20, 1000), RDC_ST_OK);
+  rdc_field_value value;
+  uint64_t next_since = 0;
+  ASSERT_EQ(cache->rdc_field_get_value_since(0, field, 0, &next_since, &value), RDC_ST_OK);
+  EXPECT_GE(value.ts + 1000 * 1000 + RdcCompressedBlock::kMaxSamples * 1000, now_ms());
+  EXPECT_LE(value.ts + 1000 * 1000, now_ms());
+}
+
+TEST(rdctstUnit, RollupTiers) {
+  // 10 second buckets kept for 100 seconds, 60 second buckets for an hour
+  auto cache = make_cache(nullptr, "10:100,60:3600");
+  const rdc_field_t field = RDC_FI_POWER_USAGE;
+  const uint64_t start = (now_ms() / 60000 - 30) * 60000;
+  for (uint32_t i = 0; i < 30 * 60; i++) {
+    ASSERT_EQ(cache->rdc_update_cache(0, integer_value(field, start + i * 1000, i % 60)),
+              RDC_ST_OK);
+  }
+  // Only the last sample is kept raw
+  ASSERT_EQ(cache->evict_cache(0, field, 1, 3600), RDC_ST_OK);
+
+  std::unique_ptr<rdc_field_rollups_t> rollups(new rdc_field_rollups_t);
+  const uint64_t end = start + 30 * 60 * 1000 - 1;
+
+  // The finest tier reaching back to the start of the range
+  ASSERT_EQ(cache->rdc_field_get_rollup(0, field, end - 50 * 1000, end, rollups.get()),
+            RDC_ST_OK);
+  EXPECT_EQ(rollups->resolution_ms, 10000u);
+  ASSERT_EQ(rollups->num_buckets, 6u);
+  for (uint32_t i = 0; i < rollups->num_buckets; i++) {
+    const rdc_field_rollup_t& bucket = rollups->buckets[i];
+    EXPECT_EQ(bucket.start_ts % 10000, 0u);
+    EXPECT_EQ(bucket.count, 10u);
+    EXPECT_EQ(bucket.max_value - bucket.min_value, 9);
+    EXPECT_EQ(bucket.sum, 10 * bucket.min_value + 45);
+    EXPECT_EQ(bucket.last_value, bucket.max_value);
+    EXPECT_EQ(bucket.last_ts, bucket.start_ts + 9000);
+  }
+
+  // The 10 second tier no longer reaches back 20 minutes
+  ASSERT_EQ(cache->rdc_field_get_rollup(0, field, end - 20 * 60 * 1000, end, rollups.get()),
+            RDC_ST_OK);
+  EXPECT_EQ(rollups->resolution_ms, 60000u);
+  ASSERT_EQ(rollups->num_buckets, 21u);
+  const rdc_field_rollup_t& bucket = rollups->buckets[1];
+  EXPECT_EQ(bucket.count, 60u);
+  EXPECT_EQ(bucket.min_value, 0);
+  EXPECT_EQ(bucket.max_value, 59);
+  EXPECT_EQ(bucket.sum, 59 * 60 / 2);
+  EXPECT_EQ(bucket.last_value, 59);
+
+  // Nothing was rolled up before the first sample
+  ASSERT_EQ(cache->rdc_field_get_rollup(0, field, start - 3600 * 1000, end, rollups.get()),
+            RDC_ST_OK);
+  EXPECT_EQ(rollups->resolution_ms, 60000u);
+  EXPECT_EQ(rollups->num_buckets, 30u);
+
+  EXPECT_EQ(cache->rdc_field_get_rollup(0, field, end, start, rollups.get()),
+            RDC_ST_BAD_PARAMETER);
+  EXPECT_EQ(cache->rdc_field_get_rollup(1, field, start, end, rollups.get()), RDC_ST_NOT_FOUND);
+}
+
+TEST(rdctstUnit, RollupTiersFromEnvironment) {
+  // An invalid specification falls back to the default tiers
+  auto cache = make_cache(nullptr, "60:10");
+  const rdc_field_t field = RDC_FI_POWER_USAGE;
+  const uint64_t start = (now_ms() / 10000 - 12) * 10000;
+  for (uint32_t i = 0; i < 120; i++) {
+    ASSERT_EQ(cache->rdc_update_cache(0, integer_value(field, start + i * 1000, 1)), RDC_ST_OK);
+  }
+  ASSERT_EQ(cache->evict_cache(0, field, 1, 3600), RDC_ST_OK);
+  std::unique_ptr<rdc_field_rollups_t> rollups(new rdc_field_rollups_t);
+  ASSERT_EQ(cache->rdc_field_get_rollup(0, field, start, start + 119 * 1000, rollups.get()),
+            RDC_ST_OK);
+  EXPECT_EQ(rollups->resolution_ms, 10000u);
+  EXPECT_EQ(rollups->num_buckets, 12u);
+
+  // "none" only keeps the raw samples
+  cache = make_cache(nullptr, "none");
+  for (uint32_t i = 0; i < 120; i++) {
+    ASSERT_EQ(cache->rdc_update_cache(0, integer_value(field, start + i * 1000, 1)), RDC_ST_OK);
+  }
+  ASSERT_EQ(cache->evict_cache(0, field, 1, 3600), RDC_ST_OK);
+  EXPECT_EQ(cache->rdc_field_get_rollup(0, field, start, start + 100 * 1000, rollups.get()),
+            RDC_ST_NOT_FOUND);
+}
@@ -0,0 +1,91 @@
+/*
+Copyright (c) 2024 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "rdc/rdc.h"
+#include "rdc_lib/impl/RdcCacheManagerImpl.h"
+#include "rdc_lib/impl/RdcPolicyEngine.h"
+#include "rdc_lib/impl/RdcWatchTableImpl.h"
+
+using amd::rdc::RdcCacheManagerImpl;
+using amd::rdc::RdcPolicyEngine;
+using amd::rdc::RdcWatchTableImpl;
+
+namespace {
+
+rdc_field_value ecc_total(uint64_t ts, int64_t value) {
+  rdc_field_value field = {};
+  field.field_id = RDC_FI_ECC_CORRECT_TOTAL;
+  field.status = RDC_ST_OK;
+  field.type = INTEGER;
+  field.ts = ts;
+  field.value.l_int = value;
+  return field;
+}
+
+}  // namespace
+
+TEST(rdctstUnit, CounterRatesGoThroughTheIngestPath) {
+  auto cache_mgr = std::make_shared<RdcCacheManagerImpl>();
+  auto policy = std::make_shared<RdcPolicyEngine>();
+  rdc_policy_rule_t rule = {};
+  rule.gpu_index = GPU_ID_INVALID;
+  rule.field_id = RDC_FI_ECC_CORRECT_RATE;
+  rule.condition = RDC_POLICY_ABOVE;
+  rule.threshold = 5;
+  uint32_t rule_id = 0;
+  ASSERT_EQ(policy->add_rule(rule, &rule_id), RDC_ST_OK);
+  RdcWatchTableImpl watch_table(nullptr, cache_mgr, nullptr, nullptr, nullptr, policy, nullptr,
+                                nullptr);
+
+  rdc_field_value values[] = {ecc_total(1000, 100), ecc_total(3000, 120), ecc_total(4000, 110),
+                              ecc_total(5000, 113)};
+  ASSERT_EQ(watch_table.rdc_field_ingest(0, values, 2, 60, 100), RDC_ST_OK);
+
+  // The rate is cached from the second sample, 20 errors in 2 seconds
+  rdc_field_value rate;
+  ASSERT_EQ(cache_mgr->rdc_field_get_latest_value(0, RDC_FI_ECC_CORRECT_RATE, &rate), RDC_ST_OK);
+  EXPECT_EQ(rate.ts, 3000u);
+  EXPECT_EQ(rate.type, DOUBLE);
+  EXPECT_DOUBLE_EQ(rate.value.dbl, 10);
+
+  // The policy engine saw the rate, and its violation is cached as an event
+  rdc_policy_violations_t violations;
+  ASSERT_EQ(policy->get_violations(0, 0, &violations), RDC_ST_OK);
+  ASSERT_EQ(violations.num_violations, 1u);
+  EXPECT_EQ(violations.violations[0].field_id, RDC_FI_ECC_CORRECT_RATE);
+  rdc_field_value event;
+  ASSERT_EQ(cache_mgr->rdc_field_get_latest_value(0, RDC_EVNT_NOTIF_POLICY_VIOLATION, &event),
+            RDC_ST_OK);
+  EXPECT_EQ(event.value.l_int, rule_id);
+
+  // A counter going back was reset, so the rate starts over from there
+  ASSERT_EQ(watch_table.rdc_field_ingest(0, values + 2, 2, 60, 100), RDC_ST_OK);
+  ASSERT_EQ(cache_mgr->rdc_field_get_latest_value(0, RDC_FI_ECC_CORRECT_RATE, &rate), RDC_ST_OK);
+  EXPECT_EQ(rate.ts, 5000u);
+  EXPECT_DOUBLE_EQ(rate.value.dbl, 3);
+}
@@ -0,0 +1,210 @@
+/*
+Copyright (c) 2024 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "rdc/rdc.h"
+#include "rdc_lib/impl/RdcDerivedFields.h"
+#include "rdc_lib/rdc_common.h"
+
+using amd::rdc::RdcDerivedFields;
+
+namespace {
+
+const uint64_t kUpdateFreq = 1000000;  // 1 second, in microseconds
+
+rdc_field_value sample(rdc_field_t field_id, uint64_t ts, double value) {
+  rdc_field_value field = {};
+  field.field_id = field_id;
+  field.status = RDC_ST_OK;
+  field.type = DOUBLE;
+  field.ts = ts;
+  field.value.dbl = value;
+  return field;
+}
+
+// The value of a derived field per GPU, the GPUs without a result left out
+std::map<uint32_t, double> results(RdcDerivedFields* derived, rdc_field_t field_id,
+                                   const std::vector<uint32_t>& gpus) {
+  std::vector<rdc_gpu_field_t> fields;
+  for (auto gpu : gpus) {
+    fields.push_back({gpu, field_id});
+  }
+  std::map<uint32_t, double> values;
+  derived->rdc_telemetry_fields_value_get(
+      fields.data(), fields.size(),
+      [](rdc_gpu_field_value_t* v, uint32_t n, void* user_data) {
+        auto values = static_cast<std::map<uint32_t, double>*>(user_data);
+        for (uint32_t i = 0; i < n; i++) {
+          if (v[i].field_value.status == RDC_ST_OK) {
+            (*values)[v[i].gpu_index] = v[i].field_value.value.dbl;
+          }
+        }
+        return RDC_ST_OK;
+      },
+      &values);
+  return values;
+}
+
+void watch(RdcDerivedFields* derived, rdc_field_t field_id, const std::vector<uint32_t>& gpus) {
+  std::map<RdcFieldKey, uint64_t> update_freqs;
+  for (auto gpu : gpus) {
+    update_freqs[{gpu, field_id}] = kUpdateFreq;
+  }
+  derived->set_watched(update_freqs);
+}
+
+}  // namespace
+
+TEST(rdctstUnit, DerivedFieldExpressions) {
+  RdcDerivedFields derived;
+  for (const char* expression : {"RDC_FI_POWER_USAGE +", "FOO", "(1+2", "sum(RDC_FI_POWER_USAGE",
+                                 "1 2", "RDC_FI_DERIVED_0 * 2"}) {
+    EXPECT_EQ(derived.set_expression(RDC_FI_DERIVED_0, expression), RDC_ST_BAD_PARAMETER)
+        << expression;
+  }
+  EXPECT_EQ(derived.set_expression(RDC_FI_GPU_TEMP, "1"), RDC_ST_BAD_PARAMETER);
+  ASSERT_EQ(derived.set_expression(RDC_FI_DERIVED_0,
+                                   "RDC_FI_GPU_MEMORY_USAGE * 100 / RDC_FI_GPU_MEMORY_TOTAL"),
+            RDC_ST_OK);
+
+  char path[] = "/tmp/rdc_derived_XXXXXX";
+  int fd = mkstemp(path);
+  ASSERT_GE(fd, 0);
+  close(fd);
+  std::ofstream(path) << "# comment\nRDC_FI_DERIVED_1 = -(RDC_FI_GPU_TEMP - 5)\n\nbogus line\n";
+  EXPECT_EQ(derived.load_file(path), RDC_ST_BAD_PARAMETER);
+  unlink(path);
+
+  watch(&derived, RDC_FI_DERIVED_0, {0});
+  derived.evaluate(0, sample(RDC_FI_GPU_MEMORY_TOTAL, 1000, 200));
+  derived.evaluate(0, sample(RDC_FI_GPU_MEMORY_USAGE, 1000, 50));
+  EXPECT_DOUBLE_EQ(results(&derived, RDC_FI_DERIVED_0, {0})[0], 25);
+
+  // Not computed on the GPUs it is not watched on
+  derived.evaluate(1, sample(RDC_FI_GPU_MEMORY_TOTAL, 1000, 200));
+  derived.evaluate(1, sample(RDC_FI_GPU_MEMORY_USAGE, 1000, 50));
+  EXPECT_EQ(results(&derived, RDC_FI_DERIVED_0, {1}).size(), 0u);
+
+  // The expression of the file was set despite the bogus line
+  std::map<RdcFieldKey, uint64_t> update_freqs = {{{0, RDC_FI_DERIVED_1}, kUpdateFreq}};
+  derived.set_watched(update_freqs);
+  derived.evaluate(0, sample(RDC_FI_GPU_TEMP, 2000, 45));
+  EXPECT_DOUBLE_EQ(results(&derived, RDC_FI_DERIVED_1, {0})[0], -40);
+
+  EXPECT_EQ(derived.clear_expression(RDC_FI_DERIVED_1), RDC_ST_OK);
+  EXPECT_EQ(derived.clear_expression(RDC_FI_DERIVED_1), RDC_ST_NOT_FOUND);
+}
+
+TEST(rdctstUnit, DerivedAggregatesRunOverTheWatchedGpus) {
+  RdcDerivedFields derived;
+  ASSERT_EQ(derived.set_expression(RDC_FI_DERIVED_0,
+                                   "RDC_FI_POWER_USAGE * 100 / sum(RDC_FI_POWER_USAGE)"),
+            RDC_ST_OK);
+  ASSERT_EQ(derived.set_expression(RDC_FI_DERIVED_1,
+                                   "avg(RDC_FI_POWER_USAGE) + min(RDC_FI_POWER_USAGE) * 0 + "
+                                   "max(RDC_FI_POWER_USAGE) * 0"),
+            RDC_ST_OK);
+  std::map<RdcFieldKey, uint64_t> update_freqs;
+  for (uint32_t gpu : {0, 1}) {
+    update_freqs[{gpu, RDC_FI_DERIVED_0}] = kUpdateFreq;
+    update_freqs[{gpu, RDC_FI_DERIVED_1}] = kUpdateFreq;
+  }
+  derived.set_watched(update_freqs);
+
+  // GPU 2 is outside the watched group
+  derived.evaluate(2, sample(RDC_FI_POWER_USAGE, 1000, 1000));
+  derived.evaluate(0, sample(RDC_FI_POWER_USAGE, 1000, 100));
+  derived.evaluate(1, sample(RDC_FI_POWER_USAGE, 1000, 300));
+
+  auto shares = results(&derived, RDC_FI_DERIVED_0, {0, 1, 2});
+  ASSERT_EQ(shares.size(), 2u);
+  EXPECT_DOUBLE_EQ(shares[0], 25);
+  EXPECT_DOUBLE_EQ(shares[1], 75);
+  auto averages = results(&derived, RDC_FI_DERIVED_1, {0, 1});
+  EXPECT_DOUBLE_EQ(averages[0], 200);
+  EXPECT_DOUBLE_EQ(averages[1], 200);
+
+  // A sample of GPU 1 updates the aggregate of GPU 0 too
+  derived.evaluate(1, sample(RDC_FI_POWER_USAGE, 2000, 500));
+  averages = results(&derived, RDC_FI_DERIVED_1, {0, 1});
+  EXPECT_DOUBLE_EQ(averages[0], 300);
+  EXPECT_DOUBLE_EQ(averages[1], 300);
+}
+
+TEST(rdctstUnit, DerivedInputsExpire) {
+  RdcDerivedFields derived;
+  ASSERT_EQ(derived.set_expression(RDC_FI_DERIVED_0, "sum(RDC_FI_POWER_USAGE)"), RDC_ST_OK);
+  ASSERT_EQ(derived.set_expression(RDC_FI_DERIVED_1, "RDC_FI_POWER_USAGE / RDC_FI_GPU_TEMP"),
+            RDC_ST_OK);
+  std::map<RdcFieldKey, uint64_t> update_freqs;
+  for (uint32_t gpu : {0, 1}) {
+    update_freqs[{gpu, RDC_FI_DERIVED_0}] = kUpdateFreq;
+    update_freqs[{gpu, RDC_FI_DERIVED_1}] = kUpdateFreq;
+  }
+  derived.set_watched(update_freqs);
+
+  derived.evaluate(1, sample(RDC_FI_POWER_USAGE, 1000, 300));
+  derived.evaluate(0, sample(RDC_FI_GPU_TEMP, 1000, 50));
+  // The power of GPU 1 was not fetched for 4 intervals, so it is dropped
+  derived.evaluate(0, sample(RDC_FI_POWER_USAGE, 5000, 100));
+  auto sums = results(&derived, RDC_FI_DERIVED_0, {0, 1});
+  EXPECT_DOUBLE_EQ(sums[0], 100);
+  EXPECT_DOUBLE_EQ(sums[1], 100);
+
+  // Nor is the ratio computed from the old temperature
+  EXPECT_EQ(results(&derived, RDC_FI_DERIVED_1, {0}).size(), 0u);
+  derived.evaluate(0, sample(RDC_FI_GPU_TEMP, 5100, 20));
+  EXPECT_DOUBLE_EQ(results(&derived, RDC_FI_DERIVED_1, {0})[0], 5);
+
+  // The samples of the previous tick still count
+  derived.evaluate(1, sample(RDC_FI_POWER_USAGE, 6200, 200));
+  EXPECT_DOUBLE_EQ(results(&derived, RDC_FI_DERIVED_0, {1})[1], 300);
+}
+
+TEST(rdctstUnit, DerivedFieldInputsAreWatchedWithIt) {
+  RdcDerivedFields derived;
+  ASSERT_EQ(derived.set_expression(RDC_FI_DERIVED_0, "RDC_FI_POWER_USAGE / RDC_FI_GPU_TEMP"),
+            RDC_ST_OK);
+  ASSERT_EQ(derived.set_expression(RDC_FI_DERIVED_1, "RDC_FI_DERIVED_0 + RDC_FI_POWER_USAGE"),
+            RDC_ST_OK);
+
+  std::vector<rdc_field_t> inputs;
+  derived.get_inputs(RDC_FI_DERIVED_1, &inputs);
+  std::sort(inputs.begin(), inputs.end());
+  EXPECT_EQ(inputs, std::vector<rdc_field_t>({RDC_FI_GPU_TEMP, RDC_FI_POWER_USAGE,
+                                              RDC_FI_DERIVED_0}));
+
+  inputs.clear();
+  derived.get_inputs(RDC_FI_GPU_TEMP, &inputs);
+  derived.get_inputs(RDC_FI_DERIVED_2, &inputs);
+  EXPECT_TRUE(inputs.empty());
+}
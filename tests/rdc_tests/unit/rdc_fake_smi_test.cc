@@ -0,0 +1,151 @@
+/*
+Copyright (c) 2024 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+#include <stdlib.h>
+
+#include <cstdint>
+#include <string>
+
+#include "amd_smi/amdsmi.h"
+#include "rdc/rdc.h"
+#include "rdc_lib/impl/FakeSmiBackendImpl.h"
+
+using amd::rdc::FakeSmiBackendImpl;
+using amd::rdc::FakeSmiConfig;
+
+namespace {
+
+uint32_t num_gpus_of(const char* env) {
+  setenv("RDC_FAKE_SMI_GPUS", env, 1);
+  uint32_t num_gpus = FakeSmiConfig::from_env().num_gpus;
+  unsetenv("RDC_FAKE_SMI_GPUS");
+  return num_gpus;
+}
+
+}  // namespace
+
+TEST(rdctstUnit, FakeSmiConfigFromEnv) {
+  FakeSmiConfig config = FakeSmiConfig::from_env();
+  EXPECT_EQ(config.num_gpus, 8u);
+  EXPECT_EQ(config.call_latency_us, 0u);
+  EXPECT_EQ(config.event_interval_ms, 0u);
+  EXPECT_TRUE(config.unsupported_calls.empty());
+
+  // Zero and invalid counts keep the default, too many are clamped
+  EXPECT_EQ(num_gpus_of("4"), 4u);
+  EXPECT_EQ(num_gpus_of("0"), 8u);
+  EXPECT_EQ(num_gpus_of("four"), 8u);
+  EXPECT_EQ(num_gpus_of("4x"), 8u);
+  EXPECT_EQ(num_gpus_of("-1"), 8u);
+  EXPECT_EQ(num_gpus_of("4294967297"), 8u);
+  EXPECT_EQ(num_gpus_of("1000"), static_cast<uint32_t>(RDC_MAX_NUM_DEVICES));
+
+  setenv("RDC_FAKE_SMI_LATENCY_US", "5", 1);
+  setenv("RDC_FAKE_SMI_EVENT_INTERVAL_MS", "20", 1);
+  setenv("RDC_FAKE_SMI_UNSUPPORTED", "get_power_info,,get_temp_metric", 1);
+  config = FakeSmiConfig::from_env();
+  unsetenv("RDC_FAKE_SMI_LATENCY_US");
+  unsetenv("RDC_FAKE_SMI_EVENT_INTERVAL_MS");
+  unsetenv("RDC_FAKE_SMI_UNSUPPORTED");
+  EXPECT_EQ(config.call_latency_us, 5u);
+  EXPECT_EQ(config.event_interval_ms, 20u);
+  EXPECT_EQ(config.unsupported_calls.size(), 2u);
+  EXPECT_EQ(config.unsupported_calls.count("get_power_info"), 1u);
+  EXPECT_EQ(config.unsupported_calls.count("get_temp_metric"), 1u);
+}
+
+TEST(rdctstUnit, FakeSmiUnsupportedCalls) {
+  FakeSmiConfig config;
+  config.num_gpus = 2;
+  config.unsupported_calls.insert("get_power_info");
+  FakeSmiBackendImpl smi(config);
+  ASSERT_EQ(smi.init(0), AMDSMI_STATUS_SUCCESS);
+
+  uint32_t num_sockets = 0;
+  ASSERT_EQ(smi.get_socket_handles(&num_sockets, nullptr), AMDSMI_STATUS_SUCCESS);
+  ASSERT_EQ(num_sockets, 2u);
+  amdsmi_socket_handle sockets[2];
+  ASSERT_EQ(smi.get_socket_handles(&num_sockets, sockets), AMDSMI_STATUS_SUCCESS);
+  amdsmi_processor_handle gpu = nullptr;
+  uint32_t num_processors = 1;
+  ASSERT_EQ(smi.get_processor_handles(sockets[1], &num_processors, &gpu), AMDSMI_STATUS_SUCCESS);
+  ASSERT_NE(gpu, nullptr);
+
+  amdsmi_power_info_t power;
+  EXPECT_EQ(smi.get_power_info(gpu, &power), AMDSMI_STATUS_NOT_SUPPORTED);
+  int64_t temperature = 0;
+  EXPECT_EQ(smi.get_temp_metric(gpu, AMDSMI_TEMPERATURE_TYPE_EDGE, AMDSMI_TEMP_CURRENT,
+                                &temperature),
+            AMDSMI_STATUS_SUCCESS);
+  // Handles beyond the simulated GPUs are rejected
+  EXPECT_EQ(smi.get_temp_metric(nullptr, AMDSMI_TEMPERATURE_TYPE_EDGE, AMDSMI_TEMP_CURRENT,
+                                &temperature),
+            AMDSMI_STATUS_INVAL);
+  EXPECT_EQ(smi.shut_down(), AMDSMI_STATUS_SUCCESS);
+}
+
+TEST(rdctstUnit, FakeSmiGeneratesEvents) {
+  FakeSmiConfig config;
+  config.num_gpus = 2;
+  config.event_interval_ms = 10;
+  FakeSmiBackendImpl smi(config);
+  ASSERT_EQ(smi.init(0), AMDSMI_STATUS_SUCCESS);
+
+  uint32_t num_sockets = 2;
+  amdsmi_socket_handle sockets[2];
+  ASSERT_EQ(smi.get_socket_handles(&num_sockets, sockets), AMDSMI_STATUS_SUCCESS);
+  amdsmi_processor_handle gpu = nullptr;
+  uint32_t num_processors = 1;
+  ASSERT_EQ(smi.get_processor_handles(sockets[1], &num_processors, &gpu), AMDSMI_STATUS_SUCCESS);
+  ASSERT_EQ(smi.init_gpu_event_notification(gpu), AMDSMI_STATUS_SUCCESS);
+  uint64_t mask = AMDSMI_EVENT_MASK_FROM_INDEX(AMDSMI_EVT_NOTIF_VMFAULT) |
+                  AMDSMI_EVENT_MASK_FROM_INDEX(AMDSMI_EVT_NOTIF_THERMAL_THROTTLE);
+  ASSERT_EQ(smi.set_gpu_event_notification_mask(gpu, mask), AMDSMI_STATUS_SUCCESS);
+
+  // Only the GPU listening gets events, of the types in its mask
+  amdsmi_evt_notification_data_t events[4];
+  for (int i = 0; i < 3; i++) {
+    uint32_t num_events = 4;
+    ASSERT_EQ(smi.get_gpu_event_notification(1000, &num_events, events), AMDSMI_STATUS_SUCCESS);
+    ASSERT_EQ(num_events, 1u);
+    EXPECT_EQ(events[0].processor_handle, gpu);
+    EXPECT_TRUE(events[0].event == AMDSMI_EVT_NOTIF_VMFAULT ||
+                events[0].event == AMDSMI_EVT_NOTIF_THERMAL_THROTTLE);
+    EXPECT_EQ(std::string(events[0].message).find("Simulated event"), 0u);
+  }
+
+  // Nothing once the GPU stops listening
+  ASSERT_EQ(smi.stop_gpu_event_notification(gpu), AMDSMI_STATUS_SUCCESS);
+  uint32_t num_events = 4;
+  ASSERT_EQ(smi.get_gpu_event_notification(100, &num_events, events), AMDSMI_STATUS_SUCCESS);
+  EXPECT_EQ(num_events, 0u);
+
+  // Events can be disabled altogether
+  config.event_interval_ms = 0;
+  FakeSmiBackendImpl quiet(config);
+  ASSERT_EQ(quiet.init(0), AMDSMI_STATUS_SUCCESS);
+  ASSERT_EQ(quiet.set_gpu_event_notification_mask(gpu, mask), AMDSMI_STATUS_SUCCESS);
+  num_events = 4;
+  ASSERT_EQ(quiet.get_gpu_event_notification(20, &num_events, events), AMDSMI_STATUS_SUCCESS);
+  EXPECT_EQ(num_events, 0u);
+}
@@ -0,0 +1,171 @@
+/*
+Copyright (c) 2024 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+#include <sys/time.h>
+
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "rdc/rdc.h"
+#include "rdc_lib/impl/RdcCacheManagerImpl.h"
+#include "rdc_tests/test_utils.h"
+
+using amd::rdc::RdcCacheManagerImpl;
+
+namespace {
+
+uint64_t now_ms() {
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return static_cast<uint64_t>(tv.tv_sec) * 1000 + tv.tv_usec / 1000;
+}
+
+class GroupAggregateTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // GPU 0 has three samples, GPU 1 one and GPU 2 none
+    now_ = now_ms();
+    ASSERT_EQ(cache_.rdc_update_cache(0, integer_value(RDC_FI_POWER_USAGE, now_ - 3000, 10)),
+              RDC_ST_OK);
+    ASSERT_EQ(cache_.rdc_update_cache(0, integer_value(RDC_FI_POWER_USAGE, now_ - 2000, 20)),
+              RDC_ST_OK);
+    ASSERT_EQ(cache_.rdc_update_cache(0, integer_value(RDC_FI_POWER_USAGE, now_ - 1000, 30)),
+              RDC_ST_OK);
+    ASSERT_EQ(cache_.rdc_update_cache(1, integer_value(RDC_FI_POWER_USAGE, now_ - 1500, 50)),
+              RDC_ST_OK);
+  }
+
+  rdc_status_t aggregate(uint64_t window_ms, const std::vector<rdc_aggregate_spec_t>& specs) {
+    return cache_.rdc_field_get_group_aggregate(gpus_, fields_, window_ms, specs.data(),
+                                                specs.size(), aggregate_.get());
+  }
+
+  RdcCacheManagerImpl cache_;
+  uint64_t now_ = 0;
+  std::vector<uint32_t> gpus_ = {0, 1, 2};
+  std::vector<rdc_field_t> fields_ = {RDC_FI_POWER_USAGE};
+  std::unique_ptr<rdc_group_aggregate_t> aggregate_{new rdc_group_aggregate_t};
+};
+
+}  // namespace
+
+TEST_F(GroupAggregateTest, SumAndAverageOfTheGpuMeans) {
+  ASSERT_EQ(aggregate(60000, {{RDC_AGGREGATE_SUM, 0}, {RDC_AGGREGATE_AVG, 0}}), RDC_ST_OK);
+  ASSERT_EQ(aggregate_->num_values, 2u);
+
+  // GPU 0 averages 20 over its three samples, GPU 1 has 50, so the
+  // unequal sample counts do not weigh GPU 0 more
+  const rdc_group_aggregate_value_t& sum = aggregate_->values[0];
+  EXPECT_EQ(sum.status, RDC_ST_OK);
+  EXPECT_EQ(sum.field_id, RDC_FI_POWER_USAGE);
+  EXPECT_EQ(sum.spec.op, RDC_AGGREGATE_SUM);
+  EXPECT_DOUBLE_EQ(sum.value, 70);
+  EXPECT_EQ(sum.num_gpus, 2u);
+  EXPECT_EQ(sum.num_samples, 4u);
+  EXPECT_EQ(sum.ts, now_ - 1000);
+  EXPECT_DOUBLE_EQ(aggregate_->values[1].value, 35);
+}
+
+TEST_F(GroupAggregateTest, MinMaxAndLastAreAttributed) {
+  ASSERT_EQ(aggregate(60000, {{RDC_AGGREGATE_MIN, 0},
+                              {RDC_AGGREGATE_MAX, 0},
+                              {RDC_AGGREGATE_LAST, 0}}),
+            RDC_ST_OK);
+  ASSERT_EQ(aggregate_->num_values, 3u);
+
+  const rdc_group_aggregate_value_t& min = aggregate_->values[0];
+  EXPECT_DOUBLE_EQ(min.value, 10);
+  EXPECT_EQ(min.gpu_index, 0u);
+  EXPECT_EQ(min.ts, now_ - 3000);
+  const rdc_group_aggregate_value_t& max = aggregate_->values[1];
+  EXPECT_DOUBLE_EQ(max.value, 50);
+  EXPECT_EQ(max.gpu_index, 1u);
+  EXPECT_EQ(max.ts, now_ - 1500);
+  const rdc_group_aggregate_value_t& last = aggregate_->values[2];
+  EXPECT_DOUBLE_EQ(last.value, 30);
+  EXPECT_EQ(last.gpu_index, 0u);
+  EXPECT_EQ(last.ts, now_ - 1000);
+}
+
+TEST_F(GroupAggregateTest, NearestRankPercentile) {
+  // Over the samples of every GPU sorted: 10, 20, 30, 50
+  ASSERT_EQ(aggregate(60000, {{RDC_AGGREGATE_PERCENTILE, 0},
+                              {RDC_AGGREGATE_PERCENTILE, 25},
+                              {RDC_AGGREGATE_PERCENTILE, 50},
+                              {RDC_AGGREGATE_PERCENTILE, 51},
+                              {RDC_AGGREGATE_PERCENTILE, 75},
+                              {RDC_AGGREGATE_PERCENTILE, 100}}),
+            RDC_ST_OK);
+  ASSERT_EQ(aggregate_->num_values, 6u);
+  double expected[] = {10, 10, 20, 30, 30, 50};
+  for (uint32_t i = 0; i < 6; i++) {
+    EXPECT_EQ(aggregate_->values[i].status, RDC_ST_OK);
+    EXPECT_DOUBLE_EQ(aggregate_->values[i].value, expected[i]) << i;
+    EXPECT_EQ(aggregate_->values[i].num_samples, 4u);
+  }
+  EXPECT_DOUBLE_EQ(aggregate_->values[3].spec.percentile, 51);
+}
+
+TEST_F(GroupAggregateTest, WindowsAndMissingSamples) {
+  // Zero reduces only the latest sample of every GPU
+  ASSERT_EQ(aggregate(0, {{RDC_AGGREGATE_SUM, 0}, {RDC_AGGREGATE_MIN, 0}}), RDC_ST_OK);
+  EXPECT_DOUBLE_EQ(aggregate_->values[0].value, 80);
+  EXPECT_EQ(aggregate_->values[0].num_samples, 2u);
+  EXPECT_DOUBLE_EQ(aggregate_->values[1].value, 30);
+
+  // The window leaves out the oldest sample of GPU 0
+  ASSERT_EQ(aggregate(2500, {{RDC_AGGREGATE_AVG, 0}}), RDC_ST_OK);
+  EXPECT_DOUBLE_EQ(aggregate_->values[0].value, (25 + 50) / 2.0);
+  EXPECT_EQ(aggregate_->values[0].num_samples, 3u);
+
+  // A field without samples is NOT_FOUND, the others are still reduced
+  fields_ = {RDC_FI_GPU_TEMP, RDC_FI_POWER_USAGE};
+  ASSERT_EQ(aggregate(60000, {{RDC_AGGREGATE_MAX, 0}}), RDC_ST_OK);
+  ASSERT_EQ(aggregate_->num_values, 2u);
+  EXPECT_EQ(aggregate_->values[0].field_id, RDC_FI_GPU_TEMP);
+  EXPECT_EQ(aggregate_->values[0].status, RDC_ST_NOT_FOUND);
+  EXPECT_EQ(aggregate_->values[0].num_gpus, 0u);
+  EXPECT_EQ(aggregate_->values[1].status, RDC_ST_OK);
+
+  gpus_ = {2};
+  fields_ = {RDC_FI_POWER_USAGE};
+  ASSERT_EQ(aggregate(60000, {{RDC_AGGREGATE_AVG, 0}}), RDC_ST_OK);
+  EXPECT_EQ(aggregate_->values[0].status, RDC_ST_NOT_FOUND);
+  EXPECT_EQ(aggregate_->values[0].num_samples, 0u);
+}
+
+TEST_F(GroupAggregateTest, InvalidReductionsAreRejected) {
+  EXPECT_EQ(aggregate(60000, {{RDC_AGGREGATE_PERCENTILE, -1}}), RDC_ST_BAD_PARAMETER);
+  EXPECT_EQ(aggregate(60000, {{RDC_AGGREGATE_PERCENTILE, 100.5}}), RDC_ST_BAD_PARAMETER);
+  EXPECT_EQ(aggregate(60000, {{RDC_AGGREGATE_SUM, 0}, {RDC_AGGREGATE_PERCENTILE, NAN}}),
+            RDC_ST_BAD_PARAMETER);
+  EXPECT_EQ(aggregate(60000, {{static_cast<rdc_aggregate_op_t>(RDC_AGGREGATE_PERCENTILE + 1), 0}}),
+            RDC_ST_BAD_PARAMETER);
+  std::vector<rdc_aggregate_spec_t> too_many(RDC_MAX_GROUP_AGGREGATE_OPS + 1,
+                                             {RDC_AGGREGATE_SUM, 0});
+  EXPECT_EQ(aggregate(60000, too_many), RDC_ST_BAD_PARAMETER);
+  // The percentile is only checked for RDC_AGGREGATE_PERCENTILE
+  EXPECT_EQ(aggregate(60000, {{RDC_AGGREGATE_SUM, NAN}}), RDC_ST_OK);
+}
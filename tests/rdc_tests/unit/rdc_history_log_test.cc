@@ -0,0 +1,146 @@
+/*
+Copyright (c) 2024 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rdc/rdc.h"
+#include "rdc_lib/impl/RdcHistoryLog.h"
+#include "rdc_tests/test_utils.h"
+
+using amd::rdc::RdcHistoryLog;
+
+namespace {
+
+const uint64_t kStart = 1700000000000;
+
+class HistoryLogTest : public ::testing::Test {
+ protected:
+  void SetUp() override { ASSERT_FALSE(dir_.path().empty()); }
+
+  // The log writes its last block and seals its segment when destroyed
+  void write(const std::vector<std::pair<uint64_t, int64_t>>& samples) {
+    RdcHistoryLog log(dir_.path(), 1 << 20, 8, 100);
+    for (const auto& sample : samples) {
+      rdc_field_value value = {};
+      value.field_id = RDC_FI_GPU_TEMP;
+      value.status = RDC_ST_OK;
+      value.ts = sample.first;
+      value.type = INTEGER;
+      value.value.l_int = sample.second;
+      log.append(0, value);
+    }
+  }
+
+  // Every page of the range, oldest first
+  std::vector<rdc_field_value> read_all(uint32_t* num_pages) {
+    RdcHistoryLog log(dir_.path(), 1 << 20, 8, 100);
+    std::unique_ptr<rdc_field_history_t> history(new rdc_field_history_t);
+    std::vector<rdc_field_value> values;
+    uint64_t since = 0;
+    *num_pages = 0;
+    do {
+      EXPECT_EQ(log.query(0, RDC_FI_GPU_TEMP, since, std::numeric_limits<uint64_t>::max(),
+                          history.get()),
+                RDC_ST_OK);
+      EXPECT_LE(history->num_values, RDC_MAX_HISTORY_VALUES);
+      values.insert(values.end(), history->values, history->values + history->num_values);
+      EXPECT_TRUE(history->next_since_ts == 0 || history->next_since_ts > since);
+      since = history->next_since_ts;
+      (*num_pages)++;
+    } while (since != 0 && *num_pages < 100);
+    return values;
+  }
+
+  TempDir dir_{"rdctst_history"};
+};
+
+}  // namespace
+
+TEST_F(HistoryLogTest, PagesAcrossOutOfOrderBlocks) {
+  // The second segment holds samples older than the first one
+  std::vector<std::pair<uint64_t, int64_t>> newer;
+  std::vector<std::pair<uint64_t, int64_t>> older;
+  for (int64_t i = 0; i < 400; i++) {
+    newer.push_back({kStart + 1000 + i, 1000 + i});
+    older.push_back({kStart + i, i});
+  }
+  write(newer);
+  write(older);
+
+  uint32_t num_pages = 0;
+  std::vector<rdc_field_value> values = read_all(&num_pages);
+  ASSERT_EQ(values.size(), 800u);
+  EXPECT_EQ(num_pages, 4u);
+  for (size_t i = 0; i < values.size(); i++) {
+    int64_t expected = i < 400 ? i : 1000 + i - 400;
+    EXPECT_EQ(values[i].ts, kStart + expected);
+    EXPECT_EQ(values[i].value.l_int, expected);
+  }
+}
+
+TEST_F(HistoryLogTest, PageEndsOnTimestampBoundary) {
+  // 200 values at each of two timestamps, the second straddles a page
+  std::vector<std::pair<uint64_t, int64_t>> samples;
+  for (int64_t i = 0; i < 400; i++) {
+    samples.push_back({kStart + (i < 200 ? 0 : 10), i});
+  }
+  for (int64_t i = 0; i < 10; i++) {
+    samples.push_back({kStart + 20 + i, 400 + i});
+  }
+  write(samples);
+
+  RdcHistoryLog log(dir_.path(), 1 << 20, 8, 100);
+  std::unique_ptr<rdc_field_history_t> history(new rdc_field_history_t);
+  ASSERT_EQ(log.query(0, RDC_FI_GPU_TEMP, kStart, kStart + 100, history.get()), RDC_ST_OK);
+  EXPECT_EQ(history->num_values, 200u);
+  EXPECT_EQ(history->next_since_ts, kStart + 10);
+  ASSERT_EQ(log.query(0, RDC_FI_GPU_TEMP, history->next_since_ts, kStart + 100, history.get()),
+            RDC_ST_OK);
+  EXPECT_EQ(history->num_values, 210u);
+  EXPECT_EQ(history->next_since_ts, 0u);
+  EXPECT_EQ(history->values[0].ts, kStart + 10);
+  EXPECT_EQ(history->values[209].value.l_int, 409);
+}
+
+TEST_F(HistoryLogTest, MorePageValuesThanOneTimestampHold) {
+  std::vector<std::pair<uint64_t, int64_t>> samples;
+  for (int64_t i = 0; i < 300; i++) {
+    samples.push_back({kStart, i});
+  }
+  for (int64_t i = 0; i < 5; i++) {
+    samples.push_back({kStart + 1 + i, 300 + i});
+  }
+  write(samples);
+
+  // Still advances, past the values of the timestamp a page cannot hold
+  uint32_t num_pages = 0;
+  std::vector<rdc_field_value> values = read_all(&num_pages);
+  EXPECT_EQ(num_pages, 2u);
+  ASSERT_EQ(values.size(), RDC_MAX_HISTORY_VALUES + 5u);
+  EXPECT_EQ(values.back().ts, kStart + 5);
+}
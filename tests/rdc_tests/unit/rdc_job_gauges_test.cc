@@ -0,0 +1,210 @@
+/*
+Copyright (c) 2024 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+#include <sys/time.h>
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "rdc/rdc.h"
+#include "rdc_lib/RdcMetricFetcher.h"
+#include "rdc_lib/RdcWatchTable.h"
+#include "rdc_lib/impl/RdcCacheManagerImpl.h"
+#include "rdc_lib/impl/RdcJobGauges.h"
+#include "rdc_tests/test_utils.h"
+
+using amd::rdc::RDC_ECC_GAUGES_FRESH;
+using amd::rdc::RDC_ECC_GAUGES_MEMOIZED;
+using amd::rdc::RDC_ECC_GAUGES_NONE;
+using amd::rdc::RdcCacheManagerImpl;
+using amd::rdc::RdcJobGauges;
+using amd::rdc::RdcMetricFetcher;
+using amd::rdc::RdcWatchTable;
+
+namespace {
+
+uint64_t now_ms() {
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return static_cast<uint64_t>(tv.tv_sec) * 1000 + tv.tv_usec / 1000;
+}
+
+//!< Counts the fetches, which return the value set for the field
+class CountingFetcher : public RdcMetricFetcher {
+ public:
+  rdc_status_t acquire_smi_handle(RdcFieldKey) override { return RDC_ST_OK; }
+  rdc_status_t delete_smi_handle(RdcFieldKey) override { return RDC_ST_OK; }
+  rdc_status_t fetch_smi_field(uint32_t gpu_index, rdc_field_t field_id,
+                               rdc_field_value* value) override {
+    fetches[{gpu_index, field_id}]++;
+    *value = integer_value(field_id, 0, values[field_id]);
+    return RDC_ST_OK;
+  }
+  rdc_status_t bulk_fetch_smi_fields(rdc_gpu_field_t*, uint32_t,
+                                     std::vector<rdc_gpu_field_value_t>&) override {  // NOLINT
+    return RDC_ST_NOT_SUPPORTED;
+  }
+
+  std::map<RdcFieldKey, uint32_t> fetches;
+  std::map<rdc_field_t, int64_t> values;
+};
+
+//!< Only answers the update intervals of the watched fields
+class WatchedFields : public RdcWatchTable {
+ public:
+  rdc_status_t rdc_field_update_all() override { return RDC_ST_OK; }
+  rdc_status_t rdc_field_listen_notif(uint32_t) override { return RDC_ST_OK; }
+  rdc_status_t rdc_job_start_stats(rdc_gpu_group_t, const char[64], uint64_t,
+                                   const rdc_gpu_gauges_t&) override {
+    return RDC_ST_NOT_SUPPORTED;
+  }
+  rdc_status_t rdc_job_stop_stats(const char[64], const rdc_gpu_gauges_t&) override {
+    return RDC_ST_NOT_SUPPORTED;
+  }
+  rdc_status_t rdc_job_remove(const char[64]) override { return RDC_ST_NOT_SUPPORTED; }
+  rdc_status_t rdc_job_remove_all() override { return RDC_ST_NOT_SUPPORTED; }
+  rdc_status_t rdc_field_watch(rdc_gpu_group_t, rdc_field_grp_t, uint64_t, double,
+                               uint32_t) override {
+    return RDC_ST_NOT_SUPPORTED;
+  }
+  rdc_status_t rdc_field_unwatch(rdc_gpu_group_t, rdc_field_grp_t) override {
+    return RDC_ST_NOT_SUPPORTED;
+  }
+  rdc_status_t rdc_field_ingest(uint32_t, const rdc_field_value*, uint32_t, double,
+                                uint32_t) override {
+    return RDC_ST_NOT_SUPPORTED;
+  }
+  rdc_status_t rdc_field_get_update_freq(uint32_t gpu_index, rdc_field_t field_id,
+                                         uint64_t* update_freq) override {
+    auto ite = update_freqs.find({gpu_index, field_id});
+    if (ite == update_freqs.end()) {
+      return RDC_ST_NOT_FOUND;
+    }
+    *update_freq = ite->second;
+    return RDC_ST_OK;
+  }
+
+  std::map<RdcFieldKey, uint64_t> update_freqs;  //!< In microseconds
+};
+
+class JobGaugesTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    fetcher_->values[RDC_FI_GPU_MEMORY_TOTAL] = 64 << 20;
+    fetcher_->values[RDC_FI_ECC_CORRECT_TOTAL] = 7;
+    fetcher_->values[RDC_FI_ECC_UNCORRECT_TOTAL] = 1;
+  }
+
+  void cache_ecc(uint32_t gpu_index, uint64_t age_ms, int64_t value) {
+    uint64_t ts = now_ms() - age_ms;
+    for (auto field : {RDC_FI_ECC_CORRECT_TOTAL, RDC_FI_ECC_UNCORRECT_TOTAL}) {
+      ASSERT_EQ(cache_->rdc_update_cache(gpu_index, integer_value(field, ts, value)), RDC_ST_OK);
+    }
+  }
+
+  uint32_t ecc_fetches(uint32_t gpu_index) {
+    return fetcher_->fetches[{gpu_index, RDC_FI_ECC_CORRECT_TOTAL}];
+  }
+
+  std::shared_ptr<RdcCacheManagerImpl> cache_{new RdcCacheManagerImpl()};
+  std::shared_ptr<CountingFetcher> fetcher_{new CountingFetcher()};
+  std::shared_ptr<WatchedFields> watch_table_{new WatchedFields()};
+  RdcJobGauges gauges_{cache_, fetcher_, watch_table_};
+};
+
+}  // namespace
+
+TEST_F(JobGaugesTest, MemoryTotalIsFetchedOnce) {
+  for (int i = 0; i < 3; i++) {
+    rdc_gpu_gauges_t gauges;
+    ASSERT_EQ(gauges_.get({0, 1}, RDC_ECC_GAUGES_NONE, &gauges), RDC_ST_OK);
+    EXPECT_EQ(gauges.size(), 2u);
+    EXPECT_EQ((gauges[{1, RDC_FI_GPU_MEMORY_TOTAL}]), 64u << 20);
+  }
+  EXPECT_EQ((fetcher_->fetches[{0, RDC_FI_GPU_MEMORY_TOTAL}]), 1u);
+  EXPECT_EQ(ecc_fetches(0), 0u);
+}
+
+TEST_F(JobGaugesTest, JobBoundariesTakeOnlySamplesWithinTheUpdateInterval) {
+  // GPU 0 is watched every second, GPU 1 every minute, GPU 2 not at all
+  watch_table_->update_freqs[{0, RDC_FI_ECC_CORRECT_TOTAL}] = 1000000;
+  watch_table_->update_freqs[{0, RDC_FI_ECC_UNCORRECT_TOTAL}] = 1000000;
+  watch_table_->update_freqs[{1, RDC_FI_ECC_CORRECT_TOTAL}] = 60000000;
+  watch_table_->update_freqs[{1, RDC_FI_ECC_UNCORRECT_TOTAL}] = 60000000;
+  cache_ecc(0, 5000, 3);
+  cache_ecc(1, 5000, 4);
+  cache_ecc(2, 0, 5);
+
+  // The sample of GPU 0 is older than its interval, the one of GPU 2 is
+  // not kept up to date by a watch
+  rdc_gpu_gauges_t gauges;
+  ASSERT_EQ(gauges_.get({0, 1, 2}, RDC_ECC_GAUGES_FRESH, &gauges), RDC_ST_OK);
+  EXPECT_EQ((gauges[{0, RDC_FI_ECC_CORRECT_TOTAL}]), 7u);
+  EXPECT_EQ((gauges[{0, RDC_FI_ECC_UNCORRECT_TOTAL}]), 1u);
+  EXPECT_EQ((gauges[{1, RDC_FI_ECC_CORRECT_TOTAL}]), 4u);
+  EXPECT_EQ((gauges[{2, RDC_FI_ECC_CORRECT_TOTAL}]), 7u);
+  EXPECT_EQ(ecc_fetches(0), 1u);
+  EXPECT_EQ(ecc_fetches(1), 0u);
+  EXPECT_EQ(ecc_fetches(2), 1u);
+
+  // Nor is a fetched total reused at a job boundary
+  gauges.clear();
+  ASSERT_EQ(gauges_.get({0}, RDC_ECC_GAUGES_FRESH, &gauges), RDC_ST_OK);
+  EXPECT_EQ(ecc_fetches(0), 2u);
+
+  // A new sample within the interval is
+  cache_ecc(0, 200, 9);
+  gauges.clear();
+  ASSERT_EQ(gauges_.get({0}, RDC_ECC_GAUGES_FRESH, &gauges), RDC_ST_OK);
+  EXPECT_EQ((gauges[{0, RDC_FI_ECC_CORRECT_TOTAL}]), 9u);
+  EXPECT_EQ(ecc_fetches(0), 2u);
+}
+
+TEST_F(JobGaugesTest, RunningJobsReuseRecentTotals) {
+  // Any sample of the last RDC_JOB_GAUGE_MAX_AGE seconds, watched or not
+  cache_ecc(0, 5000, 3);
+  rdc_gpu_gauges_t gauges;
+  ASSERT_EQ(gauges_.get({0, 1}, RDC_ECC_GAUGES_MEMOIZED, &gauges), RDC_ST_OK);
+  EXPECT_EQ((gauges[{0, RDC_FI_ECC_CORRECT_TOTAL}]), 3u);
+  EXPECT_EQ((gauges[{1, RDC_FI_ECC_CORRECT_TOTAL}]), 7u);
+  EXPECT_EQ(ecc_fetches(0), 0u);
+  EXPECT_EQ(ecc_fetches(1), 1u);
+
+  // The fetched totals are kept for the next queries
+  fetcher_->values[RDC_FI_ECC_CORRECT_TOTAL] = 8;
+  for (int i = 0; i < 3; i++) {
+    gauges.clear();
+    ASSERT_EQ(gauges_.get({1}, RDC_ECC_GAUGES_MEMOIZED, &gauges), RDC_ST_OK);
+    EXPECT_EQ((gauges[{1, RDC_FI_ECC_CORRECT_TOTAL}]), 7u);
+  }
+  EXPECT_EQ(ecc_fetches(1), 1u);
+
+  // Older samples are fetched again
+  cache_ecc(2, 11000, 3);
+  gauges.clear();
+  ASSERT_EQ(gauges_.get({2}, RDC_ECC_GAUGES_MEMOIZED, &gauges), RDC_ST_OK);
+  EXPECT_EQ((gauges[{2, RDC_FI_ECC_CORRECT_TOTAL}]), 8u);
+  EXPECT_EQ(ecc_fetches(2), 1u);
+}
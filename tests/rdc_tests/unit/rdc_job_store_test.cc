@@ -0,0 +1,244 @@
+/*
+Copyright (c) 2024 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <fcntl.h>
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rdc/rdc.h"
+#include "rdc_lib/impl/RdcCacheManagerImpl.h"
+#include "rdc_lib/impl/RdcJobStore.h"
+#include "rdc_tests/test_utils.h"
+
+using amd::rdc::RdcCacheManagerImpl;
+using amd::rdc::RdcJobStore;
+
+namespace {
+
+class JobStoreTest : public ::testing::Test {
+ protected:
+  void SetUp() override { ASSERT_FALSE(dir_.path().empty()); }
+
+  void TearDown() override {
+    unsetenv("RDC_JOB_STORE_DIR");
+    unsetenv("RDC_MAX_STOPPED_JOBS");
+  }
+
+  TempDir dir_{"rdctst_jobs"};
+};
+
+// A job of two GPUs with the given average power in W
+std::unique_ptr<rdc_job_info_t> job_info(uint64_t start_time, uint64_t watts) {
+  std::unique_ptr<rdc_job_info_t> info(new rdc_job_info_t);
+  memset(info.get(), 0, sizeof(rdc_job_info_t));
+  info->num_gpus = 2;
+  info->summary.start_time = start_time;
+  info->summary.end_time = start_time + 60;
+  info->summary.power_usage.average = watts;
+  info->summary.power_usage.max_value = watts + 10;
+  for (uint32_t gpu : {0, 3}) {
+    info->gpus[gpu].start_time = start_time;
+    info->gpus[gpu].power_usage.average = watts;
+  }
+  return info;
+}
+
+void run_job(RdcCacheManagerImpl* cache, const std::string& job_id, int64_t watts,
+             const rdc_gpu_gauges_t& gauges) {
+  rdc_group_info_t group = {};
+  group.count = 2;
+  group.entity_ids[0] = 0;
+  group.entity_ids[1] = 3;
+  rdc_field_group_info_t fields = {};
+  fields.count = 1;
+  fields.field_ids[0] = RDC_FI_POWER_USAGE;
+  ASSERT_EQ(cache->rdc_job_start_stats(job_id.c_str(), group, fields, gauges), RDC_ST_OK);
+  for (int i = 1; i <= 10; i++) {
+    rdc_field_value value = {};
+    value.field_id = RDC_FI_POWER_USAGE;
+    value.status = RDC_ST_OK;
+    value.ts = i * 1000;
+    value.type = INTEGER;
+    value.value.l_int = watts * 1000000;
+    ASSERT_EQ(cache->rdc_update_job_stats(0, job_id, value), RDC_ST_OK);
+    ASSERT_EQ(cache->rdc_update_job_stats(3, job_id, value), RDC_ST_OK);
+  }
+  ASSERT_EQ(cache->rdc_job_stop_stats(job_id.c_str(), gauges), RDC_ST_OK);
+}
+
+}  // namespace
+
+TEST_F(JobStoreTest, AppendGetAndList) {
+  const std::vector<uint32_t> gpus = {0, 3};
+  do {
+    RdcJobStore store(dir_.path());
+    for (uint64_t j = 0; j < 80; j++) {
+      auto info = job_info(1000 + j, 100 + j * 5);
+      ASSERT_TRUE(store.append("job" + std::to_string(j), gpus, *info, {}));
+    }
+    // A job id seen before now reads the newest record
+    auto info = job_info(2000, 42);
+    ASSERT_TRUE(store.append("job0", gpus, *info, {}));
+    EXPECT_EQ(store.num_records(), 81u);
+  } while (0);
+
+  // A torn record at the tail is cut off when the log is opened again
+  int fd = open((dir_.path() + "/jobs.log").c_str(), O_WRONLY | O_APPEND);
+  ASSERT_GE(fd, 0);
+  ASSERT_EQ(write(fd, "garbage", 7), 7);
+  close(fd);
+
+  RdcJobStore store(dir_.path());
+  EXPECT_EQ(store.num_records(), 81u);
+  EXPECT_TRUE(store.contains("job79"));
+  EXPECT_FALSE(store.contains("job80"));
+
+  std::unique_ptr<rdc_job_info_t> info(new rdc_job_info_t);
+  ASSERT_EQ(store.get("job0", info.get()), RDC_ST_OK);
+  EXPECT_EQ(info->summary.power_usage.average, 42u);
+  EXPECT_EQ(info->num_gpus, 2u);
+  EXPECT_EQ(info->gpus[3].power_usage.average, 42u);
+  ASSERT_EQ(store.get("job5", info.get()), RDC_ST_OK);
+  EXPECT_EQ(info->summary.start_time, 1005u);
+  EXPECT_EQ(store.get("missing", info.get()), RDC_ST_NOT_FOUND);
+
+  // Jobs averaging at least 300 W, by start time across pages
+  std::unique_ptr<rdc_job_list_t> jobs(new rdc_job_list_t);
+  rdc_job_filter_t filter = {};
+  filter.field_id = RDC_FI_POWER_USAGE;
+  filter.min_average = 300;
+  std::vector<std::string> listed;
+  uint32_t num_pages = 0;
+  do {
+    ASSERT_EQ(store.list(filter, jobs.get()), RDC_ST_OK);
+    for (uint32_t i = 0; i < jobs->num_jobs; i++) {
+      EXPECT_GE(jobs->jobs[i].summary.power_usage.average, 300u);
+      listed.push_back(jobs->jobs[i].job_id);
+    }
+    filter.cursor = jobs->next_cursor;
+    num_pages++;
+  } while (filter.cursor != 0 && num_pages < 10);
+  ASSERT_EQ(listed.size(), 40u);
+  EXPECT_EQ(listed.front(), "job40");
+  EXPECT_EQ(listed.back(), "job79");
+  EXPECT_EQ(num_pages, 2u);
+
+  // By start time only
+  filter = {};
+  filter.field_id = RDC_FI_INVALID;
+  filter.start_since = 1010;
+  filter.start_until = 1019;
+  ASSERT_EQ(store.list(filter, jobs.get()), RDC_ST_OK);
+  EXPECT_EQ(jobs->num_jobs, 10u);
+  EXPECT_EQ(jobs->next_cursor, 0u);
+
+  // Only the job stats fields can filter
+  filter.field_id = RDC_FI_ECC_CORRECT_TOTAL;
+  EXPECT_EQ(store.list(filter, jobs.get()), RDC_ST_BAD_PARAMETER);
+}
+
+TEST_F(JobStoreTest, StoppedJobsAreEvictedLeastRecentlyUsedFirst) {
+  setenv("RDC_JOB_STORE_DIR", dir_.path().c_str(), 1);
+  setenv("RDC_MAX_STOPPED_JOBS", "3", 1);
+  RdcCacheManagerImpl cache;
+  rdc_gpu_gauges_t gauges;
+  gauges[{0, RDC_FI_GPU_MEMORY_TOTAL}] = 100;
+  gauges[{3, RDC_FI_GPU_MEMORY_TOTAL}] = 100;
+
+  run_job(&cache, "job0", 100, gauges);
+  run_job(&cache, "job1", 110, gauges);
+  run_job(&cache, "job2", 120, gauges);
+  // Reading job0 makes job1 the least recently used
+  std::unique_ptr<rdc_job_info_t> info(new rdc_job_info_t);
+  ASSERT_EQ(cache.rdc_job_get_stats("job0", gauges, info.get()), RDC_ST_OK);
+  run_job(&cache, "job3", 130, gauges);
+  run_job(&cache, "job4", 140, gauges);
+
+  std::vector<uint32_t> gpus;
+  bool is_running = true;
+  EXPECT_EQ(cache.rdc_job_get_gpus("job0", &gpus, &is_running), RDC_ST_OK);
+  EXPECT_FALSE(is_running);
+  EXPECT_EQ(cache.rdc_job_get_gpus("job1", &gpus, &is_running), RDC_ST_NOT_FOUND);
+  EXPECT_EQ(cache.rdc_job_get_gpus("job2", &gpus, &is_running), RDC_ST_NOT_FOUND);
+  EXPECT_EQ(cache.rdc_job_get_gpus("job3", &gpus, &is_running), RDC_ST_OK);
+  EXPECT_EQ(cache.rdc_job_get_gpus("job4", &gpus, &is_running), RDC_ST_OK);
+
+  // The evicted jobs are read back from the job store
+  ASSERT_EQ(cache.rdc_job_get_stats("job1", gauges, info.get()), RDC_ST_OK);
+  EXPECT_EQ(info->num_gpus, 2u);
+  EXPECT_EQ(info->summary.power_usage.average, 110u);
+  EXPECT_EQ(info->gpus[3].power_usage.max_value, 110u);
+
+  // And outlive rdc_job_remove
+  ASSERT_EQ(cache.rdc_job_remove("job4"), RDC_ST_OK);
+  ASSERT_EQ(cache.rdc_job_get_stats("job4", gauges, info.get()), RDC_ST_OK);
+  EXPECT_EQ(info->summary.power_usage.average, 140u);
+
+  std::unique_ptr<rdc_job_list_t> jobs(new rdc_job_list_t);
+  rdc_job_filter_t filter = {};
+  filter.field_id = RDC_FI_INVALID;
+  ASSERT_EQ(cache.rdc_job_list(filter, jobs.get()), RDC_ST_OK);
+  EXPECT_EQ(jobs->num_jobs, 5u);
+}
+
+TEST_F(JobStoreTest, TimelinesOfEvictedJobs) {
+  setenv("RDC_JOB_STORE_DIR", dir_.path().c_str(), 1);
+  setenv("RDC_MAX_STOPPED_JOBS", "1", 1);
+  RdcCacheManagerImpl cache;
+  rdc_gpu_gauges_t gauges;
+  gauges[{0, RDC_FI_GPU_MEMORY_TOTAL}] = 100;
+  gauges[{3, RDC_FI_GPU_MEMORY_TOTAL}] = 100;
+
+  run_job(&cache, "job0", 100, gauges);
+  run_job(&cache, "job1", 110, gauges);
+  std::vector<uint32_t> gpus;
+  bool is_running = true;
+  ASSERT_EQ(cache.rdc_job_get_gpus("job0", &gpus, &is_running), RDC_ST_NOT_FOUND);
+
+  // The timeline of the evicted job is read back from the job store
+  std::unique_ptr<rdc_job_timeline_t> timeline(new rdc_job_timeline_t);
+  ASSERT_EQ(cache.rdc_job_get_timeline("job0", 3, RDC_FI_POWER_USAGE, gauges, timeline.get()),
+            RDC_ST_OK);
+  EXPECT_EQ(timeline->bucket_ms, 1000u);
+  EXPECT_EQ(timeline->num_points, 10u);
+  EXPECT_EQ(timeline->points[0].count, 1u);
+  EXPECT_DOUBLE_EQ(timeline->points[9].average, 100);
+  EXPECT_EQ(cache.rdc_job_get_timeline("job0", 1, RDC_FI_POWER_USAGE, gauges, timeline.get()),
+            RDC_ST_NOT_FOUND);
+  EXPECT_EQ(cache.rdc_job_get_timeline("job0", 0, RDC_FI_GPU_UTIL, gauges, timeline.get()),
+            RDC_ST_NOT_FOUND);
+
+  // And match the one of a job still in the cache
+  std::unique_ptr<rdc_job_timeline_t> cached(new rdc_job_timeline_t);
+  ASSERT_EQ(cache.rdc_job_get_timeline("job1", 3, RDC_FI_POWER_USAGE, gauges, cached.get()),
+            RDC_ST_OK);
+  EXPECT_EQ(cached->num_points, timeline->num_points);
+  EXPECT_EQ(cached->points[0].start_ts, timeline->points[0].start_ts);
+  EXPECT_DOUBLE_EQ(cached->points[9].average, 110);
+}
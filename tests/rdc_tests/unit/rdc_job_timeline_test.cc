@@ -0,0 +1,119 @@
+/*
+Copyright (c) 2024 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include "common/rdc_utils.h"
+#include "rdc/rdc.h"
+#include "rdc_lib/impl/RdcJobTimeline.h"
+
+using amd::rdc::RdcJobTimeline;
+using amd::rdc::WriteTimelineCsv;
+using amd::rdc::WriteTimelineCsvHeader;
+
+namespace {
+
+const uint64_t kStart = 1700000000000;
+// Copied, as the assertions take their arguments by reference
+const uint32_t kMaxBuckets = RdcJobTimeline::kMaxBuckets;
+const uint64_t kInitialWidth = RdcJobTimeline::kInitialWidth;
+
+}  // namespace
+
+TEST(rdctstUnit, JobTimelineBuckets) {
+  RdcJobTimeline timeline;
+  timeline.add(kStart, 10);
+  timeline.add(kStart + 500, 30);
+  timeline.add(kStart + 2500, 5);
+  // Older than the first sample, counted in the first bucket
+  timeline.add(kStart - 5000, 50);
+
+  EXPECT_EQ(timeline.start_time(), kStart);
+  EXPECT_EQ(timeline.width(), kInitialWidth);
+  ASSERT_EQ(timeline.num_buckets(), 3u);
+  EXPECT_EQ(timeline.bucket(0).count, 3u);
+  EXPECT_EQ(timeline.bucket(0).min_value, 10);
+  EXPECT_EQ(timeline.bucket(0).max_value, 50);
+  EXPECT_DOUBLE_EQ(timeline.bucket(0).sum, 90);
+  // Without a sample
+  EXPECT_EQ(timeline.bucket(1).count, 0u);
+  EXPECT_EQ(timeline.bucket(2).count, 1u);
+  EXPECT_EQ(timeline.bucket(2).min_value, 5);
+}
+
+TEST(rdctstUnit, JobTimelineWidthDoubles) {
+  RdcJobTimeline timeline;
+  for (uint32_t i = 0; i < kMaxBuckets; i++) {
+    timeline.add(kStart + i * 1000, i);
+  }
+  EXPECT_EQ(timeline.num_buckets(), kMaxBuckets);
+  EXPECT_EQ(timeline.width(), 1000u);
+
+  // Past the last bucket, the pairs of buckets are merged
+  timeline.add(kStart + kMaxBuckets * 1000, 1000);
+  EXPECT_EQ(timeline.width(), 2000u);
+  ASSERT_EQ(timeline.num_buckets(), kMaxBuckets / 2 + 1);
+  for (uint32_t i = 0; i < kMaxBuckets / 2; i++) {
+    const RdcJobTimeline::Bucket& b = timeline.bucket(i);
+    EXPECT_EQ(b.count, 2u);
+    EXPECT_EQ(b.min_value, 2 * i);
+    EXPECT_EQ(b.max_value, 2 * i + 1);
+    EXPECT_DOUBLE_EQ(b.sum, 4 * i + 1);
+  }
+  EXPECT_EQ(timeline.bucket(kMaxBuckets / 2).count, 1u);
+  EXPECT_EQ(timeline.bucket(kMaxBuckets / 2 + 1).count, 0u);
+
+  // A sample far ahead merges as many times as needed
+  timeline.add(kStart + 1000 * 1000, 7);
+  EXPECT_EQ(timeline.width(), 8000u);
+  EXPECT_EQ(timeline.num_buckets(), 126u);
+  EXPECT_EQ(timeline.bucket(125).count, 1u);
+  // Every sample is still counted once
+  uint64_t count = 0;
+  for (uint32_t i = 0; i < timeline.num_buckets(); i++) {
+    count += timeline.bucket(i).count;
+  }
+  EXPECT_EQ(count, kMaxBuckets + 2);
+}
+
+TEST(rdctstUnit, JobTimelineCsvExport) {
+  std::unique_ptr<rdc_job_timeline_t> timeline(new rdc_job_timeline_t);
+  timeline->bucket_ms = 1000;
+  timeline->num_points = 3;
+  timeline->points[0] = {kStart, 2, 10, 30, 20};
+  timeline->points[1] = {kStart + 1000, 0, 0, 0, 0};
+  timeline->points[2] = {kStart + 2000, 1, 5.5, 5.5, 5.5};
+
+  std::ostringstream out;
+  WriteTimelineCsvHeader(&out);
+  // The points without a sample are skipped
+  EXPECT_EQ(WriteTimelineCsv(&out, 3, RDC_FI_POWER_USAGE, *timeline), 2u);
+  std::string field = field_id_string(RDC_FI_POWER_USAGE);
+  EXPECT_EQ(out.str(), "gpu_index,field,start_ts,count,min,max,average\n"
+                       "3," + field + ",1700000000000,2,10,30,20\n"
+                       "3," + field + ",1700000002000,1,5.5,5.5,5.5\n");
+}
@@ -0,0 +1,173 @@
+/*
+Copyright (c) 2024 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+#include <sys/time.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "rdc/rdc.h"
+#include "rdc_lib/impl/RdcCacheManagerImpl.h"
+#include "rdc_lib/impl/RdcQuantileSketch.h"
+
+using amd::rdc::RdcCacheManagerImpl;
+using amd::rdc::RdcQuantileSketch;
+
+namespace {
+
+// The value of rank q * (n - 1), as the sketch defines its quantiles
+int64_t exact_quantile(std::vector<int64_t> values, double q) {
+  std::sort(values.begin(), values.end());
+  return values[static_cast<size_t>(q * (values.size() - 1))];
+}
+
+void expect_within_accuracy(double actual, int64_t expected) {
+  EXPECT_NEAR(actual, expected, expected * RdcQuantileSketch::kRelativeAccuracy + 1e-9);
+}
+
+}  // namespace
+
+TEST(rdctstUnit, QuantileSketchAccuracy) {
+  std::mt19937 rng(1);
+  std::normal_distribution<double> power(350e6, 60e6);
+  RdcQuantileSketch sketch;
+  std::vector<int64_t> values;
+  for (int i = 0; i < 100000; i++) {
+    int64_t value = static_cast<int64_t>(power(rng));
+    sketch.add(value);
+    values.push_back(value);
+  }
+  EXPECT_EQ(sketch.count(), values.size());
+  for (double q : {0.0, 0.5, 0.9, 0.95, 0.99, 1.0}) {
+    expect_within_accuracy(sketch.quantile(q), exact_quantile(values, q));
+  }
+}
+
+TEST(rdctstUnit, QuantileSketchZerosAndEmpty) {
+  RdcQuantileSketch sketch;
+  EXPECT_EQ(sketch.quantile(0.5), 0);
+
+  // 10% of idle samples
+  std::vector<int64_t> values;
+  for (int i = 0; i < 1000; i++) {
+    int64_t value = i % 10 == 0 ? 0 : i % 100 + 1;
+    sketch.add(value);
+    values.push_back(value);
+  }
+  EXPECT_EQ(sketch.quantile(0.05), 0);
+  for (double q : {0.5, 0.95, 0.99}) {
+    expect_within_accuracy(sketch.quantile(q), exact_quantile(values, q));
+  }
+}
+
+TEST(rdctstUnit, QuantileSketchMerge) {
+  RdcQuantileSketch odd;
+  RdcQuantileSketch even;
+  RdcQuantileSketch all;
+  for (int64_t i = 1; i <= 10000; i++) {
+    (i % 2 ? odd : even).add(i * 1000);
+    all.add(i * 1000);
+  }
+  RdcQuantileSketch merged;
+  merged.merge(odd);
+  merged.merge(even);
+  EXPECT_EQ(merged.count(), all.count());
+  for (double q : {0.01, 0.5, 0.9, 0.99}) {
+    EXPECT_EQ(merged.quantile(q), all.quantile(q));
+  }
+}
+
+TEST(rdctstUnit, QuantileSketchWideRange) {
+  // Past a ratio of about 160 the lowest buckets collapse, the top stays
+  // accurate
+  RdcQuantileSketch sketch;
+  std::vector<int64_t> values;
+  for (int64_t i = 1; i <= 100000; i++) {
+    sketch.add(i * i * 10);
+    values.push_back(i * i * 10);
+  }
+  for (double q : {0.5, 0.99}) {
+    expect_within_accuracy(sketch.quantile(q), exact_quantile(values, q));
+  }
+  EXPECT_LE(sketch.quantile(0.01), exact_quantile(values, 0.5));
+}
+
+TEST(rdctstUnit, JobStatsPercentiles) {
+  RdcCacheManagerImpl cache;
+  rdc_group_info_t group = {};
+  group.count = 2;
+  group.entity_ids[0] = 0;
+  group.entity_ids[1] = 1;
+  rdc_field_group_info_t fields = {};
+  fields.count = 1;
+  fields.field_ids[0] = RDC_FI_POWER_USAGE;
+  rdc_gpu_gauges_t gauges;
+  ASSERT_EQ(cache.rdc_job_start_stats("job", group, fields, gauges), RDC_ST_OK);
+
+  // 1 to 100 W on GPU 0 and 101 to 200 W on GPU 1, in microwatts
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  uint64_t start = static_cast<uint64_t>(tv.tv_sec) * 1000;
+  for (uint32_t gpu = 0; gpu < 2; gpu++) {
+    for (int64_t i = 1; i <= 100; i++) {
+      rdc_field_value value = {};
+      value.field_id = RDC_FI_POWER_USAGE;
+      value.status = RDC_ST_OK;
+      value.ts = start + i * 1000;
+      value.type = INTEGER;
+      value.value.l_int = (gpu * 100 + i) * 1000000;
+      ASSERT_EQ(cache.rdc_update_job_stats(gpu, "job", value), RDC_ST_OK);
+    }
+  }
+
+  gauges[{0, RDC_FI_GPU_MEMORY_TOTAL}] = 1;
+  gauges[{1, RDC_FI_GPU_MEMORY_TOTAL}] = 1;
+  std::unique_ptr<rdc_job_info_t> info(new rdc_job_info_t);
+  ASSERT_EQ(cache.rdc_job_get_stats("job", gauges, info.get()), RDC_ST_OK);
+
+  // Within 1% of the samples, and clamped to the exact range
+  const rdc_stats_summary_t& gpu0 = info->gpus[0].power_usage;
+  EXPECT_EQ(gpu0.min_value, 1u);
+  EXPECT_EQ(gpu0.max_value, 100u);
+  EXPECT_NEAR(gpu0.p50, 50, 1);
+  EXPECT_NEAR(gpu0.p90, 90, 1);
+  EXPECT_NEAR(gpu0.p95, 95, 1);
+  EXPECT_NEAR(gpu0.p99, 99, 1);
+  EXPECT_LE(gpu0.p99, gpu0.max_value);
+
+  const rdc_stats_summary_t& gpu1 = info->gpus[1].power_usage;
+  EXPECT_NEAR(gpu1.p50, 150, 2);
+  EXPECT_NEAR(gpu1.p99, 199, 2);
+
+  // The job summary merges the samples of both GPUs
+  const rdc_stats_summary_t& summary = info->summary.power_usage;
+  EXPECT_NEAR(summary.p50, 100, 1);
+  EXPECT_NEAR(summary.p90, 180, 2);
+  EXPECT_NEAR(summary.p99, 198, 2);
+  EXPECT_LE(summary.p50, summary.p90);
+  EXPECT_LE(summary.p90, summary.p95);
+  EXPECT_LE(summary.p95, summary.p99);
+}
@@ -0,0 +1,122 @@
+/*
+Copyright (c) 2024 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "common/rdc_perf_histogram.h"
+#include "rdc/rdc.h"
+
+using amd::rdc::RdcPerfHistogram;
+using amd::rdc::RdcPerfRegistry;
+
+namespace {
+
+RdcPerfHistogram& histogram_of(const std::string& name) {
+  return RdcPerfRegistry::get_instance().get_histogram("rdctst_" + name);
+}
+
+}  // namespace
+
+TEST(rdctstUnit, PerfHistogramEmpty) {
+  rdc_perf_stat_t stat = {};
+  histogram_of("empty").get_stat(&stat);
+  EXPECT_EQ(stat.count, 0u);
+  EXPECT_EQ(stat.total_ns, 0u);
+  EXPECT_EQ(stat.max_ns, 0u);
+  EXPECT_EQ(stat.p50_ns, 0u);
+  EXPECT_EQ(stat.p999_ns, 0u);
+}
+
+TEST(rdctstUnit, PerfHistogramSmallValuesAreExact) {
+  // Below kSubBuckets every value has its own bucket
+  RdcPerfHistogram& histogram = histogram_of("small");
+  for (uint64_t value = 0; value < 10; value++) {
+    for (int i = 0; i < 10; i++) {
+      histogram.record(value);
+    }
+  }
+
+  rdc_perf_stat_t stat = {};
+  histogram.get_stat(&stat);
+  EXPECT_EQ(stat.count, 100u);
+  EXPECT_EQ(stat.total_ns, 450u);
+  EXPECT_EQ(stat.max_ns, 9u);
+  EXPECT_EQ(stat.p50_ns, 4u);
+  EXPECT_EQ(stat.p90_ns, 8u);
+  EXPECT_EQ(stat.p99_ns, 9u);
+  EXPECT_EQ(stat.p999_ns, 9u);
+}
+
+TEST(rdctstUnit, PerfHistogramBucketWidth) {
+  const uint64_t kLarge = 1ULL << 50;
+  const uint64_t values[] = {16, 17, 31, 100, 1000, 12345, 1ULL << 20, 123456789};
+  for (uint64_t value : values) {
+    // One sample at value and one far above it, so the median is the middle
+    // of the bucket of value and the higher percentiles are clamped to max
+    RdcPerfHistogram& histogram = histogram_of("width_" + std::to_string(value));
+    histogram.record(value);
+    histogram.record(kLarge);
+
+    rdc_perf_stat_t stat = {};
+    histogram.get_stat(&stat);
+    uint64_t error = stat.p50_ns > value ? stat.p50_ns - value : value - stat.p50_ns;
+    EXPECT_LE(error, value / 32) << "value " << value << " p50 " << stat.p50_ns;
+    EXPECT_EQ(stat.p90_ns, kLarge);
+    EXPECT_EQ(stat.p999_ns, kLarge);
+    EXPECT_EQ(stat.max_ns, kLarge);
+  }
+
+  // The median never exceeds the largest sample
+  RdcPerfHistogram& histogram = histogram_of("clamped");
+  histogram.record(1000);
+  rdc_perf_stat_t stat = {};
+  histogram.get_stat(&stat);
+  EXPECT_EQ(stat.p50_ns, 1000u);
+}
+
+TEST(rdctstUnit, PerfHistogramSumsThreads) {
+  RdcPerfHistogram& histogram = histogram_of("threads");
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++) {
+    threads.emplace_back([&histogram, t]() {
+      for (int i = 0; i < 1000; i++) {
+        histogram.record(t + 1);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  rdc_perf_stat_t stat = {};
+  histogram.get_stat(&stat);
+  EXPECT_EQ(stat.count, 4000u);
+  EXPECT_EQ(stat.total_ns, 10000u);
+  EXPECT_EQ(stat.max_ns, 4u);
+  EXPECT_EQ(stat.p50_ns, 2u);
+  EXPECT_EQ(stat.p90_ns, 4u);
+}
@@ -0,0 +1,209 @@
+/*
+Copyright (c) 2024 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rdc/rdc.h"
+#include "rdc_lib/impl/RdcCacheManagerImpl.h"
+#include "rdc_lib/impl/RdcPersistentStore.h"
+#include "rdc_tests/test_utils.h"
+
+using amd::rdc::RdcCacheManagerImpl;
+using amd::rdc::RdcPersistentStore;
+using amd::rdc::RdcPersistRecordKind;
+
+namespace {
+
+uint64_t now_ms() {
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return static_cast<uint64_t>(tv.tv_sec) * 1000 + tv.tv_usec / 1000;
+}
+
+// Each test persists to its own directory through the environment, which
+// is read when the cache manager is constructed
+class PersistentCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_FALSE(dir_.path().empty());
+    setenv("RDC_CACHE_PERSIST_DIR", dir_.path().c_str(), 1);
+    setenv("RDC_CACHE_PERSIST_SEGMENT_MB", "1", 1);
+    setenv("RDC_CACHE_PERSIST_SEGMENTS", "3", 1);
+  }
+
+  void TearDown() override {
+    unsetenv("RDC_CACHE_PERSIST_DIR");
+    unsetenv("RDC_CACHE_PERSIST_SEGMENT_MB");
+    unsetenv("RDC_CACHE_PERSIST_SEGMENTS");
+  }
+
+  TempDir dir_{"rdctst_persist"};
+};
+
+rdc_group_info_t two_gpus() {
+  rdc_group_info_t group = {};
+  group.count = 2;
+  group.entity_ids[0] = 0;
+  group.entity_ids[1] = 1;
+  return group;
+}
+
+rdc_field_group_info_t power_field() {
+  rdc_field_group_info_t fields = {};
+  fields.count = 1;
+  fields.field_ids[0] = RDC_FI_POWER_USAGE;
+  return fields;
+}
+
+rdc_gpu_gauges_t memory_gauges() {
+  rdc_gpu_gauges_t gauges;
+  gauges[{0, RDC_FI_GPU_MEMORY_TOTAL}] = 1;
+  gauges[{1, RDC_FI_GPU_MEMORY_TOTAL}] = 1;
+  return gauges;
+}
+
+}  // namespace
+
+TEST_F(PersistentCacheTest, SamplesAndJobsSurviveRestart) {
+  const uint64_t start = now_ms() - 100 * 1000;
+  const uint32_t num_samples = 20000;  // Spans several segments
+  do {
+    RdcCacheManagerImpl cache;
+    rdc_gpu_gauges_t gauges;
+    ASSERT_EQ(cache.rdc_job_start_stats("job-a", two_gpus(), power_field(), gauges), RDC_ST_OK);
+    ASSERT_EQ(cache.rdc_job_start_stats("job-b", two_gpus(), power_field(), gauges), RDC_ST_OK);
+    ASSERT_EQ(cache.rdc_job_remove("job-b"), RDC_ST_OK);
+    for (uint32_t i = 0; i < num_samples; i++) {
+      rdc_field_value value =
+          integer_value(RDC_FI_POWER_USAGE, start + i, static_cast<int64_t>(i % 100) * 1000000);
+      ASSERT_EQ(cache.rdc_update_cache(0, value), RDC_ST_OK);
+      ASSERT_EQ(cache.rdc_update_job_stats(0, "job-a", value), RDC_ST_OK);
+    }
+    rdc_field_value name = {};
+    name.field_id = RDC_FI_DEV_NAME;
+    name.ts = start;
+    name.type = STRING;
+    strncpy(name.value.str, "MI300X", sizeof(name.value.str) - 1);
+    ASSERT_EQ(cache.rdc_update_cache(0, name), RDC_ST_OK);
+    ASSERT_EQ(cache.rdc_job_stop_stats("job-a", gauges), RDC_ST_OK);
+  } while (0);
+
+  RdcCacheManagerImpl cache;
+  rdc_field_value value;
+  ASSERT_EQ(cache.rdc_field_get_latest_value(0, RDC_FI_POWER_USAGE, &value), RDC_ST_OK);
+  EXPECT_EQ(value.ts, start + num_samples - 1);
+  EXPECT_EQ(value.value.l_int, 99 * 1000000);
+  ASSERT_EQ(cache.rdc_field_get_latest_value(0, RDC_FI_DEV_NAME, &value), RDC_ST_OK);
+  EXPECT_STREQ(value.value.str, "MI300X");
+
+  // The oldest segments were deleted, the newest samples are kept
+  uint64_t next_since = 0;
+  ASSERT_EQ(cache.rdc_field_get_value_since(0, RDC_FI_POWER_USAGE, 0, &next_since, &value),
+            RDC_ST_OK);
+  EXPECT_GE(value.ts, start);
+
+  std::unique_ptr<rdc_job_info_t> info(new rdc_job_info_t);
+  ASSERT_EQ(cache.rdc_job_get_stats("job-a", memory_gauges(), info.get()), RDC_ST_OK);
+  EXPECT_EQ(info->num_gpus, 2u);
+  EXPECT_EQ(info->gpus[0].power_usage.max_value, 99u);
+  EXPECT_EQ(info->gpus[0].power_usage.min_value, 0u);
+  EXPECT_NE(info->summary.end_time, 0u);
+  EXPECT_EQ(cache.rdc_job_get_stats("job-b", memory_gauges(), info.get()), RDC_ST_NOT_FOUND);
+}
+
+TEST_F(PersistentCacheTest, RunningJobIsStoppedOnRestart) {
+  // The samples follow the start of the job
+  const uint64_t start = (now_ms() / 1000 + 1) * 1000;
+  do {
+    RdcCacheManagerImpl cache;
+    rdc_gpu_gauges_t gauges;
+    gauges[{0, RDC_FI_ECC_CORRECT_TOTAL}] = 5;
+    ASSERT_EQ(cache.rdc_job_start_stats("job-a", two_gpus(), power_field(), gauges), RDC_ST_OK);
+    for (uint32_t i = 0; i < 10; i++) {
+      rdc_field_value value = integer_value(RDC_FI_POWER_USAGE, start + i * 1000, 1000000);
+      ASSERT_EQ(cache.rdc_update_cache(0, value), RDC_ST_OK);
+      ASSERT_EQ(cache.rdc_update_job_stats(0, "job-a", value), RDC_ST_OK);
+    }
+    // Newer than the last job sample
+    ASSERT_EQ(cache.rdc_update_cache(0, integer_value(RDC_FI_ECC_CORRECT_TOTAL, start + 20000, 8)),
+              RDC_ST_OK);
+    // rdcd dies without stopping the job
+  } while (0);
+
+  RdcCacheManagerImpl cache;
+  std::vector<uint32_t> gpu_indexes;
+  bool is_running = true;
+  ASSERT_EQ(cache.rdc_job_get_gpus("job-a", &gpu_indexes, &is_running), RDC_ST_OK);
+  EXPECT_FALSE(is_running);
+  EXPECT_EQ(gpu_indexes.size(), 2u);
+
+  std::unique_ptr<rdc_job_info_t> info(new rdc_job_info_t);
+  ASSERT_EQ(cache.rdc_job_get_stats("job-a", memory_gauges(), info.get()), RDC_ST_OK);
+  EXPECT_EQ(info->summary.end_time, start / 1000 + 20);
+  EXPECT_EQ(info->gpus[0].ecc_correct, 3u);
+  EXPECT_EQ(info->gpus[0].power_usage.max_value, 1u);
+
+  // The timeline of the job is restored with it
+  std::unique_ptr<rdc_job_timeline_t> timeline(new rdc_job_timeline_t);
+  ASSERT_EQ(cache.rdc_job_get_timeline("job-a", 0, RDC_FI_POWER_USAGE, memory_gauges(),
+                                       timeline.get()),
+            RDC_ST_OK);
+  EXPECT_EQ(timeline->bucket_ms, 1000u);
+  ASSERT_EQ(timeline->num_points, 10u);
+  EXPECT_EQ(timeline->points[0].start_ts, start);
+  EXPECT_EQ(timeline->points[9].count, 1u);
+  EXPECT_DOUBLE_EQ(timeline->points[9].average, 1);
+
+  // The stopped state itself persists
+  std::unique_ptr<RdcCacheManagerImpl> restarted(new RdcCacheManagerImpl());
+  ASSERT_EQ(restarted->rdc_job_get_stats("job-a", memory_gauges(), info.get()), RDC_ST_OK);
+  EXPECT_EQ(info->summary.end_time, start / 1000 + 20);
+  EXPECT_EQ(info->gpus[0].ecc_correct, 3u);
+  ASSERT_EQ(restarted->rdc_job_get_timeline("job-a", 0, RDC_FI_POWER_USAGE, memory_gauges(),
+                                            timeline.get()),
+            RDC_ST_OK);
+  EXPECT_EQ(timeline->num_points, 10u);
+}
+
+TEST_F(PersistentCacheTest, StoreIsDisabledWhenSegmentCannotBeCreated) {
+  RdcPersistentStore store(dir_.path(), 4096, 2, 1000);
+  std::vector<uint8_t> payload(1000, 7);
+  ASSERT_TRUE(store.append(amd::rdc::RDC_PERSIST_SAMPLE, payload.data(), payload.size()));
+
+  // The directory is gone, the next segment cannot be created
+  dir_.remove();
+  bool appended = true;
+  for (int i = 0; i < 8 && appended; i++) {
+    appended = store.append(amd::rdc::RDC_PERSIST_SAMPLE, payload.data(), payload.size());
+  }
+  EXPECT_FALSE(appended);
+  EXPECT_TRUE(store.disabled());
+  EXPECT_FALSE(store.append(amd::rdc::RDC_PERSIST_SAMPLE, payload.data(), 8));
+}
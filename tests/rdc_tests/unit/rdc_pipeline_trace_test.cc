@@ -0,0 +1,126 @@
+/*
+Copyright (c) 2024 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+#include <stdlib.h>
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "rdc/rdc.h"
+#include "rdc_lib/RdcPipelineTrace.h"
+
+using amd::rdc::RdcPipelineTrace;
+
+namespace {
+
+rdc_pipeline_event_t event_of(const char* name, uint64_t ts, uint64_t dur, uint32_t gpu_index,
+                              uint32_t field_id) {
+  rdc_pipeline_event_t event = {};
+  strncpy(event.name, name, RDC_MAX_PERF_STAT_NAME - 1);
+  event.ts_us = ts;
+  event.dur_us = dur;
+  event.tid = 7;
+  event.gpu_index = gpu_index;
+  event.field_id = static_cast<rdc_field_t>(field_id);
+  return event;
+}
+
+}  // namespace
+
+TEST(rdctstUnit, PipelineTraceRingWrap) {
+  // The capacity is read when the ring is first allocated
+  setenv("RDC_PIPELINE_TRACE_EVENTS", "4", 1);
+  RdcPipelineTrace& trace = RdcPipelineTrace::get_instance();
+  trace.set_enabled(true);
+  unsetenv("RDC_PIPELINE_TRACE_EVENTS");
+  EXPECT_TRUE(RdcPipelineTrace::enabled());
+
+  std::unique_ptr<rdc_pipeline_events_t> events(new rdc_pipeline_events_t);
+  trace.get_events(0, events.get());
+  EXPECT_EQ(events->num_events, 0u);
+  uint64_t first = events->next_seq;
+
+  for (uint64_t i = 0; i < 10; i++) {
+    trace.record("span", 100 + i, 105 + i, 0, RDC_FI_GPU_UTIL);
+  }
+
+  // Only the last four are kept, oldest first
+  trace.get_events(0, events.get());
+  ASSERT_EQ(events->num_events, 4u);
+  for (uint32_t i = 0; i < 4; i++) {
+    EXPECT_EQ(events->events[i].seq, first + 6 + i);
+    EXPECT_EQ(events->events[i].ts_us, 106 + i);
+    EXPECT_EQ(events->events[i].dur_us, 5u);
+    EXPECT_STREQ(events->events[i].name, "span");
+  }
+  EXPECT_EQ(events->next_seq, first + 10);
+
+  // Resuming from a sequence number returns only newer events
+  trace.get_events(first + 8, events.get());
+  ASSERT_EQ(events->num_events, 2u);
+  EXPECT_EQ(events->events[0].seq, first + 8);
+  trace.get_events(first + 10, events.get());
+  EXPECT_EQ(events->num_events, 0u);
+  EXPECT_EQ(events->next_seq, first + 10);
+
+  // Enabling again starts from an empty ring
+  trace.set_enabled(false);
+  EXPECT_FALSE(RdcPipelineTrace::enabled());
+  trace.set_enabled(true);
+  trace.get_events(0, events.get());
+  EXPECT_EQ(events->num_events, 0u);
+  trace.set_enabled(false);
+}
+
+TEST(rdctstUnit, PipelineTraceChromeJson) {
+  std::vector<rdc_pipeline_event_t> events;
+  events.push_back(event_of("tick", 1000, 50, GPU_ID_INVALID, RDC_FI_INVALID));
+  events.push_back(event_of("fetch", 1010, 20, 2, RDC_FI_INVALID));
+  events.push_back(event_of("field", 1012, 5, 3, RDC_FI_GPU_UTIL));
+
+  std::ostringstream os;
+  RdcPipelineTrace::write_chrome_json(events, os);
+  std::string json = os.str();
+
+  EXPECT_EQ(json.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["), 0u);
+  EXPECT_NE(json.find("\"ph\":\"M\""), std::string::npos);
+  EXPECT_EQ(json.substr(json.size() - 3), "]}\n");
+  EXPECT_NE(json.find("{\"name\":\"tick\",\"cat\":\"rdc\",\"ph\":\"X\",\"pid\":0,\"tid\":7,"
+                      "\"ts\":1000,\"dur\":50}"),
+            std::string::npos);
+  EXPECT_NE(json.find("\"ts\":1010,\"dur\":20,\"args\":{\"gpu\":2}}"), std::string::npos);
+  std::string field = std::string("\"args\":{\"gpu\":3,\"field\":\"") +
+                      field_id_string(RDC_FI_GPU_UTIL) + "\"}}";
+  EXPECT_NE(json.find(field), std::string::npos);
+
+  // Only the metadata event without any spans
+  std::ostringstream empty;
+  RdcPipelineTrace::write_chrome_json({}, empty);
+  EXPECT_EQ(empty.str(),
+            "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[{\"name\":\"process_name\",\"ph\":"
+            "\"M\",\"pid\":0,\"args\":{\"name\":\"rdc\"}}]}\n");
+}
@@ -0,0 +1,114 @@
+/*
+Copyright (c) 2024 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "rdc/rdc.h"
+#include "rdc_lib/impl/RdcPolicyEngine.h"
+
+using amd::rdc::rdc_evnt_notification_t;
+using amd::rdc::RdcPolicyEngine;
+
+namespace {
+
+rdc_field_value temperature(uint64_t ts, int64_t value) {
+  rdc_field_value field = {};
+  field.field_id = RDC_FI_GPU_TEMP;
+  field.status = RDC_ST_OK;
+  field.type = INTEGER;
+  field.ts = ts;
+  field.value.l_int = value;
+  return field;
+}
+
+rdc_policy_rule_t temperature_rule(rdc_policy_condition_t condition) {
+  rdc_policy_rule_t rule = {};
+  rule.gpu_index = GPU_ID_INVALID;
+  rule.field_id = RDC_FI_GPU_TEMP;
+  rule.condition = condition;
+  rule.threshold = 80;
+  rule.hysteresis = 5;
+  rule.duration_ms = 1000;
+  return rule;
+}
+
+}  // namespace
+
+TEST(rdctstUnit, PolicyViolationsAreRaisedAsEvents) {
+  RdcPolicyEngine engine;
+  uint32_t rule_id = 0;
+  rdc_policy_rule_t rule = temperature_rule(RDC_POLICY_ABOVE);
+  ASSERT_EQ(engine.add_rule(rule, &rule_id), RDC_ST_OK);
+
+  // Above the threshold for the duration, then back below it by the hysteresis
+  std::vector<rdc_evnt_notification_t> events;
+  int64_t values[] = {70, 85, 86, 90, 78, 74, 73};
+  for (uint32_t i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+    engine.evaluate(2, temperature(1000 * (i + 1), values[i]), &events);
+  }
+
+  ASSERT_EQ(events.size(), 2u);
+  EXPECT_EQ(events[0].gpu_id, 2u);
+  EXPECT_EQ(events[0].field.field_id, RDC_EVNT_NOTIF_POLICY_VIOLATION);
+  EXPECT_EQ(events[0].field.status, RDC_ST_OK);
+  EXPECT_EQ(events[0].field.type, INTEGER);
+  EXPECT_EQ(events[0].field.ts, 3000u);
+  EXPECT_EQ(events[0].field.value.l_int, rule_id);
+  EXPECT_EQ(events[1].field.field_id, RDC_EVNT_NOTIF_POLICY_CLEARED);
+  EXPECT_EQ(events[1].field.ts, 6000u);
+  EXPECT_EQ(events[1].field.value.l_int, rule_id);
+
+  // The queue read by rdc_policy_get_violations() holds the same violations
+  rdc_policy_violations_t violations;
+  ASSERT_EQ(engine.get_violations(0, 0, &violations), RDC_ST_OK);
+  ASSERT_EQ(violations.num_violations, 2u);
+  EXPECT_EQ(violations.violations[0].cleared, 0u);
+  EXPECT_EQ(violations.violations[0].value, 86);
+  EXPECT_EQ(violations.violations[1].cleared, 1u);
+  EXPECT_EQ(violations.violations[1].value, 74);
+}
+
+TEST(rdctstUnit, PolicyIncreasedRuleAndDeletedRule) {
+  RdcPolicyEngine engine;
+  uint32_t rule_id = 0;
+  rdc_policy_rule_t rule = temperature_rule(RDC_POLICY_INCREASED);
+  rule.gpu_index = 1;
+  ASSERT_EQ(engine.add_rule(rule, &rule_id), RDC_ST_OK);
+
+  std::vector<rdc_evnt_notification_t> events;
+  engine.evaluate(1, temperature(1000, 5), &events);
+  engine.evaluate(1, temperature(2000, 5), &events);
+  engine.evaluate(1, temperature(3000, 6), &events);
+  engine.evaluate(0, temperature(3000, 9), &events);
+  ASSERT_EQ(events.size(), 1u);
+  EXPECT_EQ(events[0].gpu_id, 1u);
+  EXPECT_EQ(events[0].field.ts, 3000u);
+
+  EXPECT_EQ(engine.delete_rule(rule_id), RDC_ST_OK);
+  EXPECT_EQ(engine.delete_rule(rule_id), RDC_ST_NOT_FOUND);
+  events.clear();
+  engine.evaluate(1, temperature(4000, 7), &events);
+  EXPECT_TRUE(events.empty());
+}
@@ -0,0 +1,207 @@
+/*
+Copyright (c) 2024 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rdc/rdc.h"
+#include "rdc_lib/impl/RdcPushExporter.h"
+#include "rdc_tests/test_utils.h"
+
+using amd::rdc::RDC_PUSH_DOGSTATSD;
+using amd::rdc::RDC_PUSH_INFLUX;
+using amd::rdc::RDC_PUSH_STATSD;
+using amd::rdc::RdcPushExporter;
+
+namespace {
+
+const int kReceiveTimeoutMs = 5000;
+
+// A listener on an ephemeral port of the loopback
+class LocalListener {
+ public:
+  explicit LocalListener(int type) : fd_(socket(AF_INET, type, 0)), port_(0) {
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t len = sizeof(addr);
+    if (fd_ < 0 || bind(fd_, reinterpret_cast<sockaddr*>(&addr), len) != 0 ||
+        getsockname(fd_, reinterpret_cast<sockaddr*>(&addr), &len) != 0 ||
+        (type == SOCK_STREAM && listen(fd_, 1) != 0)) {
+      return;
+    }
+    port_ = ntohs(addr.sin_port);
+  }
+  ~LocalListener() {
+    if (fd_ >= 0) {
+      close(fd_);
+    }
+  }
+
+  uint16_t port() const { return port_; }
+
+  // The next datagram, empty when none comes in time
+  std::string receive_datagram() {
+    std::string datagram;
+    if (!wait_readable(fd_)) {
+      return datagram;
+    }
+    char buf[65536];
+    ssize_t n = recv(fd_, buf, sizeof(buf), 0);
+    if (n > 0) {
+      datagram.assign(buf, n);
+    }
+    return datagram;
+  }
+
+  // Everything sent on the accepted connection until it is closed
+  std::string receive_stream() {
+    std::string stream;
+    if (!wait_readable(fd_)) {
+      return stream;
+    }
+    int conn = accept(fd_, nullptr, nullptr);
+    char buf[4096];
+    while (conn >= 0 && wait_readable(conn)) {
+      ssize_t n = recv(conn, buf, sizeof(buf), 0);
+      if (n <= 0) {
+        break;
+      }
+      stream.append(buf, n);
+    }
+    if (conn >= 0) {
+      close(conn);
+    }
+    return stream;
+  }
+
+ private:
+  static bool wait_readable(int fd) {
+    struct pollfd pfd = {fd, POLLIN, 0};
+    return poll(&pfd, 1, kReceiveTimeoutMs) == 1;
+  }
+
+  int fd_;
+  uint16_t port_;
+};
+
+rdc_field_value double_value(rdc_field_t field_id, uint64_t ts, double value) {
+  rdc_field_value field = integer_value(field_id, ts, 0);
+  field.type = DOUBLE;
+  field.value.dbl = value;
+  return field;
+}
+
+std::string hostname() {
+  char name[256] = {};
+  gethostname(name, sizeof(name) - 1);
+  return name;
+}
+
+}  // namespace
+
+TEST(rdctstUnit, PushInfluxLinesOverUdp) {
+  LocalListener listener(SOCK_DGRAM);
+  ASSERT_NE(listener.port(), 0);
+  std::string target = "udp://127.0.0.1:" + std::to_string(listener.port());
+
+  // Flushed when the exporter stops
+  auto exporter = std::make_unique<RdcPushExporter>(target, RDC_PUSH_INFLUX, 60000, 1000, 1000);
+  exporter->append(0, integer_value(RDC_FI_GPU_TEMP, 1000, 45000));
+  exporter->append(0, double_value(RDC_FI_POWER_USAGE, 1000, 210.5));
+  exporter->append(1, integer_value(RDC_FI_GPU_TEMP, 1000, -1));
+  // Neither a string nor a NaN is pushed
+  rdc_field_value name = integer_value(RDC_FI_DEV_NAME, 1000, 0);
+  name.type = STRING;
+  exporter->append(0, name);
+  exporter->append(0, double_value(RDC_FI_POWER_USAGE, 2000, std::nan("")));
+  exporter.reset();
+
+  std::string host = ",host=" + hostname();
+  EXPECT_EQ(listener.receive_datagram(),
+            "rdc,gpu=0" + host + " gpu_temp=45000i,power_usage=210.5 1000000000\n" +
+                "rdc,gpu=1" + host + " gpu_temp=-1i 1000000000\n");
+}
+
+TEST(rdctstUnit, PushDatagramsAreCutOnLines) {
+  LocalListener listener(SOCK_DGRAM);
+  ASSERT_NE(listener.port(), 0);
+  std::string target = "udp://127.0.0.1:" + std::to_string(listener.port());
+
+  const uint64_t kSamples = 200;
+  auto exporter = std::make_unique<RdcPushExporter>(target, RDC_PUSH_DOGSTATSD, 60000, 1000,
+                                                    1000);
+  for (uint64_t i = 0; i < kSamples; i++) {
+    exporter->append(i % 8, integer_value(RDC_FI_GPU_TEMP, 1000 + i, i));
+  }
+  exporter.reset();
+
+  uint64_t lines = 0;
+  uint64_t datagrams = 0;
+  std::string expected_tags = "|g|#gpu:0,host:" + hostname() + "\n";
+  for (std::string datagram = listener.receive_datagram(); !datagram.empty();
+       datagram = listener.receive_datagram()) {
+    datagrams++;
+    EXPECT_LE(datagram.size(), 1432u);
+    EXPECT_EQ(datagram.back(), '\n');
+    for (size_t start = 0; start < datagram.size(); lines++) {
+      size_t end = datagram.find('\n', start) + 1;
+      std::string line = datagram.substr(start, end - start);
+      if (lines == 0) {
+        EXPECT_EQ(line, "rdc.gpu_temp:0" + expected_tags);
+      }
+      EXPECT_EQ(line.compare(0, 13, "rdc.gpu_temp:"), 0) << line;
+      start = end;
+    }
+    if (lines == kSamples) {
+      break;
+    }
+  }
+  EXPECT_EQ(lines, kSamples);
+  EXPECT_GT(datagrams, 1u);
+}
+
+TEST(rdctstUnit, PushStatsdGaugesOverTcp) {
+  LocalListener listener(SOCK_STREAM);
+  ASSERT_NE(listener.port(), 0);
+  std::string target = "tcp://127.0.0.1:" + std::to_string(listener.port());
+
+  auto exporter = std::make_unique<RdcPushExporter>(target, RDC_PUSH_STATSD, 60000, 1000, 1000);
+  exporter->append(2, integer_value(RDC_FI_GPU_TEMP, 1000, 45000));
+  // A signed gauge would be a delta, so it is set from 0 first
+  exporter->append(2, double_value(RDC_FI_POWER_USAGE, 1000, -2.5));
+  exporter.reset();
+
+  EXPECT_EQ(listener.receive_stream(),
+            "rdc.gpu2.gpu_temp:45000|g\n"
+            "rdc.gpu2.power_usage:0|g\n"
+            "rdc.gpu2.power_usage:-2.5|g\n");
+}
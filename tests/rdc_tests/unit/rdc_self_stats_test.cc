@@ -0,0 +1,93 @@
+/*
+Copyright (c) 2024 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+#include "rdc/rdc.h"
+#include "rdc_lib/RdcSelfStats.h"
+
+using amd::rdc::RdcSelfStats;
+
+namespace {
+
+int64_t value_of(rdc_field_t field_id) {
+  int64_t value = -1;
+  EXPECT_EQ(RdcSelfStats::get_instance().get_value(field_id, &value), RDC_ST_OK);
+  return value;
+}
+
+}  // namespace
+
+TEST(rdctstUnit, SelfStatsUpdateRates) {
+  RdcSelfStats& stats = RdcSelfStats::get_instance();
+  // The stats are process wide, so start from a fresh baseline far ahead of
+  // any time another test may have used
+  const uint64_t kBase = 1ULL << 50;
+  stats.update_rates(kBase);
+  stats.update_rates(kBase + 1000);
+  EXPECT_EQ(value_of(RDC_FI_RDC_SAMPLES_PER_SEC), 0);
+  EXPECT_EQ(value_of(RDC_FI_RDC_API_CALLS_PER_SEC), 0);
+
+  // 500 samples and 10 calls over two seconds
+  stats.record_samples(300);
+  stats.record_samples(200);
+  for (int i = 0; i < 10; i++) {
+    stats.record_api_call();
+  }
+  stats.update_rates(kBase + 3000);
+  EXPECT_EQ(value_of(RDC_FI_RDC_SAMPLES_PER_SEC), 250);
+  EXPECT_EQ(value_of(RDC_FI_RDC_API_CALLS_PER_SEC), 5);
+
+  // A clock which did not move keeps the last rates
+  stats.record_samples(100);
+  stats.update_rates(kBase + 3000);
+  EXPECT_EQ(value_of(RDC_FI_RDC_SAMPLES_PER_SEC), 250);
+
+  // The next interval counts from the last update, and no new samples
+  // means a rate of zero
+  stats.update_rates(kBase + 3500);
+  EXPECT_EQ(value_of(RDC_FI_RDC_SAMPLES_PER_SEC), 0);
+  EXPECT_EQ(value_of(RDC_FI_RDC_API_CALLS_PER_SEC), 0);
+}
+
+TEST(rdctstUnit, SelfStatsGetValue) {
+  RdcSelfStats& stats = RdcSelfStats::get_instance();
+  stats.record_tick(1200, 800, 42, false);
+  stats.record_module_fetch(amd::rdc::RDC_SELF_MODULE_SMI, 300);
+  stats.record_cache_usage(1000, 64000);
+  EXPECT_EQ(value_of(RDC_FI_RDC_TICK_DURATION), 1200);
+  EXPECT_EQ(value_of(RDC_FI_RDC_FETCH_LATENCY), 800);
+  EXPECT_EQ(value_of(RDC_FI_RDC_FETCH_QUEUE_DEPTH), 42);
+  EXPECT_EQ(value_of(RDC_FI_RDC_SMI_FETCH_LATENCY), 300);
+  EXPECT_EQ(value_of(RDC_FI_RDC_CACHE_SAMPLES), 1000);
+  EXPECT_EQ(value_of(RDC_FI_RDC_CACHE_BYTES), 64000);
+
+  int64_t overruns = value_of(RDC_FI_RDC_TICK_OVERRUNS);
+  stats.record_tick(5000, 4000, 42, true);
+  EXPECT_EQ(value_of(RDC_FI_RDC_TICK_OVERRUNS), overruns + 1);
+
+  int64_t value = 0;
+  EXPECT_EQ(stats.get_value(RDC_FI_GPU_UTIL, &value), RDC_ST_NOT_SUPPORTED);
+  EXPECT_EQ(stats.get_value(RDC_FI_RDC_TICK_DURATION, nullptr), RDC_ST_BAD_PARAMETER);
+}
@@ -0,0 +1,242 @@
+/*
+Copyright (c) 2024 - present Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "rdc/rdc.h"
+#include "rdc_lib/RdcException.h"
+#include "rdc_lib/impl/RdcReplayLib.h"
+#include "rdc_lib/impl/RdcTraceFile.h"
+#include "rdc_tests/test_utils.h"
+
+using amd::rdc::rdc_evnt_notification_t;
+using amd::rdc::rdc_trace_read;
+using amd::rdc::RdcException;
+using amd::rdc::RdcReplayLib;
+using amd::rdc::RdcTraceRecord;
+using amd::rdc::RdcTraceWriter;
+
+namespace {
+
+rdc_gpu_field_value_t string_value(uint32_t gpu_index, uint64_t ts, const char* str) {
+  rdc_gpu_field_value_t value = {};
+  value.gpu_index = gpu_index;
+  value.field_value.field_id = RDC_FI_DEV_NAME;
+  value.field_value.status = RDC_ST_OK;
+  value.field_value.type = STRING;
+  value.field_value.ts = ts;
+  strncpy(value.field_value.value.str, str, RDC_MAX_STR_LENGTH - 1);
+  return value;
+}
+
+rdc_evnt_notification_t vm_fault(uint32_t gpu_index, uint64_t ts, const char* message) {
+  rdc_evnt_notification_t event = {};
+  event.gpu_id = gpu_index;
+  event.field.field_id = RDC_EVNT_NOTIF_VMFAULT;
+  event.field.status = RDC_ST_OK;
+  event.field.type = STRING;
+  event.field.ts = ts;
+  strncpy(event.field.value.str, message, RDC_MAX_STR_LENGTH - 1);
+  return event;
+}
+
+rdc_status_t save_value(rdc_gpu_field_value_t* values, uint32_t num_values, void* user_data) {
+  auto saved = static_cast<std::vector<rdc_gpu_field_value_t>*>(user_data);
+  saved->insert(saved->end(), values, values + num_values);
+  return RDC_ST_OK;
+}
+
+class TraceReplayTest : public ::testing::Test {
+ protected:
+  TempDir dir_{"rdctst_trace"};
+};
+
+}  // namespace
+
+TEST_F(TraceReplayTest, TraceRoundTrip) {
+  const std::string path = dir_.path() + "/trace.bin";
+  std::vector<rdc_gpu_field_value_t> fields;
+  do {
+    RdcTraceWriter writer(path);
+    // The event is older than the fields before it, a negative delta
+    fields.push_back({0, integer_value(RDC_FI_POWER_USAGE, 1700000005000, 150)});
+    fields.push_back({1, integer_value(RDC_FI_GPU_TEMP, 1700000005000, -40)});
+    fields.push_back(string_value(0, 1700000005001, "gfx942"));
+    writer.write_fields(fields.data(), fields.size());
+    rdc_evnt_notification_t event = vm_fault(1, 1700000004000, "gfx942");
+    writer.write_events(&event, 1);
+
+    // Repeated strings refer to the string table; a failed fetch keeps
+    // the previous timestamp
+    std::vector<rdc_gpu_field_value_t> more;
+    more.push_back(string_value(1, 1700000006000, "gfx942"));
+    more.push_back(string_value(1, 1700000006000, "gfx90a"));
+    rdc_gpu_field_value_t failed = {};
+    failed.gpu_index = 3;
+    failed.field_value.field_id = RDC_FI_GPU_CLOCK;
+    failed.field_value.status = RDC_ST_NOT_SUPPORTED;
+    more.push_back(failed);
+    rdc_gpu_field_value_t dbl = {};
+    dbl.gpu_index = 2;
+    dbl.field_value.field_id = RDC_FI_POWER_USAGE;
+    dbl.field_value.status = RDC_ST_OK;
+    dbl.field_value.type = DOUBLE;
+    dbl.field_value.ts = 1700000007000;
+    dbl.field_value.value.dbl = 0.125;
+    more.push_back(dbl);
+    writer.write_fields(more.data(), more.size());
+  } while (0);
+
+  std::vector<RdcTraceRecord> records = rdc_trace_read(path);
+  ASSERT_EQ(records.size(), 8u);
+  EXPECT_FALSE(records[0].is_event);
+  EXPECT_EQ(records[0].gpu_index, 0u);
+  EXPECT_EQ(records[0].field.field_id, RDC_FI_POWER_USAGE);
+  EXPECT_EQ(records[0].field.ts, 1700000005000u);
+  EXPECT_EQ(records[0].field.type, INTEGER);
+  EXPECT_EQ(records[0].field.value.l_int, 150);
+  EXPECT_EQ(records[1].field.value.l_int, -40);
+  EXPECT_STREQ(records[2].field.value.str, "gfx942");
+  EXPECT_EQ(records[2].field.ts, 1700000005001u);
+
+  EXPECT_TRUE(records[3].is_event);
+  EXPECT_EQ(records[3].gpu_index, 1u);
+  EXPECT_EQ(records[3].field.field_id, RDC_EVNT_NOTIF_VMFAULT);
+  EXPECT_EQ(records[3].field.ts, 1700000004000u);
+  EXPECT_STREQ(records[3].field.value.str, "gfx942");
+
+  EXPECT_STREQ(records[4].field.value.str, "gfx942");
+  EXPECT_STREQ(records[5].field.value.str, "gfx90a");
+  EXPECT_EQ(records[6].gpu_index, 3u);
+  EXPECT_EQ(records[6].field.status, RDC_ST_NOT_SUPPORTED);
+  EXPECT_EQ(records[6].field.ts, 1700000006000u);
+  EXPECT_EQ(records[7].field.type, DOUBLE);
+  EXPECT_EQ(records[7].field.value.dbl, 0.125);
+  EXPECT_EQ(records[7].field.ts, 1700000007000u);
+
+  // A record cut in the middle by a killed recorder is dropped
+  ASSERT_EQ(truncate(path.c_str(), sizeof(double) + 3), 0);
+  EXPECT_TRUE(rdc_trace_read(path).empty());
+  do {
+    RdcTraceWriter writer(path);
+    writer.write_fields(fields.data(), fields.size());
+  } while (0);
+  FILE* file = fopen(path.c_str(), "rb");
+  ASSERT_NE(file, nullptr);
+  fseek(file, 0, SEEK_END);
+  long size = ftell(file);  // NOLINT(runtime/int)
+  fclose(file);
+  ASSERT_EQ(truncate(path.c_str(), size - 2), 0);
+  records = rdc_trace_read(path);
+  ASSERT_EQ(records.size(), 2u);
+  EXPECT_EQ(records[1].field.value.l_int, -40);
+
+  EXPECT_THROW(rdc_trace_read(dir_.path() + "/missing.bin"), RdcException);
+  ASSERT_EQ(truncate(path.c_str(), 4), 0);
+  EXPECT_THROW(rdc_trace_read(path), RdcException);
+}
+
+TEST_F(TraceReplayTest, ReplayPositionLoopsAndEvents) {
+  // Power at 1, 2 and 3 seconds into the trace, faults at 1.5 and 2.5
+  const std::string path = dir_.path() + "/trace.bin";
+  do {
+    RdcTraceWriter writer(path);
+    for (int64_t i = 1; i <= 3; i++) {
+      rdc_gpu_field_value_t value = {0, integer_value(RDC_FI_POWER_USAGE, i * 1000, i * 10)};
+      writer.write_fields(&value, 1);
+      if (i < 3) {
+        rdc_evnt_notification_t event = vm_fault(0, i * 1000 + 500, "fault");
+        writer.write_events(&event, 1);
+      }
+    }
+  } while (0);
+
+  // Twice the wall clock, so a loop of the 2001 ms long trace lasts 1000.5 ms
+  RdcReplayLib replay(path, 2.0);
+  uint32_t field_ids[MAX_NUM_FIELDS];
+  uint32_t field_count = 0;
+  ASSERT_EQ(replay.rdc_telemetry_fields_query(field_ids, &field_count), RDC_ST_OK);
+  ASSERT_EQ(field_count, 2u);
+  EXPECT_EQ(field_ids[0], RDC_FI_POWER_USAGE);
+  EXPECT_EQ(field_ids[1], RDC_EVNT_NOTIF_VMFAULT);
+
+  rdc_gpu_field_t fields[] = {
+      {0, RDC_FI_POWER_USAGE}, {0, RDC_EVNT_NOTIF_VMFAULT}, {1, RDC_FI_POWER_USAGE}};
+  const uint64_t start = 1700000000000;
+  auto fetch = [&](uint64_t elapsed_ms) {
+    std::vector<rdc_gpu_field_value_t> values;
+    EXPECT_EQ(replay.fields_value_get_at(start + elapsed_ms, fields, 3, save_value, &values),
+              RDC_ST_OK);
+    return values;
+  };
+
+  // The first fetch starts the trace clock at its first record
+  std::vector<rdc_gpu_field_value_t> values = fetch(0);
+  ASSERT_EQ(values.size(), 2u);
+  EXPECT_EQ(values[0].field_value.status, RDC_ST_OK);
+  EXPECT_EQ(values[0].field_value.value.l_int, 10);
+  EXPECT_EQ(values[0].field_value.ts, start);
+  // A field the trace never recorded
+  EXPECT_EQ(values[1].gpu_index, 1u);
+  EXPECT_EQ(values[1].field_value.status, RDC_ST_NOT_SUPPORTED);
+
+  // 1.6 s into the trace: the first fault, once
+  values = fetch(300);
+  ASSERT_EQ(values.size(), 3u);
+  EXPECT_EQ(values[0].field_value.value.l_int, 10);
+  EXPECT_EQ(values[1].field_value.field_id, RDC_EVNT_NOTIF_VMFAULT);
+  EXPECT_STREQ(values[1].field_value.value.str, "fault");
+  EXPECT_EQ(values[1].field_value.ts, start + 300);
+  values = fetch(500);
+  ASSERT_EQ(values.size(), 2u);
+  EXPECT_EQ(values[0].field_value.value.l_int, 20);
+
+  // The end of the trace: the last value and the second fault
+  values = fetch(1000);
+  ASSERT_EQ(values.size(), 3u);
+  EXPECT_EQ(values[0].field_value.value.l_int, 30);
+  EXPECT_EQ(values[1].field_value.field_id, RDC_EVNT_NOTIF_VMFAULT);
+
+  // Wrapped around to the start, where the faults are served again
+  values = fetch(1001);
+  ASSERT_EQ(values.size(), 2u);
+  EXPECT_EQ(values[0].field_value.value.l_int, 10);
+  values = fetch(1300);
+  ASSERT_EQ(values.size(), 3u);
+  EXPECT_EQ(values[1].field_value.field_id, RDC_EVNT_NOTIF_VMFAULT);
+  values = fetch(1350);
+  EXPECT_EQ(values.size(), 2u);
+
+  // A fetch skipping a whole loop serves the faults reached in its own loop
+  values = fetch(3000);
+  ASSERT_EQ(values.size(), 4u);
+  EXPECT_EQ(values[0].field_value.value.l_int, 20);
+
+  EXPECT_THROW(RdcReplayLib(dir_.path() + "/missing.bin", 1.0), RdcException);
+  EXPECT_THROW(RdcReplayLib(path, 0), RdcException);
+}